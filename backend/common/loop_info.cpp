@@ -0,0 +1,167 @@
+#include <backend/common/loop_info.h>
+#include <debug.h>
+#include <algorithm>
+#include <map>
+
+namespace BE::MIR
+{
+    LoopInfo::LoopInfo(const CFG* cfg) : cfg_(cfg), entry_(0)
+    {
+        if (cfg_->entry_block)
+            entry_ = cfg_->entry_block->blockId;
+        else if (!cfg_->blocks.empty())
+            entry_ = cfg_->blocks.begin()->first;
+
+        size_t n = cfg_->graph_id.size();
+        rpoIndex_.assign(n, -1);
+        idom_.assign(n, -1);
+        depth_.assign(n, 0);
+
+        computeRPO();
+        computeDominators();
+        computeLoops();
+    }
+
+    void LoopInfo::computeRPO()
+    {
+        if (cfg_->blocks.empty()) return;
+
+        // 迭代式 DFS，避免深层 CFG 递归爆栈
+        std::vector<uint32_t>                     post;
+        std::vector<bool>                         visited(cfg_->graph_id.size(), false);
+        std::vector<std::pair<uint32_t, size_t>> stack;
+        stack.push_back({entry_, 0});
+        visited[entry_] = true;
+        while (!stack.empty())
+        {
+            auto& [id, next] = stack.back();
+            if (next < cfg_->graph_id[id].size())
+            {
+                uint32_t succ = cfg_->graph_id[id][next++];
+                if (!visited[succ])
+                {
+                    visited[succ] = true;
+                    stack.push_back({succ, 0});
+                }
+                continue;
+            }
+            post.push_back(id);
+            stack.pop_back();
+        }
+
+        rpo_.assign(post.rbegin(), post.rend());
+        for (size_t i = 0; i < rpo_.size(); ++i) rpoIndex_[rpo_[i]] = static_cast<int>(i);
+    }
+
+    void LoopInfo::computeDominators()
+    {
+        if (rpo_.empty()) return;
+
+        auto intersect = [this](int a, int b) {
+            while (a != b)
+            {
+                while (rpoIndex_[a] > rpoIndex_[b]) a = idom_[a];
+                while (rpoIndex_[b] > rpoIndex_[a]) b = idom_[b];
+            }
+            return a;
+        };
+
+        idom_[entry_] = static_cast<int>(entry_);
+        bool changed  = true;
+        while (changed)
+        {
+            changed = false;
+            for (size_t i = 1; i < rpo_.size(); ++i)
+            {
+                uint32_t b       = rpo_[i];
+                int      newIdom = -1;
+                for (uint32_t p : cfg_->inv_graph_id[b])
+                {
+                    if (idom_[p] < 0) continue;
+                    newIdom = newIdom < 0 ? static_cast<int>(p) : intersect(static_cast<int>(p), newIdom);
+                }
+                if (newIdom >= 0 && idom_[b] != newIdom)
+                {
+                    idom_[b] = newIdom;
+                    changed  = true;
+                }
+            }
+        }
+    }
+
+    void LoopInfo::computeLoops()
+    {
+        // 回边 latch -> header（header 支配 latch），按 header 合并
+        std::map<uint32_t, size_t> headerToLoop;
+        for (uint32_t b : rpo_)
+        {
+            for (uint32_t succ : cfg_->graph_id[b])
+            {
+                if (!dominates(succ, b)) continue;
+                auto it = headerToLoop.find(succ);
+                if (it == headerToLoop.end())
+                {
+                    it = headerToLoop.emplace(succ, loops_.size()).first;
+                    loops_.push_back(Loop{succ, {succ}, {}, 0});
+                }
+                loops_[it->second].latches.push_back(b);
+            }
+        }
+
+        // 从 latch 逆向遍历到 header，收集自然循环体
+        for (auto& loop : loops_)
+        {
+            std::vector<uint32_t> work;
+            for (uint32_t latch : loop.latches)
+                if (loop.blocks.insert(latch).second) work.push_back(latch);
+            while (!work.empty())
+            {
+                uint32_t b = work.back();
+                work.pop_back();
+                for (uint32_t p : cfg_->inv_graph_id[b])
+                    if (isReachable(p) && loop.blocks.insert(p).second) work.push_back(p);
+            }
+            for (uint32_t b : loop.blocks) ++depth_[b];
+        }
+        for (auto& loop : loops_) loop.depth = depth_[loop.header];
+    }
+
+    bool LoopInfo::isReachable(uint32_t id) const { return id < idom_.size() && idom_[id] >= 0; }
+
+    int LoopInfo::idom(uint32_t id) const { return id < idom_.size() ? idom_[id] : -1; }
+
+    bool LoopInfo::dominates(uint32_t a, uint32_t b) const
+    {
+        if (!isReachable(a) || !isReachable(b)) return false;
+        while (true)
+        {
+            if (a == b) return true;
+            if (b == entry_) return false;
+            b = static_cast<uint32_t>(idom_[b]);
+        }
+    }
+
+    uint32_t LoopInfo::commonDominator(uint32_t a, uint32_t b) const
+    {
+        ASSERT(isReachable(a) && isReachable(b) && "commonDominator on unreachable block");
+        while (a != b)
+        {
+            while (rpoIndex_[a] > rpoIndex_[b]) a = static_cast<uint32_t>(idom_[a]);
+            while (rpoIndex_[b] > rpoIndex_[a]) b = static_cast<uint32_t>(idom_[b]);
+        }
+        return a;
+    }
+
+    int LoopInfo::loopDepth(uint32_t id) const { return id < depth_.size() ? depth_[id] : 0; }
+
+    const LoopInfo::Loop* LoopInfo::innermostLoop(uint32_t id) const
+    {
+        const Loop* best = nullptr;
+        for (auto& loop : loops_)
+        {
+            if (!loop.blocks.count(id)) continue;
+            if (!best || loop.depth > best->depth) best = &loop;
+        }
+        return best;
+    }
+}  // namespace BE::MIR
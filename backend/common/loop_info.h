@@ -0,0 +1,63 @@
+#ifndef __BACKEND_COMMON_LOOP_INFO_H__
+#define __BACKEND_COMMON_LOOP_INFO_H__
+
+#include <backend/common/cfg.h>
+#include <set>
+#include <vector>
+
+/*
+ * LoopInfo
+ *
+ * 作用：
+ * - 在 MIR 层 CFG 上计算支配树（Cooper-Harvey-Kennedy 迭代算法）与自然循环。
+ * - 为常量提升、循环相关的 MIR 优化提供 idom / 最近公共支配者 / 循环深度查询。
+ *
+ * 说明：
+ * - 块以 blockId 标识；不可达块的 idom 为 -1，循环深度为 0。
+ * - 同一循环头的多条回边合并为一个循环。
+ */
+namespace BE::MIR
+{
+    class LoopInfo
+    {
+      public:
+        struct Loop
+        {
+            uint32_t              header;   ///< 循环头
+            std::set<uint32_t>    blocks;   ///< 循环体（包含循环头）
+            std::vector<uint32_t> latches;  ///< 回边源块
+            int                   depth;    ///< 嵌套深度，最外层为 1
+        };
+
+      public:
+        explicit LoopInfo(const CFG* cfg);
+
+        bool     isReachable(uint32_t id) const;
+        int      idom(uint32_t id) const;
+        bool     dominates(uint32_t a, uint32_t b) const;
+        uint32_t commonDominator(uint32_t a, uint32_t b) const;
+        int      loopDepth(uint32_t id) const;
+
+        // 包含 id 的最内层循环，不在循环内返回 nullptr
+        const Loop* innermostLoop(uint32_t id) const;
+
+        uint32_t                     entry() const { return entry_; }
+        const std::vector<uint32_t>& rpo() const { return rpo_; }
+        const std::vector<Loop>&     loops() const { return loops_; }
+
+      private:
+        const CFG*            cfg_;
+        uint32_t              entry_;
+        std::vector<uint32_t> rpo_;
+        std::vector<int>      rpoIndex_;
+        std::vector<int>      idom_;
+        std::vector<int>      depth_;
+        std::vector<Loop>     loops_;
+
+        void computeRPO();
+        void computeDominators();
+        void computeLoops();
+    };
+}  // namespace BE::MIR
+
+#endif  // __BACKEND_COMMON_LOOP_INFO_H__
@@ -22,8 +22,10 @@
  */
 
 #include <backend/dag/dag_builder.h>
+#include <backend/isel/isel_base.h>
 #include <cstdint>
 #include <algorithm>
+#include <set>
 #include <debug.h>
 
 namespace BE
@@ -89,9 +91,26 @@ namespace BE
                     size_t id = op->getRegNum();
                     // 检查是否已经存在该寄存器的映射，若存在则直接返回
                     auto   it = reg_value_map_.find(id);
-                    if (it != reg_value_map_.end()) return it->second;
+                    if (it != reg_value_map_.end())
+                    {
+                        // 经 REG 节点的引用读取的是块外定义的虚拟寄存器，计入跨块引用；
+                        // 本块内定义（或重建）的值以 DAG 边引用，由指令选择按边统计
+                        const SDNode* n = it->second.getNode();
+                        if (n && n->getOpcode() == static_cast<unsigned>(ISD::REG)) ++cross_block_uses_[id];
+                        return it->second;
+                    }
+
+                    // EBB 祖先中的纯计算：在本块重建（PHI 的入边值必须在前驱中可用，不能重建）
+                    auto defIt = ebb_defs_.find(id);
+                    if (defIt != ebb_defs_.end() && !in_phi_)
+                    {
+                        SDValue v = rematerialize(defIt->second, dag);
+                        reg_value_map_[id] = v;
+                        return v;
+                    }
 
                     // 若不存在，则在 DAG 中创建一个新的寄存器节点
+                    ++cross_block_uses_[id];
                     SDValue v = dag.getRegNode(id, dtype);
 
                     // 缓存映射关系并返回
@@ -131,18 +150,156 @@ namespace BE
             }
         }
 
+        bool DAGBuilder::isRematerializable(ME::Instruction* inst, size_t& resId)
+        {
+            ME::Operand* res = nullptr;
+            if (auto* icmp = dynamic_cast<ME::IcmpInst*>(inst))
+                res = icmp->res;
+            else if (auto* gep = dynamic_cast<ME::GEPInst*>(inst))
+            {
+                // 仅常量偏移：重建后是 base + imm，可直接折叠进访存指令
+                int64_t offset = 0;
+                if (constGEPOffset(*gep, offset)) res = gep->res;
+            }
+            if (!res || res->getType() != ME::OperandType::REG) return false;
+            resId = res->getRegNum();
+            return true;
+        }
+
+        SDValue DAGBuilder::rematerialize(ME::Instruction* def, SelectionDAG& dag)
+        {
+            // 重建节点不调用 setDef：它只是本块内的副本，不负责定义跨块的虚拟寄存器
+            if (auto* icmp = dynamic_cast<ME::IcmpInst*>(def))
+            {
+                auto    vt  = mapType(icmp->dt);
+                SDValue lhs = getValue(icmp->lhs, dag, vt);
+                SDValue rhs = getValue(icmp->rhs, dag, vt);
+                return dag.getImmNode(
+                    static_cast<unsigned>(ISD::ICMP), {BE::I32}, {lhs, rhs}, static_cast<int64_t>(icmp->cond));
+            }
+
+            auto*   gep    = static_cast<ME::GEPInst*>(def);
+            int64_t offset = 0;
+            constGEPOffset(*gep, offset);
+            SDValue base = getValue(gep->basePtr, dag, BE::PTR);
+            if (offset == 0) return base;
+            return dag.getNode(
+                static_cast<unsigned>(ISD::ADD), {BE::PTR}, {base, dag.getConstantI64(offset, BE::I64)});
+        }
+
+        void DAGBuilder::buildFunction(ME::Function& func, std::map<const ME::Block*, SelectionDAG*>& dags)
+        {
+            alloca_map_.clear();
+            ebb_defs_.clear();
+            cross_block_uses_.clear();
+            if (func.blocks.empty()) return;
+
+            // 1. 由终结指令求前驱数，唯一前驱即为 EBB 父块（入口块与自环除外）
+            std::map<size_t, int>    predCnt;
+            std::map<size_t, size_t> uniquePred;
+            for (auto& [bid, block] : func.blocks)
+            {
+                if (block->insts.empty()) continue;
+                std::vector<ME::Operand*> targets;
+                if (auto* br = dynamic_cast<ME::BrCondInst*>(block->insts.back()))
+                    targets = {br->trueTar, br->falseTar};
+                else if (auto* jmp = dynamic_cast<ME::BrUncondInst*>(block->insts.back()))
+                    targets = {jmp->target};
+                std::set<size_t> succs;
+                for (auto* t : targets)
+                    if (t && t->getType() == ME::OperandType::LABEL)
+                        succs.insert(static_cast<ME::LabelOperand*>(t)->lnum);
+                for (size_t succ : succs)
+                {
+                    ++predCnt[succ];
+                    uniquePred[succ] = bid;
+                }
+            }
+
+            size_t                                entryId = func.blocks.begin()->first;
+            std::map<size_t, std::vector<size_t>> children;
+            std::vector<size_t>                   roots;
+            for (auto& [bid, block] : func.blocks)
+            {
+                bool inEBB = extended_blocks_ && bid != entryId && predCnt[bid] == 1 && uniquePred[bid] != bid &&
+                             func.blocks.count(uniquePred[bid]);
+                if (inEBB)
+                    children[uniquePred[bid]].push_back(bid);
+                else
+                    roots.push_back(bid);
+            }
+
+            // 2. 按 EBB 树先序构建：进入块时其祖先的可重建定义可见，离开子树时撤销本块加入的定义
+            //    入口块是第一个根，alloca 对应的 FrameIndex 会先于其它块被记录
+            struct Frame
+            {
+                size_t              bid;
+                bool                expanded;
+                std::vector<size_t> added;
+            };
+            for (size_t root : roots)
+            {
+                std::vector<Frame> stack;
+                stack.push_back({root, false, {}});
+                while (!stack.empty())
+                {
+                    if (stack.back().expanded)
+                    {
+                        for (size_t id : stack.back().added) ebb_defs_.erase(id);
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    stack.back().expanded = true;
+                    size_t    bid         = stack.back().bid;
+                    ME::Block* block      = func.getBlock(bid);
+
+                    auto* dag = arena_ ? new SelectionDAG(*arena_) : new SelectionDAG();
+                    build(*block, *dag);
+                    dags[block] = dag;
+
+                    auto kids = children.find(bid);
+                    if (kids == children.end()) continue;
+
+                    std::vector<size_t> added;
+                    for (auto* inst : block->insts)
+                    {
+                        size_t id = 0;
+                        if (isRematerializable(inst, id) && ebb_defs_.emplace(id, inst).second) added.push_back(id);
+                    }
+                    stack.back().added = std::move(added);
+                    for (auto it = kids->second.rbegin(); it != kids->second.rend(); ++it)
+                        stack.push_back({*it, false, {}});
+                }
+            }
+        }
+
         // 设置操作数的定义结果
-        void DAGBuilder::setDef(ME::Operand* res, const SDValue& val)
+        void DAGBuilder::setDef(ME::Operand* res, const SDValue& val, SelectionDAG& dag)
         {
             // 检查操作数是否有效且为寄存器类型
             if (!res || res->getType() != ME::OperandType::REG) return;
 
-            // 获取寄存器 ID 并更新寄存器到 SDValue 的映射
+            // 获取寄存器 ID 并更新寄存器到 SDValue 的映射，块内的使用直接引用该值
             size_t regId          = res->getRegNum();
             reg_value_map_[regId] = val;
-
-            // 如果 SDValue 关联了节点，则在节点中记录对应的 IR 寄存器 ID
-            if (val.getNode()) val.getNode()->setIRRegId(regId);
+            if (!val.getNode()) return;
+
+            // 节点只能携带一个 IR 寄存器 ID。CSE 可能让多条 IR 指令得到同一节点
+            // （如 gep [1 x i32] %p, 0, 0 与 gep %p, 0 都是 p + 0），节点也可能本身就是
+            // 其它寄存器的 REG/FRAME_INDEX 节点：此时由单独的 COPY 节点定义本寄存器，
+            // 不能改写节点已有的 ID，否则原寄存器在其它块中的引用将没有定义。
+            // 常量与符号等叶子节点在每个使用处单独实例化，不定义虚拟寄存器，同样需要 COPY
+            const SDNode* n    = val.getNode();
+            auto          opc  = static_cast<ISD>(n->getOpcode());
+            bool          leaf = opc == ISD::CONST_I32 || opc == ISD::CONST_I64 || opc == ISD::CONST_F32 ||
+                        opc == ISD::SYMBOL || opc == ISD::FRAME_INDEX || opc == ISD::REG;
+            if (leaf || (n->hasIRRegId() && n->getIRRegId() != regId))
+            {
+                dag.getCopyNode(val, regId);
+                return;
+            }
+            val.getNode()->setIRRegId(regId);
         }
 
         // 将 ME::Operator 映射为 ISD::Operator
@@ -222,7 +379,7 @@ namespace BE
             //   输出：[Value, Chain]  ← 有两个输出！
             SDValue node = dag.getNode(static_cast<unsigned>(ISD::LOAD), {vt, BE::TOKEN}, {currentChain_, ptr});
             // 4. 记录加载的值（结果 #0）到 reg_value_map_
-            setDef(inst.res, SDValue(node.getNode(), 0));  // Value is result #0
+            setDef(inst.res, SDValue(node.getNode(), 0), dag);  // Value is result #0
             // 5. 更新 currentChain_ 为 LOAD 节点的 Chain 输出
             currentChain_ = SDValue(node.getNode(), 1);    // Chain is result #1
         }
@@ -257,18 +414,18 @@ namespace BE
             // 4. 创建算术节点
             SDValue  node = dag.getNode(opc, {vt}, {lhs, rhs});
             // 5. 设置结果寄存器
-            setDef(inst.res, node);
+            setDef(inst.res, node, dag);
         }
 
         void DAGBuilder::visit(ME::IcmpInst& inst, SelectionDAG& dag)
         {
-            // 生成 ICMP 节点，结果类型为 I32，携带比较条件 imm
+            // 生成 ICMP 节点，结果类型为 I32，携带比较条件 imm（条件参与 CSE，不同条件的比较不能合并）
             auto    vt  = mapType(inst.dt);
             SDValue lhs = getValue(inst.lhs, dag, vt);
             SDValue rhs = getValue(inst.rhs, dag, vt);
-            SDValue node = dag.getNode(static_cast<unsigned>(ISD::ICMP), {BE::I32}, {lhs, rhs});
-            node.getNode()->setImmI64(static_cast<int64_t>(inst.cond));
-            setDef(inst.res, node);
+            SDValue node = dag.getImmNode(
+                static_cast<unsigned>(ISD::ICMP), {BE::I32}, {lhs, rhs}, static_cast<int64_t>(inst.cond));
+            setDef(inst.res, node, dag);
         }
 
         void DAGBuilder::visit(ME::FcmpInst& inst, SelectionDAG& dag)
@@ -277,9 +434,9 @@ namespace BE
             auto    vt  = mapType(inst.dt);
             SDValue lhs = getValue(inst.lhs, dag, vt);
             SDValue rhs = getValue(inst.rhs, dag, vt);
-            SDValue node = dag.getNode(static_cast<unsigned>(ISD::FCMP), {BE::I32}, {lhs, rhs});
-            node.getNode()->setImmI64(static_cast<int64_t>(inst.cond));
-            setDef(inst.res, node);
+            SDValue node = dag.getImmNode(
+                static_cast<unsigned>(ISD::FCMP), {BE::I32}, {lhs, rhs}, static_cast<int64_t>(inst.cond));
+            setDef(inst.res, node, dag);
         }
 
         //为alloca指令生成DAG节点，对于没有优化的部分就用这个
@@ -346,7 +503,7 @@ namespace BE
                 // 有返回值
                 auto vt = mapType(inst.retType);
                 SDValue node = dag.getNode(static_cast<unsigned>(ISD::CALL), {vt, BE::TOKEN}, ops);
-                setDef(inst.res, SDValue(node.getNode(), 0));
+                setDef(inst.res, SDValue(node.getNode(), 0), dag);
                 currentChain_ = SDValue(node.getNode(), 1);
             }
             else
@@ -370,97 +527,55 @@ namespace BE
             ERROR("FuncDefInst should not appear in DAGBuilder");
         }
 
-        [[maybe_unused]]
-        static inline int elemByteSize(ME::DataType t)
+        bool DAGBuilder::constGEPOffset(ME::GEPInst& inst, int64_t& offset)
         {
-            switch (t)
+            auto strides = BE::gepByteStrides(inst);
+            offset       = 0;
+            for (size_t i = 0; i < inst.idxs.size(); ++i)
             {
-                case ME::DataType::I1:
-                case ME::DataType::I8:
-                case ME::DataType::I32: return 4;
-                case ME::DataType::I64:
-                case ME::DataType::PTR: return 8;
-                case ME::DataType::F32: return 4;
-                case ME::DataType::DOUBLE: return 8;
-                default: return 4;
+                if (inst.idxs[i]->getType() != ME::OperandType::IMMEI32) return false;
+                offset += static_cast<ME::ImmeI32Operand*>(inst.idxs[i])->value * strides[i];
             }
+            return true;
         }
 
         void DAGBuilder::visit(ME::GEPInst& inst, SelectionDAG& dag)
         {
             // 实现 GEP 到地址计算 DAG 的转换
             // 1) 取 base 指针
-            SDValue base = getValue(inst.basePtr, dag, BE::PTR);
-            
-            // 计算元素大小
-            int elemSize = elemByteSize(inst.dt);
-            
-            // 2) 计算偏移: 对于多维数组需要按维度展开
-            // dims 存储了各维度大小，idxs 存储了各维度索引
-            // 例如 a[i][j] 对于 [M x N] 数组，偏移 = (i * N + j) * elemSize
-            SDValue totalOffset;
-            bool hasOffset = false;
-            
-            // 预计算后缀乘积 stride，suffixProd[k] = dims[k] * dims[k+1] * ...
-            std::vector<int> suffixProd(inst.dims.size() + 1, 1);
-            for (int i = static_cast<int>(inst.dims.size()) - 1; i >= 0; --i)
-            {
-                suffixProd[i] = suffixProd[i + 1] * inst.dims[i];
-            }
-
-            // LLVM/GEP-style索引通常会带一个 leading idx（对 alloca/全局数组常为 0），
-            // 当 idx 数量不少于维度数时需要将第一个 idx 单独处理。
-            bool hasLeadingIdx = inst.idxs.size() >= inst.dims.size();
+            SDValue base    = getValue(inst.basePtr, dag, BE::PTR);
+            auto    strides = BE::gepByteStrides(inst);
 
+            // 2) 计算偏移：常量索引直接折叠为字节偏移，变量索引生成 idx * stride
+            SDValue totalOffset;
+            int64_t constOffset = 0;
             for (size_t i = 0; i < inst.idxs.size(); ++i)
             {
-                SDValue idx = getValue(inst.idxs[i], dag, BE::I64);
-
-                size_t dimIdx;
-                if (hasLeadingIdx)
+                if (inst.idxs[i]->getType() == ME::OperandType::IMMEI32)
                 {
-                    // idx0 对应整个数组，步长为全维度乘积
-                    if (i == 0)
-                        dimIdx = 0;
-                    else
-                        dimIdx = i - 1;
+                    constOffset += static_cast<ME::ImmeI32Operand*>(inst.idxs[i])->value * strides[i];
+                    continue;
                 }
-                else
-                    dimIdx = i;
 
-                int elemStride = 1;
-                if (hasLeadingIdx && i == 0)
-                    elemStride = suffixProd[0];
-                else if (dimIdx < suffixProd.size() - 1)
-                    elemStride = suffixProd[dimIdx + 1];
+                SDValue idx        = getValue(inst.idxs[i], dag, BE::I64);
+                SDValue strideNode = dag.getConstantI64(strides[i], BE::I64);
+                SDValue offset     = dag.getNode(static_cast<unsigned>(ISD::MUL), {BE::I64}, {idx, strideNode});
 
-                int      byteStride = elemStride * elemSize;
-                SDValue  strideNode = dag.getConstantI64(byteStride, BE::I64);
-                SDValue  offset     = dag.getNode(static_cast<unsigned>(ISD::MUL), {BE::I64}, {idx, strideNode});
-
-                if (!hasOffset)
-                {
+                if (!totalOffset)
                     totalOffset = offset;
-                    hasOffset   = true;
-                }
                 else
-                {
                     totalOffset = dag.getNode(static_cast<unsigned>(ISD::ADD), {BE::I64}, {totalOffset, offset});
-                }
-            }
-            
-            // 3) 基址 + 偏移
-            SDValue result;
-            if (hasOffset)
-            {
-                result = dag.getNode(static_cast<unsigned>(ISD::ADD), {BE::PTR}, {base, totalOffset});
             }
-            else
-            {
-                result = base;
-            }
-            
-            setDef(inst.res, result);
+
+            // 3) 基址 + 变量偏移 + 常量偏移；常量偏移放在最外层，便于访存指令折叠到立即数字段
+            //    偏移全为 0 时结果即基址，由 setDef 生成 COPY 定义本寄存器
+            SDValue result = base;
+            if (totalOffset) result = dag.getNode(static_cast<unsigned>(ISD::ADD), {BE::PTR}, {result, totalOffset});
+            if (constOffset != 0)
+                result = dag.getNode(static_cast<unsigned>(ISD::ADD), {BE::PTR},
+                    {result, dag.getConstantI64(constOffset, BE::I64)});
+
+            setDef(inst.res, result, dag);
         }
 
         void DAGBuilder::visit(ME::ZextInst& inst, SelectionDAG& dag)
@@ -470,7 +585,7 @@ namespace BE
             auto dstType = mapType(inst.to);
             SDValue src = getValue(inst.src, dag, srcType);
             SDValue node = dag.getNode(static_cast<unsigned>(ISD::ZEXT), {dstType}, {src});
-            setDef(inst.dest, node);
+            setDef(inst.dest, node, dag);
         }
 
         void DAGBuilder::visit(ME::SI2FPInst& inst, SelectionDAG& dag)
@@ -478,7 +593,7 @@ namespace BE
             // 实现 SITOFP（有符号整型到浮点）
             SDValue src = getValue(inst.src, dag, BE::I32);
             SDValue node = dag.getNode(static_cast<unsigned>(ISD::SITOFP), {BE::F32}, {src});
-            setDef(inst.dest, node);
+            setDef(inst.dest, node, dag);
         }
 
         void DAGBuilder::visit(ME::FP2SIInst& inst, SelectionDAG& dag)
@@ -486,7 +601,7 @@ namespace BE
             // 实现 FPTOSI（浮点到有符号整型）
             SDValue src = getValue(inst.src, dag, BE::F32);
             SDValue node = dag.getNode(static_cast<unsigned>(ISD::FPTOSI), {BE::I32}, {src});
-            setDef(inst.dest, node);
+            setDef(inst.dest, node, dag);
         }
 
         void DAGBuilder::visit(ME::PhiInst& inst, SelectionDAG& dag)
@@ -495,6 +610,7 @@ namespace BE
             // ops 形如 [LABEL0, VAL0, LABEL1, VAL1, ...]
             auto vt = mapType(inst.dt);//结果类型
             std::vector<SDValue> ops;//操作数列表
+            in_phi_ = true;
             
             // 1. 构造操作数列表
             for (auto& [labelOp, valOp] : inst.incomingVals)
@@ -509,9 +625,11 @@ namespace BE
                 ops.push_back(label);
             }
             
+            in_phi_ = false;
+
             // 5. 构造 PHI 节点
             SDValue node = dag.getNode(static_cast<unsigned>(ISD::PHI), {vt}, ops);
-            setDef(inst.res, node);
+            setDef(inst.res, node, dag);
         }
 
     }  // namespace DAG
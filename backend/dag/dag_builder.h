@@ -7,6 +7,7 @@
 #include <middleend/module/ir_module.h>
 #include <middleend/module/ir_operand.h>
 #include <unordered_map>
+#include <map>
 
 //这个模块负责把LLVMIR转换为SelectionDAG
 namespace BE
@@ -25,6 +26,30 @@ namespace BE
                 reg_value_map_.insert(alloca_map_.begin(), alloca_map_.end());
                 apply(*this, block, dag);
             }
+
+            /**
+             * @brief 以函数为单位构建所有基本块的 DAG
+             *
+             * 扩展基本块模式下，沿“唯一前驱”关系把块组织成扩展基本块（EBB）树并按先序构建：
+             * 若某寄存器由 EBB 祖先块中的纯计算定义（整数比较、常量偏移的 GEP），
+             * 则在当前块的 DAG 中按原表达式重建该值而非引用跨块寄存器，
+             * 使指令选择可以跨越块边界折叠“前驱中的比较 + 后继中的分支”与“地址 + 访存”。
+             * 重建节点不携带 IR 寄存器 ID；原定义是否仍被需要由 getCrossBlockUses() 给出。
+             */
+            void buildFunction(ME::Function& func, std::map<const ME::Block*, SelectionDAG*>& dags);
+
+            void setExtendedBlocks(bool enable) { extended_blocks_ = enable; }
+            /// 新建的块 DAG 从该 arena 分配节点；未设置时各 DAG 使用自有的 arena
+            void setArena(NodeArena* arena) { arena_ = arena; }
+
+            /**
+             * @brief 最近一次 buildFunction 中，各 IR 寄存器在定义所在块的 DAG 之外被引用的次数
+             *
+             * 只统计经 REG 节点读取虚拟寄存器的引用（其它块的使用、PHI 入边，含自环块中 PHI 对本块定义的引用），
+             * 在后继块中重建的引用不计入。定义所在块内的使用是 DAG 边，按节点统计即可；
+             * 计数为 0 的定义在块外不被需要，可以被折叠或删除。块内的 DAG 改写不影响该计数。
+             */
+            const std::unordered_map<size_t, int>& getCrossBlockUses() const { return cross_block_uses_; }
             // 访问 Module，通常负责遍历其中的 Function
             void visit(ME::Module& module, SelectionDAG& dag) override;
             void visit(ME::Function& func, SelectionDAG& dag) override;
@@ -84,6 +109,13 @@ namespace BE
             // 保持 alloca 产生的 FrameIndex 映射，以便跨基本块复用
             std::unordered_map<size_t, SDValue> alloca_map_;
 
+            // 扩展基本块模式：EBB 祖先中可在本块重建的定义；各 IR 寄存器的跨块引用计数
+            NodeArena*                                     arena_           = nullptr;
+            bool                                           extended_blocks_ = false;
+            bool                                           in_phi_          = false;
+            std::unordered_map<size_t, ME::Instruction*>   ebb_defs_;
+            std::unordered_map<size_t, int>                cross_block_uses_;
+
             /**
              * @brief 当前的内存操作链（Chain）
              *
@@ -121,8 +153,15 @@ namespace BE
              *
              * 将 IR 指令的结果（如 %3 = add %1, %2 中的 %3）
              * 映射到对应的 DAG 节点（ADD 节点），存入 reg_value_map_。
+             * 节点已携带其它 IR 寄存器 ID 时，另建一个携带本寄存器 ID 的 COPY 节点。
              */
-            void setDef(ME::Operand* res, const SDValue& val);
+            void setDef(ME::Operand* res, const SDValue& val, SelectionDAG& dag);
+
+            /// EBB 祖先中的定义能否在后继块中重建（无副作用、操作数在后继中同样可用）
+            static bool isRematerializable(ME::Instruction* inst, size_t& resId);
+            /// 全部索引为常量的 GEP 的字节偏移
+            static bool constGEPOffset(ME::GEPInst& inst, int64_t& offset);
+            SDValue     rematerialize(ME::Instruction* def, SelectionDAG& dag);
 
             BE::DataType* mapType(ME::DataType t);
             uint32_t      mapArithmeticOpcode(ME::Operator op, bool isFloat);
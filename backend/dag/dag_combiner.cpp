@@ -0,0 +1,588 @@
+#include <backend/dag/dag_combiner.h>
+#include <interfaces/middleend/ir_defs.h>
+#include <debug.h>
+#include <algorithm>
+#include <limits>
+
+namespace BE
+{
+    namespace DAG
+    {
+        namespace
+        {
+            inline ISD opOf(const SDNode* n) { return static_cast<ISD>(n->getOpcode()); }
+
+            bool constOf(const SDValue& v, int64_t& c)
+            {
+                const SDNode* n = v.getNode();
+                if (!n || (opOf(n) != ISD::CONST_I32 && opOf(n) != ISD::CONST_I64) || !n->hasImmI64()) return false;
+                c = n->getImmI64();
+                return true;
+            }
+
+            bool isConstValue(const SDValue& v, int64_t expect)
+            {
+                int64_t c = 0;
+                return constOf(v, c) && c == expect;
+            }
+
+            bool sameValue(const SDValue& a, const SDValue& b)
+            {
+                return a.getNode() == b.getNode() && a.getResNo() == b.getResNo();
+            }
+
+            bool isIntType(DataType* vt) { return vt == BE::I32 || vt == BE::I64 || vt == BE::PTR; }
+
+            int bitWidth(DataType* vt) { return vt == BE::I32 ? 32 : 64; }
+
+            // 按结果宽度回绕：32 位结果保持符号扩展形式
+            int64_t wrap(int64_t v, DataType* vt) { return vt == BE::I32 ? static_cast<int32_t>(v) : v; }
+
+            DataType* valueType(const SDValue& v) { return v.getNode()->getValueType(v.getResNo()); }
+
+            bool isCommutative(ISD op)
+            {
+                return op == ISD::ADD || op == ISD::MUL || op == ISD::AND || op == ISD::OR || op == ISD::XOR;
+            }
+
+            bool isBinary(ISD op)
+            {
+                switch (op)
+                {
+                    case ISD::ADD:
+                    case ISD::SUB:
+                    case ISD::MUL:
+                    case ISD::DIV:
+                    case ISD::MOD:
+                    case ISD::SHL:
+                    case ISD::ASHR:
+                    case ISD::LSHR:
+                    case ISD::AND:
+                    case ISD::OR:
+                    case ISD::XOR: return true;
+                    default: return false;
+                }
+            }
+
+            // 可被删除的无副作用节点（不携带 IR 寄存器 ID 且无使用者时）
+            bool isRemovable(const SDNode* n)
+            {
+                if (n->hasIRRegId()) return false;
+                switch (opOf(n))
+                {
+                    case ISD::STORE:
+                    case ISD::CALL:
+                    case ISD::RET:
+                    case ISD::BR:
+                    case ISD::BRCOND:
+                    case ISD::ENTRY_TOKEN:
+                    case ISD::TOKEN_FACTOR:
+                    case ISD::PHI:
+                    case ISD::FRAME_INDEX:
+                    case ISD::REG: return false;
+                    default: return true;
+                }
+            }
+
+            bool evalICmp(ME::ICmpOp cc, int64_t a, int64_t b, bool is32)
+            {
+                uint64_t ua = is32 ? static_cast<uint32_t>(a) : static_cast<uint64_t>(a);
+                uint64_t ub = is32 ? static_cast<uint32_t>(b) : static_cast<uint64_t>(b);
+                switch (cc)
+                {
+                    case ME::ICmpOp::EQ: return a == b;
+                    case ME::ICmpOp::NE: return a != b;
+                    case ME::ICmpOp::SGT: return a > b;
+                    case ME::ICmpOp::SGE: return a >= b;
+                    case ME::ICmpOp::SLT: return a < b;
+                    case ME::ICmpOp::SLE: return a <= b;
+                    case ME::ICmpOp::UGT: return ua > ub;
+                    case ME::ICmpOp::UGE: return ua >= ub;
+                    case ME::ICmpOp::ULT: return ua < ub;
+                    case ME::ICmpOp::ULE: return ua <= ub;
+                    default: ERROR("Unsupported ICMP condition in DAGCombiner"); return false;
+                }
+            }
+
+            // 访存地址分解为 基址 + 常量偏移
+            struct MemLoc
+            {
+                const SDNode* base;
+                int64_t       offset;
+                int64_t       size;
+            };
+
+            MemLoc decompose(SDValue addr, int64_t size)
+            {
+                int64_t offset = 0;
+                int64_t c      = 0;
+                while (addr.getNode() && opOf(addr.getNode()) == ISD::ADD)
+                {
+                    const SDNode* n = addr.getNode();
+                    if (constOf(n->getOperand(1), c))
+                        addr = n->getOperand(0);
+                    else if (constOf(n->getOperand(0), c))
+                        addr = n->getOperand(1);
+                    else
+                        break;
+                    offset += c;
+                }
+                return {addr.getNode(), offset, size};
+            }
+
+            bool sameBase(const SDNode* a, const SDNode* b)
+            {
+                if (a == b) return true;
+                if (opOf(a) == ISD::FRAME_INDEX && opOf(b) == ISD::FRAME_INDEX)
+                    return a->getFrameIndex() == b->getFrameIndex();
+                if (opOf(a) == ISD::SYMBOL && opOf(b) == ISD::SYMBOL) return a->getSymbol() == b->getSymbol();
+                return false;
+            }
+
+            bool isIdentifiedObject(const SDNode* n) { return opOf(n) == ISD::FRAME_INDEX || opOf(n) == ISD::SYMBOL; }
+
+            bool noAlias(const MemLoc& a, const MemLoc& b)
+            {
+                if (sameBase(a.base, b.base)) return a.offset + a.size <= b.offset || b.offset + b.size <= a.offset;
+                // 不同的栈槽/全局符号互不重叠
+                return isIdentifiedObject(a.base) && isIdentifiedObject(b.base);
+            }
+
+            bool mustAlias(const MemLoc& a, const MemLoc& b)
+            {
+                return sameBase(a.base, b.base) && a.offset == b.offset && a.size == b.size;
+            }
+
+            int64_t accessSize(DataType* vt) { return (vt == BE::I64 || vt == BE::PTR || vt == BE::F64) ? 8 : 4; }
+        }  // namespace
+
+        void DAGCombiner::push(SDNode* n)
+        {
+            if (!n || !known_.count(n) || !inWorklist_.insert(n).second) return;
+            worklist_.push_back(n);
+        }
+
+        void DAGCombiner::track(SDNode* n)
+        {
+            if (!known_.insert(n).second) return;
+            for (const auto& op : n->getOperands())
+                if (op.getNode()) users_[op.getNode()].push_back(n);
+            push(n);
+        }
+
+        int DAGCombiner::userCount(SDNode* n) const
+        {
+            auto it = users_.find(n);
+            return it == users_.end() ? 0 : static_cast<int>(it->second.size());
+        }
+
+        bool DAGCombiner::hasSingleUse(SDNode* n) const
+        {
+            if (userCount(n) != 1) return false;
+            if (!n->hasIRRegId()) return true;
+            // 携带 IR 寄存器 ID 的节点还可能被其它块引用，只有确知没有跨块引用时才算单使用
+            if (!crossBlockUses_) return false;
+            auto it = crossBlockUses_->find(n->getIRRegId());
+            return it == crossBlockUses_->end() || it->second == 0;
+        }
+
+        SDValue DAGCombiner::getConst(int64_t value, DataType* vt)
+        {
+            SDValue v = dag_.getConstantI64(wrap(value, vt), vt);
+            track(v.getNode());
+            return v;
+        }
+
+        SDValue DAGCombiner::getBinary(ISD op, DataType* vt, SDValue lhs, SDValue rhs)
+        {
+            SDValue v = dag_.getNode(static_cast<unsigned>(op), {vt}, {lhs, rhs});
+            track(v.getNode());
+            return v;
+        }
+
+        void DAGCombiner::replaceUses(SDNode* from, uint32_t resNo, SDValue to, bool skipPhi)
+        {
+            auto it = users_.find(from);
+            if (it == users_.end()) return;
+
+            // 去重但保持登记顺序，使合并结果与指针取值无关
+            std::vector<SDNode*> users;
+            for (auto* u : it->second)
+                if (std::find(users.begin(), users.end(), u) == users.end()) users.push_back(u);
+            it->second.clear();
+
+            for (auto* u : users)
+            {
+                bool keep = skipPhi && opOf(u) == ISD::PHI;
+                std::vector<SDValue> ops = u->getOperands();
+                int                  moved = 0, remain = 0;
+                for (auto& op : ops)
+                {
+                    if (op.getNode() != from) continue;
+                    if (!keep && op.getResNo() == resNo)
+                    {
+                        op = to;
+                        ++moved;
+                    }
+                    else
+                        ++remain;
+                }
+                for (int i = 0; i < remain; ++i) users_[from].push_back(u);
+                if (moved == 0) continue;
+
+                dag_.removeFromCSE(u);
+                u->replaceOperands(ops);
+                dag_.addToCSE(u);
+                for (int i = 0; i < moved; ++i) users_[to.getNode()].push_back(u);
+                push(u);
+            }
+        }
+
+        void DAGCombiner::detach(SDNode* n)
+        {
+            // n 不再使用其操作数：操作数的使用者减少，可能使其它使用者满足单使用条件
+            for (const auto& op : n->getOperands())
+            {
+                auto it = users_.find(op.getNode());
+                if (it == users_.end()) continue;
+                auto pos = std::find(it->second.begin(), it->second.end(), n);
+                if (pos != it->second.end()) it->second.erase(pos);
+                push(op.getNode());
+                for (auto* u : it->second) push(u);
+            }
+        }
+
+        void DAGCombiner::replace(SDNode* n, SDValue v)
+        {
+            if (!n->hasIRRegId())
+            {
+                replaceUses(n, 0, v, false);
+                if (userCount(n) != 0) return;
+                // 已死的节点移出 CSE 表，避免之后被重新命中而复活
+                detach(n);
+                dag_.removeFromCSE(n);
+                return;
+            }
+
+            // 携带 IR 寄存器 ID：块内使用者改用新值，节点本身改写为 COPY 以继续定义该寄存器
+            // PHI 的入边值保持引用原节点（值取自块末的寄存器）
+            replaceUses(n, 0, v, true);
+            detach(n);
+            dag_.removeFromCSE(n);
+            n->morphTo(static_cast<unsigned>(ISD::COPY), {n->getValueType(0)}, {v});
+            dag_.addToCSE(n);
+            users_[v.getNode()].push_back(n);
+        }
+
+        SDValue DAGCombiner::foldConstants(SDNode* n)
+        {
+            ISD     op = opOf(n);
+            int64_t a = 0, b = 0;
+            if (!constOf(n->getOperand(0), a) || !constOf(n->getOperand(1), b)) return SDValue();
+
+            if (op == ISD::ICMP)
+            {
+                if (!n->hasImmI64()) return SDValue();
+                bool is32 = valueType(n->getOperand(0)) == BE::I32;
+                return getConst(evalICmp(static_cast<ME::ICmpOp>(n->getImmI64()), a, b, is32) ? 1 : 0, BE::I32);
+            }
+
+            DataType* vt = n->getValueType(0);
+            int       w  = bitWidth(vt);
+            uint64_t  ua = static_cast<uint64_t>(a), ub = static_cast<uint64_t>(b);
+            int64_t   minVal = vt == BE::I32 ? std::numeric_limits<int32_t>::min() : std::numeric_limits<int64_t>::min();
+            switch (op)
+            {
+                case ISD::ADD: return getConst(static_cast<int64_t>(ua + ub), vt);
+                case ISD::SUB: return getConst(static_cast<int64_t>(ua - ub), vt);
+                case ISD::MUL: return getConst(static_cast<int64_t>(ua * ub), vt);
+                case ISD::AND: return getConst(a & b, vt);
+                case ISD::OR: return getConst(a | b, vt);
+                case ISD::XOR: return getConst(a ^ b, vt);
+                case ISD::DIV:
+                    if (b == 0 || (a == minVal && b == -1)) return SDValue();
+                    return getConst(a / b, vt);
+                case ISD::MOD:
+                    if (b == 0 || (a == minVal && b == -1)) return SDValue();
+                    return getConst(a % b, vt);
+                case ISD::SHL:
+                    if (b < 0 || b >= w) return SDValue();
+                    return getConst(static_cast<int64_t>(ua << b), vt);
+                case ISD::ASHR:
+                    if (b < 0 || b >= w) return SDValue();
+                    return getConst(a >> b, vt);
+                case ISD::LSHR:
+                    if (b < 0 || b >= w) return SDValue();
+                    return getConst(static_cast<int64_t>((w == 32 ? static_cast<uint32_t>(a) : ua) >> b), vt);
+                default: return SDValue();
+            }
+        }
+
+        SDValue DAGCombiner::combineIdentities(SDNode* n)
+        {
+            ISD     op = opOf(n);
+            SDValue x  = n->getOperand(0);
+            SDValue y  = n->getOperand(1);
+            int64_t c  = 0;
+
+            if (op == ISD::ICMP)
+            {
+                if (!sameValue(x, y) || !n->hasImmI64()) return SDValue();
+                switch (static_cast<ME::ICmpOp>(n->getImmI64()))
+                {
+                    case ME::ICmpOp::EQ:
+                    case ME::ICmpOp::SGE:
+                    case ME::ICmpOp::SLE:
+                    case ME::ICmpOp::UGE:
+                    case ME::ICmpOp::ULE: return getConst(1, BE::I32);
+                    default: return getConst(0, BE::I32);
+                }
+            }
+
+            DataType* vt = n->getValueType(0);
+
+            // 常量统一放到右侧
+            if (isCommutative(op) && constOf(x, c) && !constOf(y, c)) return getBinary(op, vt, y, x);
+
+            bool    rhsConst = constOf(y, c);
+            int64_t allOnes  = wrap(-1, vt);
+            switch (op)
+            {
+                case ISD::ADD:
+                    if (rhsConst && c == 0) return x;
+                    break;
+                case ISD::SUB:
+                    if (rhsConst && c == 0) return x;
+                    if (sameValue(x, y)) return getConst(0, vt);
+                    // x - C => x + (-C)，便于与其它加法统一重结合
+                    if (rhsConst)
+                    {
+                        int64_t neg = wrap(static_cast<int64_t>(0 - static_cast<uint64_t>(c)), vt);
+                        if (neg != c) return getBinary(ISD::ADD, vt, x, getConst(neg, vt));
+                    }
+                    // 0 - (0 - z) => z
+                    if (isConstValue(x, 0) && opOf(y.getNode()) == ISD::SUB && isConstValue(y.getNode()->getOperand(0), 0) &&
+                        valueType(y.getNode()->getOperand(1)) == vt)
+                        return y.getNode()->getOperand(1);
+                    break;
+                case ISD::MUL:
+                    if (rhsConst && c == 1) return x;
+                    if (rhsConst && c == 0) return getConst(0, vt);
+                    break;
+                case ISD::DIV:
+                    if (rhsConst && c == 1) return x;
+                    break;
+                case ISD::MOD:
+                    if (rhsConst && (c == 1 || c == -1)) return getConst(0, vt);
+                    break;
+                case ISD::AND:
+                    if (rhsConst && c == 0) return getConst(0, vt);
+                    if (rhsConst && c == allOnes) return x;
+                    if (sameValue(x, y)) return x;
+                    break;
+                case ISD::OR:
+                    if (rhsConst && c == 0) return x;
+                    if (rhsConst && c == allOnes) return getConst(allOnes, vt);
+                    if (sameValue(x, y)) return x;
+                    break;
+                case ISD::XOR:
+                    if (rhsConst && c == 0) return x;
+                    if (sameValue(x, y)) return getConst(0, vt);
+                    break;
+                case ISD::SHL:
+                case ISD::ASHR:
+                case ISD::LSHR:
+                    if (rhsConst && c == 0) return x;
+                    break;
+                default: break;
+            }
+            return SDValue();
+        }
+
+        SDValue DAGCombiner::combineReassociate(SDNode* n)
+        {
+            ISD       op = opOf(n);
+            DataType* vt = n->getValueType(0);
+            SDValue   x  = n->getOperand(0);
+            SDValue   y  = n->getOperand(1);
+            SDNode*   in = x.getNode();
+            int64_t   c2 = 0, c1 = 0;
+            bool      rhsConst = constOf(y, c2);
+
+            // 内层为 32 位、外层为 64 位的组合只出现在地址计算中（i32 下标参与指针运算），
+            // 下标本身不会溢出，因此按 64 位重结合与原语义一致
+            auto compatible = [vt](SDNode* inner) {
+                DataType* it = inner->getValueType(0);
+                return it == vt || (it == BE::I32 && vt != BE::I32);
+            };
+
+            // (x op C1) op C2 => x op (C1 op C2)
+            if (rhsConst && opOf(in) == op && in->getValueType(0) == vt && constOf(in->getOperand(1), c1))
+            {
+                uint64_t u1 = static_cast<uint64_t>(c1), u2 = static_cast<uint64_t>(c2);
+                int      w  = bitWidth(vt);
+                switch (op)
+                {
+                    case ISD::ADD: return getBinary(op, vt, in->getOperand(0), getConst(static_cast<int64_t>(u1 + u2), vt));
+                    case ISD::MUL: return getBinary(op, vt, in->getOperand(0), getConst(static_cast<int64_t>(u1 * u2), vt));
+                    case ISD::AND: return getBinary(op, vt, in->getOperand(0), getConst(c1 & c2, vt));
+                    case ISD::OR: return getBinary(op, vt, in->getOperand(0), getConst(c1 | c2, vt));
+                    case ISD::XOR: return getBinary(op, vt, in->getOperand(0), getConst(c1 ^ c2, vt));
+                    case ISD::SHL:
+                    case ISD::LSHR:
+                    case ISD::ASHR:
+                    {
+                        if (c1 < 0 || c2 < 0 || c1 >= w || c2 >= w) break;
+                        int64_t amt = c1 + c2;
+                        if (amt < w) return getBinary(op, vt, in->getOperand(0), getConst(amt, vt));
+                        if (op == ISD::ASHR) return getBinary(op, vt, in->getOperand(0), getConst(w - 1, vt));
+                        return getConst(0, vt);
+                    }
+                    default: break;
+                }
+            }
+
+            // (x + C1) * C2 => x * C2 + C1 * C2，(x + C1) << C2 => (x << C2) + (C1 << C2)
+            if (rhsConst && (op == ISD::MUL || (op == ISD::SHL && c2 >= 0 && c2 < bitWidth(vt))) &&
+                opOf(in) == ISD::ADD && compatible(in) && constOf(in->getOperand(1), c1) && hasSingleUse(in))
+            {
+                uint64_t u1 = static_cast<uint64_t>(c1);
+                int64_t  scaled = op == ISD::MUL ? static_cast<int64_t>(u1 * static_cast<uint64_t>(c2))
+                                                 : static_cast<int64_t>(u1 << c2);
+                SDValue  prod   = getBinary(op, vt, in->getOperand(0), y);
+                return getBinary(ISD::ADD, vt, prod, getConst(scaled, vt));
+            }
+
+            // (x + C) + y => (x + y) + C：常量推到地址表达式最外层
+            if (op == ISD::ADD && !rhsConst)
+            {
+                for (int i = 0; i < 2; ++i)
+                {
+                    SDValue inner = n->getOperand(i);
+                    SDValue other = n->getOperand(1 - i);
+                    SDNode* a     = inner.getNode();
+                    if (opOf(a) != ISD::ADD || !compatible(a) || !constOf(a->getOperand(1), c1)) continue;
+                    if (constOf(other, c2) || !hasSingleUse(a)) continue;
+                    SDValue sum = getBinary(ISD::ADD, vt, a->getOperand(0), other);
+                    return getBinary(ISD::ADD, vt, sum, getConst(c1, vt));
+                }
+            }
+            return SDValue();
+        }
+
+        SDValue DAGCombiner::combineLoad(SDNode* n)
+        {
+            if (n->getNumOperands() < 2 || n->getNumValues() < 2) return SDValue();
+
+            DataType* vt  = n->getValueType(0);
+            MemLoc    loc = decompose(n->getOperand(1), accessSize(vt));
+
+            // 沿 Chain 向前查找同一位置最近的存储/加载，途经的访存必须可证明不重叠
+            SDValue chain = n->getOperand(0);
+            SDValue found;
+            for (int steps = 0; steps < kMaxChainWalk && chain.getNode(); ++steps)
+            {
+                SDNode* c = chain.getNode();
+                if (opOf(c) == ISD::STORE && c->getNumOperands() >= 3)
+                {
+                    SDValue val = c->getOperand(1);
+                    MemLoc  sl  = decompose(c->getOperand(2), accessSize(valueType(val)));
+                    if (mustAlias(loc, sl))
+                    {
+                        if (valueType(val) == vt) found = val;
+                        break;
+                    }
+                    if (!noAlias(loc, sl)) break;
+                    chain = c->getOperand(0);
+                    continue;
+                }
+                if (opOf(c) == ISD::LOAD && c->getNumOperands() >= 2 && c != n)
+                {
+                    if (c->getValueType(0) == vt && mustAlias(loc, decompose(c->getOperand(1), accessSize(vt))))
+                    {
+                        found = SDValue(c, 0);
+                        break;
+                    }
+                    chain = c->getOperand(0);
+                    continue;
+                }
+                break;  // ENTRY_TOKEN、CALL 等
+            }
+            if (!found) return SDValue();
+
+            // 先让依赖本加载的 Chain 接到其输入 Chain 上，再替换加载的值
+            replaceUses(n, 1, n->getOperand(0), false);
+            return found;
+        }
+
+        SDValue DAGCombiner::combine(SDNode* n)
+        {
+            ISD op = opOf(n);
+            if (op == ISD::LOAD) return combineLoad(n);
+
+            if (n->getNumOperands() != 2 || n->getNumValues() != 1) return SDValue();
+            if (op == ISD::ICMP)
+            {
+                if (!isIntType(valueType(n->getOperand(0)))) return SDValue();
+            }
+            else if (!isBinary(op) || !isIntType(n->getValueType(0)))
+                return SDValue();
+
+            if (SDValue v = foldConstants(n)) return v;
+            if (SDValue v = combineIdentities(n)) return v;
+            if (op == ISD::ICMP) return SDValue();
+            return combineReassociate(n);
+        }
+
+        void DAGCombiner::removeDeadNodes()
+        {
+            // 标记-清除：从不可删除的节点出发，沿操作数标记存活
+            std::unordered_set<SDNode*> live;
+            std::vector<SDNode*>        stack;
+            for (auto* n : dag_.getNodes())
+                if (!isRemovable(n) && live.insert(n).second) stack.push_back(n);
+            while (!stack.empty())
+            {
+                SDNode* n = stack.back();
+                stack.pop_back();
+                for (const auto& op : n->getOperands())
+                    if (op.getNode() && live.insert(op.getNode()).second) stack.push_back(op.getNode());
+            }
+
+            std::unordered_set<SDNode*> dead;
+            for (auto* n : dag_.getNodes())
+                if (!live.count(n)) dead.insert(n);
+            dag_.removeNodes(dead);
+        }
+
+        bool DAGCombiner::run()
+        {
+            worklist_.clear();
+            inWorklist_.clear();
+            known_.clear();
+            users_.clear();
+
+            // 节点按创建顺序（拓扑序）登记，操作数先于使用者被处理
+            for (auto* n : dag_.getNodes()) track(n);
+
+            bool   changed = false;
+            size_t budget  = dag_.getNodes().size() * 16 + 64;
+            while (!worklist_.empty() && budget-- > 0)
+            {
+                SDNode* n = worklist_.front();
+                worklist_.pop_front();
+                inWorklist_.erase(n);
+                if (isRemovable(n) && userCount(n) == 0) continue;  // 已失去全部使用者
+
+                SDValue v = combine(n);
+                if (!v || v.getNode() == n) continue;
+                replace(n, v);
+                changed = true;
+            }
+            if (!changed) return false;
+
+            removeDeadNodes();
+            return true;
+        }
+    }  // namespace DAG
+}  // namespace BE
@@ -0,0 +1,80 @@
+#ifndef __BACKEND_DAG_DAG_COMBINER_H__
+#define __BACKEND_DAG_DAG_COMBINER_H__
+
+#include <backend/dag/selection_dag.h>
+#include <backend/dag/isd.h>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * DAG 合并（目标无关，在各目标的 DAG 合法化之前运行）
+ *
+ * 以工作表驱动，对单个基本块的 SelectionDAG 反复做局部化简直到不动点：
+ * - 常量折叠：两个操作数均为常量的整数运算与整数比较
+ * - 代数恒等式：x+0、x*1、x&-1、x^x、x-x、0-(0-x)、移位 0 位等；常量统一放到右侧，x-C 规范为 x+(-C)
+ * - 常量重结合：(x op C1) op C2 => x op (C1 op C2)，(x<<a)<<b => x<<(a+b)
+ * - 地址偏移重结合：(x+C)+y => (x+y)+C，(x+C1)*C2 => x*C2+C1*C2，把常量推到地址表达式最外层，
+ *   使访存指令可以把它折叠进立即数字段，并让 a[i]、a[i+1] 共享同一基址
+ * - 块内 Chain 上的存储到加载转发：沿 Chain 向前遇到同地址同类型的 STORE/LOAD 时直接复用其值，
+ *   中间只允许可证明不重叠的访存（不同栈槽/全局符号，或同一基址上不相交的常量偏移）
+ *
+ * 被替换的节点若携带 IR 寄存器 ID（可能被其它块引用），则原地改写为 COPY 以继续定义该寄存器；
+ * 否则其使用者直接改用新值，失去使用者的纯计算节点在结束时删除。
+ * 携带 IR 寄存器 ID 的节点一律保留，是否需要定义由指令选择按 DAGBuilder::getCrossBlockUses() 判断；
+ * 该计数只统计经 REG 节点的跨块引用，合并只改写块内的 DAG 边，不会使其失效。
+ * 传入 crossBlockUses 时，确无跨块引用的节点才可视为单使用参与重结合，否则保守处理。
+ */
+namespace BE
+{
+    namespace DAG
+    {
+        class DAGCombiner
+        {
+          public:
+            DAGCombiner(SelectionDAG& dag, const std::unordered_map<size_t, int>* crossBlockUses = nullptr)
+                : dag_(dag), crossBlockUses_(crossBlockUses)
+            {}
+
+            /// 运行到不动点，返回 DAG 是否被修改
+            bool run();
+
+          private:
+            static constexpr int kMaxChainWalk = 64;  ///< 存储到加载转发沿 Chain 回溯的最大步数
+
+            SelectionDAG&                          dag_;
+            const std::unordered_map<size_t, int>* crossBlockUses_;
+
+            std::deque<SDNode*>                                worklist_;
+            std::unordered_set<SDNode*>                        inWorklist_;
+            std::unordered_set<SDNode*>                        known_;   ///< 属于本 DAG 的节点
+            std::unordered_map<SDNode*, std::vector<SDNode*>>  users_;   ///< 节点 -> 使用者（每条边一项）
+
+            void push(SDNode* n);
+            void track(SDNode* n);  // 登记新建节点的使用关系并加入工作表
+            int  userCount(SDNode* n) const;
+            bool hasSingleUse(SDNode* n) const;
+
+            SDValue getConst(int64_t value, DataType* vt);
+            SDValue getBinary(ISD op, DataType* vt, SDValue lhs, SDValue rhs);
+
+            /// 把 from 的第 resNo 个结果的所有使用改为 to（skipPhi 时保留 PHI 的入边）
+            void replaceUses(SDNode* from, uint32_t resNo, SDValue to, bool skipPhi);
+            /// n 不再使用其操作数
+            void detach(SDNode* n);
+            /// 用 v 替换节点 n 的值（结果 0）
+            void replace(SDNode* n, SDValue v);
+
+            SDValue combine(SDNode* n);
+            SDValue foldConstants(SDNode* n);
+            SDValue combineIdentities(SDNode* n);
+            SDValue combineReassociate(SDNode* n);
+            SDValue combineLoad(SDNode* n);
+
+            void removeDeadNodes();
+        };
+    }  // namespace DAG
+}  // namespace BE
+
+#endif  // __BACKEND_DAG_DAG_COMBINER_H__
@@ -1,6 +1,7 @@
 #ifndef __BACKEND_DAG_FOLDING_SET_H__
 #define __BACKEND_DAG_FOLDING_SET_H__
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <vector>
@@ -11,29 +12,49 @@ namespace BE
 {
     namespace DAG
     {
+        // 节点指纹：前 kInlineWords 个字存放在对象内部，只有携带长符号名等罕见情况才溢出到堆上；
+        // 哈希值在追加时增量计算（FNV-1a），查表时不必再遍历一遍
         class FoldingSetNodeID
         {
-            std::vector<uint32_t> bits_;
+            static constexpr unsigned kInlineWords = 40;
+            static constexpr uint64_t kFNVOffset   = 14695981039346656037ULL;
+            static constexpr uint64_t kFNVPrime    = 1099511628211ULL;
+
+            uint32_t              inline_[kInlineWords] = {};
+            unsigned              size_                 = 0;
+            std::vector<uint32_t> overflow_;
+            uint64_t              hash_ = kFNVOffset;
+
+            void push(uint32_t word)
+            {
+                hash_ ^= word;
+                hash_ *= kFNVPrime;
+                if (size_ < kInlineWords)
+                    inline_[size_] = word;
+                else
+                    overflow_.push_back(word);
+                ++size_;
+            }
 
           public:
             FoldingSetNodeID() = default;
 
             void AddInteger(int64_t value)
             {
-                bits_.push_back(static_cast<uint32_t>(value & 0xFFFFFFFF));
-                bits_.push_back(static_cast<uint32_t>((value >> 32) & 0xFFFFFFFF));
+                push(static_cast<uint32_t>(value & 0xFFFFFFFF));
+                push(static_cast<uint32_t>((value >> 32) & 0xFFFFFFFF));
             }
 
             void AddPointer(const void* ptr)
             {
                 uintptr_t val = reinterpret_cast<uintptr_t>(ptr);
-                bits_.push_back(static_cast<uint32_t>(val & 0xFFFFFFFF));
-                if (sizeof(void*) > 4) { bits_.push_back(static_cast<uint32_t>((val >> 32) & 0xFFFFFFFF)); }
+                push(static_cast<uint32_t>(val & 0xFFFFFFFF));
+                if (sizeof(void*) > 4) { push(static_cast<uint32_t>((static_cast<uint64_t>(val) >> 32) & 0xFFFFFFFF)); }
             }
 
             void AddString(const std::string& str)
             {
-                bits_.push_back(static_cast<uint32_t>(str.size()));
+                push(static_cast<uint32_t>(str.size()));
                 const char* data   = str.data();
                 size_t      len    = str.size();
                 size_t      offset = 0;
@@ -42,7 +63,7 @@ namespace BE
                     uint32_t chunk      = 0;
                     size_t   chunk_size = std::min<size_t>(4, len - offset);
                     std::memcpy(&chunk, data + offset, chunk_size);
-                    bits_.push_back(chunk);
+                    push(chunk);
                     offset += chunk_size;
                 }
             }
@@ -51,25 +72,20 @@ namespace BE
             {
                 uint32_t bits;
                 std::memcpy(&bits, &value, sizeof(float));
-                bits_.push_back(bits);
+                push(bits);
             }
 
-            void AddBoolean(bool value) { bits_.push_back(value ? 1 : 0); }
+            void AddBoolean(bool value) { push(value ? 1 : 0); }
 
-            uint64_t computeHash() const
+            uint64_t computeHash() const { return hash_; }
+
+            bool operator==(const FoldingSetNodeID& other) const
             {
-                // FNV-1a hash
-                uint64_t hash = 14695981039346656037ULL;
-                for (uint32_t bit : bits_)
-                {
-                    hash ^= bit;
-                    hash *= 1099511628211ULL;
-                }
-                return hash;
+                if (size_ != other.size_ || hash_ != other.hash_) return false;
+                unsigned n = std::min(size_, kInlineWords);
+                return std::memcmp(inline_, other.inline_, n * sizeof(uint32_t)) == 0 && overflow_ == other.overflow_;
             }
-
-            bool operator==(const FoldingSetNodeID& other) const { return bits_ == other.bits_; }
-            bool operator!=(const FoldingSetNodeID& other) const { return bits_ != other.bits_; }
+            bool operator!=(const FoldingSetNodeID& other) const { return !(*this == other); }
         };
 
     }  // namespace DAG
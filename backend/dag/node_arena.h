@@ -0,0 +1,75 @@
+#ifndef __BACKEND_DAG_NODE_ARENA_H__
+#define __BACKEND_DAG_NODE_ARENA_H__
+
+#include <backend/dag/sd_node.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace BE
+{
+    namespace DAG
+    {
+        /*
+         * SDNode 的指针碰撞分配器
+         *
+         * 节点在整块内存（slab）中顺序分配，不再逐个 new/delete。各基本块的 DAG 共享同一个
+         * arena（入口块的 FrameIndex 节点会被其它块引用，各块 DAG 需要同时存活），被 DAG 合并删除的
+         * 节点只执行析构并进入空闲链表，供后续建立的节点复用。arena 析构时一次性释放全部内存。
+         */
+        class NodeArena
+        {
+            static constexpr size_t kSlabNodes = 512;  ///< 每个 slab 可容纳的节点数
+            static constexpr size_t kNodeSize  = (sizeof(SDNode) + alignof(SDNode) - 1) / alignof(SDNode) * alignof(SDNode);
+
+            std::vector<std::unique_ptr<char[]>> slabs_;
+            char*                                cur_ = nullptr;
+            char*                                end_ = nullptr;
+            std::vector<void*>                   free_;
+
+            void* allocate()
+            {
+                if (!free_.empty())
+                {
+                    void* p = free_.back();
+                    free_.pop_back();
+                    return p;
+                }
+                if (cur_ == end_)
+                {
+                    slabs_.emplace_back(new char[kSlabNodes * kNodeSize]);
+                    cur_ = slabs_.back().get();
+                    end_ = cur_ + kSlabNodes * kNodeSize;
+                }
+                void* p = cur_;
+                cur_ += kNodeSize;
+                return p;
+            }
+
+          public:
+            NodeArena() = default;
+            NodeArena(const NodeArena&)            = delete;
+            NodeArena& operator=(const NodeArena&) = delete;
+
+            template <typename... Args>
+            SDNode* create(Args&&... args)
+            {
+                return new (allocate()) SDNode(std::forward<Args>(args)...);
+            }
+
+            // 析构节点并回收其槽位；内存本身直到 arena 析构才归还
+            void destroy(SDNode* n)
+            {
+                if (!n) return;
+                n->~SDNode();
+                free_.push_back(n);
+            }
+
+            size_t getNumSlabs() const { return slabs_.size(); }
+        };
+    }  // namespace DAG
+}  // namespace BE
+
+#endif  // __BACKEND_DAG_NODE_ARENA_H__
@@ -0,0 +1,140 @@
+#ifndef __BACKEND_DAG_NODE_TABLE_H__
+#define __BACKEND_DAG_NODE_TABLE_H__
+
+#include <backend/dag/selection_dag.h>
+#include <utils/dynamic_bitset.h>
+#include <debug.h>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * 以节点 ID 为下标的块内辅助表（指令选择使用）
+ *
+ * SelectionDAG 保证 getNodes()[n->getId()] == n，因此本块 DAG 的节点可直接按 ID 定位；
+ * 少数来自其它块 DAG 的操作数（入口块中 alloca 对应的 FrameIndex）没有本块内的 ID，
+ * 在调度时由 NodeNumbering 追加编号到本块节点之后。
+ * NodeSet / NodeMap 以该编号为下标，分别用位图与向量保存，避免逐节点的树结构查找。
+ */
+namespace BE
+{
+    namespace DAG
+    {
+        class NodeNumbering
+        {
+            const SelectionDAG*                       dag_ = nullptr;
+            std::unordered_map<const SDNode*, size_t> foreign_;
+
+          public:
+            static constexpr size_t npos = static_cast<size_t>(-1);
+
+            void reset(const SelectionDAG& dag)
+            {
+                dag_ = &dag;
+                foreign_.clear();
+            }
+
+            size_t size() const { return (dag_ ? dag_->getNodes().size() : 0) + foreign_.size(); }
+
+            /// 节点的编号；其它 DAG 的节点首次出现时分配新编号
+            size_t assign(const SDNode* n)
+            {
+                if (dag_->owns(n)) return n->getId();
+                size_t next = size();
+                return foreign_.emplace(n, next).first->second;
+            }
+
+            /// 节点的编号；未编号的外来节点返回 npos
+            size_t slot(const SDNode* n) const
+            {
+                if (dag_->owns(n)) return n->getId();
+                auto it = foreign_.find(n);
+                return it == foreign_.end() ? npos : it->second;
+            }
+        };
+
+        class NodeSet
+        {
+            const NodeNumbering* num_;
+            dynamic_bitset       bits_;
+
+          public:
+            explicit NodeSet(const NodeNumbering& num) : num_(&num) {}
+
+            /// 清空并按当前编号数重新定容
+            void clear()
+            {
+                bits_.resize(num_->size());
+                bits_.reset();
+            }
+
+            /// 插入节点，返回是否为新插入
+            bool insert(const SDNode* n)
+            {
+                size_t i = num_->slot(n);
+                ASSERT(i != NodeNumbering::npos && "node not numbered in current block");
+                if (i >= bits_.size()) bits_.resize(num_->size());
+                if (bits_.test(i)) return false;
+                bits_.set(i);
+                return true;
+            }
+
+            bool count(const SDNode* n) const
+            {
+                size_t i = num_->slot(n);
+                return i < bits_.size() && bits_.test(i);
+            }
+        };
+
+        template <typename T>
+        class NodeMap
+        {
+            const NodeNumbering* num_;
+            std::vector<T>       vals_;
+            dynamic_bitset       has_;
+
+          public:
+            explicit NodeMap(const NodeNumbering& num) : num_(&num) {}
+
+            /// 清空并按当前编号数重新定容
+            void clear()
+            {
+                vals_.clear();
+                vals_.resize(num_->size());
+                has_.resize(num_->size());
+                has_.reset();
+            }
+
+            T& operator[](const SDNode* n)
+            {
+                size_t i = num_->slot(n);
+                ASSERT(i != NodeNumbering::npos && "node not numbered in current block");
+                if (i >= vals_.size())
+                {
+                    vals_.resize(num_->size());
+                    has_.resize(num_->size());
+                }
+                has_.set(i);
+                return vals_[i];
+            }
+
+            /// 已记录时返回值的指针，否则返回 nullptr
+            const T* lookup(const SDNode* n) const
+            {
+                size_t i = num_->slot(n);
+                return i < has_.size() && has_.test(i) ? &vals_[i] : nullptr;
+            }
+
+            const T& at(const SDNode* n) const
+            {
+                const T* v = lookup(n);
+                ASSERT(v && "node not in map");
+                return *v;
+            }
+
+            bool count(const SDNode* n) const { return lookup(n) != nullptr; }
+        };
+    }  // namespace DAG
+}  // namespace BE
+
+#endif  // __BACKEND_DAG_NODE_TABLE_H__
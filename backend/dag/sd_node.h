@@ -71,6 +71,16 @@ namespace BE
             }
             void replaceOperands(const std::vector<SDValue>& ops) { operands_ = ops; }//替换操作数
 
+            // 原地把节点改写为另一种操作，保留 IR 寄存器 ID 等身份信息（DAG 合并时使用）
+            void morphTo(uint32_t opcode, const std::vector<DataType*>& vts, const std::vector<SDValue>& ops)
+            {
+                opcode_      = opcode;
+                value_types_ = vts;
+                operands_    = ops;
+                has_imm_i64_ = false;
+                has_imm_f32_ = false;
+            }
+
             unsigned getNumOperands() const { return operands_.size(); }//获取操作数数量
             unsigned getNumValues() const { return value_types_.size(); }//获取结果数量
 
@@ -116,66 +126,109 @@ namespace BE
             bool hasFrameIndex() const { return has_frame_index_; }//是否有栈帧索引
             int  getFrameIndex() const { return frame_index_; }//获取栈帧索引
 
+            // 节点的可选属性，用于在不构造节点的情况下计算指纹
+            struct Attrs
+            {
+                bool               has_imm_i64     = false;
+                int64_t            imm_i64         = 0;
+                bool               has_imm_f32     = false;
+                float              imm_f32         = 0.0f;
+                const std::string* symbol          = nullptr;
+                bool               has_frame_index = false;
+                int                frame_index     = -1;
+                bool               has_ir_reg_id   = false;
+                size_t             ir_reg_id       = 0;
+            };
+
+            Attrs getAttrs() const
+            {
+                Attrs a;
+                a.has_imm_i64     = has_imm_i64_;
+                a.imm_i64         = imm_i64_;
+                a.has_imm_f32     = has_imm_f32_;
+                a.imm_f32         = imm_f32_;
+                a.symbol          = has_symbol_ ? &symbol_ : nullptr;
+                a.has_frame_index = has_frame_index_;
+                a.frame_index     = frame_index_;
+                a.has_ir_reg_id   = has_ir_reg_id_;
+                a.ir_reg_id       = ir_reg_id_;
+                return a;
+            }
+
+            // 把属性写回节点（新建节点时使用）
+            void applyAttrs(const Attrs& a)
+            {
+                if (a.has_imm_i64) setImmI64(a.imm_i64);
+                if (a.has_imm_f32) setImmF32(a.imm_f32);
+                if (a.symbol) setSymbol(*a.symbol);
+                if (a.has_frame_index) setFrameIndex(a.frame_index);
+                if (a.has_ir_reg_id) setIRRegId(a.ir_reg_id);
+            }
+
             //把节点的所有重要属性添加到 FoldingSetNodeID， DAG 节点生成一个唯一的标识（指纹/哈希），用于判断两个节点是否完全相同。
-            void Profile(FoldingSetNodeID& ID) const//用于FoldingSet的Profile
+            void Profile(FoldingSetNodeID& ID) const { Profile(ID, opcode_, value_types_, operands_, getAttrs()); }
+
+            // 由节点的组成部分直接计算指纹，SelectionDAG 查找 CSE 表时无需先构造临时节点
+            static void Profile(FoldingSetNodeID& ID, uint32_t opcode, const std::vector<DataType*>& vts,
+                const std::vector<SDValue>& ops, const Attrs& attrs)
             {
                 // 1. 操作码（ADD? MUL? LOAD?）
-                ID.AddInteger(opcode_);
+                ID.AddInteger(opcode);
 
                  // 2. 操作数和结果类型的数量
-                ID.AddInteger(operands_.size());
-                ID.AddInteger(value_types_.size());
+                ID.AddInteger(ops.size());
+                ID.AddInteger(vts.size());
 
                 // 3. 每个操作数（哪个节点的第几个结果）
-                for (const auto& op : operands_)
+                for (const auto& op : ops)
                 {
                     ID.AddPointer(op.getNode());
                     ID.AddInteger(op.getResNo());
                 }
 
                 // 4. 每个结果类型
-                for (auto* vt : value_types_) ID.AddPointer(vt);
+                for (auto* vt : vts) ID.AddPointer(vt);
 
                 // 5. 可选属性：立即数、符号、栈帧索引等
-                if (has_imm_i64_)
+                if (attrs.has_imm_i64)
                 {
                     ID.AddBoolean(true);
-                    ID.AddInteger(imm_i64_);
+                    ID.AddInteger(attrs.imm_i64);
                 }
                 else
                     ID.AddBoolean(false);
 
-                if (has_imm_f32_)
+                if (attrs.has_imm_f32)
                 {
                     ID.AddBoolean(true);
-                    ID.AddFloat(imm_f32_);
+                    ID.AddFloat(attrs.imm_f32);
                 }
                 else
                     ID.AddBoolean(false);
 
-                if (has_symbol_)
+                if (attrs.symbol)
                 {
                     ID.AddBoolean(true);
-                    ID.AddString(symbol_);
+                    ID.AddString(*attrs.symbol);
                 }
                 else
                     ID.AddBoolean(false);
 
-                if (has_frame_index_)
+                if (attrs.has_frame_index)
                 {
                     ID.AddBoolean(true);
-                    ID.AddInteger(frame_index_);
+                    ID.AddInteger(attrs.frame_index);
                 }
                 else
                     ID.AddBoolean(false);
 
-                // 6. REG 节点特殊处理：加入 IR 寄存器 ID
-                if (opcode_ == static_cast<unsigned>(ISD::REG))
+                // 6. REG 与 COPY 节点特殊处理：加入 IR 寄存器 ID（定义不同寄存器的 COPY 不能合并）
+                if (opcode == static_cast<unsigned>(ISD::REG) || opcode == static_cast<unsigned>(ISD::COPY))
                 {
-                    if (has_ir_reg_id_)
+                    if (attrs.has_ir_reg_id)
                     {
                         ID.AddBoolean(true);
-                        ID.AddInteger(ir_reg_id_);
+                        ID.AddInteger(attrs.ir_reg_id);
                     }
                     else
                         ID.AddBoolean(false);
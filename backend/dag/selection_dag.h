@@ -3,192 +3,164 @@
 
 #include <backend/dag/sd_node.h>
 #include <backend/dag/folding_set.h>
+#include <backend/dag/node_arena.h>
 #include <backend/dag/isd.h>
 #include <vector>
 #include <memory>
+#include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace BE
 {
     namespace DAG
     {
         // SelectionDAG: 选择 DAG，用于表示目标无关的中间表示
+        // 节点从 NodeArena 中分配：可由外部传入同一函数各块共享的 arena，否则使用自有的 arena
         class SelectionDAG
         {
+            std::unique_ptr<NodeArena>                    own_arena_;// 未指定外部 arena 时自有的 arena
+            NodeArena*                                    arena_;// 节点分配器
             std::vector<SDNode*>                          nodes_;// 节点列表
             uint32_t                                      next_id_ = 0;// 下一个节点 ID
             std::unordered_map<FoldingSetNodeID, SDNode*> folding_set_;// 节点折叠集合
 
-          public:
-            SelectionDAG() = default;
-            ~SelectionDAG()
+            // 所有节点创建的公共路径：直接由组成部分计算指纹查 CSE 表，命中则复用，否则在 arena 中新建
+            SDValue getOrCreate(uint32_t opcode, const std::vector<DataType*>& vts, const std::vector<SDValue>& ops,
+                const SDNode::Attrs& attrs)
             {
-                for (auto* n : nodes_)
-                {
-                    if (!n) continue;
-                    delete n;
-                    n = nullptr;
-                }
-            }
-
-            // 获取节点，参数：
-            // opcode: 操作码
-            // vts: 结果类型列表
-            // ops: 操作数列表
-            SDValue getNode(uint32_t opcode, const std::vector<DataType*>& vts, const std::vector<SDValue>& ops)
-            {
-                SDNode temp(opcode, vts, ops);//建立临时节点
-
                 FoldingSetNodeID ID;//节点 ID
-                temp.Profile(ID);//计算节点 ID
+                SDNode::Profile(ID, opcode, vts, ops, attrs);//计算节点 ID
 
                 auto it = folding_set_.find(ID);//查找节点
                 if (it != folding_set_.end()) return SDValue(it->second, 0);//如果找到，返回节点
 
-                auto* n = new SDNode(opcode, vts, ops);//创建节点
+                auto* n = arena_->create(opcode, vts, ops);//创建节点
+                n->applyAttrs(attrs);
                 nodes_.push_back(n);
                 n->setId(next_id_++);//设置节点 ID
 
-                folding_set_[ID] = n;//将节点加入折叠集合
-
-                //其余类型的节点与这个流程类似
+                folding_set_.emplace(std::move(ID), n);//将节点加入折叠集合
 
                 return SDValue(n, 0);
             }
 
+          public:
+            SelectionDAG() : own_arena_(std::make_unique<NodeArena>()), arena_(own_arena_.get()) {}
+            explicit SelectionDAG(NodeArena& arena) : arena_(&arena) {}
+            SelectionDAG(const SelectionDAG&)            = delete;
+            SelectionDAG& operator=(const SelectionDAG&) = delete;
+            ~SelectionDAG()
+            {
+                for (auto* n : nodes_) arena_->destroy(n);
+            }
+
+            // 获取节点，参数：
+            // opcode: 操作码
+            // vts: 结果类型列表
+            // ops: 操作数列表
+            SDValue getNode(uint32_t opcode, const std::vector<DataType*>& vts, const std::vector<SDValue>& ops)
+            {
+                return getOrCreate(opcode, vts, ops, SDNode::Attrs());
+            }
+
             // 获取符号节点
             SDValue getSymNode(uint32_t opcode, const std::vector<DataType*>& vts, const std::vector<SDValue>& ops,
                 const std::string& symbol)
             {
-                SDNode temp(opcode, vts, ops);
-                temp.setSymbol(symbol);
-
-                FoldingSetNodeID ID;
-                temp.Profile(ID);
-
-                auto it = folding_set_.find(ID);
-                if (it != folding_set_.end()) return SDValue(it->second, 0);
-
-                auto* n = new SDNode(opcode, vts, ops);
-                n->setSymbol(symbol);//设置符号
-                nodes_.push_back(n);
-                n->setId(next_id_++);//设置节点 ID
-
-                folding_set_[ID] = n;//将节点加入折叠集合
-
-                return SDValue(n, 0);
+                SDNode::Attrs attrs;
+                attrs.symbol = &symbol;
+                return getOrCreate(opcode, vts, ops, attrs);
             }
 
             // 获取立即数节点
             SDValue getImmNode(
                 uint32_t opcode, const std::vector<DataType*>& vts, const std::vector<SDValue>& ops, int64_t imm)
             {
-                SDNode temp(opcode, vts, ops);
-                temp.setImmI64(imm);
-
-                FoldingSetNodeID ID;
-                temp.Profile(ID);
-
-                auto it = folding_set_.find(ID);
-                if (it != folding_set_.end()) return SDValue(it->second, 0);
-
-                auto* n = new SDNode(opcode, vts, ops);
-                n->setImmI64(imm);
-                nodes_.push_back(n);
-                n->setId(next_id_++);
-
-                folding_set_[ID] = n;
-
-                return SDValue(n, 0);
+                SDNode::Attrs attrs;
+                attrs.has_imm_i64 = true;
+                attrs.imm_i64     = imm;
+                return getOrCreate(opcode, vts, ops, attrs);
             }
 
             // 获取栈帧索引节点
             SDValue getFrameIndexNode(int frame_index, DataType* ptr_ty)
             {
-                SDNode temp(static_cast<unsigned>(ISD::FRAME_INDEX), {ptr_ty}, {});
-                temp.setFrameIndex(frame_index);
-
-                FoldingSetNodeID ID;
-                temp.Profile(ID);
-
-                auto it = folding_set_.find(ID);
-                if (it != folding_set_.end()) return SDValue(it->second, 0);
-
-                auto* n = new SDNode(static_cast<unsigned>(ISD::FRAME_INDEX), {ptr_ty}, {});
-                n->setFrameIndex(frame_index);
-                nodes_.push_back(n);
-                n->setId(next_id_++);
-
-                folding_set_[ID] = n;
-
-                return SDValue(n, 0);
+                SDNode::Attrs attrs;
+                attrs.has_frame_index = true;
+                attrs.frame_index     = frame_index;
+                return getOrCreate(static_cast<unsigned>(ISD::FRAME_INDEX), {ptr_ty}, {}, attrs);
             }
 
             // 获取寄存器节点
             SDValue getRegNode(size_t ir_reg_id, DataType* vt)
             {
-                SDNode temp(static_cast<unsigned>(ISD::REG), {vt}, {});
-                temp.setIRRegId(ir_reg_id);
-
-                FoldingSetNodeID ID;
-                temp.Profile(ID);
-
-                auto it = folding_set_.find(ID);
-                if (it != folding_set_.end()) return SDValue(it->second, 0);
-
-                auto* n = new SDNode(static_cast<unsigned>(ISD::REG), {vt}, {});
-                n->setIRRegId(ir_reg_id);
-                nodes_.push_back(n);
-                n->setId(next_id_++);
-
-                folding_set_[ID] = n;
+                SDNode::Attrs attrs;
+                attrs.has_ir_reg_id = true;
+                attrs.ir_reg_id     = ir_reg_id;
+                return getOrCreate(static_cast<unsigned>(ISD::REG), {vt}, {}, attrs);
+            }
 
-                return SDValue(n, 0);
+            // 获取定义 IR 寄存器 ir_reg_id 的 COPY 节点（IR 寄存器 ID 参与 CSE，不同寄存器的副本互不合并）
+            SDValue getCopyNode(const SDValue& src, size_t ir_reg_id)
+            {
+                SDNode::Attrs attrs;
+                attrs.has_ir_reg_id = true;
+                attrs.ir_reg_id     = ir_reg_id;
+                return getOrCreate(static_cast<unsigned>(ISD::COPY),
+                    {src.getNode()->getValueType(src.getResNo())}, {src}, attrs);
             }
 
             // 获取常量节点
             SDValue getConstantI64(int64_t value, DataType* vt)
             {
-                SDNode temp(static_cast<unsigned>(ISD::CONST_I64), {vt}, {});
-                temp.setImmI64(value);
-
-                FoldingSetNodeID ID;
-                temp.Profile(ID);
-
-                auto it = folding_set_.find(ID);
-                if (it != folding_set_.end()) { return SDValue(it->second, 0); }
-
-                auto* n = new SDNode(static_cast<unsigned>(ISD::CONST_I64), {vt}, {});
-                n->setImmI64(value);
-                nodes_.push_back(n);
-                n->setId(next_id_++);
-                folding_set_[ID] = n;
-
-                return SDValue(n, 0);
+                SDNode::Attrs attrs;
+                attrs.has_imm_i64 = true;
+                attrs.imm_i64     = value;
+                return getOrCreate(static_cast<unsigned>(ISD::CONST_I64), {vt}, {}, attrs);
             }
 
             // 获取常量节点
             SDValue getConstantF32(float value, DataType* vt)
             {
-                SDNode temp(static_cast<unsigned>(ISD::CONST_F32), {vt}, {});
-                temp.setImmF32(value);
+                SDNode::Attrs attrs;
+                attrs.has_imm_f32 = true;
+                attrs.imm_f32     = value;
+                return getOrCreate(static_cast<unsigned>(ISD::CONST_F32), {vt}, {}, attrs);
+            }
 
-                FoldingSetNodeID ID;
-                temp.Profile(ID);
+            // 节点按创建顺序（拓扑序）排列，节点 ID 即其在此列表中的下标
+            const std::vector<SDNode*>& getNodes() const { return nodes_; }
+            bool owns(const SDNode* n) const { return n->getId() < nodes_.size() && nodes_[n->getId()] == n; }
 
+            // 原地修改节点前将其移出 CSE 表，修改后重新加入，避免以旧指纹命中被改写的节点
+            void removeFromCSE(SDNode* n)
+            {
+                FoldingSetNodeID ID;
+                n->Profile(ID);
                 auto it = folding_set_.find(ID);
-                if (it != folding_set_.end()) { return SDValue(it->second, 0); }
-
-                auto* n = new SDNode(static_cast<unsigned>(ISD::CONST_F32), {vt}, {});
-                n->setImmF32(value);
-                nodes_.push_back(n);
-                n->setId(next_id_++);
-                folding_set_[ID] = n;
-
-                return SDValue(n, 0);
+                if (it != folding_set_.end() && it->second == n) folding_set_.erase(it);
+            }
+            void addToCSE(SDNode* n)
+            {
+                FoldingSetNodeID ID;
+                n->Profile(ID);
+                folding_set_.emplace(ID, n);  // 已有等价节点时保留原节点
             }
 
-            const std::vector<SDNode*>& getNodes() const { return nodes_; }
+            // 删除一组已无使用者的节点
+            void removeNodes(const std::unordered_set<SDNode*>& dead)
+            {
+                if (dead.empty()) return;
+                for (auto* n : dead) removeFromCSE(n);
+                nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(),
+                                 [&dead](SDNode* n) { return dead.count(n) != 0; }),
+                    nodes_.end());
+                for (auto* n : dead) arena_->destroy(n);
+                // 压缩后重新编号，保持 ID 与下标一致
+                for (uint32_t i = 0; i < nodes_.size(); ++i) nodes_[i]->setId(i);
+                next_id_ = static_cast<uint32_t>(nodes_.size());
+            }
         };
 
     }  // namespace DAG
@@ -5,6 +5,7 @@
 #include <middleend/ir_visitor.h>
 #include <backend/mir/m_module.h>
 #include <map>
+#include <vector>
 
 
 //指令选择器基类
@@ -27,6 +28,48 @@ namespace BE
     };
 
     using IRIselBase = ME::Visitor_t<void>;
+
+    // GEP 元素宽度（字节）
+    inline int gepElemByteSize(ME::DataType t)
+    {
+        switch (t)
+        {
+            case ME::DataType::I64:
+            case ME::DataType::PTR:
+            case ME::DataType::DOUBLE: return 8;
+            default: return 4;
+        }
+    }
+
+    // 每个 GEP 索引对应的字节步长：多维数组按维度展开
+    // 例如 a[i][j] 对于 [M x N] 数组，偏移 = (i * N + j) * elemSize
+    inline std::vector<int64_t> gepByteStrides(const ME::GEPInst& inst)
+    {
+        int elemSize = gepElemByteSize(inst.dt);
+
+        // 预计算后缀乘积 stride，suffixProd[k] = dims[k] * dims[k+1] * ...
+        std::vector<int64_t> suffixProd(inst.dims.size() + 1, 1);
+        for (int i = static_cast<int>(inst.dims.size()) - 1; i >= 0; --i)
+            suffixProd[i] = suffixProd[i + 1] * inst.dims[i];
+
+        // LLVM/GEP-style索引通常会带一个 leading idx（对 alloca/全局数组常为 0），
+        // 当 idx 数量不少于维度数时需要将第一个 idx 单独处理。
+        bool hasLeadingIdx = inst.idxs.size() >= inst.dims.size();
+
+        std::vector<int64_t> strides;
+        for (size_t i = 0; i < inst.idxs.size(); ++i)
+        {
+            // idx0 对应整个数组，步长为全维度乘积
+            size_t  dimIdx     = (hasLeadingIdx && i > 0) ? i - 1 : i;
+            int64_t elemStride = 1;
+            if (hasLeadingIdx && i == 0)
+                elemStride = suffixProd[0];
+            else if (dimIdx < suffixProd.size() - 1)
+                elemStride = suffixProd[dimIdx + 1];
+            strides.push_back(elemStride * elemSize);
+        }
+        return strides;
+    }
 }  // namespace BE
 
 #endif  // __BACKEND_ISEL_ISEL_BASE_H__
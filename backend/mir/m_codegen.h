@@ -6,6 +6,7 @@
 #include <backend/mir/m_block.h>
 #include <backend/mir/m_instruction.h>
 #include <backend/mir/m_defs.h>
+#include <out_buffer.h>
 #include <iostream>
 
 namespace BE
@@ -19,7 +20,7 @@ namespace BE
         /**
          * @brief 构造函数
          * @param module 指向待生成的 MIR 模块
-         * @param output 汇编代码输出流
+         * @param output 汇编代码输出流（经 OutBuffer 缓冲后整块写出）
          */
         MCodeGen(Module* module, std::ostream& output)
             : module_(module), out_(output), cur_func_(nullptr), cur_block_(nullptr)
@@ -34,7 +35,7 @@ namespace BE
 
       protected:
         Module*       module_;    ///< 当前处理的模块
-        std::ostream& out_;       ///< 汇编输出流
+        OutBuffer     out_;       ///< 汇编输出缓冲，析构时写回输出流
         Function*     cur_func_;  ///< 当前正在生成的函数
         Block*        cur_block_; ///< 当前正在生成的块
 
@@ -1,5 +1,6 @@
 #include <backend/mir/m_defs.h>
 #include <backend/mir/m_instruction.h>
+#include <backend/mir/m_function.h>
 #include <interfaces/middleend/ir_defs.h>
 #include <debug.h>
 
@@ -20,11 +21,19 @@ namespace BE
     DataType* PTR   = &PTRINSTANCE;
     DataType* TOKEN = &TOKENINSTANCE;
 
-    //虚拟寄存器分配器，每次调用返回一个全局唯一的新虚拟寄存器
+    namespace
+    {
+        thread_local Function* curFunc = nullptr;
+    }  // namespace
+
+    VRegScope::VRegScope(Function* func) : prevFunc(curFunc) { curFunc = func; }
+    VRegScope::~VRegScope() { curFunc = prevFunc; }
+
+    //虚拟寄存器分配器，每次调用返回当前函数内唯一的新虚拟寄存器
     Register getVReg(DataType* dt)
     {
-        static uint32_t vreg_count = 0;
-        return Register(vreg_count++, dt, true);
+        ASSERT(curFunc && "getVReg called outside of a VRegScope");
+        return Register(curFunc->vregCount++, dt, true);
     }
 
     MoveInst* createMove(Operand* dst, Operand* src, const std::string& c) { return new MoveInst(src, dst, c); }
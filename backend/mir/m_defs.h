@@ -226,7 +226,28 @@ namespace BE
   lw a0, 16(sp)           // 物理寄存器
 */
 
-    /// 分配并获取一个新的虚拟寄存器
+    class Function;
+
+    /**
+     * @brief 虚拟寄存器编号的作用域
+     *
+     * 虚拟寄存器按函数独立编号，计数器存放在 Function::vregCount 中。
+     * VRegScope 声明当前线程正在处理的函数，其生命周期内 getVReg 从该函数的计数器取号；
+     * 不同线程各自持有作用域，因此可以并发处理不同函数。作用域可以嵌套，析构时恢复外层的函数。
+     */
+    class VRegScope
+    {
+      private:
+        Function* prevFunc;
+
+      public:
+        explicit VRegScope(Function* func);
+        ~VRegScope();
+        VRegScope(const VRegScope&)            = delete;
+        VRegScope& operator=(const VRegScope&) = delete;
+    };
+
+    /// 在当前 VRegScope 对应的函数中分配并获取一个新的虚拟寄存器
     Register getVReg(DataType* dt);
 }  // namespace BE
 
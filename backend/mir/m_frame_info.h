@@ -36,6 +36,7 @@ namespace BE
             int        alignment = 16;  // 对齐要求
             int        offset    = -1;  // 相对于栈指针的偏移量（初始化为-1表示未分配）
             ObjectKind kind      = ObjectKind::LocalVar; // 对象种类
+            uint64_t   weight    = 0;   // 访问频度估计（溢出槽按此排序，越热越靠近栈指针）
         };
 
       private:
@@ -100,11 +101,12 @@ namespace BE
         /**
          * @brief 创建溢出槽
          * 供寄存器分配器使用，返回溢出槽的索引（FI）。
+         * weight 为该槽的访问频度估计，越热的槽布局时越靠近栈指针（偏移小，便于使用短编码访存）。
          */
-        int createSpillSlot(int sizeBytes, int alignment = 8)
+        int createSpillSlot(int sizeBytes, int alignment = 8, uint64_t weight = 0)
         {
             int fi = static_cast<int>(spillSlots_.size());
-            spillSlots_.push_back(FrameObject{sizeBytes, std::max(8, alignment), -1, ObjectKind::SpillSlot});
+            spillSlots_.push_back(FrameObject{sizeBytes, std::max(8, alignment), -1, ObjectKind::SpillSlot, weight});
             return fi;
         }
 
@@ -119,6 +121,16 @@ namespace BE
             return it->second.offset < 0 ? -1 : it->second.offset + baseOffset_;
         }
 
+        /**
+         * @brief 获取局部变量的对齐要求（字节）
+         * 影响：内联展开的访存（如 memset 展开）可选用的最宽访存指令。不存在时返回 0。
+         */
+        int getObjectAlignment(size_t irRegId) const
+        {
+            auto it = irRegToObject_.find(irRegId);
+            return it == irRegToObject_.end() ? 0 : it->second.alignment;
+        }
+
         /**
          * @brief 获取溢出槽相对于 SP 的最终偏移
          * 影响：溢出恢复（Reload）和溢出存储（Spill）指令。
@@ -151,7 +163,9 @@ namespace BE
 
         /**
          * @brief 计算所有栈对象的具体偏移量
-         * 按照 传参区 -> 局部变量 -> 溢出槽 的顺序进行布局。
+         * 按照 传参区 -> 溢出槽（按访问频度降序）-> 局部变量 的顺序进行布局。
+         * 溢出槽逐条以 SP 加立即数访问，放在前面能让热的槽落入短编码访存的偏移范围；
+         * 局部变量多为数组，经一次取址后按基址访问，对偏移大小不敏感。
          * 影响：确定所有栈上数据的物理位置。
          */
         int calculateOffsets()
@@ -159,7 +173,20 @@ namespace BE
             // 1. 初始化偏移量，从参数区域末尾开始分配
             int currentOffset = paramSize_;
 
-            // 2. 布局局部变量：根据每个对象的对齐要求计算偏移并更新当前位置
+            // 2. 布局溢出槽：频度相同的保持创建顺序
+            std::vector<size_t> order(spillSlots_.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.end(),
+                [&](size_t a, size_t b) { return spillSlots_[a].weight > spillSlots_[b].weight; });
+            for (size_t i : order)
+            {
+                auto& slot    = spillSlots_[i];
+                currentOffset = alignTo(currentOffset, slot.alignment);
+                slot.offset   = currentOffset;
+                currentOffset += slot.size;
+            }
+
+            // 3. 布局局部变量：根据每个对象的对齐要求计算偏移并更新当前位置
             for (auto& [irRegId, obj] : irRegToObject_)
             {
                 currentOffset = alignTo(currentOffset, obj.alignment);
@@ -167,14 +194,6 @@ namespace BE
                 currentOffset += obj.size;
             }
 
-            // 3. 布局溢出槽：在局部变量之后分配溢出槽空间
-            for (auto& slot : spillSlots_)
-            {
-                currentOffset = alignTo(currentOffset, slot.alignment);
-                slot.offset   = currentOffset;
-                currentOffset += slot.size;
-            }
-
             // 4. 最后按栈帧基准对齐要求（如 16 字节）进行向上对齐
             return alignTo(currentOffset, baseAlign_);
         }
@@ -212,6 +231,10 @@ namespace BE
             {
                 if (obj.offset >= 0) currentOffset = std::max(currentOffset, obj.offset + obj.size);
             }
+            for (const auto& slot : spillSlots_)
+            {
+                if (slot.offset >= 0) currentOffset = std::max(currentOffset, slot.offset + slot.size);
+            }
 
             // 4. 按照对齐要求计算新对象的起始偏移并记录
             currentOffset                  = alignTo(currentOffset, alignment);
@@ -36,6 +36,8 @@ namespace BE
         int                        paramSize     = 0;      ///< 调用其他函数时，传出参数区的大小
         std::vector<MInstruction*> allocInsts;             ///< 待处理的 alloca 指令列表，用于计算栈空间
         MFrameInfo                 frameInfo;              ///< 栈帧详细信息管理器
+        std::vector<uint32_t>      constPool;              ///< 只读常量池：按位模式存放的 32 位常量，由常量实例化 Pass 填充
+        uint32_t                   vregCount = 0;          ///< 已分配的虚拟寄存器数，见 VRegScope
 
       public:
         Function(const std::string& name)
@@ -0,0 +1,274 @@
+#include <backend/ra/block_local.h>
+#include <backend/mir/m_function.h>
+#include <backend/mir/m_instruction.h>
+#include <backend/mir/m_block.h>
+#include <backend/mir/m_defs.h>
+#include <backend/target/target_reg_info.h>
+#include <backend/target/target_instr_adapter.h>
+#include <debug.h>
+
+#include <deque>
+#include <set>
+
+namespace BE::RA
+{
+    namespace
+    {
+        bool isFloatType(BE::DataType* dt) { return dt && dt->dt == BE::DataType::Type::FLOAT; }
+
+        void initClass(std::vector<int>& regs, const std::vector<int>& calleeSaved, const std::set<int>& reserved)
+        {
+            regs.clear();
+            for (int r : calleeSaved)
+                if (!reserved.count(r)) regs.push_back(r);
+        }
+    }  // namespace
+
+    BlockLocalRA::VRegState* BlockLocalRA::lookup(const BE::Register& r)
+    {
+        if (!r.isVreg) return nullptr;
+        auto it = index_.find(r.rId);
+        return it == index_.end() ? nullptr : &vregs_[it->second];
+    }
+
+    BlockLocalRA::RegClass& BlockLocalRA::classOf(const VRegState& v)
+    {
+        return isFloatType(v.reg.dt) ? floatRegs_ : intRegs_;
+    }
+
+    int BlockLocalRA::slotOf(VRegState& v)
+    {
+        if (v.spillSlot < 0) v.spillSlot = func_->frameInfo.createSpillSlot(v.reg.dt ? v.reg.dt->getDataWidth() : 8);
+        return v.spillSlot;
+    }
+
+    void BlockLocalRA::collect(BE::Function& func)
+    {
+        // 一遍扫描区分块内值与跨块值：出现在多个块中，或在块内先于定义被使用（如自环回边上的值）
+        vregs_.clear();
+        index_.clear();
+        std::vector<BE::Register> regs;
+        int                       serial = 0;
+
+        auto touch = [&](const BE::Register& r, bool isUse) {
+            if (!r.isVreg) return;
+            auto [it, inserted] = index_.emplace(r.rId, static_cast<int>(vregs_.size()));
+            if (inserted) vregs_.push_back(VRegState{r});
+            VRegState& v = vregs_[it->second];
+            if (v.firstBlock < 0)
+            {
+                v.firstBlock = serial;
+                v.global     = isUse;
+            }
+            else if (v.firstBlock != serial)
+                v.global = true;
+        };
+
+        for (auto& [bid, block] : func.blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                adapter_->enumUses(inst, regs);
+                for (auto& r : regs) touch(r, true);
+                adapter_->enumDefs(inst, regs);
+                for (auto& r : regs) touch(r, false);
+            }
+            ++serial;
+        }
+    }
+
+    void BlockLocalRA::release(VRegState& v)
+    {
+        if (v.phys < 0) return;
+        RegClass& rc = classOf(v);
+        for (size_t i = 0; i < rc.regs.size(); ++i)
+        {
+            if (rc.regs[i] != v.phys) continue;
+            rc.holder[i] = -1;
+            break;
+        }
+        v.phys  = -1;
+        v.dirty = false;
+    }
+
+    int BlockLocalRA::pickReg(RegClass& rc, std::vector<BE::MInstruction*>& before)
+    {
+        // 优先编号最小的空闲寄存器，减少被调用者保存寄存器的保存/恢复
+        for (size_t i = 0; i < rc.regs.size(); ++i)
+            if (rc.holder[i] < 0) return static_cast<int>(i);
+
+        // 无空闲：驱逐未被当前指令占用、块内最晚才结束的值
+        int victim = -1;
+        for (size_t i = 0; i < rc.regs.size(); ++i)
+        {
+            if (rc.pinned[i]) continue;
+            if (victim < 0 || vregs_[rc.holder[i]].lastUse > vregs_[rc.holder[victim]].lastUse)
+                victim = static_cast<int>(i);
+        }
+        ASSERT(victim >= 0 && "BlockLocalRA: no register available");
+
+        VRegState& v = vregs_[rc.holder[victim]];
+        if (v.dirty)
+            before.push_back(new BE::FIStoreInst(BE::Register(v.phys, v.reg.dt, false), slotOf(v), "spill to spill slot"));
+        release(v);
+        return victim;
+    }
+
+    void BlockLocalRA::flushGlobals(std::vector<BE::MInstruction*>& out)
+    {
+        for (RegClass* rc : {&intRegs_, &floatRegs_})
+        {
+            for (int h : rc->holder)
+            {
+                if (h < 0) continue;
+                VRegState& v = vregs_[h];
+                if (!v.global || !v.dirty) continue;
+                out.push_back(new BE::FIStoreInst(BE::Register(v.phys, v.reg.dt, false), slotOf(v), "spill live-out"));
+                v.dirty = false;
+            }
+        }
+    }
+
+    void BlockLocalRA::allocateBlock(BE::Block* block)
+    {
+        const auto*               adapter = adapter_;
+        std::vector<BE::Register> uses, defs;
+
+        // 逆序一遍得到块内每个值的最后使用位置
+        for (int idx = static_cast<int>(block->insts.size()) - 1; idx >= 0; --idx)
+        {
+            adapter->enumUses(block->insts[idx], uses);
+            for (auto& u : uses)
+            {
+                VRegState* v = lookup(u);
+                if (!v || v->lastStamp == stamp_) continue;
+                v->lastStamp = stamp_;
+                v->lastUse   = idx;
+            }
+        }
+
+        std::deque<BE::MInstruction*> out;
+        bool                          flushed = false;
+        int                           idx     = 0;
+        for (auto* inst : block->insts)
+        {
+            std::vector<BE::MInstruction*> before, after;
+
+            bool isTerm = adapter->isCondBranch(inst) || adapter->isUncondBranch(inst) || adapter->isReturn(inst);
+            if (isTerm && !flushed)
+            {
+                // 返回时跨块值不再被使用，无需写回
+                if (!adapter->isReturn(inst)) flushGlobals(before);
+                flushed = true;
+            }
+
+            adapter->enumUses(inst, uses);
+            adapter->enumDefs(inst, defs);
+
+            // 1. 使用：不在寄存器中的值从栈槽重载
+            for (auto& u : uses)
+            {
+                VRegState* v = lookup(u);
+                if (!v) continue;
+                RegClass& rc = classOf(*v);
+                if (v->phys < 0)
+                {
+                    int i       = pickReg(rc, before);
+                    v->phys     = rc.regs[i];
+                    rc.holder[i] = static_cast<int>(v - vregs_.data());
+                    before.push_back(new BE::FILoadInst(BE::Register(v->phys, u.dt, false), slotOf(*v), "reload from spill slot"));
+                }
+                for (size_t i = 0; i < rc.regs.size(); ++i)
+                    if (rc.regs[i] == v->phys) rc.pinned[i] = 1;
+                adapter->replaceUse(inst, u, BE::Register(v->phys, u.dt, false));
+            }
+
+            // 2. 块内最后一次使用后释放，结果可复用该寄存器
+            for (auto& u : uses)
+            {
+                VRegState* v = lookup(u);
+                if (!v || v->phys < 0 || usedLater(*v, idx)) continue;
+                bool redefined = false;
+                for (auto& d : defs) redefined |= (d == u);
+                if (v->global && v->dirty && !redefined)
+                    before.push_back(new BE::FIStoreInst(BE::Register(v->phys, v->reg.dt, false), slotOf(*v), "spill live-out"));
+                release(*v);
+            }
+            for (RegClass* rc : {&intRegs_, &floatRegs_}) std::fill(rc->pinned.begin(), rc->pinned.end(), 0);
+
+            // 3. 定义：分配寄存器并标记为脏；块内不再使用的跨块值立即写回
+            for (auto& d : defs)
+            {
+                VRegState* v = lookup(d);
+                if (!v) continue;
+                RegClass& rc = classOf(*v);
+                if (v->phys < 0)
+                {
+                    int i        = pickReg(rc, before);
+                    v->phys      = rc.regs[i];
+                    rc.holder[i] = static_cast<int>(v - vregs_.data());
+                }
+                v->dirty = true;
+                adapter->replaceDef(inst, d, BE::Register(v->phys, d.dt, false));
+            }
+            for (auto& d : defs)
+            {
+                VRegState* v = lookup(d);
+                if (!v || v->phys < 0 || usedLater(*v, idx)) continue;
+                if (v->global)
+                    after.push_back(new BE::FIStoreInst(BE::Register(v->phys, v->reg.dt, false), slotOf(*v), "spill live-out"));
+                release(*v);
+            }
+
+            out.insert(out.end(), before.begin(), before.end());
+            out.push_back(inst);
+            out.insert(out.end(), after.begin(), after.end());
+            ++idx;
+        }
+
+        // 无终结指令的块（直接落入后继）在块末写回
+        if (!flushed)
+        {
+            std::vector<BE::MInstruction*> tail;
+            flushGlobals(tail);
+            out.insert(out.end(), tail.begin(), tail.end());
+        }
+        block->insts = std::move(out);
+
+        for (RegClass* rc : {&intRegs_, &floatRegs_})
+        {
+            for (int& h : rc->holder)
+            {
+                if (h < 0) continue;
+                vregs_[h].phys  = -1;
+                vregs_[h].dirty = false;
+                h               = -1;
+            }
+        }
+    }
+
+    void BlockLocalRA::allocateFunction(
+        BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter, const BE::Targeting::TargetRegInfo& regInfo)
+    {
+        ASSERT(adapter && "TargetInstrAdapter is not set");
+        func_    = &func;
+        adapter_ = adapter;
+
+        std::set<int> reserved(regInfo.reservedRegs().begin(), regInfo.reservedRegs().end());
+        initClass(intRegs_.regs, regInfo.calleeSavedIntRegs(), reserved);
+        initClass(floatRegs_.regs, regInfo.calleeSavedFloatRegs(), reserved);
+        for (RegClass* rc : {&intRegs_, &floatRegs_})
+        {
+            rc->holder.assign(rc->regs.size(), -1);
+            rc->pinned.assign(rc->regs.size(), 0);
+        }
+
+        collect(func);
+        stamp_ = 0;
+        for (auto& [bid, block] : func.blocks)
+        {
+            allocateBlock(block);
+            ++stamp_;
+        }
+    }
+}  // namespace BE::RA
@@ -0,0 +1,67 @@
+#ifndef __BACKEND_RA_BLOCK_LOCAL_H__
+#define __BACKEND_RA_BLOCK_LOCAL_H__
+
+#include <backend/ra/register_allocator.h>
+#include <unordered_map>
+#include <vector>
+
+namespace BE::RA
+{
+    /*
+     * 块内快速寄存器分配（-O0 使用）
+     *
+     * 不做全局活跃性分析与区间构建，每个基本块内一遍扫描：
+     * - 只在单个块内出现、且在块内先定义后使用的 vreg 为“块内值”，其余为“跨块值”，跨块值以栈槽为准
+     * - 使用时若不在寄存器中则从栈槽重载，定义时贪心分配编号最小的空闲寄存器
+     * - 块内最后一次使用后立即释放寄存器；寄存器不足时驱逐最晚才结束的值
+     * - 块末（第一条终结指令之前）把所有被修改的跨块值写回栈槽
+     * 与 LinearScanRA 一样只使用被调用者保存寄存器，调用点无需额外处理。
+     */
+    class BlockLocalRA : public RegisterAllocator<BlockLocalRA>
+    {
+      public:
+        void allocateFunction(BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo& regInfo);
+
+      private:
+        struct VRegState
+        {
+            BE::Register reg;
+            int          firstBlock = -1;     // 首次出现的块
+            bool         global     = false;  // 跨块值
+            int          spillSlot  = -1;
+            int          phys       = -1;     // 当前所在物理寄存器
+            bool         dirty      = false;  // 寄存器中的值比栈槽新
+            int          lastUse    = -1;     // 当前块内最后一次使用的指令下标
+            int          lastStamp  = -1;     // lastUse 所属的块序号
+        };
+
+        struct RegClass
+        {
+            std::vector<int> regs;     // 可分配寄存器，按偏好顺序
+            std::vector<int> holder;   // 与 regs 对应：所在 vreg 的下标，-1 表示空闲
+            std::vector<int> pinned;   // 与 regs 对应：被当前指令占用的标记
+        };
+
+        BE::Function*                            func_    = nullptr;
+        const BE::Targeting::TargetInstrAdapter* adapter_ = nullptr;
+        std::vector<VRegState>            vregs_;
+        std::unordered_map<uint32_t, int> index_;  // vreg 编号 -> vregs_ 下标
+        RegClass                          intRegs_, floatRegs_;
+        int                               stamp_ = 0;
+
+        VRegState* lookup(const BE::Register& r);
+        RegClass&  classOf(const VRegState& v);
+        int        slotOf(VRegState& v);
+
+        void collect(BE::Function& func);
+        void allocateBlock(BE::Block* block);
+
+        bool usedLater(const VRegState& v, int idx) const { return v.lastStamp == stamp_ && v.lastUse > idx; }
+        int  pickReg(RegClass& rc, std::vector<BE::MInstruction*>& before);
+        void release(VRegState& v);
+        void flushGlobals(std::vector<BE::MInstruction*>& out);
+    };
+}  // namespace BE::RA
+
+#endif  // __BACKEND_RA_BLOCK_LOCAL_H__
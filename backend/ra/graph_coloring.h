@@ -9,9 +9,11 @@ namespace BE::RA
     class GraphColoringRA : public RegisterAllocator<GraphColoringRA>
     {
       public:
-        void allocateFunction(BE::Function& func, const BE::Targeting::TargetRegInfo& regInfo)
+        void allocateFunction(BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo& regInfo)
         {
             (void)func;
+            (void)adapter;
             (void)regInfo;
             TODO("Implement GraphColoringRA");
         }
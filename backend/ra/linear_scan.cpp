@@ -7,6 +7,7 @@
 #include <backend/target/target_instr_adapter.h>
 #include <backend/common/cfg.h>
 #include <backend/common/cfg_builder.h>
+#include <backend/common/loop_info.h>
 #include <utils/dynamic_bitset.h>
 #include <debug.h>
 
@@ -15,6 +16,7 @@
 #include <unordered_map>
 #include <deque>
 #include <algorithm>
+#include <functional>
 
 namespace BE::RA
 {
@@ -28,12 +30,20 @@ namespace BE::RA
      *    同时收集调用点（callPoints），用于偏好分配被调用者保存寄存器（callee-saved）。
      * 2) 构建 USE/DEF：枚举每条指令的使用与定义寄存器，聚合到基本块级的 USE/DEF 集合。
      * 3) 活跃性分析：在 CFG 上迭代 IN/OUT，满足 IN = USE ∪ (OUT − DEF) 直至收敛。
-     * 4) 活跃区间构建：按基本块从后向前，根据 IN/OUT 与指令次序，累积每个 vreg 的若干 [start, end) 段并合并。
-     * 5) 标记跨调用：若区间与任意调用点重叠（交叉），标记 crossesCall=true，以便后续优先使用被调用者保存寄存器。
+     * 4) 活跃区间构建：按基本块从后向前，根据 IN/OUT 与指令次序，累积每个 vreg 的若干 [start, end) 段并合并；
+     *    块内定义截断活跃段，只有块入口活跃的 vreg 才从块首开始。
+     * 5) 标记跨调用：若区间与任意调用点重叠（交叉），标记 crossesCall=true，这类区间只能使用被调用者保存寄存器；
+     *    同时记录参数/返回值等固定物理寄存器的占用范围，调用者保存寄存器不分给与之重叠的区间。
      * 6) 线性扫描分配：将区间按起点排序，维护活动集合 active；到达新区间时先移除已过期区间，然后
      *    尝试选择空闲物理寄存器；若无空闲则选择一个区间溢出（常见启发：溢出"结束点更远"的区间）。
      * 7) 重写 MIR：对未分配物理寄存器的 use/def，在指令前/后插入 reload/spill，并用临时物理寄存器替换操作数。
      *
+     * 紧凑编码偏好：每个区间按 use/def 次数与所在循环深度估计使用频度；
+     * 最热的区间优先放入目标的紧凑编码寄存器（如 RVC 的 x8-x15），其余区间先用普通寄存器把它们让出来；
+     * 溢出槽按同一频度排序布局，越热越靠近栈指针。
+     * RV64 的紧凑集合中 s0/s1（fs0/fs1）可分给任意区间，a0-a5（fa0-fa5）只分给不跨调用的区间，
+     * 因此循环内不含调用的热值才能落入 a0-a5。
+     *
      * 提示：
      * - 通过 TargetInstrAdapter 提供的接口完成目标无关的指令读写。
      * - TargetRegInfo 提供了可分配寄存器集合、被调用者保存寄存器、保留寄存器等信息。
@@ -55,6 +65,7 @@ namespace BE::RA
             bool                 crossesCall = false;
             int                  assignedReg = -1;    // 分配的物理寄存器，-1表示溢出
             int                  spillSlot   = -1;    //溢出槽索引
+            uint64_t             weight      = 0;     // 使用频度：每次 use/def 按所在块的循环深度加权
 
             //添加活跃区间片段
             void addSegment(int s, int e)
@@ -101,15 +112,19 @@ namespace BE::RA
                 return false;
             }
 
-            // 检查两个区间是否重叠
+            // 检查两个区间是否重叠（两者的片段均已 merge，按起点有序且互不相交）
             bool overlapsInterval(const Interval& other) const
             {
-                for (const auto& s1 : segs)
+                size_t i = 0, j = 0;
+                while (i < segs.size() && j < other.segs.size())
                 {
-                    for (const auto& s2 : other.segs)
-                    {
-                        if (s1.start < s2.end && s2.start < s1.end) return true;
-                    }
+                    const auto& s1 = segs[i];
+                    const auto& s2 = other.segs[j];
+                    if (s1.start < s2.end && s2.start < s1.end) return true;
+                    if (s1.end <= s2.end)
+                        ++i;
+                    else
+                        ++j;
                 }
                 return false;
             }
@@ -148,6 +163,9 @@ namespace BE::RA
         {
             return dt && dt->dt == BE::DataType::Type::FLOAT;
         }
+
+        // 循环深度 d 处一次访问的频度权重：8^d，深度超过 5 按 5 计
+        uint64_t depthWeight(int depth) { return uint64_t(1) << (3 * std::min(depth, 5)); }
     }  // namespace
 
     // 筛选可分配的整数寄存器列表
@@ -157,14 +175,17 @@ namespace BE::RA
         const auto&      reservedRegs = ri.reservedRegs();//保留的寄存器列表
         std::set<int>    reserved(reservedRegs.begin(), reservedRegs.end());//保留的寄存器集合
 
-        // 只使用 callee-saved 寄存器进行分配。caller-saved 寄存器会被每次调用破坏，
-        // 当前分配器不会在调用点周围插入保存/恢复指令。
-        // 限制寄存器池可以避免跨调用的值被意外破坏，代价是可能会有更多溢出。
+        // callee-saved 寄存器可分配给任意区间；caller-saved 寄存器会被每次调用破坏，
+        // 当前分配器不会在调用点周围插入保存/恢复指令，因此目标列出的 caller-saved 寄存器只分配给不跨调用的区间
         const auto& calleeSaved = ri.calleeSavedIntRegs();// callee-saved 寄存器列表
         for (int r : calleeSaved)
         {
             if (!reserved.count(r)) allocatable.push_back(r);//加入可分配的寄存器列表
         }
+        for (int r : ri.callerSavedIntRegs())
+        {
+            if (!reserved.count(r)) allocatable.push_back(r);
+        }
         return allocatable;
     }
 
@@ -175,19 +196,24 @@ namespace BE::RA
         const auto&      reservedRegs = ri.reservedRegs();
         std::set<int>    reserved(reservedRegs.begin(), reservedRegs.end());
 
-        // 同样只使用 callee-saved 浮点寄存器
+        // 同样：callee-saved 浮点寄存器分给任意区间，caller-saved 浮点寄存器只分给不跨调用的区间
         const auto& calleeSaved = ri.calleeSavedFloatRegs();
         for (int r : calleeSaved)
         {
             if (!reserved.count(r)) allocatable.push_back(r);
         }
+        for (int r : ri.callerSavedFloatRegs())
+        {
+            if (!reserved.count(r)) allocatable.push_back(r);
+        }
         return allocatable;
     }
 
-    void LinearScanRA::allocateFunction(BE::Function& func, const BE::Targeting::TargetRegInfo& regInfo)
+    void LinearScanRA::allocateFunction(
+        BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter, const BE::Targeting::TargetRegInfo& regInfo)
     {
         std::cerr << "[RA] function " << func.name << " begin" << std::endl;
-        ASSERT(BE::Targeting::g_adapter && "TargetInstrAdapter is not set");
+        ASSERT(adapter && "TargetInstrAdapter is not set");
 
         std::cerr << "[RA] " << func.name << " step1 numbering" << std::endl;
         // ============================================================================
@@ -209,7 +235,7 @@ namespace BE::RA
                 // 记录调用点
                 // 作用：后续用于判断哪些 vreg 的活跃区间跨越了函数调用
                 // 跨调用的 vreg 必须分配到 callee-saved 寄存器，否则值会被调用破坏
-                if (BE::Targeting::g_adapter->isCall(*it)) callPoints.insert(ins_id);
+                if (adapter->isCall(*it)) callPoints.insert(ins_id);
             }
             blockRange[block] = {start, ins_id};
         }
@@ -229,14 +255,15 @@ namespace BE::RA
             {
                 std::vector<BE::Register> uses, defs;
                 // 获取当前指令读取（uses）和写入（defs）的寄存器列表
-                BE::Targeting::g_adapter->enumUses(*it, uses);
-                BE::Targeting::g_adapter->enumDefs(*it, defs);
+                adapter->enumUses(*it, uses);
+                adapter->enumDefs(*it, defs);
+                // 若寄存器在被当前块定义之前就被使用，则属于该块的 USE 集合（活跃性源头）；
+                // 同一条指令先读后写，因此先处理 uses
+                for (auto& u : uses)
+                    if (!def.count(u)) use.insert(u);
                 // 记录基本块内定义的寄存器
                 for (auto& d : defs)
                     if (!def.count(d)) def.insert(d);
-                // 若寄存器在被当前块定义之前就被使用，则属于该块的 USE 集合（活跃性源头）
-                for (auto& u : uses)
-                    if (!def.count(u)) use.insert(u);
             }
             // 将计算出的集合存入映射表，用于后续的活跃性迭代分析
             USE[block] = std::move(use);
@@ -247,12 +274,15 @@ namespace BE::RA
         // ============================================================================
         // 第 3 步：构建 CFG 并获取后继关系
         // ============================================================================
-        BE::MIR::CFGBuilder                           builder(BE::Targeting::g_adapter);
+        BE::MIR::CFGBuilder                           builder(adapter);
         BE::MIR::CFG*                                 cfg = builder.buildCFGForFunction(&func);
         std::map<BE::Block*, std::vector<BE::Block*>> succs;
 
+        std::map<BE::Block*, int>                     loopDepth;  // 各块的循环嵌套深度，用于估计使用频度
+
         if (cfg)
         {
+            BE::MIR::LoopInfo loops(cfg);
             for (auto& [id, block] : func.blocks)
             {
                 succs[block] = {};
@@ -263,6 +293,7 @@ namespace BE::RA
                         if (succ) succs[block].push_back(succ);
                     }
                 }
+                loopDepth[block] = loops.loopDepth(id);
             }
         }
 
@@ -318,43 +349,51 @@ namespace BE::RA
         {
             auto [blockStart, blockEnd] = blockRange[block];
 
-            // 如果寄存器在块出口活跃（OUT 中），说明它需要传递给后继块
-            // 因此在整个块内都是活跃的
+            // openEnd[r]：r 在当前扫描位置之后仍活跃时，其活跃段的（开）终点
+            // 如果寄存器在块出口活跃（OUT 中），说明它需要传递给后继块，活跃段先延伸到块尾
+            std::map<BE::Register, int> openEnd;
             for (const auto& r : OUT[block])
             {
                 if (!r.isVreg) continue;
                 intervals[r].vreg = r;
-                intervals[r].addSegment(blockStart, blockEnd);
+                openEnd[r]        = blockEnd;
             }
 
             // 从后向前遍历指令构建区间
             // 为什么从后向前？因为我们需要先知道「使用点」才能确定活跃范围的终点
-            int instIdx = blockEnd - 1;
+            uint64_t accessWeight = depthWeight(loopDepth[block]);
+            int      instIdx      = blockEnd - 1;
             for (auto it = block->insts.rbegin(); it != block->insts.rend(); ++it, --instIdx)
             {
                 std::vector<BE::Register> uses, defs;
-                BE::Targeting::g_adapter->enumUses(*it, uses);
-                BE::Targeting::g_adapter->enumDefs(*it, defs);
+                adapter->enumUses(*it, uses);
+                adapter->enumDefs(*it, defs);
 
-                // 定义点：vreg 在此处被定义，活跃区间从这里「开始」
-                // 添加一个最小区间 [instIdx, instIdx+1) 表示定义点本身
+                // 定义点：vreg 在此处被定义，活跃段从这里「开始」，[instIdx, 终点)；
+                // 之后没有使用的定义也占据定义点本身 [instIdx, instIdx+1)
                 for (auto& d : defs)
                 {
                     if (!d.isVreg) continue;
                     intervals[d].vreg = d;
-                    intervals[d].addSegment(instIdx, instIdx + 1);
+                    auto open         = openEnd.find(d);
+                    intervals[d].addSegment(instIdx, open != openEnd.end() ? open->second : instIdx + 1);
+                    if (open != openEnd.end()) openEnd.erase(open);
+                    intervals[d].weight += accessWeight;
                 }
 
-                // 使用点：vreg 在此处被使用
-                // 活跃范围从块开始延伸到使用点 [blockStart, instIdx+1)
-                // 这样能确保值从定义点传递到使用点
+                // 使用点：vreg 在此处被使用，若其后没有更晚的使用，活跃段终点就是 instIdx+1；
+                // 起点留待遇到块内定义时确定
                 for (auto& u : uses)
                 {
                     if (!u.isVreg) continue;
                     intervals[u].vreg = u;
-                    intervals[u].addSegment(blockStart, instIdx + 1);
+                    openEnd.emplace(u, instIdx + 1);
+                    intervals[u].weight += accessWeight;
                 }
             }
+
+            // 块内没有定义的（块入口活跃）寄存器，活跃段从块开始延伸
+            for (auto& [r, end] : openEnd) intervals[r].addSegment(blockStart, end);
         }
 
         // 合并每个区间中的片段
@@ -380,6 +419,32 @@ namespace BE::RA
             }
         }
 
+        // 固定物理寄存器的占用：指令选择在入口块开头从参数寄存器取形参，在调用前装入实参、调用后取返回值，
+        // 在返回前写入返回值寄存器，这些值不属于任何 vreg 区间，且都不跨越基本块。
+        // 适配器不区分物理寄存器的读写，因此以调用点把基本块切成若干段：
+        // 物理寄存器在某段中出现，就视为在整段（含两端的调用点）被占用，与之重叠的区间不能分到该寄存器
+        std::map<int, Interval> fixedInt, fixedFP;
+        for (auto& [bid, block] : func.blocks)
+        {
+            auto [blockStart, blockEnd] = blockRange[block];
+            int  instIdx                = blockStart;
+            for (auto it = block->insts.begin(); it != block->insts.end(); ++it, ++instIdx)
+            {
+                std::vector<BE::Register> physRegs;
+                adapter->enumPhysRegs(*it, physRegs);
+                if (physRegs.empty()) continue;
+
+                auto next     = callPoints.lower_bound(instIdx);
+                int  segEnd   = (next != callPoints.end() && *next < blockEnd) ? *next + 1 : blockEnd;
+                int  segStart = blockStart;
+                if (next != callPoints.begin() && *std::prev(next) >= blockStart) segStart = *std::prev(next);
+                for (auto& pr : physRegs)
+                    (isFloatType(pr.dt) ? fixedFP : fixedInt)[pr.rId].addSegment(segStart, segEnd);
+            }
+        }
+        for (auto& [r, fixed] : fixedInt) fixed.merge();
+        for (auto& [r, fixed] : fixedFP) fixed.merge();
+
         std::cerr << "[RA] " << func.name << " step6 allocate" << std::endl;
         // ============================================================================
         // 第 6 步：线性扫描主循环
@@ -406,24 +471,70 @@ namespace BE::RA
         std::set<int> calleeSavedIntSet(regInfo.calleeSavedIntRegs().begin(), regInfo.calleeSavedIntRegs().end());
         std::set<int> calleeSavedFPSet(regInfo.calleeSavedFloatRegs().begin(), regInfo.calleeSavedFloatRegs().end());
 
+        // 紧凑编码寄存器集合，用于热区间的偏好分配
+        std::set<int> compactIntSet(regInfo.compactIntRegs().begin(), regInfo.compactIntRegs().end());
+        std::set<int> compactFPSet(regInfo.compactFloatRegs().begin(), regInfo.compactFloatRegs().end());
+
         // 线性扫描分配的核心 lambda 函数
         // 参数：toAlloc - 待分配的区间列表（已按起始点排序）
         //       allocRegs - 可分配的物理寄存器列表
         //       calleeSaved - callee-saved 寄存器集合
+        //       compact - 紧凑编码寄存器集合
+        //       fixed - 固定物理寄存器的占用范围
         auto allocateIntervals = [&](std::vector<Interval*>& toAlloc, const std::vector<int>& allocRegs,
-                                     const std::set<int>& calleeSaved) {
+                                     const std::set<int>& calleeSaved, const std::set<int>& compact,
+                                     const std::map<int, Interval>& fixed) {
             // active: 当前活跃的区间集合，按结束点排序（方便移除过期区间）
             std::set<Interval*, ActiveOrder> active;
             // freeRegs: 当前空闲的物理寄存器
             std::set<int>                    freeRegs(allocRegs.begin(), allocRegs.end());
 
+            // 热区间：至少有一次访问位于循环内，且使用频度排在前四分之一
+            uint64_t hotWeight = depthWeight(1);
+            if (!compact.empty() && !toAlloc.empty())
+            {
+                std::vector<uint64_t> weights;
+                weights.reserve(toAlloc.size());
+                for (auto* iv : toAlloc) weights.push_back(iv->weight);
+                auto quarter = weights.begin() + weights.size() / 4;
+                std::nth_element(weights.begin(), quarter, weights.end(), std::greater<uint64_t>());
+                hotWeight = std::max(hotWeight, *quarter);
+            }
+
+            // 寄存器 r 能否分给区间 iv：caller-saved 寄存器要求区间不跨调用，且不与固定占用重叠
+            auto usable = [&](const Interval* iv, int r) {
+                if (calleeSaved.count(r)) return true;
+                if (iv->crossesCall) return false;
+                auto it = fixed.find(r);
+                return it == fixed.end() || !iv->overlapsInterval(it->second);
+            };
+
+            // 从空闲寄存器中挑选：热区间优先紧凑编码寄存器，其余区间优先普通寄存器；
+            // 同等条件下优先 caller-saved 寄存器，省去序言/尾声中的保存与恢复
+            auto pickFree = [&](const Interval* iv) {
+                bool hot      = !compact.empty() && iv->weight >= hotWeight;
+                int  chosen   = -1;
+                int  bestRank = 4;
+                for (int r : freeRegs)
+                {
+                    if (!usable(iv, r)) continue;
+                    int rank = ((compact.count(r) != 0) == hot ? 0 : 2) + (calleeSaved.count(r) ? 1 : 0);
+                    if (rank < bestRank)
+                    {
+                        chosen   = r;
+                        bestRank = rank;
+                    }
+                }
+                return chosen;
+            };
+
             // 溢出函数：将区间标记为溢出，并分配栈槽
             auto spillInterval = [&](Interval* iv) {
                 if (!iv) return;
                 iv->assignedReg = -1;  // 标记为未分配物理寄存器
                 int spillWidth  = iv->vreg.dt ? iv->vreg.dt->getDataWidth() : 8;  // 溢出宽度（4/8字节）
                 // 在栈帧中创建溢出槽
-                if (iv->spillSlot < 0) iv->spillSlot = func.frameInfo.createSpillSlot(spillWidth);
+                if (iv->spillSlot < 0) iv->spillSlot = func.frameInfo.createSpillSlot(spillWidth, 8, iv->weight);
             };
 
             // 按起始点顺序扫描每个区间
@@ -450,24 +561,9 @@ namespace BE::RA
                 // ========== Step 2: 尝试分配空闲寄存器 ==========
                 int chosenReg = -1;
 
-                if (interval->crossesCall)
-                {
-                    // 跨调用的区间必须使用 callee-saved 寄存器
-                    // 否则 call 会破坏 caller-saved 寄存器中的值
-                    for (int r : freeRegs)
-                    {
-                        if (calleeSaved.count(r))
-                        {
-                            chosenReg = r;
-                            break;
-                        }
-                    }
-                }
-                else if (!freeRegs.empty())
-                {
-                    // 不跨调用，任意空闲寄存器都可以
-                    chosenReg = *freeRegs.begin();
-                }
+                // 跨调用的区间必须使用 callee-saved 寄存器，否则 call 会破坏 caller-saved 寄存器中的值；
+                // 不跨调用时任意未被固定占用的空闲寄存器都可以
+                chosenReg = pickFree(interval);
 
                 // ========== Step 3: 分配成功或溢出 ==========
                 if (chosenReg >= 0)
@@ -484,15 +580,14 @@ namespace BE::RA
                     Interval* toSpill = nullptr;
                     for (auto* act : active)
                     {
-                        // 如果当前区间跨调用，只考虑 callee-saved 寄存器
-                        if (interval->crossesCall && !calleeSaved.count(act->assignedReg)) continue;
+                        // 只考虑当前区间能接手的寄存器（跨调用时只有 callee-saved 寄存器）
+                        if (!usable(interval, act->assignedReg)) continue;
                         // 选择结束点最远的
                         if (!toSpill || act->getEnd() > toSpill->getEnd()) toSpill = act;
                     }
 
                     // 决定溢出谁
-                    bool canTakeReg = toSpill && (!interval->crossesCall || calleeSaved.count(toSpill->assignedReg));
-                    if (canTakeReg && toSpill->getEnd() > interval->getEnd())
+                    if (toSpill && toSpill->getEnd() > interval->getEnd())
                     {
                         // 情况 A：toSpill 活得更久，溢出它，把寄存器给当前区间
                         interval->assignedReg = toSpill->assignedReg;
@@ -510,8 +605,8 @@ namespace BE::RA
         };
 
         // 分别对整数和浮点区间进行分配
-        allocateIntervals(intIntervals, allIntRegs, calleeSavedIntSet);    // 整数寄存器
-        allocateIntervals(fpIntervals, allFloatRegs, calleeSavedFPSet);    // 浮点寄存器
+        allocateIntervals(intIntervals, allIntRegs, calleeSavedIntSet, compactIntSet, fixedInt);  // 整数寄存器
+        allocateIntervals(fpIntervals, allFloatRegs, calleeSavedFPSet, compactFPSet, fixedFP);    // 浮点寄存器
 
         std::cerr << "[RA] " << func.name << " step7 rewrite" << std::endl;
         // ============================================================================
@@ -529,18 +624,9 @@ namespace BE::RA
         }
 
         // 获取临时寄存器池（用于溢出时的 load/store）
-        // 临时寄存器从保留寄存器中选取，避免影响已分配的寄存器
-        std::vector<int> scratchIntPool;    // 整数临时寄存器池
-        std::vector<int> scratchFloatPool;  // 浮点临时寄存器池
-        
-        for (int r : regInfo.reservedRegs())
-        {
-            if (r >= 32)
-                scratchFloatPool.push_back(r);  // 浮点寄存器 (f0-f31 编号为 32-63)
-            else if (r != regInfo.spRegId() && r != regInfo.raRegId() && r != regInfo.zeroRegId() && r != 3 && r != 4 &&
-                     r != 5)  // 排除 sp, ra, zero, gp, tp, t0（t0 被 lowering 用于大偏移）
-                scratchIntPool.push_back(r);
-        }
+        // 临时寄存器由目标给出，均取自保留寄存器，避免影响已分配的寄存器
+        std::vector<int> scratchIntPool   = regInfo.scratchIntRegs();    // 整数临时寄存器池
+        std::vector<int> scratchFloatPool = regInfo.scratchFloatRegs();  // 浮点临时寄存器池
         // 如果没有可用的临时寄存器，使用最后一个可分配寄存器作为后备
         if (scratchIntPool.empty() && !allIntRegs.empty()) scratchIntPool.push_back(allIntRegs.back());
         if (scratchFloatPool.empty() && !allFloatRegs.empty()) scratchFloatPool.push_back(allFloatRegs.back());
@@ -554,12 +640,12 @@ namespace BE::RA
 
                 // 获取当前指令的使用和定义寄存器
                 std::vector<BE::Register> uses, defs;
-                BE::Targeting::g_adapter->enumUses(inst, uses);
-                BE::Targeting::g_adapter->enumDefs(inst, defs);
+                adapter->enumUses(inst, uses);
+                adapter->enumDefs(inst, defs);
 
                 // 获取当前指令已占用的物理寄存器（避免冲突）
                 std::vector<BE::Register>      physRegs;
-                BE::Targeting::g_adapter->enumPhysRegs(inst, physRegs);
+                adapter->enumPhysRegs(inst, physRegs);
                 std::set<int> busyPhys;
                 for (auto& pr : physRegs) busyPhys.insert(pr.rId);
 
@@ -583,7 +669,7 @@ namespace BE::RA
                     {
                         // 情况 1：分配了物理寄存器，直接替换
                         BE::Register phys(physReg, u.dt, false);
-                        BE::Targeting::g_adapter->replaceUse(inst, u, phys);
+                        adapter->replaceUse(inst, u, phys);
                     }
                     else if (spillSlot >= 0)
                     {
@@ -607,7 +693,7 @@ namespace BE::RA
                             // 在指令前插入：load scratch, spillSlot
                             before.push_back(new BE::FILoadInst(scratchReg, spillSlot, "reload from spill slot"));
                             // 用临时寄存器替换 vreg
-                            BE::Targeting::g_adapter->replaceUse(inst, u, scratchReg);
+                            adapter->replaceUse(inst, u, scratchReg);
                             if (isFloat)
                                 useScratchFloatList.push_back(scratch);
                             else
@@ -630,7 +716,7 @@ namespace BE::RA
                     {
                         // 情况 1：分配了物理寄存器，直接替换
                         BE::Register phys(physReg, d.dt, false);
-                        BE::Targeting::g_adapter->replaceDef(inst, d, phys);
+                        adapter->replaceDef(inst, d, phys);
                     }
                     else if (spillSlot >= 0)
                     {
@@ -658,7 +744,7 @@ namespace BE::RA
                         {
                             BE::Register scratchReg(scratch, d.dt, false);
                             // 用临时寄存器替换 vreg
-                            BE::Targeting::g_adapter->replaceDef(inst, d, scratchReg);
+                            adapter->replaceDef(inst, d, scratchReg);
                             // 在指令后插入：store scratch, spillSlot
                             after.push_back(new BE::FIStoreInst(scratchReg, spillSlot, "spill to spill slot"));
                         }
@@ -9,7 +9,8 @@ namespace BE::RA
     class LinearScanRA : public RegisterAllocator<LinearScanRA>
     {
       public:
-        void allocateFunction(BE::Function& func, const BE::Targeting::TargetRegInfo& regInfo);
+        void allocateFunction(BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo& regInfo);
     };
 }  // namespace BE::RA
 
@@ -11,9 +11,10 @@ namespace BE::RA
     class RegisterAllocator
     {
       public:
-        void allocate(BE::Module& module, const BE::Targeting::TargetRegInfo& regInfo)
+        void allocate(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo& regInfo)
         {
-            for (auto* func : module.functions) static_cast<Impl*>(this)->allocateFunction(*func, regInfo);
+            for (auto* func : module.functions) static_cast<Impl*>(this)->allocateFunction(*func, adapter, regInfo);
         }
     };
 }  // namespace BE::RA
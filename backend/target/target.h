@@ -3,19 +3,24 @@
 
 #include <backend/dag/selection_dag.h>
 #include <backend/dag/dag_builder.h>
+#include <backend/dag/dag_combiner.h>
 #include <backend/mir/m_defs.h>
+#include <debug.h>
 #include <string>
 #include <memory>
 #include <map>
+#include <unordered_map>
 
 namespace ME
 {
     class Module;
     class Block;
+    class Function;
 }  // namespace ME
 namespace BE
 {
     class Module;
+    class Function;
 }
 
 namespace BE::Targeting
@@ -23,36 +28,99 @@ namespace BE::Targeting
     class BackendTarget
     {
       public:
-        std::map<const ME::Block*, BE::DAG::SelectionDAG*> block_dags;
-
-        virtual ~BackendTarget()
+        /**
+         * @brief 一个函数的全部块 DAG
+         *
+         * 由 buildDAG 按函数构建，随该函数的指令选择结束而释放，不同函数的 DAG 互不共享状态，
+         * 因此可以在多个线程上同时为不同函数构建与选择。
+         */
+        struct FunctionDAG
         {
-            for (auto& [_, dag] : block_dags)
+            /// 本函数各块 DAG 共享的节点分配器，须比 block_dags 中的 DAG 活得更久
+            BE::DAG::NodeArena                                 arena;
+            std::map<const ME::Block*, BE::DAG::SelectionDAG*> block_dags;
+            /// IR 寄存器在定义所在块之外的引用次数（见 DAGBuilder::getCrossBlockUses），
+            /// 指令选择据此判断被折叠的定义是否还需生成
+            std::unordered_map<size_t, int> cross_block_uses;
+
+            FunctionDAG() = default;
+            FunctionDAG(const FunctionDAG&)            = delete;
+            FunctionDAG& operator=(const FunctionDAG&) = delete;
+            ~FunctionDAG()
             {
-                if (!dag) continue;
-                delete dag;
-                dag = nullptr;
+                for (auto& [_, dag] : block_dags) delete dag;
             }
-        }
+        };
+
+        /// 在扩展基本块上构建 DAG，使跨越唯一前驱边的比较/地址计算可以被折叠
+        bool extended_block_isel = false;
+        /// 优化级别：0 时走不构建 SelectionDAG 的一遍式指令选择与块内寄存器分配，并跳过 Pre-RA 优化
+        int optimize_level = 0;
+        /// 为 true 时直接输出可重定位 ELF 目标文件（-c），而非汇编文本
+        bool emit_object = false;
+
+        /// 后端逐函数流水线使用的线程数（含调用线程），1 为单线程，0 为硬件线程数
+        size_t threads = 1;
+        /// 非空时把代码生成统计（如 RV64 汇编的 RVC 可压缩率）写到该流，不进入输出文件
+        std::ostream* stats_out = nullptr;
+
+        virtual ~BackendTarget() = default;
 
         virtual const char* getName() const = 0;
 
-        void buildDAG(ME::Module* ir)
+        /// 是否支持 emit_object（直接输出目标文件）
+        virtual bool supportsObjectEmission() const { return false; }
+
+        /// 目标相关的 DAG 合法化，在目标无关的 DAG 合并之后运行
+        virtual void legalizeDAG(DAG::SelectionDAG& dag) const { (void)dag; }
+
+        std::unique_ptr<FunctionDAG> buildDAG(ME::Function& f) const
         {
-            for (auto* f : ir->functions)
+            auto            dags = std::make_unique<FunctionDAG>();
+            DAG::DAGBuilder builder;
+            builder.setExtendedBlocks(extended_block_isel);
+            builder.setArena(&dags->arena);
+            builder.buildFunction(f, dags->block_dags);
+            dags->cross_block_uses = builder.getCrossBlockUses();
+
+            for (auto& [id, block] : f.blocks)
             {
-                if (!f) continue;
-                DAG::DAGBuilder builder;
-
-                for (auto& [bid, ir_block] : f->blocks)
-                {
-                    auto* dag = new DAG::SelectionDAG();
-                    builder.build(*ir_block, *dag);
-                    block_dags[ir_block] = dag;
-                }
+                auto it = dags->block_dags.find(block);
+                if (it == dags->block_dags.end() || !it->second) continue;
+                DAG::DAGCombiner(*it->second, &dags->cross_block_uses).run();
+                legalizeDAG(*it->second);
             }
+            return dags;
         }
         virtual void runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out) = 0;
+
+        /**
+         * 流式编译接口（-fstreaming），按函数逐个完成后端并输出，已输出函数的 MIR 随即释放：
+         * - beginStream：导入全局变量并开始输出；
+         * - compileFunction：单个函数从指令选择到栈降低的全部阶段，返回的函数不加入后端模块，可在多个线程上并发调用；
+         * - emitFunction：按调用顺序输出该函数并释放它，只能在一个线程上调用；
+         * - endStream：输出全局数据与常量池并结束输出。
+         */
+        virtual bool supportsStreaming() const { return false; }
+        virtual void beginStream(ME::Module* ir, BE::Module* backend, std::ostream* out)
+        {
+            (void)ir;
+            (void)backend;
+            (void)out;
+            ERROR("Target %s does not support streaming compilation", getName());
+        }
+        virtual BE::Function* compileFunction(ME::Function* func)
+        {
+            (void)func;
+            ERROR("Target %s does not support streaming compilation", getName());
+            return nullptr;
+        }
+        virtual void emitFunction(BE::Function* func)
+        {
+            (void)func;
+            ERROR("Target %s does not support streaming compilation", getName());
+        }
+        virtual void endStream() { ERROR("Target %s does not support streaming compilation", getName()); }
     };
 }  // namespace BE::Targeting
 
@@ -51,12 +51,46 @@ namespace BE::Targeting
             ERROR("Using base target register info calleeSavedFloatRegs method is not allowed");
         }
 
+        // 可分配给“不跨调用”区间的调用者保存（caller-saved）GPR：调用会破坏它们，跨调用的区间只用被调用者保存寄存器；
+        // 其中的参数/返回值寄存器由分配器按固定占用避让
+        virtual const std::vector<int>& callerSavedIntRegs() const
+        {
+            ERROR("Using base target register info callerSavedIntRegs method is not allowed");
+        }
+        // 可分配给不跨调用区间的调用者保存 FPR
+        virtual const std::vector<int>& callerSavedFloatRegs() const
+        {
+            ERROR("Using base target register info callerSavedFloatRegs method is not allowed");
+        }
+
         // 保留的物理寄存器集合（不可用于分配），如 sp/zero/平台保留寄存器等
         virtual const std::vector<int>& reservedRegs() const
         {
             ERROR("Using base target register info reservedRegs method is not allowed");
         }
 
+        // 寄存器分配器改写溢出 use/def 时使用的临时 GPR（需保留、不参与分配，且不被栈降低使用）
+        virtual const std::vector<int>& scratchIntRegs() const
+        {
+            ERROR("Using base target register info scratchIntRegs method is not allowed");
+        }
+        // 寄存器分配器改写溢出 use/def 时使用的临时 FPR
+        virtual const std::vector<int>& scratchFloatRegs() const
+        {
+            ERROR("Using base target register info scratchFloatRegs method is not allowed");
+        }
+
+        // 可使用紧凑（短）编码的 GPR，分配器把使用最频繁的区间优先放入其中；目标无此概念时返回空表
+        virtual const std::vector<int>& compactIntRegs() const
+        {
+            ERROR("Using base target register info compactIntRegs method is not allowed");
+        }
+        // 可使用紧凑编码的 FPR
+        virtual const std::vector<int>& compactFloatRegs() const
+        {
+            ERROR("Using base target register info compactFloatRegs method is not allowed");
+        }
+
         // 该目标“全部”的 GPR 列表（包含参数/保存/临时等）
         virtual const std::vector<int>& intRegs() const
         {
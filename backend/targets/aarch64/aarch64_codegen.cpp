@@ -1,273 +1,454 @@
 #include <backend/targets/aarch64/aarch64_codegen.h>
 #include <backend/targets/aarch64/aarch64_defs.h>
-#include <sstream>
+#include <debug.h>
+#include <cstdio>
 
 namespace BE::AArch64
 {
-    static std::string formatOperand(Operand* op)
+    namespace
     {
-        if (auto* regOp = dynamic_cast<RegOperand*>(op)) return formatRegister(regOp->reg);
-        if (auto* immOp = dynamic_cast<ImmeOperand*>(op)) return "#" + std::to_string(immOp->value);
-        if (auto* memOp = dynamic_cast<MemOperand*>(op))
+#define X(n, t, a) +1
+        constexpr size_t kNumOperators = 0 A64_INSTS;
+#undef X
+
+        inline bool isCondBranchOp(Operator op)
+        {
+            return (op >= Operator::BEQ && op <= Operator::BLE) || op == Operator::CBZ || op == Operator::CBNZ;
+        }
+
+        inline int accessSize(const Register& r)
+        {
+            if (r.dt == F32) return 4;
+            return is64BitReg(r) ? 8 : 4;
+        }
+
+        inline int labelOf(Instr* inst)
+        {
+            for (auto* op : inst->operands)
+                if (auto* lb = dynamic_cast<LabelOperand*>(op)) return lb->targetBlockId;
+            return -1;
+        }
+    }  // namespace
+
+    Codegen::Codegen(BE::Module* module, std::ostream& out) : BE::MCodeGen(module, out)
+    {
+        // 助记符与其后的对齐制表符只拼接一次，输出时整段拷贝
+        opText_.reserve(kNumOperators);
+        for (size_t i = 0; i < kNumOperators; ++i)
         {
-            std::string baseStr = formatRegister(memOp->base);
-            return "[" + baseStr + ", #" + std::to_string(memOp->offset) + "]";
+            std::string text = getOpInfoAsm(static_cast<Operator>(i));
+            text += text.length() <= 3 ? "\t\t" : "\t";
+            opText_.push_back(std::move(text));
         }
-        return "unknown_op";
     }
 
     void Codegen::generateAssembly()
     {
-        out_ << ".text\n";
-        out_ << ".arch armv8-a\n";
+        printHeader();
+        printFunctions();
+        printGlobalDefinitions();
+        out_.flush();
+    }
 
-        for (auto* func : module_->functions) emitFunction(func);
+    void Codegen::printHeader() { out_ << "\t.arch armv8-a\n\t.text\n"; }
 
-        if (module_->globals.empty()) return;
+    void Codegen::printFunctions()
+    {
+        for (auto* func : module_->functions) printFunction(func);
+    }
 
-        out_ << "\n.data\n";
-        for (auto* gv : module_->globals)
+    void Codegen::printFunction(BE::Function* func)
+    {
+        cur_func_    = func;
+        labelPrefix_ = "." + func->name + "_";
+
+        out_ << "\n\t.globl\t" << func->name << "\n\t.p2align\t2\n\t.type\t" << func->name << ", %function\n";
+        out_ << func->name << ":\n";
+
+        for (auto it = func->blocks.begin(); it != func->blocks.end(); ++it)
         {
-            out_ << gv->name << ":\n";
-            if (gv->isScalar())
+            auto next    = std::next(it);
+            nextBlockId_ = next == func->blocks.end() ? -1 : static_cast<int>(next->first);
+            printBlock(it->second);
+        }
+    }
+
+    void Codegen::printLabel(int blockId) { out_ << labelPrefix_ << blockId; }
+
+    void Codegen::printBlock(BE::Block* block)
+    {
+        cur_block_ = block;
+        out_ << labelPrefix_ << block->blockId << ":\n";
+
+        auto&  insts = block->insts;
+        size_t n     = insts.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto* ti = insts[i]->kind == InstKind::TARGET ? static_cast<Instr*>(insts[i]) : nullptr;
+
+            // 块尾 b.cond next; b other  =>  b.!cond other
+            if (ti && i + 2 == n && isCondBranchOp(ti->op) && labelOf(ti) == nextBlockId_ &&
+                insts[n - 1]->kind == InstKind::TARGET && static_cast<Instr*>(insts[n - 1])->op == Operator::B)
             {
-                if (gv->type == I32 || gv->type == F32)
+                int other = labelOf(static_cast<Instr*>(insts[n - 1]));
+                if (ti->op == Operator::CBZ || ti->op == Operator::CBNZ)
                 {
-                    int val = gv->initVals.empty() ? 0 : gv->initVals[0];
-                    out_ << "  .word " << val << "\n";
+                    out_ << '\t' << opText_[static_cast<size_t>(ti->op == Operator::CBZ ? Operator::CBNZ : Operator::CBZ)];
+                    printOperand(ti->operands[0]);
+                    out_ << ", ";
                 }
-                else if (gv->type == I64 || gv->type == PTR || gv->type == F64)
+                else
                 {
-                    long long val = gv->initVals.empty() ? 0 : (long long)gv->initVals[0];
-                    out_ << "  .quad " << val << "\n";
+                    auto cc = static_cast<CondCode>(static_cast<int>(ti->op) - static_cast<int>(Operator::BEQ));
+                    out_ << '\t' << opText_[static_cast<size_t>(getBranchOp(invertCond(cc)))];
                 }
-                continue;
+                printLabel(other);
+                out_ << '\n';
+                break;
             }
-            int total_elems = 1;
-            for (int d : gv->dims) total_elems *= d;
-            bool is32 = (gv->type == I32 || gv->type == F32);
-            int  sz   = is32 ? 4 : 8;
-            if (gv->initVals.empty())
-                out_ << "  .zero " << (total_elems * sz) << "\n";
-            else
+            // 块尾跳到布局中的下一个块：直接落入
+            if (ti && i + 1 == n && ti->op == Operator::B && labelOf(ti) == nextBlockId_) break;
+
+            out_ << '\t';
+            printInstruction(insts[i]);
+            out_ << '\n';
+        }
+    }
+
+    void Codegen::printInstruction(BE::MInstruction* inst)
+    {
+        if (inst->kind == InstKind::TARGET)
+        {
+            printASM(static_cast<Instr*>(inst));
+            return;
+        }
+        if (auto* mv = dynamic_cast<MoveInst*>(inst))
+        {
+            printPseudoMove(mv);
+            return;
+        }
+        if (auto* phi = dynamic_cast<PhiInst*>(inst))
+        {
+            printOperand(phi->resReg);
+            out_ << " = phi ";
+            for (auto& [labelId, srcOp] : phi->incomingVals)
             {
-                int zero_cum = 0;
-                for (int v : gv->initVals)
-                {
-                    if (v == 0)
-                    {
-                        zero_cum += sz;
-                        continue;
-                    }
-                    if (zero_cum)
-                    {
-                        out_ << "  .zero " << zero_cum << "\n";
-                        zero_cum = 0;
-                    }
-                    if (is32)
-                        out_ << "  .word " << v << "\n";
-                    else
-                        out_ << "  .quad " << v << "\n";
-                }
-                if (zero_cum) out_ << "  .zero " << zero_cum << "\n";
+                out_ << "[" << labelId << " -> ";
+                printOperand(srcOp);
+                out_ << "], ";
             }
+            return;
         }
+        ERROR("Unsupported instruction kind in code generation");
     }
 
-    void Codegen::emitFunction(BE::Function* func)
+    void Codegen::printReg(const Register& reg, bool as64)
     {
-        cur_func_ = func;
-
-        out_ << "\n";
-        out_ << ".globl " << func->name << "\n";
-        out_ << func->name << ":\n";
-
-        for (auto& [id, block] : func->blocks) emitBlock(block);
+        if (reg.isVreg)
+        {
+            out_ << "v_" << reg.rId << "_" << reg.dt->toString();
+            return;
+        }
+        if (isFloatReg(reg))
+        {
+            out_ << (reg.dt == F32 ? 's' : 'd') << reg.rId;
+            return;
+        }
+        if (reg.rId == A64_REGISTER_ID_XZR)
+            out_ << (as64 ? "xzr" : "wzr");
+        else if (reg.rId == A64_REGISTER_ID_SP)
+            out_ << (as64 ? "sp" : "wsp");
+        else
+            out_ << (as64 ? 'x' : 'w') << reg.rId;
     }
 
-    void Codegen::emitBlock(BE::Block* block)
+    void Codegen::printOperand(const Register& reg) { printReg(reg, is64BitReg(reg)); }
+
+    void Codegen::printMem(const MemOperand* mem)
     {
-        out_ << "." << cur_func_->name << "_" << block->blockId << ":\n";
-        for (auto* inst : block->insts) emitInstruction(inst);
+        out_ << '[';
+        printReg(mem->base, true);
+        if (mem->hasIndex)
+        {
+            out_ << ", ";
+            printOperand(mem->index);
+            switch (mem->ext)
+            {
+                case Extend::SXTW: out_ << ", sxtw"; break;
+                case Extend::UXTW: out_ << ", uxtw"; break;
+                case Extend::LSL:
+                    if (mem->shift) out_ << ", lsl";
+                    break;
+                case Extend::LSR: break;  // 访存寻址没有 lsr 形式
+            }
+            if (mem->shift) out_ << " #" << mem->shift;
+            out_ << ']';
+            return;
+        }
+        switch (mem->mode)
+        {
+            case AddrMode::Offset:
+                if (mem->offset) out_ << ", #" << mem->offset;
+                out_ << ']';
+                break;
+            case AddrMode::PreIndex: out_ << ", #" << mem->offset << "]!"; break;
+            case AddrMode::PostIndex: out_ << "], #" << mem->offset; break;
+        }
     }
 
-    void Codegen::emitInstruction(BE::MInstruction* minst)
+    void Codegen::printOperand(BE::Operand* op)
     {
-        if (minst->kind == BE::InstKind::MOVE)
+        if (auto* mem = dynamic_cast<MemOperand*>(op))
         {
-            auto* moveInst = static_cast<BE::MoveInst*>(minst);
-            out_ << "  MOVE " << formatOperand(moveInst->dest) << ", " << formatOperand(moveInst->src) << "\n";
-            if (minst->comment != "") out_ << "  // " << minst->comment << "\n";
+            printMem(mem);
             return;
         }
-
-        if (minst->kind != BE::InstKind::TARGET)
-            ERROR("Unhandled non-target instruction %u in assembly generation.", static_cast<unsigned>(minst->kind));
-
-        auto*             inst = static_cast<Instr*>(minst);
-        std::stringstream ss;
-
-        if (inst->op == Operator::LA)
+        if (auto* sr = dynamic_cast<ShiftedRegOperand*>(op))
         {
-            auto* dst = static_cast<RegOperand*>(inst->operands[0]);
-            auto* sym = static_cast<SymbolOperand*>(inst->operands[1]);
-            ss << "  ldr " << formatOperand(dst) << ", =" << sym->name;
-            out_ << ss.str() << "\n";
+            printOperand(sr->reg);
+            if (sr->ext == Extend::SXTW)
+                out_ << ", sxtw";
+            else if (sr->ext == Extend::UXTW)
+                out_ << ", uxtw";
+            else if (sr->ext == Extend::LSR)
+                out_ << ", lsr";
+            else if (sr->amount)
+                out_ << ", lsl";
+            if (sr->amount) out_ << " #" << sr->amount;
             return;
         }
+        if (auto* reg = dynamic_cast<RegOperand*>(op))
+        {
+            printOperand(reg->reg);
+            return;
+        }
+        if (auto* lb = dynamic_cast<LabelOperand*>(op))
+        {
+            printLabel(lb->targetBlockId);
+            return;
+        }
+        if (auto* sym = dynamic_cast<SymbolOperand*>(op))
+        {
+            out_ << sym->name;
+            return;
+        }
+        if (auto* imm = dynamic_cast<ImmeOperand*>(op))
+        {
+            out_ << '#' << imm->value;
+            return;
+        }
+        if (auto* imm = dynamic_cast<I32Operand*>(op))
+        {
+            out_ << '#' << imm->val;
+            return;
+        }
+        if (auto* fimm = dynamic_cast<F32Operand*>(op))
+        {
+            // fmov 的浮点立即数只有 8 位精度，%.9g 足以精确表示
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "#%.9g", static_cast<double>(fimm->val));
+            out_ << buf;
+            return;
+        }
+        if (auto* fi = dynamic_cast<FrameIndexOperand*>(op))
+        {
+            out_ << "[FI#" << fi->frameIndex << "]";
+            return;
+        }
+        ERROR("Unsupported operand type in printing");
+    }
 
-        auto opAsm  = getOpInfoAsm(inst->op);
-        auto opType = getOpInfoType(inst->op);
-
-        ss << "  " << opAsm;
+    void Codegen::printASM(Instr* inst)
+    {
+        auto& ops = inst->operands;
 
-        switch (opType)
+        switch (inst->op)
         {
-            case OpType::L:
+            case Operator::LA:
             {
-                auto* lb = static_cast<LabelOperand*>(inst->operands[0]);
-                ss << " " << "." << cur_func_->name << "_" << lb->targetBlockId;
-                break;
+                // adrp + add :lo12:，寻址范围 ±4GiB
+                auto* sym = static_cast<SymbolOperand*>(ops[1]);
+                out_ << "adrp\t";
+                printOperand(ops[0]);
+                out_ << ", " << sym->name << "\n\tadd\t\t";
+                printOperand(ops[0]);
+                out_ << ", ";
+                printOperand(ops[0]);
+                out_ << ", :lo12:" << sym->name;
+                return;
             }
-            case OpType::SYM:
+            case Operator::UXTW:
             {
-                auto* so = static_cast<SymbolOperand*>(inst->operands[0]);
-                ss << " " << so->name;
-                break;
+                // 写 w 寄存器会清零高 32 位
+                out_ << "mov\t\t";
+                printReg(static_cast<RegOperand*>(ops[0])->reg, false);
+                out_ << ", ";
+                printReg(static_cast<RegOperand*>(ops[1])->reg, false);
+                return;
             }
-            case OpType::P:
+            case Operator::SXTW:
             {
-                if (inst->op == Operator::STP)
-                {
-                    auto* r1 = static_cast<RegOperand*>(inst->operands[0]);
-                    auto* r2 = static_cast<RegOperand*>(inst->operands[1]);
-                    auto* rb = static_cast<RegOperand*>(inst->operands[2]);
-                    auto* io = static_cast<ImmeOperand*>(inst->operands[3]);
-                    ss << " " << formatOperand(r1) << ", " << formatOperand(r2) << ", [" << formatOperand(rb) << ", #"
-                       << io->value << "]!";
-                }
-                else if (inst->op == Operator::LDP)
-                {
-                    auto* r1 = static_cast<RegOperand*>(inst->operands[0]);
-                    auto* r2 = static_cast<RegOperand*>(inst->operands[1]);
-                    auto* rb = static_cast<RegOperand*>(inst->operands[2]);
-                    auto* io = static_cast<ImmeOperand*>(inst->operands[3]);
-                    ss << " " << formatOperand(r1) << ", " << formatOperand(r2) << ", [" << formatOperand(rb) << "], #"
-                       << io->value;
-                }
-                break;
+                out_ << opText_[static_cast<size_t>(inst->op)];
+                printReg(static_cast<RegOperand*>(ops[0])->reg, true);
+                out_ << ", ";
+                printReg(static_cast<RegOperand*>(ops[1])->reg, false);
+                return;
             }
-            case OpType::R2:
-                if (inst->op == Operator::LA)
-                {
-                    auto* dst = static_cast<RegOperand*>(inst->operands[0]);
-                    auto* sym = static_cast<SymbolOperand*>(inst->operands[1]);
-                    ss << " " << formatOperand(dst) << ", =" << sym->name;
-                }
-                else if (inst->op == Operator::CMP)
+            case Operator::MOV:
+            {
+                // 截断拷贝 mov wD, wS：源寄存器按目标宽度输出
+                Register dst     = static_cast<RegOperand*>(ops[0])->reg;
+                bool     isFloat = isFloatReg(dst);
+                out_ << (isFloat ? "fmov\t" : "mov\t\t");
+                printOperand(ops[0]);
+                out_ << ", ";
+                if (isFloat)
+                    printOperand(ops[1]);
+                else
+                    printReg(static_cast<RegOperand*>(ops[1])->reg, is64BitReg(dst));
+                return;
+            }
+            case Operator::CSET:
+            {
+                out_ << opText_[static_cast<size_t>(inst->op)];
+                printOperand(ops[0]);
+                out_ << ", " << getCondName(static_cast<CondCode>(static_cast<ImmeOperand*>(ops[1])->value));
+                return;
+            }
+            case Operator::CSEL:
+            {
+                out_ << opText_[static_cast<size_t>(inst->op)];
+                printOperand(ops[0]);
+                out_ << ", ";
+                printOperand(ops[1]);
+                out_ << ", ";
+                printOperand(ops[2]);
+                out_ << ", " << getCondName(static_cast<CondCode>(static_cast<ImmeOperand*>(ops[3])->value));
+                return;
+            }
+            case Operator::FCMP:
+            {
+                out_ << opText_[static_cast<size_t>(inst->op)];
+                printOperand(ops[0]);
+                if (dynamic_cast<ImmeOperand*>(ops[1]))
+                    out_ << ", #0.0";
+                else
                 {
-                    if (dynamic_cast<ImmeOperand*>(inst->operands[1]) != nullptr)
-                        ss << " " << formatOperand(inst->operands[0]) << ", #"
-                           << static_cast<ImmeOperand*>(inst->operands[1])->value;
-                    else
-                        ss << " " << formatOperand(inst->operands[0]) << ", " << formatOperand(inst->operands[1]);
+                    out_ << ", ";
+                    printOperand(ops[1]);
                 }
-                else if (inst->op == Operator::CSET)
+                return;
+            }
+            case Operator::AND:
+            case Operator::ORR:
+            case Operator::EOR:
+            {
+                auto* imm = dynamic_cast<ImmeOperand*>(ops[2]);
+                if (!imm) break;
+                // 位掩码立即数以十六进制输出，按目标寄存器宽度截断
+                bool     w64  = is64BitReg(static_cast<RegOperand*>(ops[0])->reg);
+                uint64_t bits = w64 ? static_cast<uint64_t>(static_cast<int64_t>(imm->value))
+                                    : static_cast<uint64_t>(static_cast<uint32_t>(imm->value));
+                out_ << opText_[static_cast<size_t>(inst->op)];
+                printOperand(ops[0]);
+                out_ << ", ";
+                printOperand(ops[1]);
+                out_ << ", #0x";
+                out_.hex(bits);
+                return;
+            }
+            default: break;
+        }
+
+        OpType opType = getOpInfoType(inst->op);
+
+        // 偏移为负或不是访问宽度的倍数时使用非缩放形式 ldur/stur
+        if (opType == OpType::M)
+        {
+            auto*    mem = static_cast<MemOperand*>(ops[1]);
+            Register rt  = static_cast<RegOperand*>(ops[0])->reg;
+            bool     unscaled =
+                !mem->hasIndex && mem->mode == AddrMode::Offset && (mem->offset < 0 || mem->offset % accessSize(rt));
+            if (unscaled)
+                out_ << (inst->op == Operator::LDR ? "ldur\t" : "stur\t");
+            else
+                out_ << opText_[static_cast<size_t>(inst->op)];
+            printOperand(ops[0]);
+            out_ << ", ";
+            printMem(mem);
+        }
+        else
+        {
+            out_ << opText_[static_cast<size_t>(inst->op)];
+            switch (opType)
+            {
+                case OpType::I:
                 {
-                    auto*       dst  = static_cast<RegOperand*>(inst->operands[0]);
-                    auto*       cc   = static_cast<ImmeOperand*>(inst->operands[1]);
-                    const char* cond = "eq";
-                    switch (cc->value)
-                    {
-                        case 0: cond = "eq"; break;   // Equal
-                        case 1: cond = "ne"; break;   // Not Equal
-                        case 2: cond = "hs"; break;   // Unsigned >= (HS/CS)
-                        case 3: cond = "lo"; break;   // Unsigned < (LO/CC)
-                        case 8: cond = "hi"; break;   // Unsigned >
-                        case 9: cond = "ls"; break;   // Unsigned <=
-                        case 10: cond = "ge"; break;  // Signed >=
-                        case 11: cond = "lt"; break;  // Signed <
-                        case 12: cond = "gt"; break;  // Signed >
-                        case 13: cond = "le"; break;  // Signed <=
-                        default: cond = "eq"; break;
-                    }
-                    ss << " " << formatOperand(dst) << ", " << cond;
+                    printOperand(ops[0]);
+                    out_ << ", ";
+                    printOperand(ops[1]);
+                    int shift = ops.size() > 2 ? static_cast<ImmeOperand*>(ops[2])->value : 0;
+                    if (shift) out_ << ", lsl #" << shift;
+                    break;
                 }
-                else if (inst->op == Operator::MOV)
-                {
-                    auto* dst = static_cast<RegOperand*>(inst->operands[0]);
-                    auto* src = static_cast<RegOperand*>(inst->operands[1]);
-                    bool  isFloatMove =
-                        (dst->reg.dt == F32 || dst->reg.dt == F64) && (src->reg.dt == F32 || src->reg.dt == F64);
-                    if (isFloatMove)
+                case OpType::Z: break;
+                default:
+                    for (size_t i = 0; i < ops.size(); ++i)
                     {
-                        ss.str("");
-                        ss << "  fmov " << formatOperand(inst->operands[0]) << ", " << formatOperand(inst->operands[1]);
+                        if (i) out_ << ", ";
+                        printOperand(ops[i]);
                     }
-                    else { ss << " " << formatOperand(inst->operands[0]) << ", " << formatOperand(inst->operands[1]); }
-                }
-                else
-                    ss << " " << formatOperand(inst->operands[0]) << ", " << formatOperand(inst->operands[1]);
-                break;
-            case OpType::R:
+                    break;
+            }
+        }
+
+        if (!inst->comment.empty()) out_ << "\t// " << inst->comment;
+    }
+
+    void Codegen::printGlobalDefinitions()
+    {
+        if (module_->globals.empty()) return;
+
+        out_ << "\n\t.data\n";
+        for (auto* gv : module_->globals)
+        {
+            out_ << "\t.p2align\t3\n" << gv->name << ":\n";
+            bool is32 = (gv->type == I32 || gv->type == F32);
+            if (gv->isScalar())
             {
-                if (inst->op == Operator::MOVZ || inst->op == Operator::MOVK || inst->op == Operator::MOVN)
-                {
-                    ss << " " << formatOperand(inst->operands[0]);
-                    if (inst->operands.size() >= 2 && dynamic_cast<ImmeOperand*>(inst->operands[1]) != nullptr)
-                    {
-                        ss << ", #" << static_cast<ImmeOperand*>(inst->operands[1])->value;
-                        if (inst->operands.size() >= 3 && dynamic_cast<ImmeOperand*>(inst->operands[2]) != nullptr)
-                        {
-                            ss << ", lsl #" << static_cast<ImmeOperand*>(inst->operands[2])->value;
-                        }
-                    }
-                }
+                if (is32)
+                    out_ << "\t.word\t" << (gv->initVals.empty() ? 0 : gv->initVals[0]) << "\n";
                 else
-                {
-                    ss << " " << formatOperand(inst->operands[0]) << ", " << formatOperand(inst->operands[1]) << ", ";
-                    if (inst->operands.size() >= 3)
-                    {
-                        if (dynamic_cast<ImmeOperand*>(inst->operands[2]) != nullptr)
-                            ss << "#" << static_cast<ImmeOperand*>(inst->operands[2])->value;
-                        else
-                            ss << formatOperand(inst->operands[2]);
-                    }
-                }
-                break;
+                    out_ << "\t.quad\t" << (gv->initVals.empty() ? 0LL : static_cast<long long>(gv->initVals[0]))
+                         << "\n";
+                continue;
             }
-            case OpType::M:
-                ss << " " << formatOperand(inst->operands[0]) << ", " << formatOperand(inst->operands[1]);
-                break;
-            case OpType::Z:
+
+            int total_elems = 1;
+            for (int d : gv->dims) total_elems *= d;
+            int sz = is32 ? 4 : 8;
+            if (gv->initVals.empty())
+            {
+                out_ << "\t.zero\t" << (total_elems * sz) << "\n";
+                continue;
+            }
+
+            int zero_cum = 0;
+            for (int v : gv->initVals)
             {
-                if (inst->op == Operator::RET)
-                    ;
-                else if (inst->op == Operator::STP)
+                if (v == 0)
                 {
-                    auto* r1 = static_cast<RegOperand*>(inst->operands[0]);
-                    auto* r2 = static_cast<RegOperand*>(inst->operands[1]);
-                    auto* rb = static_cast<RegOperand*>(inst->operands[2]);
-                    auto* io = static_cast<ImmeOperand*>(inst->operands[3]);
-                    ss << " " << formatOperand(r1) << ", " << formatOperand(r2) << ", [" << formatOperand(rb) << ", #"
-                       << io->value << "]!";
+                    zero_cum += sz;
+                    continue;
                 }
-                else if (inst->op == Operator::LDP)
+                if (zero_cum)
                 {
-                    auto* r1 = static_cast<RegOperand*>(inst->operands[0]);
-                    auto* r2 = static_cast<RegOperand*>(inst->operands[1]);
-                    auto* rb = static_cast<RegOperand*>(inst->operands[2]);
-                    auto* io = static_cast<ImmeOperand*>(inst->operands[3]);
-                    ss << " " << formatOperand(r1) << ", " << formatOperand(r2) << ", [" << formatOperand(rb) << "], "
-                       << "#" << io->value;
+                    out_ << "\t.zero\t" << zero_cum << "\n";
+                    zero_cum = 0;
                 }
-                break;
+                out_ << (is32 ? "\t.word\t" : "\t.quad\t") << v << "\n";
             }
+            if (zero_cum) out_ << "\t.zero\t" << zero_cum << "\n";
         }
-        out_ << ss.str();
-
-        if (minst->comment != "") out_ << "  // " << minst->comment;
-
-        out_ << "\n";
     }
 }  // namespace BE::AArch64
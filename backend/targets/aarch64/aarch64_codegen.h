@@ -3,27 +3,39 @@
 
 #include <backend/mir/m_module.h>
 #include <backend/mir/m_codegen.h>
-#include <iostream>
+#include <backend/targets/aarch64/aarch64_defs.h>
+#include <string>
+#include <vector>
 
 namespace BE::AArch64
 {
-    class Codegen
+    class Codegen : public BE::MCodeGen
     {
       public:
-        Codegen(BE::Module* module, std::ostream& out) : module_(module), out_(out) {}
+        Codegen(BE::Module* module, std::ostream& out);
 
-        void generateAssembly();
+        void generateAssembly() override;
 
-      private:
-        BE::Module*   module_;
-        std::ostream& out_;
+      protected:
+        void printHeader() override;
+        void printFunctions() override;
+        void printFunction(BE::Function* func) override;
+        void printBlock(BE::Block* block) override;
+        void printInstruction(BE::MInstruction* inst) override;
+        void printGlobalDefinitions() override;
+
+        void printOperand(const Register& reg) override;
+        void printOperand(BE::Operand* op) override;
 
-        BE::Function* cur_func_       = nullptr;
-        int           cur_stack_size_ = 0;
+      private:
+        void printASM(Instr* inst);
+        void printMem(const MemOperand* mem);
+        void printLabel(int blockId);
+        void printReg(const Register& reg, bool as64);
 
-        void emitFunction(BE::Function* func);
-        void emitBlock(BE::Block* block);
-        void emitInstruction(BE::MInstruction* inst);
+        std::vector<std::string> opText_;           ///< 各指令助记符连同其后的对齐制表符
+        std::string              labelPrefix_;      ///< 当前函数块标签前缀 ".<func>_"
+        int                      nextBlockId_ = -1;  ///< 布局中的下一个块，跳到它的无条件跳转可省略
     };
 }  // namespace BE::AArch64
 
@@ -1,5 +1,6 @@
 #include <backend/targets/aarch64/aarch64_defs.h>
 #include <backend/mir/m_instruction.h>
+#include <cstring>
 
 namespace BE::AArch64
 {
@@ -26,4 +27,133 @@ namespace BE::AArch64
             default: return OpType::Z;
         }
     }
+
+    const char* getCondName(CondCode cc)
+    {
+        static const char* const names[] = {
+            "eq", "ne", "hs", "lo", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le"};
+        return names[static_cast<int>(cc)];
+    }
+
+    Operator getBranchOp(CondCode cc)
+    {
+        switch (cc)
+        {
+            case CondCode::EQ: return Operator::BEQ;
+            case CondCode::NE: return Operator::BNE;
+            case CondCode::HS: return Operator::BHS;
+            case CondCode::LO: return Operator::BLO;
+            case CondCode::MI: return Operator::BMI;
+            case CondCode::PL: return Operator::BPL;
+            case CondCode::VS: return Operator::BVS;
+            case CondCode::VC: return Operator::BVC;
+            case CondCode::HI: return Operator::BHI;
+            case CondCode::LS: return Operator::BLS;
+            case CondCode::GE: return Operator::BGE;
+            case CondCode::LT: return Operator::BLT;
+            case CondCode::GT: return Operator::BGT;
+            case CondCode::LE: return Operator::BLE;
+        }
+        return Operator::B;
+    }
+
+    CondCode swapCond(CondCode cc)
+    {
+        switch (cc)
+        {
+            case CondCode::HS: return CondCode::LS;
+            case CondCode::LO: return CondCode::HI;
+            case CondCode::HI: return CondCode::LO;
+            case CondCode::LS: return CondCode::HS;
+            case CondCode::GE: return CondCode::LE;
+            case CondCode::LT: return CondCode::GT;
+            case CondCode::GT: return CondCode::LT;
+            case CondCode::LE: return CondCode::GE;
+            default: return cc;
+        }
+    }
+
+    bool isLogicalImm(uint64_t value, bool is64)
+    {
+        if (!is64)
+        {
+            value &= A64_WORD_MASK;
+            if (value == 0 || value == A64_WORD_MASK) return false;
+            value |= value << 32;
+        }
+        else if (value == 0 || value == ~0ULL)
+            return false;
+
+        // 找到最小的重复元素宽度
+        unsigned size = 64;
+        while (size > 2)
+        {
+            unsigned half = size / 2;
+            uint64_t mask = (1ULL << half) - 1;
+            if ((value & mask) != ((value >> half) & mask)) break;
+            size = half;
+        }
+
+        // 元素内循环意义下恰有两次 0/1 翻转，即循环移位后为一段连续的 1
+        uint64_t elem        = size == 64 ? value : value & ((1ULL << size) - 1);
+        unsigned transitions = 0;
+        for (unsigned i = 0; i < size; ++i)
+        {
+            unsigned cur  = (elem >> i) & 1;
+            unsigned next = (elem >> ((i + 1) % size)) & 1;
+            if (cur != next) ++transitions;
+        }
+        return transitions == 2;
+    }
+
+    bool isFMovImm(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if (bits & 0x7ffff) return false;  // 尾数只保留高 4 位
+        int exp = static_cast<int>((bits >> 23) & 0xff) - 127;
+        return exp >= -3 && exp <= 4;
+    }
+
+    void emitMovImm(std::deque<MInstruction*>& out, Register rd, int64_t value)
+    {
+        size_t numSegs = is64BitReg(rd) ? 4 : 2;
+        auto   segs    = decomposeImm64(static_cast<unsigned long long>(value));
+
+        size_t zeros = 0, ones = 0;
+        for (size_t i = 0; i < numSegs; ++i)
+        {
+            if (segs[i] == 0) ++zeros;
+            if (segs[i] == A64_IMM16_MASK) ++ones;
+        }
+
+        // 全 1 分段更多时以 movn 起手，其余分段只需 movk 覆盖非 0xffff 的部分
+        bool     useMovn = ones > zeros;
+        unsigned skip    = useMovn ? A64_IMM16_MASK : 0;
+        bool     first   = true;
+        for (size_t i = 0; i < numSegs; ++i)
+        {
+            if (segs[i] == skip) continue;
+            int shift = static_cast<int>(i) * A64_IMM16_SHIFT;
+            if (first)
+            {
+                int imm = static_cast<int>(useMovn ? (~segs[i] & A64_IMM16_MASK) : segs[i]);
+                out.push_back(createInstr3(useMovn ? Operator::MOVN : Operator::MOVZ,
+                    new RegOperand(rd),
+                    new ImmeOperand(imm),
+                    new ImmeOperand(shift)));
+                first = false;
+            }
+            else
+                out.push_back(createInstr3(Operator::MOVK,
+                    new RegOperand(rd),
+                    new ImmeOperand(static_cast<int>(segs[i])),
+                    new ImmeOperand(shift)));
+        }
+        if (first)
+            out.push_back(createInstr3(useMovn ? Operator::MOVN : Operator::MOVZ,
+                new RegOperand(rd),
+                new ImmeOperand(0),
+                new ImmeOperand(0)));
+    }
 }  // namespace BE::AArch64
@@ -4,6 +4,8 @@
 #include <backend/mir/m_defs.h>
 #include <backend/mir/m_instruction.h>
 #include <array>
+#include <cstdint>
+#include <deque>
 #include <vector>
 #include <string>
 
@@ -25,7 +27,8 @@ namespace BE::AArch64
     constexpr unsigned A64_WORD_MASK        = 0xFFFFFFFFu;
 
     // (NAME, TYPE, ASM)
-    // TYPE: R (rd, rs1, rs2), R2 (rd, rs), M (rt, [base, off]), P (pair mem), Z (no operands)
+    // TYPE: R (rd, rn, rm|#imm|shifted), R3 (rd, rn, rm, ra|cond), R2 (rd, rs), I (rd, #imm16, lsl #sh),
+    //       M (rt, [mem]), P (rt1, rt2, [mem]), L (label), CB (rt, label), SYM (symbol), Z (no operands)
 #define A64_INSTS             \
     X(ADD, R, "add")          \
     X(SUB, R, "sub")          \
@@ -37,10 +40,14 @@ namespace BE::AArch64
     X(LSL, R, "lsl")          \
     X(LSR, R, "lsr")          \
     X(ASR, R, "asr")          \
-    X(MOVZ, R, "movz")        \
-    X(MOVN, R, "movn")        \
-    X(MOVK, R, "movk")        \
+    X(MADD, R3, "madd")       \
+    X(MSUB, R3, "msub")       \
+    X(CSEL, R3, "csel")       \
+    X(MOVZ, I, "movz")        \
+    X(MOVN, I, "movn")        \
+    X(MOVK, I, "movk")        \
     X(UXTW, R2, "uxtw")       \
+    X(SXTW, R2, "sxtw")       \
     X(LA, R2, "la")           \
     X(CSET, R2, "cset")       \
     X(STP, P, "stp")          \
@@ -49,13 +56,24 @@ namespace BE::AArch64
     X(LDR, M, "ldr")          \
     X(STR, M, "str")          \
     X(CMP, R2, "cmp")         \
+    X(CMN, R2, "cmn")         \
     X(B, L, "b")              \
     X(BEQ, L, "b.eq")         \
     X(BNE, L, "b.ne")         \
+    X(BHS, L, "b.hs")         \
+    X(BLO, L, "b.lo")         \
+    X(BMI, L, "b.mi")         \
+    X(BPL, L, "b.pl")         \
+    X(BVS, L, "b.vs")         \
+    X(BVC, L, "b.vc")         \
+    X(BHI, L, "b.hi")         \
+    X(BLS, L, "b.ls")         \
+    X(BGE, L, "b.ge")         \
     X(BLT, L, "b.lt")         \
-    X(BLE, L, "b.le")         \
     X(BGT, L, "b.gt")         \
-    X(BGE, L, "b.ge")         \
+    X(BLE, L, "b.le")         \
+    X(CBZ, CB, "cbz")         \
+    X(CBNZ, CB, "cbnz")       \
     X(BL, SYM, "bl")          \
     X(RET, Z, "ret")          \
     X(FADD, R, "fadd")        \
@@ -80,11 +98,14 @@ namespace BE::AArch64
 
     enum class OpType
     {
-        R,    // rd, rs1, rs2
+        R,    // rd, rn, rm / #imm / 移位寄存器
+        R3,   // rd, rn, rm, ra（madd/msub）或 rd, rn, rm, cond（csel）
         R2,   // rd, rs
-        M,    // rt, [base, #off]
-        P,    // pair mem (stp/ldp)
+        I,    // rd, #imm16, lsl #shift（movz/movn/movk）
+        M,    // rt, [base, ...]
+        P,    // rt1, rt2, [base, ...]（stp/ldp）
         L,    // label only
+        CB,   // rt, label（cbz/cbnz）
         SYM,  // symbol only (bl)
         Z     // no operands
     };
@@ -92,6 +113,34 @@ namespace BE::AArch64
     std::string getOpInfoAsm(Operator op);
     OpType      getOpInfoType(Operator op);
 
+    /**
+     * @brief 条件码，取值与指令编码中的 cond 字段一致，因此取反只需翻转最低位
+     */
+    enum class CondCode
+    {
+        EQ = 0,
+        NE = 1,
+        HS = 2,
+        LO = 3,
+        MI = 4,
+        PL = 5,
+        VS = 6,
+        VC = 7,
+        HI = 8,
+        LS = 9,
+        GE = 10,
+        LT = 11,
+        GT = 12,
+        LE = 13
+    };
+
+    const char* getCondName(CondCode cc);
+    inline CondCode invertCond(CondCode cc) { return static_cast<CondCode>(static_cast<int>(cc) ^ 1); }
+    // 条件码对应的 b.cond 操作码
+    Operator getBranchOp(CondCode cc);
+    // 交换比较两侧操作数后的等价条件码
+    CondCode swapCond(CondCode cc);
+
     class Instr : public BE::MInstruction
     {
       public:
@@ -191,6 +240,9 @@ namespace BE::AArch64
         return formatPhysReg(r, dt);
     }
 
+    inline bool isFloatReg(const Register& r) { return r.dt && r.dt->dt == DataType::Type::FLOAT; }
+    inline bool is64BitReg(const Register& r) { return !r.dt || r.dt->dl == DataType::Length::B64; }
+
     inline std::array<unsigned, 4> decomposeImm64(unsigned long long value)
     {
         std::array<unsigned, 4> segments{};
@@ -209,6 +261,25 @@ namespace BE::AArch64
         return static_cast<unsigned>(value / scale) <= A64_IMM12_MASK;
     }
 
+    // ldr/str 可直接编码的偏移：按访问宽度缩放的无符号 12 位，或 ldur/stur 的有符号 9 位
+    inline bool fitsMemOffset(int64_t value, int scale)
+    {
+        if (value >= -256 && value <= 255) return true;
+        return value >= 0 && value <= 0x7fffffff && fitsUnsignedScaledOffset(static_cast<int>(value), scale);
+    }
+
+    // add/sub/cmp 的 12 位无符号立即数（取负后可换用 sub/add/cmn）
+    inline bool fitsArithImm(int64_t value) { return value >= -4095 && value <= 4095; }
+
+    // and/orr/eor 的位掩码立即数：元素宽度 2~64 位、循环移位后为连续 1 的重复模式
+    bool isLogicalImm(uint64_t value, bool is64);
+
+    // fmov 的 8 位浮点立即数：±(16..31)/16 × 2^(-3..4)
+    bool isFMovImm(float value);
+
+    /**
+     * @brief 立即数操作数
+     */
     class ImmeOperand : public Operand
     {
       public:
@@ -216,12 +287,60 @@ namespace BE::AArch64
         ImmeOperand(int val) : Operand(I32, Operand::Type::IMMI32), value(val) {}
     };
 
+    // 寄存器偏移 / 移位寄存器操作数的扩展方式（LSR 只用于移位寄存器操作数）
+    enum class Extend
+    {
+        LSL,
+        LSR,
+        SXTW,
+        UXTW
+    };
+
+    // 访存寻址模式：[base, #off]、[base, #off]!（前变址）、[base], #off（后变址）
+    enum class AddrMode
+    {
+        Offset,
+        PreIndex,
+        PostIndex
+    };
+
+    /**
+     * @brief 访存操作数
+     *
+     * 立即数形式 [base, #offset]（可带前/后变址写回），
+     * 或寄存器偏移形式 [base, index{, sxtw|lsl #shift}]，shift 只能为 0 或访问宽度的 log2。
+     */
     class MemOperand : public Operand
     {
       public:
         Register base;
         int      offset;
-        MemOperand(Register b, int o) : Operand(PTR, Operand::Type::REG), base(b), offset(o) {}
+        AddrMode mode     = AddrMode::Offset;
+        bool     hasIndex = false;
+        Register index;
+        Extend   ext   = Extend::LSL;
+        int      shift = 0;
+
+        MemOperand(Register b, int o, AddrMode m = AddrMode::Offset)
+            : Operand(PTR, Operand::Type::REG), base(b), offset(o), mode(m)
+        {}
+        MemOperand(Register b, Register idx, Extend e, int sh)
+            : Operand(PTR, Operand::Type::REG), base(b), offset(0), hasIndex(true), index(idx), ext(e), shift(sh)
+        {}
+    };
+
+    /**
+     * @brief 移位 / 扩展寄存器操作数，用作 add/sub 的第二源操作数：xN, lsl #k、wN, lsr #k 或 wN, sxtw #k
+     */
+    class ShiftedRegOperand : public Operand
+    {
+      public:
+        Register reg;
+        Extend   ext;
+        int      amount;
+        ShiftedRegOperand(Register r, Extend e, int amt)
+            : Operand(r.dt, Operand::Type::REG), reg(r), ext(e), amount(amt)
+        {}
     };
 
     class LabelOperand : public Operand
@@ -238,6 +357,31 @@ namespace BE::AArch64
         SymbolOperand(const std::string& n) : Operand(PTR, Operand::Type::REG), name(n) {}
     };
 
+    inline Instr* createRInst(Operator op, Register rd, Register rn, Register rm)
+    {
+        return createInstr3(op, new RegOperand(rd), new RegOperand(rn), new RegOperand(rm));
+    }
+    inline Instr* createRInst(Operator op, Register rd, Register rn, int imm)
+    {
+        return createInstr3(op, new RegOperand(rd), new RegOperand(rn), new ImmeOperand(imm));
+    }
+    inline Instr* createR2Inst(Operator op, Register rd, Register rs)
+    {
+        return createInstr2(op, new RegOperand(rd), new RegOperand(rs));
+    }
+    inline Instr* createR3Inst(Operator op, Register rd, Register rn, Register rm, Register ra)
+    {
+        return createInstr4(op, new RegOperand(rd), new RegOperand(rn), new RegOperand(rm), new RegOperand(ra));
+    }
+    inline Instr* createMemInst(Operator op, Register rt, MemOperand* mem)
+    {
+        return createInstr2(op, new RegOperand(rt), mem);
+    }
+    inline Instr* createBranch(Operator op, int targetBlockId)
+    {
+        return createInstr1(op, new LabelOperand(targetBlockId));
+    }
+
     inline Instr* createMove(Operand* dst, Operand* src, const std::string& comment = "")
     {
         if (ImmeOperand* imi = dynamic_cast<ImmeOperand*>(src))
@@ -272,6 +416,9 @@ namespace BE::AArch64
         return AArch64::createMove(dst, new ImmeOperand(imm), comment);
     }
 
+    // 将 64 位常量装入 rd：按 16 位分段选择 movz 或 movn 起手，其余非平凡分段用 movk 补齐
+    void emitMovImm(std::deque<MInstruction*>& out, Register rd, int64_t value);
+
     namespace PR
     {
 #define A64_X_REGS \
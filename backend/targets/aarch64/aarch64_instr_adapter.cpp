@@ -1,67 +1,273 @@
 #include <backend/targets/aarch64/aarch64_instr_adapter.h>
 #include <backend/targets/aarch64/aarch64_defs.h>
+#include <algorithm>
 #include <debug.h>
 
 namespace BE::Targeting::AArch64
 {
     using namespace BE::AArch64;
 
-    bool InstrAdapter::isCall(BE::MInstruction* inst) const { TODO("判断是否为调用指令"); }
+    bool InstrAdapter::isCall(BE::MInstruction* inst) const
+    {
+        auto* ai = dynamic_cast<Instr*>(inst);
+        return ai && ai->op == Operator::BL;
+    }
+
+    bool InstrAdapter::isReturn(BE::MInstruction* inst) const
+    {
+        auto* ai = dynamic_cast<Instr*>(inst);
+        return ai && ai->op == Operator::RET;
+    }
+
+    bool InstrAdapter::isUncondBranch(BE::MInstruction* inst) const
+    {
+        auto* ai = dynamic_cast<Instr*>(inst);
+        return ai && ai->op == Operator::B;
+    }
+
+    bool InstrAdapter::isCondBranch(BE::MInstruction* inst) const
+    {
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return false;
+        switch (ai->op)
+        {
+            case Operator::BEQ:
+            case Operator::BNE:
+            case Operator::BHS:
+            case Operator::BLO:
+            case Operator::BMI:
+            case Operator::BPL:
+            case Operator::BVS:
+            case Operator::BVC:
+            case Operator::BHI:
+            case Operator::BLS:
+            case Operator::BGE:
+            case Operator::BLT:
+            case Operator::BGT:
+            case Operator::BLE:
+            case Operator::CBZ:
+            case Operator::CBNZ: return true;
+            default: return false;
+        }
+    }
+
+    int InstrAdapter::extractBranchTarget(BE::MInstruction* inst) const
+    {
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return -1;
+        for (auto* op : ai->operands)
+            if (auto* label = dynamic_cast<LabelOperand*>(op)) return label->targetBlockId;
+        return -1;
+    }
+
+    // 指令开头的“定义”操作数个数，其余寄存器操作数均为“使用”
+    static size_t defCount(Operator op)
+    {
+        switch (op)
+        {
+            case Operator::STR:
+            case Operator::STP:
+            case Operator::CMP:
+            case Operator::CMN:
+            case Operator::FCMP:
+            case Operator::CBZ:
+            case Operator::CBNZ:
+            case Operator::BL:
+            case Operator::RET:
+            case Operator::NOP: return 0;
+            case Operator::LDP: return 2;
+            default: break;
+        }
+        return getOpInfoType(op) == OpType::L ? 0 : 1;
+    }
 
-    bool InstrAdapter::isReturn(BE::MInstruction* inst) const { TODO("判断是否为返回指令"); }
+    // movk 只改写 rd 的一个 16 位分段，rd 同时是使用
+    static bool defIsAlsoUse(Operator op) { return op == Operator::MOVK; }
 
-    bool InstrAdapter::isUncondBranch(BE::MInstruction* inst) const { TODO("判断是否为无条件跳转指令"); }
+    static void pushUnique(std::vector<BE::Register>& out, const BE::Register& r)
+    {
+        if (std::find(out.begin(), out.end(), r) == out.end()) out.push_back(r);
+    }
 
-    bool InstrAdapter::isCondBranch(BE::MInstruction* inst) const { TODO("判断是否为条件跳转指令"); }
+    // 访存与移位寄存器操作数中的寄存器不论位置都是使用
+    template <typename Fn>
+    static void forEachUseSlot(Instr* ai, Fn&& fn)
+    {
+        size_t defs = defIsAlsoUse(ai->op) ? 0 : defCount(ai->op);
+        for (size_t i = 0; i < ai->operands.size(); ++i)
+        {
+            Operand* op = ai->operands[i];
+            if (auto* mem = dynamic_cast<MemOperand*>(op))
+            {
+                fn(mem->base);
+                if (mem->hasIndex) fn(mem->index);
+            }
+            else if (auto* sh = dynamic_cast<ShiftedRegOperand*>(op))
+                fn(sh->reg);
+            else if (auto* reg = dynamic_cast<RegOperand*>(op))
+            {
+                if (i >= defs) fn(reg->reg);
+            }
+        }
+    }
 
-    int InstrAdapter::extractBranchTarget(BE::MInstruction* inst) const { TODO("从分支指令中提取目标基本块标签 ID"); }
+    template <typename Fn>
+    static void forEachDefSlot(Instr* ai, Fn&& fn)
+    {
+        size_t defs = std::min(defCount(ai->op), ai->operands.size());
+        for (size_t i = 0; i < defs; ++i)
+            if (auto* reg = dynamic_cast<RegOperand*>(ai->operands[i])) fn(reg->reg);
+    }
 
     void InstrAdapter::enumUses(BE::MInstruction* inst, std::vector<BE::Register>& out) const
     {
-        TODO("统计指令使用的寄存器，存入vector out中");
+        out.clear();
+        if (inst->kind == BE::InstKind::PHI)
+        {
+            auto* phi = dynamic_cast<BE::PhiInst*>(inst);
+            for (auto& [label, op] : phi->incomingVals)
+                if (auto* regOp = dynamic_cast<BE::RegOperand*>(op))
+                    if (regOp->reg.isVreg) pushUnique(out, regOp->reg);
+            return;
+        }
+        if (inst->kind == BE::InstKind::MOVE)
+        {
+            auto* mv = dynamic_cast<BE::MoveInst*>(inst);
+            if (auto* regOp = dynamic_cast<BE::RegOperand*>(mv->src))
+                if (regOp->reg.isVreg) out.push_back(regOp->reg);
+            return;
+        }
+        if (inst->kind == BE::InstKind::SSLOT)
+        {
+            auto* fi = dynamic_cast<BE::FIStoreInst*>(inst);
+            if (fi->src.isVreg) out.push_back(fi->src);
+            return;
+        }
+
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return;
+        forEachUseSlot(ai, [&](BE::Register& r) {
+            if (r.isVreg) pushUnique(out, r);
+        });
     }
 
     void InstrAdapter::enumDefs(BE::MInstruction* inst, std::vector<BE::Register>& out) const
     {
-        TODO("统计指令定义的寄存器，存入vector out中(可能为空集)");
+        out.clear();
+        if (inst->kind == BE::InstKind::PHI)
+        {
+            auto* phi = dynamic_cast<BE::PhiInst*>(inst);
+            if (phi->resReg.isVreg) out.push_back(phi->resReg);
+            return;
+        }
+        if (inst->kind == BE::InstKind::MOVE)
+        {
+            auto* mv = dynamic_cast<BE::MoveInst*>(inst);
+            if (auto* regOp = dynamic_cast<BE::RegOperand*>(mv->dest))
+                if (regOp->reg.isVreg) out.push_back(regOp->reg);
+            return;
+        }
+        if (inst->kind == BE::InstKind::LSLOT)
+        {
+            auto* fi = dynamic_cast<BE::FILoadInst*>(inst);
+            if (fi->dest.isVreg) out.push_back(fi->dest);
+            return;
+        }
+
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return;
+        forEachDefSlot(ai, [&](BE::Register& r) {
+            if (r.isVreg) pushUnique(out, r);
+        });
+    }
+
+    static void replaceReg(BE::Register& slot, const BE::Register& from, const BE::Register& to)
+    {
+        if (slot == from) slot = to;
     }
 
     static void replaceOne(Operand* op, const BE::Register& from, const BE::Register& to)
     {
-        if (auto* regOp = dynamic_cast<RegOperand*>(op))
-            if (regOp->reg == from) regOp->reg = to;
+        if (auto* regOp = dynamic_cast<RegOperand*>(op)) replaceReg(regOp->reg, from, to);
     }
 
-    // tip: 1.MemOperand 的 base 和 RegOperand 的 reg 都是寄存器，需要分别处理
-    //      2.注意不同指令的寄存器使用方式不同，个数也不相同，需要根据指令类型进行处理
-    //      3.定义寄存器可能为空集，需要根据指令类型进行处理
-    //      4.可以借助replaceOne函数实现
     void InstrAdapter::replaceUse(BE::MInstruction* inst, const BE::Register& from, const BE::Register& to) const
     {
-        (void)replaceOne;
-        TODO("实现 replaceUse，替换指令中的使用寄存器，从from替换为to");
+        if (inst->kind == BE::InstKind::PHI)
+        {
+            auto* phi = dynamic_cast<BE::PhiInst*>(inst);
+            for (auto& [label, op] : phi->incomingVals) replaceOne(op, from, to);
+            return;
+        }
+        if (inst->kind == BE::InstKind::MOVE)
+        {
+            replaceOne(dynamic_cast<BE::MoveInst*>(inst)->src, from, to);
+            return;
+        }
+        if (inst->kind == BE::InstKind::SSLOT)
+        {
+            replaceReg(dynamic_cast<BE::FIStoreInst*>(inst)->src, from, to);
+            return;
+        }
+
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return;
+        forEachUseSlot(ai, [&](BE::Register& r) { replaceReg(r, from, to); });
     }
 
     void InstrAdapter::replaceDef(BE::MInstruction* inst, const BE::Register& from, const BE::Register& to) const
     {
-        (void)replaceOne;
-        TODO("实现 replaceDef，替换指令中的定义寄存器，从from替换为to");
+        if (inst->kind == BE::InstKind::PHI)
+        {
+            replaceReg(dynamic_cast<BE::PhiInst*>(inst)->resReg, from, to);
+            return;
+        }
+        if (inst->kind == BE::InstKind::MOVE)
+        {
+            replaceOne(dynamic_cast<BE::MoveInst*>(inst)->dest, from, to);
+            return;
+        }
+        if (inst->kind == BE::InstKind::LSLOT)
+        {
+            replaceReg(dynamic_cast<BE::FILoadInst*>(inst)->dest, from, to);
+            return;
+        }
+
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return;
+        forEachDefSlot(ai, [&](BE::Register& r) { replaceReg(r, from, to); });
     }
 
     void InstrAdapter::enumPhysRegs(BE::MInstruction* inst, std::vector<BE::Register>& out) const
     {
-        TODO("实现 enumPhysRegs");
+        out.clear();
+        auto collect = [&](const BE::Register& r) {
+            if (!r.isVreg && r.rId != A64_REGISTER_ID_SP && r.rId != A64_REGISTER_ID_XZR) pushUnique(out, r);
+        };
+
+        if (inst->kind == BE::InstKind::MOVE)
+        {
+            auto* mv = dynamic_cast<BE::MoveInst*>(inst);
+            if (auto* regOp = dynamic_cast<BE::RegOperand*>(mv->src)) collect(regOp->reg);
+            if (auto* regOp = dynamic_cast<BE::RegOperand*>(mv->dest)) collect(regOp->reg);
+            return;
+        }
+
+        auto* ai = dynamic_cast<Instr*>(inst);
+        if (!ai) return;
+        forEachDefSlot(ai, collect);
+        forEachUseSlot(ai, collect);
     }
 
     void InstrAdapter::insertReloadBefore(
         BE::Block* block, std::deque<BE::MInstruction*>::iterator it, const BE::Register& physReg, int frameIndex) const
     {
-        TODO("实现 insertReloadBefore");
+        block->insts.insert(it, new BE::FILoadInst(physReg, frameIndex, "reload from spill slot"));
     }
 
     void InstrAdapter::insertSpillAfter(
         BE::Block* block, std::deque<BE::MInstruction*>::iterator it, const BE::Register& physReg, int frameIndex) const
     {
-        TODO("实现 insertSpillAfter");
+        block->insts.insert(std::next(it), new BE::FIStoreInst(physReg, frameIndex, "spill to spill slot"));
     }
 }  // namespace BE::Targeting::AArch64
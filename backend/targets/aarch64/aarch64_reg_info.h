@@ -9,23 +9,60 @@ namespace BE::Targeting::AArch64
 {
     class RegInfo : public TargetRegInfo
     {
+      private:
+        // GPR 与 FPR 共用 0..31 的编号，靠寄存器的数据类型区分（x/w 与 d/s）
+        // x0-x7 参数，x8 间接结果，x9-x15 临时，x16/x17 过程内调用临时，x18 平台保留，
+        // x19-x28 被调用者保存，x29 帧指针，x30 链接寄存器，31 = sp，32 = xzr
+        // d0-d7 参数，d8-d15 被调用者保存（低 64 位），d16-d31 临时
+        //
+        // 被调用者保存寄存器可分配给任意区间；不跨调用的区间还可使用 x0-x8、x12-x15 与 d0-d7、d19-d31，
+        // 叶函数因此不必在序言/尾声中保存寄存器。x9-x11 / d16-d18 作为溢出改写的临时寄存器，
+        // x16/x17 留给栈降低（大偏移、浮点立即数），因此 reservedRegs 只列出与各类可分配集合都不相交的编号
+
+        inline static const std::vector<int> intArgRegs_     = {0, 1, 2, 3, 4, 5, 6, 7};                   // x0-x7
+        inline static const std::vector<int> floatArgRegs_   = {0, 1, 2, 3, 4, 5, 6, 7};                   // d0-d7
+        inline static const std::vector<int> calleeSavedInt_ = {19, 20, 21, 22, 23, 24, 25, 26, 27, 28};  // x19-x28
+        inline static const std::vector<int> calleeSavedFP_  = {8, 9, 10, 11, 12, 13, 14, 15};            // d8-d15
+        inline static const std::vector<int> callerSavedInt_ = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 13, 14, 15};  // x0-x8, x12-x15
+        inline static const std::vector<int> callerSavedFP_  = {
+            0, 1, 2, 3, 4, 5, 6, 7, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+        };  // d0-d7, d19-d31
+        inline static const std::vector<int> reservedRegs_   = {16, 17, 18, 29, 30, 31, 32};  // ip0, ip1, pr, fp, lr, sp, xzr
+        inline static const std::vector<int> scratchInt_     = {9, 10, 11};                    // x9-x11
+        inline static const std::vector<int> scratchFP_      = {16, 17, 18};                   // d16-d18
+        inline static const std::vector<int> noCompact_;                                        // A64 为定长编码
+        inline static const std::vector<int> intRegs_        = {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+            16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30
+        };  // x0-x30
+        inline static const std::vector<int> floatRegs_ = {
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+            16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
+        };  // d0-d31
+
       public:
-        RegInfo() { TODO("实现 RegInfo 的构造，如有必要"); }
+        RegInfo() = default;
 
-        int spRegId() const override { TODO("实现 spRegId"); }
-        int raRegId() const override { TODO("实现 raRegId"); }
-        int zeroRegId() const override { TODO("实现 zeroRegId"); }
+        int spRegId() const override { return BE::AArch64::A64_REGISTER_ID_SP; }
+        int raRegId() const override { return 30; }  // x30 = lr
+        int zeroRegId() const override { return BE::AArch64::A64_REGISTER_ID_XZR; }
 
-        const std::vector<int>& intArgRegs() const override { TODO("实现 intArgRegs"); }
-        const std::vector<int>& floatArgRegs() const override { TODO("实现 floatArgRegs"); }
+        const std::vector<int>& intArgRegs() const override { return intArgRegs_; }
+        const std::vector<int>& floatArgRegs() const override { return floatArgRegs_; }
 
-        const std::vector<int>& calleeSavedIntRegs() const override { TODO("实现 calleeSavedIntRegs"); }
-        const std::vector<int>& calleeSavedFloatRegs() const override { TODO("实现 calleeSavedFloatRegs"); }
+        const std::vector<int>& calleeSavedIntRegs() const override { return calleeSavedInt_; }
+        const std::vector<int>& calleeSavedFloatRegs() const override { return calleeSavedFP_; }
+        const std::vector<int>& callerSavedIntRegs() const override { return callerSavedInt_; }
+        const std::vector<int>& callerSavedFloatRegs() const override { return callerSavedFP_; }
 
-        const std::vector<int>& reservedRegs() const override { TODO("实现 reservedRegs"); }
+        const std::vector<int>& reservedRegs() const override { return reservedRegs_; }
+        const std::vector<int>& scratchIntRegs() const override { return scratchInt_; }
+        const std::vector<int>& scratchFloatRegs() const override { return scratchFP_; }
+        const std::vector<int>& compactIntRegs() const override { return noCompact_; }
+        const std::vector<int>& compactFloatRegs() const override { return noCompact_; }
 
-        const std::vector<int>& intRegs() const override { TODO("实现 intRegs"); }
-        const std::vector<int>& floatRegs() const override { TODO("实现 floatRegs"); }
+        const std::vector<int>& intRegs() const override { return intRegs_; }
+        const std::vector<int>& floatRegs() const override { return floatRegs_; }
     };
 }  // namespace BE::Targeting::AArch64
 
@@ -1,4 +1,3 @@
-#include "backend/targets/aarch64/aarch64_defs.h"
 #include <backend/targets/aarch64/aarch64_target.h>
 #include <backend/target/registry.h>
 #include <backend/targets/aarch64/isel/aarch64_dag_isel.h>
@@ -6,23 +5,18 @@
 #include <backend/targets/aarch64/aarch64_instr_adapter.h>
 #include <backend/targets/aarch64/aarch64_codegen.h>
 #include <backend/ra/linear_scan.h>
+#include <backend/ra/block_local.h>
 #include <backend/targets/aarch64/passes/lowering/frame_lowering.h>
 #include <backend/targets/aarch64/passes/lowering/stack_lowering.h>
 #include <backend/targets/aarch64/passes/lowering/phi_elimination.h>
+#include <backend/targets/aarch64/passes/optimize/ldst_pairing.h>
+#include <backend/targets/aarch64/dag/aarch64_dag_legalize.h>
 
 #include <debug.h>
 
 #include <map>
 #include <vector>
 
-namespace BE
-{
-    namespace RA
-    {
-        void setTargetInstrAdapter(const BE::Targeting::TargetInstrAdapter* adapter);
-    }
-}  // namespace BE
-
 namespace BE::Targeting::AArch64
 {
     namespace
@@ -37,41 +31,57 @@ namespace BE::Targeting::AArch64
         } s_auto_register;
     }  // namespace
 
-    void AArch64Target::runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out)
+    namespace
     {
-        static BE::Targeting::AArch64::InstrAdapter s_adapter;
-        static BE::Targeting::AArch64::RegInfo      s_regInfo;
-        BE::Targeting::setTargetInstrAdapter(&s_adapter);
-
-        TODO("选择一种 Instruction Selector 实现，并完成指令选择");
-        // BE::AArch64::DAGIsel isel(ir, backend, this);
-        // BE::AArch64::IRIsel isel(ir, backend, this);
-        // isel.run();
-
-        // Pre-RA
+        void runPreRAPasses(BE::Module& m, const BE::Targeting::TargetInstrAdapter* adapter)
         {
-            BE::AArch64::Passes::Lowering::FrameLoweringPass fl;
-            fl.runOnModule(*backend);
-
-            // 对实现了 mem2reg 优化的同学，还需完成 Phi Elimination
-            // BE::AArch64::Passes::Lowering::PhiEliminationPass phiElim;
-            // phiElim.runOnModule(*backend, &s_adapter);
-
-            TODO("如有需要，需在寄存器分配前完成其它伪指令的消解，如移动指令的消解");
+            BE::AArch64::Passes::Lowering::PhiEliminationPass phiElim;
+            phiElim.runOnModule(m, adapter);
         }
-
-        // RA
+        void runRAPipeline(BE::Module& m, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::AArch64::RegInfo& regInfo, int optLevel)
         {
-            TODO("使用你实现的寄存器分配器进行寄存器分配");
-            // BE::RA::LinearScanRA ra;
-            // ra.allocate(*backend, s_regInfo);
+            // -O0 只做块内分配，后端耗时与指令数线性相关
+            if (optLevel == 0)
+            {
+                BE::RA::BlockLocalRA local;
+                local.allocate(m, adapter, regInfo);
+                return;
+            }
+            BE::RA::LinearScanRA ls;
+            ls.allocate(m, adapter, regInfo);
         }
-
-        // Post-RA
+        void runPostRAPasses(BE::Module& m, int optLevel)
         {
-            BE::AArch64::Passes::Lowering::StackLoweringPass sl;
-            sl.runOnModule(*backend);
+            BE::AArch64::Passes::Lowering::FrameLoweringPass frameLowering;
+            frameLowering.runOnModule(m);
+            BE::AArch64::Passes::Lowering::StackLoweringPass stackLowering;
+            stackLowering.runOnModule(m);
+
+            // 相邻的同基址访存合并为 ldp/stp
+            if (optLevel > 0)
+            {
+                BE::AArch64::Passes::Optimize::LdStPairingPass pairing;
+                pairing.runOnModule(m);
+            }
         }
+    }  // namespace
+
+    void AArch64Target::legalizeDAG(BE::DAG::SelectionDAG& dag) const { BE::AArch64::DAGLegalizer().run(dag); }
+
+    void AArch64Target::runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out)
+    {
+        const BE::Targeting::AArch64::InstrAdapter adapter;
+        const BE::Targeting::AArch64::RegInfo      regInfo;
+
+        BE::AArch64::DAGIsel isel(ir, backend, this);
+        isel.run();
+
+        runPreRAPasses(*backend, &adapter);
+
+        runRAPipeline(*backend, &adapter, regInfo, optimize_level);
+
+        runPostRAPasses(*backend, optimize_level);
 
         BE::AArch64::Codegen codegen(backend, *out);
         codegen.generateAssembly();
@@ -19,6 +19,7 @@ namespace BE::Targeting::AArch64
       public:
         const char* getName() const override { return "aarch64"; }
         void        runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out) override;
+        void        legalizeDAG(DAG::SelectionDAG& dag) const override;
     };
 }  // namespace BE::Targeting::AArch64
 
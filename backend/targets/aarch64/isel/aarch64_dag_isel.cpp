@@ -9,62 +9,159 @@
 #include <middleend/module/ir_function.h>
 #include <debug.h>
 #include <transfer.h>
-#include <functional>
+#include <algorithm>
+#include <climits>
 #include <cstring>
 
-// 在 README 中已经说明了这里可能会出现 I32 op I64 的情况
-// 并且 selectBinary 中我也将处理这个情况的代码删去了，请自行考虑如何解决这个问题
+// 在 README 中已经说明了这里可能会出现 I32 op I64 的情况：
+// 每条整数指令按结果寄存器的宽度计算，宽度不一致的操作数经 getOperandReg(node, want64) 做 sxtw 或截断
 // 额外的，在 ../aarch64_def.h 中我定义了 LOC_STR 宏，它可以用于在创建指令时添加位置信息
-// 启用这个宏也许可以在你 debug 时帮助你迅速定位到一条错误的指令是在哪里创建的
 
 namespace BE::AArch64
 {
+    namespace
+    {
+        inline DAG::ISD opOf(const DAG::SDNode* n) { return static_cast<DAG::ISD>(n->getOpcode()); }
+
+        inline bool isConstInt(const DAG::SDNode* n)
+        {
+            auto op = opOf(n);
+            return (op == DAG::ISD::CONST_I32 || op == DAG::ISD::CONST_I64) && n->hasImmI64();
+        }
+        inline bool isConstValue(const DAG::SDNode* n, int64_t v) { return isConstInt(n) && n->getImmI64() == v; }
+
+        // +0.0 的位模式全零，可以直接使用 wzr
+        inline bool isPositiveZeroF32(const DAG::SDNode* n)
+        {
+            if (opOf(n) != DAG::ISD::CONST_F32 || !n->hasImmF32()) return false;
+            float    f = n->getImmF32();
+            uint32_t bits;
+            std::memcpy(&bits, &f, sizeof(bits));
+            return bits == 0;
+        }
+
+        inline BE::DataType* typeOf(const DAG::SDNode* n) { return n->getNumValues() > 0 ? n->getValueType(0) : BE::I32; }
+        inline bool isFloatType(BE::DataType* dt) { return dt && dt->dt == BE::DataType::Type::FLOAT; }
+        inline bool is64Type(BE::DataType* dt) { return dt && dt->dl == BE::DataType::Length::B64; }
+        inline bool fitsInt(int64_t v) { return v >= INT_MIN && v <= INT_MAX; }
+        inline Register zeroReg(bool is64) { return is64 ? PR::xzr : PR::wzr; }
+
+        inline int log2Exact(int64_t v)
+        {
+            if (v <= 0 || (v & (v - 1)) != 0) return -1;
+            int k = 0;
+            while ((int64_t(1) << k) != v) ++k;
+            return k;
+        }
+
+        // 可以被 add/sub 作为移位寄存器操作数吸收的 mul/shl：返回左移位数，否则 -1
+        int fusedShiftAmount(const DAG::SDNode* n)
+        {
+            if (n->getNumOperands() != 2) return -1;
+            const DAG::SDNode* rhs = n->getOperand(1).getNode();
+            if (!rhs || !isConstInt(rhs)) return -1;
+            int64_t c     = rhs->getImmI64();
+            int     width = is64Type(typeOf(n)) ? 64 : 32;
+            if (opOf(n) == DAG::ISD::SHL) return (c > 0 && c < width) ? static_cast<int>(c) : -1;
+            if (opOf(n) == DAG::ISD::MUL)
+            {
+                int k = log2Exact(c);
+                return (k > 0 && k < width) ? k : -1;
+            }
+            return -1;
+        }
+
+        CondCode icmpCond(int cc)
+        {
+            switch (static_cast<ME::ICmpOp>(cc))
+            {
+                case ME::ICmpOp::EQ: return CondCode::EQ;
+                case ME::ICmpOp::NE: return CondCode::NE;
+                case ME::ICmpOp::SGT: return CondCode::GT;
+                case ME::ICmpOp::SGE: return CondCode::GE;
+                case ME::ICmpOp::SLT: return CondCode::LT;
+                case ME::ICmpOp::SLE: return CondCode::LE;
+                case ME::ICmpOp::UGT: return CondCode::HI;
+                case ME::ICmpOp::UGE: return CondCode::HS;
+                case ME::ICmpOp::ULT: return CondCode::LO;
+                case ME::ICmpOp::ULE: return CondCode::LS;
+                default: ERROR("Unsupported ICMP condition: %d", cc);
+            }
+            return CondCode::EQ;
+        }
+
+        // fcmp 之后的条件码：无序时 NZCV = 0011，据此为有序/无序谓词各选一个条件码
+        // ONE、UEQ 需要两个条件码组合，返回 false
+        bool fcmpCond(int cc, CondCode& out)
+        {
+            switch (static_cast<ME::FCmpOp>(cc))
+            {
+                case ME::FCmpOp::OEQ: out = CondCode::EQ; return true;
+                case ME::FCmpOp::OGT: out = CondCode::GT; return true;
+                case ME::FCmpOp::OGE: out = CondCode::GE; return true;
+                case ME::FCmpOp::OLT: out = CondCode::MI; return true;
+                case ME::FCmpOp::OLE: out = CondCode::LS; return true;
+                case ME::FCmpOp::ORD: out = CondCode::VC; return true;
+                case ME::FCmpOp::UNO: out = CondCode::VS; return true;
+                case ME::FCmpOp::UGT: out = CondCode::HI; return true;
+                case ME::FCmpOp::UGE: out = CondCode::PL; return true;
+                case ME::FCmpOp::ULT: out = CondCode::LT; return true;
+                case ME::FCmpOp::ULE: out = CondCode::LE; return true;
+                case ME::FCmpOp::UNE: out = CondCode::NE; return true;
+                default: return false;
+            }
+        }
+
+        inline Instr* createCondInst(Operator op, Register rd, CondCode cc)
+        {
+            return createInstr2(op, new RegOperand(rd), new ImmeOperand(static_cast<int>(cc)));
+        }
+        inline Instr* createCselInst(Register rd, Register rn, Register rm, CondCode cc)
+        {
+            return createInstr4(Operator::CSEL,
+                new RegOperand(rd),
+                new RegOperand(rn),
+                new RegOperand(rm),
+                new ImmeOperand(static_cast<int>(cc)));
+        }
+        inline Instr* createCmpInst(Operator op, Register rn, Operand* rhs)
+        {
+            return createInstr2(op, new RegOperand(rn), rhs);
+        }
+    }  // namespace
+
     std::vector<const DAG::SDNode*> DAGIsel::scheduleDAG(const DAG::SelectionDAG& dag)
     {
-        // ============================================================================
-        // TODO: 实现 DAG 调度
-        // ============================================================================
-        //
-        // 作用：
-        // 将 DAG 的所有节点排序为线性指令序列，保证依赖关系正确。
-        //
-        // 为什么需要：
-        // - DAG 是无序的节点集合，生成代码前必须确定指令的先后顺序
-        // - 必须保证每条指令的操作数在使用前已被计算（拓扑序）
-        // - 需要正确处理 Chain 依赖，维持内存操作与副作用的顺序
-        //
-        // 如何做：
-        // - 后序遍历：从根节点（无使用者的节点）出发，先访问依赖再访问当前节点
+        // 后序遍历：从所有节点出发，先访问依赖再访问当前节点，得到满足数据与 Chain 依赖的拓扑序
+        std::vector<const DAG::SDNode*> result;
+        result.reserve(dag.getNodes().size());
+        numbering_.reset(dag);
+        DAG::NodeSet visited(numbering_);
+        visited.clear();
+
+        for (const auto* node : dag.getNodes()) postOrderHelper(node, numbering_, visited, result);
 
-        TODO("实现 DAG 调度：输出拓扑序的节点列表");
+        return result;
     }
 
     void DAGIsel::allocateRegistersForNode(const DAG::SDNode* node)
     {
-        // ============================================================================
-        // 为调度后的 DAG 节点预分配虚拟寄存器
-        // ============================================================================
-        //
-        // 为什么需要：
-        // - 在指令选择前，先为每个计算结果分配虚拟寄存器
-        // - 确保跨基本块的值（如 PHI 操作数）使用一致的寄存器映射
-        // - 分离"分配"与"使用"两个阶段，简化后续的指令生成逻辑
-        //
-        // 策略：
-        // - 若节点对应 IR 寄存器，复用 IR 寄存器映射
+        // 为调度后的 DAG 节点预分配虚拟寄存器：
+        // - 若节点对应 IR 寄存器，复用 IR 寄存器映射（跨块一致，PHI 依赖于此）
         // - 否则分配临时虚拟寄存器
-
+        // - 常量、LABEL、SYMBOL、FRAME_INDEX 等叶子节点由使用者按需实例化；只产生 Chain 的节点无需寄存器
         if (node->getNumValues() == 0) return;
 
-        auto opcode = static_cast<DAG::ISD>(node->getOpcode());
+        auto opcode = opOf(node);
 
         if (opcode == DAG::ISD::LABEL || opcode == DAG::ISD::SYMBOL || opcode == DAG::ISD::CONST_I32 ||
             opcode == DAG::ISD::CONST_I64 || opcode == DAG::ISD::CONST_F32 || opcode == DAG::ISD::FRAME_INDEX)
             return;
 
         BE::DataType* dt = node->getValueType(0);
-        Register      vreg;
+        if (dt == BE::TOKEN) return;
 
+        Register vreg;
         if (node->hasIRRegId())
             vreg = getOrCreateVReg(node->getIRRegId(), dt);
         else
@@ -73,64 +170,200 @@ namespace BE::AArch64
         nodeToVReg_[node] = vreg;
     }
 
+    int DAGIsel::crossBlockUses(const DAG::SDNode* node) const
+    {
+        if (!node->hasIRRegId() || !ctx_.crossBlockUses) return 0;
+        auto it = ctx_.crossBlockUses->find(node->getIRRegId());
+        return it == ctx_.crossBlockUses->end() ? 0 : it->second;
+    }
+
+    bool DAGIsel::hasSingleUse(const DAG::SDNode* node, const UserMap& users) const
+    {
+        const auto* u = users.lookup(node);
+        if (!u || u->size() != 1) return false;
+        return crossBlockUses(node) == 0;
+    }
+
+    int DAGIsel::accessSize(const DAG::SDNode* memNode)
+    {
+        if (opOf(memNode) == DAG::ISD::LOAD) return dataTypeSize(typeOf(memNode));
+        return dataTypeSize(typeOf(memNode->getOperand(1).getNode()));
+    }
+
+    bool DAGIsel::isFoldedAddress(const DAG::SDNode* node, const UserMap& users)
+    {
+        if (opOf(node) != DAG::ISD::ADD) return false;
+
+        const auto* nodeUsers = users.lookup(node);
+        if (!nodeUsers || nodeUsers->empty()) return false;
+        // 仍被其它块以寄存器方式引用时必须生成
+        if (crossBlockUses(node) != 0) return false;
+
+        const DAG::SDNode* base   = nullptr;
+        int64_t            offset = 0;
+        if (!selectAddress(node, base, offset) || base == node) return false;
+
+        for (auto& [user, idx] : *nodeUsers)
+        {
+            auto opc = opOf(user);
+            if (!(opc == DAG::ISD::LOAD && idx == 1) && !(opc == DAG::ISD::STORE && idx == 2)) return false;
+            // 栈槽基址的偏移由帧降低负责合法化，其余基址要求偏移可直接编码
+            if (opOf(base) != DAG::ISD::FRAME_INDEX && !fitsMemOffset(offset, accessSize(user))) return false;
+        }
+        return true;
+    }
+
+    void DAGIsel::markFoldedNodes(const std::vector<const DAG::SDNode*>& scheduled)
+    {
+        // ============================================================================
+        // 折叠分析：标记不需要单独生成指令的节点（预先放入 selected_）
+        // ============================================================================
+        //
+        // - 只被条件分支使用的 ICMP/FCMP：由分支直接生成 cmp + b.cond / cbz / cbnz
+        // - 只作为访存地址的 ADD：折叠为 [base, #imm] 或 [base, index{, sxtw|lsl #k}]
+        // - 被唯一使用者 add/sub 吸收的 mul/shl：生成 madd/msub 或移位寄存器操作数
+        // - 所有引用都已在后继块中重建的纯计算
+        fusedCompares_.clear();
+        fusedOperands_.clear();
+        indexedAddr_.clear();
+        widened_.clear();
+        if (!ctx_.crossBlockUses) return;
+
+        UserMap users(numbering_);
+        users.clear();
+        for (const auto* node : scheduled)
+            for (unsigned i = 0; i < node->getNumOperands(); ++i)
+                if (const auto* op = node->getOperand(i).getNode()) users[op].push_back({node, i});
+
+        auto userCount = [&users](const DAG::SDNode* n) {
+            const auto* u = users.lookup(n);
+            return u ? static_cast<int>(u->size()) : 0;
+        };
+
+        for (const auto* node : scheduled)
+        {
+            auto opcode = opOf(node);
+            if (opcode == DAG::ISD::BRCOND)
+            {
+                const DAG::SDNode* cond = node->getOperand(node->getNumOperands() == 3 ? 0 : 1).getNode();
+                if (!cond || userCount(cond) != 1 || crossBlockUses(cond) != 0) continue;
+                CondCode cc;
+                if (opOf(cond) == DAG::ISD::ICMP ||
+                    (opOf(cond) == DAG::ISD::FCMP && fcmpCond(static_cast<int>(cond->getImmI64()), cc)))
+                {
+                    fusedCompares_.insert(cond);
+                    selected_.insert(cond);
+                }
+                continue;
+            }
+
+            switch (opcode)
+            {
+                case DAG::ISD::COPY:
+                case DAG::ISD::ICMP:
+                case DAG::ISD::FCMP:
+                case DAG::ISD::ADD:
+                case DAG::ISD::SUB:
+                case DAG::ISD::MUL:
+                case DAG::ISD::AND:
+                case DAG::ISD::OR:
+                case DAG::ISD::XOR:
+                case DAG::ISD::SHL:
+                case DAG::ISD::ASHR:
+                case DAG::ISD::LSHR:
+                    if (node->hasIRRegId() && userCount(node) == 0 && crossBlockUses(node) == 0)
+                        selected_.insert(node);
+                    else if (isFoldedAddress(node, users))
+                        selected_.insert(node);
+                    break;
+                default: break;
+            }
+        }
+
+        // 不能折叠为立即数偏移的地址尝试寄存器偏移寻址：所有使用者必须是同宽度的访存
+        for (const auto* node : scheduled)
+        {
+            if (opOf(node) != DAG::ISD::ADD || selected_.count(node)) continue;
+            const auto* nodeUsers = users.lookup(node);
+            if (!nodeUsers || nodeUsers->empty()) continue;
+            if (crossBlockUses(node) != 0) continue;
+
+            int  size = 0;
+            bool ok   = true;
+            for (auto& [user, idx] : *nodeUsers)
+            {
+                auto opc = opOf(user);
+                if (!(opc == DAG::ISD::LOAD && idx == 1) && !(opc == DAG::ISD::STORE && idx == 2)) ok = false;
+                if (!ok) break;
+                int s = accessSize(user);
+                if (size != 0 && s != size) ok = false;
+                size = s;
+            }
+            if (!ok) continue;
+
+            const DAG::SDNode *base = nullptr, *index = nullptr, *scale = nullptr;
+            if (!matchIndexedAddress(node, size, base, index, scale)) continue;
+            indexedAddr_.insert(node);
+            selected_.insert(node);
+            if (scale && hasSingleUse(scale, users) && !selected_.count(scale))
+            {
+                fusedOperands_.insert(scale);
+                selected_.insert(scale);
+            }
+        }
+
+        // add/sub 吸收唯一使用的 mul/shl：乘以 2 的幂与常量左移成为移位寄存器操作数，其余乘法成为 madd/msub
+        auto tryFuse = [&](const DAG::SDNode* owner, const DAG::SDNode* op) {
+            if (!op || selected_.count(op) || !hasSingleUse(op, users)) return false;
+            if (opOf(op) != DAG::ISD::MUL && opOf(op) != DAG::ISD::SHL) return false;
+            if (isFloatType(typeOf(op)) || is64Type(typeOf(op)) != is64Type(typeOf(owner))) return false;
+            if (opOf(op) == DAG::ISD::SHL && fusedShiftAmount(op) < 0) return false;
+            fusedOperands_.insert(op);
+            selected_.insert(op);
+            return true;
+        };
+        for (const auto* node : scheduled)
+        {
+            auto opcode = opOf(node);
+            if ((opcode != DAG::ISD::ADD && opcode != DAG::ISD::SUB) || selected_.count(node)) continue;
+            if (isFloatType(typeOf(node)) || node->getNumOperands() != 2) continue;
+            const DAG::SDNode* lhs = node->getOperand(0).getNode();
+            const DAG::SDNode* rhs = node->getOperand(1).getNode();
+            if (!lhs || !rhs || isConstInt(rhs)) continue;
+            if (opcode == DAG::ISD::SUB)
+            {
+                if (!isConstValue(lhs, 0)) tryFuse(node, rhs);
+                continue;
+            }
+            if (!tryFuse(node, rhs)) tryFuse(node, lhs);
+        }
+    }
+
     Register DAGIsel::getOperandReg(const DAG::SDNode* node, BE::Block* m_block)
     {
         // ============================================================================
         // 操作数获取：统一的实例化入口
         // ============================================================================
         //
-        // 作用：为 DAG 节点返回或实例化对应的寄存器
-        //
-        // 为什么需要：
-        // - 指令选择时，需要将 DAG 节点（抽象）映射到寄存器（具体）
-        // - 统一处理已分配寄存器、IR 寄存器映射、按需实例化三种情况
+        // - 已分配寄存器的节点直接返回
+        // - 常量、地址节点在首次使用时才生成指令（常量为带立即数的 MoveInst，由栈降低展开为 movz/movk 或 fmov）
 
         if (!node) ERROR("Cannot get register for null node");
 
-        auto opcode = static_cast<DAG::ISD>(node->getOpcode());
+        auto opcode = opOf(node);
 
-        auto it = nodeToVReg_.find(node);
-        if (it != nodeToVReg_.end()) return it->second;
+        if (const Register* r = nodeToVReg_.lookup(node)) return *r;
 
         if (opcode == DAG::ISD::REG && node->hasIRRegId())
-            return getOrCreateVReg(node->getIRRegId(), node->getNumValues() > 0 ? node->getValueType(0) : BE::I64);
+            return getOrCreateVReg(node->getIRRegId(), typeOf(node));
 
         if (opcode == DAG::ISD::CONST_I32 || opcode == DAG::ISD::CONST_I64)
         {
-            DataType* dt = (node->getNumValues() > 0) ? node->getValueType(0) : BE::I32;
-            if (!dt) dt = (opcode == DAG::ISD::CONST_I32) ? BE::I32 : BE::I64;
-
-            Register destReg = getVReg(dt);
-            int64_t  imm     = node->hasImmI64() ? node->getImmI64() : 0;
-
-            if (imm == 0)
-            {
-                Register zeroReg  = (dt == BE::I32) ? PR::wzr : PR::xzr;
-                nodeToVReg_[node] = zeroReg;
-                return zeroReg;
-            }
+            DataType* dt      = (opcode == DAG::ISD::CONST_I32) ? BE::I32 : BE::I64;
+            Register  destReg = getVReg(dt);
+            int64_t   imm     = node->hasImmI64() ? node->getImmI64() : 0;
 
-            auto   segments    = decomposeImm64(static_cast<unsigned long long>(imm));
-            size_t numSegments = (dt == BE::I32) ? 2 : 4;
-
-            bool first = true;
-            for (size_t i = 0; i < numSegments; ++i)
-            {
-                if (segments[i] == 0 && !first) continue;
-                if (first)
-                {
-                    m_block->insts.push_back(
-                        createInstr2(Operator::MOVZ, new RegOperand(destReg), new ImmeOperand(segments[i])));
-                    first = false;
-                }
-                else
-                {
-                    m_block->insts.push_back(createInstr3(Operator::MOVK,
-                        new RegOperand(destReg),
-                        new ImmeOperand(segments[i]),
-                        new ImmeOperand(i * 16)));
-                }
-            }
+            m_block->insts.push_back(BE::createMove(new RegOperand(destReg), static_cast<int>(imm), LOC_STR));
 
             nodeToVReg_[node] = destReg;
             return destReg;
@@ -138,49 +371,72 @@ namespace BE::AArch64
 
         if (opcode == DAG::ISD::CONST_F32)
         {
-            DataType* dt = (node->getNumValues() > 0) ? node->getValueType(0) : BE::F32;
-            if (!dt) dt = BE::F32;
-            Register dstReg = getVReg(dt);
+            Register destReg = getVReg(BE::F32);
+            float    f_val   = node->hasImmF32() ? node->getImmF32() : 0.0f;
+            m_block->insts.push_back(BE::createMove(new RegOperand(destReg), f_val, LOC_STR));
 
-            float fval = node->hasImmF32() ? node->getImmF32() : 0.0f;
+            nodeToVReg_[node] = destReg;
+            return destReg;
+        }
 
-            if (fval == 0.0f)
-            {
-                m_block->insts.push_back(createInstr2(Operator::FMOV, new RegOperand(dstReg), new RegOperand(PR::wzr)));
-                nodeToVReg_[node] = dstReg;
-                return dstReg;
-            }
+        if (opcode == DAG::ISD::FRAME_INDEX || opcode == DAG::ISD::SYMBOL)
+        {
+            Register addr     = materializeAddress(node, m_block);
+            nodeToVReg_[node] = addr;
+            return addr;
+        }
 
-            int      bits  = FLOAT_TO_INT_BITS(fval);
-            Register wTmp  = getVReg(BE::I32);
-            auto     segs  = decomposeImm64(static_cast<unsigned long long>(static_cast<uint32_t>(bits)));
-            bool     first = true;
-            for (size_t i = 0; i < 2; ++i)
-            {
-                if (segs[i] == 0 && !first) continue;
-                if (first)
-                {
-                    m_block->insts.push_back(
-                        createInstr2(Operator::MOVZ, new RegOperand(wTmp), new ImmeOperand(segs[i])));
-                    first = false;
-                }
-                else
-                {
-                    m_block->insts.push_back(createInstr3(
-                        Operator::MOVK, new RegOperand(wTmp), new ImmeOperand(segs[i]), new ImmeOperand(i * 16)));
-                }
-            }
-            m_block->insts.push_back(createInstr2(Operator::FMOV, new RegOperand(dstReg), new RegOperand(wTmp)));
+        ERROR("Node not scheduled or cannot be materialized: %s", DAG::toString(opcode));
+        return Register();
+    }
 
-            nodeToVReg_[node] = dstReg;
-            return dstReg;
+    Register DAGIsel::getOperandReg(const DAG::SDNode* node, bool want64, BE::Block* m_block)
+    {
+        // 常量按所需宽度直接实例化，避免多一次扩展；与常量自身宽度不同的实例缓存在 widened_ 中
+        if (isConstInt(node) && (opOf(node) == DAG::ISD::CONST_I64) != want64)
+        {
+            if (const Register* r = widened_.lookup(node)) return *r;
+            Register destReg = getVReg(want64 ? BE::I64 : BE::I32);
+            m_block->insts.push_back(
+                BE::createMove(new RegOperand(destReg), static_cast<int>(node->getImmI64()), LOC_STR));
+            widened_[node] = destReg;
+            return destReg;
         }
 
-        if (opcode == DAG::ISD::FRAME_INDEX || opcode == DAG::ISD::SYMBOL) return materializeAddress(node, m_block);
+        Register reg = getOperandReg(node, m_block);
+        if (isFloatReg(reg) || is64BitReg(reg) == want64) return reg;
+        if (!want64) return fitWidth(reg, false, m_block);
 
-        ERROR("Node not scheduled or cannot be materialized: %s",
-            DAG::toString(static_cast<DAG::ISD>(node->getOpcode())));
-        return Register();
+        if (const Register* w = widened_.lookup(node)) return *w;
+        Register wide  = fitWidth(reg, true, m_block);
+        widened_[node] = wide;
+        return wide;
+    }
+
+    Register DAGIsel::fitWidth(Register reg, bool want64, BE::Block* m_block)
+    {
+        if (isFloatReg(reg) || is64BitReg(reg) == want64) return reg;
+        if (want64)
+        {
+            // 32 位整数参与 64 位运算（地址计算）时按有符号扩展
+            Register wide = getVReg(BE::I64);
+            m_block->insts.push_back(createR2Inst(Operator::SXTW, wide, reg));
+            return wide;
+        }
+        // 截断：mov wD, wS 只取低 32 位
+        Register narrow = getVReg(BE::I32);
+        m_block->insts.push_back(createR2Inst(Operator::MOV, narrow, reg));
+        return narrow;
+    }
+
+    void DAGIsel::emitCopy(Register dst, Register src, BE::Block* m_block)
+    {
+        if (!isFloatReg(dst) && !isFloatReg(src) && is64BitReg(dst) != is64BitReg(src))
+        {
+            m_block->insts.push_back(createR2Inst(is64BitReg(dst) ? Operator::SXTW : Operator::MOV, dst, src));
+            return;
+        }
+        m_block->insts.push_back(BE::createMove(new RegOperand(dst), new RegOperand(src), LOC_STR));
     }
 
     Register DAGIsel::materializeAddress(const DAG::SDNode* node, BE::Block* m_block)
@@ -189,27 +445,20 @@ namespace BE::AArch64
         // 地址实例化：使用者负责实例化
         // ============================================================================
         //
-        // 作用：将地址节点（FRAME_INDEX/SYMBOL）实例化为寄存器
-        //
-        // 为什么需要：
-        // - 地址节点本身不生成独立的指令，而是由使用者（LOAD/STORE/ADD）决定如何实例化
-        // - FRAME_INDEX 需要生成抽象的 FrameIndexOperand，由后续 Pass 替换为实际偏移
-        // - SYMBOL 需要生成 LA 伪指令加载全局变量地址
+        // - FRAME_INDEX 生成 add xD, sp, #fi，偏移由帧降低根据 FrameIndexOperand 填入
+        // - SYMBOL 生成 LA 伪指令（adrp + add :lo12:）
 
         if (!node) ERROR("Cannot materialize null address");
 
-        auto opcode = static_cast<DAG::ISD>(node->getOpcode());
+        auto opcode = opOf(node);
 
-        if (opcode == DAG::ISD::FRAME_INDEX && node->hasIRRegId())
+        if (opcode == DAG::ISD::FRAME_INDEX)
         {
-            size_t   ir_reg_id = node->getIRRegId();
-            Register addrReg   = getVReg(BE::I64);
-
-            Instr* addr_inst     = createInstr2(Operator::ADD, new RegOperand(addrReg), new RegOperand(PR::sp));
-            addr_inst->fiop      = new FrameIndexOperand(ir_reg_id);
+            Register addrReg     = getVReg(BE::I64);
+            Instr*   addr_inst   = createRInst(Operator::ADD, addrReg, PR::sp, 0);
+            addr_inst->fiop      = new FrameIndexOperand(node->getFrameIndex());
             addr_inst->use_fiops = true;
             m_block->insts.push_back(addr_inst);
-
             return addrReg;
         }
 
@@ -221,8 +470,7 @@ namespace BE::AArch64
             return addrReg;
         }
 
-        auto it = nodeToVReg_.find(node);
-        if (it != nodeToVReg_.end()) return it->second;
+        if (const Register* r = nodeToVReg_.lookup(node)) return *r;
 
         if (opcode == DAG::ISD::REG && node->hasIRRegId())
             return getOrCreateVReg(node->getIRRegId(), node->getNumValues() > 0 ? node->getValueType(0) : BE::I64);
@@ -230,12 +478,7 @@ namespace BE::AArch64
         ERROR("Cannot materialize address for opcode: %s", DAG::toString(opcode));
     }
 
-    int DAGIsel::dataTypeSize(BE::DataType* dt)
-    {
-        if (dt == BE::I32 || dt == BE::F32) return 4;
-        if (dt == BE::I64 || dt == BE::F64 || dt == BE::PTR) return 8;
-        return 4;
-    }
+    int DAGIsel::dataTypeSize(BE::DataType* dt) { return is64Type(dt) ? 8 : 4; }
 
     Register DAGIsel::getOrCreateVReg(size_t ir_reg_id, BE::DataType* dt)
     {
@@ -249,57 +492,125 @@ namespace BE::AArch64
 
     void DAGIsel::importGlobals()
     {
-        // ============================================================================
-        // TODO: 导入全局变量
-        // ============================================================================
-        //
-        // 作用：
-        // 将 IR 模块中的全局变量转换为后端的 GlobalVariable 对象。
-        //
-        // 为什么需要：
-        // - 全局变量需在生成的汇编中声明和初始化
-        // - 需转换类型（ME::DataType → BE::DataType）
-        // - 需处理初始化值（标量 vs 数组）
-        //
-        // 关键点：
-        // - 遍历 ir_module_->globalVars
-        // - 创建 BE::GlobalVariable 对象
-        // - 处理数组维度（arrayDims）与初始值（initList/init）
-        // - 浮点数需位转换（FLOAT_TO_INT_BITS）
+        for (auto* glb : ir_module_->globalVars)
+        {
+            BE::DataType* beType = BE::I32;
+            if (glb->dt == ME::DataType::F32)
+                beType = BE::F32;
+            else if (glb->dt == ME::DataType::I64 || glb->dt == ME::DataType::PTR)
+                beType = BE::I64;
+
+            auto* gv = new BE::GlobalVariable(beType, glb->name);
+            gv->dims = glb->initList.arrayDims;
 
-        TODO("导入全局变量到后端模块");
+            if (glb->init)
+            {
+                if (auto* immI32 = dynamic_cast<ME::ImmeI32Operand*>(glb->init))
+                    gv->initVals.push_back(immI32->value);
+                else if (auto* immF32 = dynamic_cast<ME::ImmeF32Operand*>(glb->init))
+                    gv->initVals.push_back(FLOAT_TO_INT_BITS(immF32->value));
+            }
+            else if (!glb->initList.initList.empty())
+            {
+                for (const auto& val : glb->initList.initList)
+                {
+                    if (val.type == FE::AST::floatType)
+                        gv->initVals.push_back(FLOAT_TO_INT_BITS(val.floatValue));
+                    else
+                        gv->initVals.push_back(val.intValue);
+                }
+            }
+
+            m_backend_module->globals.push_back(gv);
+        }
     }
 
-    void DAGIsel::collectAllocas(ME::Function* ir_func)
+    int DAGIsel::computeCallFrameBytes(ME::Function* ir_func)
     {
-        // ============================================================================
-        // TODO: 收集函数中的所有 alloca 并注册到 frameInfo
-        // ============================================================================
-        //
-        // 作用：
-        // 遍历函数的所有 IR 指令，找到所有 ALLOCA 指令，计算其需要的栈空间大小，
-        // 并在函数级别的栈帧管理中为其分配槽位。
+        // AAPCS64：整数与浮点参数各自使用 8 个寄存器，超出部分按出现顺序各占 8 字节栈槽
+        int maxCallBytes = 0;
+        for (auto& [blockId, block] : ir_func->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                auto* call = dynamic_cast<ME::CallInst*>(inst);
+                if (!call) continue;
+                int intArgs = 0, floatArgs = 0;
+                for (auto& [type, op] : call->args) (type == ME::DataType::F32 ? floatArgs : intArgs)++;
+                int stackArgs = std::max(0, intArgs - A64_GPR_ARG_COUNT) + std::max(0, floatArgs - A64_FPR_ARG_COUNT);
+                maxCallBytes  = std::max(maxCallBytes, stackArgs * 8);
+            }
+        }
+        return maxCallBytes;
+    }
 
-        TODO("收集 alloca 并注册到 frameInfo");
+    void DAGIsel::collectAllocas(ME::Function* ir_func)
+    {
+        for (auto& [blockId, block] : ir_func->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                auto* alloca = dynamic_cast<ME::AllocaInst*>(inst);
+                if (!alloca) continue;
+                auto* resReg = dynamic_cast<ME::RegOperand*>(alloca->res);
+                if (!resReg) continue;
+
+                size_t irRegId   = resReg->regNum;
+                int    elemSize  = (alloca->dt == ME::DataType::F32 || alloca->dt == ME::DataType::I32) ? 4 : 8;
+                int    totalSize = elemSize;
+                for (int dim : alloca->dims) totalSize *= dim;
+
+                ctx_.mfunc->frameInfo.createLocalObject(irRegId, totalSize, 16);
+                ctx_.allocaFI[irRegId] = static_cast<int>(irRegId);
+            }
+        }
     }
 
     void DAGIsel::setupParameters(ME::Function* ir_func)
     {
-        // ============================================================================
-        // TODO: 为函数参数创建虚拟寄存器
-        // ============================================================================
-        //
-        // 作用：
-        // 遍历 IR 函数定义中的所有参数，为每个参数分配虚拟寄存器，并记录参数的虚拟寄存器映射关系
+        // 前 8 个整数参数在 x0-x7，前 8 个浮点参数在 s0-s7（两类各自计数），其余参数依次位于调用者栈顶的 8 字节槽
+        BE::Block* entry = nullptr;
+        if (!ctx_.mfunc->blocks.empty()) entry = ctx_.mfunc->blocks.begin()->second;
+        if (!entry) return;
+
+        int intIdx = 0, floatIdx = 0, stackIdx = 0;
+        for (const auto& [argType, argOp] : ir_func->funcDef->argRegs)
+        {
+            auto* regOp = dynamic_cast<ME::RegOperand*>(argOp);
+            if (!regOp) continue;
+
+            BE::DataType* beType = BE::I64;
+            if (argType == ME::DataType::F32)
+                beType = BE::F32;
+            else if (argType == ME::DataType::I32)
+                beType = BE::I32;
 
-        TODO("为函数参数创建虚拟寄存器并建立映射");
+            Register vreg = getOrCreateVReg(regOp->regNum, beType);
+            ctx_.mfunc->params.push_back(vreg);
+
+            bool isFloat = beType == BE::F32;
+            int& regIdx  = isFloat ? floatIdx : intIdx;
+            if (regIdx < (isFloat ? A64_FPR_ARG_COUNT : A64_GPR_ARG_COUNT))
+            {
+                Register srcReg(regIdx++, beType, false);
+                entry->insts.push_back(BE::createMove(new RegOperand(vreg), new RegOperand(srcReg), "param_reg"));
+            }
+            else
+            {
+                auto* ld    = createMemInst(Operator::LDR, vreg, new MemOperand(PR::sp, stackIdx++ * 8));
+                ld->comment = "param_stack";
+                entry->insts.push_back(ld);
+            }
+        }
+
+        if (stackIdx > 0) ctx_.mfunc->hasStackParam = true;
     }
 
     bool DAGIsel::selectAddress(const DAG::SDNode* addrNode, const DAG::SDNode*& baseNode, int64_t& offset)
     {
         if (!addrNode) return false;
 
-        auto opcode = static_cast<DAG::ISD>(addrNode->getOpcode());
+        auto opcode = opOf(addrNode);
 
         if (opcode == DAG::ISD::FRAME_INDEX || opcode == DAG::ISD::SYMBOL)
         {
@@ -308,45 +619,116 @@ namespace BE::AArch64
             return true;
         }
 
-        if (opcode == DAG::ISD::ADD)
+        if (opcode != DAG::ISD::ADD) return false;
+
+        const DAG::SDNode* lhs = addrNode->getOperand(0).getNode();
+        const DAG::SDNode* rhs = addrNode->getOperand(1).getNode();
+
+        const DAG::SDNode* innerBase;
+        int64_t            innerOffset = 0;
+        if (isConstInt(rhs) && selectAddress(lhs, innerBase, innerOffset))
+        {
+            baseNode = innerBase;
+            offset   = innerOffset + rhs->getImmI64();
+            return true;
+        }
+        if (isConstInt(lhs) && selectAddress(rhs, innerBase, innerOffset))
+        {
+            baseNode = innerBase;
+            offset   = innerOffset + lhs->getImmI64();
+            return true;
+        }
+
+        // 任意寄存器值 + 常量：寄存器值作为基址
+        if (isConstInt(rhs) && !isConstInt(lhs))
         {
-            const DAG::SDNode* lhs = addrNode->getOperand(0).getNode();
-            const DAG::SDNode* rhs = addrNode->getOperand(1).getNode();
+            baseNode = lhs;
+            offset   = rhs->getImmI64();
+            return true;
+        }
+        if (isConstInt(lhs) && !isConstInt(rhs))
+        {
+            baseNode = rhs;
+            offset   = lhs->getImmI64();
+            return true;
+        }
+        return false;
+    }
+
+    bool DAGIsel::matchIndexedAddress(const DAG::SDNode* addrNode, int size, const DAG::SDNode*& baseNode,
+        const DAG::SDNode*& indexNode, const DAG::SDNode*& scaleNode)
+    {
+        // [base, index{, sxtw|lsl #k}]：地址为 base + index * C，C 只能是 1 或访问宽度
+        if (opOf(addrNode) != DAG::ISD::ADD || addrNode->getNumOperands() != 2) return false;
+        const DAG::SDNode* ops[2] = {addrNode->getOperand(0).getNode(), addrNode->getOperand(1).getNode()};
+        if (!ops[0] || !ops[1] || isConstInt(ops[0]) || isConstInt(ops[1])) return false;
 
-            const DAG::SDNode* lhsBase;
-            int64_t            lhsOffset = 0;
-            if (selectAddress(lhs, lhsBase, lhsOffset))
+        for (int i = 0; i < 2; ++i)
+        {
+            const DAG::SDNode* o = ops[1 - i];
+            if (opOf(o) != DAG::ISD::MUL && opOf(o) != DAG::ISD::SHL) continue;
+            const DAG::SDNode* c = o->getOperand(1).getNode();
+            if (!c || !isConstInt(c)) continue;
+            int64_t factor = opOf(o) == DAG::ISD::MUL ? c->getImmI64() : (c->getImmI64() >= 0 && c->getImmI64() < 8
+                                                                                  ? int64_t(1) << c->getImmI64()
+                                                                                  : 0);
+            if (factor != size && factor != 1) continue;
+            baseNode  = ops[i];
+            indexNode = o->getOperand(0).getNode();
+            scaleNode = o;
+            return true;
+        }
+
+        // 无缩放：较窄（32 位）的一侧作为下标
+        bool swap = is64Type(typeOf(ops[0])) == false && is64Type(typeOf(ops[1]));
+        baseNode  = ops[swap ? 1 : 0];
+        indexNode = ops[swap ? 0 : 1];
+        scaleNode = nullptr;
+        return true;
+    }
+
+    MemOperand* DAGIsel::selectMemOperand(const DAG::SDNode* addrNode, int size, int& frameIndex, BE::Block* m_block)
+    {
+        frameIndex = -1;
+
+        const DAG::SDNode* baseNode = nullptr;
+        int64_t            offset   = 0;
+        if (selectAddress(addrNode, baseNode, offset))
+        {
+            // 栈槽：以 sp 为基址，最终偏移与合法化交给帧降低
+            if (opOf(baseNode) == DAG::ISD::FRAME_INDEX)
             {
-                if ((static_cast<DAG::ISD>(rhs->getOpcode()) == DAG::ISD::CONST_I32 ||
-                        static_cast<DAG::ISD>(rhs->getOpcode()) == DAG::ISD::CONST_I64) &&
-                    rhs->hasImmI64())
-                {
-                    baseNode = lhsBase;
-                    offset   = lhsOffset + rhs->getImmI64();
-                    return true;
-                }
-                return false;
+                frameIndex = baseNode->getFrameIndex();
+                return new MemOperand(PR::sp, static_cast<int>(offset));
             }
 
-            const DAG::SDNode* rhsBase;
-            int64_t            rhsOffset = 0;
-            if (selectAddress(rhs, rhsBase, rhsOffset))
+            Register baseReg = getOperandReg(baseNode, true, m_block);
+            if (fitsMemOffset(offset, size)) return new MemOperand(baseReg, static_cast<int>(offset));
+
+            // 偏移超出编码范围：装入寄存器后使用寄存器偏移寻址
+            Register offReg = getVReg(BE::I64);
+            m_block->insts.push_back(BE::createMove(new RegOperand(offReg), static_cast<int>(offset), LOC_STR));
+            return new MemOperand(baseReg, offReg, Extend::LSL, 0);
+        }
+
+        const DAG::SDNode *indexNode = nullptr, *scaleNode = nullptr;
+        if (indexedAddr_.count(addrNode) && matchIndexedAddress(addrNode, size, baseNode, indexNode, scaleNode))
+        {
+            int shift = 0;
+            if (scaleNode && fusedOperands_.count(scaleNode))
             {
-                if ((static_cast<DAG::ISD>(lhs->getOpcode()) == DAG::ISD::CONST_I32 ||
-                        static_cast<DAG::ISD>(lhs->getOpcode()) == DAG::ISD::CONST_I64) &&
-                    lhs->hasImmI64())
-                {
-                    baseNode = rhsBase;
-                    offset   = rhsOffset + lhs->getImmI64();
-                    return true;
-                }
-                return false;
+                int64_t c = scaleNode->getOperand(1).getNode()->getImmI64();
+                shift     = opOf(scaleNode) == DAG::ISD::MUL ? log2Exact(c) : static_cast<int>(c);
             }
+            else if (scaleNode)
+                indexNode = scaleNode;  // 乘法另有使用者，已单独生成，直接作为下标
 
-            return false;
+            Register baseReg  = getOperandReg(baseNode, true, m_block);
+            Register indexReg = getOperandReg(indexNode, m_block);
+            return new MemOperand(baseReg, indexReg, is64BitReg(indexReg) ? Extend::LSL : Extend::SXTW, shift);
         }
 
-        return false;
+        return new MemOperand(getOperandReg(addrNode, true, m_block), 0);
     }
 
     void DAGIsel::selectCopy(const DAG::SDNode* node, BE::Block* m_block)
@@ -356,233 +738,641 @@ namespace BE::AArch64
         const DAG::SDNode* src = node->getOperand(0).getNode();
         if (!src) return;
 
-        Register dst    = getOperandReg(node, m_block);
-        Register srcReg = getOperandReg(src, m_block);
+        Register dst = getOperandReg(node, m_block);
 
-        m_block->insts.push_back(BE::AArch64::createMove(new RegOperand(dst), new RegOperand(srcReg), LOC_STR));
-    }
+        if (isConstInt(src))
+        {
+            m_block->insts.push_back(
+                BE::createMove(new RegOperand(dst), static_cast<int>(src->getImmI64()), LOC_STR));
+            return;
+        }
+        if (opOf(src) == DAG::ISD::CONST_F32 && src->hasImmF32())
+        {
+            m_block->insts.push_back(BE::createMove(new RegOperand(dst), src->getImmF32(), LOC_STR));
+            return;
+        }
 
-    void DAGIsel::selectConst(const DAG::SDNode* node, BE::Block* m_block) { TODO("选择常量节点"); }
+        emitCopy(dst, getOperandReg(src, m_block), m_block);
+    }
 
     void DAGIsel::selectPhi(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择 PHI 节点
-        // ============================================================================
-        //
-        // 作用：
-        // 为 PHI 节点生成 MIR 的 PhiInst，记录所有前驱块与对应的值。
-        //
-        // 为什么需要：
-        // - PHI 节点在 SSA 中合并来自不同前驱的值
-        // - 需要保留前驱块信息，供后续 PHI 消解 Pass 使用
-        //
-        // 关键点：
-        // - PHI 操作数成对出现：[label0, val0, label1, val1, ...]
-        // - 常量可直接作为立即数，无需实例化为寄存器
+        // PHI 节点的操作数成对出现：[value0, label0, value1, label1, ...]
+        // 常量保留为立即数，由 PHI 消解在前驱块中实例化（getOperandReg 会把指令插入当前块）
+        unsigned numOps = node->getNumOperands();
+        if (numOps < 2 || numOps % 2 != 0) return;
+
+        Register dst = nodeToVReg_.at(node);
+        auto*    phi = new PhiInst(dst);
+
+        for (unsigned i = 0; i < numOps; i += 2)
+        {
+            const DAG::SDNode* valNode   = node->getOperand(i).getNode();
+            const DAG::SDNode* labelNode = node->getOperand(i + 1).getNode();
+            if (!valNode || !labelNode) continue;
+
+            uint32_t predLabel = labelNode->hasImmI64() ? static_cast<uint32_t>(labelNode->getImmI64()) : 0;
+
+            Operand* srcOp = nullptr;
+            auto     valOp = opOf(valNode);
+            if (valOp == DAG::ISD::CONST_I32 || valOp == DAG::ISD::CONST_I64)
+                srcOp = new I32Operand(valNode->hasImmI64() ? static_cast<int>(valNode->getImmI64()) : 0);
+            else if (valOp == DAG::ISD::CONST_F32)
+                srcOp = new F32Operand(valNode->hasImmF32() ? valNode->getImmF32() : 0.0f);
+            else if (valNode->hasIRRegId())
+                srcOp = new RegOperand(getOrCreateVReg(valNode->getIRRegId(), typeOf(valNode)));
+            else if (const Register* r = nodeToVReg_.lookup(valNode))
+                srcOp = new RegOperand(*r);
+            else
+                continue;
 
-        TODO("选择 PHI 节点：提取前驱与值，生成 PhiInst");
+            phi->incomingVals[predLabel] = srcOp;
+        }
+
+        m_block->insts.push_back(phi);
     }
 
     void DAGIsel::selectBinary(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // ============================================================================
-        // 选择二元运算节点（示例实现，保留）
-        // ============================================================================
-        //
-        // AArch64 特殊处理：
-        // - 寄存器位宽匹配：x/w 寄存器别名需要类型转换
-        // - MOD 运算：展开为 a - (a / b) * b
-
         if (node->getNumOperands() < 2) return;
 
-        auto opcode = static_cast<DAG::ISD>(node->getOpcode());
-
-        Register dst = nodeToVReg_.at(node);
+        auto     opcode = opOf(node);
+        Register dst    = nodeToVReg_.at(node);
 
         const DAG::SDNode* lhs = node->getOperand(0).getNode();
         const DAG::SDNode* rhs = node->getOperand(1).getNode();
 
-        Register lhsReg = getOperandReg(lhs, m_block);
-        Register rhsReg = getOperandReg(rhs, m_block);
+        if (isFloatReg(dst))
+        {
+            Operator op;
+            switch (opcode)
+            {
+                case DAG::ISD::ADD:
+                case DAG::ISD::FADD: op = Operator::FADD; break;
+                case DAG::ISD::SUB:
+                case DAG::ISD::FSUB: op = Operator::FSUB; break;
+                case DAG::ISD::MUL:
+                case DAG::ISD::FMUL: op = Operator::FMUL; break;
+                case DAG::ISD::DIV:
+                case DAG::ISD::FDIV: op = Operator::FDIV; break;
+                default: ERROR("Unsupported float binary operator: %s", DAG::toString(opcode)); return;
+            }
+            m_block->insts.push_back(createRInst(op, dst, getOperandReg(lhs, m_block), getOperandReg(rhs, m_block)));
+            return;
+        }
+
+        bool w64 = is64BitReg(dst);
 
-        Operator op;
-        bool     isFloat = (dst.dt == BE::F32 || dst.dt == BE::F64);
+        // 可交换运算把常量放到右侧
+        bool commutative = opcode == DAG::ISD::ADD || opcode == DAG::ISD::MUL || opcode == DAG::ISD::AND ||
+                           opcode == DAG::ISD::OR || opcode == DAG::ISD::XOR;
+        if (commutative && isConstInt(lhs) && !isConstInt(rhs)) std::swap(lhs, rhs);
 
         switch (opcode)
         {
-            case DAG::ISD::ADD: op = isFloat ? Operator::FADD : Operator::ADD; break;
-            case DAG::ISD::SUB: op = isFloat ? Operator::FSUB : Operator::SUB; break;
-            case DAG::ISD::MUL: op = isFloat ? Operator::FMUL : Operator::MUL; break;
-            case DAG::ISD::DIV: op = isFloat ? Operator::FDIV : Operator::SDIV; break;
-            case DAG::ISD::FADD: op = Operator::FADD; break;
-            case DAG::ISD::FSUB: op = Operator::FSUB; break;
-            case DAG::ISD::FMUL: op = Operator::FMUL; break;
-            case DAG::ISD::FDIV: op = Operator::FDIV; break;
-            case DAG::ISD::AND: op = Operator::AND; break;
-            case DAG::ISD::OR: op = Operator::ORR; break;
-            case DAG::ISD::XOR: op = Operator::EOR; break;
-            case DAG::ISD::SHL: op = Operator::LSL; break;
-            case DAG::ISD::ASHR: op = Operator::ASR; break;
-            case DAG::ISD::LSHR: op = Operator::LSR; break;
-            case DAG::ISD::MOD: ERROR("MOD operator is not supported for AArch64. How to handle this?"); return;
-            default: ERROR("Unsupported binary operator: %d", node->getOpcode()); return;
+            case DAG::ISD::ADD:
+            case DAG::ISD::SUB: selectAddSub(node, dst, m_block); return;
+            case DAG::ISD::DIV:
+            case DAG::ISD::MOD: selectDivMod(node, dst, m_block); return;
+            case DAG::ISD::MUL:
+            {
+                Register l = getOperandReg(lhs, w64, m_block);
+                int      k = isConstInt(rhs) ? log2Exact(rhs->getImmI64()) : -1;
+                if (k > 0 && k < (w64 ? 64 : 32))
+                    m_block->insts.push_back(createRInst(Operator::LSL, dst, l, k));
+                else
+                    m_block->insts.push_back(createRInst(Operator::MUL, dst, l, getOperandReg(rhs, w64, m_block)));
+                return;
+            }
+            case DAG::ISD::AND:
+            case DAG::ISD::OR:
+            case DAG::ISD::XOR:
+            {
+                Operator op = opcode == DAG::ISD::AND ? Operator::AND
+                              : opcode == DAG::ISD::OR ? Operator::ORR
+                                                       : Operator::EOR;
+                Register l  = getOperandReg(lhs, w64, m_block);
+                if (isConstInt(rhs) && fitsInt(rhs->getImmI64()))
+                {
+                    int64_t  c    = rhs->getImmI64();
+                    uint64_t bits = w64 ? static_cast<uint64_t>(c) : static_cast<uint32_t>(c);
+                    if (isLogicalImm(bits, w64))
+                    {
+                        m_block->insts.push_back(createRInst(op, dst, l, static_cast<int>(c)));
+                        return;
+                    }
+                }
+                m_block->insts.push_back(createRInst(op, dst, l, getOperandReg(rhs, w64, m_block)));
+                return;
+            }
+            case DAG::ISD::SHL:
+            case DAG::ISD::ASHR:
+            case DAG::ISD::LSHR:
+            {
+                Operator op = opcode == DAG::ISD::SHL ? Operator::LSL
+                              : opcode == DAG::ISD::ASHR ? Operator::ASR
+                                                         : Operator::LSR;
+                Register l  = getOperandReg(lhs, w64, m_block);
+                if (isConstInt(rhs))
+                    m_block->insts.push_back(
+                        createRInst(op, dst, l, static_cast<int>(rhs->getImmI64() & (w64 ? 63 : 31))));
+                else
+                    m_block->insts.push_back(createRInst(op, dst, l, getOperandReg(rhs, w64, m_block)));
+                return;
+            }
+            default: ERROR("Unsupported binary operator: %s", DAG::toString(opcode));
         }
-
-        m_block->insts.push_back(createInstr3(op, new RegOperand(dst), new RegOperand(lhsReg), new RegOperand(rhsReg)));
     }
 
-    void DAGIsel::selectUnary(const DAG::SDNode* node, BE::Block* m_block)
+    void DAGIsel::selectAddSub(const DAG::SDNode* node, Register dst, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择一元运算节点，但也许不用做任何事情
-        // ============================================================================
+        bool               isSub = opOf(node) == DAG::ISD::SUB;
+        bool               w64   = is64BitReg(dst);
+        const DAG::SDNode* lhs   = node->getOperand(0).getNode();
+        const DAG::SDNode* rhs   = node->getOperand(1).getNode();
+        if (!isSub && isConstInt(lhs) && !isConstInt(rhs)) std::swap(lhs, rhs);
+
+        // 12 位立即数：按符号在 add / sub 之间切换
+        if (isConstInt(rhs))
+        {
+            int64_t c = isSub ? -rhs->getImmI64() : rhs->getImmI64();
+            if (fitsArithImm(c))
+            {
+                Register l = getOperandReg(lhs, w64, m_block);
+                m_block->insts.push_back(createRInst(c >= 0 ? Operator::ADD : Operator::SUB, dst, l,
+                    static_cast<int>(c >= 0 ? c : -c)));
+                return;
+            }
+        }
 
-        TODO("选择一元运算节点");
-    }
+        // 0 - x => neg
+        if (isSub && isConstValue(lhs, 0))
+        {
+            m_block->insts.push_back(createRInst(Operator::SUB, dst, zeroReg(w64), getOperandReg(rhs, w64, m_block)));
+            return;
+        }
 
-    void DAGIsel::selectLoad(const DAG::SDNode* node, BE::Block* m_block)
-    {
-        // ============================================================================
-        // 选择 LOAD 节点, 作为示例实现，仅供参考
-        // ============================================================================
-        //
-        // 作用：
-        // 为 LOAD 节点生成目标相关的访存指令（LDR）。
-        //
-        // 为什么需要地址选择：
-        // - 地址可能是简单的 [base + offset]，也可能是复杂表达式
-        // - 声明式地址选择（selectAddress）可将常见模式折叠到访存指令的立即数字段
-        // - 若地址过于复杂，需先完整计算到寄存器
+        const DAG::SDNode* other = lhs;
+        const DAG::SDNode* fused = nullptr;
+        if (fusedOperands_.count(rhs))
+            fused = rhs;
+        else if (!isSub && fusedOperands_.count(lhs))
+        {
+            fused = lhs;
+            other = rhs;
+        }
 
-        if (node->getNumOperands() < 2) return;
+        if (fused)
+        {
+            Register           o = getOperandReg(other, w64, m_block);
+            const DAG::SDNode* x = fused->getOperand(0).getNode();
+            int                k = fusedShiftAmount(fused);
+            if (k >= 0)
+            {
+                // x << k 作为第二源操作数：32 位下标参与 64 位运算时用 sxtw #k（k <= 4）
+                Register xr  = getOperandReg(x, m_block);
+                Extend   ext = Extend::LSL;
+                if (w64 && !is64BitReg(xr) && k <= 4)
+                    ext = Extend::SXTW;
+                else
+                    xr = getOperandReg(x, w64, m_block);
+                m_block->insts.push_back(createInstr3(isSub ? Operator::SUB : Operator::ADD,
+                    new RegOperand(dst),
+                    new RegOperand(o),
+                    new ShiftedRegOperand(xr, ext, k)));
+                return;
+            }
 
-        Register           dst  = nodeToVReg_.at(node);
-        const DAG::SDNode* addr = node->getOperand(1).getNode();
+            Register xr = getOperandReg(x, w64, m_block);
+            Register yr = getOperandReg(fused->getOperand(1).getNode(), w64, m_block);
+            m_block->insts.push_back(createR3Inst(isSub ? Operator::MSUB : Operator::MADD, dst, xr, yr, o));
+            return;
+        }
 
-        const DAG::SDNode* baseNode;
-        int64_t            offset = 0;
+        m_block->insts.push_back(createRInst(isSub ? Operator::SUB : Operator::ADD,
+            dst,
+            getOperandReg(lhs, w64, m_block),
+            getOperandReg(rhs, w64, m_block)));
+    }
 
-        if (selectAddress(addr, baseNode, offset))
+    void DAGIsel::selectDivMod(const DAG::SDNode* node, Register dst, BE::Block* m_block)
+    {
+        bool               isMod = opOf(node) == DAG::ISD::MOD;
+        bool               w64   = is64BitReg(dst);
+        BE::DataType*      ty    = w64 ? BE::I64 : BE::I32;
+        const DAG::SDNode* lhs   = node->getOperand(0).getNode();
+        const DAG::SDNode* rhs   = node->getOperand(1).getNode();
+        Register           l     = getOperandReg(lhs, w64, m_block);
+
+        // 除以 2^k：负数先加 2^k-1 再算术右移（向零取整）；取模为 x - (商 << k)
+        // 偏置由符号位得到：k == 1 时为 x lsr #(w-1)，否则为 (x asr #(w-1)) lsr #(w-k)，免去 cmp + csel
+        int k = isConstInt(rhs) ? log2Exact(rhs->getImmI64()) : -1;
+        if (k >= 1 && k <= 30)
         {
-            Register baseReg;
-
-            if (static_cast<DAG::ISD>(baseNode->getOpcode()) == DAG::ISD::FRAME_INDEX)
+            int      width = w64 ? 64 : 32;
+            Register sign  = l;
+            if (k > 1)
             {
-                int fi              = baseNode->getFrameIndex();
-                baseReg             = getVReg(BE::I64);
-                Instr* addrInst     = createInstr2(Operator::ADD, new RegOperand(baseReg), new RegOperand(PR::sp));
-                addrInst->fiop      = new FrameIndexOperand(fi);
-                addrInst->use_fiops = true;
-                m_block->insts.push_back(addrInst);
+                sign = getVReg(ty);
+                m_block->insts.push_back(createRInst(Operator::ASR, sign, l, width - 1));
             }
-            else if (static_cast<DAG::ISD>(baseNode->getOpcode()) == DAG::ISD::SYMBOL && baseNode->hasSymbol())
+            Register sel = getVReg(ty);
+            m_block->insts.push_back(createInstr3(Operator::ADD,
+                new RegOperand(sel),
+                new RegOperand(l),
+                new ShiftedRegOperand(sign, Extend::LSR, width - k)));
+
+            if (!isMod)
             {
-                std::string symbol = baseNode->getSymbol();
-                baseReg            = getVReg(BE::I64);
-                m_block->insts.push_back(
-                    createInstr2(Operator::LA, new RegOperand(baseReg), new SymbolOperand(symbol)));
+                m_block->insts.push_back(createRInst(Operator::ASR, dst, sel, k));
+                return;
             }
-            else { baseReg = getOperandReg(baseNode, m_block); }
+            Register rounded = getVReg(ty);
+            m_block->insts.push_back(createRInst(Operator::AND, rounded, sel, -(1 << k)));
+            m_block->insts.push_back(createRInst(Operator::SUB, dst, l, rounded));
+            return;
+        }
 
-            m_block->insts.push_back(
-                createInstr2(Operator::LDR, new RegOperand(dst), new MemOperand(baseReg, static_cast<int>(offset))));
+        Register r = getOperandReg(rhs, w64, m_block);
+        if (!isMod)
+        {
+            m_block->insts.push_back(createRInst(Operator::SDIV, dst, l, r));
+            return;
         }
-        else
+        // a % b = a - (a / b) * b
+        Register q = getVReg(ty);
+        m_block->insts.push_back(createRInst(Operator::SDIV, q, l, r));
+        m_block->insts.push_back(createR3Inst(Operator::MSUB, dst, q, r, l));
+    }
+
+    void DAGIsel::selectLoad(const DAG::SDNode* node, BE::Block* m_block)
+    {
+        // LOAD 操作数：[Chain, Address]
+        if (node->getNumOperands() < 2) return;
+
+        Register           dst    = nodeToVReg_.at(node);
+        DataType*          loadTy = typeOf(node);  // 访存宽度以 DAG 节点的类型为准
+        const DAG::SDNode* addr   = node->getOperand(1).getNode();
+
+        int         fi  = -1;
+        MemOperand* mem = selectMemOperand(addr, dataTypeSize(loadTy), fi, m_block);
+
+        // 虚拟寄存器宽度与访存宽度不一致时先装入临时寄存器
+        Register target   = dst;
+        bool     mismatch = !isFloatType(loadTy) && is64Type(loadTy) != is64BitReg(dst);
+        if (mismatch) target = getVReg(is64Type(loadTy) ? BE::I64 : BE::I32);
+
+        Instr* ld = createMemInst(Operator::LDR, target, mem);
+        if (fi >= 0)
         {
-            Register addrReg = getOperandReg(addr, m_block);
-            m_block->insts.push_back(createInstr2(Operator::LDR, new RegOperand(dst), new MemOperand(addrReg, 0)));
+            ld->fiop      = new FrameIndexOperand(fi);
+            ld->use_fiops = true;
         }
+        m_block->insts.push_back(ld);
+        if (mismatch) emitCopy(dst, target, m_block);
     }
 
     void DAGIsel::selectStore(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择 STORE 节点
-        // ============================================================================
-        //
-        // 作用：
-        // 为 STORE 节点生成目标相关的存储指令（STR）。
-        //
-        // 与 LOAD 相似：
-        // - 同样需要地址选择与立即数范围检查
-        // - 操作数：[Chain, Value, Address]
+        // STORE 操作数：[Chain, Value, Address]
+        if (node->getNumOperands() < 3) return;
+
+        const DAG::SDNode* valNode  = node->getOperand(1).getNode();
+        const DAG::SDNode* addrNode = node->getOperand(2).getNode();
+        if (!valNode || !addrNode) return;
+
+        DataType* valTy = typeOf(valNode);
+        int       size  = dataTypeSize(valTy);
+
+        // 存零直接使用零寄存器（+0.0f 与整数 0 的位模式相同）
+        Register src;
+        if (isConstValue(valNode, 0) || isPositiveZeroF32(valNode))
+            src = zeroReg(size == 8);
+        else if (isConstInt(valNode))
+            src = getOperandReg(valNode, size == 8, m_block);
+        else
+        {
+            // REG 节点按 IR 寄存器复用，其类型可能来自先出现的 GEP 下标（I64），
+            // 访存宽度以值所在虚拟寄存器的实际宽度为准
+            src  = getOperandReg(valNode, m_block);
+            size = isFloatReg(src) ? 4 : (is64BitReg(src) ? 8 : 4);
+        }
 
-        TODO("选择 STORE：地址折叠 + 生成存储指令");
+        int         fi = -1;
+        MemOperand* mem = selectMemOperand(addrNode, size, fi, m_block);
+        Instr*      st  = createMemInst(Operator::STR, src, mem);
+        if (fi >= 0)
+        {
+            st->fiop      = new FrameIndexOperand(fi);
+            st->use_fiops = true;
+        }
+        m_block->insts.push_back(st);
     }
 
-    void DAGIsel::selectICmp(const DAG::SDNode* node, BE::Block* m_block)
+    CondCode DAGIsel::emitIntCompare(const DAG::SDNode* cmp, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择整数比较节点（ICMP）
-        // ============================================================================
+        const DAG::SDNode* lhs  = cmp->getOperand(0).getNode();
+        const DAG::SDNode* rhs  = cmp->getOperand(1).getNode();
+        CondCode           cond = icmpCond(cmp->hasImmI64() ? static_cast<int>(cmp->getImmI64()) : 0);
+        if (isConstInt(lhs) && !isConstInt(rhs))
+        {
+            std::swap(lhs, rhs);
+            cond = swapCond(cond);
+        }
+
+        bool     w64 = is64Type(typeOf(lhs)) || is64Type(typeOf(rhs));
+        Register l   = getOperandReg(lhs, w64, m_block);
 
-        TODO("选择 ICMP：根据条件生成比较指令序列");
+        // 立即数比较：负数改用 cmn
+        if (isConstInt(rhs) && fitsArithImm(rhs->getImmI64()))
+        {
+            int64_t c = rhs->getImmI64();
+            m_block->insts.push_back(createCmpInst(
+                c >= 0 ? Operator::CMP : Operator::CMN, l, new ImmeOperand(static_cast<int>(c >= 0 ? c : -c))));
+            return cond;
+        }
+
+        m_block->insts.push_back(createCmpInst(Operator::CMP, l, new RegOperand(getOperandReg(rhs, w64, m_block))));
+        return cond;
+    }
+
+    void DAGIsel::emitFloatCompare(const DAG::SDNode* cmp, BE::Block* m_block)
+    {
+        Register           l   = getOperandReg(cmp->getOperand(0).getNode(), m_block);
+        const DAG::SDNode* rhs = cmp->getOperand(1).getNode();
+        if (isPositiveZeroF32(rhs))
+            m_block->insts.push_back(createCmpInst(Operator::FCMP, l, new ImmeOperand(0)));
+        else
+            m_block->insts.push_back(createCmpInst(Operator::FCMP, l, new RegOperand(getOperandReg(rhs, m_block))));
+    }
+
+    void DAGIsel::selectICmp(const DAG::SDNode* node, BE::Block* m_block)
+    {
+        if (node->getNumOperands() < 2) return;
+        CondCode cond = emitIntCompare(node, m_block);
+        m_block->insts.push_back(createCondInst(Operator::CSET, nodeToVReg_.at(node), cond));
     }
 
     void DAGIsel::selectFCmp(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择浮点比较节点（FCMP）
-        // ============================================================================
+        if (node->getNumOperands() < 2) return;
 
-        TODO("选择 FCMP：根据条件生成浮点比较指令");
+        Register dst = nodeToVReg_.at(node);
+        int      cc  = node->hasImmI64() ? static_cast<int>(node->getImmI64()) : 0;
+        emitFloatCompare(node, m_block);
+
+        CondCode cond;
+        if (fcmpCond(cc, cond))
+        {
+            m_block->insts.push_back(createCondInst(Operator::CSET, dst, cond));
+            return;
+        }
+
+        // ONE = OLT | OGT，UEQ = OEQ | UNO
+        CondCode first, second;
+        switch (static_cast<ME::FCmpOp>(cc))
+        {
+            case ME::FCmpOp::ONE: first = CondCode::MI, second = CondCode::GT; break;
+            case ME::FCmpOp::UEQ: first = CondCode::EQ, second = CondCode::VS; break;
+            default: ERROR("Unsupported FCMP condition: %d", cc); return;
+        }
+        Register t1 = getVReg(dst.dt);
+        Register t2 = getVReg(dst.dt);
+        m_block->insts.push_back(createCondInst(Operator::CSET, t1, first));
+        m_block->insts.push_back(createCondInst(Operator::CSET, t2, second));
+        m_block->insts.push_back(createRInst(Operator::ORR, dst, t1, t2));
     }
 
     void DAGIsel::selectBranch(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择分支节点（BR / BRCOND）
-        // ============================================================================
-        //
-        // 作用：
-        // 为无条件分支与条件分支生成跳转指令。
-        // - BR 直接跳转，用 B label
-        // - BRCOND 需判断条件（非 0 为真），生成 CMP + BNE + B 序列
+        auto opcode = opOf(node);
+
+        if (opcode == DAG::ISD::BR)
+        {
+            // 无条件分支：BR [Chain, Target]
+            if (node->getNumOperands() < 1) return;
+            int                targetIdx  = (node->getNumOperands() == 1) ? 0 : 1;
+            const DAG::SDNode* targetNode = node->getOperand(targetIdx).getNode();
+            if (!targetNode || !targetNode->hasImmI64()) return;
+            m_block->insts.push_back(createBranch(Operator::B, static_cast<int>(targetNode->getImmI64())));
+            return;
+        }
 
-        TODO("选择分支：区分 BR/BRCOND 生成跳转指令");
+        // 条件分支：BRCOND [Chain, Cond, TrueLabel, FalseLabel]
+        if (node->getNumOperands() < 3) return;
+
+        int                condIdx        = (node->getNumOperands() == 3) ? 0 : 1;
+        const DAG::SDNode* condNode       = node->getOperand(condIdx).getNode();
+        const DAG::SDNode* trueLabelNode  = node->getOperand(condIdx + 1).getNode();
+        const DAG::SDNode* falseLabelNode = node->getOperand(condIdx + 2).getNode();
+        if (!condNode || !trueLabelNode || !falseLabelNode) return;
+
+        int trueLabel  = trueLabelNode->hasImmI64() ? static_cast<int>(trueLabelNode->getImmI64()) : 0;
+        int falseLabel = falseLabelNode->hasImmI64() ? static_cast<int>(falseLabelNode->getImmI64()) : 0;
+
+        if (fusedCompares_.count(condNode) && opOf(condNode) == DAG::ISD::ICMP)
+        {
+            const DAG::SDNode* lhs = condNode->getOperand(0).getNode();
+            const DAG::SDNode* rhs = condNode->getOperand(1).getNode();
+            auto               cc  = static_cast<ME::ICmpOp>(condNode->getImmI64());
+            if (isConstValue(rhs, 0) && !isConstInt(lhs) && (cc == ME::ICmpOp::EQ || cc == ME::ICmpOp::NE))
+            {
+                // 与 0 比较相等性：cbz / cbnz 省去 cmp
+                Operator op = cc == ME::ICmpOp::EQ ? Operator::CBZ : Operator::CBNZ;
+                m_block->insts.push_back(
+                    createInstr2(op, new RegOperand(getOperandReg(lhs, m_block)), new LabelOperand(trueLabel)));
+            }
+            else
+                m_block->insts.push_back(createBranch(getBranchOp(emitIntCompare(condNode, m_block)), trueLabel));
+        }
+        else if (fusedCompares_.count(condNode))
+        {
+            CondCode cond = CondCode::NE;
+            fcmpCond(static_cast<int>(condNode->getImmI64()), cond);
+            emitFloatCompare(condNode, m_block);
+            m_block->insts.push_back(createBranch(getBranchOp(cond), trueLabel));
+        }
+        else
+        {
+            // 条件非 0 则跳转到 trueLabel
+            Register condReg = getOperandReg(condNode, m_block);
+            m_block->insts.push_back(
+                createInstr2(Operator::CBNZ, new RegOperand(condReg), new LabelOperand(trueLabel)));
+        }
+
+        m_block->insts.push_back(createBranch(Operator::B, falseLabel));
+    }
+
+    bool DAGIsel::selectMemset(const DAG::SDNode* node, BE::Block* m_block)
+    {
+        // 操作数: [Chain, Callee, ptr, val(i8), len(i32), isVolatile(i1)]
+        // 只处理“清零 + 常量长度 + 4 字节倍数”的情形：展开为 stp xzr, xzr / str xzr / str wzr 序列
+        if (node->getNumOperands() < 5) return false;
+
+        const DAG::SDNode* ptrNode = node->getOperand(2).getNode();
+        const DAG::SDNode* valNode = node->getOperand(3).getNode();
+        const DAG::SDNode* lenNode = node->getOperand(4).getNode();
+        if (!ptrNode || !valNode || !lenNode) return false;
+        if (!isConstValue(valNode, 0) || !isConstInt(lenNode)) return false;
+
+        int64_t len = lenNode->getImmI64();
+        if (len < 0 || len > kMemsetUnrollBytes || len % 4 != 0) return false;
+        if (len == 0) return true;
+
+        // 栈上数组直接以 sp 为基址，偏移交给帧降低
+        int                fi       = -1;
+        int64_t            baseOff  = 0;
+        Register           baseReg  = PR::sp;
+        const DAG::SDNode* baseNode = nullptr;
+        if (selectAddress(ptrNode, baseNode, baseOff) && opOf(baseNode) == DAG::ISD::FRAME_INDEX)
+            fi = baseNode->getFrameIndex();
+        else
+        {
+            baseReg = getOperandReg(ptrNode, true, m_block);
+            baseOff = 0;
+        }
+
+        auto emit = [&](Instr* inst) {
+            if (fi >= 0)
+            {
+                inst->fiop      = new FrameIndexOperand(fi);
+                inst->use_fiops = true;
+            }
+            m_block->insts.push_back(inst);
+        };
+
+        int64_t off = 0;
+        for (; off + 16 <= len; off += 16)
+            emit(createInstr3(Operator::STP,
+                new RegOperand(PR::xzr),
+                new RegOperand(PR::xzr),
+                new MemOperand(baseReg, static_cast<int>(baseOff + off))));
+        for (; off + 8 <= len; off += 8)
+            emit(createMemInst(Operator::STR, PR::xzr, new MemOperand(baseReg, static_cast<int>(baseOff + off))));
+        for (; off + 4 <= len; off += 4)
+            emit(createMemInst(Operator::STR, PR::wzr, new MemOperand(baseReg, static_cast<int>(baseOff + off))));
+        return true;
     }
 
     void DAGIsel::selectCall(const DAG::SDNode* node, BE::Block* m_block)
     {
         // ============================================================================
-        // TODO: 选择 CALL 节点
+        // 函数调用（AAPCS64）
         // ============================================================================
         //
-        // 作用：
-        // 为函数调用生成参数传递、CALL 指令、返回值处理的完整序列。
-        // - 需要遵循目标调用约定（参数寄存器 vs 栈传参）
-        // - 整数与浮点参数使用不同的寄存器组
-        // - 内置函数（llvm.memset 等）需特殊处理，转化为对 memset 的调用
-        //
-        // AArch64 调用约定：
-        // - 整数参数：x0-x7 (w0-w7)
-        // - 浮点参数：d0-d7 (s0-s7)
-        // - 超出的参数 → 存储到栈上（SP + 0, SP + 8, ...）
-        // - 返回值从 x0/w0/s0/d0 搬运到目标寄存器
+        // - 整数参数依次使用 x0-x7（w0-w7），浮点参数依次使用 s0-s7，两类各自计数
+        // - 超出的参数按出现顺序存入 [sp, #8k]（位于本函数栈帧底部的传出参数区）
+        // - 源值只可能在虚拟寄存器（分配到被调用者保存寄存器）或溢出临时寄存器中，逐个搬运不会相互覆盖
+        // CALL 操作数: [Chain, Callee, Arg0, Arg1, ...]
+        if (node->getNumOperands() < 2) return;
+
+        const DAG::SDNode* calleeNode = node->getOperand(1).getNode();
+        if (!calleeNode) return;
+
+        std::string funcName = calleeNode->hasSymbol() ? calleeNode->getSymbol() : "unknown";
+
+        std::vector<const DAG::SDNode*> args;
+        for (unsigned idx = 2; idx < node->getNumOperands(); ++idx)
+            if (const DAG::SDNode* argNode = node->getOperand(idx).getNode()) args.push_back(argNode);
+
+        // 内置函数：常量长度的清零 memset 直接展开；其余转为库函数调用，只传 (dst, val/src, len)，len 为 size_t
+        bool libcall = false;
+        if (funcName.find("llvm.memset") != std::string::npos)
+        {
+            if (selectMemset(node, m_block)) return;
+            funcName = "memset";
+            libcall  = true;
+        }
+        else if (funcName.find("llvm.memcpy") != std::string::npos)
+        {
+            funcName = "memcpy";
+            libcall  = true;
+        }
+        if (libcall && args.size() > 3) args.resize(3);
+
+        struct ArgInfo
+        {
+            const DAG::SDNode* node;
+            BE::DataType*      type;
+            int                regIdx;    ///< 参数寄存器编号，-1 表示栈传递
+            int                stackOff;  ///< 栈传递时相对 sp 的偏移
+        };
+        std::vector<ArgInfo> infos;
+        int                  intIdx = 0, floatIdx = 0, stackOff = 0;
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            BE::DataType* ty = typeOf(args[i]);
+            if (libcall && i != 1) ty = BE::I64;
+            bool isFloat = isFloatType(ty);
+            int& idx     = isFloat ? floatIdx : intIdx;
+            if (idx < (isFloat ? A64_FPR_ARG_COUNT : A64_GPR_ARG_COUNT))
+                infos.push_back({args[i], ty, idx++, -1});
+            else
+            {
+                infos.push_back({args[i], ty, -1, stackOff});
+                stackOff += 8;
+            }
+        }
+
+        // 先写栈参数，再装寄存器参数，保证参数寄存器装好后直到 bl 之间不再插入其它指令
+        for (auto& info : infos)
+        {
+            if (info.regIdx >= 0) continue;
+            bool     w64 = is64Type(info.type);
+            Register src;
+            if (isConstValue(info.node, 0) || isPositiveZeroF32(info.node))
+                src = zeroReg(w64);
+            else if (isFloatType(info.type))
+                src = getOperandReg(info.node, m_block);
+            else
+                src = getOperandReg(info.node, w64, m_block);
+            m_block->insts.push_back(createMemInst(Operator::STR, src, new MemOperand(PR::sp, info.stackOff)));
+        }
+
+        // 寄存器参数的源值先全部实例化（扩展、常量），再逐个搬入参数寄存器
+        std::vector<std::pair<Register, Operand*>> moves;
+        for (auto& info : infos)
+        {
+            if (info.regIdx < 0) continue;
+            Register dst(info.regIdx, info.type, false);
+            if (isConstInt(info.node))
+                moves.push_back({dst, new I32Operand(static_cast<int>(info.node->getImmI64()))});
+            else if (opOf(info.node) == DAG::ISD::CONST_F32 && info.node->hasImmF32())
+                moves.push_back({dst, new F32Operand(info.node->getImmF32())});
+            else if (isFloatType(info.type))
+                moves.push_back({dst, new RegOperand(getOperandReg(info.node, m_block))});
+            else
+                moves.push_back({dst, new RegOperand(getOperandReg(info.node, is64Type(info.type), m_block))});
+        }
+        for (auto& [dst, src] : moves) m_block->insts.push_back(BE::createMove(new RegOperand(dst), src, LOC_STR));
 
-        TODO("选择 CALL：参数传递 + 生成调用指令 + 返回值处理");
+        m_block->insts.push_back(createInstr1(Operator::BL, new SymbolOperand(funcName)));
+
+        // 返回值：w0/x0 或 s0
+        if (const Register* r = nodeToVReg_.lookup(node))
+        {
+            Register dst = *r;
+            Register src(0, dst.dt, false);
+            m_block->insts.push_back(BE::createMove(new RegOperand(dst), new RegOperand(src), LOC_STR));
+        }
     }
 
     void DAGIsel::selectRet(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // 操作数 0 是 Chain（保证副作用顺序），操作数 1 是实际返回值
-        // 如有返回值，则将返回值移动到 x0/w0/s0/d0
+        // 操作数 0 是 Chain，操作数 1 是实际返回值，按类型放入 w0/x0/s0
         if (node->getNumOperands() > 1)
         {
             const DAG::SDNode* retValNode = node->getOperand(1).getNode();
-            Register           retReg     = getOperandReg(retValNode, m_block);
-
-            DataType* retType = retValNode->getNumValues() > 0 ? retValNode->getValueType(0) : BE::I32;
+            DataType*          retType    = typeOf(retValNode);
+            Register           destReg(0, isFloatType(retType) ? BE::F32 : (is64Type(retType) ? BE::I64 : BE::I32));
 
-            Register destReg;
-            if (retType == BE::F32 || retType == BE::F64)
-                destReg = (retType == BE::F32) ? PR::s0 : PR::d0;
+            if (isConstInt(retValNode))
+                m_block->insts.push_back(
+                    BE::createMove(new RegOperand(destReg), static_cast<int>(retValNode->getImmI64()), LOC_STR));
+            else if (opOf(retValNode) == DAG::ISD::CONST_F32 && retValNode->hasImmF32())
+                m_block->insts.push_back(BE::createMove(new RegOperand(destReg), retValNode->getImmF32(), LOC_STR));
             else
-                destReg = (retType == BE::I32) ? PR::w0 : PR::x0;
-
-            if (retReg.dt->equal(I64) && destReg.dt->equal(I32)) destReg.dt = I64;
-            m_block->insts.push_back(BE::AArch64::createMove(new RegOperand(destReg), new RegOperand(retReg), LOC_STR));
+                emitCopy(destReg, getOperandReg(retValNode, m_block), m_block);
         }
 
         m_block->insts.push_back(createInstr0(Operator::RET));
@@ -590,21 +1380,36 @@ namespace BE::AArch64
 
     void DAGIsel::selectCast(const DAG::SDNode* node, BE::Block* m_block)
     {
-        // ============================================================================
-        // TODO: 选择类型转换节点（ZEXT / SITOFP / FPTOSI）
-        // ============================================================================
-        //
-        // 作用：
-        // 为类型转换节点生成目标相关的转换指令。
+        if (node->getNumOperands() < 1) return;
+
+        auto     opcode = opOf(node);
+        Register dst    = nodeToVReg_.at(node);
+
+        const DAG::SDNode* srcNode = node->getOperand(0).getNode();
+        if (!srcNode) return;
+
+        Register srcReg = getOperandReg(srcNode, m_block);
 
-        TODO("选择类型转换：生成 UXTW/SCVTF/FCVTZS 指令");
+        switch (opcode)
+        {
+            case DAG::ISD::ZEXT:
+                // 写 w 寄存器会清零高 32 位：i32 -> i64 用 mov wD, wS（UXTW），同宽时普通拷贝
+                if (is64BitReg(dst) && !is64BitReg(srcReg))
+                    m_block->insts.push_back(createR2Inst(Operator::UXTW, dst, srcReg));
+                else
+                    emitCopy(dst, srcReg, m_block);
+                break;
+            case DAG::ISD::SITOFP: m_block->insts.push_back(createR2Inst(Operator::SCVTF, dst, srcReg)); break;
+            case DAG::ISD::FPTOSI: m_block->insts.push_back(createR2Inst(Operator::FCVTZS, dst, srcReg)); break;
+            default: ERROR("Unsupported cast opcode: %s", DAG::toString(opcode));
+        }
     }
 
     void DAGIsel::selectNode(const DAG::SDNode* node, BE::Block* m_block)
     {
         if (!node) return;
 
-        auto opcode = static_cast<DAG::ISD>(node->getOpcode());
+        auto opcode = opOf(node);
 
         switch (opcode)
         {
@@ -613,12 +1418,12 @@ namespace BE::AArch64
             case DAG::ISD::ENTRY_TOKEN:
             case DAG::ISD::TOKEN_FACTOR:
             case DAG::ISD::FRAME_INDEX:
+            case DAG::ISD::CONST_I32:
+            case DAG::ISD::CONST_I64:
+            case DAG::ISD::CONST_F32:
             case DAG::ISD::REG: break;
             case DAG::ISD::COPY: selectCopy(node, m_block); break;
             case DAG::ISD::PHI: selectPhi(node, m_block); break;
-            case DAG::ISD::CONST_I32:
-            case DAG::ISD::CONST_I64:
-            case DAG::ISD::CONST_F32: selectConst(node, m_block); break;
             case DAG::ISD::ADD:
             case DAG::ISD::SUB:
             case DAG::ISD::MUL:
@@ -645,65 +1450,91 @@ namespace BE::AArch64
             case DAG::ISD::ZEXT:
             case DAG::ISD::SITOFP:
             case DAG::ISD::FPTOSI: selectCast(node, m_block); break;
-            default: ERROR("Unsupported DAG node: %s", DAG::toString(static_cast<DAG::ISD>(node->getOpcode())));
+            default: ERROR("Unsupported DAG node: %s", DAG::toString(opcode));
         }
     }
 
     void DAGIsel::selectBlock(ME::Block* ir_block, const DAG::SelectionDAG& dag)
     {
-        // ============================================================================
-        // TODO: 选择基本块的所有指令
-        // ============================================================================
-        //
-        // 作用：
-        // 将一个基本块的 DAG 转换为 MIR 指令序列。
-        //
-        // 采用两阶段：
-        // - 阶段 1：调度与寄存器分配
-        //   * 调度 DAG 节点，确定指令顺序
-        //   * 为每个节点预分配虚拟寄存器（如果不预分配会怎么样？可以怎么解决？）
-        // - 阶段 2：指令选择
-        //   * 按调度顺序遍历节点，调用 selectNode 生成具体指令
-        //   * 使用已选择集合避免重复选择
+        BE::Block* m_block = ctx_.mfunc->blocks[static_cast<uint32_t>(ir_block->blockId)];
+
+        // 阶段 1：调度 DAG 节点（同时为本块涉及的节点编号）
+        auto scheduledNodes = scheduleDAG(dag);
+
+        // 重置块级状态，各表按编号数定容
+        nodeToVReg_.clear();
+        selected_.clear();
 
-        TODO("选择基本块：调度 + 分配寄存器 + 生成指令");
+        // 阶段 1.5：为每个节点预分配虚拟寄存器
+        for (const auto* node : scheduledNodes) allocateRegistersForNode(node);
+
+        // 阶段 1.6：标记被使用者折叠的节点
+        markFoldedNodes(scheduledNodes);
+
+        // 阶段 2：指令选择
+        for (const auto* node : scheduledNodes)
+        {
+            if (!selected_.insert(node)) continue;
+            selectNode(node, m_block);
+        }
     }
 
     void DAGIsel::selectFunction(ME::Function* ir_func)
     {
-        // ============================================================================
-        // TODO: 选择函数的所有指令
-        // ============================================================================
-        //
-        // 作用：
-        // 协调整个函数的指令选择流程，包括栈帧管理、参数设置、基本块选择。
-        //
-        // 为什么需要函数级初始化：
-        // - 每个函数有独立的虚拟寄存器空间（vregMap、nodeToVReg_）
-        // - 需要计算栈帧布局（传出参数区、局部变量区）
-        // - 需要创建所有基本块的 MIR 对象
-        //
-        // 关键步骤：
-        // 1. 重置上下文
-        // 2. 创建后端函数对象
+        // 1. 构建本函数的 DAG，重置函数级上下文
+        auto dags  = target_->buildDAG(*ir_func);
+        ctx_.mfunc = nullptr;
+        ctx_.vregMap.clear();
+        ctx_.allocaFI.clear();
+        ctx_.crossBlockUses = &dags->cross_block_uses;
+
+        // 2. 创建后端函数对象，此后新建的虚拟寄存器在该函数内编号
+        ctx_.mfunc = new BE::Function(ir_func->funcDef->funcName);
+        m_backend_module->functions.push_back(ctx_.mfunc);
+        VRegScope vregScope(ctx_.mfunc);
+
         // 3. 计算传出参数区大小
-        // 4. 收集局部变量
-        // 5. 创建所有基本块对象
-        // 6. 为参数分配虚拟寄存器
-        // 7. 对每个基本块做指令选择
+        ctx_.mfunc->paramSize = computeCallFrameBytes(ir_func);
+        ctx_.mfunc->frameInfo.setParamAreaSize(ctx_.mfunc->paramSize);
+
+        // 4. 收集局部变量（alloca）
+        collectAllocas(ir_func);
 
-        // Hint: 建议了解下对于函数来说，哪些寄存器是由调用者保存，哪些是被调用者保存的
+        // 5. 创建所有基本块的 MIR 对象
+        for (auto& [blockId, block] : ir_func->blocks)
+            ctx_.mfunc->blocks[static_cast<uint32_t>(blockId)] = new BE::Block(static_cast<uint32_t>(blockId));
+
+        // 6. 为参数分配虚拟寄存器
+        setupParameters(ir_func);
 
-        TODO("选择函数：初始化上下文 + 栈帧管理 + 逐块选择");
+        // 7. 对每个基本块做指令选择
+        for (auto& [blockId, block] : ir_func->blocks)
+        {
+            auto it = dags->block_dags.find(block);
+            if (it != dags->block_dags.end() && it->second) selectBlock(block, *(it->second));
+        }
+        ctx_.crossBlockUses = nullptr;
     }
 
     void DAGIsel::runImpl()
     {
         importGlobals();
 
-        target_->buildDAG(ir_module_);
-
         for (auto* f : ir_module_->functions) selectFunction(f);
     }
 
+    void DAGIsel::postOrderHelper(const DAG::SDNode* node, DAG::NodeNumbering& numbering, DAG::NodeSet& visited,
+        std::vector<const DAG::SDNode*>& result)
+    {
+        if (!node) return;
+        numbering.assign(node);  // 其它块 DAG 的节点（入口块的 FrameIndex）在此获得本块编号
+        if (!visited.insert(node)) return;
+
+        for (unsigned i = 0; i < node->getNumOperands(); ++i)
+            if (const DAG::SDNode* opNode = node->getOperand(i).getNode())
+                postOrderHelper(opNode, numbering, visited, result);
+
+        result.push_back(node);
+    }
+
 }  // namespace BE::AArch64
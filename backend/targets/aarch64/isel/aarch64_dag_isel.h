@@ -3,9 +3,11 @@
 
 #include <backend/isel/isel_base.h>
 #include <backend/dag/selection_dag.h>
+#include <backend/dag/node_table.h>
+#include <backend/targets/aarch64/aarch64_defs.h>
 #include <middleend/module/ir_module.h>
 #include <map>
-#include <set>
+#include <unordered_map>
 
 /*
  * 注：当前目录下有 aarch64_dag_isel 与 aarch64_ir_isel 两份实现，它们的功能是一致的，你只需要选择其中一份来完成就行
@@ -47,15 +49,27 @@ namespace BE::AArch64
             BE::Function*              mfunc = nullptr;
             std::map<size_t, Register> vregMap;   ///< IR 寄存器 ID -> 后端虚拟寄存器
             std::map<size_t, int>      allocaFI;  ///< IR alloca 寄存器 ID -> 栈帧索引
+            const std::unordered_map<size_t, int>* crossBlockUses = nullptr;  ///< IR 寄存器在定义所在块之外的引用次数（DAG 构建时统计）
         };
 
         FunctionContext ctx_;
 
         /**
          * @brief 每个基本块级别的状态（每个块重置）
+         *
+         * - nodeToVReg_：DAG 节点到其结果寄存器的映射（仅在块内有效）
+         * - selected_：已选择或已被使用者覆盖的节点集合（防止重复选择）
          */
-        std::map<const DAG::SDNode*, Register> nodeToVReg_;  ///< DAG 节点 -> 其结果虚拟寄存器
-        std::set<const DAG::SDNode*>           selected_;    ///< 已经选择过的节点集合
+        DAG::NodeNumbering     numbering_;                     ///< 本块节点编号（各块表的下标）
+        DAG::NodeMap<Register> nodeToVReg_{numbering_};        ///< DAG 节点 -> 其结果虚拟寄存器
+        DAG::NodeMap<Register> widened_{numbering_};           ///< 32 位结果符号扩展后的 64 位寄存器；常量则为另一宽度的实例
+        DAG::NodeSet           selected_{numbering_};          ///< 已经选择过的节点集合
+        DAG::NodeSet           fusedCompares_{numbering_};     ///< 并入条件分支的比较节点
+        DAG::NodeSet           fusedOperands_{numbering_};     ///< 被 add/sub 吸收的 mul/shl（madd/msub 或移位寄存器操作数）
+        DAG::NodeSet           indexedAddr_{numbering_};       ///< 折叠为 [base, index{, sxtw|lsl #k}] 的地址
+
+        /// memset 内联展开阈值：清零长度不超过该值时展开为 stp/str 零寄存器序列
+        static constexpr int64_t kMemsetUnrollBytes = 128;
 
         void runImpl();
         void importGlobals();
@@ -63,35 +77,56 @@ namespace BE::AArch64
         void collectAllocas(ME::Function* ir_func);
         void setupParameters(ME::Function* ir_func);
         void selectBlock(ME::Block* ir_block, const DAG::SelectionDAG& dag);
+        int  computeCallFrameBytes(ME::Function* ir_func);
 
         // ==================== 阶段 1：调度（Schedule） ====================
 
         std::vector<const DAG::SDNode*> scheduleDAG(const DAG::SelectionDAG& dag);
         void                            allocateRegistersForNode(const DAG::SDNode* node);
 
+        using UserMap = DAG::NodeMap<std::vector<std::pair<const DAG::SDNode*, unsigned>>>;
+        void markFoldedNodes(const std::vector<const DAG::SDNode*>& scheduled);  // 标记被使用者折叠、无需单独生成的节点
+        int  crossBlockUses(const DAG::SDNode* node) const;  // 节点所定义的 IR 寄存器在其它块中的引用次数
+        bool hasSingleUse(const DAG::SDNode* node, const UserMap& users) const;
+        bool isFoldedAddress(const DAG::SDNode* node, const UserMap& users);  // 地址是否被全部访存使用者折叠
+        int  accessSize(const DAG::SDNode* memNode);  // LOAD/STORE 的访问宽度（字节）
+
         // ==================== 阶段 2：选择（Select） ====================
 
         void     selectNode(const DAG::SDNode* node, BE::Block* m_block);
         Register getOperandReg(const DAG::SDNode* node, BE::Block* m_block);
+        Register getOperandReg(const DAG::SDNode* node, bool want64, BE::Block* m_block);  // 按需 sxtw / 截断
+        Register fitWidth(Register reg, bool want64, BE::Block* m_block);
+        void     emitCopy(Register dst, Register src, BE::Block* m_block);
         Register materializeAddress(const DAG::SDNode* node, BE::Block* m_block);
         bool     selectAddress(const DAG::SDNode* addrNode, const DAG::SDNode*& baseNode, int64_t& offset);
+        bool     matchIndexedAddress(const DAG::SDNode* addrNode, int size, const DAG::SDNode*& baseNode,
+                const DAG::SDNode*& indexNode, const DAG::SDNode*& scaleNode);
+        MemOperand* selectMemOperand(const DAG::SDNode* addrNode, int size, int& frameIndex, BE::Block* m_block);
         Register getOrCreateVReg(size_t ir_reg_id, BE::DataType* dt);
 
         void selectCopy(const DAG::SDNode* node, BE::Block* m_block);
         void selectPhi(const DAG::SDNode* node, BE::Block* m_block);
-        void selectConst(const DAG::SDNode* node, BE::Block* m_block);
         void selectBinary(const DAG::SDNode* node, BE::Block* m_block);
-        void selectUnary(const DAG::SDNode* node, BE::Block* m_block);
+        void selectAddSub(const DAG::SDNode* node, Register dst, BE::Block* m_block);
+        void selectDivMod(const DAG::SDNode* node, Register dst, BE::Block* m_block);
         void selectLoad(const DAG::SDNode* node, BE::Block* m_block);
         void selectStore(const DAG::SDNode* node, BE::Block* m_block);
         void selectICmp(const DAG::SDNode* node, BE::Block* m_block);
         void selectFCmp(const DAG::SDNode* node, BE::Block* m_block);
+        CondCode emitIntCompare(const DAG::SDNode* cmp, BE::Block* m_block);  // cmp/cmn，返回成立时的条件码
+        void     emitFloatCompare(const DAG::SDNode* cmp, BE::Block* m_block);
         void selectBranch(const DAG::SDNode* node, BE::Block* m_block);
         void selectCall(const DAG::SDNode* node, BE::Block* m_block);
+        bool selectMemset(const DAG::SDNode* node, BE::Block* m_block);  // 常量长度清零 memset 内联展开
         void selectRet(const DAG::SDNode* node, BE::Block* m_block);
         void selectCast(const DAG::SDNode* node, BE::Block* m_block);
 
         int dataTypeSize(BE::DataType* dt);
+
+        // 后序遍历辅助函数
+        static void postOrderHelper(const DAG::SDNode* node, DAG::NodeNumbering& numbering, DAG::NodeSet& visited,
+            std::vector<const DAG::SDNode*>& result);
     };
 
 }  // namespace BE::AArch64
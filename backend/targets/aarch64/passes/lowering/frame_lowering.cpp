@@ -7,6 +7,106 @@
 
 namespace BE::AArch64::Passes::Lowering
 {
+    namespace
+    {
+        inline int alignTo16(int v) { return (v + 15) & ~15; }
+
+        // 访存宽度（字节）：由数据寄存器的类型决定
+        inline int accessSize(const Register& rt)
+        {
+            if (rt.dt == F32) return 4;
+            return is64BitReg(rt) ? 8 : 4;
+        }
+
+        // ldp/stp 的 7 位有符号缩放偏移
+        inline bool fitsPairOffset(int64_t value, int size)
+        {
+            return value % size == 0 && value / size >= -64 && value / size <= 63;
+        }
+
+        template <typename Fn>
+        void forEachReg(MInstruction* inst, Fn&& fn)
+        {
+            switch (inst->kind)
+            {
+                case InstKind::MOVE:
+                {
+                    auto* mv = static_cast<MoveInst*>(inst);
+                    if (auto* r = dynamic_cast<RegOperand*>(mv->dest)) fn(r->reg);
+                    if (auto* r = dynamic_cast<RegOperand*>(mv->src)) fn(r->reg);
+                    return;
+                }
+                case InstKind::LSLOT: fn(static_cast<FILoadInst*>(inst)->dest); return;
+                case InstKind::SSLOT: fn(static_cast<FIStoreInst*>(inst)->src); return;
+                case InstKind::TARGET: break;
+                default: return;
+            }
+            for (auto* op : static_cast<Instr*>(inst)->operands)
+            {
+                if (auto* mem = dynamic_cast<MemOperand*>(op))
+                {
+                    fn(mem->base);
+                    if (mem->hasIndex) fn(mem->index);
+                }
+                else if (auto* sr = dynamic_cast<ShiftedRegOperand*>(op))
+                    fn(sr->reg);
+                else if (auto* r = dynamic_cast<RegOperand*>(op))
+                    fn(r->reg);
+            }
+        }
+
+        /**
+         * @brief 保存区中的一个槽：相邻的同类寄存器两两成对，用 stp/ldp 一次存取
+         */
+        struct SaveSlot
+        {
+            Register first;
+            Register second;
+            bool     paired;
+            int      offset;  ///< 相对保存区底部（sp + L）的偏移
+        };
+
+        std::vector<SaveSlot> layoutSaveArea(const std::vector<Register>& saved)
+        {
+            std::vector<SaveSlot> slots;
+            int                   offset = 0;
+            for (size_t i = 0; i < saved.size();)
+            {
+                bool canPair = i + 1 < saved.size() && isFloatReg(saved[i]) == isFloatReg(saved[i + 1]);
+                if (canPair)
+                {
+                    slots.push_back({saved[i], saved[i + 1], true, offset});
+                    i += 2;
+                }
+                else
+                {
+                    slots.push_back({saved[i], Register(), false, offset});
+                    i += 1;
+                }
+                offset += canPair ? 16 : 8;
+            }
+            return slots;
+        }
+
+        Instr* createSaveInst(Operator pairOp, Operator singleOp, const SaveSlot& slot, MemOperand* mem)
+        {
+            if (slot.paired) return createInstr3(pairOp, new RegOperand(slot.first), new RegOperand(slot.second), mem);
+            return createMemInst(singleOp, slot.first, mem);
+        }
+
+        // sp 加减常量：12 位立即数直接编码，否则经 x16
+        void adjustSp(Operator op, int amount, std::deque<MInstruction*>& out)
+        {
+            if (amount <= static_cast<int>(A64_IMM12_MASK))
+            {
+                out.push_back(createRInst(op, PR::sp, PR::sp, amount));
+                return;
+            }
+            emitMovImm(out, PR::x16, amount);
+            out.push_back(createRInst(op, PR::sp, PR::sp, PR::x16));
+        }
+    }  // namespace
+
     void FrameLoweringPass::runOnModule(BE::Module& module)
     {
         for (auto* func : module.functions)
@@ -16,5 +116,182 @@ namespace BE::AArch64::Passes::Lowering
         }
     }
 
-    void FrameLoweringPass::lowerFunction(BE::Function* func) { TODO("实现 Frame Lowering"); }
+    std::vector<Register> FrameLoweringPass::collectSavedRegs(BE::Function* func)
+    {
+        // 被调用者保存寄存器只在寄存器分配结果中出现时才保存；x30 在函数内有 bl 时保存
+        bool hasCall = false;
+        bool usedInt[A64_MAX_GPR_ID + 1] = {};
+        bool usedFP[A64_MAX_FPR_ID + 1]  = {};
+
+        for (auto& [bid, block] : func->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                if (inst->kind == InstKind::TARGET && static_cast<Instr*>(inst)->op == Operator::BL) hasCall = true;
+                forEachReg(inst, [&](const Register& r) {
+                    if (r.isVreg) return;
+                    if (isFloatReg(r))
+                    {
+                        if (r.rId >= A64_CALLEE_FP_FIRST && r.rId <= A64_CALLEE_FP_LAST) usedFP[r.rId] = true;
+                    }
+                    else if (r.rId >= A64_CALLEE_INT_FIRST && r.rId <= A64_CALLEE_INT_LAST)
+                        usedInt[r.rId] = true;
+                });
+            }
+        }
+
+        std::vector<Register> saved;
+        for (int r = A64_CALLEE_INT_FIRST; r <= A64_CALLEE_INT_LAST; ++r)
+            if (usedInt[r]) saved.push_back(Register(r, I64, false));
+        if (hasCall) saved.push_back(PR::x30);
+        for (int r = A64_CALLEE_FP_FIRST; r <= A64_CALLEE_FP_LAST; ++r)
+            if (usedFP[r]) saved.push_back(Register(r, F64, false));
+        return saved;
+    }
+
+    void FrameLoweringPass::resolveOffset(Instr* inst, int offset, std::deque<MInstruction*>& out)
+    {
+        switch (getOpInfoType(inst->op))
+        {
+            case OpType::M:
+            {
+                auto* mem   = static_cast<MemOperand*>(inst->operands[1]);
+                int   total = mem->offset + offset;
+                if (fitsMemOffset(total, accessSize(static_cast<RegOperand*>(inst->operands[0])->reg)))
+                {
+                    mem->offset = total;
+                    break;
+                }
+                emitMovImm(out, PR::x16, total);
+                inst->operands[1] = new MemOperand(mem->base, PR::x16, Extend::LSL, 0);
+                delete mem;
+                break;
+            }
+            case OpType::P:
+            {
+                auto* mem   = static_cast<MemOperand*>(inst->operands[2]);
+                int   total = mem->offset + offset;
+                if (fitsPairOffset(total, accessSize(static_cast<RegOperand*>(inst->operands[0])->reg)))
+                {
+                    mem->offset = total;
+                    break;
+                }
+                emitMovImm(out, PR::x16, total);
+                out.push_back(createRInst(Operator::ADD, PR::x16, mem->base, PR::x16));
+                mem->base   = PR::x16;
+                mem->offset = 0;
+                break;
+            }
+            case OpType::R:
+            {
+                // add xD, sp, #fi
+                auto* imm   = static_cast<ImmeOperand*>(inst->operands[2]);
+                int   total = imm->value + offset;
+                if (total >= 0 && total <= static_cast<int>(A64_IMM12_MASK))
+                {
+                    imm->value = total;
+                    break;
+                }
+                emitMovImm(out, PR::x16, total);
+                inst->operands[2] = new RegOperand(PR::x16);
+                delete imm;
+                break;
+            }
+            default: ERROR("Unexpected frame index on %s", getOpInfoAsm(inst->op).c_str());
+        }
+    }
+
+    void FrameLoweringPass::insertPrologue(
+        BE::Function* func, const std::vector<Register>& saved, int saveSize, int localSize)
+    {
+        BE::Block*                entry = func->blocks.begin()->second;
+        std::deque<MInstruction*> prologue;
+
+        auto slots = layoutSaveArea(saved);
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            // 第一组以前变址写回同时分配保存区
+            auto* mem = i == 0 ? new MemOperand(PR::sp, -saveSize, AddrMode::PreIndex)
+                               : new MemOperand(PR::sp, slots[i].offset);
+            prologue.push_back(createSaveInst(Operator::STP, Operator::STR, slots[i], mem));
+        }
+        if (localSize > 0) adjustSp(Operator::SUB, localSize, prologue);
+
+        entry->insts.insert(entry->insts.begin(), prologue.begin(), prologue.end());
+    }
+
+    void FrameLoweringPass::insertEpilogue(
+        BE::Function* func, const std::vector<Register>& saved, int saveSize, int localSize)
+    {
+        auto slots = layoutSaveArea(saved);
+        for (auto& [bid, block] : func->blocks)
+        {
+            std::deque<MInstruction*> newInsts;
+            for (auto* inst : block->insts)
+            {
+                if (inst->kind == InstKind::TARGET && static_cast<Instr*>(inst)->op == Operator::RET)
+                {
+                    if (localSize > 0) adjustSp(Operator::ADD, localSize, newInsts);
+                    // 逆序恢复，最后一组以后变址写回同时释放保存区
+                    for (size_t i = slots.size(); i-- > 0;)
+                    {
+                        auto* mem = i == 0 ? new MemOperand(PR::sp, saveSize, AddrMode::PostIndex)
+                                           : new MemOperand(PR::sp, slots[i].offset);
+                        newInsts.push_back(createSaveInst(Operator::LDP, Operator::LDR, slots[i], mem));
+                    }
+                }
+                newInsts.push_back(inst);
+            }
+            block->insts.swap(newInsts);
+        }
+    }
+
+    void FrameLoweringPass::lowerFunction(BE::Function* func)
+    {
+        if (func->blocks.empty()) return;
+
+        // 1. 计算栈帧布局
+        std::vector<Register> saved    = collectSavedRegs(func);
+        int                   saveSize = alignTo16(static_cast<int>(saved.size()) * 8);
+
+        func->frameInfo.setBaseOffset(0);
+        int localSize   = alignTo16(func->frameInfo.calculateOffsets());
+        func->stackSize = localSize + saveSize;
+
+        // 2. 解析帧索引操作数：局部变量偏移 + 指令中已有的偏移
+        for (auto& [bid, block] : func->blocks)
+        {
+            std::deque<MInstruction*> newInsts;
+            for (auto* inst : block->insts)
+            {
+                if (inst->kind == InstKind::TARGET)
+                {
+                    auto* ai = static_cast<Instr*>(inst);
+                    if (ai->use_fiops && ai->fiop && ai->fiop->ot == Operand::Type::FRAME_INDEX)
+                    {
+                        auto* fiOp   = static_cast<FrameIndexOperand*>(ai->fiop);
+                        int   offset = func->frameInfo.getObjectOffset(fiOp->frameIndex);
+                        if (offset < 0) ERROR("Unknown frame index %d in %s", fiOp->frameIndex, func->name.c_str());
+                        resolveOffset(ai, offset, newInsts);
+                        delete ai->fiop;
+                        ai->fiop      = nullptr;
+                        ai->use_fiops = false;
+                    }
+                    else if (ai->comment == "param_stack")
+                    {
+                        // 栈参数位于调用者的栈顶，即本函数栈帧之上
+                        resolveOffset(ai, func->stackSize, newInsts);
+                        ai->comment.clear();
+                    }
+                }
+                newInsts.push_back(inst);
+            }
+            block->insts.swap(newInsts);
+        }
+
+        // 3. 序言与尾声
+        if (func->stackSize == 0) return;
+        insertPrologue(func, saved, saveSize, localSize);
+        insertEpilogue(func, saved, saveSize, localSize);
+    }
 }  // namespace BE::AArch64::Passes::Lowering
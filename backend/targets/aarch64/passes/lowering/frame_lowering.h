@@ -2,9 +2,22 @@
 #define __BACKEND_AARCH64_PASSES_LOWERING_FRAME_LOWERING_H__
 
 #include <backend/mir/m_module.h>
+#include <backend/targets/aarch64/aarch64_defs.h>
+#include <vector>
 
 namespace BE::AArch64::Passes::Lowering
 {
+    /**
+     * @brief 栈帧降低（寄存器分配之后）
+     *
+     * 栈帧布局（sp 为序言结束后的栈顶）：
+     *   [sp, sp + L)       传出参数区、局部变量、溢出槽（MFrameInfo 布局，L 按 16 对齐）
+     *   [sp + L, sp + L+S) 被调用者保存寄存器（S 按 16 对齐），x30 仅在函数内有调用时保存
+     *   [sp + L + S, ...)  调用者传入的栈参数
+     *
+     * 序言为 stp/str ..., [sp, #-S]! 加 sub sp, sp, #L，尾声与之对称；
+     * 帧索引操作数与栈参数偏移在此处解析为 sp 相对偏移，超出编码范围时借助 x16。
+     */
     class FrameLoweringPass
     {
       public:
@@ -14,7 +27,11 @@ namespace BE::AArch64::Passes::Lowering
         void runOnModule(BE::Module& module);
 
       private:
-        void lowerFunction(BE::Function* func);
+        void                  lowerFunction(BE::Function* func);
+        std::vector<Register> collectSavedRegs(BE::Function* func);
+        void                  resolveOffset(Instr* inst, int offset, std::deque<MInstruction*>& out);
+        void insertPrologue(BE::Function* func, const std::vector<Register>& saved, int saveSize, int localSize);
+        void insertEpilogue(BE::Function* func, const std::vector<Register>& saved, int saveSize, int localSize);
     };
 }  // namespace BE::AArch64::Passes::Lowering
 
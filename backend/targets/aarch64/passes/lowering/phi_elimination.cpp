@@ -1,20 +1,185 @@
 #include <backend/targets/aarch64/passes/lowering/phi_elimination.h>
 #include <debug.h>
 #include <algorithm>
-#include <transfer.h>
+#include <set>
 
 namespace BE::AArch64::Passes::Lowering
 {
+    // 与 RV64 的实现一致，区别在于分支目标保存在 LabelOperand 中
+    // 注意 AArch64::createMove 会直接生成目标 mov，这里的拷贝需要使用 BE::createMove 生成伪指令，交给寄存器分配处理
     using namespace BE;
 
+    std::vector<PhiInst*> PhiEliminationPass::collectPhis(BE::Block* block)
+    {
+        std::vector<PhiInst*> phis;
+        for (auto* inst : block->insts)
+            if (inst && inst->kind == InstKind::PHI) phis.push_back(static_cast<PhiInst*>(inst));
+        return phis;
+    }
+
+    // 将 PHI 指令按前驱块分组：predLabel -> [(dst, src), ...]
+    std::map<uint32_t, PhiEliminationPass::CopyList> PhiEliminationPass::aggregateCopies(
+        const std::vector<PhiInst*>& phis)
+    {
+        std::map<uint32_t, CopyList> copiesPerPred;
+        for (auto* phi : phis)
+            for (auto& [predLabel, srcOp] : phi->incomingVals) copiesPerPred[predLabel].push_back({phi->resReg, srcOp});
+        return copiesPerPred;
+    }
+
+    /**
+     * 关键边分裂：前驱块以 b.cond / cbz / cbnz 跳到当前块时，拷贝不能放在前驱块里，
+     * 否则会污染另一条出边。插入中间块，让条件跳转指向它，再由它跳转到原目标。
+     */
+    BE::Block* PhiEliminationPass::splitCriticalEdge(BE::Function* func, BE::Block* predBlock, uint32_t blockId,
+        const BE::Targeting::TargetInstrAdapter* adapter)
+    {
+        auto& insts = predBlock->insts;
+        for (size_t i = 0; i < insts.size(); ++i)
+        {
+            auto* ai = dynamic_cast<AArch64::Instr*>(insts[i]);
+            if (!ai || !adapter->isCondBranch(ai)) continue;
+            if (adapter->extractBranchTarget(ai) != static_cast<int>(blockId)) continue;
+
+            uint32_t newId     = func->blocks.rbegin()->first + 1;
+            auto*    edgeBlock = new BE::Block(newId);
+
+            for (auto* op : ai->operands)
+                if (auto* lb = dynamic_cast<LabelOperand*>(op)) lb->targetBlockId = static_cast<int>(newId);
+
+            edgeBlock->insts.push_back(createBranch(Operator::B, static_cast<int>(blockId)));
+
+            func->blocks[newId] = edgeBlock;
+            return edgeBlock;
+        }
+        return predBlock;
+    }
+
+    // 拷贝插入到末尾的无条件跳转或返回之前；条件跳转经过关键边分裂后不再指向当前块
+    size_t PhiEliminationPass::findInsertIndex(BE::Block* predBlock, const BE::Targeting::TargetInstrAdapter* adapter)
+    {
+        size_t n = predBlock->insts.size();
+        if (n == 0) return 0;
+
+        auto* last = predBlock->insts.back();
+        if (adapter->isUncondBranch(last) || adapter->isReturn(last)) return n - 1;
+        return n;
+    }
+
+    bool PhiEliminationPass::isDestUsedAsSrc(const Register& dst, const CopyList& copies)
+    {
+        for (auto& [_, srcOp] : copies)
+            if (auto* srcReg = dynamic_cast<RegOperand*>(srcOp))
+                if (srcReg->reg == dst) return true;
+        return false;
+    }
+
+    bool PhiEliminationPass::removeSelfCopies(CopyList& copies)
+    {
+        size_t before = copies.size();
+        for (auto it = copies.begin(); it != copies.end();)
+        {
+            auto* srcReg = dynamic_cast<RegOperand*>(it->second);
+            if (srcReg && srcReg->reg == it->first)
+                it = copies.erase(it);
+            else
+                ++it;
+        }
+        return copies.size() < before;
+    }
+
+    /**
+     * 并行拷贝消解：先执行目标不被其它拷贝读取的拷贝，剩下的只可能是环，用临时寄存器打破
+     */
+    std::vector<MInstruction*> PhiEliminationPass::resolveParallelCopies(CopyList copies)
+    {
+        std::vector<MInstruction*> result;
+
+        while (!copies.empty())
+        {
+            if (removeSelfCopies(copies)) continue;
+
+            bool found = false;
+            for (auto it = copies.begin(); it != copies.end(); ++it)
+            {
+                if (!isDestUsedAsSrc(it->first, copies))
+                {
+                    result.push_back(BE::createMove(new RegOperand(it->first), it->second, "phi-elim"));
+                    copies.erase(it);
+                    found = true;
+                    break;
+                }
+            }
+            if (found) continue;
+
+            std::map<Register, Register> destToSrc;
+            for (auto& [dst, srcOp] : copies)
+                if (auto* srcReg = dynamic_cast<RegOperand*>(srcOp)) destToSrc[dst] = srcReg->reg;
+
+            Register              start = destToSrc.begin()->first;
+            Register              cur   = start;
+            std::vector<Register> cycle;
+            do {
+                cycle.push_back(cur);
+                cur = destToSrc[cur];
+            } while (!(cur == start));
+
+            Register tmp = getVReg(cycle.front().dt);
+            result.push_back(BE::createMove(new RegOperand(tmp), new RegOperand(cycle.front()), "phi-cycle"));
+            for (size_t i = 0; i + 1 < cycle.size(); ++i)
+                result.push_back(
+                    BE::createMove(new RegOperand(cycle[i]), new RegOperand(destToSrc[cycle[i]]), "phi-cycle"));
+            result.push_back(BE::createMove(new RegOperand(cycle.back()), new RegOperand(tmp), "phi-cycle"));
+
+            std::set<Register> cycleSet(cycle.begin(), cycle.end());
+            for (auto it = copies.begin(); it != copies.end();)
+            {
+                if (cycleSet.count(it->first))
+                    it = copies.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        return result;
+    }
+
     void PhiEliminationPass::runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter)
     {
-        if (module.functions.empty()) return;
-        for (auto* func : module.functions) runOnFunction(func, adapter);
+        for (auto* func : module.functions)
+        {
+            VRegScope vregScope(func);
+            runOnFunction(func, adapter);
+        }
     }
 
     void PhiEliminationPass::runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter)
     {
-        TODO("(如果你在中端实现了mem2reg)实现 Phi Elimination");
+        if (!func || func->blocks.empty()) return;
+
+        for (auto& [blockId, block] : func->blocks)
+        {
+            if (!block) continue;
+
+            auto phis = collectPhis(block);
+            if (phis.empty()) continue;
+
+            auto copiesPerPred = aggregateCopies(phis);
+            for (auto& [predLabel, copies] : copiesPerPred)
+            {
+                auto predIt = func->blocks.find(predLabel);
+                if (predIt == func->blocks.end() || !predIt->second) continue;
+
+                BE::Block* predBlock = splitCriticalEdge(func, predIt->second, blockId, adapter);
+                size_t     insertIdx = findInsertIndex(predBlock, adapter);
+                auto       newInsts  = resolveParallelCopies(std::move(copies));
+                predBlock->insts.insert(predBlock->insts.begin() + insertIdx, newInsts.begin(), newInsts.end());
+            }
+
+            std::deque<MInstruction*> filtered;
+            for (auto* inst : block->insts)
+                if (!inst || inst->kind != InstKind::PHI) filtered.push_back(inst);
+            block->insts = std::move(filtered);
+        }
     }
 }  // namespace BE::AArch64::Passes::Lowering
@@ -5,12 +5,9 @@
 #include <backend/mir/m_function.h>
 #include <backend/mir/m_block.h>
 #include <backend/mir/m_instruction.h>
-#include <backend/common/cfg.h>
-#include <backend/common/cfg_builder.h>
 #include <backend/target/target_instr_adapter.h>
 #include <backend/targets/aarch64/aarch64_defs.h>
 #include <map>
-#include <queue>
 #include <vector>
 
 namespace BE::AArch64::Passes::Lowering
@@ -24,18 +21,18 @@ namespace BE::AArch64::Passes::Lowering
         void runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter);
 
       private:
-        void runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter);
-
-        [[maybe_unused]] void splitCriticalEdgesForBlock(BE::Function* func, BE::MIR::CFG* cfg, uint32_t toLabel);
-        [[maybe_unused]] void redirectEdgeBranch(
-            BE::Function* func, uint32_t fromLabel, uint32_t oldTo, uint32_t newTo);
-
-        [[maybe_unused]] std::deque<BE::MInstruction*>::iterator findInsertPoint(
-            BE::Block* block, const BE::Targeting::TargetInstrAdapter* adapter);
-
-        [[maybe_unused]] void insertPhiCopiesForPred(BE::Function* func, BE::Block* predBlock,
-            const std::vector<std::pair<BE::Register, BE::Operand*>>& copies,
-            const BE::Targeting::TargetInstrAdapter*                  adapter);
+        // 一个前驱块可能对应多个 PHI 的拷贝（多个 PHI 指令共享同一前驱）
+        using CopyList = std::vector<std::pair<Register, Operand*>>;
+
+        void                         runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter);
+        std::vector<PhiInst*>        collectPhis(BE::Block* block);
+        std::map<uint32_t, CopyList> aggregateCopies(const std::vector<PhiInst*>& phis);
+        BE::Block*                   splitCriticalEdge(BE::Function* func, BE::Block* predBlock, uint32_t blockId,
+                              const BE::Targeting::TargetInstrAdapter* adapter);
+        size_t findInsertIndex(BE::Block* predBlock, const BE::Targeting::TargetInstrAdapter* adapter);
+        bool   isDestUsedAsSrc(const Register& dst, const CopyList& copies);
+        bool   removeSelfCopies(CopyList& copies);
+        std::vector<MInstruction*> resolveParallelCopies(CopyList copies);
     };
 }  // namespace BE::AArch64::Passes::Lowering
 
@@ -4,9 +4,64 @@
 #include <backend/mir/m_block.h>
 #include <backend/mir/m_function.h>
 #include <backend/mir/m_instruction.h>
+#include <debug.h>
+#include <cstring>
 
 namespace BE::AArch64::Passes::Lowering
 {
+    namespace
+    {
+        inline int accessSize(const Register& r)
+        {
+            if (r.dt == F32) return 4;
+            return is64BitReg(r) ? 8 : 4;
+        }
+
+        // 溢出槽访存：偏移可直接编码时用 [sp, #off]，否则偏移先装入 x16
+        void emitSlotAccess(Operator op, Register rt, int offset, std::deque<MInstruction*>& out)
+        {
+            if (fitsMemOffset(offset, accessSize(rt)))
+            {
+                out.push_back(createMemInst(op, rt, new MemOperand(PR::sp, offset)));
+                return;
+            }
+            emitMovImm(out, PR::x16, offset);
+            out.push_back(createMemInst(op, rt, new MemOperand(PR::sp, PR::x16, Extend::LSL, 0)));
+        }
+
+        // 物理寄存器间的拷贝；源寄存器按目标宽度取视图，同一寄存器的拷贝直接省去
+        void emitRegMove(Register dst, Register src, std::deque<MInstruction*>& out)
+        {
+            bool dstFloat = isFloatReg(dst), srcFloat = isFloatReg(src);
+            if (dstFloat == srcFloat)
+            {
+                if (dst.rId == src.rId) return;
+                out.push_back(createR2Inst(Operator::MOV, dst, Register(src.rId, dst.dt, false)));
+                return;
+            }
+            // 整数与浮点寄存器之间按位搬运
+            out.push_back(createR2Inst(Operator::FMOV, dst, src));
+        }
+
+        void emitFloatImm(Register dst, float value, std::deque<MInstruction*>& out)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            if (bits == 0)
+            {
+                out.push_back(createR2Inst(Operator::FMOV, dst, PR::wzr));
+                return;
+            }
+            if (isFMovImm(value))
+            {
+                out.push_back(createInstr2(Operator::FMOV, new RegOperand(dst), new F32Operand(value)));
+                return;
+            }
+            emitMovImm(out, PR::w16, static_cast<int32_t>(bits));
+            out.push_back(createR2Inst(Operator::FMOV, dst, PR::w16));
+        }
+    }  // namespace
+
     void StackLoweringPass::runOnModule(BE::Module& module)
     {
         for (auto* func : module.functions)
@@ -16,5 +71,64 @@ namespace BE::AArch64::Passes::Lowering
         }
     }
 
-    void StackLoweringPass::lowerFunction(BE::Function* func) { TODO("实现 Stack Lowering"); }
+    // 展开溢出槽伪指令与 MOVE 伪指令（此时栈帧布局已由 FrameLowering 确定）
+    void StackLoweringPass::lowerFunction(BE::Function* func)
+    {
+        for (auto& [bid, block] : func->blocks)
+        {
+            std::deque<MInstruction*> newInsts;
+            for (auto* inst : block->insts)
+            {
+                if (!inst) continue;
+
+                switch (inst->kind)
+                {
+                    case InstKind::LSLOT:
+                    {
+                        auto* fiLoad = static_cast<FILoadInst*>(inst);
+                        emitSlotAccess(Operator::LDR,
+                            fiLoad->dest,
+                            func->frameInfo.getSpillSlotOffset(fiLoad->frameIndex),
+                            newInsts);
+                        delete fiLoad;
+                        continue;
+                    }
+                    case InstKind::SSLOT:
+                    {
+                        auto* fiStore = static_cast<FIStoreInst*>(inst);
+                        emitSlotAccess(Operator::STR,
+                            fiStore->src,
+                            func->frameInfo.getSpillSlotOffset(fiStore->frameIndex),
+                            newInsts);
+                        delete fiStore;
+                        continue;
+                    }
+                    case InstKind::MOVE:
+                    {
+                        auto* mvInst = static_cast<MoveInst*>(inst);
+                        auto* dstOp  = dynamic_cast<RegOperand*>(mvInst->dest);
+                        // 目标仍为虚拟寄存器说明该值未被使用，直接删除
+                        if (dstOp && !dstOp->reg.isVreg)
+                        {
+                            Register dst = dstOp->reg;
+                            if (auto* srcReg = dynamic_cast<RegOperand*>(mvInst->src))
+                                emitRegMove(dst, srcReg->reg, newInsts);
+                            else if (auto* imm = dynamic_cast<I32Operand*>(mvInst->src))
+                                emitMovImm(newInsts, dst, imm->val);
+                            else if (auto* fImm = dynamic_cast<F32Operand*>(mvInst->src))
+                                emitFloatImm(dst, fImm->val, newInsts);
+                            else
+                                ERROR("Unsupported MOVE source operand");
+                        }
+                        delete mvInst;
+                        continue;
+                    }
+                    default: break;
+                }
+
+                newInsts.push_back(inst);
+            }
+            block->insts.swap(newInsts);
+        }
+    }
 }  // namespace BE::AArch64::Passes::Lowering
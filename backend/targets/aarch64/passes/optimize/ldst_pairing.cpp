@@ -0,0 +1,90 @@
+#include <backend/targets/aarch64/passes/optimize/ldst_pairing.h>
+#include <debug.h>
+
+namespace BE::AArch64::Passes::Optimize
+{
+    namespace
+    {
+        inline int accessSize(const Register& r)
+        {
+            if (r.dt == F32) return 4;
+            return is64BitReg(r) ? 8 : 4;
+        }
+
+        // 可参与配对的 ldr/str：[base, #imm] 形式且不带写回
+        MemOperand* pairableMem(Instr* inst)
+        {
+            if (inst->op != Operator::LDR && inst->op != Operator::STR) return nullptr;
+            if (inst->use_fiops || inst->operands.size() != 2) return nullptr;
+            auto* mem = dynamic_cast<MemOperand*>(inst->operands[1]);
+            if (!mem || mem->hasIndex || mem->mode != AddrMode::Offset) return nullptr;
+            return mem;
+        }
+    }  // namespace
+
+    void LdStPairingPass::runOnModule(BE::Module& module)
+    {
+        for (auto* func : module.functions)
+        {
+            if (!func) continue;
+            for (auto& [bid, block] : func->blocks) runOnBlock(block);
+        }
+    }
+
+    Instr* LdStPairingPass::tryPair(Instr* first, Instr* second)
+    {
+        if (first->op != second->op) return nullptr;
+        MemOperand* m1 = pairableMem(first);
+        MemOperand* m2 = pairableMem(second);
+        if (!m1 || !m2 || m1->base.rId != m2->base.rId) return nullptr;
+
+        Register r1 = static_cast<RegOperand*>(first->operands[0])->reg;
+        Register r2 = static_cast<RegOperand*>(second->operands[0])->reg;
+        if (isFloatReg(r1) != isFloatReg(r2)) return nullptr;
+        int size = accessSize(r1);
+        if (accessSize(r2) != size) return nullptr;
+
+        bool isLoad = first->op == Operator::LDR;
+        // 第一条 ldr 改写了基址时第二条的地址已经变化；ldp 的两个目标不能相同
+        if (isLoad && (r1.rId == m1->base.rId || r1.rId == r2.rId)) return nullptr;
+
+        int lowOff;
+        Register lo, hi;
+        if (m2->offset == m1->offset + size)
+            lowOff = m1->offset, lo = r1, hi = r2;
+        else if (m1->offset == m2->offset + size)
+            lowOff = m2->offset, lo = r2, hi = r1;
+        else
+            return nullptr;
+        if (lowOff % size != 0 || lowOff / size < -64 || lowOff / size > 63) return nullptr;
+
+        return createInstr3(isLoad ? Operator::LDP : Operator::STP,
+            new RegOperand(lo),
+            new RegOperand(hi),
+            new MemOperand(m1->base, lowOff));
+    }
+
+    void LdStPairingPass::runOnBlock(BE::Block* block)
+    {
+        std::deque<MInstruction*> newInsts;
+        auto&                     insts = block->insts;
+        for (size_t i = 0; i < insts.size(); ++i)
+        {
+            if (i + 1 < insts.size() && insts[i]->kind == InstKind::TARGET && insts[i + 1]->kind == InstKind::TARGET)
+            {
+                auto* first  = static_cast<Instr*>(insts[i]);
+                auto* second = static_cast<Instr*>(insts[i + 1]);
+                if (Instr* paired = tryPair(first, second))
+                {
+                    newInsts.push_back(paired);
+                    delete first;
+                    delete second;
+                    ++i;
+                    continue;
+                }
+            }
+            newInsts.push_back(insts[i]);
+        }
+        insts.swap(newInsts);
+    }
+}  // namespace BE::AArch64::Passes::Optimize
@@ -0,0 +1,32 @@
+#ifndef __BACKEND_AARCH64_PASSES_OPTIMIZE_LDST_PAIRING_H__
+#define __BACKEND_AARCH64_PASSES_OPTIMIZE_LDST_PAIRING_H__
+
+#include <backend/mir/m_module.h>
+#include <backend/mir/m_function.h>
+#include <backend/mir/m_block.h>
+#include <backend/targets/aarch64/aarch64_defs.h>
+
+/*
+ * 访存配对（Post-RA，栈降低之后运行）
+ *
+ * 把相邻的两条同基址、同宽度、偏移相差一个访问宽度的 ldr/str 合并为 ldp/stp：
+ *   ldr w1, [x0, #8]; ldr w2, [x0, #12]  =>  ldp w1, w2, [x0, #8]
+ * 要求较低的偏移满足 7 位有符号缩放立即数；对 ldr，第一条的目标不能是基址，两条目标不能相同。
+ */
+namespace BE::AArch64::Passes::Optimize
+{
+    class LdStPairingPass
+    {
+      public:
+        LdStPairingPass()  = default;
+        ~LdStPairingPass() = default;
+
+        void runOnModule(BE::Module& module);
+
+      private:
+        void   runOnBlock(BE::Block* block);
+        Instr* tryPair(Instr* first, Instr* second);
+    };
+}  // namespace BE::AArch64::Passes::Optimize
+
+#endif  // __BACKEND_AARCH64_PASSES_OPTIMIZE_LDST_PAIRING_H__
@@ -1,4 +1,5 @@
 #include <backend/targets/riscv64/isel/rv64_dag_isel.h>
+#include <backend/targets/riscv64/isel/rv64_isel_utils.h>
 #include <backend/target/target.h>
 #include <backend/dag/selection_dag.h>
 #include <backend/dag/isd.h>
@@ -16,54 +17,6 @@ namespace BE::RV64
 {
     [[maybe_unused]]static inline bool imm12(int imm) { return imm >= -2048 && imm <= 2047; }
 
-    // 获取Load操作码
-    static Operator getLoadOpForType(BE::DataType* dt)
-    {
-        // 获取数据长度，若类型缺失则默认为 32 位（SysY 整数为 32 位，防止 64 位操作覆盖相邻数据）
-        BE::DataType::Length len;
-        if (dt)
-            len = dt->dl;
-        else
-            len = BE::DataType::Length::B32;
-        // 如果数据类型是浮点型
-        if (dt && dt->dt == BE::DataType::Type::FLOAT)
-        {
-            // 32 位返回 FLW，否则返回 FLD
-            if (len == BE::DataType::Length::B32)
-                return Operator::FLW;
-            else
-                return Operator::FLD;
-        }
-        // 32 位返回 LW，否则返回 LD
-        if (len == BE::DataType::Length::B32)
-            return Operator::LW;
-        else
-            return Operator::LD;
-    }
-
-    //获取Store操作码
-    static Operator getStoreOpForType(BE::DataType* dt)
-    {
-        BE::DataType::Length len;
-        if (dt)
-            len = dt->dl;
-        else
-            len = BE::DataType::Length::B32;
-
-        if (dt && dt->dt == BE::DataType::Type::FLOAT)
-        {
-            if (len == BE::DataType::Length::B32)
-                return Operator::FSW;
-            else
-                return Operator::FSD;
-        }
-
-        if (len == BE::DataType::Length::B32)
-            return Operator::SW;
-        else
-            return Operator::SD;
-    }
-
     // ============================================================================
         // TODO: 实现 DAG 调度
         // ============================================================================
@@ -81,12 +34,15 @@ namespace BE::RV64
     std::vector<const DAG::SDNode*> DAGIsel::scheduleDAG(const DAG::SelectionDAG& dag)
     {
         std::vector<const DAG::SDNode*> result;
-        std::set<const DAG::SDNode*> visited;
+        result.reserve(dag.getNodes().size());
+        numbering_.reset(dag);
+        DAG::NodeSet visited(numbering_);
+        visited.clear();
 
         // 从所有节点开始遍历（确保不遗漏任何节点）
         for (const auto* node : dag.getNodes())
         {
-            postOrderHelper(node, visited, result);  // 调用辅助函数
+            postOrderHelper(node, numbering_, visited, result);  // 调用辅助函数
         }
 
         return result;
@@ -127,6 +83,112 @@ namespace BE::RV64
         nodeToVReg_[node] = vreg;
     }
 
+    int DAGIsel::crossBlockUses(const DAG::SDNode* node) const
+    {
+        if (!node->hasIRRegId() || !ctx_.crossBlockUses) return 0;
+        auto it = ctx_.crossBlockUses->find(node->getIRRegId());
+        return it == ctx_.crossBlockUses->end() ? 0 : it->second;
+    }
+
+    bool DAGIsel::isFoldedAddress(const DAG::SDNode* node, const UserMap& users)
+    {
+        if (static_cast<DAG::ISD>(node->getOpcode()) != DAG::ISD::ADD) return false;
+
+        const auto* nodeUsers = users.lookup(node);
+        if (!nodeUsers || nodeUsers->empty()) return false;
+        // 仍被其它块以寄存器方式引用时必须生成
+        if (crossBlockUses(node) != 0) return false;
+
+        for (auto& [user, idx] : *nodeUsers)
+        {
+            auto opc = static_cast<DAG::ISD>(user->getOpcode());
+            if (!(opc == DAG::ISD::LOAD && idx == 1) && !(opc == DAG::ISD::STORE && idx == 2)) return false;
+        }
+
+        const DAG::SDNode* base   = nullptr;
+        int64_t            offset = 0;
+        return selectAddress(node, base, offset) && base != node && offset >= -2048 && offset <= 2047;
+    }
+
+    void DAGIsel::markFoldedNodes(const std::vector<const DAG::SDNode*>& scheduled)
+    {
+        // ============================================================================
+        // 折叠分析：标记不需要单独生成指令的节点（预先放入 selected_）
+        // ============================================================================
+        //
+        // - 只被条件分支使用的 ICMP：由分支直接生成 B<cc>（含扩展基本块中从前驱重建的比较）
+        // - 只作为访存地址且能折叠为 base + imm 的 ADD
+        // - 所有引用都已在后继块中重建的纯计算（扩展基本块模式下前驱中的原定义）
+        // - 被移位加等融合模式覆盖的 SHL
+        fusedCompares_.clear();
+        foldableShl_.clear();
+        if (!ctx_.crossBlockUses) return;
+
+        UserMap users(numbering_);
+        users.clear();
+        for (const auto* node : scheduled)
+            for (unsigned i = 0; i < node->getNumOperands(); ++i)
+                if (const auto* op = node->getOperand(i).getNode()) users[op].push_back({node, i});
+
+        auto userCount = [&users](const DAG::SDNode* n) {
+            const auto* u = users.lookup(n);
+            return u ? static_cast<int>(u->size()) : 0;
+        };
+
+        for (const auto* node : scheduled)
+        {
+            if (static_cast<DAG::ISD>(node->getOpcode()) != DAG::ISD::SHL || userCount(node) != 1) continue;
+            if (crossBlockUses(node) != 0) continue;
+            foldableShl_.insert(node);
+        }
+
+        for (const auto* node : scheduled)
+        {
+            auto opcode = static_cast<DAG::ISD>(node->getOpcode());
+            if (opcode == DAG::ISD::BRCOND)
+            {
+                const DAG::SDNode* cond = node->getOperand(node->getNumOperands() == 3 ? 0 : 1).getNode();
+                if (cond && static_cast<DAG::ISD>(cond->getOpcode()) == DAG::ISD::ICMP && userCount(cond) == 1 &&
+                    crossBlockUses(cond) == 0)
+                {
+                    fusedCompares_.insert(cond);
+                    selected_.insert(cond);
+                }
+                continue;
+            }
+
+            switch (opcode)
+            {
+                case DAG::ISD::COPY:
+                case DAG::ISD::ICMP:
+                case DAG::ISD::FCMP:
+                case DAG::ISD::ADD:
+                case DAG::ISD::SUB:
+                case DAG::ISD::MUL:
+                case DAG::ISD::AND:
+                case DAG::ISD::OR:
+                case DAG::ISD::XOR:
+                case DAG::ISD::SHL:
+                case DAG::ISD::ASHR:
+                case DAG::ISD::LSHR:
+                    if (node->hasIRRegId() && userCount(node) == 0 && crossBlockUses(node) == 0)
+                        selected_.insert(node);
+                    else if (isFoldedAddress(node, users))
+                        selected_.insert(node);
+                    break;
+                default: break;
+            }
+        }
+
+        // 仅当使用者实际选中了覆盖它的模式时，SHL 才无需单独生成
+        for (const auto* node : scheduled)
+        {
+            if (static_cast<DAG::ISD>(node->getOpcode()) != DAG::ISD::ADD || selected_.count(node)) continue;
+            PatternMatch m;
+            if (matchPattern(node, m) && m.covered) selected_.insert(m.covered);
+        }
+    }
+
     Register DAGIsel::getOperandReg(const DAG::SDNode* node, BE::Block* m_block)
     {
         // ============================================================================
@@ -144,8 +206,7 @@ namespace BE::RV64
 
         auto opcode = static_cast<DAG::ISD>(node->getOpcode());
 
-        auto it = nodeToVReg_.find(node);
-        if (it != nodeToVReg_.end()) return it->second;
+        if (const Register* r = nodeToVReg_.lookup(node)) return *r;
 
         if (opcode == DAG::ISD::REG && node->hasIRRegId())
             return getOrCreateVReg(node->getIRRegId(), node->getNumValues() > 0 ? node->getValueType(0) : BE::I32);
@@ -223,8 +284,7 @@ namespace BE::RV64
             return addrReg;
         }
 
-        auto it = nodeToVReg_.find(node);
-        if (it != nodeToVReg_.end()) return it->second;
+        if (const Register* r = nodeToVReg_.lookup(node)) return *r;
 
         if (opcode == DAG::ISD::REG && node->hasIRRegId())
             return getOrCreateVReg(node->getIRRegId(), node->getNumValues() > 0 ? node->getValueType(0) : BE::I64);
@@ -257,49 +317,6 @@ namespace BE::RV64
         return vreg;
     }
 
-    void DAGIsel::importGlobals()
-    {
-        // 遍历 IR 模块中的所有全局变量
-        for (auto* glb : ir_module_->globalVars)
-        {
-            // 转换类型: ME::DataType -> BE::DataType
-            BE::DataType* beType = BE::I32;  // 默认 I32
-            if (glb->dt == ME::DataType::F32)
-                beType = BE::F32;
-            else if (glb->dt == ME::DataType::I64 || glb->dt == ME::DataType::PTR)
-                beType = BE::I64;
-
-            // 创建后端全局变量对象
-            auto* gv = new BE::GlobalVariable(beType, glb->name);
-
-            // 处理数组维度
-            gv->dims = glb->initList.arrayDims;
-
-            // 处理初始化值
-            if (glb->init)
-            {
-                // 标量初始化
-                if (auto* immI32 = dynamic_cast<ME::ImmeI32Operand*>(glb->init))
-                    gv->initVals.push_back(immI32->value);
-                else if (auto* immF32 = dynamic_cast<ME::ImmeF32Operand*>(glb->init))
-                    gv->initVals.push_back(FLOAT_TO_INT_BITS(immF32->value));
-            }
-            else if (!glb->initList.initList.empty())
-            {
-                // 数组初始化列表
-                for (const auto& val : glb->initList.initList)
-                {
-                    if (val.type == FE::AST::floatType)
-                        gv->initVals.push_back(FLOAT_TO_INT_BITS(val.floatValue));
-                    else
-                        gv->initVals.push_back(val.intValue);
-                }
-            }
-
-            m_backend_module->globals.push_back(gv);
-        }
-    }
-
     void DAGIsel::collectAllocas(ME::Function* ir_func)
     {
         // 遍历函数所有基本块中的指令
@@ -464,9 +481,8 @@ namespace BE::RV64
                 else
                 {
                     // 已调度节点，从 nodeToVReg_ 获取
-                    auto it = nodeToVReg_.find(valNode);
-                    if (it != nodeToVReg_.end())
-                        srcOp = new RegOperand(it->second);
+                    if (const Register* r = nodeToVReg_.lookup(valNode))
+                        srcOp = new RegOperand(*r);
                     else
                         continue;
                 }
@@ -478,113 +494,212 @@ namespace BE::RV64
         m_block->insts.push_back(phi);
     }
 
-    void DAGIsel::selectBinary(const DAG::SDNode* node, BE::Block* m_block)
+    namespace
     {
-        if (node->getNumOperands() < 2) return;
-
-        auto opcode = static_cast<DAG::ISD>(node->getOpcode());
-
-        Register dst = nodeToVReg_.at(node);
+        using ISelPattern::Emit;
+        using ISelPattern::Leaf;
+        using ISelPattern::Ty;
 
-        const DAG::SDNode* lhs = node->getOperand(0).getNode();
-        const DAG::SDNode* rhs = node->getOperand(1).getNode();
+        bool constValue(const DAG::SDNode* n, int64_t& val)
+        {
+            auto opc = static_cast<DAG::ISD>(n->getOpcode());
+            if ((opc != DAG::ISD::CONST_I32 && opc != DAG::ISD::CONST_I64) || !n->hasImmI64()) return false;
+            val = n->getImmI64();
+            return true;
+        }
 
-        Register lhsReg;
-        auto     lhsOp = static_cast<DAG::ISD>(lhs->getOpcode());
+        Ty nodeTy(const DAG::SDNode* node)
+        {
+            if (static_cast<DAG::ISD>(node->getOpcode()) == DAG::ISD::ICMP) return Ty::Any;
+            BE::DataType* dt = node->getNumValues() > 0 ? node->getValueType(0) : BE::I64;
+            if (dt == BE::F32 || dt == BE::F64) return Ty::F32;
+            return dt == BE::I32 ? Ty::I32 : Ty::I64;
+        }
 
-        bool isAllocaReg = false;
-        int  allocaFI    = -1;
-        if (lhsOp == DAG::ISD::REG && lhs->hasIRRegId())
+        // li 伪指令的展开代价：addi / lui / lui+addiw
+        int liCost(int64_t val)
         {
-            auto it = ctx_.allocaFI.find(lhs->getIRRegId());
-            if (it != ctx_.allocaFI.end())
-            {
-                isAllocaReg = true;
-                allocaFI    = it->second;
-            }
+            if (val >= -2048 && val <= 2047) return getOpLatency(Operator::LI);
+            if ((val & 0xfff) == 0) return getOpLatency(Operator::LUI);
+            return getOpLatency(Operator::LUI) + getOpLatency(Operator::ADDIW);
         }
 
-        if (lhsOp == DAG::ISD::SYMBOL)
-            lhsReg = materializeAddress(lhs, m_block);
-        else if (lhsOp == DAG::ISD::FRAME_INDEX || isAllocaReg)
+        bool isRegLeaf(Leaf l)
         {
-            lhsReg            = getVReg(BE::I64);
-            int    fi         = isAllocaReg ? allocaFI : lhs->getFrameIndex();
-            Instr* addrInst   = createIInst(Operator::ADDI, lhsReg, PR::sp, 0);
-            addrInst->fiop    = new FrameIndexOperand(fi);
-            addrInst->use_ops = true;
-            m_block->insts.push_back(addrInst);
+            return l == Leaf::Reg || l == Leaf::Shl1 || l == Leaf::Shl2 || l == Leaf::Shl3;
         }
-        else
-            lhsReg = getOperandReg(lhs, m_block);
 
-        Register rhsReg;
-        int      rhsImm     = 0;
-        bool     isRhsConst = false;
+        int regLeaves(const ISelPattern::Pattern& p) { return isRegLeaf(p.lhs) + isRegLeaf(p.rhs); }
 
-        auto rhsOp = static_cast<DAG::ISD>(rhs->getOpcode());
-        if (rhsOp == DAG::ISD::CONST_I32 && rhs->hasImmI64())
+        int log2Exact(int64_t v)
         {
-            rhsImm     = static_cast<int>(rhs->getImmI64());
-            isRhsConst = true;
+            int k = 0;
+            while ((int64_t(1) << k) < v) ++k;
+            return k;
         }
-        else
-            rhsReg = getOperandReg(rhs, m_block);
-
-        Operator op;
-        bool     isFloat =
-            (node->getNumValues() > 0 && (node->getValueType(0) == BE::F32 || node->getValueType(0) == BE::F64));
-        bool is32bit = (dst.dt == BE::I32);
+    }  // namespace
 
-        switch (opcode)
+    bool DAGIsel::matchLeaf(ISelPattern::Leaf leaf, ISelPattern::Ty ty, const DAG::SDNode* n,
+        const DAG::SDNode*& bound, int64_t& imm, int& cost) const
+    {
+        int64_t v     = 0;
+        bool    isImm = constValue(n, v);
+        switch (leaf)
         {
-            case DAG::ISD::ADD: op = isFloat ? Operator::FADD_S : (is32bit ? Operator::ADDW : Operator::ADD); break;
-            case DAG::ISD::SUB: op = isFloat ? Operator::FSUB_S : (is32bit ? Operator::SUBW : Operator::SUB); break;
-            case DAG::ISD::MUL: op = isFloat ? Operator::FMUL_S : (is32bit ? Operator::MULW : Operator::MUL); break;
-            case DAG::ISD::DIV: op = isFloat ? Operator::FDIV_S : (is32bit ? Operator::DIVW : Operator::DIV); break;
-            case DAG::ISD::FADD: op = Operator::FADD_S; break;
-            case DAG::ISD::FSUB: op = Operator::FSUB_S; break;
-            case DAG::ISD::FMUL: op = Operator::FMUL_S; break;
-            case DAG::ISD::FDIV: op = Operator::FDIV_S; break;
-            case DAG::ISD::MOD: op = is32bit ? Operator::REMW : Operator::REM; break;
-            case DAG::ISD::AND: op = Operator::AND; break;
-            case DAG::ISD::OR: op = Operator::OR; break;
-            case DAG::ISD::XOR: op = Operator::XOR; break;
-            case DAG::ISD::SHL: op = Operator::SLL; break;
-            case DAG::ISD::ASHR: op = Operator::SRA; break;
-            case DAG::ISD::LSHR: op = Operator::SRL; break;
-            default: ERROR("Unsupported binary operator: %d", node->getOpcode()); return;
+            case Leaf::Reg:
+            {
+                bound = n;
+                // 单使用者的 SHL 若不被覆盖需单独生成，未被覆盖的常量需要单独实例化
+                if (foldableShl_.count(n))
+                    cost += getOpLatency(Operator::SLLI);
+                else if (nodeToVReg_.count(n))
+                    return true;
+                else if (isImm && v != 0)
+                    cost += liCost(v);
+                else if (static_cast<DAG::ISD>(n->getOpcode()) == DAG::ISD::CONST_F32)
+                    cost += getOpLatency(Operator::LI) + getOpLatency(Operator::FMV_W_X);
+                return true;
+            }
+            case Leaf::Zero: return isImm && v == 0;
+            case Leaf::Imm12: imm = v; return isImm && imm12(static_cast<int>(v)) && v == static_cast<int>(v);
+            case Leaf::NegImm12: imm = v; return isImm && v >= -2047 && v <= 2048;
+            case Leaf::IncImm12: imm = v; return isImm && v >= -2049 && v <= 2046;
+            case Leaf::ShAmt: imm = v; return isImm && v >= 0 && v < (ty == Ty::I32 ? 32 : 64);
+            case Leaf::Pow2:
+                imm = v;
+                return isImm && v > 0 && (v & (v - 1)) == 0 && v <= (ty == Ty::I32 ? (int64_t(1) << 30) : (int64_t(1) << 62));
+            case Leaf::Shl1:
+            case Leaf::Shl2:
+            case Leaf::Shl3:
+            {
+                int64_t amt = 0;
+                if (!foldableShl_.count(n) || !constValue(n->getOperand(1).getNode(), amt)) return false;
+                if (amt != static_cast<int>(leaf) - static_cast<int>(Leaf::Shl1) + 1) return false;
+                bound = n->getOperand(0).getNode();
+                return true;
+            }
         }
+        return false;
+    }
 
-        if (isRhsConst)
+    bool DAGIsel::matchPattern(const DAG::SDNode* node, PatternMatch& best) const
+    {
+        // ============================================================================
+        // 模式匹配：枚举模式表中根操作码相同的所有条目，取覆盖代价最小者
+        // ============================================================================
+        //
+        // 代价 = 模式生成的指令延迟 + 未被覆盖、仍需单独生成的子节点（常量实例化、SHL）
+        // 因此能吃掉更多子节点的模式（立即数形式、移位加）在代价上自然胜出；
+        // 代价相同时取表中靠前的条目。
+        if (node->getNumOperands() < 2) return false;
+
+        auto               opcode = static_cast<DAG::ISD>(node->getOpcode());
+        int                cond   = node->hasImmI64() ? static_cast<int>(node->getImmI64()) : 0;
+        Ty                 ty     = nodeTy(node);
+        const DAG::SDNode* ops[2] = {node->getOperand(0).getNode(), node->getOperand(1).getNode()};
+
+        best.pat = nullptr;
+        for (const auto& pat : ISelPattern::kPatterns)
         {
-            bool     is32bit = (dst.dt == BE::I32);
-            Operator iop;
-            bool     hasImmForm = true;
+            if (pat.op != opcode || pat.ty != ty) continue;
+            if (pat.cond != ISelPattern::kAnyCond && pat.cond != cond) continue;
 
-            switch (op)
+            for (int swapped = 0; swapped < (pat.commutable ? 2 : 1); ++swapped)
             {
-                case Operator::ADD: iop = is32bit ? Operator::ADDIW : Operator::ADDI; break;
-                case Operator::AND: iop = Operator::ANDI; break;
-                case Operator::OR: iop = Operator::ORI; break;
-                case Operator::XOR: iop = Operator::XORI; break;
-                case Operator::SLL: iop = is32bit ? Operator::SLLIW : Operator::SLLI; break;
-                case Operator::SRA: iop = is32bit ? Operator::SRAIW : Operator::SRAI; break;
-                case Operator::SRL: iop = is32bit ? Operator::SRLIW : Operator::SRLI; break;
-                default: hasImmForm = false; break;
+                PatternMatch m;
+                m.pat  = &pat;
+                m.cost = getOpLatency(pat.inst) + ISelPattern::emitExtraCost(pat.emit);
+                if (!matchLeaf(pat.lhs, ty, ops[swapped], m.lhs, m.imm, m.cost)) continue;
+                if (!matchLeaf(pat.rhs, ty, ops[1 - swapped], m.rhs, m.imm, m.cost)) continue;
+                if (m.lhs != ops[swapped]) m.covered = ops[swapped];
+                if (m.rhs && m.rhs != ops[1 - swapped]) m.covered = ops[1 - swapped];
+                // 代价相同时优先寄存器叶子更少（覆盖更多子节点）的模式
+                if (!best.pat || m.cost < best.cost || (m.cost == best.cost && regLeaves(pat) < regLeaves(*best.pat)))
+                    best = m;
             }
+        }
+        return best.pat != nullptr;
+    }
 
-            if (hasImmForm)
-                m_block->insts.push_back(createIInst(iop, dst, lhsReg, rhsImm));
-            else
+    Register DAGIsel::getLeafReg(const DAG::SDNode* node, BE::Block* m_block)
+    {
+        auto    opcode = static_cast<DAG::ISD>(node->getOpcode());
+        int64_t v      = 0;
+        if (constValue(node, v) && v == 0 && !nodeToVReg_.count(node)) return PR::x0;
+
+        if (opcode == DAG::ISD::SYMBOL) return materializeAddress(node, m_block);
+
+        int fi = -1;
+        if (opcode == DAG::ISD::FRAME_INDEX)
+            fi = node->getFrameIndex();
+        else if (opcode == DAG::ISD::REG && node->hasIRRegId())
+        {
+            auto it = ctx_.allocaFI.find(node->getIRRegId());
+            if (it != ctx_.allocaFI.end()) fi = it->second;
+        }
+        if (fi < 0) return getOperandReg(node, m_block);
+
+        Register reg      = getVReg(BE::I64);
+        Instr*   addrInst = createIInst(Operator::ADDI, reg, PR::sp, 0);
+        addrInst->fiop    = new FrameIndexOperand(fi);
+        addrInst->use_ops = true;
+        m_block->insts.push_back(addrInst);
+        return reg;
+    }
+
+    void DAGIsel::emitPattern(const PatternMatch& m, Register dst, BE::Block* m_block)
+    {
+        const auto& pat   = *m.pat;
+        Register    a     = isRegLeaf(pat.lhs) ? getLeafReg(m.lhs, m_block) : Register();
+        Register    b     = isRegLeaf(pat.rhs) ? getLeafReg(m.rhs, m_block) : Register();
+        int         imm   = static_cast<int>(m.imm);
+        auto&       insts = m_block->insts;
+
+        // 需要取反的形式先把根指令的结果写入临时寄存器
+        bool     negate = pat.emit == Emit::RRNot || pat.emit == Emit::RRSwapNot || pat.emit == Emit::RINot ||
+                      pat.emit == Emit::RIIncNot;
+        Register out    = negate ? getVReg(BE::I64) : dst;
+
+        switch (pat.emit)
+        {
+            case Emit::RR:
+            case Emit::RRNot: insts.push_back(createRInst(pat.inst, out, a, b)); break;
+            case Emit::RRSwap:
+            case Emit::RRSwapNot: insts.push_back(createRInst(pat.inst, out, b, a)); break;
+            case Emit::RI:
+            case Emit::RINot: insts.push_back(createIInst(pat.inst, out, a, imm)); break;
+            case Emit::RINeg: insts.push_back(createIInst(pat.inst, out, a, -imm)); break;
+            case Emit::RILog2: insts.push_back(createIInst(pat.inst, out, a, log2Exact(m.imm))); break;
+            case Emit::RIInc:
+            case Emit::RIIncNot: insts.push_back(createIInst(pat.inst, out, a, imm + 1)); break;
+            case Emit::EqZ: insts.push_back(createIInst(pat.inst, out, a, 1)); break;
+            case Emit::NeZ: insts.push_back(createRInst(pat.inst, out, PR::x0, a)); break;
+            case Emit::EqRR:
+            case Emit::NeRR:
             {
-                Register tmpReg = getVReg(lhsReg.dt);
-                m_block->insts.push_back(createMove(new RegOperand(tmpReg), rhsImm, LOC_STR));
-                m_block->insts.push_back(createRInst(op, dst, lhsReg, tmpReg));
+                Register tmp = getVReg(BE::I64);
+                insts.push_back(createRInst(Operator::XOR, tmp, a, b));
+                if (pat.emit == Emit::EqRR)
+                    insts.push_back(createIInst(pat.inst, out, tmp, 1));
+                else
+                    insts.push_back(createRInst(pat.inst, out, PR::x0, tmp));
+                break;
             }
         }
-        else
-            m_block->insts.push_back(createRInst(op, dst, lhsReg, rhsReg));
+        if (negate) insts.push_back(createIInst(Operator::XORI, dst, out, 1));
+    }
+
+    void DAGIsel::selectBinary(const DAG::SDNode* node, BE::Block* m_block)
+    {
+        if (node->getNumOperands() < 2) return;
+
+        PatternMatch m;
+        if (!matchPattern(node, m))
+        {
+            ERROR("Unsupported binary operator: %d", node->getOpcode());
+            return;
+        }
+        emitPattern(m, nodeToVReg_.at(node), m_block);
     }
 
     void DAGIsel::selectUnary(const DAG::SDNode* node, BE::Block* m_block)
@@ -648,6 +763,24 @@ namespace BE::RV64
                 return false;
             }
 
+            // 任意寄存器值 + 常量：寄存器值作为基址（如跨块的指针、变量下标的地址）
+            auto isConst = [](const DAG::SDNode* n) {
+                auto opc = static_cast<DAG::ISD>(n->getOpcode());
+                return (opc == DAG::ISD::CONST_I32 || opc == DAG::ISD::CONST_I64) && n->hasImmI64();
+            };
+            if (isConst(rhs) && !isConst(lhs))
+            {
+                baseNode = lhs;
+                offset   = rhs->getImmI64();
+                return true;
+            }
+            if (isConst(lhs) && !isConst(rhs))
+            {
+                baseNode = rhs;
+                offset   = lhs->getImmI64();
+                return true;
+            }
+
             return false;
         }
 
@@ -798,82 +931,14 @@ namespace BE::RV64
     {
         if (node->getNumOperands() < 2) return;
 
-        Register dst = nodeToVReg_.at(node);
-
-        const DAG::SDNode* lhs = node->getOperand(0).getNode();
-        const DAG::SDNode* rhs = node->getOperand(1).getNode();
-
-        Register lhsReg = getOperandReg(lhs, m_block);
-        Register rhsReg = getOperandReg(rhs, m_block);
-
-        // 从节点的立即数中获取比较条件码
-        int condCode = node->hasImmI64() ? static_cast<int>(node->getImmI64()) : 0;
-        auto cond = static_cast<ME::ICmpOp>(condCode);
-
-        switch (cond)
+        // 比较条件码存放在节点的立即数中，模式表按条件码区分
+        PatternMatch m;
+        if (!matchPattern(node, m))
         {
-            case ME::ICmpOp::EQ:
-            {
-                // XOR + SEQZ: dst = (lhs ^ rhs) == 0
-                Register tmp = getVReg(BE::I64);
-                m_block->insts.push_back(createRInst(Operator::XOR, tmp, lhsReg, rhsReg));
-                m_block->insts.push_back(createIInst(Operator::SLTIU, dst, tmp, 1));
-                break;
-            }
-            case ME::ICmpOp::NE:
-            {
-                // XOR + SNEZ: dst = (lhs ^ rhs) != 0
-                Register tmp = getVReg(BE::I64);
-                m_block->insts.push_back(createRInst(Operator::XOR, tmp, lhsReg, rhsReg));
-                m_block->insts.push_back(createRInst(Operator::SLTU, dst, PR::x0, tmp));
-                break;
-            }
-            case ME::ICmpOp::SLT:
-                m_block->insts.push_back(createRInst(Operator::SLT, dst, lhsReg, rhsReg));
-                break;
-            case ME::ICmpOp::SGE:
-            {
-                // SGE = NOT(SLT)
-                Register tmp = getVReg(BE::I64);
-                m_block->insts.push_back(createRInst(Operator::SLT, tmp, lhsReg, rhsReg));
-                m_block->insts.push_back(createIInst(Operator::XORI, dst, tmp, 1));
-                break;
-            }
-            case ME::ICmpOp::SGT:
-                // SGT = SLT（交换操作数）
-                m_block->insts.push_back(createRInst(Operator::SLT, dst, rhsReg, lhsReg));
-                break;
-            case ME::ICmpOp::SLE:
-            {
-                // SLE = NOT(SGT) = NOT(SLT 交换操作数)
-                Register tmp = getVReg(BE::I64);
-                m_block->insts.push_back(createRInst(Operator::SLT, tmp, rhsReg, lhsReg));
-                m_block->insts.push_back(createIInst(Operator::XORI, dst, tmp, 1));
-                break;
-            }
-            case ME::ICmpOp::ULT:
-                m_block->insts.push_back(createRInst(Operator::SLTU, dst, lhsReg, rhsReg));
-                break;
-            case ME::ICmpOp::UGE:
-            {
-                Register tmp = getVReg(BE::I64);
-                m_block->insts.push_back(createRInst(Operator::SLTU, tmp, lhsReg, rhsReg));
-                m_block->insts.push_back(createIInst(Operator::XORI, dst, tmp, 1));
-                break;
-            }
-            case ME::ICmpOp::UGT:
-                m_block->insts.push_back(createRInst(Operator::SLTU, dst, rhsReg, lhsReg));
-                break;
-            case ME::ICmpOp::ULE:
-            {
-                Register tmp = getVReg(BE::I64);
-                m_block->insts.push_back(createRInst(Operator::SLTU, tmp, rhsReg, lhsReg));
-                m_block->insts.push_back(createIInst(Operator::XORI, dst, tmp, 1));
-                break;
-            }
-            default:
-                ERROR("Unsupported ICMP condition: %d", condCode);
+            ERROR("Unsupported ICMP condition: %d", node->hasImmI64() ? static_cast<int>(node->getImmI64()) : 0);
+            return;
         }
+        emitPattern(m, nodeToVReg_.at(node), m_block);
     }
 
     void DAGIsel::selectFCmp(const DAG::SDNode* node, BE::Block* m_block)
@@ -959,19 +1024,56 @@ namespace BE::RV64
 
             if (!condNode || !trueLabelNode || !falseLabelNode) return;
 
-            Register condReg = getOperandReg(condNode, m_block);
-
             int trueLabel = trueLabelNode->hasImmI64() ? static_cast<int>(trueLabelNode->getImmI64()) : 0;
             int falseLabel = falseLabelNode->hasImmI64() ? static_cast<int>(falseLabelNode->getImmI64()) : 0;
 
-            // 条件非 0 则跳转到 trueLabel
-            m_block->insts.push_back(createBInst(Operator::BNE, condReg, PR::x0, Label(trueLabel)));
+            if (fusedCompares_.count(condNode))
+                selectCompareBranch(condNode, trueLabel, m_block);
+            else
+            {
+                // 条件非 0 则跳转到 trueLabel
+                Register condReg = getOperandReg(condNode, m_block);
+                m_block->insts.push_back(createBInst(Operator::BNE, condReg, PR::x0, Label(trueLabel)));
+            }
 
             // 否则跳转到 falseLabel
             m_block->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(falseLabel)));
         }
     }
 
+    void DAGIsel::selectCompareBranch(const DAG::SDNode* cmp, int trueLabel, BE::Block* m_block)
+    {
+        // 比较结果只被分支使用：直接生成 B<cc>，GT/LE 类条件交换操作数
+        auto operandReg = [&](const DAG::SDNode* n) {
+            auto opc = static_cast<DAG::ISD>(n->getOpcode());
+            if ((opc == DAG::ISD::CONST_I32 || opc == DAG::ISD::CONST_I64) && n->hasImmI64() && n->getImmI64() == 0)
+                return PR::x0;
+            return getOperandReg(n, m_block);
+        };
+        Register lhs = operandReg(cmp->getOperand(0).getNode());
+        Register rhs = operandReg(cmp->getOperand(1).getNode());
+
+        int      condCode = cmp->hasImmI64() ? static_cast<int>(cmp->getImmI64()) : 0;
+        Operator op;
+        bool     swap = false;
+        switch (static_cast<ME::ICmpOp>(condCode))
+        {
+            case ME::ICmpOp::EQ: op = Operator::BEQ; break;
+            case ME::ICmpOp::NE: op = Operator::BNE; break;
+            case ME::ICmpOp::SLT: op = Operator::BLT; break;
+            case ME::ICmpOp::SGE: op = Operator::BGE; break;
+            case ME::ICmpOp::SGT: op = Operator::BLT, swap = true; break;
+            case ME::ICmpOp::SLE: op = Operator::BGE, swap = true; break;
+            case ME::ICmpOp::ULT: op = Operator::BLTU; break;
+            case ME::ICmpOp::UGE: op = Operator::BGEU; break;
+            case ME::ICmpOp::UGT: op = Operator::BLTU, swap = true; break;
+            case ME::ICmpOp::ULE: op = Operator::BGEU, swap = true; break;
+            default: ERROR("Unsupported ICMP condition: %d", condCode);
+        }
+        if (swap) std::swap(lhs, rhs);
+        m_block->insts.push_back(createBInst(op, lhs, rhs, Label(trueLabel)));
+    }
+
     void DAGIsel::selectCall(const DAG::SDNode* node, BE::Block* m_block)
     {
         // CALL 操作数: [Chain, Callee, Arg0, Arg1, ...]
@@ -983,9 +1085,12 @@ namespace BE::RV64
         // 提取函数名
         std::string funcName = calleeNode->hasSymbol() ? calleeNode->getSymbol() : "unknown";
 
-        // 处理内置函数
+        // 处理内置函数：常量小长度的 memset 直接展开，避免调用点破坏寄存器
         if (funcName.find("llvm.memset") != std::string::npos)
+        {
+            if (selectMemset(node, m_block)) return;
             funcName = "memset";
+        }
         else if (funcName.find("llvm.memcpy") != std::string::npos)
             funcName = "memcpy";
 
@@ -1053,15 +1158,116 @@ namespace BE::RV64
         m_block->insts.push_back(createCallInst(Operator::CALL, funcName, iRegCnt, fRegCnt));
 
         // 处理返回值
-        auto it = nodeToVReg_.find(node);
-        if (it != nodeToVReg_.end())
+        if (const Register* r = nodeToVReg_.lookup(node))
         {
-            Register dst = it->second;
+            Register dst = *r;
             Register srcReg = (dst.dt == BE::F32 || dst.dt == BE::F64) ? PR::fa0 : PR::a0;
             m_block->insts.push_back(createMove(new RegOperand(dst), new RegOperand(srcReg), LOC_STR));
         }
     }
 
+    int DAGIsel::knownAlignment(const DAG::SDNode* addrNode)
+    {
+        // 局部数组的对齐取自 alloca 对应的帧对象；其余指针至少按 SysY 元素宽度（4 字节）对齐
+        auto opcode = static_cast<DAG::ISD>(addrNode->getOpcode());
+        if (opcode == DAG::ISD::FRAME_INDEX && addrNode->hasIRRegId())
+            return std::max(4, ctx_.mfunc->frameInfo.getObjectAlignment(addrNode->getIRRegId()));
+
+        if (opcode == DAG::ISD::ADD && addrNode->getNumOperands() == 2)
+        {
+            const DAG::SDNode* base = addrNode->getOperand(0).getNode();
+            const DAG::SDNode* off  = addrNode->getOperand(1).getNode();
+            auto offOp = static_cast<DAG::ISD>(off->getOpcode());
+            if ((offOp == DAG::ISD::CONST_I32 || offOp == DAG::ISD::CONST_I64) && off->hasImmI64())
+            {
+                int64_t c     = off->getImmI64();
+                int     align = knownAlignment(base);
+                if (c == 0) return align;
+                return std::max(4, static_cast<int>(std::min<int64_t>(align, c & -c)));
+            }
+        }
+        return 4;
+    }
+
+    void DAGIsel::emitZeroStores(BE::Block* m_block, Register base, int64_t bytes, int unit)
+    {
+        int64_t off = 0;
+        for (; unit == 8 && off + 8 <= bytes; off += 8)
+            m_block->insts.push_back(createSInst(Operator::SD, PR::x0, base, static_cast<int>(off)));
+        for (; off + 4 <= bytes; off += 4)
+            m_block->insts.push_back(createSInst(Operator::SW, PR::x0, base, static_cast<int>(off)));
+    }
+
+    bool DAGIsel::selectMemset(const DAG::SDNode* node, BE::Block* m_block)
+    {
+        // ============================================================================
+        // memset 内联展开
+        // ============================================================================
+        //
+        // 操作数: [Chain, Callee, ptr, val(i8), len(i32), isVolatile(i1)]
+        // 仅处理“清零 + 常量长度 + 4 字节倍数”的情形（ASTCodeGen 的局部数组零初始化）：
+        // - len <= kMemsetUnrollBytes：完全展开为 sd/sw x0 序列
+        // - len <= kMemsetInlineBytes：拆分当前块，生成每次迭代清零 4 个单元的循环，余量在出口块展开
+        // 其余情况保留库函数调用
+        if (node->getNumOperands() < 5) return false;
+
+        const DAG::SDNode* ptrNode = node->getOperand(2).getNode();
+        const DAG::SDNode* valNode = node->getOperand(3).getNode();
+        const DAG::SDNode* lenNode = node->getOperand(4).getNode();
+        if (!ptrNode || !valNode || !lenNode) return false;
+
+        auto isConst = [](const DAG::SDNode* n) {
+            auto op = static_cast<DAG::ISD>(n->getOpcode());
+            return (op == DAG::ISD::CONST_I32 || op == DAG::ISD::CONST_I64) && n->hasImmI64();
+        };
+        if (!isConst(valNode) || valNode->getImmI64() != 0 || !isConst(lenNode)) return false;
+
+        int64_t len = lenNode->getImmI64();
+        if (len < 0 || len > kMemsetInlineBytes || len % 4 != 0) return false;
+        if (len == 0) return true;
+
+        int      unit = knownAlignment(ptrNode) >= 8 ? 8 : 4;
+        Register base = getOperandReg(ptrNode, m_block);
+
+        if (len <= kMemsetUnrollBytes)
+        {
+            emitZeroStores(m_block, base, len, unit);
+            return true;
+        }
+
+        int64_t step      = 4 * unit;
+        int64_t loopBytes = len / step * step;
+
+        // 拆分：m_block -> loop -> tail，当前块的剩余指令落到 tail
+        BE::Function* func   = ctx_.mfunc;
+        uint32_t      loopId = func->blocks.rbegin()->first + 1;
+        auto*         loop   = new BE::Block(loopId);
+        func->blocks[loopId] = loop;
+        uint32_t tailId      = loopId + 1;
+        auto*    tail        = new BE::Block(tailId);
+        func->blocks[tailId] = tail;
+
+        Register end = getVReg(BE::I64);
+        m_block->insts.push_back(createIInst(Operator::ADDI, end, base, static_cast<int>(loopBytes)));
+        m_block->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(static_cast<int>(loopId))));
+
+        Register cur  = getVReg(BE::I64);
+        Register next = getVReg(BE::I64);
+        auto*    phi  = new PhiInst(cur);
+        phi->incomingVals[m_block->blockId] = new RegOperand(base);
+        phi->incomingVals[loopId]           = new RegOperand(next);
+        loop->insts.push_back(phi);
+        emitZeroStores(loop, cur, step, unit);
+        loop->insts.push_back(createIInst(Operator::ADDI, next, cur, static_cast<int>(step)));
+        loop->insts.push_back(createBInst(Operator::BLTU, next, end, Label(static_cast<int>(loopId))));
+        loop->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(static_cast<int>(tailId))));
+
+        emitZeroStores(tail, end, len - loopBytes, unit);
+
+        splitTail_ = tail;
+        return true;
+    }
+
     void DAGIsel::selectRet(const DAG::SDNode* node, BE::Block* m_block)
     {
         // 操作数 0 是 Chain（保证副作用顺序），操作数 1 是实际返回值
@@ -1170,55 +1376,53 @@ namespace BE::RV64
         // 获取当前 MIR 基本块
         BE::Block* m_block = ctx_.mfunc->blocks[static_cast<uint32_t>(ir_block->blockId)];
 
-        // 重置块级状态
+        // 阶段 1：调度 DAG 节点（同时为本块涉及的节点编号）
+        auto scheduledNodes = scheduleDAG(dag);
+
+        // 重置块级状态，各表按编号数定容
         nodeToVReg_.clear();
         selected_.clear();
 
-        // 阶段 1：调度 DAG 节点
-        auto scheduledNodes = scheduleDAG(dag);
-
         // 阶段 1.5：为每个节点预分配虚拟寄存器
         for (const auto* node : scheduledNodes)
             allocateRegistersForNode(node);
 
+        // 阶段 1.6：标记被使用者折叠的节点
+        markFoldedNodes(scheduledNodes);
+
         // 阶段 2：指令选择
         for (const auto* node : scheduledNodes)
         {
-            if (selected_.count(node)) continue;
-            selected_.insert(node);
+            if (!selected_.insert(node)) continue;
             selectNode(node, m_block);
+
+            // 节点展开时拆分了当前块（如 memset 循环），后续指令接在出口块上
+            if (splitTail_)
+            {
+                m_block    = splitTail_;
+                splitTail_ = nullptr;
+                ctx_.blockExit[static_cast<uint32_t>(ir_block->blockId)] = m_block->blockId;
+            }
         }
     }
 
-    void DAGIsel::selectFunction(ME::Function* ir_func)
+    BE::Function* DAGIsel::selectFunction(ME::Function* ir_func)
     {
-        // 1. 重置函数级上下文
+        // 1. 构建本函数的 DAG，重置函数级上下文
+        auto dags  = target_->buildDAG(*ir_func);
         ctx_.mfunc = nullptr;
         ctx_.vregMap.clear();
         ctx_.allocaFI.clear();
+        ctx_.blockExit.clear();
+        ctx_.crossBlockUses = &dags->cross_block_uses;
 
-        // 2. 创建后端函数对象
+        // 2. 创建后端函数对象，此后新建的虚拟寄存器在该函数内编号
         std::string funcName = ir_func->funcDef->funcName;
         ctx_.mfunc = new BE::Function(funcName);
-        m_backend_module->functions.push_back(ctx_.mfunc);
+        VRegScope vregScope(ctx_.mfunc);
 
-        // 3. 计算传出参数区大小（遍历所有 CALL 指令找最大参数数量）
-        //    为前 8 个寄存器参数预留临时区，避免搬运时被覆盖
-        int maxCallBytes = 0;
-        for (auto& [blockId, block] : ir_func->blocks)
-        {
-            for (auto* inst : block->insts)
-            {
-                if (auto* call = dynamic_cast<ME::CallInst*>(inst))
-                {
-                    int argCount      = static_cast<int>(call->args.size());
-                    int stackArgBytes = std::max(0, argCount - 8) * 8;
-                    int regTempBytes  = std::min(argCount, 8) * 8;  // 为 a0-a7 预留的临时区
-                    int totalBytes    = stackArgBytes + regTempBytes;
-                    if (totalBytes > maxCallBytes) maxCallBytes = totalBytes;
-                }
-            }
-        }
+        // 3. 计算传出参数区大小（为前 8 个寄存器参数预留临时区，避免搬运时被覆盖）
+        int maxCallBytes = computeCallFrameBytes(ir_func);
         ctx_.mfunc->paramSize = maxCallBytes;
         ctx_.mfunc->frameInfo.setParamAreaSize(ctx_.mfunc->paramSize);
 
@@ -1235,37 +1439,60 @@ namespace BE::RV64
         // 6. 为参数分配虚拟寄存器
         setupParameters(ir_func);
 
-        // 7. 对每个基本块构建 DAG 并做指令选择
+        // 7. 对每个基本块做指令选择
         for (auto& [blockId, block] : ir_func->blocks)
         {
-            // 获取该块的 SelectionDAG（由 target_->buildDAG 预先构建）
-            auto it = target_->block_dags.find(block);
-            if (it != target_->block_dags.end() && it->second)
+            auto it = dags->block_dags.find(block);
+            if (it != dags->block_dags.end() && it->second)
                 selectBlock(block, *(it->second));
         }
+
+        // 8. 被拆分的块以出口块作为后继的前驱，改写 PHI 的前驱标签
+        if (!ctx_.blockExit.empty())
+        {
+            // 只改写 IR 块中的 PHI；展开时新建块内的 PHI 已使用正确的前驱
+            for (auto& [blockId, block] : ir_func->blocks)
+            {
+                for (auto* inst : ctx_.mfunc->blocks[static_cast<uint32_t>(blockId)]->insts)
+                {
+                    if (inst->kind != InstKind::PHI) continue;
+                    auto* phi = static_cast<PhiInst*>(inst);
+                    std::map<uint32_t, Operand*> remapped;
+                    for (auto& [label, op] : phi->incomingVals)
+                    {
+                        auto exitIt = ctx_.blockExit.find(label);
+                        remapped[exitIt == ctx_.blockExit.end() ? label : exitIt->second] = op;
+                    }
+                    phi->incomingVals = std::move(remapped);
+                }
+            }
+        }
+
+        ctx_.crossBlockUses = nullptr;
+        return ctx_.mfunc;
     }
 
     void DAGIsel::runImpl()
     {
-        importGlobals();
-
-        target_->buildDAG(ir_module_);
+        importGlobalVariables(ir_module_, m_backend_module);
 
-        for (auto* f : ir_module_->functions) selectFunction(f);
+        for (auto* f : ir_module_->functions) m_backend_module->functions.push_back(selectFunction(f));
     }
 
 
     void DAGIsel::postOrderHelper(
     const DAG::SDNode* node,
-    std::set<const DAG::SDNode*>& visited,
+    DAG::NodeNumbering& numbering,
+    DAG::NodeSet& visited,
     std::vector<const DAG::SDNode*>& result)
     {
-    if (!node || visited.count(node)) return;
-    visited.insert(node);
+    if (!node) return;
+    numbering.assign(node);  // 其它块 DAG 的节点（入口块的 FrameIndex）在此获得本块编号
+    if (!visited.insert(node)) return;
     
     for (unsigned i = 0; i < node->getNumOperands(); ++i) {
         const DAG::SDNode* opNode = node->getOperand(i).getNode();
-        if (opNode) postOrderHelper(opNode, visited, result);  // 递归
+        if (opNode) postOrderHelper(opNode, numbering, visited, result);  // 递归
     }
     
     result.push_back(node);
@@ -3,9 +3,11 @@
 
 #include <backend/isel/isel_base.h>
 #include <backend/dag/selection_dag.h>
+#include <backend/dag/node_table.h>
+#include <backend/targets/riscv64/isel/rv64_isel_patterns.h>
 #include <middleend/module/ir_module.h>
 #include <map>
-#include <set>
+#include <unordered_map>
 
 /*
  * 注：当前目录下有 rv64_dag_isel 与 rv64_ir_isel 两份实现，它们的功能是一致的，你只需要选择其中一份来完成就行
@@ -37,6 +39,10 @@ namespace BE::RV64
             : BE::ISelBase<DAGIsel>(backend_module), ir_module_(ir_module), target_(target)
         {}
 
+        /// 为单个函数构建 DAG 并完成指令选择，返回新建的后端函数（不加入后端模块）
+        /// 只访问该函数自身的状态，不同 DAGIsel 实例可以在多个线程上同时选择不同函数
+        BE::Function* selectFunction(ME::Function* ir_func);
+
       private:
         ME::Module*                   ir_module_;
         BE::Targeting::BackendTarget* target_;
@@ -53,6 +59,8 @@ namespace BE::RV64
             BE::Function*              mfunc = nullptr;
             std::map<size_t, Register> vregMap;   ///< IR 寄存器 ID -> 后端虚拟寄存器
             std::map<size_t, int>      allocaFI;  ///< IR alloca 寄存器 ID -> 栈帧索引
+            std::map<uint32_t, uint32_t> blockExit;  ///< IR 块 ID -> 块内被拆分后出口所在的 MIR 块 ID
+            const std::unordered_map<size_t, int>* crossBlockUses = nullptr;  ///< IR 寄存器在定义所在块之外的引用次数（DAG 构建时统计）
         };
 
         FunctionContext ctx_;
@@ -64,12 +72,18 @@ namespace BE::RV64
          * - nodeToVReg_：DAG 节点到其结果寄存器的映射（仅在块内有效）
          * - selected_：已选择的节点集合（防止重复选择）
          */
-        std::map<const DAG::SDNode*, Register> nodeToVReg_;  ///< DAG 节点 -> 其结果虚拟寄存器
-        std::set<const DAG::SDNode*>           selected_;    ///< 已经选择过的节点集合
+        DAG::NodeNumbering     numbering_;    ///< 本块节点编号（各块表的下标）
+        DAG::NodeMap<Register> nodeToVReg_{numbering_};  ///< DAG 节点 -> 其结果虚拟寄存器
+        DAG::NodeSet           selected_{numbering_};    ///< 已经选择过的节点集合
+        DAG::NodeSet           fusedCompares_{numbering_};  ///< 并入条件分支的比较节点
+        DAG::NodeSet           foldableShl_{numbering_};  ///< 仅有一个使用者、可被移位加模式覆盖的 SHL 节点
+        BE::Block*                             splitTail_ = nullptr;  ///< 选择中拆分了当前块时，后续指令的落点
+
+        /// memset 内联展开阈值：不超过 kMemsetUnrollBytes 时完全展开，不超过 kMemsetInlineBytes 时生成紧凑循环
+        static constexpr int64_t kMemsetUnrollBytes = 64;
+        static constexpr int64_t kMemsetInlineBytes = 1024;
 
         void runImpl();//入口
-        void importGlobals();//导入全局变量
-        void selectFunction(ME::Function* ir_func);//选择函数
 
         void collectAllocas(ME::Function* ir_func);//收集 alloca
         void setupParameters(ME::Function* ir_func);//设置参数
@@ -80,6 +94,11 @@ namespace BE::RV64
         std::vector<const DAG::SDNode*> scheduleDAG(const DAG::SelectionDAG& dag);//调度DAG
         void                            allocateRegistersForNode(const DAG::SDNode* node);//分配寄存器
 
+        using UserMap = DAG::NodeMap<std::vector<std::pair<const DAG::SDNode*, unsigned>>>;
+        void markFoldedNodes(const std::vector<const DAG::SDNode*>& scheduled);//标记被使用者折叠、无需单独生成的节点
+        int  crossBlockUses(const DAG::SDNode* node) const;//节点所定义的 IR 寄存器在其它块中的引用次数
+        bool isFoldedAddress(const DAG::SDNode* node, const UserMap& users);//地址是否被全部访存使用者折叠
+
         // ==================== 阶段 2：选择（Select） ====================
 
         void     selectNode(const DAG::SDNode* node, BE::Block* m_block);//选择节点
@@ -88,6 +107,25 @@ namespace BE::RV64
         bool     selectAddress(const DAG::SDNode* addrNode, const DAG::SDNode*& baseNode, int64_t& offset);//选择地址
         Register getOrCreateVReg(size_t ir_reg_id, BE::DataType* dt);//获取或创建虚拟寄存器
 
+        // ==================== 模式表匹配（rv64_isel_patterns.h） ====================
+
+        /// 一次成功的模式匹配：操作数按模式中的顺序排列（交换匹配时已调换）
+        struct PatternMatch
+        {
+            const ISelPattern::Pattern* pat     = nullptr;
+            const DAG::SDNode*          lhs     = nullptr;  ///< 左叶子绑定的节点（Shl 叶子为被移位的值）
+            const DAG::SDNode*          rhs     = nullptr;  ///< 右叶子绑定的节点
+            const DAG::SDNode*          covered = nullptr;  ///< 被模式吃掉、无需单独生成的子节点
+            int64_t                     imm     = 0;        ///< 立即数叶子的值
+            int                         cost    = 0;
+        };
+
+        bool     matchLeaf(ISelPattern::Leaf leaf, ISelPattern::Ty ty, const DAG::SDNode* n,
+                const DAG::SDNode*& bound, int64_t& imm, int& cost) const;//叶子约束匹配
+        bool     matchPattern(const DAG::SDNode* node, PatternMatch& best) const;//代价最小的覆盖
+        void     emitPattern(const PatternMatch& m, Register dst, BE::Block* m_block);//按模式生成指令
+        Register getLeafReg(const DAG::SDNode* node, BE::Block* m_block);//寄存器叶子的实例化
+
         void selectCopy(const DAG::SDNode* node, BE::Block* m_block);//选择copy
         void selectPhi(const DAG::SDNode* node, BE::Block* m_block);//选择phi
         void selectBinary(const DAG::SDNode* node, BE::Block* m_block);//选择二元操作
@@ -97,7 +135,11 @@ namespace BE::RV64
         void selectICmp(const DAG::SDNode* node, BE::Block* m_block);//选择icmp
         void selectFCmp(const DAG::SDNode* node, BE::Block* m_block);//选择fcmp
         void selectBranch(const DAG::SDNode* node, BE::Block* m_block);//选择branch
+        void selectCompareBranch(const DAG::SDNode* cmp, int trueLabel, BE::Block* m_block);//比较与分支融合
         void selectCall(const DAG::SDNode* node, BE::Block* m_block);//选择call
+        bool selectMemset(const DAG::SDNode* node, BE::Block* m_block);//常量长度 memset 内联展开
+        void emitZeroStores(BE::Block* m_block, Register base, int64_t bytes, int unit);//连续清零存储
+        int  knownAlignment(const DAG::SDNode* addrNode);//地址节点的已知对齐
         void selectRet(const DAG::SDNode* node, BE::Block* m_block);//选择ret
         void selectCast(const DAG::SDNode* node, BE::Block* m_block);//选择cast
 
@@ -105,7 +147,8 @@ namespace BE::RV64
 
         //后续遍历辅助函数
         static void postOrderHelper(const DAG::SDNode* node,
-                                    std::set<const DAG::SDNode*>& visited,
+                                    DAG::NodeNumbering& numbering,
+                                    DAG::NodeSet& visited,
                                     std::vector<const DAG::SDNode*>& result);
     };
 
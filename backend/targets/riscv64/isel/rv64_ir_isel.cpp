@@ -1,28 +1,626 @@
 #include <backend/targets/riscv64/isel/rv64_ir_isel.h>
+#include <backend/targets/riscv64/isel/rv64_isel_utils.h>
+#include <backend/target/target.h>
+#include <middleend/module/ir_instruction.h>
+#include <middleend/module/ir_function.h>
+#include <debug.h>
+#include <transfer.h>
+#include <cstring>
 
 namespace BE::RV64
 {
+    static inline bool imm12(int64_t imm) { return imm >= -2048 && imm <= 2047; }
+
+    static inline bool isFloatReg(const Register& r) { return r.dt == BE::F32 || r.dt == BE::F64; }
+
     void IRIsel::runImpl() { apply(*this, *ir_module_); }
 
-    void IRIsel::visit(ME::Module& module) { TODO("Handle rv64 ir isel for module"); }
-    void IRIsel::visit(ME::Function& func) { TODO("Handle rv64 ir isel for function"); }
-    void IRIsel::visit(ME::Block& block) { TODO("Handle rv64 ir isel for block"); }
-
-    void IRIsel::visit(ME::LoadInst& inst) { TODO("Handle rv64 ir isel for load instruction"); }
-    void IRIsel::visit(ME::StoreInst& inst) { TODO("Handle rv64 ir isel for store instruction"); }
-    void IRIsel::visit(ME::ArithmeticInst& inst) { TODO("Handle rv64 ir isel for arithmetic instruction"); }
-    void IRIsel::visit(ME::IcmpInst& inst) { TODO("Handle rv64 ir isel for icmp instruction"); }
-    void IRIsel::visit(ME::FcmpInst& inst) { TODO("Handle rv64 ir isel for fcmp instruction"); }
-    void IRIsel::visit(ME::AllocaInst& inst) { TODO("Handle rv64 ir isel for alloca instruction"); }
-    void IRIsel::visit(ME::BrCondInst& inst) { TODO("Handle rv64 ir isel for brcond instruction"); }
-    void IRIsel::visit(ME::BrUncondInst& inst) { TODO("Handle rv64 ir isel for bruncond instruction"); }
-    void IRIsel::visit(ME::CallInst& inst) { TODO("Handle rv64 ir isel for call instruction"); }
-    void IRIsel::visit(ME::RetInst& inst) { TODO("Handle rv64 ir isel for ret instruction"); }
-    void IRIsel::visit(ME::GEPInst& inst) { TODO("Handle rv64 ir isel for gep instruction"); }
-    void IRIsel::visit(ME::FP2SIInst& inst) { TODO("Handle rv64 ir isel for fp2si instruction"); }
-    void IRIsel::visit(ME::SI2FPInst& inst) { TODO("Handle rv64 ir isel for si2fp instruction"); }
-    void IRIsel::visit(ME::ZextInst& inst) { TODO("Handle rv64 ir isel for zext instruction"); }
-    void IRIsel::visit(ME::PhiInst& inst) { TODO("Handle rv64 ir isel for phi instruction"); }
+    BE::DataType* IRIsel::mapType(ME::DataType t)
+    {
+        switch (t)
+        {
+            case ME::DataType::I1:
+            case ME::DataType::I8:
+            case ME::DataType::I32: return BE::I32;
+            case ME::DataType::I64:
+            case ME::DataType::PTR: return BE::I64;
+            case ME::DataType::F32: return BE::F32;
+            case ME::DataType::DOUBLE: return BE::F64;
+            default: ERROR("Unsupported IR data type"); return BE::I32;
+        }
+    }
+
+    Register IRIsel::getOrCreateVReg(size_t ir_reg_id, BE::DataType* dt)
+    {
+        if (ir_reg_id >= vregMap_.size()) vregMap_.resize(ir_reg_id + 1);
+        // RISC-V 对寄存器宽度没有要求，类型不一致时直接复用已有映射
+        if (!vregMap_[ir_reg_id].dt) vregMap_[ir_reg_id] = getVReg(dt);
+        return vregMap_[ir_reg_id];
+    }
+
+    int IRIsel::allocaIndex(ME::Operand* op) const
+    {
+        if (!op || op->getType() != ME::OperandType::REG) return -1;
+        size_t id = op->getRegNum();
+        return id < allocaFI_.size() ? allocaFI_[id] : -1;
+    }
+
+    Register IRIsel::getOperandReg(ME::Operand* op, BE::DataType* dt)
+    {
+        if (!op) ERROR("Cannot get register for null operand");
+
+        switch (op->getType())
+        {
+            case ME::OperandType::REG:
+            {
+                int fi = allocaIndex(op);
+                if (fi < 0) return getOrCreateVReg(op->getRegNum(), dt);
+                // alloca 的地址按需实例化
+                Register addr = getVReg(BE::I64);
+                m_block_->insts.push_back(createIInst(Operator::ADDI, addr, PR::sp, new FrameIndexOperand(fi)));
+                return addr;
+            }
+            case ME::OperandType::IMMEI32:
+            {
+                int val = static_cast<ME::ImmeI32Operand*>(op)->value;
+                if (val == 0) return PR::x0;
+                Register reg = getVReg(dt == BE::I64 ? BE::I64 : BE::I32);
+                m_block_->insts.push_back(createMove(new RegOperand(reg), val, LOC_STR));
+                return reg;
+            }
+            case ME::OperandType::IMMEF32:
+            {
+                float    f = static_cast<ME::ImmeF32Operand*>(op)->value;
+                uint32_t bits;
+                memcpy(&bits, &f, sizeof(float));
+                Register reg = getVReg(BE::F32);
+                Register src = PR::x0;
+                if (bits != 0)
+                {
+                    src = getVReg(BE::I32);
+                    m_block_->insts.push_back(createMove(new RegOperand(src), static_cast<int>(bits), LOC_STR));
+                }
+                m_block_->insts.push_back(createR2Inst(Operator::FMV_W_X, reg, src));
+                return reg;
+            }
+            case ME::OperandType::GLOBAL:
+            {
+                Register addr = getVReg(BE::I64);
+                Label    symbolLabel(static_cast<ME::GlobalOperand*>(op)->name, false, true);
+                m_block_->insts.push_back(createUInst(Operator::LA, addr, symbolLabel));
+                return addr;
+            }
+            default: ERROR("Unsupported operand type in IR isel"); return Register();
+        }
+    }
+
+    bool IRIsel::getImm12(ME::Operand* op, int& imm) const
+    {
+        if (!op || op->getType() != ME::OperandType::IMMEI32) return false;
+        imm = static_cast<ME::ImmeI32Operand*>(op)->value;
+        return imm12(imm);
+    }
+
+    IRIsel::Address IRIsel::selectAddress(ME::Operand* ptr)
+    {
+        Address addr;
+        addr.fi = allocaIndex(ptr);
+        if (addr.fi >= 0)
+            addr.base = PR::sp;
+        else
+            addr.base = getOperandReg(ptr, BE::I64);
+        return addr;
+    }
+
+    void IRIsel::emitAddImm(Register dst, Register src, int64_t imm)
+    {
+        if (imm12(imm))
+        {
+            m_block_->insts.push_back(createIInst(Operator::ADDI, dst, src, static_cast<int>(imm)));
+            return;
+        }
+        Register tmp = getVReg(BE::I64);
+        m_block_->insts.push_back(createMove(new RegOperand(tmp), static_cast<int>(imm), LOC_STR));
+        m_block_->insts.push_back(createRInst(Operator::ADD, dst, src, tmp));
+    }
+
+    void IRIsel::emitLoad(Operator op, Register dst, const Address& addr)
+    {
+        if (addr.fi >= 0)
+        {
+            auto* ld    = createIInst(op, dst, PR::sp, 0);
+            ld->imme    = static_cast<int>(addr.off);
+            ld->fiop    = new FrameIndexOperand(addr.fi);
+            ld->use_ops = true;
+            m_block_->insts.push_back(ld);
+            return;
+        }
+        m_block_->insts.push_back(createIInst(op, dst, addr.base, static_cast<int>(addr.off)));
+    }
+
+    void IRIsel::emitStore(Operator op, Register val, const Address& addr)
+    {
+        if (addr.fi >= 0)
+        {
+            auto* st    = createSInst(op, val, PR::sp, 0);
+            st->imme    = static_cast<int>(addr.off);
+            st->fiop    = new FrameIndexOperand(addr.fi);
+            st->use_ops = true;
+            m_block_->insts.push_back(st);
+            return;
+        }
+        m_block_->insts.push_back(createSInst(op, val, addr.base, static_cast<int>(addr.off)));
+    }
+
+    void IRIsel::collectFrameObjects(ME::Function& func)
+    {
+        // 传出参数区大小与所有 alloca 的栈对象在进入函数时一并确定
+        m_func_->paramSize = computeCallFrameBytes(&func);
+        m_func_->frameInfo.setParamAreaSize(m_func_->paramSize);
+
+        for (auto& [blockId, block] : func.blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                if (inst->opcode != ME::Operator::ALLOCA) continue;
+                auto* alloca = static_cast<ME::AllocaInst*>(inst);
+                if (!alloca->res || alloca->res->getType() != ME::OperandType::REG) continue;
+
+                size_t id        = alloca->res->getRegNum();
+                int    totalSize = (alloca->dt == ME::DataType::F32 || alloca->dt == ME::DataType::I32) ? 4 : 8;
+                for (int dim : alloca->dims) totalSize *= dim;
+
+                m_func_->frameInfo.createLocalObject(id, totalSize, 16);
+                if (id >= allocaFI_.size()) allocaFI_.resize(id + 1, -1);
+                allocaFI_[id] = static_cast<int>(id);
+            }
+        }
+    }
+
+    void IRIsel::setupParameters(ME::Function& func)
+    {
+        BE::Block* entry = m_func_->blocks.empty() ? nullptr : m_func_->blocks.begin()->second;
+        if (!entry) return;
+
+        const Register iArgRegs[] = {PR::a0, PR::a1, PR::a2, PR::a3, PR::a4, PR::a5, PR::a6, PR::a7};
+        const Register fArgRegs[] = {PR::fa0, PR::fa1, PR::fa2, PR::fa3, PR::fa4, PR::fa5, PR::fa6, PR::fa7};
+
+        size_t argIdx = 0;
+        for (const auto& [argType, argOp] : func.funcDef->argRegs)
+        {
+            if (!argOp || argOp->getType() != ME::OperandType::REG) continue;
+
+            BE::DataType* beType = mapType(argType);
+            Register      vreg   = getOrCreateVReg(argOp->getRegNum(), beType);
+            m_func_->params.push_back(vreg);
+
+            if (argIdx < 8)
+            {
+                Register srcReg = isFloatReg(vreg) ? fArgRegs[argIdx] : iArgRegs[argIdx];
+                entry->insts.push_back(createMove(new RegOperand(vreg), new RegOperand(srcReg), "param_reg"));
+            }
+            else
+            {
+                auto* ld    = createIInst(getLoadOpForType(beType), vreg, PR::sp, static_cast<int>((argIdx - 8) * 8));
+                ld->comment = "param_stack";
+                entry->insts.push_back(ld);
+                m_func_->hasStackParam = true;
+            }
+            ++argIdx;
+        }
+    }
+
+    void IRIsel::visit(ME::Module& module)
+    {
+        importGlobalVariables(&module, m_backend_module);
+        for (auto* func : module.functions) apply(*this, *func);
+    }
+
+    void IRIsel::visit(ME::Function& func) { m_backend_module->functions.push_back(selectFunction(func)); }
+
+    BE::Function* IRIsel::selectFunction(ME::Function& func)
+    {
+        m_func_ = new BE::Function(func.funcDef->funcName);
+        VRegScope vregScope(m_func_);
+
+        size_t maxReg = func.getMaxReg() + 1;
+        vregMap_.assign(maxReg, Register());
+        allocaFI_.assign(maxReg, -1);
+
+        collectFrameObjects(func);
+
+        for (auto& [blockId, block] : func.blocks)
+            m_func_->blocks[static_cast<uint32_t>(blockId)] = new BE::Block(static_cast<uint32_t>(blockId));
+
+        setupParameters(func);
+
+        for (auto& [blockId, block] : func.blocks) apply(*this, *block);
+        return m_func_;
+    }
+
+    void IRIsel::visit(ME::Block& block)
+    {
+        m_block_ = m_func_->blocks[static_cast<uint32_t>(block.blockId)];
+        for (auto* inst : block.insts) apply(*this, *inst);
+    }
+
+    void IRIsel::visit(ME::LoadInst& inst)
+    {
+        BE::DataType* dt   = mapType(inst.dt);
+        Address       addr = selectAddress(inst.ptr);
+        Register      dst  = getOrCreateVReg(inst.res->getRegNum(), dt);
+        emitLoad(getLoadOpForType(dt), dst, addr);
+    }
+
+    void IRIsel::visit(ME::StoreInst& inst)
+    {
+        BE::DataType* dt   = mapType(inst.dt);
+        Register      val  = getOperandReg(inst.val, dt);
+        Address       addr = selectAddress(inst.ptr);
+        emitStore(getStoreOpForType(dt), val, addr);
+    }
+
+    void IRIsel::visit(ME::ArithmeticInst& inst)
+    {
+        BE::DataType* dt  = mapType(inst.dt);
+        Register      dst = getOrCreateVReg(inst.res->getRegNum(), dt);
+
+        if (dt == BE::F32 || dt == BE::F64)
+        {
+            Operator op;
+            switch (inst.opcode)
+            {
+                case ME::Operator::FADD: op = Operator::FADD_S; break;
+                case ME::Operator::FSUB: op = Operator::FSUB_S; break;
+                case ME::Operator::FMUL: op = Operator::FMUL_S; break;
+                case ME::Operator::FDIV: op = Operator::FDIV_S; break;
+                default: ERROR("Unsupported float arithmetic opcode"); return;
+            }
+            Register lhs = getOperandReg(inst.lhs, dt);
+            Register rhs = getOperandReg(inst.rhs, dt);
+            m_block_->insts.push_back(createRInst(op, dst, lhs, rhs));
+            return;
+        }
+
+        bool     is32 = (dt == BE::I32);
+        Operator op, iop = Operator::ADDI;
+        bool     hasImmForm = true, commutative = false;
+        switch (inst.opcode)
+        {
+            case ME::Operator::ADD:
+                op = is32 ? Operator::ADDW : Operator::ADD, iop = is32 ? Operator::ADDIW : Operator::ADDI;
+                commutative = true;
+                break;
+            case ME::Operator::SUB: op = is32 ? Operator::SUBW : Operator::SUB, hasImmForm = false; break;
+            case ME::Operator::MUL: op = is32 ? Operator::MULW : Operator::MUL, hasImmForm = false; break;
+            case ME::Operator::DIV: op = is32 ? Operator::DIVW : Operator::DIV, hasImmForm = false; break;
+            case ME::Operator::MOD: op = is32 ? Operator::REMW : Operator::REM, hasImmForm = false; break;
+            case ME::Operator::BITAND: op = Operator::AND, iop = Operator::ANDI, commutative = true; break;
+            case ME::Operator::BITXOR: op = Operator::XOR, iop = Operator::XORI, commutative = true; break;
+            case ME::Operator::SHL:
+                op = is32 ? Operator::SLLW : Operator::SLL, iop = is32 ? Operator::SLLIW : Operator::SLLI;
+                break;
+            case ME::Operator::ASHR:
+                op = is32 ? Operator::SRAW : Operator::SRA, iop = is32 ? Operator::SRAIW : Operator::SRAI;
+                break;
+            case ME::Operator::LSHR:
+                op = is32 ? Operator::SRLW : Operator::SRL, iop = is32 ? Operator::SRLIW : Operator::SRLI;
+                break;
+            default: ERROR("Unsupported integer arithmetic opcode"); return;
+        }
+
+        ME::Operand* lhsOp = inst.lhs;
+        ME::Operand* rhsOp = inst.rhs;
+        int          imm   = 0;
+        // 常量放到右侧；两侧均为常量时让 0 留在左侧以便使用 x0
+        int rhsImm = 0;
+        if (commutative && getImm12(lhsOp, imm) && (!getImm12(rhsOp, rhsImm) || rhsImm == 0))
+            std::swap(lhsOp, rhsOp);
+
+        // x - c 改写为 x + (-c)
+        if (inst.opcode == ME::Operator::SUB && getImm12(rhsOp, imm) && imm != -2048)
+        {
+            Register lhs = getOperandReg(lhsOp, dt);
+            m_block_->insts.push_back(createIInst(is32 ? Operator::ADDIW : Operator::ADDI, dst, lhs, -imm));
+            return;
+        }
+        bool isShift = inst.opcode == ME::Operator::SHL || inst.opcode == ME::Operator::ASHR ||
+                       inst.opcode == ME::Operator::LSHR;
+        if (hasImmForm && getImm12(rhsOp, imm) && (!isShift || (imm >= 0 && imm < (is32 ? 32 : 64))))
+        {
+            Register lhs = getOperandReg(lhsOp, dt);
+            m_block_->insts.push_back(createIInst(iop, dst, lhs, imm));
+            return;
+        }
+
+        Register lhs = getOperandReg(lhsOp, dt);
+        Register rhs = getOperandReg(rhsOp, dt);
+        m_block_->insts.push_back(createRInst(op, dst, lhs, rhs));
+    }
+
+    void IRIsel::visit(ME::IcmpInst& inst)
+    {
+        BE::DataType* dt  = mapType(inst.dt);
+        Register      dst = getOrCreateVReg(inst.res->getRegNum(), BE::I32);
+        Register      lhs = getOperandReg(inst.lhs, dt);
+        Register      rhs = getOperandReg(inst.rhs, dt);
+
+        // 对结果取反的条件先算出相反比较，再 xori 1
+        auto negated = [&](Operator op, Register a, Register b) {
+            Register tmp = getVReg(BE::I64);
+            m_block_->insts.push_back(createRInst(op, tmp, a, b));
+            m_block_->insts.push_back(createIInst(Operator::XORI, dst, tmp, 1));
+        };
+
+        switch (inst.cond)
+        {
+            case ME::ICmpOp::EQ:
+            case ME::ICmpOp::NE:
+            {
+                Register diff = lhs;
+                if (!(rhs == PR::x0))
+                {
+                    diff = getVReg(BE::I64);
+                    m_block_->insts.push_back(createRInst(Operator::XOR, diff, lhs, rhs));
+                }
+                if (inst.cond == ME::ICmpOp::EQ)
+                    m_block_->insts.push_back(createIInst(Operator::SLTIU, dst, diff, 1));
+                else
+                    m_block_->insts.push_back(createRInst(Operator::SLTU, dst, PR::x0, diff));
+                break;
+            }
+            case ME::ICmpOp::SLT: m_block_->insts.push_back(createRInst(Operator::SLT, dst, lhs, rhs)); break;
+            case ME::ICmpOp::SGT: m_block_->insts.push_back(createRInst(Operator::SLT, dst, rhs, lhs)); break;
+            case ME::ICmpOp::SGE: negated(Operator::SLT, lhs, rhs); break;
+            case ME::ICmpOp::SLE: negated(Operator::SLT, rhs, lhs); break;
+            case ME::ICmpOp::ULT: m_block_->insts.push_back(createRInst(Operator::SLTU, dst, lhs, rhs)); break;
+            case ME::ICmpOp::UGT: m_block_->insts.push_back(createRInst(Operator::SLTU, dst, rhs, lhs)); break;
+            case ME::ICmpOp::UGE: negated(Operator::SLTU, lhs, rhs); break;
+            case ME::ICmpOp::ULE: negated(Operator::SLTU, rhs, lhs); break;
+            default: ERROR("Unsupported ICMP condition: %d", static_cast<int>(inst.cond));
+        }
+    }
+
+    void IRIsel::visit(ME::FcmpInst& inst)
+    {
+        Register dst = getOrCreateVReg(inst.res->getRegNum(), BE::I32);
+        Register lhs = getOperandReg(inst.lhs, BE::F32);
+        Register rhs = getOperandReg(inst.rhs, BE::F32);
+
+        switch (inst.cond)
+        {
+            case ME::FCmpOp::OEQ:
+            case ME::FCmpOp::UEQ: m_block_->insts.push_back(createRInst(Operator::FEQ_S, dst, lhs, rhs)); break;
+            case ME::FCmpOp::OLT:
+            case ME::FCmpOp::ULT: m_block_->insts.push_back(createRInst(Operator::FLT_S, dst, lhs, rhs)); break;
+            case ME::FCmpOp::OLE:
+            case ME::FCmpOp::ULE: m_block_->insts.push_back(createRInst(Operator::FLE_S, dst, lhs, rhs)); break;
+            case ME::FCmpOp::OGT:
+            case ME::FCmpOp::UGT: m_block_->insts.push_back(createRInst(Operator::FLT_S, dst, rhs, lhs)); break;
+            case ME::FCmpOp::OGE:
+            case ME::FCmpOp::UGE: m_block_->insts.push_back(createRInst(Operator::FLE_S, dst, rhs, lhs)); break;
+            case ME::FCmpOp::ONE:
+            case ME::FCmpOp::UNE:
+            {
+                Register tmp = getVReg(BE::I64);
+                m_block_->insts.push_back(createRInst(Operator::FEQ_S, tmp, lhs, rhs));
+                m_block_->insts.push_back(createIInst(Operator::XORI, dst, tmp, 1));
+                break;
+            }
+            default: ERROR("Unsupported FCMP condition: %d", static_cast<int>(inst.cond));
+        }
+    }
+
+    // 栈对象已在进入函数时统一创建
+    void IRIsel::visit(ME::AllocaInst& inst) { (void)inst; }
+
+    void IRIsel::visit(ME::BrCondInst& inst)
+    {
+        int trueLabel  = static_cast<int>(inst.trueTar->getLabelNum());
+        int falseLabel = static_cast<int>(inst.falseTar->getLabelNum());
+
+        if (inst.cond->getType() == ME::OperandType::IMMEI32)
+        {
+            int target = static_cast<ME::ImmeI32Operand*>(inst.cond)->value ? trueLabel : falseLabel;
+            m_block_->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(target)));
+            return;
+        }
+
+        Register cond = getOperandReg(inst.cond, BE::I32);
+        m_block_->insts.push_back(createBInst(Operator::BNE, cond, PR::x0, Label(trueLabel)));
+        m_block_->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(falseLabel)));
+    }
+
+    void IRIsel::visit(ME::BrUncondInst& inst)
+    {
+        int target = static_cast<int>(inst.target->getLabelNum());
+        m_block_->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(target)));
+    }
+
+    void IRIsel::visit(ME::CallInst& inst)
+    {
+        std::string funcName = inst.funcName;
+        if (funcName.find("llvm.memset") != std::string::npos)
+            funcName = "memset";
+        else if (funcName.find("llvm.memcpy") != std::string::npos)
+            funcName = "memcpy";
+
+        const Register iArgRegs[] = {PR::a0, PR::a1, PR::a2, PR::a3, PR::a4, PR::a5, PR::a6, PR::a7};
+        const Register fArgRegs[] = {PR::fa0, PR::fa1, PR::fa2, PR::fa3, PR::fa4, PR::fa5, PR::fa6, PR::fa7};
+
+        int argCount = static_cast<int>(inst.args.size());
+        int tempBase = argCount > 8 ? (argCount - 8) * 8 : 0;  // 临时区紧跟在真实栈参数之后
+
+        // 先将所有参数写入栈上的缓冲区，再统一加载到参数寄存器，避免搬运覆盖尚未使用的源值
+        for (int pos = 0; pos < argCount; ++pos)
+        {
+            auto& [argType, argOp] = inst.args[pos];
+            BE::DataType* dt       = mapType(argType);
+            Register      argReg   = getOperandReg(argOp, dt);
+            int           off      = pos < 8 ? tempBase + pos * 8 : (pos - 8) * 8;
+            auto*         st       = createSInst(getStoreOpForType(dt), argReg, PR::sp, off);
+            st->comment            = "call_stackarg";
+            m_block_->insts.push_back(st);
+        }
+
+        int iRegCnt = 0, fRegCnt = 0;
+        for (int pos = 0; pos < argCount && pos < 8; ++pos)
+        {
+            BE::DataType* dt      = mapType(inst.args[pos].first);
+            bool          isFloat = (dt == BE::F32 || dt == BE::F64);
+            Register      dst     = isFloat ? fArgRegs[pos] : iArgRegs[pos];
+            auto*         ld      = createIInst(getLoadOpForType(dt), dst, PR::sp, tempBase + pos * 8);
+            ld->comment           = "call_stackarg";
+            m_block_->insts.push_back(ld);
+            if (isFloat)
+                ++fRegCnt;
+            else
+                ++iRegCnt;
+        }
+
+        m_block_->insts.push_back(createCallInst(Operator::CALL, funcName, iRegCnt, fRegCnt));
+
+        if (inst.res && inst.retType != ME::DataType::VOID)
+        {
+            Register dst = getOrCreateVReg(inst.res->getRegNum(), mapType(inst.retType));
+            Register src = isFloatReg(dst) ? PR::fa0 : PR::a0;
+            m_block_->insts.push_back(createMove(new RegOperand(dst), new RegOperand(src), LOC_STR));
+        }
+    }
+
+    void IRIsel::visit(ME::RetInst& inst)
+    {
+        if (inst.res && inst.rt != ME::DataType::VOID)
+        {
+            BE::DataType* dt  = mapType(inst.rt);
+            Register      val = getOperandReg(inst.res, dt);
+            Register      dst = (dt == BE::F32 || dt == BE::F64) ? PR::fa0 : PR::a0;
+            m_block_->insts.push_back(createMove(new RegOperand(dst), new RegOperand(val), LOC_STR));
+        }
+        m_block_->insts.push_back(createIInst(Operator::JALR, PR::x0, PR::ra, 0));
+    }
+
+    void IRIsel::visit(ME::GEPInst& inst)
+    {
+        Register dst     = getOrCreateVReg(inst.res->getRegNum(), BE::I64);
+        auto     strides = gepByteStrides(inst);
+
+        // 常量下标折叠为一个字节偏移，变量下标逐个缩放
+        int64_t               constOff = 0;
+        std::vector<Register> terms;
+        for (size_t i = 0; i < inst.idxs.size(); ++i)
+        {
+            ME::Operand* idx = inst.idxs[i];
+            if (idx->getType() == ME::OperandType::IMMEI32)
+            {
+                constOff += static_cast<int64_t>(static_cast<ME::ImmeI32Operand*>(idx)->value) * strides[i];
+                continue;
+            }
+
+            Register idxReg = getOperandReg(idx, BE::I64);
+            Register scaled = getVReg(BE::I64);
+            int64_t  stride = strides[i];
+            if (stride > 0 && (stride & (stride - 1)) == 0)
+            {
+                int shift = 0;
+                while ((int64_t(1) << shift) < stride) ++shift;
+                m_block_->insts.push_back(createIInst(Operator::SLLI, scaled, idxReg, shift));
+            }
+            else
+            {
+                Register strideReg = getVReg(BE::I64);
+                m_block_->insts.push_back(createMove(new RegOperand(strideReg), static_cast<int>(stride), LOC_STR));
+                m_block_->insts.push_back(createRInst(Operator::MUL, scaled, idxReg, strideReg));
+            }
+            terms.push_back(scaled);
+        }
+
+        // 基址 + 常量偏移；最后一步直接写入结果寄存器
+        Register acc;
+        int      fi = allocaIndex(inst.basePtr);
+        if (fi >= 0)
+        {
+            acc          = terms.empty() ? dst : getVReg(BE::I64);
+            auto* addr   = createIInst(Operator::ADDI, acc, PR::sp, 0);
+            addr->imme   = static_cast<int>(constOff);
+            addr->fiop   = new FrameIndexOperand(fi);
+            addr->use_ops = true;
+            m_block_->insts.push_back(addr);
+        }
+        else
+        {
+            acc = getOperandReg(inst.basePtr, BE::I64);
+            if (constOff != 0 || terms.empty())
+            {
+                Register next = terms.empty() ? dst : getVReg(BE::I64);
+                emitAddImm(next, acc, constOff);
+                acc = next;
+            }
+        }
+
+        for (size_t i = 0; i < terms.size(); ++i)
+        {
+            Register next = (i + 1 == terms.size()) ? dst : getVReg(BE::I64);
+            m_block_->insts.push_back(createRInst(Operator::ADD, next, acc, terms[i]));
+            acc = next;
+        }
+    }
+
+    void IRIsel::visit(ME::FP2SIInst& inst)
+    {
+        Register src = getOperandReg(inst.src, BE::F32);
+        Register dst = getOrCreateVReg(inst.dest->getRegNum(), BE::I32);
+        m_block_->insts.push_back(createR2Inst(Operator::FCVT_W_S, dst, src));
+    }
+
+    void IRIsel::visit(ME::SI2FPInst& inst)
+    {
+        Register src = getOperandReg(inst.src, BE::I32);
+        Register dst = getOrCreateVReg(inst.dest->getRegNum(), BE::F32);
+        m_block_->insts.push_back(createR2Inst(Operator::FCVT_S_W, dst, src));
+    }
+
+    void IRIsel::visit(ME::ZextInst& inst)
+    {
+        size_t destId = inst.dest->getRegNum();
+
+        // i1 只取 0/1，零扩展不改变值：结果尚未映射时直接复用源寄存器
+        if (inst.from == ME::DataType::I1 && inst.src->getType() == ME::OperandType::REG &&
+            (destId >= vregMap_.size() || !vregMap_[destId].dt))
+        {
+            Register src = getOperandReg(inst.src, BE::I32);
+            if (destId >= vregMap_.size()) vregMap_.resize(destId + 1);
+            vregMap_[destId] = src;
+            return;
+        }
+
+        Register src = getOperandReg(inst.src, mapType(inst.from));
+        Register dst = getOrCreateVReg(destId, mapType(inst.to));
+        m_block_->insts.push_back(createR2Inst(Operator::ZEXT_W, dst, src));
+    }
+
+    void IRIsel::visit(ME::PhiInst& inst)
+    {
+        BE::DataType* dt  = mapType(inst.dt);
+        Register      dst = getOrCreateVReg(inst.res->getRegNum(), dt);
+        auto*         phi = new PhiInst(dst);
+
+        // 常量保留为立即数，由 PHI 消解在前驱块中实例化
+        for (auto& [labelOp, valOp] : inst.incomingVals)
+        {
+            uint32_t pred  = static_cast<uint32_t>(labelOp->getLabelNum());
+            Operand* srcOp = nullptr;
+            switch (valOp->getType())
+            {
+                case ME::OperandType::IMMEI32: srcOp = new I32Operand(static_cast<ME::ImmeI32Operand*>(valOp)->value); break;
+                case ME::OperandType::IMMEF32: srcOp = new F32Operand(static_cast<ME::ImmeF32Operand*>(valOp)->value); break;
+                case ME::OperandType::REG: srcOp = new RegOperand(getOrCreateVReg(valOp->getRegNum(), dt)); break;
+                default: ERROR("Unsupported PHI incoming operand"); break;
+            }
+            phi->incomingVals[pred] = srcOp;
+        }
+        m_block_->insts.push_back(phi);
+    }
 
     void IRIsel::visit(ME::GlbVarDeclInst& inst)
     {
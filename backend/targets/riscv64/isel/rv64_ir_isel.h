@@ -2,6 +2,8 @@
 #define __BACKEND_TARGETS_RISCV64_ISEL_RV64_IR_ISEL_H__
 
 #include <backend/isel/isel_base.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <vector>
 
 /*
  * 注：当前目录下有 rv64_dag_isel 与 rv64_ir_isel 两份实现，它们的功能是一致的，你只需要选择其中一份来完成就行
@@ -26,6 +28,11 @@
  * 随后记录一下 ，%a 的结果存储在 v_3_i32 中即可，后续如果有指令使用到 %a，那么通过查表的方式使用 v_3_i32 来代表 %a 即可
  *
  * 因此，这里就不给出过多的注释了与解释了，类似工作在生成中间代码的时候已经做过了
+ *
+ * 本实现作为 -O0 的快速路径：不构建 SelectionDAG，按块顺序一遍翻译
+ * - IR 寄存器到 vreg、alloca 到栈帧索引的映射均为按寄存器编号索引的数组
+ * - 常量 0 直接使用 x0，12 位立即数使用 I 型指令
+ * - alloca 上的访存直接使用帧索引寻址，GEP 的常量部分折叠进偏移
  */
 
 namespace BE::Targeting
@@ -44,12 +51,42 @@ namespace BE::RV64
             : BE::ISelBase<IRIsel>(backend_module), ir_module_(ir_module), target_(target)
         {}
 
+        /// 翻译单个函数，返回新建的后端函数（不加入后端模块）；不同 IRIsel 实例可以并发翻译不同函数
+        BE::Function* selectFunction(ME::Function& func);
+
       private:
         ME::Module*                   ir_module_;
         BE::Targeting::BackendTarget* target_;
 
+        BE::Function*         m_func_  = nullptr;
+        BE::Block*            m_block_ = nullptr;
+        std::vector<Register> vregMap_;   ///< IR 寄存器编号 -> vreg（dt 为空表示尚未映射）
+        std::vector<int>      allocaFI_;  ///< IR 寄存器编号 -> 栈帧索引（-1 表示不是 alloca）
+
+        // 访存地址：fi >= 0 时为 fi + off，否则为 base + off
+        struct Address
+        {
+            Register base;
+            int64_t  off = 0;
+            int      fi  = -1;
+        };
+
         void runImpl();
 
+        static BE::DataType* mapType(ME::DataType t);
+
+        Register getOrCreateVReg(size_t ir_reg_id, BE::DataType* dt);
+        int      allocaIndex(ME::Operand* op) const;
+        Register getOperandReg(ME::Operand* op, BE::DataType* dt);
+        bool     getImm12(ME::Operand* op, int& imm) const;
+        Address  selectAddress(ME::Operand* ptr);
+
+        void collectFrameObjects(ME::Function& func);
+        void setupParameters(ME::Function& func);
+        void emitAddImm(Register dst, Register src, int64_t imm);
+        void emitLoad(Operator op, Register dst, const Address& addr);
+        void emitStore(Operator op, Register val, const Address& addr);
+
       public:
         void visit(ME::Module& module) override;
         void visit(ME::Function& func) override;
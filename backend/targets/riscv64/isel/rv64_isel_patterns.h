@@ -0,0 +1,181 @@
+#ifndef __BACKEND_TARGETS_RISCV64_ISEL_RV64_ISEL_PATTERNS_H__
+#define __BACKEND_TARGETS_RISCV64_ISEL_RV64_ISEL_PATTERNS_H__
+
+#include <backend/dag/isd.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <middleend/ir_defs.h>
+
+/*
+ * RV64 指令选择模式表
+ *
+ * 每条模式描述一棵以 DAG 节点为根、深度不超过 2 的树：
+ *   根节点操作码 (+ 比较条件) + 结果类型 + 两个操作数的叶子约束 -> 目标指令 + 生成方式
+ * 叶子约束既可以是“任意寄存器”，也可以吃掉一个常量（立即数形式）或一个子节点（如 Zba 的移位加）。
+ * DAGIsel 的匹配引擎对同一节点枚举所有可匹配模式，按 RV64_INSTS 中的延迟累加代价
+ * （生成的指令 + 未被覆盖、需要单独实例化的常量），取代价最小者。
+ * 新增融合模式只需在表中加一行。
+ */
+namespace BE::RV64::ISelPattern
+{
+    // 结果类型
+    enum class Ty : uint8_t
+    {
+        I32,
+        I64,
+        F32,
+        Any  // 不区分宽度（比较指令作用于符号扩展后的整个寄存器）
+    };
+
+    // 操作数叶子约束
+    enum class Leaf : uint8_t
+    {
+        Reg,       // 任意值，放入寄存器（常量 0 使用 x0）
+        Zero,      // 常量 0
+        Imm12,     // 12 位有符号立即数
+        NegImm12,  // 取负后为 12 位有符号立即数
+        IncImm12,  // 加 1 后为 12 位有符号立即数
+        ShAmt,     // 合法移位量（32 位为 0~31，64 位为 0~63）
+        Pow2,      // 2 的正整数次幂
+        Shl1,      // (shl x, 1)，子节点被覆盖
+        Shl2,      // (shl x, 2)
+        Shl3,      // (shl x, 3)
+    };
+
+    // 生成方式
+    enum class Emit : uint8_t
+    {
+        RR,         // inst dst, a, b
+        RRSwap,     // inst dst, b, a
+        RI,         // inst dst, a, imm
+        RINeg,      // inst dst, a, -imm
+        RILog2,     // inst dst, a, log2(imm)
+        RRNot,      // inst t, a, b;     xori dst, t, 1
+        RRSwapNot,  // inst t, b, a;     xori dst, t, 1
+        RINot,      // inst t, a, imm;   xori dst, t, 1
+        RIInc,      // inst dst, a, imm+1
+        RIIncNot,   // inst t, a, imm+1; xori dst, t, 1
+        EqZ,        // inst dst, a, 1            (seqz)
+        NeZ,        // inst dst, x0, a           (snez)
+        EqRR,       // xor t, a, b;      inst dst, t, 1
+        NeRR,       // xor t, a, b;      inst dst, x0, t
+    };
+
+    constexpr int kAnyCond = -1;
+
+    struct Pattern
+    {
+        DAG::ISD op;
+        int      cond;  // ICMP 条件码，非比较为 kAnyCond
+        Ty       ty;
+        Leaf     lhs;
+        Leaf     rhs;
+        bool     commutable;  // 是否允许交换操作数后匹配
+        Operator inst;
+        Emit     emit;
+    };
+
+    constexpr int cc(ME::ICmpOp c) { return static_cast<int>(c); }
+
+    // clang-format off
+    inline constexpr Pattern kPatterns[] = {
+        // ---------------- 整数算术 ----------------
+        {DAG::ISD::ADD, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      true,  Operator::ADD,   Emit::RR},
+        {DAG::ISD::ADD, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Imm12,    true,  Operator::ADDI,  Emit::RI},
+        {DAG::ISD::ADD, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      true,  Operator::ADDW,  Emit::RR},
+        {DAG::ISD::ADD, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Imm12,    true,  Operator::ADDIW, Emit::RI},
+#if RV64_ENABLE_ZBA
+        {DAG::ISD::ADD, kAnyCond, Ty::I64, Leaf::Shl1, Leaf::Reg,     true,  Operator::SH1ADD, Emit::RR},
+        {DAG::ISD::ADD, kAnyCond, Ty::I64, Leaf::Shl2, Leaf::Reg,     true,  Operator::SH2ADD, Emit::RR},
+        {DAG::ISD::ADD, kAnyCond, Ty::I64, Leaf::Shl3, Leaf::Reg,     true,  Operator::SH3ADD, Emit::RR},
+#endif
+        {DAG::ISD::SUB, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      false, Operator::SUB,   Emit::RR},
+        {DAG::ISD::SUB, kAnyCond, Ty::I64, Leaf::Reg, Leaf::NegImm12, false, Operator::ADDI,  Emit::RINeg},
+        {DAG::ISD::SUB, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      false, Operator::SUBW,  Emit::RR},
+        {DAG::ISD::SUB, kAnyCond, Ty::I32, Leaf::Reg, Leaf::NegImm12, false, Operator::ADDIW, Emit::RINeg},
+
+        {DAG::ISD::MUL, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      true,  Operator::MUL,   Emit::RR},
+        {DAG::ISD::MUL, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Pow2,     true,  Operator::SLLI,  Emit::RILog2},
+        {DAG::ISD::MUL, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      true,  Operator::MULW,  Emit::RR},
+        {DAG::ISD::MUL, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Pow2,     true,  Operator::SLLIW, Emit::RILog2},
+
+        {DAG::ISD::DIV, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      false, Operator::DIV,   Emit::RR},
+        {DAG::ISD::DIV, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      false, Operator::DIVW,  Emit::RR},
+        {DAG::ISD::MOD, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      false, Operator::REM,   Emit::RR},
+        {DAG::ISD::MOD, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      false, Operator::REMW,  Emit::RR},
+
+        // ---------------- 位运算与移位 ----------------
+        {DAG::ISD::AND, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      true,  Operator::AND,   Emit::RR},
+        {DAG::ISD::AND, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Imm12,    true,  Operator::ANDI,  Emit::RI},
+        {DAG::ISD::AND, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      true,  Operator::AND,   Emit::RR},
+        {DAG::ISD::AND, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Imm12,    true,  Operator::ANDI,  Emit::RI},
+        {DAG::ISD::OR,  kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      true,  Operator::OR,    Emit::RR},
+        {DAG::ISD::OR,  kAnyCond, Ty::I64, Leaf::Reg, Leaf::Imm12,    true,  Operator::ORI,   Emit::RI},
+        {DAG::ISD::OR,  kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      true,  Operator::OR,    Emit::RR},
+        {DAG::ISD::OR,  kAnyCond, Ty::I32, Leaf::Reg, Leaf::Imm12,    true,  Operator::ORI,   Emit::RI},
+        {DAG::ISD::XOR, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,      true,  Operator::XOR,   Emit::RR},
+        {DAG::ISD::XOR, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Imm12,    true,  Operator::XORI,  Emit::RI},
+        {DAG::ISD::XOR, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,      true,  Operator::XOR,   Emit::RR},
+        {DAG::ISD::XOR, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Imm12,    true,  Operator::XORI,  Emit::RI},
+
+        {DAG::ISD::SHL,  kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,     false, Operator::SLL,   Emit::RR},
+        {DAG::ISD::SHL,  kAnyCond, Ty::I64, Leaf::Reg, Leaf::ShAmt,   false, Operator::SLLI,  Emit::RI},
+        {DAG::ISD::SHL,  kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,     false, Operator::SLLW,  Emit::RR},
+        {DAG::ISD::SHL,  kAnyCond, Ty::I32, Leaf::Reg, Leaf::ShAmt,   false, Operator::SLLIW, Emit::RI},
+        {DAG::ISD::ASHR, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,     false, Operator::SRA,   Emit::RR},
+        {DAG::ISD::ASHR, kAnyCond, Ty::I64, Leaf::Reg, Leaf::ShAmt,   false, Operator::SRAI,  Emit::RI},
+        {DAG::ISD::ASHR, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,     false, Operator::SRAW,  Emit::RR},
+        {DAG::ISD::ASHR, kAnyCond, Ty::I32, Leaf::Reg, Leaf::ShAmt,   false, Operator::SRAIW, Emit::RI},
+        {DAG::ISD::LSHR, kAnyCond, Ty::I64, Leaf::Reg, Leaf::Reg,     false, Operator::SRL,   Emit::RR},
+        {DAG::ISD::LSHR, kAnyCond, Ty::I64, Leaf::Reg, Leaf::ShAmt,   false, Operator::SRLI,  Emit::RI},
+        {DAG::ISD::LSHR, kAnyCond, Ty::I32, Leaf::Reg, Leaf::Reg,     false, Operator::SRLW,  Emit::RR},
+        {DAG::ISD::LSHR, kAnyCond, Ty::I32, Leaf::Reg, Leaf::ShAmt,   false, Operator::SRLIW, Emit::RI},
+
+        // ---------------- 浮点算术 ----------------
+        {DAG::ISD::ADD,  kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     true,  Operator::FADD_S, Emit::RR},
+        {DAG::ISD::SUB,  kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     false, Operator::FSUB_S, Emit::RR},
+        {DAG::ISD::MUL,  kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     true,  Operator::FMUL_S, Emit::RR},
+        {DAG::ISD::DIV,  kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     false, Operator::FDIV_S, Emit::RR},
+        {DAG::ISD::FADD, kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     true,  Operator::FADD_S, Emit::RR},
+        {DAG::ISD::FSUB, kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     false, Operator::FSUB_S, Emit::RR},
+        {DAG::ISD::FMUL, kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     true,  Operator::FMUL_S, Emit::RR},
+        {DAG::ISD::FDIV, kAnyCond, Ty::F32, Leaf::Reg, Leaf::Reg,     false, Operator::FDIV_S, Emit::RR},
+
+        // ---------------- 整数比较（结果为 0/1） ----------------
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::EQ),  Ty::Any, Leaf::Reg, Leaf::Zero,     true,  Operator::SLTIU, Emit::EqZ},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::EQ),  Ty::Any, Leaf::Reg, Leaf::Reg,      true,  Operator::SLTIU, Emit::EqRR},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::NE),  Ty::Any, Leaf::Reg, Leaf::Zero,     true,  Operator::SLTU,  Emit::NeZ},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::NE),  Ty::Any, Leaf::Reg, Leaf::Reg,      true,  Operator::SLTU,  Emit::NeRR},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SLT), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLT,   Emit::RR},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SLT), Ty::Any, Leaf::Reg, Leaf::Imm12,    false, Operator::SLTI,  Emit::RI},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SLE), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLT,   Emit::RRSwapNot},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SLE), Ty::Any, Leaf::Reg, Leaf::IncImm12, false, Operator::SLTI,  Emit::RIInc},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SGT), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLT,   Emit::RRSwap},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SGT), Ty::Any, Leaf::Reg, Leaf::IncImm12, false, Operator::SLTI,  Emit::RIIncNot},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SGE), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLT,   Emit::RRNot},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::SGE), Ty::Any, Leaf::Reg, Leaf::Imm12,    false, Operator::SLTI,  Emit::RINot},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::ULT), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLTU,  Emit::RR},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::ULT), Ty::Any, Leaf::Reg, Leaf::Imm12,    false, Operator::SLTIU, Emit::RI},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::ULE), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLTU,  Emit::RRSwapNot},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::UGT), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLTU,  Emit::RRSwap},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::UGE), Ty::Any, Leaf::Reg, Leaf::Reg,      false, Operator::SLTU,  Emit::RRNot},
+        {DAG::ISD::ICMP, cc(ME::ICmpOp::UGE), Ty::Any, Leaf::Reg, Leaf::Imm12,    false, Operator::SLTIU, Emit::RINot},
+    };
+    // clang-format on
+
+    // 生成方式本身的代价（不含根指令）：取反需额外 xori，等值比较需额外 xor
+    inline int emitExtraCost(Emit e)
+    {
+        switch (e)
+        {
+            case Emit::RRNot:
+            case Emit::RRSwapNot:
+            case Emit::RINot:
+            case Emit::RIIncNot: return getOpLatency(Operator::XORI);
+            case Emit::EqRR:
+            case Emit::NeRR: return getOpLatency(Operator::XOR);
+            default: return 0;
+        }
+    }
+}  // namespace BE::RV64::ISelPattern
+
+#endif  // __BACKEND_TARGETS_RISCV64_ISEL_RV64_ISEL_PATTERNS_H__
@@ -0,0 +1,120 @@
+#include <backend/targets/riscv64/isel/rv64_isel_utils.h>
+#include <middleend/module/ir_function.h>
+#include <middleend/module/ir_instruction.h>
+#include <transfer.h>
+#include <algorithm>
+
+namespace BE::RV64
+{
+    // 获取Load操作码
+    Operator getLoadOpForType(BE::DataType* dt)
+    {
+        // 获取数据长度，若类型缺失则默认为 32 位（SysY 整数为 32 位，防止 64 位操作覆盖相邻数据）
+        BE::DataType::Length len;
+        if (dt)
+            len = dt->dl;
+        else
+            len = BE::DataType::Length::B32;
+        // 如果数据类型是浮点型
+        if (dt && dt->dt == BE::DataType::Type::FLOAT)
+        {
+            // 32 位返回 FLW，否则返回 FLD
+            if (len == BE::DataType::Length::B32)
+                return Operator::FLW;
+            else
+                return Operator::FLD;
+        }
+        // 32 位返回 LW，否则返回 LD
+        if (len == BE::DataType::Length::B32)
+            return Operator::LW;
+        else
+            return Operator::LD;
+    }
+
+    //获取Store操作码
+    Operator getStoreOpForType(BE::DataType* dt)
+    {
+        BE::DataType::Length len;
+        if (dt)
+            len = dt->dl;
+        else
+            len = BE::DataType::Length::B32;
+
+        if (dt && dt->dt == BE::DataType::Type::FLOAT)
+        {
+            if (len == BE::DataType::Length::B32)
+                return Operator::FSW;
+            else
+                return Operator::FSD;
+        }
+
+        if (len == BE::DataType::Length::B32)
+            return Operator::SW;
+        else
+            return Operator::SD;
+    }
+
+    void importGlobalVariables(ME::Module* ir_module, BE::Module* backend_module)
+    {
+        // 遍历 IR 模块中的所有全局变量
+        for (auto* glb : ir_module->globalVars)
+        {
+            // 转换类型: ME::DataType -> BE::DataType
+            BE::DataType* beType = BE::I32;  // 默认 I32
+            if (glb->dt == ME::DataType::F32)
+                beType = BE::F32;
+            else if (glb->dt == ME::DataType::I64 || glb->dt == ME::DataType::PTR)
+                beType = BE::I64;
+
+            // 创建后端全局变量对象
+            auto* gv = new BE::GlobalVariable(beType, glb->name);
+
+            // 处理数组维度
+            gv->dims = glb->initList.arrayDims;
+
+            // 处理初始化值
+            if (glb->init)
+            {
+                // 标量初始化
+                if (auto* immI32 = dynamic_cast<ME::ImmeI32Operand*>(glb->init))
+                    gv->initVals.push_back(immI32->value);
+                else if (auto* immF32 = dynamic_cast<ME::ImmeF32Operand*>(glb->init))
+                    gv->initVals.push_back(FLOAT_TO_INT_BITS(immF32->value));
+            }
+            else if (!glb->initList.initList.empty())
+            {
+                // 数组初始化列表
+                for (const auto& val : glb->initList.initList)
+                {
+                    if (val.type == FE::AST::floatType)
+                        gv->initVals.push_back(FLOAT_TO_INT_BITS(val.floatValue));
+                    else
+                        gv->initVals.push_back(val.intValue);
+                }
+            }
+
+            backend_module->globals.push_back(gv);
+        }
+    }
+
+    int computeCallFrameBytes(ME::Function* ir_func)
+    {
+        // 遍历所有 CALL 指令找最大参数数量
+        int maxCallBytes = 0;
+        for (auto& [blockId, block] : ir_func->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                if (auto* call = dynamic_cast<ME::CallInst*>(inst))
+                {
+                    int argCount      = static_cast<int>(call->args.size());
+                    int stackArgBytes = std::max(0, argCount - 8) * 8;
+                    int regTempBytes  = std::min(argCount, 8) * 8;  // 为 a0-a7 预留的临时区
+                    int totalBytes    = stackArgBytes + regTempBytes;
+                    if (totalBytes > maxCallBytes) maxCallBytes = totalBytes;
+                }
+            }
+        }
+        return maxCallBytes;
+    }
+}  // namespace BE::RV64
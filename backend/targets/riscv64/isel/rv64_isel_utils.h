@@ -0,0 +1,25 @@
+#ifndef __BACKEND_TARGETS_RISCV64_ISEL_RV64_ISEL_UTILS_H__
+#define __BACKEND_TARGETS_RISCV64_ISEL_RV64_ISEL_UTILS_H__
+
+#include <backend/mir/m_module.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <middleend/module/ir_module.h>
+
+/*
+ * DAGIsel 与 IRIsel 共用的与指令选择方式无关的部分：
+ * 访存指令选择、全局变量导入、传出参数区大小的计算
+ */
+namespace BE::RV64
+{
+    // 按数据类型选择 Load/Store 操作码（类型缺失时按 32 位处理）
+    Operator getLoadOpForType(BE::DataType* dt);
+    Operator getStoreOpForType(BE::DataType* dt);
+
+    // 将 IR 全局变量导入后端模块
+    void importGlobalVariables(ME::Module* ir_module, BE::Module* backend_module);
+
+    // 函数内所有调用所需的传出参数区大小：栈参数 + 为 a0-a7 预留的搬运临时区
+    int computeCallFrameBytes(ME::Function* ir_func);
+}  // namespace BE::RV64
+
+#endif  // __BACKEND_TARGETS_RISCV64_ISEL_RV64_ISEL_UTILS_H__
@@ -182,7 +182,10 @@ namespace BE::RV64::Passes::Lowering
     void PhiEliminationPass::runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter)
     {
         for (auto* func : module.functions)
+        {
+            VRegScope vregScope(func);
             runOnFunction(func, adapter);
+        }
     }
 
     void PhiEliminationPass::runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter)
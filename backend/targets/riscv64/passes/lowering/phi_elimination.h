@@ -22,12 +22,13 @@ namespace BE::RV64::Passes::Lowering
         ~PhiEliminationPass() = default;
 
         void runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter);
+        /// 处理单个函数，需在该函数的 VRegScope 内调用
+        void runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter);
 
       private:
       // 一个前驱块可能对应多个 PHI 的拷贝（多个 PHI 指令共享同一前驱）
         using CopyList = std::vector<std::pair<Register, Operand*>>;
 
-        void runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter);
         std::vector<PhiInst*> collectPhis(BE::Block* block);
         std::map<uint32_t, CopyList> aggregateCopies(const std::vector<PhiInst*>& phis);
         BE::Block* splitCriticalEdge(BE::Function* func, BE::Block* predBlock, uint32_t blockId,
@@ -0,0 +1,229 @@
+#include <backend/targets/riscv64/passes/optimize/const_materialize.h>
+#include <debug.h>
+#include <algorithm>
+
+namespace BE::RV64::Passes::Optimize
+{
+    using namespace BE;
+    using namespace BE::RV64;
+
+    void ConstMaterializePass::runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter)
+    {
+        for (auto* func : module.functions)
+        {
+            VRegScope vregScope(func);
+            runOnFunction(func, adapter);
+        }
+    }
+
+    bool ConstMaterializePass::needsMultiInst(int32_t val) { return val < -2048 || val > 2047; }
+
+    // li 伪指令的实际展开代价：addi / lui / lui+addiw
+    int ConstMaterializePass::intMaterializeCost(int32_t val)
+    {
+        if (!needsMultiInst(val)) return getOpLatency(Operator::LI);
+        if ((val & 0xfff) == 0) return getOpLatency(Operator::LUI);
+        return getOpLatency(Operator::LUI) + getOpLatency(Operator::ADDIW);
+    }
+
+    bool ConstMaterializePass::preferPoolLoad(uint32_t bits) const
+    {
+        if (bits == 0) return false;
+        int synthCost = intMaterializeCost(static_cast<int32_t>(bits)) + getOpLatency(Operator::FMV_W_X);
+        int poolCost  = getOpLatency(Operator::LUI) + getOpLatency(Operator::FLW);
+        // 代价相同时优先寄存器合成，避免额外的访存
+        return poolCost < synthCost;
+    }
+
+    std::map<ConstMaterializePass::ConstKey, std::vector<ConstMaterializePass::Site>>
+    ConstMaterializePass::collectSites()
+    {
+        // 只处理单定义的 vreg，浮点临时寄存器还需仅被 FMV_W_X 使用
+        std::map<Register, int> defCnt, useCnt;
+        std::vector<Register>   regs;
+        for (auto& [bid, block] : func_->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                adapter_->enumDefs(inst, regs);
+                for (auto& r : regs) ++defCnt[r];
+                adapter_->enumUses(inst, regs);
+                for (auto& r : regs) ++useCnt[r];
+            }
+        }
+
+        std::map<ConstKey, std::vector<Site>> groups;
+        for (auto& [bid, block] : func_->blocks)
+        {
+            auto& insts = block->insts;
+            for (size_t i = 0; i < insts.size(); ++i)
+            {
+                if (insts[i]->kind != InstKind::MOVE) continue;
+                auto* mv = static_cast<MoveInst*>(insts[i]);
+                if (!mv->src || mv->src->ot != Operand::Type::IMMI32) continue;
+                if (!mv->dest || mv->dest->ot != Operand::Type::REG) continue;
+
+                Register dst = static_cast<RegOperand*>(mv->dest)->reg;
+                int32_t  val = static_cast<I32Operand*>(mv->src)->val;
+                if (!dst.isVreg || defCnt[dst] != 1) continue;
+
+                auto* next = i + 1 < insts.size() ? dynamic_cast<Instr*>(insts[i + 1]) : nullptr;
+                if (next && next->op == Operator::FMV_W_X && next->rs1 == dst && useCnt[dst] == 1 &&
+                    next->rd.isVreg && defCnt[next->rd] == 1)
+                {
+                    groups[{true, static_cast<uint32_t>(val)}].push_back(Site{block, mv, next, next->rd});
+                    ++i;
+                    continue;
+                }
+                if (needsMultiInst(val))
+                    groups[{false, static_cast<uint32_t>(val)}].push_back(Site{block, mv, nullptr, dst});
+            }
+        }
+        return groups;
+    }
+
+    std::vector<MInstruction*> ConstMaterializePass::materialize(const ConstKey& key, Register dst)
+    {
+        auto [isFloat, bits] = key;
+        if (!isFloat) return {createMove(new RegOperand(dst), static_cast<int>(bits), "hoisted const")};
+
+        if (bits == 0) return {createR2Inst(Operator::FMV_W_X, dst, PR::x0)};
+
+        if (preferPoolLoad(bits))
+        {
+            auto it = poolIndex_.find(bits);
+            if (it == poolIndex_.end())
+            {
+                it = poolIndex_.emplace(bits, func_->constPool.size()).first;
+                func_->constPool.push_back(bits);
+            }
+            std::string name = getConstPoolLabel(func_->name, it->second);
+            Register    hi   = getVReg(BE::I64);
+            return {createUInst(Operator::LUI, hi, Label(name, true)),
+                createIInst(Operator::FLW, dst, hi, Label(name, false))};
+        }
+
+        Register tmp = getVReg(BE::I32);
+        return {createMove(new RegOperand(tmp), static_cast<int>(bits), "hoisted const"),
+            createR2Inst(Operator::FMV_W_X, dst, tmp)};
+    }
+
+    void ConstMaterializePass::rewriteFloatSite(const Site& site, uint32_t bits)
+    {
+        if (bits != 0 && !preferPoolLoad(bits)) return;
+
+        auto& insts = site.block->insts;
+        auto  it    = std::find(insts.begin(), insts.end(), site.move);
+        ASSERT(it != insts.end() && std::next(it) != insts.end() && *std::next(it) == site.fmv);
+
+        auto repl = materialize({true, bits}, site.result);
+        it        = insts.erase(it, std::next(it, 2));
+        insts.insert(it, repl.begin(), repl.end());
+        MInstruction::delInst(site.move);
+        MInstruction::delInst(site.fmv);
+    }
+
+    void ConstMaterializePass::eraseSite(const Site& site)
+    {
+        auto& insts = site.block->insts;
+        insts.erase(std::remove_if(insts.begin(), insts.end(),
+                        [&](MInstruction* inst) { return inst == site.move || inst == site.fmv; }),
+            insts.end());
+        MInstruction::delInst(site.move);
+        if (site.fmv) MInstruction::delInst(site.fmv);
+    }
+
+    size_t ConstMaterializePass::insertPointBeforeTerminator(BE::Block* block) const
+    {
+        size_t pos = block->insts.size();
+        while (pos > 0)
+        {
+            auto* inst = block->insts[pos - 1];
+            if (!adapter_->isCondBranch(inst) && !adapter_->isUncondBranch(inst) && !adapter_->isReturn(inst)) break;
+            --pos;
+        }
+        return pos;
+    }
+
+    void ConstMaterializePass::runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter)
+    {
+        adapter_ = adapter;
+        func_    = func;
+        poolIndex_.clear();
+
+        BE::MIR::CFGBuilder builder(adapter_);
+        BE::MIR::CFG*       cfg = builder.buildCFGForFunction(func);
+        if (!cfg) return;
+        BE::MIR::LoopInfo loops(cfg);
+
+        std::map<Register, Register> replaced;
+        for (auto& [key, sites] : collectSites())
+        {
+            bool reachable = true;
+            bool inLoop    = false;
+            for (auto& s : sites)
+            {
+                reachable &= loops.isReachable(s.block->blockId);
+                inLoop |= loops.loopDepth(s.block->blockId) > 0;
+            }
+
+            // 无可复用、无可外提：浮点仍按代价模型就地改写
+            if (!reachable || (sites.size() == 1 && !inLoop))
+            {
+                if (key.first)
+                    for (auto& s : sites) rewriteFloatSite(s, key.second);
+                continue;
+            }
+
+            // 所有实例化点的最近公共支配者，再沿支配树提到循环外
+            uint32_t target = sites[0].block->blockId;
+            for (auto& s : sites) target = loops.commonDominator(target, s.block->blockId);
+            while (loops.loopDepth(target) > 0 && target != loops.entry())
+                target = static_cast<uint32_t>(loops.idom(target));
+
+            // 目标块内已有实例化点时复用块内第一个（它先于同块内其它实例化点及其使用）
+            auto     canonIt = std::find_if(sites.begin(), sites.end(),
+                [target](const Site& s) { return s.block->blockId == target; });
+            Register canon;
+            if (canonIt != sites.end())
+            {
+                canon = canonIt->result;
+                if (key.first) rewriteFloatSite(*canonIt, key.second);
+            }
+            else
+            {
+                canon         = getVReg(key.first ? BE::F32 : BE::I64);
+                auto  repl    = materialize(key, canon);
+                auto* tBlock  = func->blocks.at(target);
+                auto  pos     = static_cast<std::ptrdiff_t>(insertPointBeforeTerminator(tBlock));
+                tBlock->insts.insert(tBlock->insts.begin() + pos, repl.begin(), repl.end());
+            }
+
+            for (auto it = sites.begin(); it != sites.end(); ++it)
+            {
+                if (it == canonIt) continue;
+                replaced[it->result] = canon;
+                eraseSite(*it);
+            }
+        }
+
+        if (!replaced.empty())
+        {
+            std::vector<Register> uses;
+            for (auto& [bid, block] : func->blocks)
+            {
+                for (auto* inst : block->insts)
+                {
+                    adapter_->enumUses(inst, uses);
+                    for (auto& r : uses)
+                    {
+                        auto it = replaced.find(r);
+                        if (it != replaced.end()) adapter_->replaceUse(inst, r, it->second);
+                    }
+                }
+            }
+        }
+
+        delete cfg;
+    }
+}  // namespace BE::RV64::Passes::Optimize
@@ -0,0 +1,68 @@
+#ifndef __BACKEND_RV64_PASSES_OPTIMIZE_CONST_MATERIALIZE_H__
+#define __BACKEND_RV64_PASSES_OPTIMIZE_CONST_MATERIALIZE_H__
+
+#include <backend/mir/m_module.h>
+#include <backend/mir/m_function.h>
+#include <backend/mir/m_block.h>
+#include <backend/mir/m_instruction.h>
+#include <backend/common/cfg.h>
+#include <backend/common/cfg_builder.h>
+#include <backend/common/loop_info.h>
+#include <backend/target/target_instr_adapter.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <map>
+#include <vector>
+
+/*
+ * 常量实例化（Pre-RA，SSA 形式的 MIR 上运行）
+ *
+ * 指令选择按块就地实例化常量：整数为 MOVE vreg, imm（宽立即数展开为 lui+addiw），
+ * 浮点为 MOVE vtmp, bits + FMV_W_X vdst, vtmp。本 Pass 在函数级：
+ * - 对相同常量做 CSE，统一放到所有使用块的最近公共支配者；
+ * - 若该位置在循环内，继续沿支配树上提到循环外；
+ * - 浮点常量按 RV64_INSTS 延迟表在“整数寄存器合成”与“.rodata 常量池加载”之间择优，
+ *   0.0 直接使用 fmv.w.x fd, x0。
+ * 仅处理需要多条指令合成的整数常量（超出 12 位有符号立即数），小立即数保持原地以免拉长活跃区间。
+ */
+namespace BE::RV64::Passes::Optimize
+{
+    class ConstMaterializePass
+    {
+      public:
+        ConstMaterializePass()  = default;
+        ~ConstMaterializePass() = default;
+
+        void runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter);
+        /// 处理单个函数，需在该函数的 VRegScope 内调用
+        void runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter);
+
+      private:
+        // 一处常量实例化；浮点常量由 MOVE + FMV_W_X 两条指令组成
+        struct Site
+        {
+            BE::Block* block;
+            MoveInst*  move;
+            Instr*     fmv;
+            Register   result;
+        };
+        // <是否浮点, 32 位位模式>
+        using ConstKey = std::pair<bool, uint32_t>;
+
+        BE::Function*                            func_    = nullptr;
+        const BE::Targeting::TargetInstrAdapter* adapter_ = nullptr;
+        std::map<uint32_t, size_t>               poolIndex_;
+
+        std::map<ConstKey, std::vector<Site>> collectSites();
+
+        static int intMaterializeCost(int32_t val);
+        static bool needsMultiInst(int32_t val);
+        bool preferPoolLoad(uint32_t bits) const;
+
+        std::vector<MInstruction*> materialize(const ConstKey& key, Register dst);
+        void   rewriteFloatSite(const Site& site, uint32_t bits);
+        void   eraseSite(const Site& site);
+        size_t insertPointBeforeTerminator(BE::Block* block) const;
+    };
+}  // namespace BE::RV64::Passes::Optimize
+
+#endif  // __BACKEND_RV64_PASSES_OPTIMIZE_CONST_MATERIALIZE_H__
@@ -0,0 +1,1072 @@
+#include <backend/targets/riscv64/passes/optimize/modulo_schedule.h>
+#include <debug.h>
+#include <algorithm>
+#include <climits>
+#include <set>
+
+namespace BE::RV64::Passes::Optimize
+{
+    using namespace BE;
+    using namespace BE::RV64;
+
+    namespace
+    {
+        constexpr int kMaxOps    = 48;  // 循环体规模上限：序言/尾声按阶段数复制循环体
+        constexpr int kMaxStages = 4;
+        constexpr int kMaxIISlack = 8;  // 在 MII 之上最多再尝试的 II 个数
+        constexpr int kBudgetRatio = 6;  // 迭代模调度的放置预算（每条指令）
+
+        Operand* cloneOperand(Operand* op)
+        {
+            if (!op) return nullptr;
+            switch (op->ot)
+            {
+                case Operand::Type::REG: return new RegOperand(static_cast<RegOperand*>(op)->reg);
+                case Operand::Type::IMMI32: return new I32Operand(static_cast<I32Operand*>(op)->val);
+                case Operand::Type::IMMF32: return new F32Operand(static_cast<F32Operand*>(op)->val);
+                case Operand::Type::FRAME_INDEX:
+                    return new FrameIndexOperand(static_cast<FrameIndexOperand*>(op)->frameIndex);
+                default: return nullptr;
+            }
+        }
+
+        bool isCloneable(Operand* op)
+        {
+            if (!op) return true;
+            switch (op->ot)
+            {
+                case Operand::Type::REG:
+                case Operand::Type::IMMI32:
+                case Operand::Type::IMMF32:
+                case Operand::Type::FRAME_INDEX: return true;
+                default: return false;
+            }
+        }
+
+        bool isFloatReg(const Register& r) { return r.dt && r.dt->dt == DataType::Type::FLOAT; }
+
+        // 比较关系，统一成“iv 在左侧”的形式
+        enum class Rel
+        {
+            LT,
+            LE,
+            GT,
+            GE
+        };
+
+        Rel negate(Rel r)
+        {
+            switch (r)
+            {
+                case Rel::LT: return Rel::GE;
+                case Rel::LE: return Rel::GT;
+                case Rel::GT: return Rel::LE;
+                case Rel::GE: return Rel::LT;
+            }
+            return r;
+        }
+
+        Rel swapSides(Rel r)
+        {
+            switch (r)
+            {
+                case Rel::LT: return Rel::GT;
+                case Rel::LE: return Rel::GE;
+                case Rel::GT: return Rel::LT;
+                case Rel::GE: return Rel::LE;
+            }
+            return r;
+        }
+    }  // namespace
+
+    void ModuloSchedulePass::runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter,
+        const BE::Targeting::TargetRegInfo* regInfo)
+    {
+        for (auto* func : module.functions)
+        {
+            VRegScope vregScope(func);
+            runOnFunction(func, adapter, regInfo);
+        }
+    }
+
+    int ModuloSchedulePass::latencyOf(MInstruction* inst)
+    {
+        if (inst->kind == InstKind::TARGET) return getOpLatency(static_cast<Instr*>(inst)->op);
+        return getOpLatency(Operator::LI);
+    }
+
+    bool ModuloSchedulePass::isLoad(MInstruction* inst)
+    {
+        if (inst->kind != InstKind::TARGET) return false;
+        switch (static_cast<Instr*>(inst)->op)
+        {
+            case Operator::LW:
+            case Operator::LD:
+            case Operator::FLW:
+            case Operator::FLD: return true;
+            default: return false;
+        }
+    }
+
+    bool ModuloSchedulePass::isStore(MInstruction* inst)
+    {
+        if (inst->kind != InstKind::TARGET) return false;
+        switch (static_cast<Instr*>(inst)->op)
+        {
+            case Operator::SW:
+            case Operator::SD:
+            case Operator::FSW:
+            case Operator::FSD: return true;
+            default: return false;
+        }
+    }
+
+    void ModuloSchedulePass::runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter,
+        const BE::Targeting::TargetRegInfo* regInfo)
+    {
+        adapter_ = adapter;
+        regInfo_ = regInfo;
+        func_    = func;
+        BE::MIR::CFGBuilder builder(adapter_);
+
+        // 每次展开都会新增块，展开后重建 CFG 再找下一个循环；原循环保留为退路，不再重复处理
+        std::set<uint32_t> visited;
+        placeBefore_.clear();
+        bool expanded = true;
+        while (expanded)
+        {
+            expanded            = false;
+            BE::MIR::CFG* cfg = builder.buildCFGForFunction(func);
+            if (!cfg) return;
+            BE::MIR::LoopInfo loops(cfg);
+            computeLiveness(cfg);
+
+            for (auto& loop : loops.loops())
+            {
+                if (!visited.insert(loop.header).second) continue;
+                if (!matchLoop(cfg, loop)) continue;
+                buildDeps();
+                if (!findSchedule()) continue;
+
+                if (stages_ == 1)
+                {
+                    reorderBody();
+                    continue;
+                }
+                expandLoop();
+                expanded = true;
+                break;
+            }
+            delete cfg;
+        }
+        if (!placeBefore_.empty()) relayout();
+    }
+
+    // 块按 blockId 顺序布局，RA 也按此顺序编号；把新块挪到原循环头之前，避免活跃区间被拉长到函数末尾
+    void ModuloSchedulePass::relayout()
+    {
+        std::set<BE::Block*> added;
+        for (auto& [hId, blocks] : placeBefore_) added.insert(blocks.begin(), blocks.end());
+
+        std::vector<BE::Block*> layout;
+        for (auto& [id, block] : func_->blocks)
+        {
+            if (added.count(block)) continue;
+            auto it = placeBefore_.find(id);
+            if (it != placeBefore_.end()) layout.insert(layout.end(), it->second.begin(), it->second.end());
+            layout.push_back(block);
+        }
+
+        std::map<uint32_t, uint32_t> newId;
+        for (size_t i = 0; i < layout.size(); ++i) newId[layout[i]->blockId] = static_cast<uint32_t>(i);
+
+        func_->blocks.clear();
+        for (auto* block : layout)
+        {
+            block->blockId                  = newId.at(block->blockId);
+            func_->blocks[block->blockId] = block;
+            for (auto* inst : block->insts)
+            {
+                if (inst->kind == InstKind::PHI)
+                {
+                    auto*                         phi = static_cast<PhiInst*>(inst);
+                    decltype(phi->incomingVals)   vals;
+                    for (auto& [pred, val] : phi->incomingVals) vals[newId.at(pred)] = val;
+                    phi->incomingVals.swap(vals);
+                    continue;
+                }
+                int target = adapter_->extractBranchTarget(inst);
+                if (target < 0 || static_cast<Instr*>(inst)->label.is_data) continue;
+                static_cast<Instr*>(inst)->label = Label(static_cast<int>(newId.at(static_cast<uint32_t>(target))));
+            }
+        }
+    }
+
+    // ============================================================================
+    // 循环形状识别
+    // ============================================================================
+
+    bool ModuloSchedulePass::matchLoop(const BE::MIR::CFG* cfg, const BE::MIR::LoopInfo::Loop& loop)
+    {
+        loop_ = LoopShape{};
+        ops_.clear();
+        defOp_.clear();
+        phiOf_.clear();
+
+        if (loop.blocks.size() != 2 || loop.latches.size() != 1) return false;
+        uint32_t hId = loop.header, bId = loop.latches[0];
+        if (hId == bId) return false;
+
+        // 循环头恰有前置块与循环体两个前驱，循环体只从循环头进入
+        const auto& hPreds = cfg->inv_graph_id[hId];
+        if (hPreds.size() != 2 || cfg->inv_graph_id[bId].size() != 1) return false;
+        uint32_t pId   = hPreds[0] == bId ? hPreds[1] : hPreds[0];
+        loop_.header   = func_->blocks.at(hId);
+        loop_.body     = func_->blocks.at(bId);
+        loop_.preheader = func_->blocks.at(pId);
+
+        // 前置块须显式跳到循环头（之后改为跳到守卫块）
+        bool explicitEntry = false;
+        for (auto* inst : loop_.preheader->insts)
+            if ((adapter_->isCondBranch(inst) || adapter_->isUncondBranch(inst)) &&
+                adapter_->extractBranchTarget(inst) == static_cast<int>(hId))
+                explicitEntry = true;
+        if (!explicitEntry) return false;
+
+        // 循环头：PHI*，整数常量*，条件跳转，无条件跳转
+        auto&  hInsts = loop_.header->insts;
+        size_t i      = 0;
+        for (; i < hInsts.size() && hInsts[i]->kind == InstKind::PHI; ++i)
+            loop_.phis.push_back(static_cast<PhiInst*>(hInsts[i]));
+        for (; i < hInsts.size() && hInsts[i]->kind == InstKind::MOVE; ++i)
+        {
+            auto* mv = static_cast<MoveInst*>(hInsts[i]);
+            if (!mv->src || mv->src->ot != Operand::Type::IMMI32) return false;
+            if (!mv->dest || mv->dest->ot != Operand::Type::REG) return false;
+            if (!static_cast<RegOperand*>(mv->dest)->reg.isVreg) return false;
+            loop_.headerConsts.push_back(mv);
+        }
+        if (hInsts.size() != i + 2) return false;
+        auto* cond = dynamic_cast<Instr*>(hInsts[i]);
+        auto* jump = dynamic_cast<Instr*>(hInsts[i + 1]);
+        if (!cond || !jump || !adapter_->isCondBranch(cond) || !adapter_->isUncondBranch(jump)) return false;
+
+        int  tCond = adapter_->extractBranchTarget(cond), tJump = adapter_->extractBranchTarget(jump);
+        bool branchToBody;
+        if (tCond == static_cast<int>(bId) && tJump != static_cast<int>(bId))
+        {
+            branchToBody = true;
+            loop_.exitId = static_cast<uint32_t>(tJump);
+        }
+        else if (tJump == static_cast<int>(bId) && tCond != static_cast<int>(bId))
+        {
+            branchToBody = false;
+            loop_.exitId = static_cast<uint32_t>(tCond);
+        }
+        else
+            return false;
+
+        if (!collectBody()) return false;
+
+        // 循环头 PHI：初值来自前置块，回边值来自循环体
+        for (size_t p = 0; p < loop_.phis.size(); ++p)
+        {
+            auto* phi = loop_.phis[p];
+            if (phi->incomingVals.size() != 2 || !phi->incomingVals.count(pId) || !phi->incomingVals.count(bId))
+                return false;
+            Operand* init = phi->incomingVals.at(pId);
+            Operand* back = phi->incomingVals.at(bId);
+            if (!init || (init->ot != Operand::Type::REG && init->ot != Operand::Type::IMMI32)) return false;
+            if (!back || (back->ot != Operand::Type::REG && back->ot != Operand::Type::IMMI32)) return false;
+            phiOf_[phi->resReg] = static_cast<int>(p);
+            loop_.phiInit.push_back(init);
+            loop_.phiBack.push_back(back);
+        }
+        for (size_t p = 0; p < loop_.phis.size(); ++p)
+        {
+            int      backDef = -1;
+            Operand* back    = loop_.phiBack[p];
+            if (back->ot == Operand::Type::REG)
+            {
+                Register r = static_cast<RegOperand*>(back)->reg;
+                if (phiOf_.count(r)) return false;
+                for (auto* mv : loop_.headerConsts)
+                    if (static_cast<RegOperand*>(mv->dest)->reg == r) return false;
+                auto it = defOp_.find(r);
+                if (it != defOp_.end()) backDef = it->second;
+            }
+            loop_.phiBackDef.push_back(backDef);
+        }
+
+        // 回边值为不变量的 PHI 只在第 0 次迭代取初值，不允许在循环体中使用
+        std::vector<Register> uses;
+        for (auto* inst : ops_)
+        {
+            adapter_->enumUses(inst, uses);
+            for (auto& r : uses)
+            {
+                auto it = phiOf_.find(r);
+                if (it != phiOf_.end() && loop_.phiBackDef[it->second] < 0) return false;
+            }
+        }
+
+        return matchInduction(cond, branchToBody);
+    }
+
+    bool ModuloSchedulePass::collectBody()
+    {
+        auto& bInsts = loop_.body->insts;
+        if (bInsts.empty()) return false;
+        auto* last = bInsts.back();
+        if (!adapter_->isUncondBranch(last) ||
+            adapter_->extractBranchTarget(last) != static_cast<int>(loop_.header->blockId))
+            return false;
+        if (bInsts.size() - 1 < 2 || bInsts.size() - 1 > static_cast<size_t>(kMaxOps)) return false;
+
+        std::vector<Register> defs;
+        for (size_t i = 0; i + 1 < bInsts.size(); ++i)
+        {
+            auto* inst = bInsts[i];
+            if (inst->kind == InstKind::MOVE)
+            {
+                auto* mv = static_cast<MoveInst*>(inst);
+                if (!mv->dest || mv->dest->ot != Operand::Type::REG) return false;
+                if (!static_cast<RegOperand*>(mv->dest)->reg.isVreg || !isCloneable(mv->src)) return false;
+            }
+            else if (inst->kind == InstKind::TARGET)
+            {
+                auto* ri = static_cast<Instr*>(inst);
+                if (adapter_->isCall(ri) || adapter_->isCondBranch(ri) || adapter_->isUncondBranch(ri) ||
+                    adapter_->isReturn(ri) || ri->op == Operator::JAL || ri->op == Operator::JALR)
+                    return false;
+                if (!isStore(ri) && !ri->rd.isVreg && ri->rd.rId != 0) return false;
+                if (!isCloneable(ri->fiop)) return false;
+            }
+            else
+                return false;
+
+            adapter_->enumDefs(inst, defs);
+            for (auto& r : defs) defOp_[r] = static_cast<int>(ops_.size());
+            ops_.push_back(inst);
+        }
+        return true;
+    }
+
+    bool ModuloSchedulePass::isInvariant(const Register& reg) const
+    {
+        if (!reg.isVreg) return reg.rId == 0;
+        return !defOp_.count(reg) && !phiOf_.count(reg);
+    }
+
+    bool ModuloSchedulePass::matchInduction(Instr* cond, bool branchToBody)
+    {
+        Rel rel;
+        switch (cond->op)
+        {
+            case Operator::BLT: rel = Rel::LT; break;
+            case Operator::BGE: rel = Rel::GE; break;
+            case Operator::BGT: rel = Rel::GT; break;
+            case Operator::BLE: rel = Rel::LE; break;
+            default: return false;
+        }
+        // 转换为“继续循环”的条件
+        if (!branchToBody) rel = negate(rel);
+
+        auto isIV = [&](const Register& r, int& phi, int& inc, int& step) {
+            auto it = phiOf_.find(r);
+            if (it == phiOf_.end() || loop_.phiBackDef[it->second] < 0) return false;
+            auto* ri = dynamic_cast<Instr*>(ops_[loop_.phiBackDef[it->second]]);
+            if (!ri || (ri->op != Operator::ADDIW && ri->op != Operator::ADDI)) return false;
+            if (ri->use_label || ri->use_ops || !(ri->rs1 == r) || ri->imme <= 0) return false;
+            phi  = it->second;
+            inc  = loop_.phiBackDef[it->second];
+            step = ri->imme;
+            return true;
+        };
+
+        Register lhs = cond->rs1, rhs = cond->rs2;
+        int      phi = -1, inc = -1, step = 0;
+        if (!isIV(lhs, phi, inc, step))
+        {
+            if (!isIV(rhs, phi, inc, step)) return false;
+            std::swap(lhs, rhs);
+            rel = swapSides(rel);
+        }
+        if (rel != Rel::LT && rel != Rel::LE) return false;
+        if (!isInvariant(rhs)) return false;
+
+        // 守卫块用 addi 一次算出第 S-1 次迭代的 iv
+        if (step * (kMaxStages - 1) > 2047) return false;
+
+        loop_.ivPhi     = phi;
+        loop_.ivInc     = inc;
+        loop_.step      = step;
+        loop_.bound     = rhs;
+        loop_.inclusive = rel == Rel::LE;
+        return true;
+    }
+
+    ModuloSchedulePass::ValueSrc ModuloSchedulePass::classify(const Register& reg) const
+    {
+        auto d = defOp_.find(reg);
+        if (d != defOp_.end()) return {ValueSrc::Kind::DIRECT, d->second, -1, reg};
+        auto p = phiOf_.find(reg);
+        if (p != phiOf_.end()) return {ValueSrc::Kind::CARRIED, loop_.phiBackDef[p->second], p->second, reg};
+        return {ValueSrc::Kind::INVARIANT, -1, -1, reg};
+    }
+
+    // ============================================================================
+    // 依赖图与调度
+    // ============================================================================
+
+    void ModuloSchedulePass::buildDeps()
+    {
+        int n = static_cast<int>(ops_.size());
+        edges_.clear();
+        succs_.assign(n, {});
+        preds_.assign(n, {});
+
+        auto addEdge = [&](int from, int to, int latency, int distance, bool data) {
+            succs_[from].push_back(static_cast<int>(edges_.size()));
+            preds_[to].push_back(static_cast<int>(edges_.size()));
+            edges_.push_back({from, to, latency, distance, data});
+        };
+
+        // 数据依赖：循环体内定义为距离 0，经循环头 PHI 传入为距离 1
+        std::vector<Register> uses;
+        for (int u = 0; u < n; ++u)
+        {
+            adapter_->enumUses(ops_[u], uses);
+            for (auto& r : uses)
+            {
+                ValueSrc src = classify(r);
+                if (src.kind == ValueSrc::Kind::INVARIANT) continue;
+                addEdge(src.op, u, latencyOf(ops_[src.op]), src.kind == ValueSrc::Kind::CARRIED ? 1 : 0, true);
+            }
+        }
+
+        // 访存依赖：不做别名分析，至少一方为写的访存对在迭代内与跨迭代都保序
+        for (int a = 0; a < n; ++a)
+        {
+            bool aMem = isLoad(ops_[a]) || isStore(ops_[a]);
+            if (!aMem) continue;
+            for (int b = a + 1; b < n; ++b)
+            {
+                if (!isLoad(ops_[b]) && !isStore(ops_[b])) continue;
+                if (!isStore(ops_[a]) && !isStore(ops_[b])) continue;
+                addEdge(a, b, 1, 0, false);
+                addEdge(b, a, 1, 1, false);
+            }
+        }
+    }
+
+    bool ModuloSchedulePass::hasPositiveCycle(int ii) const
+    {
+        int                           n = static_cast<int>(ops_.size());
+        std::vector<std::vector<int>> dist(n, std::vector<int>(n, INT_MIN));
+        for (auto& e : edges_) dist[e.from][e.to] = std::max(dist[e.from][e.to], e.latency - ii * e.distance);
+        for (int k = 0; k < n; ++k)
+            for (int i = 0; i < n; ++i)
+            {
+                if (dist[i][k] == INT_MIN) continue;
+                for (int j = 0; j < n; ++j)
+                {
+                    if (dist[k][j] == INT_MIN) continue;
+                    dist[i][j] = std::max(dist[i][j], dist[i][k] + dist[k][j]);
+                }
+            }
+        for (int i = 0; i < n; ++i)
+            if (dist[i][i] > 0) return true;
+        return false;
+    }
+
+    // 递归约束下的最小 II：依赖环上 延迟和 / 距离和 的最大值
+    int ModuloSchedulePass::recurrenceMII() const
+    {
+        int hi = 1;
+        for (auto& e : edges_) hi += e.latency;
+        int lo = 1;
+        while (lo < hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (hasPositiveCycle(mid))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    /**
+     * 迭代模调度（Rau）：按高度从高到低放置指令，在 [Estart, Estart + II) 中寻找空闲的发射槽；
+     * 找不到时强行放置并驱逐占用该槽的指令，同时驱逐因此违反依赖的后继，直到全部放置或预算耗尽。
+     * 归纳变量的递增指令最先放置，且必须位于第 0 阶段（内核据其结果判断是否启动下一次迭代）。
+     */
+    bool ModuloSchedulePass::scheduleAt(int ii)
+    {
+        int n = static_cast<int>(ops_.size());
+
+        std::vector<int> height(n, 0);
+        for (int iter = 0; iter < n; ++iter)
+        {
+            bool changed = false;
+            for (auto& e : edges_)
+            {
+                int h = height[e.to] + e.latency - ii * e.distance;
+                if (h > height[e.from])
+                {
+                    height[e.from] = h;
+                    changed        = true;
+                }
+            }
+            if (!changed) break;
+        }
+
+        std::vector<int> prio(n);
+        for (int i = 0; i < n; ++i) prio[i] = i;
+        std::stable_sort(prio.begin(), prio.end(), [&](int a, int b) {
+            if ((a == loop_.ivInc) != (b == loop_.ivInc)) return a == loop_.ivInc;
+            return height[a] > height[b];
+        });
+
+        time_.assign(n, -1);
+        std::vector<int> lastTime(n, -1);
+        std::vector<int> mrt(ii, -1);  // 单发射：每个模周期一个发射槽
+        int              unscheduled = n;
+        int              budget      = n * kBudgetRatio;
+
+        auto unschedule = [&](int op) {
+            mrt[time_[op] % ii] = -1;
+            time_[op]           = -1;
+            ++unscheduled;
+        };
+
+        while (unscheduled > 0)
+        {
+            if (budget-- <= 0) return false;
+
+            int op = -1;
+            for (int cand : prio)
+                if (time_[cand] < 0)
+                {
+                    op = cand;
+                    break;
+                }
+
+            int estart = 0;
+            for (int ei : preds_[op])
+            {
+                auto& e = edges_[ei];
+                if (e.from == op || time_[e.from] < 0) continue;
+                estart = std::max(estart, time_[e.from] + e.latency - ii * e.distance);
+            }
+
+            int slot = -1;
+            for (int t = estart; t < estart + ii; ++t)
+                if (mrt[t % ii] < 0)
+                {
+                    slot = t;
+                    break;
+                }
+            if (slot < 0)
+            {
+                slot = (lastTime[op] < 0 || estart > lastTime[op]) ? estart : lastTime[op] + 1;
+                unschedule(mrt[slot % ii]);
+            }
+
+            time_[op]      = slot;
+            lastTime[op]   = slot;
+            mrt[slot % ii] = op;
+            --unscheduled;
+
+            for (int ei : succs_[op])
+            {
+                auto& e = edges_[ei];
+                if (e.to == op || time_[e.to] < 0) continue;
+                if (time_[e.to] < slot + e.latency - ii * e.distance) unschedule(e.to);
+            }
+        }
+
+        int minT = *std::min_element(time_.begin(), time_.end());
+        int maxT = *std::max_element(time_.begin(), time_.end());
+        int base = (minT / ii) * ii;
+        for (auto& t : time_) t -= base;
+        maxT -= base;
+
+        ii_     = ii;
+        stages_ = maxT / ii + 1;
+        if (time_[loop_.ivInc] >= ii || stages_ > kMaxStages) return false;
+
+        order_.resize(n);
+        for (int i = 0; i < n; ++i) order_[i] = i;
+        std::sort(order_.begin(), order_.end(), [&](int a, int b) { return time_[a] % ii < time_[b] % ii; });
+        return true;
+    }
+
+    // 原顺序在单发射顺序核上每次迭代的稳态周期数（含等待操作数的停顿）
+    int ModuloSchedulePass::originalCycles() const
+    {
+        int              n = static_cast<int>(ops_.size());
+        std::vector<int> ready(n, 0), prevReady(n, 0);
+        int              clock = 0, lastIter = 0, iterCycles = 0;
+        for (int iter = 0; iter < 3; ++iter)
+        {
+            for (int u = 0; u < n; ++u)
+            {
+                int issue = clock + 1;
+                for (int ei : preds_[u])
+                {
+                    auto& e = edges_[ei];
+                    if (e.distance == 0)
+                        issue = std::max(issue, ready[e.from]);
+                    else if (iter > 0)
+                        issue = std::max(issue, prevReady[e.from]);
+                }
+                clock    = issue;
+                ready[u] = issue + latencyOf(ops_[u]);
+            }
+            iterCycles = clock - lastIter;
+            lastIter   = clock;
+            prevReady  = ready;
+        }
+        return iterCycles;
+    }
+
+    // 内核 PHI 链：跨 k 个阶段使用的值需要 k 个逐轮传递的寄存器
+    std::map<int, int> ModuloSchedulePass::chainLengths() const
+    {
+        std::map<int, int> maxK;
+        for (auto& e : edges_)
+        {
+            if (!e.data) continue;
+            int k = stageOf(e.to) + e.distance - stageOf(e.from);
+            if (k <= 0) continue;
+            // 跨迭代使用的 PHI 与循环体内的直接使用分开成链（二者在序言入口处的取值不同）
+            int key   = e.distance ? -1 - e.from : e.from;
+            maxK[key] = std::max(maxK[key], k);
+        }
+        return maxK;
+    }
+
+    int ModuloSchedulePass::kernelChainCount() const
+    {
+        int total = 0;
+        for (auto& [key, k] : chainLengths()) total += k;
+        return total;
+    }
+
+    /**
+     * 估算展开后超出可分配寄存器的值的个数。线性扫描只分配 callee-saved 寄存器，且块内的使用区间从块首算起，
+     * 因此一个块的压力近似为块内引用的不同寄存器数：
+     *   PRO/EPI 为其中的指令实例数，K 为每条指令一个定义加上 PHI 链，另加循环不变量与穿过循环的值。
+     * 结果大于 0 的调度不被采用。
+     */
+    int ModuloSchedulePass::excessRegisters() const
+    {
+        int n = static_cast<int>(ops_.size());
+
+        std::vector<bool>     isFP(n, false), hasDef(n, false);
+        std::vector<Register> defs, uses;
+        std::set<Register>    loopDefs;
+        for (int d = 0; d < n; ++d)
+        {
+            adapter_->enumDefs(ops_[d], defs);
+            if (defs.empty()) continue;
+            hasDef[d] = true;
+            isFP[d]   = isFloatReg(defs[0]);
+            loopDefs.insert(defs[0]);
+        }
+        for (auto* phi : loop_.phis) loopDefs.insert(phi->resReg);
+        for (auto* mv : loop_.headerConsts) loopDefs.insert(static_cast<RegOperand*>(mv->dest)->reg);
+
+        // 整个流水线区域内始终占用寄存器的值：循环中用到的不变量与循环后仍活跃的值
+        std::set<Register> pinned;
+        if (loop_.bound.isVreg) pinned.insert(loop_.bound);
+        for (auto* inst : ops_)
+        {
+            adapter_->enumUses(inst, uses);
+            for (auto& r : uses)
+                if (r.isVreg && isInvariant(r)) pinned.insert(r);
+        }
+        auto live = liveIn_.find(loop_.exitId);
+        if (live != liveIn_.end())
+            for (auto& r : live->second)
+                if (!loopDefs.count(r)) pinned.insert(r);
+
+        int pinInt = 0, pinFP = 0;
+        for (auto& r : pinned) (isFloatReg(r) ? pinFP : pinInt) += 1;
+
+        int proInt = 0, proFP = 0, epiInt = 0, epiFP = 0, kInt = 0, kFP = 0;
+        for (int d = 0; d < n; ++d)
+        {
+            if (!hasDef[d]) continue;
+            int s   = stageOf(d);
+            int pro = std::max(0, stages_ - 1 - s);  // 序言中的实例数
+            int epi = s;                             // 尾声中的实例数
+            (isFP[d] ? proFP : proInt) += pro;
+            (isFP[d] ? epiFP : epiInt) += epi;
+            (isFP[d] ? kFP : kInt) += 1;
+        }
+        for (auto& [key, k] : chainLengths())
+        {
+            int d = key >= 0 ? key : -1 - key;
+            (isFP[d] ? kFP : kInt) += k;
+        }
+        // 尾声的输入是内核的定义与 PHI 链
+        epiInt += kInt;
+        epiFP += kFP;
+
+        auto available = [&](const std::vector<int>& regs) {
+            const auto& reserved = regInfo_->reservedRegs();
+            int         cnt      = 0;
+            for (int r : regs)
+                if (std::find(reserved.begin(), reserved.end(), r) == reserved.end()) ++cnt;
+            return cnt;
+        };
+        int needInt = pinInt + std::max({proInt, kInt, epiInt});
+        int needFP  = pinFP + std::max({proFP, kFP, epiFP});
+        return std::max(0, needInt - available(regInfo_->calleeSavedIntRegs())) +
+               std::max(0, needFP - available(regInfo_->calleeSavedFloatRegs()));
+    }
+
+    // 各块入口活跃的虚拟寄存器（PHI 的使用计在对应前驱的出口）
+    void ModuloSchedulePass::computeLiveness(const BE::MIR::CFG* cfg)
+    {
+        liveIn_.clear();
+        std::map<uint32_t, std::set<Register>> use, def;
+        std::vector<Register>                  regs;
+        for (auto& [id, block] : func_->blocks)
+        {
+            auto& u = use[id];
+            auto& d = def[id];
+            for (auto* inst : block->insts)
+            {
+                if (inst->kind == InstKind::PHI)
+                {
+                    auto* phi = static_cast<PhiInst*>(inst);
+                    d.insert(phi->resReg);
+                    continue;
+                }
+                adapter_->enumUses(inst, regs);
+                for (auto& r : regs)
+                    if (r.isVreg && !d.count(r)) u.insert(r);
+                adapter_->enumDefs(inst, regs);
+                for (auto& r : regs)
+                    if (r.isVreg) d.insert(r);
+            }
+        }
+        for (auto& [id, block] : func_->blocks)
+            for (auto* inst : block->insts)
+            {
+                if (inst->kind != InstKind::PHI) break;
+                for (auto& [pred, val] : static_cast<PhiInst*>(inst)->incomingVals)
+                {
+                    if (!val || val->ot != Operand::Type::REG) continue;
+                    Register r = static_cast<RegOperand*>(val)->reg;
+                    if (r.isVreg && !def[pred].count(r)) use[pred].insert(r);
+                }
+            }
+
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto it = func_->blocks.rbegin(); it != func_->blocks.rend(); ++it)
+            {
+                uint32_t           id  = it->first;
+                std::set<Register> in  = use[id];
+                if (id < cfg->graph.size())
+                    for (auto* succ : cfg->graph[id])
+                    {
+                        if (!succ) continue;
+                        for (auto& r : liveIn_[succ->blockId])
+                            if (!def[id].count(r)) in.insert(r);
+                    }
+                auto& cur = liveIn_[id];
+                if (in.size() != cur.size())
+                {
+                    cur     = std::move(in);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    bool ModuloSchedulePass::findSchedule()
+    {
+        int n       = static_cast<int>(ops_.size());
+        int mii     = std::max(n, recurrenceMII());
+        int orig    = originalCycles();
+        int carried = 0;
+        for (int d : loop_.phiBackDef) carried += d >= 0;
+
+        for (int ii = mii; ii < orig && ii <= mii + kMaxIISlack; ++ii)
+        {
+            if (!scheduleAt(ii)) continue;
+            // 寄存器压力超出可分配寄存器时不采用该调度：溢出的值每轮都要重新加载并写回，
+            // 抵消流水线的收益。更大的 II 阶段数更少，压力随之降低，因此继续尝试
+            if (excessRegisters() > 0) continue;
+            // 单阶段：内核即重排后的循环体；多阶段：额外付出内核 PHI 链上的拷贝
+            if (stages_ == 1) return true;
+            if (ii + kernelChainCount() >= orig + carried) continue;
+            return true;
+        }
+        return false;
+    }
+
+    // ============================================================================
+    // 代码生成
+    // ============================================================================
+
+    void ModuloSchedulePass::reorderBody()
+    {
+        auto*                     jump = loop_.body->insts.back();
+        std::deque<MInstruction*> insts;
+        for (int op : order_) insts.push_back(ops_[op]);
+        insts.push_back(jump);
+        loop_.body->insts.swap(insts);
+    }
+
+    Register ModuloSchedulePass::defOf(int op) const
+    {
+        std::vector<Register> defs;
+        adapter_->enumDefs(ops_[op], defs);
+        ASSERT(defs.size() == 1);
+        return defs[0];
+    }
+
+    Register ModuloSchedulePass::invariant(const Register& reg)
+    {
+        if (!reg.isVreg) return reg;
+        auto it = constClone_.find(reg);
+        if (it != constClone_.end()) return it->second;
+
+        // 循环头中的常量不支配新块，在守卫块中重新实例化
+        for (auto* mv : loop_.headerConsts)
+        {
+            if (!(static_cast<RegOperand*>(mv->dest)->reg == reg)) continue;
+            Register clone = getVReg(reg.dt);
+            guard_->insts.push_back(createMove(new RegOperand(clone), static_cast<I32Operand*>(mv->src)->val));
+            constClone_[reg] = clone;
+            return clone;
+        }
+        return reg;
+    }
+
+    Register ModuloSchedulePass::initValue(int phi)
+    {
+        Operand* init = loop_.phiInit[phi];
+        if (init->ot == Operand::Type::REG) return static_cast<RegOperand*>(init)->reg;
+
+        auto it = initClone_.find(phi);
+        if (it != initClone_.end()) return it->second;
+        Register reg = getVReg(loop_.phis[phi]->resReg.dt);
+        guard_->insts.push_back(createMove(new RegOperand(reg), static_cast<I32Operand*>(init)->val));
+        initClone_[phi] = reg;
+        return reg;
+    }
+
+    // 内核 PHI 链：key 为定义指令（直接使用）或 -1 - 指令（经循环头 PHI 的跨迭代使用），第 k 项保存 k 轮前的值
+    Register ModuloSchedulePass::chain(int key, int k)
+    {
+        auto it = chainReg_.find({key, k});
+        if (it != chainReg_.end()) return it->second;
+        int      op  = key >= 0 ? key : -1 - key;
+        Register reg = getVReg(defOf(op).dt);
+        chainReg_[{key, k}] = reg;
+        return reg;
+    }
+
+    Register ModuloSchedulePass::resolve(const Register& reg, Context ctx, int op, int iter)
+    {
+        ValueSrc src = classify(reg);
+        if (src.kind == ValueSrc::Kind::INVARIANT) return invariant(reg);
+
+        bool carried = src.kind == ValueSrc::Kind::CARRIED;
+        int  def     = src.op;
+        int  key     = carried ? -1 - def : def;
+        switch (ctx)
+        {
+            case Context::PROLOGUE:
+            {
+                // 序言中每个实例的迭代号已知
+                int srcIter = carried ? iter - 1 : iter;
+                if (srcIter < 0) return initValue(src.phi);
+                return proName_.at({def, srcIter});
+            }
+            case Context::KERNEL:
+            {
+                int k = stageOf(op) + (carried ? 1 : 0) - stageOf(def);
+                ASSERT(k >= 0);
+                return k == 0 ? kernelDef_[def] : chain(key, k);
+            }
+            case Context::EPILOGUE:
+            {
+                // iter 为相对内核最后一轮启动的迭代的偏移（<= 0）
+                int srcIter = carried ? iter - 1 : iter;
+                int round   = srcIter + stageOf(def);
+                if (round > 0) return epiName_.at({def, srcIter});
+                return round == 0 ? kernelDef_[def] : chain(key, -round);
+            }
+        }
+        return reg;
+    }
+
+    Register ModuloSchedulePass::emitInstance(int op, BE::Block* block, Context ctx, int iter)
+    {
+        MInstruction* src = ops_[op];
+        MInstruction* inst;
+        Register      def;
+        if (src->kind == InstKind::MOVE)
+        {
+            auto* mv    = static_cast<MoveInst*>(src);
+            auto* clone = createMove(cloneOperand(mv->dest), cloneOperand(mv->src), mv->comment);
+            if (clone->src->ot == Operand::Type::REG)
+            {
+                auto* r = static_cast<RegOperand*>(clone->src);
+                if (r->reg.isVreg) r->reg = resolve(r->reg, ctx, op, iter);
+            }
+            auto* d = static_cast<RegOperand*>(clone->dest);
+            def = d->reg = getVReg(d->reg.dt);
+            inst         = clone;
+        }
+        else
+        {
+            auto* clone = new Instr(*static_cast<Instr*>(src));
+            clone->fiop = cloneOperand(clone->fiop);
+            if (clone->rs1.isVreg) clone->rs1 = resolve(clone->rs1, ctx, op, iter);
+            if (clone->rs2.isVreg) clone->rs2 = resolve(clone->rs2, ctx, op, iter);
+            if (!isStore(clone) && clone->rd.isVreg) def = clone->rd = getVReg(clone->rd.dt);
+            inst = clone;
+        }
+        block->insts.push_back(inst);
+        return def;
+    }
+
+    // 循环继续条件 iv < n（或 iv <= n）不成立时跳往 target
+    Instr* ModuloSchedulePass::createExitBranch(const Register& iv, uint32_t target)
+    {
+        Register bound = invariant(loop_.bound);
+        if (loop_.inclusive) return createBInst(Operator::BLT, bound, iv, Label(static_cast<int>(target)));
+        return createBInst(Operator::BGE, iv, bound, Label(static_cast<int>(target)));
+    }
+
+    void ModuloSchedulePass::expandLoop()
+    {
+        proName_.clear();
+        epiName_.clear();
+        chainReg_.clear();
+        constClone_.clear();
+        initClone_.clear();
+        kernelDef_.assign(ops_.size(), Register());
+
+        uint32_t hId = loop_.header->blockId, pId = loop_.preheader->blockId;
+        uint32_t gId = func_->blocks.rbegin()->first + 1;
+        guard_       = new BE::Block(gId);
+        auto* pro    = new BE::Block(gId + 1);
+        auto* kernel = new BE::Block(gId + 2);
+        auto* epi    = new BE::Block(gId + 3);
+        for (auto* b : {guard_, pro, kernel, epi}) func_->blocks[b->blockId] = b;
+        placeBefore_[hId] = {guard_, pro, kernel, epi};
+
+        int last = stages_ - 1;  // 内核第一轮的轮号
+
+        // 序言：第 r 轮执行第 0..r 阶段（迭代 r - s）
+        for (int r = 0; r < last; ++r)
+            for (int op : order_)
+            {
+                int iter = r - stageOf(op);
+                if (iter < 0) continue;
+                proName_[{op, iter}] = emitInstance(op, pro, Context::PROLOGUE, iter);
+            }
+        pro->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(static_cast<int>(kernel->blockId))));
+
+        // 内核：每条指令一份，归纳变量在第 0 阶段算出下一轮要启动的迭代的 iv
+        for (int op : order_) kernelDef_[op] = emitInstance(op, kernel, Context::KERNEL, 0);
+        kernel->insts.push_back(createExitBranch(kernelDef_[loop_.ivInc], epi->blockId));
+        kernel->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(static_cast<int>(kernel->blockId))));
+
+        // 尾声：第 e 轮执行第 e..S-1 阶段，迭代号相对内核最后一轮启动的迭代为 e - s
+        for (int e = 1; e <= last; ++e)
+            for (int op : order_)
+            {
+                int s = stageOf(op);
+                if (s < e) continue;
+                epiName_[{op, e - s}] = emitInstance(op, epi, Context::EPILOGUE, e - s);
+            }
+        epi->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(static_cast<int>(hId))));
+
+        // 内核 PHI 链：入口值取自序言中 k 轮前产生的实例（迭代 -1 即循环头 PHI 的初值）
+        std::map<int, int> chainLen;
+        for (auto& [key, reg] : chainReg_) chainLen[key.first] = std::max(chainLen[key.first], key.second);
+        std::vector<MInstruction*> kernelPhis;
+        for (auto& [key, len] : chainLen)
+        {
+            int def = key >= 0 ? key : -1 - key;
+            for (int k = 1; k <= len; ++k)
+            {
+                auto* phi  = new PhiInst(chain(key, k));
+                int   iter = last - k - stageOf(def);
+                if (iter < 0)
+                {
+                    ASSERT(key < 0 && iter == -1);
+                    int p = -1;
+                    for (size_t i = 0; i < loop_.phis.size(); ++i)
+                        if (loop_.phiBackDef[i] == def) p = static_cast<int>(i);
+                    phi->incomingVals[pro->blockId] = new RegOperand(initValue(p));
+                }
+                else
+                    phi->incomingVals[pro->blockId] = new RegOperand(proName_.at({def, iter}));
+                phi->incomingVals[kernel->blockId] = new RegOperand(k == 1 ? kernelDef_[def] : chain(key, k - 1));
+                kernelPhis.push_back(phi);
+            }
+        }
+        kernel->insts.insert(kernel->insts.begin(), kernelPhis.begin(), kernelPhis.end());
+
+        // 守卫：第 S-1 次迭代满足条件才走流水线，否则直接进入原循环
+        int      ivPhi = loop_.ivPhi;
+        Register ivLast;
+        Operand* ivInit = loop_.phiInit[ivPhi];
+        if (ivInit->ot == Operand::Type::IMMI32)
+        {
+            int64_t v = static_cast<int64_t>(static_cast<I32Operand*>(ivInit)->val) +
+                        static_cast<int64_t>(last) * loop_.step;
+            ivLast = getVReg(BE::I64);
+            guard_->insts.push_back(createMove(new RegOperand(ivLast), static_cast<int>(v)));
+        }
+        else
+        {
+            ivLast = getVReg(BE::I64);
+            guard_->insts.push_back(
+                createIInst(Operator::ADDI, ivLast, static_cast<RegOperand*>(ivInit)->reg, last * loop_.step));
+        }
+        guard_->insts.push_back(createExitBranch(ivLast, hId));
+        guard_->insts.push_back(createJInst(Operator::JAL, PR::x0, Label(static_cast<int>(pro->blockId))));
+
+        // 前置块改为进入守卫块
+        for (auto* inst : loop_.preheader->insts)
+        {
+            if (!adapter_->isCondBranch(inst) && !adapter_->isUncondBranch(inst)) continue;
+            if (adapter_->extractBranchTarget(inst) != static_cast<int>(hId)) continue;
+            static_cast<Instr*>(inst)->label = Label(static_cast<int>(gId));
+        }
+
+        // 循环头 PHI：前置块的初值改由守卫块传入；尾声带回最后一次迭代后的状态
+        for (size_t p = 0; p < loop_.phis.size(); ++p)
+        {
+            auto* phi = loop_.phis[p];
+            phi->incomingVals.erase(pId);
+            phi->incomingVals[gId] = loop_.phiInit[p];
+
+            int      def = loop_.phiBackDef[p];
+            Operand* out;
+            if (def >= 0)
+                out = new RegOperand(stageOf(def) == 0 ? kernelDef_[def] : epiName_.at({def, 0}));
+            else if (loop_.phiBack[p]->ot == Operand::Type::REG)
+                out = new RegOperand(invariant(static_cast<RegOperand*>(loop_.phiBack[p])->reg));
+            else
+                out = new I32Operand(static_cast<I32Operand*>(loop_.phiBack[p])->val);
+            phi->incomingVals[epi->blockId] = out;
+        }
+    }
+}  // namespace BE::RV64::Passes::Optimize
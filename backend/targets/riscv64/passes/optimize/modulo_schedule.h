@@ -0,0 +1,164 @@
+#ifndef __BACKEND_RV64_PASSES_OPTIMIZE_MODULO_SCHEDULE_H__
+#define __BACKEND_RV64_PASSES_OPTIMIZE_MODULO_SCHEDULE_H__
+
+#include <backend/mir/m_module.h>
+#include <backend/mir/m_function.h>
+#include <backend/mir/m_block.h>
+#include <backend/mir/m_instruction.h>
+#include <backend/common/cfg.h>
+#include <backend/common/cfg_builder.h>
+#include <backend/common/loop_info.h>
+#include <backend/target/target_instr_adapter.h>
+#include <backend/target/target_reg_info.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+/*
+ * 最内层循环的模调度（软件流水，Pre-RA，SSA 形式的 MIR 上运行）
+ *
+ * 处理的循环形状：while 循环降低后的“循环头 + 单个循环体块”——
+ *   H: PHI ...; [li 常量]; bcc iv, n -> B/Exit; j Exit/B
+ *   B: 循环体（无调用、无分支）; j H
+ * 其中 iv 为步长为正常数的归纳变量（addiw iv', iv, c），n 为循环不变量，条件为 iv < n 或 iv <= n。
+ *
+ * 调度按单发射顺序核建模，指令延迟取自 RV64_INSTS：
+ * - 迭代模调度（Rau）：从 MII = max(ResMII, RecMII) 起逐个尝试 II，按高度优先放置，冲突时驱逐；
+ * - 只有一个阶段时仅按调度顺序重排循环体；
+ * - 多阶段时生成 G（守卫）/ PRO（序言）/ K（内核）/ EPI（尾声）四个新块：
+ *     G:   计算第 S-1 次迭代的 iv，条件不满足则回到原循环 H，否则进入序言
+ *     PRO: 依次启动前 S-1 次迭代
+ *     K:   每轮启动一次新迭代，跨阶段的值经内核 PHI 链逐轮传递（模变量扩展交给 RA）
+ *     EPI: 排空已启动的迭代，再带着迭代后的状态回到 H（H 的条件随即不成立而退出）
+ *   原循环保持不变，作为迭代次数不足时的退路。
+ * 展开后的寄存器压力超出可分配寄存器的调度一律放弃（改试更大的 II）；
+ * 收益按稳态每次迭代的周期估算：II 加上内核 PHI 链的拷贝，不比原顺序快则放弃该循环。
+ */
+namespace BE::RV64::Passes::Optimize
+{
+    class ModuloSchedulePass
+    {
+      public:
+        ModuloSchedulePass()  = default;
+        ~ModuloSchedulePass() = default;
+
+        void runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo* regInfo);
+        /// 处理单个函数，需在该函数的 VRegScope 内调用
+        void runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo* regInfo);
+
+      private:
+        struct DepEdge
+        {
+            int  from;
+            int  to;
+            int  latency;
+            int  distance;
+            bool data;  ///< 寄存器数据依赖（否则为访存保序）
+        };
+
+        // 循环体中一个寄存器使用的来源
+        struct ValueSrc
+        {
+            enum class Kind
+            {
+                DIRECT,     ///< 本次迭代循环体内定义（op = 定义指令）
+                CARRIED,    ///< 循环头 PHI，值来自上一次迭代的 op（phi 为该 PHI）
+                INVARIANT,  ///< 循环不变量
+            } kind;
+            int      op;
+            int      phi;
+            Register reg;
+        };
+
+        struct LoopShape
+        {
+            BE::Block*            header   = nullptr;
+            BE::Block*            body     = nullptr;
+            BE::Block*            preheader = nullptr;
+            uint32_t              exitId   = 0;
+            std::vector<PhiInst*> phis;
+            std::vector<int>      phiBackDef;   ///< 回边值在循环体内的定义指令，-1 表示不变量
+            std::vector<Operand*> phiInit;      ///< 来自前置块的初值
+            std::vector<Operand*> phiBack;      ///< 来自循环体的回边值
+            std::vector<MoveInst*> headerConsts;
+            int                   ivPhi    = -1;
+            int                   ivInc    = -1;
+            int                   step     = 0;
+            Register              bound;
+            bool                  inclusive = false;  ///< iv <= n
+        };
+
+        const BE::Targeting::TargetInstrAdapter* adapter_ = nullptr;
+        const BE::Targeting::TargetRegInfo*      regInfo_ = nullptr;
+        BE::Function*                            func_    = nullptr;
+
+        LoopShape                   loop_;
+        std::vector<MInstruction*>  ops_;  ///< 循环体指令（不含末尾跳转）
+        std::map<Register, int>     defOp_;
+        std::map<Register, int>     phiOf_;
+        std::vector<DepEdge>        edges_;
+        std::vector<std::vector<int>> succs_, preds_;
+        std::map<uint32_t, std::set<Register>> liveIn_;  ///< 各块入口活跃的虚拟寄存器
+
+        // 调度结果
+        int              ii_     = 0;
+        int              stages_ = 0;
+        std::vector<int> time_;
+        std::vector<int> order_;  ///< 内核中的指令顺序（按周期）
+
+        // 展开状态
+        enum class Context
+        {
+            PROLOGUE,
+            KERNEL,
+            EPILOGUE,
+        };
+        BE::Block*                             guard_ = nullptr;
+        std::vector<Register>                  kernelDef_;   ///< 内核中每条指令的新定义
+        std::map<std::pair<int, int>, Register> proName_;    ///< (指令, 迭代) -> 序言中的定义
+        std::map<std::pair<int, int>, Register> epiName_;    ///< (指令, 相对迭代) -> 尾声中的定义
+        std::map<std::pair<int, int>, Register> chainReg_;   ///< (链, 轮数) -> 内核 PHI
+        std::map<Register, Register>           constClone_;  ///< 循环头常量 -> 守卫块中的副本
+        std::map<int, Register>                initClone_;   ///< 立即数初值 -> 守卫块中的寄存器
+        std::map<uint32_t, std::vector<BE::Block*>> placeBefore_;  ///< 原循环头 -> 布局在其前面的新块
+
+        bool matchLoop(const BE::MIR::CFG* cfg, const BE::MIR::LoopInfo::Loop& loop);
+        bool matchInduction(Instr* cond, bool branchToBody);
+        bool collectBody();
+        bool isInvariant(const Register& reg) const;
+        ValueSrc classify(const Register& reg) const;
+        void buildDeps();
+
+        static int  latencyOf(MInstruction* inst);
+        static bool isLoad(MInstruction* inst);
+        static bool isStore(MInstruction* inst);
+
+        bool hasPositiveCycle(int ii) const;
+        int  recurrenceMII() const;
+        bool scheduleAt(int ii);
+        bool findSchedule();
+        int  stageOf(int op) const { return time_[op] / ii_; }
+        int  originalCycles() const;
+        std::map<int, int> chainLengths() const;
+        int                kernelChainCount() const;
+        int                excessRegisters() const;
+        void               computeLiveness(const BE::MIR::CFG* cfg);
+
+        void     reorderBody();
+        void     expandLoop();
+        Register defOf(int op) const;
+        Register invariant(const Register& reg);
+        Register initValue(int phi);
+        Register chain(int key, int k);
+        Register resolve(const Register& reg, Context ctx, int op, int iter);
+        Register emitInstance(int op, BE::Block* block, Context ctx, int iter);
+        Instr*   createExitBranch(const Register& iv, uint32_t target);
+        void     relayout();
+    };
+}  // namespace BE::RV64::Passes::Optimize
+
+#endif  // __BACKEND_RV64_PASSES_OPTIMIZE_MODULO_SCHEDULE_H__
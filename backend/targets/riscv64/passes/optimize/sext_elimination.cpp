@@ -0,0 +1,224 @@
+#include <backend/targets/riscv64/passes/optimize/sext_elimination.h>
+#include <debug.h>
+
+namespace BE::RV64::Passes::Optimize
+{
+    using namespace BE;
+    using namespace BE::RV64;
+
+    void SExtEliminationPass::runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter)
+    {
+        for (auto* func : module.functions) runOnFunction(func, adapter);
+    }
+
+    unsigned SExtEliminationPass::constFact(int32_t val)
+    {
+        // 32 位立即数经 li 实例化后总是符号扩展的；非负时高位同时为零
+        return val >= 0 ? ALL : SEXT32;
+    }
+
+    unsigned SExtEliminationPass::factOf(const Register& reg) const
+    {
+        if (!reg.isVreg) return reg.rId == 0 ? ALL : NONE;
+        auto it = facts_.find(reg);
+        return it == facts_.end() ? NONE : it->second;
+    }
+
+    unsigned SExtEliminationPass::factOf(BE::Operand* op) const
+    {
+        if (!op) return NONE;
+        switch (op->ot)
+        {
+            case Operand::Type::REG: return factOf(static_cast<RegOperand*>(op)->reg);
+            case Operand::Type::IMMI32: return constFact(static_cast<I32Operand*>(op)->val);
+            default: return NONE;
+        }
+    }
+
+    unsigned SExtEliminationPass::transfer(BE::MInstruction* inst) const
+    {
+        if (inst->kind == InstKind::PHI)
+        {
+            unsigned f = ALL;
+            for (auto& [label, op] : static_cast<PhiInst*>(inst)->incomingVals) f &= factOf(op);
+            return f;
+        }
+        if (inst->kind == InstKind::MOVE)
+        {
+            auto* mv = static_cast<MoveInst*>(inst);
+            if (mv->src && mv->src->ot == Operand::Type::REG)
+            {
+                const Register& src = static_cast<RegOperand*>(mv->src)->reg;
+                // 来自参数/返回值寄存器：调用约定保证 i32 以符号扩展形式传递
+                if (!src.isVreg && src.rId != 0) return mv->dest->dt == BE::I32 ? SEXT32 : NONE;
+            }
+            return factOf(mv->src);
+        }
+
+        auto* ri = dynamic_cast<Instr*>(inst);
+        if (!ri) return NONE;
+
+        unsigned f1 = factOf(ri->rs1);
+        unsigned f2 = factOf(ri->rs2);
+        // 立即数位置为帧索引/标签时，imme 字段无意义，只保留与立即数无关的结论
+        bool immValid = !ri->use_ops && !ri->use_label;
+        switch (ri->op)
+        {
+            case Operator::SLT:
+            case Operator::SLTU:
+            case Operator::SLTI:
+            case Operator::SLTIU:
+            case Operator::FEQ_S:
+            case Operator::FLT_S:
+            case Operator::FLE_S: return ALL;
+
+            case Operator::ADDW:
+            case Operator::SUBW:
+            case Operator::MULW:
+            case Operator::DIVW:
+            case Operator::REMW:
+            case Operator::SLLIW:
+            case Operator::SRAIW:
+            case Operator::SLLW:
+            case Operator::SRLW:
+            case Operator::SRAW:
+            case Operator::LW:
+            case Operator::LUI:
+            case Operator::FCVT_W_S:
+            case Operator::FMV_X_W: return SEXT32;
+
+            case Operator::ADDIW: return (immValid && ri->imme == 0 && f1 == ALL) ? ALL : SEXT32;
+            case Operator::SRLIW: return (immValid && ri->imme > 0) ? ALL : SEXT32;
+            case Operator::LI: return immValid ? constFact(ri->imme) : NONE;
+            case Operator::ZEXT_W: return f1 == ALL ? ALL : ZEXT32;
+
+            case Operator::ADDI: return (immValid && ri->imme == 0) ? f1 : NONE;
+            case Operator::ANDI:
+                if (!immValid) return NONE;
+                return ri->imme >= 0 ? ALL : f1;
+            case Operator::AND:
+                if (f1 == ALL || f2 == ALL) return ALL;
+                return (f1 & f2 & SEXT32) | ((f1 | f2) & ZEXT32);
+            case Operator::OR:
+            case Operator::XOR: return f1 & f2;
+            case Operator::ORI:
+            case Operator::XORI:
+                if (!immValid) return NONE;
+                return (f1 & SEXT32) | (ri->imme >= 0 ? (f1 & ZEXT32) : 0u);
+            default: return NONE;
+        }
+    }
+
+    void SExtEliminationPass::computeFacts(BE::Function* func)
+    {
+        // 最大不动点：所有被定义的 vreg 先假设 ALL，再按定义指令逐轮收紧
+        facts_.clear();
+        defCnt_.clear();
+        std::vector<Register> defs;
+        for (auto& [bid, block] : func->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                adapter_->enumDefs(inst, defs);
+                for (auto& d : defs)
+                {
+                    facts_[d] = ALL;
+                    ++defCnt_[d];
+                }
+            }
+        }
+
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            std::map<Register, unsigned> next;
+            for (auto& [bid, block] : func->blocks)
+            {
+                for (auto* inst : block->insts)
+                {
+                    adapter_->enumDefs(inst, defs);
+                    if (defs.empty()) continue;
+                    unsigned f = defs.size() == 1 ? transfer(inst) : NONE;
+                    for (auto& d : defs)
+                    {
+                        auto it = next.emplace(d, ALL).first;
+                        it->second &= f;
+                    }
+                }
+            }
+            for (auto& [reg, f] : next)
+            {
+                unsigned& cur = facts_[reg];
+                if (cur != f)
+                {
+                    cur     = f;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    bool SExtEliminationPass::isRedundantExt(BE::MInstruction* inst, Register& dst, Register& src) const
+    {
+        auto* ri = dynamic_cast<Instr*>(inst);
+        if (!ri || !ri->rd.isVreg || !ri->rs1.isVreg) return false;
+
+        auto it = defCnt_.find(ri->rd);
+        if (it == defCnt_.end() || it->second != 1) return false;
+        it = defCnt_.find(ri->rs1);
+        if (it == defCnt_.end() || it->second != 1) return false;
+
+        bool redundant = false;
+        if (ri->op == Operator::ZEXT_W)
+            redundant = factOf(ri->rs1) & ZEXT32;
+        else if (ri->op == Operator::ADDIW && ri->imme == 0 && !ri->use_ops && !ri->use_label)
+            redundant = factOf(ri->rs1) & SEXT32;
+        if (!redundant) return false;
+
+        dst = ri->rd;
+        src = ri->rs1;
+        return true;
+    }
+
+    void SExtEliminationPass::runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter)
+    {
+        adapter_ = adapter;
+        computeFacts(func);
+
+        std::map<Register, Register> replaced;
+        for (auto& [bid, block] : func->blocks)
+        {
+            for (auto it = block->insts.begin(); it != block->insts.end();)
+            {
+                Register dst, src;
+                if (!isRedundantExt(*it, dst, src))
+                {
+                    ++it;
+                    continue;
+                }
+                replaced[dst] = src;
+                MInstruction::delInst(*it);
+                it = block->insts.erase(it);
+            }
+        }
+        if (replaced.empty()) return;
+
+        // 扩展链 a -> b -> c 折叠到最终源寄存器
+        auto resolve = [&replaced](Register r) {
+            for (auto it = replaced.find(r); it != replaced.end(); it = replaced.find(r)) r = it->second;
+            return r;
+        };
+
+        std::vector<Register> uses;
+        for (auto& [bid, block] : func->blocks)
+        {
+            for (auto* inst : block->insts)
+            {
+                adapter_->enumUses(inst, uses);
+                for (auto& r : uses)
+                    if (replaced.count(r)) adapter_->replaceUse(inst, r, resolve(r));
+            }
+        }
+    }
+}  // namespace BE::RV64::Passes::Optimize
@@ -0,0 +1,58 @@
+#ifndef __BACKEND_RV64_PASSES_OPTIMIZE_SEXT_ELIMINATION_H__
+#define __BACKEND_RV64_PASSES_OPTIMIZE_SEXT_ELIMINATION_H__
+
+#include <backend/mir/m_module.h>
+#include <backend/mir/m_function.h>
+#include <backend/mir/m_block.h>
+#include <backend/mir/m_instruction.h>
+#include <backend/target/target_instr_adapter.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <map>
+#include <vector>
+
+/*
+ * 冗余扩展消除（Pre-RA，SSA 形式的 MIR 上运行）
+ *
+ * RV64 的 W 指令、LW、比较指令等天然产生“从 32 位符号扩展”的结果，比较类指令的结果更是只有 0/1。
+ * 本 Pass 以最大不动点的方式为每个 vreg 求出已知的扩展性质：
+ * - SEXT32：高 32 位为第 31 位的复制（符号扩展）
+ * - ZEXT32：高 32 位全零（零扩展）
+ * 随后删除不改变值的扩展指令，并把其结果的使用改写为源寄存器：
+ * - ZEXT_W d, s   （s 已零扩展）
+ * - ADDIW d, s, 0 （sext.w，s 已符号扩展）
+ */
+namespace BE::RV64::Passes::Optimize
+{
+    class SExtEliminationPass
+    {
+      public:
+        SExtEliminationPass()  = default;
+        ~SExtEliminationPass() = default;
+
+        void runOnModule(BE::Module& module, const BE::Targeting::TargetInstrAdapter* adapter);
+        void runOnFunction(BE::Function* func, const BE::Targeting::TargetInstrAdapter* adapter);
+
+      private:
+        enum ExtFact : unsigned
+        {
+            NONE   = 0,
+            SEXT32 = 1u << 0,
+            ZEXT32 = 1u << 1,
+            ALL    = SEXT32 | ZEXT32
+        };
+
+        const BE::Targeting::TargetInstrAdapter* adapter_ = nullptr;
+        std::map<Register, unsigned>             facts_;
+        std::map<Register, int>                  defCnt_;
+
+        static unsigned constFact(int32_t val);
+
+        void     computeFacts(BE::Function* func);
+        unsigned factOf(const Register& reg) const;
+        unsigned factOf(BE::Operand* op) const;
+        unsigned transfer(BE::MInstruction* inst) const;
+        bool     isRedundantExt(BE::MInstruction* inst, Register& dst, Register& src) const;
+    };
+}  // namespace BE::RV64::Passes::Optimize
+
+#endif  // __BACKEND_RV64_PASSES_OPTIMIZE_SEXT_ELIMINATION_H__
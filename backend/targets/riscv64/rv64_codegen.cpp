@@ -5,13 +5,48 @@
 
 namespace BE::RV64
 {
-    CodeGen::CodeGen(BE::Module* module, std::ostream& output) : BE::MCodeGen(module, output) {}
+    namespace
+    {
+#define X(name, type, _asm, latency) +1
+        constexpr size_t kNumOperators = 0 RV64_INSTS;
+#undef X
+    }  // namespace
+
+    CodeGen::CodeGen(BE::Module* module, std::ostream& output) : BE::MCodeGen(module, output)
+    {
+        // 助记符与其后的对齐制表符只拼接一次，输出时整段拷贝
+        opText_.reserve(kNumOperators);
+        for (size_t i = 0; i < kNumOperators; ++i)
+        {
+            std::string text = getOpAsm(static_cast<Operator>(i));
+            text += text.length() <= 3 ? "\t\t" : "\t";
+            opText_.push_back(std::move(text));
+        }
+    }
 
     void CodeGen::generateAssembly()
     {
-        printHeader();
+        beginAssembly();
         printFunctions();
+        endAssembly();
+    }
+
+    void CodeGen::beginAssembly() { printHeader(); }
+
+    void CodeGen::emitFunction(BE::Function* func)
+    {
+        printFunction(func);
+        if (!func->constPool.empty()) constPools_.emplace_back(func->name, func->constPool);
+        cur_func_  = nullptr;
+        cur_block_ = nullptr;
+    }
+
+    void CodeGen::endAssembly()
+    {
+        if (statsOut_) printCompressionStat("module", totalCompressible_, totalInsts_);
         printGlobalDefinitions();
+        printConstantPools();
+        out_.flush();
     }
 
     void CodeGen::printHeader()
@@ -23,15 +58,29 @@ namespace BE::RV64
 
     void CodeGen::printFunctions()
     {
-        for (auto& func : module_->functions) { printFunction(func); }
+        for (auto& func : module_->functions) { emitFunction(func); }
     }
 
     void CodeGen::printFunction(BE::Function* func)
     {
-        cur_func_ = func;
+        cur_func_    = func;
+        labelPrefix_ = "." + func->name + "_";
         out_ << func->name << ":\n";
 
+        funcCompressible_ = funcInsts_ = 0;
         for (auto& [blockId, block] : func->blocks) { printBlock(block); }
+        if (!statsOut_) return;
+        printCompressionStat(func->name.c_str(), funcCompressible_, funcInsts_);
+        totalCompressible_ += funcCompressible_;
+        totalInsts_ += funcInsts_;
+    }
+
+    // 向统计流输出压缩率，如 "rvc main: 120/400 compressible (30.0%)"
+    void CodeGen::printCompressionStat(const char* scope, size_t compressible, size_t total)
+    {
+        size_t permille = total ? (compressible * 1000 + total / 2) / total : 0;
+        *statsOut_ << "rvc " << scope << ": " << compressible << "/" << total << " compressible (" << permille / 10
+                   << "." << permille % 10 << "%)\n";
     }
 
     void CodeGen::printBlock(BE::Block* block)
@@ -39,13 +88,13 @@ namespace BE::RV64
         cur_block_   = block;
         uint32_t bid = block->blockId;
 
-        out_ << "." << cur_func_->name << "_" << bid << ":\n";
+        out_ << labelPrefix_ << bid << ":\n";
 
         for (auto& inst : block->insts)
         {
-            out_ << "\t";
+            out_ << '\t';
             printInstruction(inst);
-            out_ << "\n";
+            out_ << '\n';
         }
     }
 
@@ -53,6 +102,11 @@ namespace BE::RV64
     {
         if (auto* ti = dynamic_cast<Instr*>(inst))
         {
+            if (statsOut_)
+            {
+                ++funcInsts_;
+                if (isCompressible(ti)) ++funcCompressible_;
+            }
             printASM(ti);
             return;
         }
@@ -83,14 +137,8 @@ namespace BE::RV64
                    op == Operator::SW || op == Operator::SD || op == Operator::FSW || op == Operator::FSD;
         };
 
-        std::string opAsm  = getOpInfoAsm(inst->op);
-        OpType      opType = getOpInfoType(inst->op);
-
-        out_ << opAsm;
-        if (opAsm.length() <= 3)
-            out_ << "\t\t";
-        else
-            out_ << "\t";
+        OpType opType = getOpType(inst->op);
+        out_ << opText_[static_cast<size_t>(inst->op)];
 
         switch (opType)
         {
@@ -118,7 +166,9 @@ namespace BE::RV64
 
                 if (isMemInst(inst->op))
                 {
-                    if (inst->use_ops && inst->fiop)
+                    if (inst->use_label)
+                        printOperand(inst->label);  // %lo(sym)，常量池等符号访存
+                    else if (inst->use_ops && inst->fiop)
                         printOperand(inst->fiop);  // Use fiop (could be FrameIndexOperand)
                     else
                         out_ << inst->imme;
@@ -159,7 +209,7 @@ namespace BE::RV64
                 if (inst->use_label)
                     printOperand(inst->label);
                 else
-                    out_ << "." << cur_func_->name << "_" << inst->imme;
+                    out_ << labelPrefix_ << inst->imme;
                 break;
             }
             case OpType::U:
@@ -179,7 +229,7 @@ namespace BE::RV64
                 if (inst->use_label)
                     printOperand(inst->label);
                 else
-                    out_ << "." << cur_func_->name << "_" << inst->imme;
+                    out_ << labelPrefix_ << inst->imme;
                 break;
             }
             case OpType::CALL:
@@ -281,7 +331,7 @@ namespace BE::RV64
                 out_ << "%lo(" << label.name << ")";
         }
         else
-            out_ << "." << cur_func_->name << "_" << label.jmp_label;
+            out_ << labelPrefix_ << label.jmp_label;
     }
 
     void CodeGen::printOperand(BE::Operand* op)
@@ -381,27 +431,14 @@ namespace BE::RV64
         }
     }
 
-    std::string CodeGen::getOpInfoAsm(Operator op)
+    void CodeGen::printConstantPools()
     {
-        switch (op)
+        if (constPools_.empty()) return;
+        out_ << "\t.section\t.rodata\n\t.p2align\t2\n";
+        for (auto& [name, pool] : constPools_)
         {
-#define X(name, type, _asm, latency) \
-    case Operator::name: return #_asm;
-            RV64_INSTS
-#undef X
-            default: ERROR("Unknown operator: %d", (int)op);
-        }
-    }
-
-    OpType CodeGen::getOpInfoType(Operator op)
-    {
-        switch (op)
-        {
-#define X(name, type, _asm, latency) \
-    case Operator::name: return OpType::type;
-            RV64_INSTS
-#undef X
-            default: ERROR("Unknown operator: %d", (int)op);
+            for (size_t i = 0; i < pool.size(); ++i)
+                out_ << getConstPoolLabel(name, i) << ":\n\t.word\t" << pool[i] << "\n";
         }
     }
 }  // namespace BE::RV64
@@ -4,6 +4,8 @@
 #include <backend/mir/m_codegen.h>
 #include <backend/mir/m_module.h>
 #include <backend/targets/riscv64/rv64_defs.h>
+#include <string>
+#include <vector>
 
 namespace BE::RV64
 {
@@ -14,6 +16,15 @@ namespace BE::RV64
 
         void generateAssembly() override;
 
+        // 逐函数输出（流式编译）：beginAssembly 后按顺序 emitFunction，最后 endAssembly 输出全局数据与常量池
+        // emitFunction 返回后不再访问该函数，调用者可以立即释放它
+        void beginAssembly();
+        void emitFunction(BE::Function* func);
+        void endAssembly();
+
+        /// 设置后按函数与整个模块把 RVC 可压缩率写到 os（-fcodegen-stats），汇编输出不受影响
+        void setStatsStream(std::ostream* os) { statsOut_ = os; }
+
       protected:
         void printHeader() override;
         void printFunctions() override;
@@ -27,10 +38,20 @@ namespace BE::RV64
 
       private:
         void printASM(Instr* inst);
+        void printConstantPools();
         void printOperand(const Label& label);
+        void printCompressionStat(const char* scope, size_t compressible, size_t total);
+
+        std::vector<std::string> opText_;       ///< 各指令助记符连同其后的对齐制表符
+        std::string              labelPrefix_;  ///< 当前函数块标签前缀 ".<func>_"
+
+        /// 已输出函数的常量池（函数名, 按位模式存放的常量），在文件末尾统一输出
+        std::vector<std::pair<std::string, std::vector<uint32_t>>> constPools_;
 
-        std::string getOpInfoAsm(Operator op);
-        OpType      getOpInfoType(Operator op);
+        // RVC 压缩统计：可由汇编器压缩为 16 位编码的指令数 / 指令总数（当前函数与整个模块），仅在 statsOut_ 非空时统计
+        std::ostream* statsOut_        = nullptr;
+        size_t        funcCompressible_ = 0, funcInsts_ = 0;
+        size_t        totalCompressible_ = 0, totalInsts_ = 0;
     };
 }  // namespace BE::RV64
 
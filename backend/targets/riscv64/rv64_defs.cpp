@@ -38,6 +38,131 @@ namespace BE::RV64
     OpInfo::OpInfo() {}
     OpInfo::OpInfo(std::string a, OpType t, int lat) : _asm(a), type(t), latency(lat) {}
 
+    int getOpLatency(Operator op)
+    {
+        switch (op)
+        {
+#define X(name, type, _asm, latency) \
+    case Operator::name: return latency;
+            RV64_INSTS
+#undef X
+            default: ERROR("Unknown operator: %d", (int)op);
+        }
+        return 1;
+    }
+
+    OpType getOpType(Operator op)
+    {
+        switch (op)
+        {
+#define X(name, type, _asm, latency) \
+    case Operator::name: return OpType::type;
+            RV64_INSTS
+#undef X
+            default: ERROR("Unknown operator: %d", (int)op);
+        }
+        return OpType::R;
+    }
+
+    const char* getOpAsm(Operator op)
+    {
+        switch (op)
+        {
+#define X(name, type, _asm, latency) \
+    case Operator::name: return #_asm;
+            RV64_INSTS
+#undef X
+            default: ERROR("Unknown operator: %d", (int)op);
+        }
+        return "";
+    }
+
+    namespace
+    {
+        // RVC 三位寄存器字段只能编码 x8-x15 / f8-f15
+        bool isCReg(const Register& r) { return !r.isVreg && ((r.rId >= 8 && r.rId <= 15) || (r.rId >= 40 && r.rId <= 47)); }
+        bool isSimm6(int v) { return v >= -32 && v <= 31; }
+        // 按 scale 对齐且位于 [0, maxOff] 的无符号偏移
+        bool isScaledUimm(int v, int scale, int maxOff) { return v >= 0 && v <= maxOff && v % scale == 0; }
+    }  // namespace
+
+    bool isCompressible(const Instr* inst)
+    {
+        if (inst->use_ops || (inst->use_label && getOpType(inst->op) != OpType::B && getOpType(inst->op) != OpType::J))
+            return false;
+
+        const uint32_t zero = PR::x0.rId, sp = PR::sp.rId, ra = PR::ra.rId;
+        const Register &rd = inst->rd, &rs1 = inst->rs1, &rs2 = inst->rs2;
+        const int       imm = inst->imme;
+        // rd 与某一源操作数相同、另一源操作数为 RVC 寄存器（可交换的二元运算）
+        auto cBinary = [&](bool commutative) {
+            if (!isCReg(rd)) return false;
+            if (rd.rId == rs1.rId && isCReg(rs2)) return true;
+            return commutative && rd.rId == rs2.rId && isCReg(rs1);
+        };
+
+        switch (inst->op)
+        {
+            case Operator::ADDI:
+                if (rd.rId == zero) return false;
+                if (rs1.rId == zero) return isSimm6(imm);                                        // c.li
+                if (imm == 0) return true;                                                       // c.mv
+                if (rd.rId == sp && rs1.rId == sp) return imm % 16 == 0 && imm >= -512 && imm <= 496;  // c.addi16sp
+                if (rs1.rId == sp) return isCReg(rd) && imm > 0 && isScaledUimm(imm, 4, 1020);   // c.addi4spn
+                return rd.rId == rs1.rId && isSimm6(imm);                                        // c.addi
+            case Operator::ADDIW: return rd.rId != zero && rd.rId == rs1.rId && isSimm6(imm);   // c.addiw
+            case Operator::LI: return rd.rId != zero && isSimm6(imm);                           // c.li
+            case Operator::LUI:  // c.lui：20 位立即数按有符号数取值
+            {
+                int hi = imm >= 0x80000 ? imm - 0x100000 : imm;
+                return rd.rId != zero && rd.rId != sp && hi != 0 && isSimm6(hi);
+            }
+            case Operator::SLLI: return rd.rId != zero && rd.rId == rs1.rId && imm != 0;        // c.slli
+            case Operator::SRLI:
+            case Operator::SRAI: return isCReg(rd) && rd.rId == rs1.rId && imm != 0;            // c.srli / c.srai
+            case Operator::ANDI: return isCReg(rd) && rd.rId == rs1.rId && isSimm6(imm);        // c.andi
+            case Operator::ADD:                                                                 // c.add / c.mv
+                if (rd.rId == zero) return false;
+                if (rd.rId == rs1.rId && rs2.rId != zero) return true;
+                if (rd.rId == rs2.rId && rs1.rId != zero) return true;
+                return rs1.rId == zero && rs2.rId != zero;
+            case Operator::SUB:
+            case Operator::SUBW: return cBinary(false);  // c.sub / c.subw
+            case Operator::AND:
+            case Operator::OR:
+            case Operator::XOR:
+            case Operator::ADDW: return cBinary(true);  // c.and / c.or / c.xor / c.addw
+            case Operator::LW:
+                if (rs1.rId == sp) return rd.rId != zero && isScaledUimm(imm, 4, 252);  // c.lwsp
+                return isCReg(rd) && isCReg(rs1) && isScaledUimm(imm, 4, 124);          // c.lw
+            case Operator::LD:
+                if (rs1.rId == sp) return rd.rId != zero && isScaledUimm(imm, 8, 504);  // c.ldsp
+                return isCReg(rd) && isCReg(rs1) && isScaledUimm(imm, 8, 248);          // c.ld
+            case Operator::FLD:
+                if (rs1.rId == sp) return isScaledUimm(imm, 8, 504);                     // c.fldsp
+                return isCReg(rd) && isCReg(rs1) && isScaledUimm(imm, 8, 248);          // c.fld
+            // 存储：rs1 为待存值，rs2 为基址
+            case Operator::SW:
+                if (rs2.rId == sp) return isScaledUimm(imm, 4, 252);                     // c.swsp
+                return isCReg(rs1) && isCReg(rs2) && isScaledUimm(imm, 4, 124);         // c.sw
+            case Operator::SD:
+            case Operator::FSD:
+                if (rs2.rId == sp) return isScaledUimm(imm, 8, 504);                     // c.sdsp / c.fsdsp
+                return isCReg(rs1) && isCReg(rs2) && isScaledUimm(imm, 8, 248);         // c.sd / c.fsd
+            case Operator::BEQ:
+            case Operator::BNE: return isCReg(rs1) && rs2.rId == zero;                  // c.beqz / c.bnez
+            case Operator::JAL: return rd.rId == zero;                                  // c.j
+            case Operator::JALR: return (rd.rId == zero || rd.rId == ra) && rs1.rId != zero && imm == 0;  // c.jr / c.jalr
+            case Operator::RET: return true;                                            // c.jr ra
+            default: return false;
+        }
+    }
+
+    std::string getConstPoolLabel(const std::string& funcName, size_t idx)
+    {
+        return "." + funcName + "_cp" + std::to_string(idx);
+    }
+
     Instr* createRInst_impl(Operator op, Register rd, Register rs1, Register rs2, const std::string& comment)
     {
         Instr* inst   = new Instr();
@@ -70,14 +195,15 @@ namespace BE::RV64
         return inst;
     }
 
-    Instr* createIInst_impl(Operator op, Register rd, Register rs1, Label /* label */, const std::string& comment)
+    Instr* createIInst_impl(Operator op, Register rd, Register rs1, Label label, const std::string& comment)
     {
-        Instr* inst   = new Instr();
-        inst->op      = op;
-        inst->rd      = rd;
-        inst->rs1     = rs1;
-        inst->comment = comment;
-        // TODO: Handle label for instruction
+        Instr* inst     = new Instr();
+        inst->op        = op;
+        inst->rd        = rd;
+        inst->rs1       = rs1;
+        inst->label     = label;
+        inst->use_label = true;
+        inst->comment   = comment;
         return inst;
     }
 
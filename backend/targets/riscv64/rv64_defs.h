@@ -55,6 +55,9 @@
     X(SLL, R, sll, 1)            \
     X(SRL, R, srl, 1)            \
     X(SRA, R, sra, 1)            \
+    X(SLLW, R, sllw, 1)          \
+    X(SRLW, R, srlw, 1)          \
+    X(SRAW, R, sraw, 1)          \
     X(AND, R, and, 1)            \
     X(OR, R, or, 1)              \
     X(XOR, R, xor, 1)            \
@@ -320,6 +323,16 @@ namespace BE::RV64
         {}
     };
 
+    // 查询 RV64_INSTS 中登记的指令延迟（周期数），供代价模型使用
+    int getOpLatency(Operator op);
+    // 查询 RV64_INSTS 中登记的指令格式与助记符（目标文件输出使用）
+    OpType      getOpType(Operator op);
+    const char* getOpAsm(Operator op);
+    // 函数常量池第 idx 项的标签名（.<func>_cp<idx>）
+    std::string getConstPoolLabel(const std::string& funcName, size_t idx);
+    // 分配后的指令能否被汇编器压缩为 RVC 16 位编码（跳转/分支只看形式，不检查目标距离）
+    bool isCompressible(const Instr* inst);
+
     Instr* createRInst_impl(Operator op, Register rd, Register rs1, Register rs2, const std::string& comment = "");
     Instr* createR2Inst_impl(Operator op, Register rd, Register rs, const std::string& comment = "");
 
@@ -0,0 +1,674 @@
+#include <backend/targets/riscv64/rv64_elf_writer.h>
+#include <debug.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace BE::RV64
+{
+    namespace
+    {
+        // ELF64 常量（只列出用到的部分，避免依赖宿主机的 <elf.h>）
+        constexpr uint16_t ET_REL    = 1;
+        constexpr uint16_t EM_RISCV  = 243;
+        constexpr uint32_t EF_RISCV_FLOAT_ABI_DOUBLE = 0x4;
+
+        constexpr uint32_t SHT_PROGBITS = 1;
+        constexpr uint32_t SHT_SYMTAB   = 2;
+        constexpr uint32_t SHT_STRTAB   = 3;
+        constexpr uint32_t SHT_RELA     = 4;
+        constexpr uint32_t SHT_NOBITS   = 8;
+
+        constexpr uint64_t SHF_WRITE     = 0x1;
+        constexpr uint64_t SHF_ALLOC     = 0x2;
+        constexpr uint64_t SHF_EXECINSTR = 0x4;
+        constexpr uint64_t SHF_INFO_LINK = 0x40;
+
+        constexpr uint8_t STB_LOCAL   = 0;
+        constexpr uint8_t STB_GLOBAL  = 1;
+        constexpr uint8_t STT_NOTYPE  = 0;
+        constexpr uint8_t STT_OBJECT  = 1;
+        constexpr uint8_t STT_FUNC    = 2;
+        constexpr uint16_t SHN_UNDEF  = 0;
+
+        constexpr uint32_t R_RISCV_CALL_PLT     = 19;
+        constexpr uint32_t R_RISCV_PCREL_HI20   = 23;
+        constexpr uint32_t R_RISCV_PCREL_LO12_I = 24;
+        constexpr uint32_t R_RISCV_HI20         = 26;
+        constexpr uint32_t R_RISCV_LO12_I       = 27;
+        constexpr uint32_t R_RISCV_LO12_S       = 28;
+
+        // 固定的节顺序
+        enum SectionIndex : uint16_t
+        {
+            SEC_NULL = 0,
+            SEC_TEXT,
+            SEC_RELA_TEXT,
+            SEC_DATA,
+            SEC_BSS,
+            SEC_RODATA,
+            SEC_SYMTAB,
+            SEC_STRTAB,
+            SEC_SHSTRTAB,
+            SEC_COUNT
+        };
+
+        // 基本指令格式
+        constexpr uint32_t OPC_LOAD    = 0x03;
+        constexpr uint32_t OPC_LOAD_FP = 0x07;
+        constexpr uint32_t OPC_OP_IMM  = 0x13;
+        constexpr uint32_t OPC_AUIPC   = 0x17;
+        constexpr uint32_t OPC_OP_IMM32 = 0x1b;
+        constexpr uint32_t OPC_STORE   = 0x23;
+        constexpr uint32_t OPC_STORE_FP = 0x27;
+        constexpr uint32_t OPC_OP      = 0x33;
+        constexpr uint32_t OPC_LUI     = 0x37;
+        constexpr uint32_t OPC_OP32    = 0x3b;
+        constexpr uint32_t OPC_OP_FP   = 0x53;
+        constexpr uint32_t OPC_BRANCH  = 0x63;
+        constexpr uint32_t OPC_JALR    = 0x67;
+        constexpr uint32_t OPC_JAL     = 0x6f;
+
+        constexpr uint32_t RM_RTZ = 1;
+        constexpr uint32_t RM_DYN = 7;
+
+        uint32_t encR(uint32_t opc, uint32_t rd, uint32_t f3, uint32_t rs1, uint32_t rs2, uint32_t f7)
+        {
+            return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | opc;
+        }
+        uint32_t encI(uint32_t opc, uint32_t rd, uint32_t f3, uint32_t rs1, int32_t imm)
+        {
+            return ((static_cast<uint32_t>(imm) & 0xfff) << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | opc;
+        }
+        uint32_t encS(uint32_t opc, uint32_t f3, uint32_t base, uint32_t val, int32_t imm)
+        {
+            uint32_t u = static_cast<uint32_t>(imm);
+            return (((u >> 5) & 0x7f) << 25) | (val << 20) | (base << 15) | (f3 << 12) | ((u & 0x1f) << 7) | opc;
+        }
+        uint32_t encB(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm)
+        {
+            uint32_t u = static_cast<uint32_t>(imm);
+            return (((u >> 12) & 1) << 31) | (((u >> 5) & 0x3f) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) |
+                   (((u >> 1) & 0xf) << 8) | (((u >> 11) & 1) << 7) | OPC_BRANCH;
+        }
+        uint32_t encU(uint32_t opc, uint32_t rd, uint32_t imm20) { return ((imm20 & 0xfffff) << 12) | (rd << 7) | opc; }
+        uint32_t encJ(uint32_t rd, int32_t imm)
+        {
+            uint32_t u = static_cast<uint32_t>(imm);
+            return (((u >> 20) & 1) << 31) | (((u >> 1) & 0x3ff) << 21) | (((u >> 11) & 1) << 20) |
+                   (((u >> 12) & 0xff) << 12) | (rd << 7) | OPC_JAL;
+        }
+
+        uint32_t regNo(const Register& r)
+        {
+            if (r.isVreg) ERROR("Virtual register v_%u reached object emission", r.rId);
+            return r.rId & 31;
+        }
+
+        bool fitsImm12(int64_t v) { return v >= -2048 && v <= 2047; }
+        bool fitsBranch(int64_t v) { return v >= -4096 && v <= 4094; }
+        bool fitsJal(int64_t v) { return v >= -(int64_t(1) << 20) && v <= (int64_t(1) << 20) - 2; }
+
+        // li 的展开：12 位以内为 addi rd, x0, imm，否则为 lui (+ addiw)
+        void splitImm32(int32_t imm, int32_t& hi20, int32_t& lo12)
+        {
+            int64_t v = imm;
+            lo12      = static_cast<int32_t>(((v & 0xfff) ^ 0x800) - 0x800);
+            hi20      = static_cast<int32_t>(((v - lo12) >> 12) & 0xfffff);
+        }
+
+        // 条件分支：funct3 与是否需要交换操作数（bgt/ble 等伪指令）
+        void branchInfo(Operator op, uint32_t& f3, bool& swap)
+        {
+            swap = false;
+            switch (op)
+            {
+                case Operator::BEQ: f3 = 0; break;
+                case Operator::BNE: f3 = 1; break;
+                case Operator::BLT: f3 = 4; break;
+                case Operator::BGE: f3 = 5; break;
+                case Operator::BLTU: f3 = 6; break;
+                case Operator::BGEU: f3 = 7; break;
+                case Operator::BGT: f3 = 4, swap = true; break;
+                case Operator::BLE: f3 = 5, swap = true; break;
+                case Operator::BGTU: f3 = 6, swap = true; break;
+                case Operator::BLEU: f3 = 7, swap = true; break;
+                default: ERROR("Not a branch operator: %d", static_cast<int>(op));
+            }
+        }
+
+        void put16(std::vector<uint8_t>& buf, uint16_t v)
+        {
+            for (int i = 0; i < 2; ++i) buf.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+        void put32(std::vector<uint8_t>& buf, uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i) buf.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+        void put64(std::vector<uint8_t>& buf, uint64_t v)
+        {
+            for (int i = 0; i < 8; ++i) buf.push_back(static_cast<uint8_t>(v >> (8 * i)));
+        }
+        void alignTo(std::vector<uint8_t>& buf, size_t align)
+        {
+            while (buf.size() % align) buf.push_back(0);
+        }
+
+        bool isMemInst(Operator op)
+        {
+            return op == Operator::LW || op == Operator::LD || op == Operator::FLW || op == Operator::FLD ||
+                   op == Operator::SW || op == Operator::SD || op == Operator::FSW || op == Operator::FSD;
+        }
+    }  // namespace
+
+    ELFWriter::ELFWriter(BE::Module* module, std::ostream& output) : module_(module), out_(output) {}
+
+    void ELFWriter::write()
+    {
+        for (auto* func : module_->functions) addFunction(func);
+        finish();
+    }
+
+    void ELFWriter::addFunction(BE::Function* func)
+    {
+        encodeFunction(func);
+        if (!func->constPool.empty()) constPools_.emplace_back(func->name, func->constPool);
+        curFunc_ = nullptr;
+        longBranch_.clear();
+    }
+
+    void ELFWriter::finish()
+    {
+        emitData();
+        emitConstPools();
+        writeFile();
+    }
+
+    void ELFWriter::emit32(uint32_t word) { put32(text_, word); }
+
+    void ELFWriter::addReloc(uint32_t type, const std::string& symbol, int64_t addend)
+    {
+        textRelocs_.push_back({text_.size(), type, symbol, addend});
+    }
+
+    void ELFWriter::addSymbol(
+        const std::string& name, uint8_t bind, uint8_t type, uint16_t shndx, uint64_t value, uint64_t size)
+    {
+        symbols_.push_back({name, bind, type, shndx, value, size});
+    }
+
+    // ==================== .text ====================
+
+    int ELFWriter::branchTarget(const Instr* inst) const
+    {
+        if (inst->use_label)
+        {
+            if (inst->label.is_data) ERROR("Branch to data label %s", inst->label.name.c_str());
+            return inst->label.jmp_label;
+        }
+        return inst->imme;
+    }
+
+    uint32_t ELFWriter::instSize(const Instr* inst) const
+    {
+        switch (inst->op)
+        {
+            case Operator::LI:
+            {
+                if (fitsImm12(inst->imme)) return 4;
+                int32_t hi, lo;
+                splitImm32(inst->imme, hi, lo);
+                return lo == 0 ? 4 : 8;
+            }
+            case Operator::LA:
+            case Operator::CALL:
+            case Operator::ZEXT_W: return 8;
+            case Operator::BEQ:
+            case Operator::BNE:
+            case Operator::BLT:
+            case Operator::BGE:
+            case Operator::BLTU:
+            case Operator::BGEU:
+            case Operator::BGT:
+            case Operator::BLE:
+            case Operator::BGTU:
+            case Operator::BLEU:
+            {
+                auto it = longBranch_.find(inst);
+                return it != longBranch_.end() && it->second ? 8 : 4;
+            }
+            default: return 4;
+        }
+    }
+
+    void ELFWriter::layoutFunction(BE::Function* func, uint64_t base)
+    {
+        // 先假设所有条件分支都能直接到达，再把越界的改为长形式并重新布局；长形式只增不减，迭代必然收敛
+        longBranch_.clear();
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            blockOffset_.clear();
+            std::vector<std::pair<const Instr*, uint64_t>> branches;
+            uint64_t                                       pc = base;
+            for (auto& [bid, block] : func->blocks)
+            {
+                blockOffset_[bid] = pc;
+                for (auto* inst : block->insts)
+                {
+                    auto* ri = dynamic_cast<Instr*>(inst);
+                    if (!ri) ERROR("Non-target instruction reached object emission in %s", func->name.c_str());
+                    if (getOpType(ri->op) == OpType::B) branches.push_back({ri, pc});
+                    pc += instSize(ri);
+                }
+            }
+            for (auto& [ri, at] : branches)
+            {
+                if (longBranch_[ri]) continue;
+                auto it = blockOffset_.find(static_cast<uint32_t>(branchTarget(ri)));
+                if (it == blockOffset_.end()) ERROR("Branch to unknown block %d", branchTarget(ri));
+                if (fitsBranch(static_cast<int64_t>(it->second) - static_cast<int64_t>(at))) continue;
+                longBranch_[ri] = true;
+                changed         = true;
+            }
+        }
+    }
+
+    void ELFWriter::encodeFunction(BE::Function* func)
+    {
+        curFunc_      = func;
+        uint64_t start = text_.size();
+        layoutFunction(func, start);
+
+        for (auto& [bid, block] : func->blocks)
+        {
+            // 与汇编输出一致，块标签 .<func>_<bid> 作为局部符号保留，便于 objdump 对照
+            addSymbol("." + func->name + "_" + std::to_string(bid), STB_LOCAL, STT_NOTYPE, SEC_TEXT, text_.size(), 0);
+            for (auto* inst : block->insts) encodeInst(static_cast<Instr*>(inst));
+        }
+
+        addSymbol(func->name, func->name == "main" ? STB_GLOBAL : STB_LOCAL, STT_FUNC, SEC_TEXT, start,
+            text_.size() - start);
+    }
+
+    void ELFWriter::encodeInst(const Instr* inst)
+    {
+        Operator op = inst->op;
+        if (inst->use_ops && inst->fiop) ERROR("Unlowered frame index reached object emission");
+
+        // 立即数字段：访存指令可带 %lo(sym)，其余为数值
+        auto immOf = [&](uint32_t loReloc) -> int32_t {
+            if (inst->use_label && isMemInst(op))
+            {
+                if (!inst->label.is_data || inst->label.is_hi) ERROR("Unsupported label in memory operand");
+                addReloc(loReloc, inst->label.name);
+                return 0;
+            }
+            if (!fitsImm12(inst->imme)) ERROR("Immediate %d out of range for 12-bit field", inst->imme);
+            return inst->imme;
+        };
+
+        uint32_t rd = 0, rs1 = 0, rs2 = 0;
+        switch (getOpType(op))
+        {
+            case OpType::R:
+                rd  = regNo(inst->rd);
+                rs1 = regNo(inst->rs1);
+                rs2 = regNo(inst->rs2);
+                break;
+            case OpType::R2:
+            case OpType::I:
+                rd  = regNo(inst->rd);
+                rs1 = regNo(inst->rs1);
+                break;
+            default: break;
+        }
+
+        switch (op)
+        {
+            // ---------- R ----------
+            case Operator::ADD: emit32(encR(OPC_OP, rd, 0, rs1, rs2, 0x00)); return;
+            case Operator::SUB: emit32(encR(OPC_OP, rd, 0, rs1, rs2, 0x20)); return;
+            case Operator::SLL: emit32(encR(OPC_OP, rd, 1, rs1, rs2, 0x00)); return;
+            case Operator::SLT: emit32(encR(OPC_OP, rd, 2, rs1, rs2, 0x00)); return;
+            case Operator::SLTU: emit32(encR(OPC_OP, rd, 3, rs1, rs2, 0x00)); return;
+            case Operator::XOR: emit32(encR(OPC_OP, rd, 4, rs1, rs2, 0x00)); return;
+            case Operator::SRL: emit32(encR(OPC_OP, rd, 5, rs1, rs2, 0x00)); return;
+            case Operator::SRA: emit32(encR(OPC_OP, rd, 5, rs1, rs2, 0x20)); return;
+            case Operator::OR: emit32(encR(OPC_OP, rd, 6, rs1, rs2, 0x00)); return;
+            case Operator::AND: emit32(encR(OPC_OP, rd, 7, rs1, rs2, 0x00)); return;
+            case Operator::MUL: emit32(encR(OPC_OP, rd, 0, rs1, rs2, 0x01)); return;
+            case Operator::DIV: emit32(encR(OPC_OP, rd, 4, rs1, rs2, 0x01)); return;
+            case Operator::REM: emit32(encR(OPC_OP, rd, 6, rs1, rs2, 0x01)); return;
+            case Operator::ADDW: emit32(encR(OPC_OP32, rd, 0, rs1, rs2, 0x00)); return;
+            case Operator::SUBW: emit32(encR(OPC_OP32, rd, 0, rs1, rs2, 0x20)); return;
+            case Operator::SLLW: emit32(encR(OPC_OP32, rd, 1, rs1, rs2, 0x00)); return;
+            case Operator::SRLW: emit32(encR(OPC_OP32, rd, 5, rs1, rs2, 0x00)); return;
+            case Operator::SRAW: emit32(encR(OPC_OP32, rd, 5, rs1, rs2, 0x20)); return;
+            case Operator::MULW: emit32(encR(OPC_OP32, rd, 0, rs1, rs2, 0x01)); return;
+            case Operator::DIVW: emit32(encR(OPC_OP32, rd, 4, rs1, rs2, 0x01)); return;
+            case Operator::REMW: emit32(encR(OPC_OP32, rd, 6, rs1, rs2, 0x01)); return;
+            case Operator::FADD_S: emit32(encR(OPC_OP_FP, rd, RM_DYN, rs1, rs2, 0x00)); return;
+            case Operator::FSUB_S: emit32(encR(OPC_OP_FP, rd, RM_DYN, rs1, rs2, 0x04)); return;
+            case Operator::FMUL_S: emit32(encR(OPC_OP_FP, rd, RM_DYN, rs1, rs2, 0x08)); return;
+            case Operator::FDIV_S: emit32(encR(OPC_OP_FP, rd, RM_DYN, rs1, rs2, 0x0c)); return;
+            case Operator::FMIN_S: emit32(encR(OPC_OP_FP, rd, 0, rs1, rs2, 0x14)); return;
+            case Operator::FMAX_S: emit32(encR(OPC_OP_FP, rd, 1, rs1, rs2, 0x14)); return;
+            case Operator::FEQ_S: emit32(encR(OPC_OP_FP, rd, 2, rs1, rs2, 0x50)); return;
+            case Operator::FLT_S: emit32(encR(OPC_OP_FP, rd, 1, rs1, rs2, 0x50)); return;
+            case Operator::FLE_S: emit32(encR(OPC_OP_FP, rd, 0, rs1, rs2, 0x50)); return;
+
+            // ---------- R2（含伪指令） ----------
+            case Operator::FMV_W_X: emit32(encR(OPC_OP_FP, rd, 0, rs1, 0, 0x78)); return;
+            case Operator::FMV_X_W: emit32(encR(OPC_OP_FP, rd, 0, rs1, 0, 0x70)); return;
+            case Operator::FCVT_S_W: emit32(encR(OPC_OP_FP, rd, RM_DYN, rs1, 0, 0x68)); return;
+            case Operator::FCVT_W_S: emit32(encR(OPC_OP_FP, rd, RM_RTZ, rs1, 0, 0x60)); return;
+            case Operator::FMV_S: emit32(encR(OPC_OP_FP, rd, 0, rs1, rs1, 0x10)); return;
+            case Operator::FMV_D: emit32(encR(OPC_OP_FP, rd, 0, rs1, rs1, 0x11)); return;
+            case Operator::FNEG_S: emit32(encR(OPC_OP_FP, rd, 1, rs1, rs1, 0x10)); return;
+            case Operator::ZEXT_W:
+                // 无 Zba 时与 GNU as 相同，展开为 slli + srli
+                emit32(encI(OPC_OP_IMM, rd, 1, rs1, 32));
+                emit32(encI(OPC_OP_IMM, rd, 5, rd, 32));
+                return;
+
+            // ---------- I ----------
+            case Operator::ADDI: emit32(encI(OPC_OP_IMM, rd, 0, rs1, immOf(0))); return;
+            case Operator::SLTI: emit32(encI(OPC_OP_IMM, rd, 2, rs1, immOf(0))); return;
+            case Operator::SLTIU: emit32(encI(OPC_OP_IMM, rd, 3, rs1, immOf(0))); return;
+            case Operator::XORI: emit32(encI(OPC_OP_IMM, rd, 4, rs1, immOf(0))); return;
+            case Operator::ORI: emit32(encI(OPC_OP_IMM, rd, 6, rs1, immOf(0))); return;
+            case Operator::ANDI: emit32(encI(OPC_OP_IMM, rd, 7, rs1, immOf(0))); return;
+            case Operator::SLLI: emit32(encI(OPC_OP_IMM, rd, 1, rs1, inst->imme & 0x3f)); return;
+            case Operator::SRLI: emit32(encI(OPC_OP_IMM, rd, 5, rs1, inst->imme & 0x3f)); return;
+            case Operator::SRAI: emit32(encI(OPC_OP_IMM, rd, 5, rs1, 0x400 | (inst->imme & 0x3f))); return;
+            case Operator::ADDIW: emit32(encI(OPC_OP_IMM32, rd, 0, rs1, immOf(0))); return;
+            case Operator::SLLIW: emit32(encI(OPC_OP_IMM32, rd, 1, rs1, inst->imme & 0x1f)); return;
+            case Operator::SRLIW: emit32(encI(OPC_OP_IMM32, rd, 5, rs1, inst->imme & 0x1f)); return;
+            case Operator::SRAIW: emit32(encI(OPC_OP_IMM32, rd, 5, rs1, 0x400 | (inst->imme & 0x1f))); return;
+            case Operator::JALR: emit32(encI(OPC_JALR, rd, 0, rs1, immOf(0))); return;
+            case Operator::RET: emit32(encI(OPC_JALR, 0, 0, regNo(PR::ra), 0)); return;
+            case Operator::LW: emit32(encI(OPC_LOAD, rd, 2, rs1, immOf(R_RISCV_LO12_I))); return;
+            case Operator::LD: emit32(encI(OPC_LOAD, rd, 3, rs1, immOf(R_RISCV_LO12_I))); return;
+            case Operator::FLW: emit32(encI(OPC_LOAD_FP, rd, 2, rs1, immOf(R_RISCV_LO12_I))); return;
+            case Operator::FLD: emit32(encI(OPC_LOAD_FP, rd, 3, rs1, immOf(R_RISCV_LO12_I))); return;
+
+            // ---------- S：rs1 为被存储的值，rs2 为基址 ----------
+            case Operator::SW:
+            case Operator::SD:
+            case Operator::FSW:
+            case Operator::FSD:
+            {
+                uint32_t opc = (op == Operator::SW || op == Operator::SD) ? OPC_STORE : OPC_STORE_FP;
+                uint32_t f3  = (op == Operator::SW || op == Operator::FSW) ? 2 : 3;
+                emit32(encS(opc, f3, regNo(inst->rs2), regNo(inst->rs1), immOf(R_RISCV_LO12_S)));
+                return;
+            }
+
+            // ---------- U（含伪指令） ----------
+            case Operator::LUI:
+            {
+                rd = regNo(inst->rd);
+                if (inst->use_label)
+                {
+                    if (!inst->label.is_data || !inst->label.is_hi) ERROR("lui expects a %%hi(symbol) operand");
+                    addReloc(R_RISCV_HI20, inst->label.name);
+                    emit32(encU(OPC_LUI, rd, 0));
+                }
+                else
+                    emit32(encU(OPC_LUI, rd, static_cast<uint32_t>(inst->imme)));
+                return;
+            }
+            case Operator::LI:
+            {
+                rd = regNo(inst->rd);
+                if (inst->use_label) ERROR("li with a label operand");
+                if (fitsImm12(inst->imme))
+                {
+                    emit32(encI(OPC_OP_IMM, rd, 0, 0, inst->imme));
+                    return;
+                }
+                int32_t hi, lo;
+                splitImm32(inst->imme, hi, lo);
+                emit32(encU(OPC_LUI, rd, static_cast<uint32_t>(hi)));
+                if (lo != 0) emit32(encI(OPC_OP_IMM32, rd, 0, rd, lo));
+                return;
+            }
+            case Operator::LA:
+            {
+                // auipc rd, %pcrel_hi(sym); addi rd, rd, %pcrel_lo(.Lpcrel_hiN)
+                rd = regNo(inst->rd);
+                if (!inst->use_label || !inst->label.is_data) ERROR("la expects a symbol operand");
+                std::string anchor = ".Lpcrel_hi" + std::to_string(pcrelCount_++);
+                addSymbol(anchor, STB_LOCAL, STT_NOTYPE, SEC_TEXT, text_.size(), 0);
+                addReloc(R_RISCV_PCREL_HI20, inst->label.name);
+                emit32(encU(OPC_AUIPC, rd, 0));
+                addReloc(R_RISCV_PCREL_LO12_I, anchor);
+                emit32(encI(OPC_OP_IMM, rd, 0, rd, 0));
+                return;
+            }
+
+            // ---------- B / J：块标签在函数内解析 ----------
+            case Operator::BEQ:
+            case Operator::BNE:
+            case Operator::BLT:
+            case Operator::BGE:
+            case Operator::BLTU:
+            case Operator::BGEU:
+            case Operator::BGT:
+            case Operator::BLE:
+            case Operator::BGTU:
+            case Operator::BLEU:
+            {
+                uint32_t f3;
+                bool     swap;
+                branchInfo(op, f3, swap);
+                uint32_t a = regNo(inst->rs1), b = regNo(inst->rs2);
+                if (swap) std::swap(a, b);
+
+                int64_t pc     = static_cast<int64_t>(text_.size());
+                int64_t target = static_cast<int64_t>(blockOffset_.at(static_cast<uint32_t>(branchTarget(inst))));
+                if (instSize(inst) == 4)
+                {
+                    emit32(encB(f3, a, b, static_cast<int32_t>(target - pc)));
+                    return;
+                }
+                // 长分支：反向条件跳过紧随的 jal
+                int64_t off = target - (pc + 4);
+                if (!fitsJal(off)) ERROR("Branch target out of range in %s", curFunc_->name.c_str());
+                emit32(encB(f3 ^ 1, a, b, 8));
+                emit32(encJ(0, static_cast<int32_t>(off)));
+                return;
+            }
+            case Operator::JAL:
+            {
+                int64_t off = static_cast<int64_t>(blockOffset_.at(static_cast<uint32_t>(branchTarget(inst)))) -
+                              static_cast<int64_t>(text_.size());
+                if (!fitsJal(off)) ERROR("Jump target out of range in %s", curFunc_->name.c_str());
+                emit32(encJ(regNo(inst->rd), static_cast<int32_t>(off)));
+                return;
+            }
+
+            case Operator::CALL:
+                // auipc ra, 0; jalr ra, 0(ra)，由链接器通过 R_RISCV_CALL_PLT 回填
+                addReloc(R_RISCV_CALL_PLT, inst->func_name);
+                emit32(encU(OPC_AUIPC, regNo(PR::ra), 0));
+                emit32(encI(OPC_JALR, regNo(PR::ra), 0, regNo(PR::ra), 0));
+                return;
+
+            default: ERROR("Unsupported instruction in object emission: %s", getOpAsm(op));
+        }
+    }
+
+    // ==================== .data / .bss / .rodata ====================
+
+    void ELFWriter::emitData()
+    {
+        for (auto* gv : module_->globals)
+        {
+            bool isWord   = gv->type == I32 || gv->type == F32;
+            int  elemSize = isWord ? 4 : 8;
+            int  count    = 1;
+            for (int d : gv->dims) count *= d;
+
+            std::vector<uint8_t> bytes;
+            for (int i = 0; i < count; ++i)
+            {
+                int64_t v = i < static_cast<int>(gv->initVals.size()) ? gv->initVals[i] : 0;
+                if (gv->type == F64) v = 0;
+                if (isWord)
+                    put32(bytes, static_cast<uint32_t>(v));
+                else
+                    put64(bytes, static_cast<uint64_t>(v));
+            }
+
+            bool zero = std::all_of(bytes.begin(), bytes.end(), [](uint8_t b) { return b == 0; });
+            if (zero)
+            {
+                bssSize_ = (bssSize_ + elemSize - 1) / elemSize * elemSize;
+                addSymbol(gv->name, STB_LOCAL, STT_OBJECT, SEC_BSS, bssSize_, bytes.size());
+                bssSize_ += bytes.size();
+                continue;
+            }
+            alignTo(data_, elemSize);
+            addSymbol(gv->name, STB_LOCAL, STT_OBJECT, SEC_DATA, data_.size(), bytes.size());
+            data_.insert(data_.end(), bytes.begin(), bytes.end());
+        }
+    }
+
+    void ELFWriter::emitConstPools()
+    {
+        for (auto& [name, pool] : constPools_)
+        {
+            for (size_t i = 0; i < pool.size(); ++i)
+            {
+                addSymbol(getConstPoolLabel(name, i), STB_LOCAL, STT_OBJECT, SEC_RODATA, rodata_.size(), 4);
+                put32(rodata_, pool[i]);
+            }
+        }
+    }
+
+    // ==================== 文件写出 ====================
+
+    void ELFWriter::writeFile()
+    {
+        // 1. 符号表：局部符号在前，被引用但未定义的符号作为全局未定义符号追加
+        std::vector<Symbol> locals, globals;
+        for (auto& s : symbols_) (s.bind == STB_LOCAL ? locals : globals).push_back(s);
+        std::unordered_map<std::string, size_t> defined;
+        for (auto& s : symbols_) defined.emplace(s.name, 0);
+        for (auto& r : textRelocs_)
+        {
+            if (defined.count(r.symbol)) continue;
+            defined.emplace(r.symbol, 0);
+            globals.push_back({r.symbol, STB_GLOBAL, STT_NOTYPE, SHN_UNDEF, 0, 0});
+        }
+
+        std::vector<uint8_t>                    strtab{0};
+        std::vector<uint8_t>                    symtab(24, 0);  // 0 号空符号
+        std::unordered_map<std::string, uint32_t> symIndex;
+        uint32_t                                index = 1;
+        for (auto* list : {&locals, &globals})
+        {
+            for (auto& s : *list)
+            {
+                put32(symtab, static_cast<uint32_t>(strtab.size()));
+                strtab.insert(strtab.end(), s.name.begin(), s.name.end());
+                strtab.push_back(0);
+                symtab.push_back(static_cast<uint8_t>((s.bind << 4) | s.type));
+                symtab.push_back(0);
+                put16(symtab, s.shndx);
+                put64(symtab, s.value);
+                put64(symtab, s.size);
+                symIndex.emplace(s.name, index++);
+            }
+        }
+
+        // 2. 重定位表
+        std::vector<uint8_t> rela;
+        for (auto& r : textRelocs_)
+        {
+            put64(rela, r.offset);
+            put64(rela, (static_cast<uint64_t>(symIndex.at(r.symbol)) << 32) | r.type);
+            put64(rela, static_cast<uint64_t>(r.addend));
+        }
+
+        // 3. 节名表
+        const char*          names[SEC_COUNT] = {"", ".text", ".rela.text", ".data", ".bss", ".rodata", ".symtab",
+                     ".strtab", ".shstrtab"};
+        std::vector<uint8_t> shstrtab;
+        uint32_t             nameOff[SEC_COUNT];
+        for (int i = 0; i < SEC_COUNT; ++i)
+        {
+            nameOff[i] = static_cast<uint32_t>(shstrtab.size());
+            for (const char* p = names[i]; *p; ++p) shstrtab.push_back(static_cast<uint8_t>(*p));
+            shstrtab.push_back(0);
+        }
+
+        // 4. 依次放置各节内容，最后是节头表
+        struct Placed
+        {
+            uint64_t offset = 0, size = 0;
+        };
+        Placed               placed[SEC_COUNT];
+        std::vector<uint8_t> file(64, 0);
+        auto place = [&](int sec, const std::vector<uint8_t>& bytes, size_t align) {
+            alignTo(file, align);
+            placed[sec] = {file.size(), bytes.size()};
+            file.insert(file.end(), bytes.begin(), bytes.end());
+        };
+        place(SEC_TEXT, text_, 4);
+        place(SEC_DATA, data_, 8);
+        placed[SEC_BSS] = {file.size(), bssSize_};
+        place(SEC_RODATA, rodata_, 8);
+        place(SEC_RELA_TEXT, rela, 8);
+        place(SEC_SYMTAB, symtab, 8);
+        place(SEC_STRTAB, strtab, 1);
+        place(SEC_SHSTRTAB, shstrtab, 1);
+        alignTo(file, 8);
+        uint64_t shoff = file.size();
+
+        auto sectionHeader = [&](int sec, uint32_t type, uint64_t flags, uint32_t link, uint32_t info, uint64_t align,
+                                 uint64_t entsize) {
+            put32(file, nameOff[sec]);
+            put32(file, type);
+            put64(file, flags);
+            put64(file, 0);
+            put64(file, placed[sec].offset);
+            put64(file, placed[sec].size);
+            put32(file, link);
+            put32(file, info);
+            put64(file, align);
+            put64(file, entsize);
+        };
+        file.resize(file.size() + 64, 0);  // SEC_NULL
+        sectionHeader(SEC_TEXT, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0, 0, 4, 0);
+        sectionHeader(SEC_RELA_TEXT, SHT_RELA, SHF_INFO_LINK, SEC_SYMTAB, SEC_TEXT, 8, 24);
+        sectionHeader(SEC_DATA, SHT_PROGBITS, SHF_WRITE | SHF_ALLOC, 0, 0, 8, 0);
+        sectionHeader(SEC_BSS, SHT_NOBITS, SHF_WRITE | SHF_ALLOC, 0, 0, 8, 0);
+        sectionHeader(SEC_RODATA, SHT_PROGBITS, SHF_ALLOC, 0, 0, 4, 0);
+        sectionHeader(SEC_SYMTAB, SHT_SYMTAB, 0, SEC_STRTAB, static_cast<uint32_t>(1 + locals.size()), 8, 24);
+        sectionHeader(SEC_STRTAB, SHT_STRTAB, 0, 0, 0, 1, 0);
+        sectionHeader(SEC_SHSTRTAB, SHT_STRTAB, 0, 0, 0, 1, 0);
+
+        // 5. ELF 头
+        std::vector<uint8_t> ehdr = {0x7f, 'E', 'L', 'F', 2 /*ELFCLASS64*/, 1 /*ELFDATA2LSB*/, 1 /*EV_CURRENT*/, 0};
+        ehdr.resize(16, 0);
+        put16(ehdr, ET_REL);
+        put16(ehdr, EM_RISCV);
+        put32(ehdr, 1);
+        put64(ehdr, 0);      // e_entry
+        put64(ehdr, 0);      // e_phoff
+        put64(ehdr, shoff);  // e_shoff
+        put32(ehdr, EF_RISCV_FLOAT_ABI_DOUBLE);
+        put16(ehdr, 64);  // e_ehsize
+        put16(ehdr, 0);   // e_phentsize
+        put16(ehdr, 0);   // e_phnum
+        put16(ehdr, 64);  // e_shentsize
+        put16(ehdr, SEC_COUNT);
+        put16(ehdr, SEC_SHSTRTAB);
+        std::copy(ehdr.begin(), ehdr.end(), file.begin());
+
+        out_.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    }
+}  // namespace BE::RV64
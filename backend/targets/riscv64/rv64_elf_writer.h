@@ -0,0 +1,98 @@
+#ifndef __BACKEND_RV64_RV64_ELF_WRITER_H__
+#define __BACKEND_RV64_RV64_ELF_WRITER_H__
+
+#include <backend/mir/m_module.h>
+#include <backend/targets/riscv64/rv64_defs.h>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*
+ * RV64 可重定位 ELF 目标文件输出（-c）
+ *
+ * 与 CodeGen 打印汇编再交给外部汇编器不同，这里把寄存器分配与栈降低之后的 MIR 直接编码为机器码：
+ * - .text：按 RV64_INSTS 中的 R/I/S/B/U/J 格式编码，伪指令按 GNU as 的方式展开
+ *   （li → lui+addiw、la → auipc+addi、call → auipc+jalr、zext.w → slli+srli、fmv/fneg → fsgnj/fsgnjn）；
+ *   块间分支在函数内直接解析，超出 ±4KiB 的条件分支改写为“反向分支跳过 + jal”
+ * - .data / .bss / .rodata：有非零初值的全局变量、全零全局变量、函数常量池
+ * - .symtab：main 为全局符号，其余函数、全局变量与常量池标签与汇编输出一样为局部符号，
+ *   未在本模块定义的被引用符号（运行时库函数）为全局未定义符号
+ * - .rela.text：call 使用 R_RISCV_CALL_PLT，la 使用 R_RISCV_PCREL_HI20/LO12_I，
+ *   %hi/%lo 使用 R_RISCV_HI20/LO12_I/LO12_S
+ *
+ * 不生成压缩指令与链接器松弛所需的 R_RISCV_RELAX，产物可直接与现有运行时库链接。
+ */
+namespace BE::RV64
+{
+    class ELFWriter
+    {
+      public:
+        ELFWriter(BE::Module* module, std::ostream& output);
+
+        /// 编码整个模块并写出目标文件
+        void write();
+
+        // 逐函数编码（流式编译）：按顺序 addFunction，最后 finish 编码全局数据与常量池并写出文件
+        // addFunction 返回后不再访问该函数，调用者可以立即释放它
+        void addFunction(BE::Function* func);
+        void finish();
+
+      private:
+        struct Reloc
+        {
+            uint64_t    offset;
+            uint32_t    type;
+            std::string symbol;
+            int64_t     addend;
+        };
+
+        struct Symbol
+        {
+            std::string name;
+            uint8_t     bind;
+            uint8_t     type;
+            uint16_t    shndx;
+            uint64_t    value;
+            uint64_t    size;
+        };
+
+        BE::Module*   module_;
+        std::ostream& out_;
+
+        std::vector<uint8_t> text_;
+        std::vector<uint8_t> data_;
+        std::vector<uint8_t> rodata_;
+        uint64_t             bssSize_ = 0;
+        std::vector<Reloc>   textRelocs_;
+        std::vector<Symbol>  symbols_;  ///< 本模块定义的符号（未定义符号在写出时补充）
+        int                  pcrelCount_ = 0;
+
+        /// 已编码函数的常量池（函数名, 按位模式存放的常量），在 .rodata 中统一写出
+        std::vector<std::pair<std::string, std::vector<uint32_t>>> constPools_;
+
+        // 当前函数的布局：块 ID -> 相对 .text 起点的偏移，以及需要长跳转形式的条件分支
+        std::map<uint32_t, uint64_t> blockOffset_;
+        std::map<const Instr*, bool> longBranch_;
+        BE::Function*                curFunc_ = nullptr;
+
+        void encodeFunction(BE::Function* func);
+        void layoutFunction(BE::Function* func, uint64_t base);
+        uint32_t instSize(const Instr* inst) const;
+        void     encodeInst(const Instr* inst);
+        int      branchTarget(const Instr* inst) const;
+
+        void emitData();
+        void emitConstPools();
+
+        void emit32(uint32_t word);
+        void addReloc(uint32_t type, const std::string& symbol, int64_t addend = 0);
+        void addSymbol(const std::string& name, uint8_t bind, uint8_t type, uint16_t shndx, uint64_t value,
+            uint64_t size);
+
+        void writeFile();
+    };
+}  // namespace BE::RV64
+
+#endif  // __BACKEND_RV64_RV64_ELF_WRITER_H__
@@ -251,6 +251,19 @@ namespace BE::Targeting::RV64
     void InstrAdapter::enumPhysRegs(BE::MInstruction* inst, std::vector<BE::Register>& out) const
     {
         out.clear();
+        // 形参、调用返回值与函数返回值以 MoveInst 在参数寄存器与 vreg 之间搬运
+        if (inst->kind == BE::InstKind::MOVE)
+        {
+            auto* mv = dynamic_cast<BE::MoveInst*>(inst);
+            if (!mv) return;
+            for (auto* op : {mv->src, mv->dest})
+            {
+                auto* regOp = dynamic_cast<BE::RegOperand*>(op);
+                if (regOp && !regOp->reg.isVreg && regOp->reg.rId != 0) out.push_back(regOp->reg);
+            }
+            return;
+        }
+
         auto* ri = dynamic_cast<Instr*>(inst);
         if (!ri) return;
 
@@ -22,7 +22,15 @@ namespace BE::Targeting::RV64
         inline static const std::vector<int> floatArgRegs_   = {42, 43, 44, 45, 46, 47, 48, 49};  // fa0-fa7
         inline static const std::vector<int> calleeSavedInt_ = {8, 9, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27};  // s0-s11
         inline static const std::vector<int> calleeSavedFP_  = {40, 41, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59};  // fs0-fs11
+        inline static const std::vector<int> callerSavedInt_ = {10, 11, 12, 13, 14, 15, 16, 17, 28, 29, 30, 31};  // a0-a7, t3-t6
+        inline static const std::vector<int> callerSavedFP_  = {
+            35, 36, 37, 38, 39, 42, 43, 44, 45, 46, 47, 48, 49, 60, 61, 62, 63
+        };  // ft3-ft7, fa0-fa7, ft8-ft11
         inline static const std::vector<int> reservedRegs_   = {0, 1, 2, 3, 4, 5, 6, 7, 32, 33, 34};  // x0, ra, sp, gp, tp, t0, t1, t2, ft0-2
+        inline static const std::vector<int> scratchInt_     = {6, 7};        // t1, t2（t0 留给栈降低的大偏移）
+        inline static const std::vector<int> scratchFP_      = {32, 33, 34};  // ft0-ft2
+        inline static const std::vector<int> compactInt_     = {8, 9, 10, 11, 12, 13, 14, 15};  // x8-x15，RVC 的 3 位寄存器字段
+        inline static const std::vector<int> compactFP_      = {40, 41, 42, 43, 44, 45, 46, 47};  // f8-f15
         inline static const std::vector<int> intRegs_ = {
             0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
             16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31
@@ -44,8 +52,14 @@ namespace BE::Targeting::RV64
 
         const std::vector<int>& calleeSavedIntRegs() const override { return calleeSavedInt_; }
         const std::vector<int>& calleeSavedFloatRegs() const override { return calleeSavedFP_; }
+        const std::vector<int>& callerSavedIntRegs() const override { return callerSavedInt_; }
+        const std::vector<int>& callerSavedFloatRegs() const override { return callerSavedFP_; }
 
         const std::vector<int>& reservedRegs() const override { return reservedRegs_; }
+        const std::vector<int>& scratchIntRegs() const override { return scratchInt_; }
+        const std::vector<int>& scratchFloatRegs() const override { return scratchFP_; }
+        const std::vector<int>& compactIntRegs() const override { return compactInt_; }
+        const std::vector<int>& compactFloatRegs() const override { return compactFP_; }
         const std::vector<int>& intRegs() const override { return intRegs_; }
         const std::vector<int>& floatRegs() const override { return floatRegs_; }
     };
@@ -2,30 +2,31 @@
 #include <backend/target/registry.h>
 
 #include <backend/targets/riscv64/isel/rv64_dag_isel.h>
+#include <backend/targets/riscv64/isel/rv64_ir_isel.h>
+#include <backend/targets/riscv64/isel/rv64_isel_utils.h>
 #include <backend/targets/riscv64/passes/lowering/frame_lowering.h>
 #include <backend/targets/riscv64/passes/lowering/stack_lowering.h>
 #include <backend/targets/riscv64/passes/lowering/phi_elimination.h>
+#include <backend/targets/riscv64/passes/optimize/const_materialize.h>
+#include <backend/targets/riscv64/passes/optimize/sext_elimination.h>
+#include <backend/targets/riscv64/passes/optimize/modulo_schedule.h>
 #include <backend/targets/riscv64/rv64_codegen.h>
+#include <backend/targets/riscv64/rv64_elf_writer.h>
 
 #include <backend/common/cfg_builder.h>
 #include <backend/ra/linear_scan.h>
+#include <backend/ra/block_local.h>
 #include <backend/targets/riscv64/rv64_reg_info.h>
 #include <backend/targets/riscv64/rv64_instr_adapter.h>
 #include <backend/dag/dag_builder.h>
 #include <backend/targets/riscv64/dag/rv64_dag_legalize.h>
 
 #include <debug.h>
+#include <utils/thread_pool.h>
 
 #include <map>
 #include <iostream>
 #include <vector>
-namespace BE
-{
-    namespace RA
-    {
-        void setTargetInstrAdapter(const BE::Targeting::TargetInstrAdapter* adapter);
-    }
-}  // namespace BE
 
 namespace BE::Targeting::RV64
 {
@@ -44,46 +45,152 @@ namespace BE::Targeting::RV64
 
     namespace
     {
-        static void runPreRAPasses(BE::Module& m, const BE::Targeting::TargetInstrAdapter* adapter)
+        // 以下各阶段只读写 func 本身（以及只读的 adapter/regInfo），需在 func 的 VRegScope 内调用
+        void runPreRAPasses(BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::TargetRegInfo* regInfo, int optLevel)
         {
-            // 对实现了 mem2reg 优化的同学，还需完成 Phi Elimination
-            BE::RV64::Passes::Lowering::PhiEliminationPass phiElim;
-            phiElim.runOnModule(m, adapter);
+            if (optLevel > 0)
+            {
+                // 常量 CSE / 外提，浮点常量按延迟表选择合成或常量池加载（需在 SSA 形式下运行）
+                BE::RV64::Passes::Optimize::ConstMaterializePass constMat;
+                constMat.runOnFunction(&func, adapter);
+
+                // 删除对已知符号/零扩展值的冗余扩展（zext.w / sext.w）
+                BE::RV64::Passes::Optimize::SExtEliminationPass sextElim;
+                sextElim.runOnFunction(&func, adapter);
 
+                // 最内层循环的模调度（软件流水），需在 PHI 消除前运行：内核中的跨阶段值以 PHI 链交给 RA
+                BE::RV64::Passes::Optimize::ModuloSchedulePass moduloSched;
+                moduloSched.runOnFunction(&func, adapter, regInfo);
+            }
 
+            // 对实现了 mem2reg 优化的同学，还需完成 Phi Elimination
+            BE::RV64::Passes::Lowering::PhiEliminationPass phiElim;
+            phiElim.runOnFunction(&func, adapter);
         }
-        static void runRAPipeline(BE::Module& m, const BE::Targeting::RV64::RegInfo& regInfo)
+        void runRAPipeline(BE::Function& func, const BE::Targeting::TargetInstrAdapter* adapter,
+            const BE::Targeting::RV64::RegInfo& regInfo, int optLevel)
         {
+            // -O0 只做块内分配，后端耗时与指令数线性相关
+            if (optLevel == 0)
+            {
+                BE::RA::BlockLocalRA local;
+                local.allocateFunction(func, adapter, regInfo);
+                return;
+            }
             BE::RA::LinearScanRA ls;
-            ls.allocate(m, regInfo);
+            ls.allocateFunction(func, adapter, regInfo);
         }
-        static void runPostRAPasses(BE::Module& m)
+        void runPostRAPasses(BE::Function& func)
         {
-
             BE::RV64::Passes::Lowering::FrameLoweringPass frameLowering;
-            frameLowering.runOnModule(m);
+            frameLowering.runOnFunction(&func);
             BE::RV64::Passes::Lowering::StackLoweringPass stackLowering;
-            stackLowering.runOnModule(m);   
+            stackLowering.lowerFunction(&func);
+        }
+
+        // 单个函数从指令选择到栈降低的完整流程，不同函数可以在多个线程上同时进行
+        BE::Function* buildMachineFunction(Target& target, ME::Module* ir, ME::Function* func, BE::Module* backend,
+            const BE::Targeting::TargetInstrAdapter* adapter, const BE::Targeting::RV64::RegInfo& regInfo)
+        {
+            // 指令选择：-O0 直接遍历 IR 一遍翻译，不构建 SelectionDAG
+            BE::Function* mfunc = nullptr;
+            if (target.optimize_level == 0)
+                mfunc = BE::RV64::IRIsel(ir, backend, &target).selectFunction(*func);
+            else
+                mfunc = BE::RV64::DAGIsel(ir, backend, &target).selectFunction(func);
+
+            VRegScope vregScope(mfunc);
+            runPreRAPasses(*mfunc, adapter, &regInfo, target.optimize_level);
+            runRAPipeline(*mfunc, adapter, regInfo, target.optimize_level);
+            runPostRAPasses(*mfunc);
+            return mfunc;
         }
     }  // namespace
 
-    void Target::runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out)
+    struct Target::StreamState
     {
-        static BE::Targeting::RV64::InstrAdapter s_adapter;
-        static BE::Targeting::RV64::RegInfo      s_regInfo;
-        BE::Targeting::setTargetInstrAdapter(&s_adapter);
+        const BE::Targeting::RV64::InstrAdapter adapter;
+        const BE::Targeting::RV64::RegInfo      regInfo;
+        ME::Module*                             ir      = nullptr;
+        BE::Module*                             backend = nullptr;
+        // 按 emit_object 二选一
+        std::unique_ptr<BE::RV64::CodeGen>   codegen;
+        std::unique_ptr<BE::RV64::ELFWriter> writer;
+    };
 
-        // 指令选择
-        BE::RV64::DAGIsel isel(ir, backend, this);
-        isel.run();
+    Target::Target()  = default;
+    Target::~Target() = default;
 
-        runPreRAPasses(*backend, &s_adapter);
-        
-        runRAPipeline(*backend, s_regInfo);
+    void Target::legalizeDAG(BE::DAG::SelectionDAG& dag) const { BE::RV64::DAGLegalizer().run(dag); }
 
-        runPostRAPasses(*backend);
+    void Target::runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out)
+    {
+        // 适配器与寄存器信息都是无状态的只读对象，各线程共享同一份
+        const BE::Targeting::RV64::InstrAdapter adapter;
+        const BE::Targeting::RV64::RegInfo      regInfo;
 
+        // 全局变量在进入并行区前导入；各函数按 IR 中的顺序占位，输出顺序与单线程一致
+        BE::RV64::importGlobalVariables(ir, backend);
+        backend->functions.assign(ir->functions.size(), nullptr);
+
+        // 指令选择到栈降低的各阶段都只涉及单个函数，逐函数在线程池上并行完成
+        ThreadPool pool(ThreadPool::resolveThreads(threads));
+        pool.parallelFor(ir->functions.size(), [&](size_t, size_t index) {
+            backend->functions[index] = buildMachineFunction(*this, ir, ir->functions[index], backend, &adapter, regInfo);
+        });
+
+        if (emit_object)
+        {
+            BE::RV64::ELFWriter writer(backend, *out);
+            writer.write();
+            return;
+        }
         BE::RV64::CodeGen codegen(backend, *out);
+        codegen.setStatsStream(stats_out);
         codegen.generateAssembly();
     }
+
+    void Target::beginStream(ME::Module* ir, BE::Module* backend, std::ostream* out)
+    {
+        stream_          = std::make_unique<StreamState>();
+        stream_->ir      = ir;
+        stream_->backend = backend;
+        BE::RV64::importGlobalVariables(ir, backend);
+
+        if (emit_object)
+            stream_->writer = std::make_unique<BE::RV64::ELFWriter>(backend, *out);
+        else
+        {
+            stream_->codegen = std::make_unique<BE::RV64::CodeGen>(backend, *out);
+            stream_->codegen->setStatsStream(stats_out);
+            stream_->codegen->beginAssembly();
+        }
+    }
+
+    BE::Function* Target::compileFunction(ME::Function* func)
+    {
+        ASSERT(stream_ && "compileFunction called outside of a stream");
+        return buildMachineFunction(*this, stream_->ir, func, stream_->backend, &stream_->adapter, stream_->regInfo);
+    }
+
+    void Target::emitFunction(BE::Function* func)
+    {
+        ASSERT(stream_ && "emitFunction called outside of a stream");
+        if (stream_->writer)
+            stream_->writer->addFunction(func);
+        else
+            stream_->codegen->emitFunction(func);
+        delete func;
+    }
+
+    void Target::endStream()
+    {
+        ASSERT(stream_ && "endStream called outside of a stream");
+        if (stream_->writer)
+            stream_->writer->finish();
+        else
+            stream_->codegen->endAssembly();
+        stream_.reset();
+    }
 }  // namespace BE::Targeting::RV64
@@ -2,6 +2,7 @@
 #define __BACKEND_TARGETS_RISCV64_RV64_TARGET_H__
 
 #include <backend/target/target.h>
+#include <memory>
 
 namespace BE
 {
@@ -17,8 +18,23 @@ namespace BE::Targeting::RV64
     class Target : public BackendTarget
     {
       public:
+        Target();
+        ~Target() override;
+
         const char* getName() const override { return "riscv64"; }
+        bool        supportsObjectEmission() const override { return true; }
         void        runPipeline(ME::Module* ir, BE::Module* backend, std::ostream* out) override;
+        void        legalizeDAG(DAG::SelectionDAG& dag) const override;
+
+        bool          supportsStreaming() const override { return true; }
+        void          beginStream(ME::Module* ir, BE::Module* backend, std::ostream* out) override;
+        BE::Function* compileFunction(ME::Function* func) override;
+        void          emitFunction(BE::Function* func) override;
+        void          endStream() override;
+
+      private:
+        struct StreamState;
+        std::unique_ptr<StreamState> stream_;  ///< beginStream 与 endStream 之间的状态
     };
 }  // namespace BE::Targeting::RV64
 
@@ -1,49 +1,57 @@
 #include <middleend/ir_defs.h>
 
-std::ostream& operator<<(std::ostream& os, ME::DataType dt)
+namespace ME
 {
-    switch (dt)
+    const char* getDataTypeName(DataType dt)
     {
+        switch (dt)
+        {
 #define X(name, str, val) \
-    case ME::DataType::name: return os << #str;
-        IR_DATATYPE
+    case DataType::name: return #str;
+            IR_DATATYPE
 #undef X
-        default: return os << "unknown";
+            default: return "unknown";
+        }
     }
-}
 
-std::ostream& operator<<(std::ostream& os, ME::Operator op)
-{
-    switch (op)
+    const char* getOperatorName(Operator op)
     {
+        switch (op)
+        {
 #define X(name, str, val) \
-    case ME::Operator::name: return os << #str;
-        IR_OPCODE
+    case Operator::name: return #str;
+            IR_OPCODE
 #undef X
-        default: return os << "unknown";
+            default: return "unknown";
+        }
     }
-}
 
-std::ostream& operator<<(std::ostream& os, ME::ICmpOp cop)
-{
-    switch (cop)
+    const char* getICmpName(ICmpOp cop)
     {
+        switch (cop)
+        {
 #define X(name, str, val) \
-    case ME::ICmpOp::name: return os << #str;
-        IR_ICMP
+    case ICmpOp::name: return #str;
+            IR_ICMP
 #undef X
-        default: return os << "unknown";
+            default: return "unknown";
+        }
     }
-}
 
-std::ostream& operator<<(std::ostream& os, ME::FCmpOp cop)
-{
-    switch (cop)
+    const char* getFCmpName(FCmpOp cop)
     {
+        switch (cop)
+        {
 #define X(name, str, val) \
-    case ME::FCmpOp::name: return os << #str;
-        IR_FCMP
+    case FCmpOp::name: return #str;
+            IR_FCMP
 #undef X
-        default: return os << "unknown";
+            default: return "unknown";
+        }
     }
-}
+}  // namespace ME
+
+std::ostream& operator<<(std::ostream& os, ME::DataType dt) { return os << ME::getDataTypeName(dt); }
+std::ostream& operator<<(std::ostream& os, ME::Operator op) { return os << ME::getOperatorName(op); }
+std::ostream& operator<<(std::ostream& os, ME::ICmpOp cop) { return os << ME::getICmpName(cop); }
+std::ostream& operator<<(std::ostream& os, ME::FCmpOp cop) { return os << ME::getFCmpName(cop); }
@@ -2,7 +2,7 @@
 #define __INTERFACES_MIDDLEEND_IR_DEFS_H__
 
 #include <iostream>
-#include <map>
+#include <utils/indexed_map.h>
 
 #define IR_DATATYPE  \
     X(UNK, unk, 0)   \
@@ -125,8 +125,14 @@ namespace ME
 #undef X
     };
 
-    using RegMap   = std::map<size_t, size_t>;  // 寄存器号 -> 重命名后寄存器号
-    using LabelMap = std::map<size_t, size_t>;  // 标签号 -> 重命名后标签号
+    using RegMap   = IndexedMap<size_t>;  // 寄存器号 -> 重命名后寄存器号
+    using LabelMap = IndexedMap<size_t>;  // 标签号 -> 重命名后标签号
+
+    // 各枚举在 LLVM IR 文本中的拼写（静态字符串，供打印直接使用）
+    const char* getDataTypeName(DataType dt);
+    const char* getOperatorName(Operator op);
+    const char* getICmpName(ICmpOp cop);
+    const char* getFCmpName(FCmpOp cop);
 }  // namespace ME
 
 std::ostream& operator<<(std::ostream& os, ME::DataType dt);
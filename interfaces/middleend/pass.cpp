@@ -4,8 +4,18 @@
 
 namespace ME
 {
-    void FunctionPass::runOnModule(Module& module)
+    Analysis::PreservedAnalyses FunctionPass::runOnModule(Module& module)
     {
-        for (auto* function : module.functions) runOnFunction(*function);
+        doInitialization(module);
+        auto preserved = Analysis::PreservedAnalyses::all();
+        for (auto* function : module.functions)
+        {
+            OperandScope scope(module.constants, function);
+            auto         pa = runOnFunction(*function);
+            Analysis::AM.invalidate(*function, pa);
+            preserved.intersect(pa);
+        }
+        doFinalization(module);
+        return preserved;
     }
 }  // namespace ME
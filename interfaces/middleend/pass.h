@@ -1,6 +1,8 @@
 #ifndef __INTERFACES_MIDDLEEND_PASS_H__
 #define __INTERFACES_MIDDLEEND_PASS_H__
 
+#include <middleend/pass/analysis/analysis_manager.h>
+
 namespace ME
 {
     class Module;
@@ -9,12 +11,18 @@ namespace ME
 
 namespace ME
 {
+    /*
+     * Pass 的返回值说明运行后仍然有效的分析（见 analysis_manager.h 中的 PreservedAnalyses）：
+     * - runOnFunction 的结果由调用方交给 AM.invalidate(function, pa)；
+     * - runOnModule 的结果由调用方交给 AM.invalidate(module, pa)，函数级分析已在 Pass 内部按函数失效。
+     * 未修改 IR 时返回 PreservedAnalyses::all()。
+     */
     class Pass
     {
       public:
-        virtual ~Pass()                                = default;
-        virtual void runOnModule(Module& module)       = 0;
-        virtual void runOnFunction(Function& function) = 0;
+        virtual ~Pass()                                                       = default;
+        virtual Analysis::PreservedAnalyses runOnModule(Module& module)       = 0;
+        virtual Analysis::PreservedAnalyses runOnFunction(Function& function) = 0;
     };
 
     class ModulePass : public Pass
@@ -22,17 +30,24 @@ namespace ME
        * 全局优化Pass的基类
        */
       public:
-        virtual void runOnModule(Module& module) override       = 0;
-        virtual void runOnFunction(Function& function) override = 0;
+        virtual Analysis::PreservedAnalyses runOnModule(Module& module) override       = 0;
+        virtual Analysis::PreservedAnalyses runOnFunction(Function& function) override = 0;
     };
 
     class FunctionPass : public Pass
     { /*
        * 过程内优化Pass的基类
+       * runOnFunction 只能读写传入的函数（以及线程安全的常量池与 Analysis::AM），
+       * 因此 PassManager 可以在多个线程上用各自的 Pass 实例同时处理不同的函数。
+       * 需要模块级信息时在 doInitialization 中取得，它在进入各函数之前于单线程中调用。
        */
       public:
-        virtual void runOnModule(Module& module) override;
-        virtual void runOnFunction(Function& function) override = 0;
+        // 逐个函数运行并按返回值失效该函数的分析，返回各函数保留集合的交集
+        virtual Analysis::PreservedAnalyses runOnModule(Module& module) override;
+        virtual Analysis::PreservedAnalyses runOnFunction(Function& function) override = 0;
+
+        virtual void doInitialization(Module& module) {}
+        virtual void doFinalization(Module& module) {}
     };
 }  // namespace ME
 
@@ -7,24 +7,19 @@
 #include <middleend/visitor/codegen/ast_codegen.h>
 #include <middleend/visitor/printer/module_printer.h>
 #include <middleend/module/ir_module.h>
-#include <middleend/pass/unify_return.h>
-#include <middleend/pass/dce.h>
-#include <middleend/pass/adce.h>
-#include <middleend/pass/mem2reg.h>
-#include <middleend/pass/inline.h>
-#include <middleend/pass/sccp.h>
-#include <middleend/pass/tco.h>
-#include <middleend/pass/licm.h>
-#include <middleend/pass/cse.h>
-#include <middleend/pass/simplify_cfg.h>
+#include <middleend/pass/pass_manager.h>
+#include <middleend/pass/analysis/analysis_manager.h>
 
 #include <backend/mir/m_module.h>
 #include <backend/target/registry.h>
 #include <backend/target/target.h>
 
+#include <utils/thread_pool.h>
+
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <cstdlib>
 
 /* 如果你简化了框架的实现, 或者解决了框架现存的问题
    或者是用现代C++特性对框架进行了重构, 并且有效地简化了代码或者提高了代码的复用性
@@ -55,6 +50,42 @@ string truncateString(const string& str, size_t width)
     return str;
 }
 
+/*
+ * 流式编译 (-fstreaming)：模块级 pass 结束后，逐函数运行中端后期管线与后端流水线并立即输出，
+ * 随后释放该函数的 IR 与 MIR，峰值内存约为全局数据加上同时在处理的函数。
+ * 每轮取线程数个函数并行编译，再按原顺序输出，输出与非流式编译一致。
+ */
+void streamFunctions(ME::Module& m, ME::PassManager& passManager, BE::Targeting::BackendTarget& tgt,
+    BE::Module& backendModule, ostream* out, size_t threads)
+{
+    ThreadPool pool(ThreadPool::resolveThreads(threads));
+    passManager.beginLate(m, pool.size());
+    tgt.beginStream(&m, &backendModule, out);
+
+    vector<BE::Function*> compiled(pool.size());
+    for (size_t begin = 0; begin < m.functions.size(); begin += pool.size())
+    {
+        size_t count = min(pool.size(), m.functions.size() - begin);
+        pool.parallelFor(count, [&](size_t worker, size_t index) {
+            ME::Function* f = m.functions[begin + index];
+            passManager.runLate(m, *f, worker);
+            compiled[index] = tgt.compileFunction(f);
+        });
+        for (size_t i = 0; i < count; ++i)
+        {
+            tgt.emitFunction(compiled[i]);
+            ME::Function*& f = m.functions[begin + i];
+            ME::Analysis::AM.invalidate(*f);
+            delete f;
+            f = nullptr;
+        }
+    }
+    m.functions.clear();
+
+    passManager.endLate(m);
+    tgt.endStream();
+}
+
 int main(int argc, char** argv)
 {
     // 这一段程序的作用是解析输入参数
@@ -63,6 +94,13 @@ int main(int argc, char** argv)
     string   step          = "-llvm";
     string   march         = "riscv64";
     int      optimizeLevel = 0;
+    bool     ebbISel       = false;  // 在扩展基本块上做指令选择
+    bool     analysisStats = false;  // 输出中端各分析的构建次数
+    bool     codegenStats  = false;  // 向标准错误输出后端代码生成统计（RVC 可压缩率）
+    bool     streaming     = false;  // 逐函数完成后端流水线并输出，见 streamFunctions
+    string   passPipeline  = "";     // -passes= 指定的中端管线，为空时按优化等级选择默认管线
+    bool     hasPipeline   = false;
+    size_t   threads       = 1;      // 中端函数级 pass 与后端逐函数流水线的并行线程数，0 表示使用全部硬件线程
     ostream* outStream     = &cout;  // 默认输出到标准输出
     ofstream outFile;                // 如果指定了输出文件，则将输出重定向到该文件
 
@@ -70,7 +108,7 @@ int main(int argc, char** argv)
     {
         string arg = argv[i];
 
-        if (arg == "-lexer" || arg == "-parser" || arg == "-llvm" || arg == "-S") { step = arg; }
+        if (arg == "-lexer" || arg == "-parser" || arg == "-llvm" || arg == "-S" || arg == "-c") { step = arg; }
         else if (arg == "-o")
         {
             if (i + 1 < argc)
@@ -95,6 +133,33 @@ int main(int argc, char** argv)
         else if (arg == "-O0") { optimizeLevel = 0; }
         else if (arg == "-O2") { optimizeLevel = 2; }
         else if (arg == "-O3") { optimizeLevel = 3; }
+        else if (arg == "-fisel-ebb") { ebbISel = true; }
+        else if (arg == "-fanalysis-stats") { analysisStats = true; }
+        else if (arg == "-fcodegen-stats") { codegenStats = true; }
+        else if (arg == "-fstreaming") { streaming = true; }
+        else if (arg.rfind("-j", 0) == 0 && arg.find_first_not_of("0123456789", 2) == string::npos)
+        {
+            // -j N 或 -jN
+            string num = arg.size() > 2 ? arg.substr(2) : (i + 1 < argc ? argv[++i] : "");
+            if (num.empty() || num.find_first_not_of("0123456789") != string::npos)
+            {
+                cerr << "Error: -j option requires a thread count" << endl;
+                return 1;
+            }
+            // 位数过多时 strtoull 返回 ULLONG_MAX，同样按超出上限处理
+            unsigned long long n = strtoull(num.c_str(), nullptr, 10);
+            if (n > ThreadPool::kMaxThreads)
+            {
+                cerr << "Error: -j thread count must be at most " << ThreadPool::kMaxThreads << endl;
+                return 1;
+            }
+            threads = static_cast<size_t>(n);
+        }
+        else if (arg.rfind("-passes=", 0) == 0)
+        {
+            passPipeline = arg.substr(8);
+            hasPipeline  = true;
+        }
         else if (arg[0] != '-') { inputFile = arg; }  // 如果不是选项，则视为输入文件
         else
         {
@@ -106,13 +171,14 @@ int main(int argc, char** argv)
     if (inputFile.empty())
     {
         cerr << "Error: No input file specified" << endl;
-        cerr << "Usage: " << argv[0] << " [-lexer|-parser|-llvm|-S] [-o output_file] input_file [-O]" << endl;
+        cerr << "Usage: " << argv[0] << " [-lexer|-parser|-llvm|-S|-c] [-o output_file] input_file [-O] [-passes=...] [-j N] [-fisel-ebb] [-fanalysis-stats] [-fcodegen-stats] [-fstreaming]" << endl;
         return 1;
     }
 
     if (!outputFile.empty())  // 如果指定了输出文件，则重定向输出流
     {
-        outFile.open(outputFile);
+        // -c 输出二进制目标文件
+        outFile.open(outputFile, step == "-c" ? ios::out | ios::binary : ios::out);
         if (!outFile)
         {
             cerr << "Cannot open output file " << outputFile << endl;
@@ -320,8 +386,34 @@ int main(int argc, char** argv)
         ME::Module     m;
 
         apply(codegen, *ast, &m);
+        // 此后只使用 IR，尽早释放 AST
+        delete ast;
+        ast = nullptr;
+
+        /*
+         * 中端管线：-passes= 显式给出时使用之，否则使用当前优化等级的默认管线（-O0 为空）。
+         * 管线语法与可用的 pass 名见 middleend/pass/pass_manager.h。
+         */
+        ME::PassManager passManager;
+        passManager.setThreads(threads);
+        {
+            string err;
+            if (!passManager.parse(hasPipeline ? passPipeline : ME::PassManager::getPreset(optimizeLevel), err))
+            {
+                cerr << "Error: invalid -passes pipeline: " << err << endl;
+                cerr << "Available passes:";
+                for (auto& name : ME::PassManager::passNames()) cerr << " " << name;
+                cerr << endl;
+                ret = 1;
+                goto cleanup_ast;
+            }
+        }
+
+        // 流式编译只对 -S/-c 生效：管线末尾的函数级部分留到逐函数编译时运行
+        streaming = streaming && (step == "-S" || step == "-c");
+        if (streaming) passManager.splitLatePasses();
 
-        if (optimizeLevel > 0)
+        if (!passManager.empty())
         {
             /*
              * Lab 4: 中间代码优化
@@ -335,48 +427,22 @@ int main(int argc, char** argv)
              * - 激进死代码消除（基于控制依赖图，需删除死循环）
              * - 难度不低于上述 pass 的其它优化
              */
-            // 下面这个 pass 可以作为参考，主要是示范如何通过cache获取分析pass的结果
-            ME::TCOPass tcoPass;
-            tcoPass.runOnModule(m);
-
-            ME::UnifyReturnPass unifyReturnPass;
-            unifyReturnPass.runOnModule(m);
-
-            ME::Mem2RegPass mem2RegPass;
-            mem2RegPass.runOnModule(m);
-
-            ME::InlinePass inlinePass;
-            inlinePass.runOnModule(m);
+            passManager.run(m);
 
-            ME::SCCPPass sccpPass;
-            sccpPass.runOnModule(m);
-
-            ME::DCEPass dcePass;
-            dcePass.runOnModule(m);
-
-            ME::LICMPass licmPass;
-            licmPass.runOnModule(m);
-
-            ME::ADCEPass adcePass;
-            adcePass.runOnModule(m);
-
-            ME::CSEPass csePass;
-            csePass.runOnModule(m);
-
-            ME::SimplifyCFGPass simplifyCFGPass;
-            simplifyCFGPass.runOnModule(m);
+            if (analysisStats && !streaming) ME::Analysis::AM.printStats(cerr);
         }
 
         if (step == "-llvm")
         {
             // 这一部分的打印有完整实现提供，如果你未对 IR 结构有改动，可以直接使用
             ME::IRPrinter printer;
-            printer.visit(m, *outStream);
+            OutBuffer     irOut(*outStream);
+            printer.visit(m, irOut);
             ret = 0;
             goto cleanup_ast;
         }
 
-        if (step != "-S")
+        if (step != "-S" && step != "-c")
         {
             cerr << "Unknown step: " << step << endl;
             ret = 1;
@@ -431,7 +497,32 @@ int main(int argc, char** argv)
             goto cleanup_ast;
         }
 
-        tgt->runPipeline(&m, &backendModule, outStream);
+        if (step == "-c" && !tgt->supportsObjectEmission())
+        {
+            cerr << "Target " << tgt->getName() << " does not support -c, use -S instead" << endl;
+            ret = 1;
+            goto cleanup_ast;
+        }
+
+        if (streaming && !tgt->supportsStreaming())
+        {
+            cerr << "Target " << tgt->getName() << " does not support -fstreaming" << endl;
+            ret = 1;
+            goto cleanup_ast;
+        }
+
+        tgt->extended_block_isel = ebbISel;
+        tgt->optimize_level      = optimizeLevel;
+        tgt->emit_object         = step == "-c";
+        tgt->threads             = threads;
+        tgt->stats_out           = codegenStats ? &cerr : nullptr;
+        if (streaming)
+        {
+            streamFunctions(m, passManager, *tgt, backendModule, outStream, threads);
+            if (analysisStats) ME::Analysis::AM.printStats(cerr);
+        }
+        else
+            tgt->runPipeline(&m, &backendModule, outStream);
 
         ret = 0;
     }
@@ -0,0 +1,61 @@
+#ifndef __MIDDLEEND_MODULE_IR_ARENA_H__
+#define __MIDDLEEND_MODULE_IR_ARENA_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/*
+ * 函数级指令内存池
+ * - 每个 Function 持有一个 InstArena，函数内新建的指令从当前线程所在函数的池中顺序切分，
+ *   分配只是移动指针，同一函数的指令在内存中紧密相邻，遍历时缓存友好；
+ * - delete 指令只运行析构函数，不归还内存，整块内存随 Function 一同释放；
+ * - 当前池由 OperandScope 设置（见 ir_operand.h），每个线程各自独立。
+ */
+
+namespace ME
+{
+    class InstArena
+    {
+        static constexpr size_t chunkSize = 16 * 1024;
+        static constexpr size_t align     = alignof(std::max_align_t);
+
+        std::vector<char*> chunks;
+        char*              cur = nullptr;
+        char*              end = nullptr;
+
+      public:
+        InstArena() = default;
+        ~InstArena()
+        {
+            for (char* c : chunks) ::operator delete(c);
+        }
+        InstArena(const InstArena&)            = delete;
+        InstArena& operator=(const InstArena&) = delete;
+
+        void* allocate(size_t size)
+        {
+            size = (size + align - 1) & ~(align - 1);
+            if (static_cast<size_t>(end - cur) < size)
+            {
+                size_t n = std::max(size, chunkSize);
+                chunks.push_back(static_cast<char*>(::operator new(n)));
+                cur = chunks.back();
+                end = cur + n;
+            }
+            void* p = cur;
+            cur += size;
+            return p;
+        }
+
+        // 当前线程正在处理的函数的指令池，未处于函数作用域时为 nullptr
+        static InstArena*& current()
+        {
+            static thread_local InstArena* arena = nullptr;
+            return arena;
+        }
+    };
+}  // namespace ME
+
+#endif  // __MIDDLEEND_MODULE_IR_ARENA_H__
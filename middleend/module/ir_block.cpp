@@ -4,12 +4,13 @@ namespace ME
 {
     Block::~Block()
     {
-        for (auto inst : insts)
+        // 先摘除再释放，避免迭代器访问已释放指令的后继指针
+        while (!insts.empty())
         {
+            Instruction* inst = insts.front();
+            insts.pop_front();
             delete inst;
-            inst = nullptr;
         }
-        insts.clear();
     }
 
     void Block::insertFront(Instruction* inst) { insts.push_front(inst); }
@@ -1,8 +1,7 @@
 #ifndef __MIDDLEEND_MODULE_IR_BLOCK_H__
 #define __MIDDLEEND_MODULE_IR_BLOCK_H__
 
-#include <middleend/module/ir_instruction.h>
-#include <deque>
+#include <middleend/module/ir_inst_list.h>
 
 #define ENABLE_IRBLOCK_COMMENT
 
@@ -11,8 +10,8 @@ namespace ME
     class Block : public Visitable
     {
       public:
-        std::deque<Instruction*> insts;    // 指令列表
-        size_t                   blockId;  // 基本块编号
+        InstList insts;    // 指令列表（侵入式双向链表）
+        size_t   blockId;  // 基本块编号
 
       public:
 #ifndef ENABLE_IRBLOCK_COMMENT
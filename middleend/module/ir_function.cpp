@@ -22,8 +22,8 @@ namespace ME
     Block* Function::createBlock()
     {
         // 创建基本块，分配新的 label 编号
-        Block* newBlock  = new Block(maxLabel);
-        blocks[maxLabel] = newBlock;
+        Block* newBlock = new Block(maxLabel);
+        blocks.insert(maxLabel, newBlock);
 
         maxLabel++;
         return newBlock;
@@ -31,8 +31,7 @@ namespace ME
     Block* Function::getBlock(size_t label)
     {
         // 根据 label 获取基本块
-        if (blocks.find(label) != blocks.end()) return blocks[label];
-        return nullptr;
+        return blocks.get(label);
     }
     // 设置和获取当前函数的最大寄存器编号和最大基本块编号
     void   Function::setMaxReg(size_t reg) { maxReg = reg; }
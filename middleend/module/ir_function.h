@@ -2,16 +2,121 @@
 #define __MIDDLEEND_MODULE_IR_FUNCTION_H__
 
 #include <middleend/module/ir_block.h>
-#include <map>
+#include <deque>
+#include <iterator>
+#include <utility>
 
 namespace ME
 {
+    /*
+     * 函数的基本块表：以 label 为下标的稠密数组
+     * - find/getBlock/insert/erase 均为 O(1)；label 由 createBlock 连续分配，数组不会稀疏太多；
+     * - 遍历时跳过空槽，按 label 升序给出 (label, Block*)，与原先 std::map 的遍历顺序和用法一致，
+     *   因此打印与各 Pass 的遍历顺序保持不变；
+     * - 底层用 deque 追加，遍历中 createBlock 不会使已取得的元素引用失效，end() 为哨兵，新块同样会被遍历到。
+     */
+    class BlockMap
+    {
+      public:
+        using value_type = std::pair<const size_t, Block*>;
+
+        class iterator
+        {
+            friend class BlockMap;
+
+          public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = value_type*;
+            using reference         = value_type&;
+
+          private:
+            std::deque<value_type>* slots = nullptr;
+            size_t                  idx   = 0;  // 越过末尾的任意下标都视为 end()
+
+            iterator(std::deque<value_type>* s, size_t i) : slots(s), idx(i) { skip(); }
+            void skip()
+            {
+                while (idx < slots->size() && !(*slots)[idx].second) ++idx;
+            }
+            bool atEnd() const { return idx >= slots->size(); }
+
+          public:
+            iterator() = default;
+
+            reference operator*() const { return (*slots)[idx]; }
+            pointer   operator->() const { return &(*slots)[idx]; }
+            iterator& operator++()
+            {
+                ++idx;
+                skip();
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            iterator& operator--()
+            {
+                if (idx > slots->size()) idx = slots->size();
+                do --idx;
+                while (!(*slots)[idx].second);
+                return *this;
+            }
+            bool operator==(const iterator& o) const { return idx == o.idx || (atEnd() && o.atEnd()); }
+            bool operator!=(const iterator& o) const { return !(*this == o); }
+        };
+
+      private:
+        std::deque<value_type> slots;
+        size_t                 cnt = 0;
+
+      public:
+        iterator begin() { return iterator(&slots, 0); }
+        iterator end() { return iterator(&slots, static_cast<size_t>(-1)); }
+
+        bool   empty() const { return cnt == 0; }
+        size_t size() const { return cnt; }
+        size_t count(size_t label) const { return label < slots.size() && slots[label].second ? 1 : 0; }
+
+        Block* get(size_t label) const { return label < slots.size() ? slots[label].second : nullptr; }
+        iterator find(size_t label) { return count(label) ? iterator(&slots, label) : end(); }
+
+        // 登记（或替换）label 对应的基本块
+        void insert(size_t label, Block* block)
+        {
+            while (slots.size() <= label) slots.emplace_back(slots.size(), nullptr);
+            if (!slots[label].second && block) ++cnt;
+            if (slots[label].second && !block) --cnt;
+            slots[label].second = block;
+        }
+        // 移除基本块（不释放），返回下一个有效位置
+        iterator erase(iterator it)
+        {
+            insert(it.idx, nullptr);
+            return iterator(&slots, it.idx + 1);
+        }
+        void erase(size_t label)
+        {
+            if (count(label)) insert(label, nullptr);
+        }
+        void clear()
+        {
+            slots.clear();
+            cnt = 0;
+        }
+    };
+
     // 函数类，包含函数定义指令和基本块列表
     class Function : public Visitable
     {
       public:
-        FuncDefInst*             funcDef;  // 函数定义指令
-        std::map<size_t, Block*> blocks;   // 函数基本块列表，基本块编号->基本块指针 映射
+        FuncDefInst* funcDef;  // 函数定义指令
+        BlockMap     blocks;   // 函数基本块列表，基本块编号->基本块指针 映射
+        OperandPool  operands;   // 本函数的寄存器/标签操作数表，随函数一同释放
+        InstArena    instArena;  // 本函数指令的内存池，随函数一同释放
 
       private:
         size_t maxLabel;  // 当前函数中最大的基本块编号
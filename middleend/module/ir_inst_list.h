@@ -0,0 +1,211 @@
+#ifndef __MIDDLEEND_MODULE_IR_INST_LIST_H__
+#define __MIDDLEEND_MODULE_IR_INST_LIST_H__
+
+#include <middleend/module/ir_instruction.h>
+#include <cstddef>
+#include <iterator>
+
+/*
+ * 基本块的侵入式指令链表
+ * - 前驱/后继指针直接存放在 Instruction 中，一条指令同一时刻只能位于一个链表里；
+ * - 插入、删除、按指令摘除（remove）均为 O(1)，迭代器在其他位置增删时保持有效；
+ * - splice 把另一链表中的一段接到本链表，不复制指令。
+ * 链表只负责链接关系，不拥有指令：erase/remove/clear 都不会 delete 指令。
+ */
+
+namespace ME
+{
+    class InstList
+    {
+      public:
+        class iterator
+        {
+            friend class InstList;
+
+          public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = Instruction*;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = Instruction* const*;
+            using reference         = Instruction*;
+
+          private:
+            Instruction*    cur  = nullptr;
+            const InstList* list = nullptr;
+
+            iterator(Instruction* c, const InstList* l) : cur(c), list(l) {}
+
+          public:
+            iterator() = default;
+
+            Instruction* operator*() const { return cur; }
+            iterator&    operator++()
+            {
+                cur = cur->nextInst;
+                return *this;
+            }
+            iterator operator++(int)
+            {
+                iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+            // end() 回退得到尾指令
+            iterator& operator--()
+            {
+                cur = cur ? cur->prevInst : list->tail;
+                return *this;
+            }
+            iterator operator--(int)
+            {
+                iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+            bool operator==(const iterator& o) const { return cur == o.cur; }
+            bool operator!=(const iterator& o) const { return cur != o.cur; }
+        };
+        using const_iterator         = iterator;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = reverse_iterator;
+
+      private:
+        Instruction* head = nullptr;
+        Instruction* tail = nullptr;
+        size_t       cnt  = 0;
+
+      public:
+        InstList() = default;
+        InstList(const InstList&)            = delete;
+        InstList& operator=(const InstList&) = delete;
+
+        iterator         begin() const { return iterator(head, this); }
+        iterator         end() const { return iterator(nullptr, this); }
+        reverse_iterator rbegin() const { return reverse_iterator(end()); }
+        reverse_iterator rend() const { return reverse_iterator(begin()); }
+        iterator         iteratorOf(Instruction* inst) const { return iterator(inst, this); }
+
+        bool         empty() const { return cnt == 0; }
+        size_t       size() const { return cnt; }
+        Instruction* front() const { return head; }
+        Instruction* back() const { return tail; }
+
+        // 在 pos 之前插入 inst，返回指向 inst 的迭代器
+        iterator insert(iterator pos, Instruction* inst)
+        {
+            Instruction* next = pos.cur;
+            Instruction* prev = next ? next->prevInst : tail;
+            inst->prevInst    = prev;
+            inst->nextInst    = next;
+            if (prev)
+                prev->nextInst = inst;
+            else
+                head = inst;
+            if (next)
+                next->prevInst = inst;
+            else
+                tail = inst;
+            ++cnt;
+            return iterator(inst, this);
+        }
+        template <typename It>
+        void insert(iterator pos, It first, It last)
+        {
+            for (; first != last; ++first) insert(pos, *first);
+        }
+        void push_back(Instruction* inst) { insert(end(), inst); }
+        void push_front(Instruction* inst) { insert(begin(), inst); }
+
+        // 摘除 pos 指向的指令，返回其后继位置
+        iterator erase(iterator pos)
+        {
+            Instruction* next = pos.cur->nextInst;
+            remove(pos.cur);
+            return iterator(next, this);
+        }
+        void remove(Instruction* inst)
+        {
+            if (inst->prevInst)
+                inst->prevInst->nextInst = inst->nextInst;
+            else
+                head = inst->nextInst;
+            if (inst->nextInst)
+                inst->nextInst->prevInst = inst->prevInst;
+            else
+                tail = inst->prevInst;
+            inst->prevInst = inst->nextInst = nullptr;
+            --cnt;
+        }
+        void pop_back() { remove(tail); }
+        void pop_front() { remove(head); }
+
+        // 用 newInst 原地替换 oldInst（oldInst 被摘除但不释放）
+        void replace(Instruction* oldInst, Instruction* newInst)
+        {
+            insert(iterator(oldInst, this), newInst);
+            remove(oldInst);
+        }
+
+        // 把 other 中 [first, last) 的指令整段移动到本链表 pos 之前：重新链接为 O(1)，仅计数与区间长度成正比
+        void splice(iterator pos, InstList& other, iterator first, iterator last)
+        {
+            if (first == last) return;
+            size_t n = 0;
+            for (iterator it = first; it != last; ++it) ++n;
+            spliceRange(pos, other, first.cur, last.cur, n);
+        }
+        void splice(iterator pos, InstList& other)
+        {
+            if (other.empty()) return;
+            spliceRange(pos, other, other.head, nullptr, other.cnt);
+        }
+
+        // 仅断开链接，不释放指令
+        void clear()
+        {
+            for (Instruction* inst = head; inst;)
+            {
+                Instruction* next = inst->nextInst;
+                inst->prevInst = inst->nextInst = nullptr;
+                inst                            = next;
+            }
+            head = tail = nullptr;
+            cnt         = 0;
+        }
+
+      private:
+        // [first, last) 为 other 中非空的一段，共 n 条指令；last 为 nullptr 表示直到表尾
+        void spliceRange(iterator pos, InstList& other, Instruction* first, Instruction* last, size_t n)
+        {
+            Instruction* segLast = last ? last->prevInst : other.tail;
+
+            // 从 other 中断开
+            if (first->prevInst)
+                first->prevInst->nextInst = last;
+            else
+                other.head = last;
+            if (last)
+                last->prevInst = first->prevInst;
+            else
+                other.tail = first->prevInst;
+            other.cnt -= n;
+
+            // 接到 pos 之前
+            Instruction* next = pos.cur;
+            Instruction* prev = next ? next->prevInst : tail;
+            first->prevInst   = prev;
+            segLast->nextInst = next;
+            if (prev)
+                prev->nextInst = first;
+            else
+                head = first;
+            if (next)
+                next->prevInst = segLast;
+            else
+                tail = segLast;
+            cnt += n;
+        }
+    };
+}  // namespace ME
+
+#endif  // __MIDDLEEND_MODULE_IR_INST_LIST_H__
@@ -2,9 +2,61 @@
 #include <debug.h>
 #include <numeric>
 #include <sstream>
+#ifdef ENABLE_IRINST_COMMENT
+#include <mutex>
+#include <unordered_map>
+#endif
 
 namespace ME
 {
+    void* Instruction::operator new(size_t size)
+    {
+        InstArena* arena = InstArena::current();
+        ASSERT(arena && "Instruction created outside of a function OperandScope");
+        return arena->allocate(size);
+    }
+
+#ifndef ENABLE_IRINST_COMMENT
+    Instruction::~Instruction() = default;
+#else
+    namespace
+    {
+        // 指令注释旁路表：只有设置过注释的指令才占用表项
+        std::mutex                                          commentMtx;
+        std::unordered_map<const Instruction*, std::string> comments;
+    }  // namespace
+
+    Instruction::~Instruction()
+    {
+        std::lock_guard<std::mutex> lock(commentMtx);
+        comments.erase(this);
+    }
+
+    void Instruction::setComment(const std::string& c)
+    {
+        std::lock_guard<std::mutex> lock(commentMtx);
+        if (c.empty())
+            comments.erase(this);
+        else
+            comments[this] = c;
+    }
+
+    const std::string& Instruction::getCommentText() const
+    {
+        static const std::string    empty;
+        std::lock_guard<std::mutex> lock(commentMtx);
+        auto                        it = comments.find(this);
+        return it == comments.end() ? empty : it->second;
+    }
+
+    std::string Instruction::getComment() const
+    {
+        const std::string& c = getCommentText();
+        if (c.empty()) return "";
+        return " ; " + c;
+    }
+#endif
+
     // LoadInst: 从内存加载值到寄存器
     // LLVM IR 格式: %reg = load i32, ptr %ptr
     std::string LoadInst::toString() const
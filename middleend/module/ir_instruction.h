@@ -4,48 +4,72 @@
 #include <middleend/ir_defs.h>
 #include <middleend/ir_visitor.h>
 #include <middleend/module/ir_operand.h>
+#include <middleend/module/ir_arena.h>
 #include <frontend/ast/ast_defs.h>
 #include <string>
 #include <vector>
 #include <utility>
 
-#define ENABLE_IRINST_COMMENT
+// 定义 ENABLE_IRINST_COMMENT 后，指令注释会记录在旁路表中并随 IR 一同打印
+// #define ENABLE_IRINST_COMMENT
 
 namespace ME
 { /*
    * 本文件定义了LLVM IR的指令类，在完成Lab3-2中间代码生成时，你的一个工作重点就是
    * 根据AST构建这些指令实例。
    * 你可以根据需要自行添加成员变量和函数，辅助你完成实验。
+   *
+   * 指令对象只保留操作码、链表指针与各自的操作数，注释不占用指令空间；
+   * 指令通过 operator new 从当前函数的 InstArena 中分配（见 ir_arena.h）。
    */
-    class Instruction : public Visitable, public InsVisitable
+    class Instruction : public Visitable
     {
       public:
         Operator opcode;
 
+        // 所在基本块指令链表中的前驱/后继，由 InstList 维护
+        Instruction* prevInst = nullptr;
+        Instruction* nextInst = nullptr;
+
       public:
+        Instruction(Operator op, const std::string& c = "") : opcode(op)
+        {
+            if (!c.empty()) setComment(c);
+        }
 #ifndef ENABLE_IRINST_COMMENT
-        Instruction(Operator op, const std::string& c = "") : opcode(op) {}
-        void        setComment(const std::string& c) {}
-        std::string getComment() const
+        void               setComment(const std::string& c) {}
+        std::string        getComment() const { return ""; }
+        const std::string& getCommentText() const
         {
-            if (comment.empty()) return "";
-            return " ; " + comment;
+            static const std::string empty;
+            return empty;
         }
 #else
-        std::string comment;
-        Instruction(Operator op, const std::string& c = "") : opcode(op), comment(c) {}
-        void        setComment(const std::string& c) { comment = c; }
-        std::string getComment() const { return ""; }
+        void               setComment(const std::string& c);
+        std::string        getComment() const;
+        const std::string& getCommentText() const;  // 原始注释文本，无注释时为空串
 #endif
-        virtual ~Instruction() = default;
+        virtual ~Instruction();
+
+        // 从当前函数的指令池中分配；delete 只析构，内存随函数释放
+        static void* operator new(size_t size);
+        static void  operator delete(void* p) {}
 
       public:
-        virtual std::string toString() const                     = 0;
-        virtual void        accept(Visitor& visitor) override    = 0;
-        virtual void        accept(InsVisitor& visitor) override = 0;
+        virtual std::string toString() const                  = 0;
+        virtual void        accept(Visitor& visitor) override = 0;
+        virtual void        accept(InsVisitor& visitor)       = 0;
 
         // 是否为终止指令
-        virtual bool isTerminator() const = 0;
+        bool isTerminator() const
+        {
+            return opcode == Operator::BR_COND || opcode == Operator::BR_UNCOND || opcode == Operator::RET;
+        }
+
+        // 指令定义的结果操作数，无定义时返回 nullptr
+        virtual Operand* getDefOperand() const { return nullptr; }
+        // 按操作数顺序收集指令中各个使用位置的地址，def-use 链通过它原地改写操作数
+        virtual void     getUseSlots(std::vector<Operand**>& slots) {}
     };
 
     class LoadInst : public Instruction
@@ -66,7 +90,8 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override { slots.push_back(&ptr); }
     };
 
     class StoreInst : public Instruction
@@ -87,7 +112,11 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual void getUseSlots(std::vector<Operand**>& slots) override
+        {
+            slots.push_back(&ptr);
+            slots.push_back(&val);
+        }
     };
 
     // 算术指令，包括加减乘除等
@@ -110,7 +139,12 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override
+        {
+            slots.push_back(&lhs);
+            slots.push_back(&rhs);
+        }
     };
 
     // 整型比较指令
@@ -134,7 +168,12 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override
+        {
+            slots.push_back(&lhs);
+            slots.push_back(&rhs);
+        }
     };
 
     // 浮点比较指令
@@ -158,7 +197,12 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override
+        {
+            slots.push_back(&lhs);
+            slots.push_back(&rhs);
+        }
     };
 
     // 分配指令
@@ -180,7 +224,7 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
     };
 
     // 条件分支指令
@@ -202,7 +246,7 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return true; }
+        virtual void getUseSlots(std::vector<Operand**>& slots) override { slots.push_back(&cond); }
     };
 
     class BrUncondInst : public Instruction
@@ -218,8 +262,6 @@ namespace ME
         virtual std::string toString() const override;
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
-
-        virtual bool isTerminator() const override { return true; }
     };
 
     // 全局变量声明指令
@@ -240,12 +282,14 @@ namespace ME
         {}
         ~GlbVarDeclInst() override = default;
 
+        // 模块级指令，不属于任何函数的指令池
+        static void* operator new(size_t size) { return ::operator new(size); }
+        static void  operator delete(void* p) { ::operator delete(p); }
+
       public:
         virtual std::string toString() const override;
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
-
-        virtual bool isTerminator() const override { return false; }
     };
 
     // 函数调用指令
@@ -278,7 +322,11 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override
+        {
+            for (auto& arg : args) slots.push_back(&arg.second);
+        }
     };
 
     // 返回指令
@@ -299,7 +347,7 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return true; }
+        virtual void getUseSlots(std::vector<Operand**>& slots) override { slots.push_back(&res); }
     };
 
     // 函数声明指令
@@ -318,12 +366,14 @@ namespace ME
         {}
         ~FuncDeclInst() override = default;
 
+        // 模块级指令，不属于任何函数的指令池
+        static void* operator new(size_t size) { return ::operator new(size); }
+        static void  operator delete(void* p) { ::operator delete(p); }
+
       public:
         virtual std::string toString() const override;
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
-
-        virtual bool isTerminator() const override { return false; }
     };
 
     // 函数定义指令
@@ -345,12 +395,14 @@ namespace ME
         {}
         ~FuncDefInst() override = default;
 
+        // 由 Function 持有，在函数体之外创建，使用普通堆内存
+        static void* operator new(size_t size) { return ::operator new(size); }
+        static void  operator delete(void* p) { ::operator delete(p); }
+
       public:
         virtual std::string toString() const override;
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
-
-        virtual bool isTerminator() const override { return false; }
     };
 
     // GetElementPtr指令 计算地址偏移
@@ -380,7 +432,12 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override
+        {
+            slots.push_back(&basePtr);
+            for (auto& idx : idxs) slots.push_back(&idx);
+        }
     };
 
     // 类型转换指令 i2fp
@@ -399,7 +456,8 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return dest; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override { slots.push_back(&src); }
     };
 
     // 类型转换指令 fp2i
@@ -418,7 +476,8 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return dest; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override { slots.push_back(&src); }
     };
 
     // 类型转换指令 zero extension（高位补0）
@@ -441,7 +500,8 @@ namespace ME
         virtual void        accept(Visitor& visitor) override { visitor.visit(*this); }
         virtual void        accept(InsVisitor& visitor) override { visitor.visit(*this); }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return dest; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override { slots.push_back(&src); }
     };
 
     // Phi指令 ：if/while 等控制流汇合后用 φ 指令决定变量来自哪条路径
@@ -453,7 +513,13 @@ namespace ME
 
         using ValOp   = Operand*;
         using LabelOp = Operand*;
-        std::map<LabelOp, ValOp> incomingVals;  // label -> value
+        // 按标签编号排序，incoming 的遍历与打印顺序只取决于 IR 本身，与操作数对象的分配地址无关
+        struct LabelOrder
+        {
+            bool operator()(const Operand* a, const Operand* b) const { return a->getLabelNum() < b->getLabelNum(); }
+        };
+        using IncomingMap = std::map<LabelOp, ValOp, LabelOrder>;
+        IncomingMap incomingVals;  // label -> value
 
       public:
         PhiInst(DataType t, Operand* r, const std::string& c = "")
@@ -475,8 +541,64 @@ namespace ME
             incomingVals[l] = v;
         }
 
-        virtual bool isTerminator() const override { return false; }
+        virtual Operand* getDefOperand() const override { return res; }
+        virtual void     getUseSlots(std::vector<Operand**>& slots) override
+        {
+            for (auto& [label, val] : incomingVals) slots.push_back(&val);
+        }
     };
+
+    using ::apply;
+
+    // 指令的访问者分派：按 opcode switch 后 static_cast 到具体类型，直接调用访问者的 visit，
+    // 省去 apply 通用路径中包装器 + accept 两层虚调用以及参数元组的打包。
+    // 对 Instruction& 调用 apply 时优先匹配此重载，其余对象仍走 ivisitor.h 中的通用 apply。
+    template <typename VisitorType, typename... CallArgs,
+        typename Return = typename std::remove_reference_t<VisitorType>::ReturnType,
+        typename Set    = typename std::remove_reference_t<VisitorType>::VisitSetType>
+    Return apply(VisitorType& visitor, Instruction& inst, CallArgs&&... args)
+    {
+#define X(op, T) \
+    case Operator::op: return visitor.visit(static_cast<T&>(inst), std::forward<CallArgs>(args)...);
+        switch (inst.opcode)
+        {
+            X(LOAD, LoadInst)
+            X(STORE, StoreInst)
+            X(ADD, ArithmeticInst)
+            X(SUB, ArithmeticInst)
+            X(MUL, ArithmeticInst)
+            X(DIV, ArithmeticInst)
+            X(MOD, ArithmeticInst)
+            X(FADD, ArithmeticInst)
+            X(FSUB, ArithmeticInst)
+            X(FMUL, ArithmeticInst)
+            X(FDIV, ArithmeticInst)
+            X(BITXOR, ArithmeticInst)
+            X(BITAND, ArithmeticInst)
+            X(SHL, ArithmeticInst)
+            X(ASHR, ArithmeticInst)
+            X(LSHR, ArithmeticInst)
+            X(ICMP, IcmpInst)
+            X(FCMP, FcmpInst)
+            X(ALLOCA, AllocaInst)
+            X(BR_COND, BrCondInst)
+            X(BR_UNCOND, BrUncondInst)
+            X(GLOBAL_VAR, GlbVarDeclInst)
+            X(CALL, CallInst)
+            X(FUNCDECL, FuncDeclInst)
+            X(FUNCDEF, FuncDefInst)
+            X(RET, RetInst)
+            X(GETELEMENTPTR, GEPInst)
+            X(FPTOSI, FP2SIInst)
+            X(SITOFP, SI2FPInst)
+            X(ZEXT, ZextInst)
+            X(PHI, PhiInst)
+            default: break;
+        }
+#undef X
+        // 其余 opcode 没有唯一对应的指令类，退回虚函数分派
+        return Set::template apply<Return>(inst, visitor, std::forward<CallArgs>(args)...);
+    }
 }  // namespace ME
 
 #endif  // __MIDDLEEND_MODULE_IR_INSTRUCTION_H__
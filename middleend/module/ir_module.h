@@ -12,6 +12,7 @@ namespace ME
         std::vector<GlbVarDeclInst*> globalVars;  // 全局变量列表
         std::vector<FuncDeclInst*>   funcDecls;   // 函数声明列表
         std::vector<Function*>       functions;   // 函数定义列表
+        ConstantPool                 constants;   // 模块级立即数/全局变量操作数表，在全部函数释放后才析构
 
       public:
         Module();
@@ -1,87 +1,127 @@
 #include <middleend/module/ir_operand.h>
+#include <middleend/module/ir_function.h>
+#include <algorithm>
 
 namespace ME
 {
-    OperandFactory::~OperandFactory()
+    namespace
     {
-        for (auto& [k, v] : ImmeI32OperandMap) delete v;
-        for (auto& [k, v] : ImmeF32OperandMap) delete v;
-        for (auto& [k, v] : RegOperandMap) delete v;
-        for (auto& [k, v] : LabelOperandMap) delete v;
-        for (auto& [k, v] : GlobalOperandMap) delete v;
+        // 当前线程所处的模块/函数操作数表，由 OperandScope 设置
+        thread_local ConstantPool* curConsts = nullptr;
+        thread_local OperandPool*  curPool   = nullptr;
+    }  // namespace
+
+    ConstantPool::~ConstantPool()
+    {
+        for (auto& [k, v] : i32s) delete v;
+        for (auto& [k, v] : f32s) delete v;
+        for (auto& [k, v] : globals) delete v;
     }
 
     // 内部查找缓存，若不存在则 new 一个对象并缓存后返回同一指针
 
-    RegOperand* OperandFactory::getRegOperand(size_t id)
+    ImmeI32Operand* ConstantPool::getImmeI32Operand(int value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto&                       op = i32s[value];
+        if (!op) op = new ImmeI32Operand(value);
+        return op;
+    }
+
+    ImmeF32Operand* ConstantPool::getImmeF32Operand(float value)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto&                       op = f32s[value];
+        if (!op) op = new ImmeF32Operand(value);
+        return op;
+    }
+
+    GlobalOperand* ConstantPool::getGlobalOperand(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto&                       op = globals[name];
+        if (!op) op = new GlobalOperand(name);
+        return op;
+    }
+
+    OperandPool::~OperandPool()
+    {
+        for (auto* op : regs) delete op;
+        for (auto* op : labels) delete op;
+    }
+
+    RegOperand* OperandPool::getRegOperand(size_t id)
     {
-        auto it = RegOperandMap.find(id);
-        if (it == RegOperandMap.end())
-        {
-            RegOperand* op    = new RegOperand(id);
-            RegOperandMap[id] = op;
-            return op;
-        }
-        return it->second;
+        if (id >= regs.size()) regs.resize(std::max(id + 1, regs.size() * 2), nullptr);
+        if (!regs[id]) regs[id] = new RegOperand(id);
+        return regs[id];
     }
 
-    ImmeI32Operand* OperandFactory::getImmeI32Operand(int value)
+    LabelOperand* OperandPool::getLabelOperand(size_t num)
     {
-        auto it = ImmeI32OperandMap.find(value);
-        if (it == ImmeI32OperandMap.end())
-        {
-            ImmeI32Operand* op       = new ImmeI32Operand(value);
-            ImmeI32OperandMap[value] = op;
-            return op;
-        }
-        return it->second;
+        if (num >= labels.size()) labels.resize(std::max(num + 1, labels.size() * 2), nullptr);
+        if (!labels[num]) labels[num] = new LabelOperand(num);
+        return labels[num];
     }
 
-    ImmeF32Operand* OperandFactory::getImmeF32Operand(float value)
+    ImmeI32Operand* OperandPool::getImmeI32Operand(int value, ConstantPool& consts)
     {
-        auto it = ImmeF32OperandMap.find(value);
-        if (it == ImmeF32OperandMap.end())
-        {
-            ImmeF32Operand* op       = new ImmeF32Operand(value);
-            ImmeF32OperandMap[value] = op;
-            return op;
-        }
-        return it->second;
+        auto& op = i32s[value];
+        if (!op) op = consts.getImmeI32Operand(value);
+        return op;
     }
 
-    GlobalOperand* OperandFactory::getGlobalOperand(const std::string& name)
+    ImmeF32Operand* OperandPool::getImmeF32Operand(float value, ConstantPool& consts)
     {
-        auto it = GlobalOperandMap.find(name);
-        if (it == GlobalOperandMap.end())
-        {
-            GlobalOperand* op      = new GlobalOperand(name);
-            GlobalOperandMap[name] = op;
-            return op;
-        }
-        return it->second;
+        auto& op = f32s[value];
+        if (!op) op = consts.getImmeF32Operand(value);
+        return op;
     }
 
-    LabelOperand* OperandFactory::getLabelOperand(size_t num)
+    OperandScope::OperandScope(ConstantPool& consts, Function* func)
+        : prevConsts(curConsts), prevPool(curPool), prevArena(InstArena::current())
     {
-        auto it = LabelOperandMap.find(num);
-        if (it == LabelOperandMap.end())
-        {
-            LabelOperand* op     = new LabelOperand(num);
-            LabelOperandMap[num] = op;
-            return op;
-        }
-        return it->second;
+        curConsts            = &consts;
+        curPool              = func ? &func->operands : nullptr;
+        InstArena::current() = func ? &func->instArena : nullptr;
     }
 
-    OperandFactory& ofInstance = OperandFactory::getInstance();
+    OperandScope::~OperandScope()
+    {
+        curConsts            = prevConsts;
+        curPool              = prevPool;
+        InstArena::current() = prevArena;
+    }
 }  // namespace ME
 
-// 全局访问接口，方便外部获取操作数对象
-ME::RegOperand*     getRegOperand(size_t id) { return ME::ofInstance.getRegOperand(id); }
-ME::ImmeI32Operand* getImmeI32Operand(int value) { return ME::ofInstance.getImmeI32Operand(value); }
-ME::ImmeF32Operand* getImmeF32Operand(float value) { return ME::ofInstance.getImmeF32Operand(value); }
-ME::GlobalOperand*  getGlobalOperand(const std::string& name) { return ME::ofInstance.getGlobalOperand(name); }
-ME::LabelOperand*   getLabelOperand(size_t num) { return ME::ofInstance.getLabelOperand(num); }
+// 全局访问接口，在当前 OperandScope 对应的操作数表中获取操作数对象
+ME::RegOperand* getRegOperand(size_t id)
+{
+    ASSERT(ME::curPool && "getRegOperand called outside of a function OperandScope");
+    return ME::curPool->getRegOperand(id);
+}
+ME::ImmeI32Operand* getImmeI32Operand(int value)
+{
+    ASSERT(ME::curConsts && "getImmeI32Operand called outside of an OperandScope");
+    if (ME::curPool) return ME::curPool->getImmeI32Operand(value, *ME::curConsts);
+    return ME::curConsts->getImmeI32Operand(value);
+}
+ME::ImmeF32Operand* getImmeF32Operand(float value)
+{
+    ASSERT(ME::curConsts && "getImmeF32Operand called outside of an OperandScope");
+    if (ME::curPool) return ME::curPool->getImmeF32Operand(value, *ME::curConsts);
+    return ME::curConsts->getImmeF32Operand(value);
+}
+ME::GlobalOperand* getGlobalOperand(const std::string& name)
+{
+    ASSERT(ME::curConsts && "getGlobalOperand called outside of an OperandScope");
+    return ME::curConsts->getGlobalOperand(name);
+}
+ME::LabelOperand* getLabelOperand(size_t num)
+{
+    ASSERT(ME::curPool && "getLabelOperand called outside of a function OperandScope");
+    return ME::curPool->getLabelOperand(num);
+}
 
 std::ostream& operator<<(std::ostream& os, const ME::Operand* op)
 {
@@ -6,11 +6,16 @@
 #include <debug.h>
 #include <string>
 #include <sstream>
-#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace ME
 {
-    class OperandFactory;
+    class ConstantPool;
+    class OperandPool;
+    class Function;
+    class InstArena;
 
     // 操作数基类
     class Operand
@@ -32,7 +37,7 @@ namespace ME
     // 寄存器操作数
     class RegOperand : public Operand
     {
-        friend class OperandFactory;
+        friend class OperandPool;
 
       public:
         size_t regNum;  // 寄存器编号
@@ -50,7 +55,7 @@ namespace ME
     // 立即数操作数 - 整型
     class ImmeI32Operand : public Operand
     {
-        friend class OperandFactory;
+        friend class ConstantPool;
 
       public:
         int value;  // 立即数值
@@ -68,7 +73,7 @@ namespace ME
     // 立即数操作数 - 浮点型
     class ImmeF32Operand : public Operand
     {
-        friend class OperandFactory;
+        friend class ConstantPool;
 
       public:
         float value;  // 立即数值
@@ -91,7 +96,7 @@ namespace ME
     // 全局变量操作数
     class GlobalOperand : public Operand
     {
-        friend class OperandFactory;
+        friend class ConstantPool;
 
       public:
         std::string name;
@@ -109,7 +114,7 @@ namespace ME
     // 标签操作数
     class LabelOperand : public Operand
     {
-        friend class OperandFactory;
+        friend class OperandPool;
 
       public:
         size_t lnum;  // 标签编号
@@ -124,29 +129,66 @@ namespace ME
         virtual size_t      getLabelNum() const override { return lnum; }
     };
 
-    class OperandFactory
+    /*
+     * 操作数的归属与去重
+     * - ConstantPool：模块级，立即数与全局变量名按值哈希去重，随 Module 一同释放；多个线程可同时查询（内部加锁）。
+     * - OperandPool：函数级，寄存器/标签操作数以编号为下标存放在稠密数组中，O(1) 查找，随 Function 一同释放；
+     *   另缓存本函数用到的立即数，命中时不必访问模块级表。
+     * - OperandScope：声明当前线程正在处理的模块与函数，全局的 getRegOperand/getImmeI32Operand 等接口
+     *   据此定位操作数表，新建的指令也从该函数的 InstArena 中分配。不同线程各自持有作用域，因此可以并发处理不同函数。
+     */
+    class ConstantPool
     {
       private:
-        std::map<int, ImmeI32Operand*>        ImmeI32OperandMap;  // 整型立即数操作数缓存
-        std::map<float, ImmeF32Operand*>      ImmeF32OperandMap;  // 浮点型立即数操作数缓存
-        std::map<size_t, RegOperand*>         RegOperandMap;      // 寄存器操作数缓存
-        std::map<size_t, LabelOperand*>       LabelOperandMap;    // 标签操作数缓存
-        std::map<std::string, GlobalOperand*> GlobalOperandMap;   // 全局变量操作数缓存
-        OperandFactory() = default;
-        ~OperandFactory();
+        std::unordered_map<int, ImmeI32Operand*>        i32s;     // 整型立即数
+        std::unordered_map<float, ImmeF32Operand*>      f32s;     // 浮点型立即数
+        std::unordered_map<std::string, GlobalOperand*> globals;  // 全局变量
+        std::mutex                                      mtx;
 
       public:
-        RegOperand*     getRegOperand(size_t id);
+        ConstantPool() = default;
+        ~ConstantPool();
+        ConstantPool(const ConstantPool&)            = delete;
+        ConstantPool& operator=(const ConstantPool&) = delete;
+
         ImmeI32Operand* getImmeI32Operand(int value);
         ImmeF32Operand* getImmeF32Operand(float value);
         GlobalOperand*  getGlobalOperand(const std::string& name);
+    };
+
+    class OperandPool
+    {
+      private:
+        std::vector<RegOperand*>                   regs;    // 寄存器编号 -> 操作数
+        std::vector<LabelOperand*>                 labels;  // 标签编号 -> 操作数
+        std::unordered_map<int, ImmeI32Operand*>   i32s;    // 本函数用到的整型立即数（指向模块级表）
+        std::unordered_map<float, ImmeF32Operand*> f32s;    // 本函数用到的浮点型立即数（指向模块级表）
+
+      public:
+        OperandPool() = default;
+        ~OperandPool();
+        OperandPool(const OperandPool&)            = delete;
+        OperandPool& operator=(const OperandPool&) = delete;
+
+        RegOperand*     getRegOperand(size_t id);
         LabelOperand*   getLabelOperand(size_t num);
+        ImmeI32Operand* getImmeI32Operand(int value, ConstantPool& consts);
+        ImmeF32Operand* getImmeF32Operand(float value, ConstantPool& consts);
+    };
 
-        static OperandFactory& getInstance()
-        {
-            static OperandFactory instance;
-            return instance;
-        }
+    class OperandScope
+    {
+      private:
+        ConstantPool* prevConsts;
+        OperandPool*  prevPool;
+        InstArena*    prevArena;
+
+      public:
+        // func 为空表示只处于模块级（如生成全局变量），此时不能申请寄存器/标签操作数，也不能新建函数内指令
+        OperandScope(ConstantPool& consts, Function* func = nullptr);
+        ~OperandScope();
+        OperandScope(const OperandScope&)            = delete;
+        OperandScope& operator=(const OperandScope&) = delete;
     };
 }  // namespace ME
 
@@ -3,7 +3,10 @@
 #include <middleend/pass/analysis/postdominfo.h>
 #include <middleend/visitor/utils/use_def_visitor.h>
 #include <middleend/module/ir_operand.h>
+#include <utils/indexed_map.h>
+#include <map>
 #include <queue>
+#include <unordered_map>
 #include <algorithm>
 
 namespace ME
@@ -30,7 +33,7 @@ namespace ME
         return succs;
     }
 
-    void ADCEPass::runOnFunction(Function& function)
+    Analysis::PreservedAnalyses ADCEPass::runOnFunction(Function& function)
     {
         liveInsts.clear();
         postImmDom.clear();
@@ -44,18 +47,22 @@ namespace ME
         markLive(function);
 
         // 2) 移除死代码（包含死指令删除 + 死终结符分支修复）
-        removeDeadCode(function);
+        bool changed = removeDeadCode(function);
 
         // 3) 清理不可达块（以及可达块 Phi 中来自不可达前驱的 incoming）
-        cleanUp(function);
-        Analysis::Manager::getInstance().invalidate(function);
-        Analysis::Manager::getInstance().get<Analysis::CFG>(function);
+        changed |= cleanUp(function);
+        if (!changed) return Analysis::PreservedAnalyses::all();
+
+        // 死分支被重定向、不可达块被删除，函数级分析全部作废；call/store 必定活跃，模块级分析不受影响
+        return Analysis::PreservedAnalyses::none().preserveModuleAnalyses();
     }
 
-    void ADCEPass::cleanUp(Function& function)
+    bool ADCEPass::cleanUp(Function& function)
     {
+        bool changed = false;
+
         // 1) 从入口块做 BFS，计算可达块集合
-        std::set<size_t>   reachable;
+        DenseSet           reachable(function.getMaxLabel());
         std::queue<size_t> q;
 
         if (function.blocks.count(0))
@@ -76,12 +83,8 @@ namespace ME
             std::vector<size_t> succs = getSuccessors(itBlock->second);
             for (size_t succId : succs)
             {
-                if (reachable.find(succId) == reachable.end())
-                {
-                    // 标记为可达
-                    reachable.insert(succId);
-                    q.push(succId);
-                }
+                // 首次到达时标记为可达并入队
+                if (reachable.insert(succId)) q.push(succId);
             }
         }
 
@@ -108,15 +111,16 @@ namespace ME
                         if (inst->opcode == Operator::PHI)
                         {
                             auto* phi     = dynamic_cast<PhiInst*>(inst);
-                            auto* labelOp = OperandFactory::getInstance().getLabelOperand(id);
+                            auto* labelOp = getLabelOperand(id);
                             // 从 Phi 节点中移除该不可达块的输入
-                            phi->incomingVals.erase(labelOp);
+                            if (phi->incomingVals.erase(labelOp)) changed = true;
                         }
                         else { break; }
                     }
                 }
             }
         }
+        return changed;
     }
 
     bool ADCEPass::isSideEffect(Instruction* inst)
@@ -134,8 +138,6 @@ namespace ME
 
     void ADCEPass::markLive(Function& function)
     {
-        Analysis::Manager::getInstance().invalidate     (function);
-
         // 获取控制流图 CFG 和后支配信息（用于控制依赖传播）
         auto* cfg         = Analysis::Manager::getInstance().get<Analysis::CFG>(function);
         auto* postDomInfo = Analysis::Manager::getInstance().get<Analysis::PostDomInfo>(function);
@@ -145,7 +147,7 @@ namespace ME
         const auto& pdf = postDomInfo->getPostDomFrontier();  // 获取后支配边界数组
 
         // 构建寄存器定义映射：reg -> 定义该 reg 的指令
-        std::map<size_t, Instruction*> regDefInst;
+        IndexedMap<Instruction*> regDefInst(function.getMaxReg());
         for (auto& [id, block] : function.blocks)
         {
             for (auto* inst : block->insts)
@@ -157,8 +159,8 @@ namespace ME
             }
         }
 
-        std::queue<Instruction*>       worklist;  // 存储待处理的活跃指令
-        std::map<Instruction*, size_t> instToBlock;
+        std::queue<Instruction*>                 worklist;  // 存储待处理的活跃指令
+        std::unordered_map<Instruction*, size_t> instToBlock;
 
         // 初始化：把所有有副作用的指令加入活跃集合与工作队列
         for (auto& [id, block] : function.blocks)
@@ -195,10 +197,10 @@ namespace ME
             for (auto& [reg, _] : dummyMap)
             {
                 // 遍历寄存器定义
-                if (regDefInst.count(reg))
+                if (auto* def = regDefInst.lookup(reg))
                 {
                     // 如果有定义该寄存器的指令
-                    Instruction* defInst = regDefInst[reg];
+                    Instruction* defInst = *def;
                     if (liveInsts.find(defInst) == liveInsts.end())
                     {
                         // 如果定义指令尚未标记为活跃，则标记并加入工作列表
@@ -279,19 +281,17 @@ namespace ME
 
         for (auto& [id, block] : function.blocks)
         {
-            std::deque<Instruction*> newInsts;
-
-            for (auto* inst : block->insts)
+            // 先推进迭代器，再原地摘除或替换当前指令
+            for (auto it = block->insts.begin(); it != block->insts.end();)
             {
+                Instruction* inst = *it++;
+
                 // 活跃指令直接保留
-                if (liveInsts.count(inst))
-                {
-                    newInsts.push_back(inst);
-                    continue;
-                }
+                if (liveInsts.count(inst)) continue;
                 // 死指令：非终结符直接删除
                 if (!inst->isTerminator())
                 {
+                    block->insts.remove(inst);
                     delete inst;
                     changed = true;
                     continue;
@@ -333,20 +333,16 @@ namespace ME
                     {
                         auto* br = dynamic_cast<BrUncondInst*>(inst);
 
-                        if ((int)br->target->getLabelNum() == targetId)
-                        {
-                            newInsts.push_back(inst);  // 已经跳转到正确目标
-                            continue;
-                        }
+                        if ((int)br->target->getLabelNum() == targetId) continue;  // 已经跳转到正确目标
                     }
 
                     // 否则就，创建新的无条件跳转
-                    auto* newBr = new BrUncondInst(OperandFactory::getInstance().getLabelOperand(targetId));
+                    auto* newBr = new BrUncondInst(getLabelOperand(targetId));
 
                     // 更新目标块的 Phi：如果当前块成为目标块的新前驱，需要补齐 incoming（默认 0）
                     if (auto it = function.blocks.find(targetId); it != function.blocks.end() && it->second)
                     {
-                        auto* currentLabel = OperandFactory::getInstance().getLabelOperand(id);
+                        auto* currentLabel = getLabelOperand(id);
                         for (auto* targetInst : it->second->insts)
                         {
                             // 遍历目标块的指令，直到非Phi指令为止
@@ -355,12 +351,12 @@ namespace ME
                             if (phi->incomingVals.find(currentLabel) == phi->incomingVals.end())
                             {
                                 // 如果当前块不在Phi的前驱中，添加一个默认值0
-                                phi->addIncoming(OperandFactory::getInstance().getImmeI32Operand(0), currentLabel);
+                                phi->addIncoming(getImmeI32Operand(0), currentLabel);
                             }
                         }
                     }
+                    block->insts.replace(inst, newBr);
                     delete inst;
-                    newInsts.push_back(newBr);
                     changed = true;
                 }
                 // 情况2: 如果后支配链上没有活跃块，
@@ -371,21 +367,14 @@ namespace ME
                     if (auto* target = dynamic_cast<LabelOperand*>(br->trueTar))
                     {  // 创建无条件跳转到 true 目标
                         auto* newBr = new BrUncondInst(target);
+                        block->insts.replace(inst, newBr);
                         delete inst;
-                        newInsts.push_back(newBr);
                         changed = true;
                     }
-                    else
-                    {
-                        // 如果无法确定目标，保留原指令
-                        newInsts.push_back(inst);
-                    }
+                    // 如果无法确定目标，保留原指令
                 }
                 // 情况3: 其他情况保留原终结符
-                else { newInsts.push_back(inst); }
             }
-
-            block->insts = newInsts;
         }
         return changed;
     }
@@ -4,8 +4,7 @@
 #include <interfaces/middleend/pass.h>
 #include <middleend/module/ir_function.h>
 #include <middleend/module/ir_instruction.h>
-#include <set>
-#include <map>
+#include <unordered_set>
 #include <vector>
 
 namespace ME
@@ -17,7 +16,7 @@ namespace ME
         ADCEPass()  = default;
         ~ADCEPass() = default;
 
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
         // 标记活跃指令
@@ -26,12 +25,12 @@ namespace ME
         bool removeDeadCode(Function& function);
         // 判断指令是否有副作用，和dcepass中一样
         bool isSideEffect(Instruction* inst);
-        // 清理不可达块造成的 Phi 节点残留
-        void cleanUp(Function& function);
+        // 清理不可达块造成的 Phi 节点残留，返回是否有改动
+        bool cleanUp(Function& function);
 
-        std::set<Instruction*> liveInsts;   // 活跃指令集合
-        std::vector<int>       postImmDom;  // 后支配树的直接支配者
-        size_t                 numBlocks;   // 基本块数量
+        std::unordered_set<Instruction*> liveInsts;   // 活跃指令集合
+        std::vector<int>                 postImmDom;  // 后支配树的直接支配者
+        size_t                           numBlocks;   // 基本块数量
     };
 }  // namespace ME
 
@@ -1,20 +1,59 @@
 #include <middleend/pass/analysis/analysis_manager.h>
+#include <middleend/pass/analysis/cfg.h>
+#include <middleend/pass/analysis/dominfo.h>
+#include <middleend/pass/analysis/postdominfo.h>
+#include <middleend/pass/analysis/loop_info.h>
+#include <middleend/pass/analysis/call_graph.h>
+#include <middleend/pass/analysis/global_modref.h>
+#include <string>
 
 namespace ME::Analysis
 {
     Manager& AM = Manager::getInstance();
 
+    PreservedAnalyses& PreservedAnalyses::preserveCFGAnalyses()
+    {
+        preserve<CFG>();
+        preserve<DomInfo>();
+        preserve<PostDomInfo>();
+        preserve<LoopInfo>();
+        return *this;
+    }
+
+    PreservedAnalyses& PreservedAnalyses::preserveModuleAnalyses()
+    {
+        preserve<CallGraph>();
+        preserve<GlobalModRef>();
+        return *this;
+    }
+
+    void PreservedAnalyses::intersect(const PreservedAnalyses& other)
+    {
+        if (other.allPreserved) return;
+        if (allPreserved)
+        {
+            *this = other;
+            return;
+        }
+        for (auto it = preservedIds.begin(); it != preservedIds.end();)
+        {
+            if (other.preservedIds.count(*it))
+                ++it;
+            else
+                it = preservedIds.erase(it);
+        }
+    }
+
     Manager::~Manager()
     {
         for (auto& funcCachePair : analysisCache)
         {
             // 删除该函数上的所有分析结果
-            for (auto& analysisPair : funcCachePair.second)
-            {
-                // 使用注册的删除器函数删除分析结果
-                auto deleterIt = deleterMap.find(analysisPair.first);
-                if (deleterIt != deleterMap.end()) { deleterIt->second(analysisPair.second); }
-            }
+            for (auto& analysisPair : funcCachePair.second) destroy(analysisPair.first, analysisPair.second);
+        }
+        for (auto& moduleCachePair : moduleCache)
+        {
+            for (auto& analysisPair : moduleCachePair.second) destroy(analysisPair.first, analysisPair.second);
         }
     }
 
@@ -25,16 +64,80 @@ namespace ME::Analysis
         return instance;
     }
 
+    void Manager::destroy(size_t tid, void* analysis)
+    {
+        // 使用注册的删除器函数删除分析结果
+        auto deleterIt = deleterMap.find(tid);
+        if (deleterIt != deleterMap.end()) deleterIt->second(analysis);
+    }
+
+    void Manager::eraseWithDependents(AnalysisMap& cached, size_t tid)
+    {
+        auto it = cached.find(tid);
+        if (it == cached.end()) return;
+        destroy(it->first, it->second);
+        cached.erase(it);
+
+        auto depIt = dependents.find(tid);
+        if (depIt == dependents.end()) return;
+        for (size_t dep : depIt->second) eraseWithDependents(cached, dep);
+    }
+
     void Manager::invalidate(Function& func)
     {
+        std::lock_guard<std::mutex> lock(mtx);
         // 删除该函数上的所有分析结果
         auto it = analysisCache.find(&func);
         if (it == analysisCache.end()) return;
+        for (auto& analysisPair : it->second) destroy(analysisPair.first, analysisPair.second);
+        analysisCache.erase(it);
+    }
+
+    void Manager::invalidate(Function& func, const PreservedAnalyses& pa)
+    {
+        if (pa.areAllPreserved()) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        auto                        it = analysisCache.find(&func);
+        if (it == analysisCache.end()) return;
+
+        // 先收集再删除：删除时会连带删除依赖项，不能边遍历边删
+        std::vector<size_t> abandoned;
         for (auto& analysisPair : it->second)
         {
-            auto deleterIt = deleterMap.find(analysisPair.first);
-            if (deleterIt != deleterMap.end()) deleterIt->second(analysisPair.second);
+            if (!pa.isPreserved(analysisPair.first)) abandoned.push_back(analysisPair.first);
         }
-        analysisCache.erase(it);
+        for (size_t tid : abandoned) eraseWithDependents(it->second, tid);
+        if (it->second.empty()) analysisCache.erase(it);
+    }
+
+    void Manager::invalidate(Module& module, const PreservedAnalyses& pa)
+    {
+        if (pa.areAllPreserved()) return;
+        std::lock_guard<std::mutex> lock(mtx);
+        auto                        it = moduleCache.find(&module);
+        if (it == moduleCache.end()) return;
+
+        std::vector<size_t> abandoned;
+        for (auto& analysisPair : it->second)
+        {
+            if (!pa.isPreserved(analysisPair.first)) abandoned.push_back(analysisPair.first);
+        }
+        for (size_t tid : abandoned) eraseWithDependents(it->second, tid);
+        if (it->second.empty()) moduleCache.erase(it);
+    }
+
+    void Manager::printStats(std::ostream& os) const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        // 按名称排序输出，与 TID（函数地址）无关
+        std::map<std::string, size_t> byName;
+        size_t                        total = 0;
+        for (auto& [tid, stat] : buildStats)
+        {
+            byName[stat.first] += stat.second;
+            total += stat.second;
+        }
+        os << "analysis builds: " << total << "\n";
+        for (auto& [name, count] : byName) os << "  " << name << ": " << count << "\n";
     }
 }  // namespace ME::Analysis
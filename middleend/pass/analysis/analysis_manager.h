@@ -1,7 +1,11 @@
 #ifndef __INTERFACES_MIDDLEEND_ANALYSIS_MANAGER_H__
 #define __INTERFACES_MIDDLEEND_ANALYSIS_MANAGER_H__
 
+#include <algorithm>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
 #include <set>
 #include <type_utils.h>
 #include <unordered_map>
@@ -11,12 +15,19 @@
  * 中端分析管理器 (Analysis Manager)
  *
  * 用法速览:
- * - 注册/获取分析: 通过 AM.get<YourAnalysis>(function) 获得并缓存某函数上的分析结果。
- * - 缓存失效: 当函数 IR 发生改变后，调用 AM.invalidate(function) 使相关分析失效。
+ * - 注册/获取分析: 通过 AM.get<YourAnalysis>(function) 获得并缓存某函数上的分析结果；
+ *   模块级分析（调用图、全局变量读写等）通过 AM.get<YourAnalysis>(module) 获取，与函数级分析一同缓存。
+ * - 缓存失效: Pass 的 runOnFunction/runOnModule 返回 PreservedAnalyses，说明哪些分析在 Pass 后仍然有效，
+ *   由调用方通过 AM.invalidate(function, pa) / AM.invalidate(module, pa) 只丢弃未保留的分析。
+ *   Pass 内部修改 IR 后还要继续使用分析时，可调用 AM.invalidate(function) 或 AM.invalidate<YourAnalysis>(function)。
+ * - 依赖关系: 分析在 get<> 中通过 addDependency<本分析, 依赖的分析>() 登记依赖，
+ *   被依赖的分析失效时，依赖它的分析一并失效（如 CFG 失效则 DomInfo、LoopInfo 也失效）。
  * - 分析类需定义静态常量 TID = getTID<AP>()，用于唯一标识。
  *   该标识实际上是 getTID<AP>() 实例化后的函数地址。不同实例的 getTID<AP>()
- *   所在地址不同，因此我们可以将它用作每个类的唯一 ID
+ *   所在地址不同，因此我们可以将它用作每个类的唯一 ID；NAME 用于统计输出。
  * - 参考已有示例: CFG、DomInfo 的 get<> 特化与调用方式。
+ * - 多线程: 缓存表的查找/插入/删除都在内部互斥锁下进行，不同线程可以同时处理不同的函数；
+ *   同一函数上的分析只能由一个线程访问，模块级分析应在进入并行区之前取得。
  */
 
 namespace ME
@@ -27,6 +38,42 @@ namespace ME
 
     namespace Analysis
     {
+        // Pass 运行后仍然有效的分析集合
+        class PreservedAnalyses
+        {
+          private:
+            bool             allPreserved = false;
+            std::set<size_t> preservedIds;
+
+          public:
+            // 未修改 IR
+            static PreservedAnalyses all()
+            {
+                PreservedAnalyses pa;
+                pa.allPreserved = true;
+                return pa;
+            }
+            // 修改了 IR 且不维护任何分析
+            static PreservedAnalyses none() { return PreservedAnalyses(); }
+
+            template <typename Target>
+            PreservedAnalyses& preserve()
+            {
+                preservedIds.insert(Target::TID);
+                return *this;
+            }
+            // 只改写了指令、未改变基本块及其跳转关系：CFG、(后)支配树与循环信息仍然有效
+            PreservedAnalyses& preserveCFGAnalyses();
+            // 没有增删 call 指令与对全局变量的 store：调用图与全局变量读写分析仍然有效
+            PreservedAnalyses& preserveModuleAnalyses();
+
+            bool areAllPreserved() const { return allPreserved; }
+            bool isPreserved(size_t tid) const { return allPreserved || preservedIds.count(tid); }
+
+            // 取交集：两次修改都保留的分析才保留
+            void intersect(const PreservedAnalyses& other);
+        };
+
         class Manager
         {
           private:
@@ -35,10 +82,20 @@ namespace ME
             using AnalysisMap = std::unordered_map<size_t, void*>;
             // 函数类指针 -> (分析 TID -> 分析结果 指针)
             std::unordered_map<Function*, AnalysisMap> analysisCache;
+            // 模块指针 -> (分析 TID -> 模块级分析结果 指针)
+            std::unordered_map<Module*, AnalysisMap> moduleCache;
 
             using Deleter = void (*)(void*);
             // 分析 ID -> 删除器函数 指针
             std::unordered_map<size_t, Deleter> deleterMap;
+            // 分析 ID -> 依赖它的分析 ID 列表
+            std::unordered_map<size_t, std::vector<size_t>> dependents;
+
+            // 统计：分析 ID -> (名称, 构建次数)
+            std::map<size_t, std::pair<const char*, size_t>> buildStats;
+
+            // 保护以上所有表；分析的构建在锁外进行
+            mutable std::mutex mtx;
 
             Manager() = default;
             ~Manager();
@@ -49,9 +106,29 @@ namespace ME
             // 获取某函数上的分析结果，若不存在则创建并缓存
             template <typename Target>
             Target* get(Function& func);
+            // 获取模块级分析结果，若不存在则创建并缓存
+            template <typename Target>
+            Target* get(Module& module);
 
             // 使某函数上的所有分析结果失效
             void invalidate(Function& func);
+            // 只丢弃 pa 中未保留的函数级分析（及依赖它们的分析）
+            void invalidate(Function& func, const PreservedAnalyses& pa);
+            // 只丢弃 pa 中未保留的模块级分析
+            void invalidate(Module& module, const PreservedAnalyses& pa);
+
+            // 只使某函数上的一种分析结果失效（如只改了指令、未改 CFG 时只丢弃 DefUse）
+            template <typename Target>
+            void invalidate(Function& func)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                auto                        it = analysisCache.find(&func);
+                if (it == analysisCache.end()) return;
+                eraseWithDependents(it->second, Target::TID);
+            }
+
+            // 打印各分析的构建次数
+            void printStats(std::ostream& os) const;
 
           private:
             // 注册某分析类的删除器函数
@@ -65,17 +142,38 @@ namespace ME
                 }
             }
 
+            // 登记 Target 依赖于 On：On 失效时 Target 一并失效
+            template <typename Target, typename On>
+            void addDependency()
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                auto&                       list = dependents[On::TID];
+                if (std::find(list.begin(), list.end(), Target::TID) == list.end()) list.push_back(Target::TID);
+            }
+
             // 缓存某函数上的分析结果
             template <typename Target>
             void cache(Function& func, Target* analysis)
             {
+                std::lock_guard<std::mutex> lock(mtx);
+                registerDeleter<Target>();
+                countBuild<Target>();
                 analysisCache[&func][Target::TID] = analysis;
             }
+            template <typename Target>
+            void cache(Module& module, Target* analysis)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                registerDeleter<Target>();
+                countBuild<Target>();
+                moduleCache[&module][Target::TID] = analysis;
+            }
 
             // 获取某函数上已缓存的分析结果，若不存在则返回 nullptr
             template <typename Target>
             Target* getCached(Function& func)
             {
+                std::lock_guard<std::mutex> lock(mtx);
                 // 检查缓存中是否已有该函数的指定分析结果
                 if (analysisCache.count(&func))  // count 检查键是否存在
                 {
@@ -88,6 +186,27 @@ namespace ME
                 }
                 return nullptr;
             }
+            template <typename Target>
+            Target* getCached(Module& module)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                auto                        it = moduleCache.find(&module);
+                if (it == moduleCache.end()) return nullptr;
+                auto ait = it->second.find(Target::TID);
+                return ait == it->second.end() ? nullptr : static_cast<Target*>(ait->second);
+            }
+
+            template <typename Target>
+            void countBuild()
+            {
+                auto& stat = buildStats[Target::TID];
+                stat.first = Target::NAME;
+                ++stat.second;
+            }
+
+            // 删除一个分析结果，并递归删除依赖它的分析
+            void eraseWithDependents(AnalysisMap& cached, size_t tid);
+            void destroy(size_t tid, void* analysis);
         };
 
         extern Manager& AM;
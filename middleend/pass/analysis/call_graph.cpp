@@ -0,0 +1,71 @@
+#include <middleend/pass/analysis/call_graph.h>
+#include <algorithm>
+
+namespace ME::Analysis
+{
+    void CallGraph::build(Module& module)
+    {
+        defined.clear();
+        callees.clear();
+        callers.clear();
+        externalCallers.clear();
+
+        for (auto* func : module.functions)
+        {
+            if (func && func->funcDef) defined[func->funcDef->funcName] = func;
+        }
+
+        for (auto* func : module.functions)
+        {
+            if (!func) continue;
+            for (auto& [id, block] : func->blocks)
+            {
+                for (auto* inst : block->insts)
+                {
+                    if (inst->opcode != Operator::CALL) continue;
+                    Function* callee = getFunction(static_cast<CallInst*>(inst)->funcName);
+                    if (!callee)
+                    {
+                        externalCallers.insert(func);
+                        continue;
+                    }
+                    auto& out = callees[func];
+                    if (std::find(out.begin(), out.end(), callee) != out.end()) continue;
+                    out.push_back(callee);
+                    callers[callee].push_back(func);
+                }
+            }
+        }
+    }
+
+    Function* CallGraph::getFunction(const std::string& name) const
+    {
+        auto it = defined.find(name);
+        return it == defined.end() ? nullptr : it->second;
+    }
+
+    const std::vector<Function*>& CallGraph::getCallees(Function* func) const
+    {
+        static const std::vector<Function*> empty;
+        auto                                it = callees.find(func);
+        return it == callees.end() ? empty : it->second;
+    }
+
+    const std::vector<Function*>& CallGraph::getCallers(Function* func) const
+    {
+        static const std::vector<Function*> empty;
+        auto                                it = callers.find(func);
+        return it == callers.end() ? empty : it->second;
+    }
+
+    template <>
+    CallGraph* Manager::get<CallGraph>(Module& module)
+    {
+        if (auto* cached = getCached<CallGraph>(module)) return cached;
+
+        auto* cg = new CallGraph();
+        cg->build(module);
+        cache<CallGraph>(module, cg);
+        return cg;
+    }
+}  // namespace ME::Analysis
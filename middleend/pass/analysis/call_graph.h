@@ -0,0 +1,47 @@
+#ifndef __INTERFACES_MIDDLEEND_ANALYSIS_CALL_GRAPH_H__
+#define __INTERFACES_MIDDLEEND_ANALYSIS_CALL_GRAPH_H__
+
+#include <middleend/pass/analysis/analysis_manager.h>
+#include <middleend/module/ir_module.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * 调用图 (CallGraph) 分析，模块级
+ * - 通过 Analysis::AM.get<CallGraph>(module) 构建并缓存。
+ * - 记录模块内定义函数之间的调用边（按函数在模块中的顺序、首次出现的顺序去重），
+ *   以及哪些函数调用了模块外（库）函数。
+ * - 增删 call 指令的 Pass 不能保留该分析。
+ */
+
+namespace ME::Analysis
+{
+    class CallGraph
+    {
+      public:
+        static inline const size_t TID  = getTID<CallGraph>();  // 唯一类型 ID
+        static inline const char*  NAME = "CallGraph";
+
+      private:
+        std::unordered_map<std::string, Function*>            defined;          // 函数名 -> 模块内定义
+        std::unordered_map<Function*, std::vector<Function*>> callees;          // caller -> 被调用的模块内函数
+        std::unordered_map<Function*, std::vector<Function*>> callers;          // callee -> 调用它的模块内函数
+        std::unordered_set<Function*>                         externalCallers;  // 调用了模块外函数的函数
+
+      public:
+        void build(Module& module);
+
+        Function*                     getFunction(const std::string& name) const;
+        const std::vector<Function*>& getCallees(Function* func) const;
+        const std::vector<Function*>& getCallers(Function* func) const;
+        bool callsExternal(Function* func) const { return externalCallers.count(func); }
+        bool hasExternalCalls() const { return !externalCallers.empty(); }
+    };
+
+    template <>
+    CallGraph* Manager::get<CallGraph>(Module& module);
+}  // namespace ME::Analysis
+
+#endif  // __INTERFACES_MIDDLEEND_ANALYSIS_CALL_GRAPH_H__
@@ -40,16 +40,16 @@ namespace ME::Analysis
         buildFromBlock(0, visited);      // 构建cfg
 
         // 清理未访问的基本块及其边
-        auto blocks_temp = func->blocks;
-        func->blocks.clear();  // 清空函数的所有基本块映射
-
-        for (auto& [blockId, block] : blocks_temp)
+        for (auto it = func->blocks.begin(); it != func->blocks.end();)
         {
             // 根据访问情况决定是否保留该基本块
-            if (visited[blockId])
-                func->blocks[blockId] = block;
-            else
-                delete block;
+            if (visited[it->first])
+            {
+                ++it;
+                continue;
+            }
+            delete it->second;
+            it = func->blocks.erase(it);
         }
 
         // 重新构建 id2block 映射
@@ -99,8 +99,9 @@ namespace ME::Analysis
                 auto next_it = std::next(it);
                 while (next_it != currentBlock->insts.end())
                 {
-                    delete *next_it;
-                    next_it = currentBlock->insts.erase(next_it);  // erase 返回下一个迭代器
+                    Instruction* dead = *next_it;
+                    next_it           = currentBlock->insts.erase(next_it);  // erase 返回下一个迭代器
+                    delete dead;
                 }
                 break;
             }
@@ -25,7 +25,8 @@ namespace ME::Analysis
     {
       public:
         // 唯一类型 ID
-        static inline const size_t TID = getTID<CFG>();
+        static inline const size_t TID  = getTID<CFG>();
+        static inline const char*  NAME = "CFG";
 
         ME::Function*                func;      // 所属函数指针
         std::map<size_t, ME::Block*> id2block;  // blockId -> Block*
@@ -0,0 +1,113 @@
+#include <middleend/pass/analysis/def_use.h>
+#include <algorithm>
+
+namespace ME::Analysis
+{
+    void DefUse::build(Function& func)
+    {
+        defs.clear();
+        uses.clear();
+        instBlock.clear();
+        reserve(func.getMaxReg());
+
+        for (auto& [id, block] : func.blocks)
+        {
+            for (auto* inst : block->insts) addInst(inst, block);
+        }
+    }
+
+    void DefUse::reserve(size_t reg)
+    {
+        if (reg < defs.size()) return;
+        defs.resize(reg + 1, nullptr);
+        uses.resize(reg + 1);
+    }
+
+    Block* DefUse::getBlock(Instruction* inst) const
+    {
+        if (!inst) return nullptr;
+        auto it = instBlock.find(inst);
+        return it == instBlock.end() ? nullptr : it->second;
+    }
+
+    const std::vector<DefUse::Use>& DefUse::getUses(size_t reg) const
+    {
+        static const std::vector<Use> empty;
+        return reg < uses.size() ? uses[reg] : empty;
+    }
+
+    void DefUse::addInst(Instruction* inst, Block* block)
+    {
+        instBlock[inst] = block;
+
+        Operand* def = inst->getDefOperand();
+        if (def && def->getType() == OperandType::REG)
+        {
+            reserve(def->getRegNum());
+            defs[def->getRegNum()] = inst;
+        }
+
+        std::vector<Operand**> slots;
+        inst->getUseSlots(slots);
+        for (auto* slot : slots)
+        {
+            Operand* op = *slot;
+            if (!op || op->getType() != OperandType::REG) continue;
+            reserve(op->getRegNum());
+            uses[op->getRegNum()].push_back({inst, slot});
+        }
+    }
+
+    void DefUse::removeInst(Instruction* inst)
+    {
+        instBlock.erase(inst);
+
+        Operand* def = inst->getDefOperand();
+        if (def && def->getType() == OperandType::REG && getDef(def->getRegNum()) == inst)
+            defs[def->getRegNum()] = nullptr;
+
+        // 同一寄存器可能在指令中出现多次，按寄存器整体摘除该指令的全部使用
+        std::vector<Operand**> slots;
+        inst->getUseSlots(slots);
+        for (auto* slot : slots)
+        {
+            Operand* op = *slot;
+            if (!op || op->getType() != OperandType::REG || op->getRegNum() >= uses.size()) continue;
+            auto& list = uses[op->getRegNum()];
+            list.erase(std::remove_if(list.begin(), list.end(), [inst](const Use& u) { return u.user == inst; }),
+                list.end());
+        }
+    }
+
+    void DefUse::moveInst(Instruction* inst, Block* block) { instBlock[inst] = block; }
+
+    void DefUse::replaceAllUsesWith(size_t reg, Operand* newOp)
+    {
+        if (reg >= uses.size()) return;
+        if (newOp && newOp->getType() == OperandType::REG && newOp->getRegNum() == reg) return;
+
+        std::vector<Use> list = std::move(uses[reg]);
+        uses[reg].clear();
+
+        bool toReg = newOp && newOp->getType() == OperandType::REG;
+        if (toReg) reserve(newOp->getRegNum());
+        for (auto& use : list)
+        {
+            Operand* cur = *use.slot;
+            if (!cur || cur->getType() != OperandType::REG || cur->getRegNum() != reg) continue;
+            *use.slot = newOp;
+            if (toReg) uses[newOp->getRegNum()].push_back(use);
+        }
+    }
+
+    template <>
+    DefUse* Manager::get<DefUse>(Function& func)
+    {
+        if (auto* cached = getCached<DefUse>(func)) return cached;
+
+        auto* du = new DefUse();
+        du->build(func);
+        cache<DefUse>(func, du);
+        return du;
+    }
+}  // namespace ME::Analysis
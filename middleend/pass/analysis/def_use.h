@@ -0,0 +1,66 @@
+#ifndef __INTERFACES_MIDDLEEND_ANALYSIS_DEF_USE_H__
+#define __INTERFACES_MIDDLEEND_ANALYSIS_DEF_USE_H__
+
+#include <middleend/pass/analysis/analysis_manager.h>
+#include <middleend/module/ir_function.h>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Def-Use 链分析
+ * - 通过 Analysis::AM.get<DefUse>(function) 构建并缓存函数内的 def-use 链。
+ * - 寄存器编号直接作为下标：getDef 为 O(1)，每条 Use 记录使用者指令与其操作数槽位的地址，
+ *   replaceAllUsesWith 只改写该寄存器的使用点，代价与使用数成正比，无需重新遍历整个函数。
+ * - 修改 IR 的 Pass 可以通过 addInst/removeInst/moveInst 增量维护，使链在 Pass 之间保持有效；
+ *   直接改写指令操作数（如删除 Phi 的 incoming）前需先 removeInst，改完后再 addInst。
+ * - 未维护链的 Pass 修改了指令后，需调用 AM.invalidate(function) 或 AM.invalidate<DefUse>(function)。
+ */
+
+namespace ME::Analysis
+{
+    class DefUse
+    {
+      public:
+        static inline const size_t TID  = getTID<DefUse>();  // 唯一类型 ID
+        static inline const char*  NAME = "DefUse";
+
+        // 一次使用：使用者指令 + 指令内存放该操作数的槽位
+        struct Use
+        {
+            Instruction* user;
+            Operand**    slot;
+        };
+
+      private:
+        std::vector<Instruction*>                defs;       // 寄存器编号 -> 定义指令（参数或未定义为 nullptr）
+        std::vector<std::vector<Use>>            uses;       // 寄存器编号 -> 使用点列表
+        std::unordered_map<Instruction*, Block*> instBlock;  // 指令 -> 所在基本块
+
+      public:
+        DefUse()  = default;
+        ~DefUse() = default;
+
+        void build(Function& func);
+
+        Instruction*            getDef(size_t reg) const { return reg < defs.size() ? defs[reg] : nullptr; }
+        Block*                  getBlock(Instruction* inst) const;
+        Block*                  getDefBlock(size_t reg) const { return getBlock(getDef(reg)); }
+        const std::vector<Use>& getUses(size_t reg) const;
+        bool                    hasUses(size_t reg) const { return reg < uses.size() && !uses[reg].empty(); }
+
+        // 把 reg 的全部使用改写为 newOp，并把这些使用登记到 newOp（若为寄存器）下
+        void replaceAllUsesWith(size_t reg, Operand* newOp);
+
+        void addInst(Instruction* inst, Block* block);   // 登记新插入的指令
+        void removeInst(Instruction* inst);              // 注销即将删除（或即将改写操作数）的指令
+        void moveInst(Instruction* inst, Block* block);  // 指令被移动到其他基本块
+
+      private:
+        void reserve(size_t reg);
+    };
+
+    template <>
+    DefUse* Manager::get<DefUse>(Function& func);
+}  // namespace ME::Analysis
+
+#endif  // __INTERFACES_MIDDLEEND_ANALYSIS_DEF_USE_H__
@@ -48,6 +48,7 @@ namespace ME::Analysis
 
         auto* domInfo = new DomInfo();
         domInfo->build(*cfg);
+        addDependency<DomInfo, CFG>();
         cache<DomInfo>(func, domInfo);
         return domInfo;
     }
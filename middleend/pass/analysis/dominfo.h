@@ -11,7 +11,8 @@ namespace ME::Analysis
     class DomInfo
     {
       public:
-        static inline const size_t TID = getTID<DomInfo>();  // 唯一类型 ID
+        static inline const size_t TID  = getTID<DomInfo>();  // 唯一类型 ID
+        static inline const char*  NAME = "DomInfo";
 
         DomAnalyzer* domAnalyzer;  // 支配分析器指针
 
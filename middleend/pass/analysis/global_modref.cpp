@@ -0,0 +1,48 @@
+#include <middleend/pass/analysis/global_modref.h>
+#include <middleend/visitor/utils/licm_visitor.h>
+
+namespace ME::Analysis
+{
+    void GlobalModRef::build(Module& module, const CallGraph& cg)
+    {
+        immutableGlobals.clear();
+
+        // 模块外函数可能修改任何全局变量，保守地视为全部可变
+        if (cg.hasExternalCalls()) return;
+
+        // 先假设所有全局变量不可变，再排除被 store 写入的
+        for (auto* glb : module.globalVars)
+        {
+            if (glb) immutableGlobals.insert(glb->name);
+        }
+
+        LICMGlobalStoreVisitor storeVisitor;
+        for (auto* function : module.functions)
+        {
+            if (!function) continue;
+            for (auto& [id, block] : function->blocks)
+            {
+                for (auto* inst : block->insts)
+                {
+                    Operand* globalOp = apply(storeVisitor, *inst);
+                    if (!globalOp || globalOp->getType() != OperandType::GLOBAL) continue;
+                    immutableGlobals.erase(static_cast<GlobalOperand*>(globalOp)->name);
+                }
+            }
+        }
+    }
+
+    template <>
+    GlobalModRef* Manager::get<GlobalModRef>(Module& module)
+    {
+        if (auto* cached = getCached<GlobalModRef>(module)) return cached;
+
+        auto* cg = get<CallGraph>(module);
+
+        auto* modRef = new GlobalModRef();
+        modRef->build(module, *cg);
+        addDependency<GlobalModRef, CallGraph>();
+        cache<GlobalModRef>(module, modRef);
+        return modRef;
+    }
+}  // namespace ME::Analysis
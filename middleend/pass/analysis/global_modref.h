@@ -0,0 +1,38 @@
+#ifndef __INTERFACES_MIDDLEEND_ANALYSIS_GLOBAL_MODREF_H__
+#define __INTERFACES_MIDDLEEND_ANALYSIS_GLOBAL_MODREF_H__
+
+#include <middleend/pass/analysis/analysis_manager.h>
+#include <middleend/pass/analysis/call_graph.h>
+#include <string>
+#include <unordered_set>
+
+/*
+ * 全局变量读写 (GlobalModRef) 分析，模块级
+ * - 通过 Analysis::AM.get<GlobalModRef>(module) 构建并缓存，依赖 CallGraph。
+ * - 收集模块中被 store 写入过的全局变量；只要存在对模块外函数的调用，就保守地认为所有全局变量都可能被修改。
+ * - isImmutable(name) 为真的全局变量在整个程序运行期间保持初值，其 load 可以跨调用外提。
+ * - 增删 store/call 指令的 Pass 不能保留该分析。
+ */
+
+namespace ME::Analysis
+{
+    class GlobalModRef
+    {
+      public:
+        static inline const size_t TID  = getTID<GlobalModRef>();  // 唯一类型 ID
+        static inline const char*  NAME = "GlobalModRef";
+
+      private:
+        std::unordered_set<std::string> immutableGlobals;  // 从未被写入的全局变量
+
+      public:
+        void build(Module& module, const CallGraph& cg);
+
+        bool isImmutable(const std::string& name) const { return immutableGlobals.count(name); }
+    };
+
+    template <>
+    GlobalModRef* Manager::get<GlobalModRef>(Module& module);
+}  // namespace ME::Analysis
+
+#endif  // __INTERFACES_MIDDLEEND_ANALYSIS_GLOBAL_MODREF_H__
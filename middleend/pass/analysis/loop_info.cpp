@@ -259,8 +259,9 @@ namespace ME::Analysis
         // 构建 LoopInfo
         auto* loopInfo = new LoopInfo();
         loopInfo->build(*cfg, *dom);
+        addDependency<LoopInfo, CFG>();
+        addDependency<LoopInfo, DomInfo>();
         cache<LoopInfo>(func, loopInfo);
-        registerDeleter<LoopInfo>();
         return loopInfo;
     }
 }  // namespace ME::Analysis
@@ -49,7 +49,8 @@ namespace ME::Analysis
     class LoopInfo
     {
       public:
-        static inline const size_t TID = getTID<LoopInfo>();  // 唯一类型 ID
+        static inline const size_t TID  = getTID<LoopInfo>();  // 唯一类型 ID
+        static inline const char*  NAME = "LoopInfo";
 
       public:
         LoopInfo();
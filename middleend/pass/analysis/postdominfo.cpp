@@ -57,6 +57,7 @@ namespace ME::Analysis
 
         auto* postDomInfo = new PostDomInfo();
         postDomInfo->build(*cfg);
+        addDependency<PostDomInfo, CFG>();
         cache<PostDomInfo>(func, postDomInfo);
         return postDomInfo;
     }
@@ -11,7 +11,8 @@ namespace ME::Analysis
     class PostDomInfo
     {
       public:
-        static inline const size_t TID = getTID<PostDomInfo>();  // 唯一类型 ID
+        static inline const size_t TID  = getTID<PostDomInfo>();  // 唯一类型 ID
+        static inline const char*  NAME = "PostDomInfo";
 
         DomAnalyzer* postDomAnalyzer;  // 后支配分析器指针
 
@@ -5,35 +5,42 @@
 #include <middleend/pass/analysis/analysis_manager.h>
 #include <middleend/pass/analysis/cfg.h>
 #include <middleend/pass/analysis/dominfo.h>
+#include <middleend/pass/analysis/def_use.h>
 #include <middleend/visitor/utils/operand_replace_visitor.h>
-#include <middleend/visitor/utils/use_def_visitor.h>
 #include <middleend/visitor/utils/expr_key_visitor.h>
 #include <transfer.h>
-#include <deque>
+#include <utils/indexed_map.h>
 #include <unordered_map>
 #include <unordered_set>
 
 namespace ME
 {
-    void CSEPass::runOnFunction(Function& function)
+    Analysis::PreservedAnalyses CSEPass::runOnFunction(Function& function)
     {
         // CSE（Common Subexpression Elimination）：
         // - 跨块 CSE：沿支配树 DFS，在支配路径上维护“表达式 -> 已有值”的映射
         // - 同时做一个轻量的“隐式 CSE”：当条件寄存器值可确定时，将条件分支改写为无条件跳转
         // - 删除被替代的冗余指令，并对剩余指令做操作数替换
-        bool changed = runDominatorCSE(function);
+        bool branchFolded = false;
+        bool changed      = runDominatorCSE(function, branchFolded);
         // changed |= runBlockLocalCSE(function);
-        if (changed) Analysis::AM.invalidate(function);
+        if (!changed) return Analysis::PreservedAnalyses::all();
+        // 改写了分支则 CFG 改变；否则只删除了纯计算指令，def-use 链已同步维护
+        if (branchFolded) return Analysis::PreservedAnalyses::none().preserveModuleAnalyses();
+        return Analysis::PreservedAnalyses::none()
+            .preserveCFGAnalyses()
+            .preserve<Analysis::DefUse>()
+            .preserveModuleAnalyses();
     }
 
     // 对于跨块的cse，需要考虑支配关系和控制流
     // 使用支配树进行深度优先遍历，在遍历过程中维护表达式-值映射表
-    bool CSEPass::runDominatorCSE(Function& function)
+    bool CSEPass::runDominatorCSE(Function& function, bool& branchFolded)
     {
-        Analysis::AM.invalidate(function);
         auto* cfg = Analysis::AM.get<Analysis::CFG>(function);
         auto* dom = Analysis::AM.get<Analysis::DomInfo>(function);
         if (!cfg || !dom || cfg->id2block.empty()) return false;
+        auto* defUse = Analysis::AM.get<Analysis::DefUse>(function);
 
         bool                                      changed = false;
         const auto&                               domTree = dom->getDomTree();
@@ -44,24 +51,18 @@ namespace ME
         // eraseSet：记录可以删除的冗余指令（其结果会被已有值替换）
         std::unordered_set<Instruction*> eraseSet;
 
-        // replaceRegs：reg -> operand，表示 “这个寄存器的值等价于另一个值”，用于后续改写操作数
-        // 在遍历过程中动态维护
-        std::unordered_map<size_t, Operand*> replaceRegs;
-        OperandReplaceVisitor                replacer(replaceRegs);
-
-        std::unordered_set<size_t> visited;     // 记录已访问的基本块，防止重复访问
-        ExprKeyVisitor             keyVisitor;  // 获取指令的key
+        DenseSet       visited(function.getMaxLabel());  // 记录已访问的基本块，防止重复访问
+        ExprKeyVisitor keyVisitor;                       // 获取指令的key
 
 
         // 隐式CSE：记录已知条件值 (寄存器号 -> true/false)
         // 当跳转到一个新块的时候，如果该块只有一个前驱且该前驱是条件分支，
         // 则可以根据跳转方向推导出条件寄存器的值
-        std::unordered_map<size_t, bool> knownConditions;
+        IndexedMap<char> knownConditions(function.getMaxReg());
 
         std::function<void(size_t)> dfs = [&](size_t blockId) {
             // 沿支配树做 DFS，保证当访问某块时：它的支配者块都已被访问并建立了 exprMap
-            if (visited.count(blockId)) return;
-            visited.insert(blockId);
+            if (!visited.insert(blockId)) return;
             // 获取当前基本块
             Block* block = function.getBlock(blockId);
             if (!block) return;
@@ -73,8 +74,7 @@ namespace ME
 
             for (auto* inst : block->insts)
             {
-                // 先做一次“已知等价寄存器”的替换，避免 key 受旧寄存器干扰
-                if (!replaceRegs.empty()) { apply(replacer, *inst); }
+                // 冗余指令的结果在发现时已沿 def-use 链替换，这里看到的操作数总是最新的等价值
 
                 // 隐式CSE：检查条件分支是否使用已知条件
                 // 如果当前指令是条件分支指令，且条件寄存器的值已知，则替换为无条件跳转
@@ -83,12 +83,11 @@ namespace ME
                     if (brCond->cond && brCond->cond->getType() == OperandType::REG)
                     {
                         size_t condReg = brCond->cond->getRegNum();
-                        auto   it      = knownConditions.find(condReg);
-                        if (it != knownConditions.end())
+                        if (const char* known = knownConditions.lookup(condReg))
                         {
                             // 条件值已知，替换为常量并转为无条件跳转
-                            Operand* target  = it->second ? brCond->trueTar : brCond->falseTar;
-                            Operand* skipped = it->second ? brCond->falseTar : brCond->trueTar;
+                            Operand* target  = *known ? brCond->trueTar : brCond->falseTar;
+                            Operand* skipped = *known ? brCond->falseTar : brCond->trueTar;
                             auto*    newBr   = new BrUncondInst(target);
 
                             // 从被跳过的目标块的PHI节点中移除当前块的引用
@@ -102,7 +101,10 @@ namespace ME
                                     {
                                         if (phiInst->opcode != Operator::PHI) break;
                                         auto* phi = static_cast<PhiInst*>(phiInst);
+                                        // 删除 incoming 会使其槽位失效，先注销再重新登记
+                                        defUse->removeInst(phi);
                                         phi->incomingVals.erase(curLabel);
+                                        defUse->addInst(phi, skippedBlock);
                                     }
                                 }
                             }
@@ -110,7 +112,8 @@ namespace ME
                             // 用新指令替换旧指令
                             eraseSet.insert(inst);
                             block->insts.push_back(newBr);
-                            changed = true;
+                            defUse->addInst(newBr, block);
+                            changed = branchFolded = true;
                             continue;
                         }
                     }
@@ -122,19 +125,18 @@ namespace ME
                 if (keyVisitor.result.empty()) continue;
 
                 // 只有定义了寄存器结果的指令才有替换意义
-                DefCollector defCollector;
-                apply(defCollector, *inst);
-                size_t defReg = defCollector.getResult();
-                if (defReg == 0) continue;
+                Operand* def = inst->getDefOperand();
+                if (!def || def->getType() != OperandType::REG) continue;
+                size_t defReg = def->getRegNum();
 
                 // 查询当前支配路径上是否已有等价表达式：
-                // - 若存在：当前指令冗余，用已有值替换 defReg，并删除当前指令
+                // - 若存在：当前指令冗余，用已有值替换 defReg 的全部使用，并删除当前指令
                 // - 若不存在：将本指令结果加入 exprMap，使其对支配子树可用
                 auto found = exprMap.find(keyVisitor.result);
                 if (found != exprMap.end())
                 {
-                    // 更新映射至新的操作数
-                    replaceRegs[defReg] = found->second;
+                    // 沿 def-use 链改写所有使用点，代价只与使用数相关
+                    defUse->replaceAllUsesWith(defReg, found->second);
                     eraseSet.insert(inst);
                     changed = true;
                     continue;
@@ -214,30 +216,13 @@ namespace ME
 
         dfs(0);
 
-        // 先删冗余指令，避免后续 finalReplacer 遇到悬挂指令指针
-        if (!eraseSet.empty())
-        {
-            // 根据eraseSet，构造新的指令列表
-            for (auto& [id, block] : function.blocks)
-            {
-                std::deque<Instruction*> newInsts;
-                for (auto* inst : block->insts)
-                {
-                    if (eraseSet.count(inst)) { delete inst; }
-                    else { newInsts.push_back(inst); }
-                }
-                block->insts = newInsts;
-            }
-        }
-
-        // 如果有替换，进行最终替换
-        if (!replaceRegs.empty())
+        // 删除冗余指令，其使用点已在遍历过程中改写完毕
+        // 指令所在块由 def-use 链给出，直接从链表中摘除
+        for (auto* inst : eraseSet)
         {
-            OperandReplaceVisitor finalReplacer(replaceRegs);
-            for (auto& [id, block] : function.blocks)
-            {
-                for (auto* inst : block->insts) { apply(finalReplacer, *inst); }
-            }
+            defUse->getBlock(inst)->insts.remove(inst);
+            defUse->removeInst(inst);
+            delete inst;
         }
         return changed;
     }
@@ -248,17 +233,8 @@ namespace ME
     {
         bool changed = false;
 
-        // 记录每一条指令对应的块，以及使用某个寄存器的指令列表
-        std::unordered_map<Instruction*, size_t> inst2block;
-        UserCollector                            userCollector;
-        for (auto& [id, block] : function.blocks)
-        {
-            for (auto* inst : block->insts)
-            {
-                inst2block[inst] = id;
-                apply(userCollector, *inst);
-            }
-        }
+        // 指令所在块与寄存器的使用者都由 def-use 链给出
+        auto* defUse = Analysis::AM.get<Analysis::DefUse>(function);
 
         for (auto& [id, block] : function.blocks)
         {
@@ -270,33 +246,37 @@ namespace ME
             std::unordered_map<std::string, Operand*> exprMap;
             ExprKeyVisitor                            keyVisitor;
 
-            // 新建指令列表
-            std::deque<Instruction*> newInsts;
-
-            for (auto* inst : block->insts)
+            for (auto it = block->insts.begin(); it != block->insts.end();)
             {
+                Instruction* inst = *it;
+
                 // 尝试进行替换
-                if (!replaceRegs.empty()) apply(replacer, *inst);
+                if (!replaceRegs.empty())
+                {
+                    // 块内替换直接改写操作数，先注销再重新登记，保持 def-use 链有效
+                    defUse->removeInst(inst);
+                    apply(replacer, *inst);
+                    defUse->addInst(inst, block);
+                }
 
                 // 获取指令对应的key值
                 keyVisitor.result.clear();
                 apply(keyVisitor, *inst);
 
-                // 非 CSE 候选指令直接加入新指令列表
+                // 非 CSE 候选指令保留
                 if (keyVisitor.result.empty())
                 {
-                    newInsts.push_back(inst);
+                    ++it;
                     continue;
                 }
 
                 // 获取指令定义的新值的寄存器编号
-                DefCollector defCollector;
-                apply(defCollector, *inst);
-                size_t defReg = defCollector.getResult();
+                Operand* def    = inst->getDefOperand();
+                size_t   defReg = def && def->getType() == OperandType::REG ? def->getRegNum() : 0;
                 if (defReg == 0)
                 {
-                    // 没有定义值的指令直接加入新指令列表
-                    newInsts.push_back(inst);
+                    // 没有定义值的指令保留
+                    ++it;
                     continue;
                 }
 
@@ -306,26 +286,24 @@ namespace ME
                 {
                     // 如果有等价表达式，检查是否有块外使用
                     bool externalUse = false;
-                    auto uit         = userCollector.userMap.find(defReg);
-                    if (uit != userCollector.userMap.end())
+                    for (auto& use : defUse->getUses(defReg))
                     {
-                        for (auto* useInst : uit->second)
+                        Block* useBlock = defUse->getBlock(use.user);
+                        if (useBlock && useBlock != block)
                         {
-                            auto bit = inst2block.find(useInst);
-                            if (bit != inst2block.end() && bit->second != id)
-                            {
-                                // 块外使用了
-                                externalUse = true;
-                                break;
-                            }
+                            // 块外使用了
+                            externalUse = true;
+                            break;
                         }
                     }
 
                     // 更改映射至新的操作数
                     replaceRegs[defReg] = found->second;
-                    if (externalUse) { newInsts.push_back(inst); }
+                    if (externalUse) { ++it; }
                     else
                     {
+                        it = block->insts.erase(it);
+                        defUse->removeInst(inst);
                         delete inst;
                         changed = true;
                     }
@@ -334,9 +312,8 @@ namespace ME
 
                 // 没有等价表达式，记录下来
                 exprMap.emplace(std::move(keyVisitor.result), getRegOperand(defReg));
-                newInsts.push_back(inst);
+                ++it;
             }
-            block->insts = newInsts;
         }
         return changed;
     }
@@ -348,9 +325,9 @@ CSE 流程总结对应 dominator CSE ：
 1) 构建 CFG 与支配树，从入口块(0)沿支配树 DFS 遍历基本块。
 2) 维护 exprMap：在当前 DFS 支配路径上记录“表达式 key -> 已有结果 operand”。
 3) 逐指令处理：
-   - 先用 replaceRegs 做操作数替换，保证 key 计算基于最新等价值；
+   - 冗余指令的结果在发现时即沿 def-use 链替换，后续指令的 key 总是基于最新等价值；
    - 若遇到条件分支且条件值已知：改写为无条件跳转，并更新被跳过块的 Phi incoming；
-   - 为可消除指令生成 key：若 key 已在 exprMap 中出现，记录 defReg 替换并删除该指令；否则将其加入 exprMap。
+   - 为可消除指令生成 key：若 key 已在 exprMap 中出现，replaceAllUsesWith 改写 defReg 的使用并删除该指令；否则将其加入 exprMap。
 4) 递归访问支配子块，并在离开块时撤销本块新增的 exprMap/knownConditions 条目（使缓存只对支配子树有效）。
-5) 最后统一删除冗余指令，并对函数内剩余指令做一次全量寄存器替换。
+5) 最后统一删除冗余指令，无需再对整个函数做一次寄存器替换。
 */
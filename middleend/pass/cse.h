@@ -16,12 +16,13 @@ namespace ME
         CSEPass()  = default;
         ~CSEPass() = default;
 
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
         // 块内的cse
         bool runBlockLocalCSE(Function& function);
-        bool runDominatorCSE(Function& function);
+        // branchFolded 返回是否把条件分支改写成了无条件跳转（即 CFG 是否改变）
+        bool runDominatorCSE(Function& function, bool& branchFolded);
     };
 }  // namespace ME
 
@@ -1,72 +1,75 @@
 #include <middleend/pass/dce.h>
 #include <middleend/module/ir_block.h>
 #include <middleend/module/ir_operand.h>
-#include <middleend/visitor/utils/use_def_visitor.h>
+#include <middleend/pass/analysis/def_use.h>
 #include <algorithm>
+#include <unordered_set>
 
 namespace ME
 {
-    void DCEPass::runOnFunction(Function& function)
+    Analysis::PreservedAnalyses DCEPass::runOnFunction(Function& function)
     {
         // DCE（Dead Code Elimination）：
         // 以“结果寄存器无人使用”为判据，删除无副作用的死指令。
-        // 由于删除会让一些寄存器的 use 计数归零，需要迭代到收敛。
+        // 删除会让其操作数的 use 归零，沿 def-use 链把这些定义指令加入工作队列，一遍即可收敛。
+        if (!eliminateDeadCode(function)) return Analysis::PreservedAnalyses::all();
 
-        // 反复执行直到不再有改动
-        bool changed = true;
-        while (changed) { changed = eliminateDeadCode(function); }
+        // 只删除块内的非终结、无副作用指令：块间跳转与 call/store 均不变，def-use 链已同步维护
+        return Analysis::PreservedAnalyses::none()
+            .preserveCFGAnalyses()
+            .preserve<Analysis::DefUse>()
+            .preserveModuleAnalyses();
     }
 
     bool DCEPass::eliminateDeadCode(Function& function)
     {
-        std::map<size_t, int> useCounts;        // 寄存器使用次数   寄存器编号->使用次数
-        bool                  changed = false;  // 是否有改动
+        // def-use 链在删除过程中同步维护，Pass 结束后仍然有效
+        auto* defUse = Analysis::AM.get<Analysis::DefUse>(function);
 
-        // 1) 统计全函数的寄存器 use 次数
-        UseCollector useCollector(useCounts);
-        // 遍历所有指令，收集使用信息
+        // 判断指令是否为死指令：无副作用，定义了寄存器且该寄存器没有任何使用
+        auto isDead = [&](Instruction* inst) {
+            if (isSideEffect(inst)) return false;
+            Operand* def = inst->getDefOperand();
+            return def && def->getType() == OperandType::REG && !defUse->hasUses(def->getRegNum());
+        };
+
+        // 1) 初始工作队列：当前所有死指令
+        std::vector<Instruction*> worklist;
         for (auto& [id, block] : function.blocks)
         {
-            for (auto inst : block->insts) { apply(useCollector, *inst); }
+            for (auto inst : block->insts)
+            {
+                if (isDead(inst)) worklist.push_back(inst);
+            }
         }
+        if (worklist.empty()) return false;
 
-        // 2) 在线性遍历中删除死指令：
-        //    - 只删除“无副作用”指令
-        //    - 且该指令定义的寄存器 defReg 的 use 次数为 0
-        DefCollector defCollector;  // 用于获取指令定义的寄存器
-
-        for (auto& [id, block] : function.blocks)
+        // 2) 逐个删除：注销其使用后，检查操作数的定义指令是否随之变为死指令
+        // 死指令随即从所在块中 O(1) 摘除，全部处理完后统一释放
+        std::unordered_set<Instruction*> dead;
+        while (!worklist.empty())
         {
-            std::deque<Instruction*> newInsts;  // 新的指令列表
+            Instruction* inst = worklist.back();
+            worklist.pop_back();
+            if (!dead.insert(inst).second) continue;
 
-            for (auto inst : block->insts)
-            {
-                bool isDead = false;
-                if (!isSideEffect(inst))
-                {
-                    // 对于没有副作用的指令，检查其定义的寄存器是否被使用
-                    apply(defCollector, *inst);
-                    size_t defReg = defCollector.getResult();
-                    // 如果定义了寄存器且该寄存器未被使用，则为死指令
-                    if (defReg != 0 && useCounts[defReg] == 0)
-                    {
-                        isDead  = true;
-                        changed = true;
-                        delete inst;  // 删除死指令
-                    }
-                }
+            if (Block* block = defUse->getBlock(inst)) block->insts.remove(inst);
+            std::vector<Operand**> slots;
+            inst->getUseSlots(slots);
+            defUse->removeInst(inst);
 
-                if (!isDead)
-                {
-                    newInsts.push_back(inst);  // 保留非死指令
-                }
+            for (auto* slot : slots)
+            {
+                Operand* op = *slot;
+                if (!op || op->getType() != OperandType::REG) continue;
+                Instruction* def = defUse->getDef(op->getRegNum());
+                if (def && !dead.count(def) && isDead(def)) worklist.push_back(def);
             }
-
-            // 一次性替换整个指令列表（O(1) swap）
-            block->insts = newInsts;
         }
 
-        return changed;
+        for (auto* inst : dead) delete inst;
+
+        return true;
     }
 
     bool DCEPass::isSideEffect(Instruction* inst)
@@ -86,7 +89,7 @@ namespace ME
 
 /*
 DCE 流程总结（对应本文件实现）：
-1) 扫描全函数，统计每个寄存器的 use 次数。
-2) 遍历指令：若指令无副作用且其 def 寄存器 use 次数为 0，则删除该指令。
-3) 因为删除会减少其它寄存器的 use 次数，重复执行 1)-2) 直到不再发生删除。
+1) 借助 def-use 链找出所有“无副作用且 def 寄存器没有使用”的指令，作为初始工作队列。
+2) 删除队列中的指令并注销其使用；若某操作数的定义指令因此失去全部使用，也加入队列。
+3) 队列清空即收敛，最后统一从基本块中摘除死指令；def-use 链全程同步维护。
 */
@@ -17,7 +17,7 @@ namespace ME
         ~DCEPass() = default;
 
         // 运行DCE优化
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
         // 执行死代码消除，返回是否有改动
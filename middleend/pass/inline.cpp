@@ -5,7 +5,6 @@
 #include <middleend/visitor/utils/use_def_visitor.h>
 #include <middleend/pass/analysis/analysis_manager.h>
 #include <algorithm>
-#include <deque>
 #include <map>
 #include <set>
 
@@ -102,7 +101,7 @@ namespace ME
         }
         else if (auto* phi = dynamic_cast<PhiInst*>(inst))
         {
-            std::map<Operand*, Operand*> newIncoming;
+            PhiInst::IncomingMap newIncoming;
             for (auto& [label, val] : phi->incomingVals)
             {
                 // 遍历所有 incoming，重映射 label
@@ -158,35 +157,15 @@ namespace ME
         }
 
         // 在块内查找 call 指令，将指令分为 call 之前和 call 之后两部分
-        auto&                    insts = callBlock->insts;
-        std::deque<Instruction*> beforeCall;
-        std::deque<Instruction*> afterCallInsts;
-        bool                     found = false;
-        for (auto* inst : insts)
-        {
-            if (inst == callInst)
-            {
-                found = true;
-                continue;  // 跳过 call 指令本身
-            }
-            if (!found)
-            {
-                // 调用函数之前的指令
-                beforeCall.push_back(inst);
-            }
-            else
-            {
-                // 调用函数之后的指令
-                afterCallInsts.push_back(inst);
-            }
-        }
-        if (!found) return false;
+        auto& insts  = callBlock->insts;
+        auto  callIt = std::find(insts.begin(), insts.end(), static_cast<Instruction*>(callInst));
+        if (callIt == insts.end()) return false;
 
-        // 创建续接块 afterCall：承接 call 之后的原有指令序列
+        // 创建续接块 afterCall：承接 call 之后的原有指令序列（整段移动）
         Block* afterCall = caller.createBlock();
-        afterCall->insts = afterCallInsts;
-        // callBlock 只保留 call 之前的指令
-        callBlock->insts = beforeCall;
+        afterCall->insts.splice(afterCall->insts.end(), insts, std::next(callIt), insts.end());
+        // callBlock 只保留 call 之前的指令，call 指令本身摘除
+        insts.remove(callInst);
 
         // callBlock 被切分后，afterCall 继承了原先 callBlock 的"后继关系"
         // 需要将后继块里 phi 的 incoming label 从 callBlock 改为 afterCall
@@ -310,7 +289,7 @@ namespace ME
         return true;
     }
 
-    void InlinePass::runOnModule(Module& module)
+    Analysis::PreservedAnalyses InlinePass::runOnModule(Module& module)
     {
         // 模块级内联：
         // - 每轮分析调用图与代价信息
@@ -319,6 +298,7 @@ namespace ME
         module_ = &module;
         InlineStrategy strategy;
         bool           changed = true;
+        bool           inlined = false;
 
         while (changed)
         {
@@ -330,6 +310,8 @@ namespace ME
             for (auto* func : strategy.getProcessingOrder())
             {
                 if (!func) continue;
+                // 克隆出的寄存器与标签都在 caller 的操作数表中重新分配
+                OperandScope scope(module.constants, func);
 
                 // 预先收集待内联调用点（只记录指针）
                 // 内联过程中会切分块并移动指令，提前保存 (block, index) 容易失效
@@ -366,19 +348,23 @@ namespace ME
 
                     if (inlineCall(*func, foundBlock, call, *callee))
                     {
-                        changed = true;
+                        changed = inlined = true;
+                        // 后续轮次的代价统计要用到 caller 的 CFG/支配树，立即失效
                         Analysis::AM.invalidate(*func);
                     }
                 }
             }
         }
         module_ = nullptr;
+        // 被内联的 caller 已逐个失效，模块级的调用图随之改变
+        return inlined ? Analysis::PreservedAnalyses::none() : Analysis::PreservedAnalyses::all();
     }
 
-    void InlinePass::runOnFunction(Function& function)
+    Analysis::PreservedAnalyses InlinePass::runOnFunction(Function& function)
     {
         (void)function;
         // 内联作为模块级别的优化，不在函数级别执行任何操作
+        return Analysis::PreservedAnalyses::all();
     }
 }  // namespace ME
 
@@ -19,8 +19,8 @@ namespace ME
         InlinePass()  = default;
         ~InlinePass() = default;
 
-        void runOnModule(Module& module) override;
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnModule(Module& module) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
         std::map<size_t, Operand*> buildOperandMap(Function& caller, Function& callee, CallInst* callInst);
@@ -1,9 +1,10 @@
 #include <middleend/pass/licm.h>
 #include <middleend/pass/analysis/analysis_manager.h>
 #include <middleend/pass/analysis/loop_info.h>
+#include <middleend/pass/analysis/def_use.h>
+#include <middleend/pass/analysis/global_modref.h>
 #include <middleend/module/ir_operand.h>
 #include <middleend/visitor/utils/licm_visitor.h>
-#include <middleend/visitor/utils/operand_replace_visitor.h>
 #include <middleend/visitor/utils/use_def_visitor.h>
 #include <deque>
 
@@ -38,30 +39,20 @@
 */
 namespace ME
 {
-    // 模块级别的 LICM 优化入口
-    // 功能：对整个模块进行循环不变量外提优化
-    // 实现思路：
-    // 1. 首先收集所有不可变的全局变量（用于判断全局变量 load 是否可以外提）
-    // 2. 然后对模块中的每个函数分别进行 LICM 优化
-    void LICMPass::runOnModule(Module& module)
-    {
-        collectImmutableGlobals(module);
-        for (auto* function : module.functions) runOnFunctionImpl(*function);
-    }
+    // 模块级准备：从分析管理器取得全局变量读写信息（用于判断全局变量 load 是否可以跨调用外提）
+    // 外提只移动 load 与标量指令，不增删 store/call，模块级分析在整个过程中保持有效
+    void LICMPass::doInitialization(Module& module) { modRef = Analysis::AM.get<Analysis::GlobalModRef>(module); }
 
-    // 函数级别的 LICM 优化入口
-    // 功能：对单个函数进行循环不变量外提优化
-    // 实现思路：直接调用核心实现函数 runOnFunctionImpl
-    void LICMPass::runOnFunction(Function& function) { runOnFunctionImpl(function); }
+    void LICMPass::doFinalization(Module& module) { modRef = nullptr; }
 
     // LICM (Loop Invariant Code Motion) 优化的核心函数
     // 对给定函数中的所有循环进行循环不变量外提优化
-    void LICMPass::runOnFunctionImpl(Function& function)
+    Analysis::PreservedAnalyses LICMPass::runOnFunction(Function& function)
     {
         // 步骤 1: 基本检查
         // 如果函数没有定义或没有基本块，直接返回
-        if (!function.funcDef) return;
-        if (function.blocks.empty()) return;
+        if (!function.funcDef) return Analysis::PreservedAnalyses::all();
+        if (function.blocks.empty()) return Analysis::PreservedAnalyses::all();
 
         // 步骤 2: 获取必要的分析结果
         // cfg: 控制流图 (Control Flow Graph)，用于分析基本块之间的跳转关系
@@ -69,7 +60,7 @@ namespace ME
         //      支配关系用于确保外提的指令在循环的所有执行路径上都可用
         auto* cfg = Analysis::AM.get<Analysis::CFG>(function);
         auto* dom = Analysis::AM.get<Analysis::DomInfo>(function);
-        if (!cfg || !dom) return;
+        if (!cfg || !dom) return Analysis::PreservedAnalyses::all();
         
         // imm_dom: 直接支配者数组，imm_dom[i] 表示基本块 i 的直接支配者
         // 用于快速判断一个基本块是否支配另一个基本块
@@ -79,22 +70,12 @@ namespace ME
         // loopInfo: 循环信息分析结果，包含函数中所有检测到的循环
         // 如果函数中没有循环，则无需进行 LICM 优化
         auto* loopInfo = Analysis::AM.get<Analysis::LoopInfo>(function);
-        if (!loopInfo || loopInfo->getNumLoops() == 0) return;
-
-        // 步骤 4: 建立 def-use 索引，便于后续判断循环不变量
-        // regDefs: 寄存器定义映射，regDefs[regId] = 定义该寄存器的指令
-        //          用于快速查找某个寄存器是由哪条指令定义的
-        // regDefBlock: 寄存器定义所在的基本块映射，regDefBlock[regId] = 定义该寄存器的基本块 ID
-        //              用于判断寄存器定义是否在循环内
-        // instBlock: 指令所在的基本块映射，instBlock[inst] = 该指令所在的基本块 ID
-        //            用于快速查找指令位于哪个基本块
-        // userMap: 寄存器使用映射，userMap[regId] = 使用该寄存器的所有指令列表
-        //          用于快速查找哪些指令使用了某个寄存器
-        std::unordered_map<size_t, Instruction*>    regDefs;
-        std::unordered_map<size_t, size_t>          regDefBlock;
-        std::unordered_map<Instruction*, size_t>    instBlock;
-        std::map<size_t, std::vector<Instruction*>> userMap;
-        buildDefUseMaps(function, regDefs, regDefBlock, instBlock, userMap);
+        if (!loopInfo || loopInfo->getNumLoops() == 0) return Analysis::PreservedAnalyses::all();
+
+        // 步骤 4: 获取 def-use 链，便于后续判断循环不变量
+        // defUse: 提供寄存器的定义指令及其所在块（判断定义是否在循环内）、
+        //         指令所在块、寄存器的所有使用点；外提过程中同步维护，多个循环之间无需重建
+        auto* defUse = Analysis::AM.get<Analysis::DefUse>(function);
         
         // changed: 标记函数是否被修改，如果进行了优化，需要标记为 true
         //          以便后续使分析结果失效（因为 CFG 可能改变）
@@ -151,12 +132,10 @@ namespace ME
             // invariantRegs: 循环不变量寄存器集合，包含所有循环不变量的寄存器 ID
             //                用于快速判断某个寄存器是否为循环不变量
             std::set<Instruction*> invariantInsts;
-            std::set<size_t>       invariantRegs;
+            DenseSet               invariantRegs(function.getMaxReg());
             collectInvariantInsts(function,
                 loop,                    // 当前循环
-                regDefBlock,            // 寄存器定义所在的基本块映射
-                userMap,                // 寄存器使用映射
-                instBlock,              // 指令所在的基本块映射
+                *defUse,                // def-use 链
                 imm_dom,                // 直接支配者数组
                 restrictHeader,         // 是否限制只提升头块的标量不变量
                 loopStoreGlobals,       // 循环内被写入的全局变量集合
@@ -173,7 +152,7 @@ namespace ME
             //            如果循环没有 preheader，需要创建一个
             // cfgChanged: 标记 CFG 是否被修改（如果创建了新的 preheader，CFG 会改变）
             bool   cfgChanged = false;
-            Block* preheader = getOrCreatePreheader(function, cfg, loop, cfgChanged);
+            Block* preheader = getOrCreatePreheader(function, cfg, loop, *defUse, cfgChanged);
             if (!preheader) continue;  // 如果无法创建 preheader，跳过当前循环
             if (cfgChanged) changed = true;  // 如果 CFG 被修改，标记函数已改变
 
@@ -188,88 +167,14 @@ namespace ME
             // 步骤 5.6: 执行外提操作
             // 将循环不变量指令按照 hoistOrder 的顺序移动到 preheader 中
             // 这需要更新指令所在的基本块，并确保支配关系正确
-            hoistInstructions(preheader, hoistOrder, instBlock, regDefBlock, function, loop, imm_dom);
+            hoistInstructions(preheader, hoistOrder, *defUse, function, loop, imm_dom);
             changed = true;  // 标记函数已被修改
         }
 
-        // 步骤 6: 如果函数被修改，使分析结果失效
-        // 因为外提操作可能改变了 CFG 或其他分析结果，需要重新计算
-        if (changed) Analysis::AM.invalidate(function);
-    }
-
-    void LICMPass::collectImmutableGlobals(Module& module)
-    {
-        // 步骤 1: 初始化 - 清空不可变全局变量集合
-        immutableGlobals.clear();
-
-        // 步骤 2: 初始假设 - 将所有全局变量都标记为不可变
-        // 这是一个乐观的假设：我们假设所有全局变量在循环执行期间不会被修改
-        // 后续步骤会逐步排除那些被写入的全局变量
-        for (auto* glb : module.globalVars)
-        {
-            if (glb) immutableGlobals.insert(glb->name);
-        }
-
-        // 步骤 3: 收集所有已定义的函数名
-        // 用于后续判断函数调用是内部函数还是外部函数
-        // 内部函数：在当前模块中有定义，我们可以分析其行为
-        // 外部函数：未定义，可能修改任何全局变量，需要保守处理
-        std::unordered_set<std::string> definedFuncs;
-        for (auto* function : module.functions)
-        {
-            if (function && function->funcDef) definedFuncs.insert(function->funcDef->funcName);
-        }
-
-        // 步骤 4: 查找所有对全局变量的 store 操作
-        // 如果某个全局变量被写入（store），说明它是可变的，不能外提
-        // 需要从不可变集合中移除
-        LICMGlobalStoreVisitor storeVisitor;
-        for (auto* function : module.functions)
-        {
-            if (!function) continue;
-            for (auto& [id, block] : function->blocks)
-            {
-                for (auto* inst : block->insts)
-                {
-                    if (!inst) continue;
-                    // 检查当前指令是否是对全局变量的 store 操作
-                    Operand* globalOp = apply(storeVisitor, *inst);
-                    if (!globalOp) continue;  // 不是 store 或不是全局变量
-                    if (globalOp->getType() != OperandType::GLOBAL) continue;
-                    // 找到被写入的全局变量，从不可变集合中移除
-                    auto* g = static_cast<GlobalOperand*>(globalOp);
-                    immutableGlobals.erase(g->name);
-                    continue;
-                }
-            }
-        }
-
-        // 步骤 5: 检查是否有调用未知外部函数的情况
-        // 如果调用了外部函数（未在当前模块中定义），我们无法分析其行为
-        // 保守地认为所有全局变量都可能被外部函数修改
-        // 因此清空不可变集合，避免错误的外提优化
-        for (auto* function : module.functions)
-        {
-            if (!function) continue;
-            for (auto& [id, block] : function->blocks)
-            {
-                for (auto* inst : block->insts)
-                {
-                    auto* call = dynamic_cast<CallInst*>(inst);
-                    if (!call) continue;  // 不是函数调用指令
-                    // 检查调用的函数是否在当前模块中定义
-                    if (definedFuncs.find(call->funcName) != definedFuncs.end()) continue;
-                    // 调用了外部函数，保守处理：清空所有不可变全局变量
-                    // 因为外部函数可能修改任何全局变量
-                    immutableGlobals.clear();
-                    return;
-                }
-            }
-        }
-        // 如果执行到这里，说明：
-        // 1. 所有全局变量的 store 操作都已检查完毕
-        // 2. 没有调用未知的外部函数
-        // immutableGlobals 中剩余的全局变量就是真正不可变的，可以安全外提
+        // 步骤 6: 告知调用者哪些分析结果仍然有效，由调用者负责失效
+        if (!changed) return Analysis::PreservedAnalyses::all();
+        // 插入了 preheader，CFG 及其上的分析全部作废；未增删 store/call，模块级分析仍然有效
+        return Analysis::PreservedAnalyses::none().preserveModuleAnalyses();
     }
 
     //判断基本块dom是否支配node
@@ -324,9 +229,11 @@ namespace ME
     //   - function: 当前函数
     //   - cfg: 控制流图
     //   - loop: 循环信息
+    //   - defUse: def-use 链（登记新建的指令）
     //   - cfgChanged: 输出参数，如果创建了新块则设为 true
     // 返回：preheader 块的指针，如果无法创建则返回 nullptr
-    Block* LICMPass::getOrCreatePreheader(Function& function, Analysis::CFG* cfg, Analysis::Loop& loop, bool& cfgChanged)
+    Block* LICMPass::getOrCreatePreheader(
+        Function& function, Analysis::CFG* cfg, Analysis::Loop& loop, Analysis::DefUse& defUse, bool& cfgChanged)
     {
         size_t headerId = loop.header;
 
@@ -359,12 +266,13 @@ namespace ME
         Block* preheader = function.createBlock();
         preheader->setComment("licm.preheader");  // 添加注释，用于后续识别
         preheader->insts.push_back(new BrUncondInst(getLabelOperand(headerId)));  // preheader 直接跳到 header
+        defUse.addInst(preheader->insts.back(), preheader);
 
         // 修改所有外部前驱的终结指令，使它们跳到新的 preheader 块
         redirectPredsToPreheader(function, predsOutside, headerId, preheader->blockId);
 
         // 更新 header 的 phi 节点，把来自外部前驱的 incoming，替换为 preheader
-        updateHeaderPhis(function, function.getBlock(headerId), predsOutside, preheader->blockId);
+        updateHeaderPhis(function, function.getBlock(headerId), predsOutside, preheader->blockId, defUse);
 
         // 标记 CFG 已经发生变化
         cfgChanged = true;
@@ -412,8 +320,9 @@ namespace ME
     //   - header: 循环头块指针
     //   - predsOutside: 外部前驱块的 ID 集合
     //   - preheaderId: preheader 块的 ID
-    void LICMPass::updateHeaderPhis(
-        Function& function, Block* header, const std::set<size_t>& predsOutside, size_t preheaderId)
+    //   - defUse: def-use 链（Phi 的 incoming 改变后重新登记）
+    void LICMPass::updateHeaderPhis(Function& function, Block* header, const std::set<size_t>& predsOutside,
+        size_t preheaderId, Analysis::DefUse& defUse)
     {
         if (!header) return;
         Operand* newLabel  = getLabelOperand(preheaderId);
@@ -436,11 +345,14 @@ namespace ME
             }
 
             if (moved.empty()) continue;
+            // 删除 incoming 会使其槽位失效，先注销再重新登记
+            defUse.removeInst(phi);
             for (auto& item : moved) phi->incomingVals.erase(item.first);
 
             if (predsOutside.size() == 1)
             {
                 phi->addIncoming(moved.front().second, newLabel);
+                defUse.addInst(phi, header);
                 continue;
             }
 
@@ -449,6 +361,7 @@ namespace ME
             for (auto& item : moved) newPhi->addIncoming(item.second, item.first);
             preheaderPhis.push_back(newPhi);
             phi->addIncoming(newRes, newLabel);
+            defUse.addInst(phi, header);
         }
 
         if (preheaderPhis.empty()) return;
@@ -460,7 +373,11 @@ namespace ME
             preheader->insts.pop_back();
         }
 
-        for (auto* inst : preheaderPhis) preheader->insts.push_back(inst);
+        for (auto* inst : preheaderPhis)
+        {
+            preheader->insts.push_back(inst);
+            defUse.addInst(inst, preheader);
+        }
         if (terminator) preheader->insts.push_back(terminator);
     }
 
@@ -484,47 +401,6 @@ namespace ME
         return succs.front() == headerId;
     }
 
-    // 构建 def-use 映射关系
-    // 功能：建立函数中所有指令的定义-使用关系索引，用于快速查找寄存器定义和使用
-    // 实现思路：
-    // 1. 遍历函数中所有基本块和指令
-    // 2. 记录每条指令所在的基本块（instBlock）
-    // 3. 对于每条定义寄存器的指令，记录寄存器到指令的映射（regDefs）和寄存器到基本块的映射（regDefBlock）
-    // 4. 使用访问者模式收集所有寄存器的使用情况（userMap）
-    // 参数：
-    //   - function: 当前函数
-    //   - regDefs: 输出参数，寄存器 ID 到定义指令的映射
-    //   - regDefBlock: 输出参数，寄存器 ID 到定义所在基本块 ID 的映射
-    //   - instBlock: 输出参数，指令到所在基本块 ID 的映射
-    //   - userMap: 输出参数，寄存器 ID 到使用该寄存器的指令列表的映射
-    void LICMPass::buildDefUseMaps(Function& function, std::unordered_map<size_t, Instruction*>& regDefs,
-        std::unordered_map<size_t, size_t>& regDefBlock, std::unordered_map<Instruction*, size_t>& instBlock,
-        std::map<size_t, std::vector<Instruction*>>& userMap)
-    {
-        UserCollector userCollector;
-
-        for (auto& [id, block] : function.blocks)
-        {
-            for (auto* inst : block->insts)
-            {
-                instBlock[inst] = id;
-
-                DefCollector defCollector;
-                apply(defCollector, *inst);
-                size_t defReg = defCollector.getResult();
-                if (defReg != 0)
-                {
-                    regDefs[defReg]     = inst;
-                    regDefBlock[defReg] = id;
-                }
-
-                apply(userCollector, *inst);
-            }
-        }
-
-        userMap = userCollector.userMap;
-    }
-
     // 判断操作数（寄存器）是否为循环不变量
     // 功能：检查寄存器 reg 是否为循环不变量（在循环外定义或已被判定为不变量）
     // 实现思路：
@@ -534,31 +410,26 @@ namespace ME
     // 参数：
     //   - reg: 寄存器 ID
     //   - loop: 循环信息
-    //   - regDefBlock: 寄存器定义所在基本块的映射
+    //   - defUse: def-use 链
     //   - invariantRegs: 已判定的循环不变量寄存器集合
     // 返回：如果寄存器是循环不变量，返回 true；否则返回 false
-    bool LICMPass::isLoopInvariantOperand(size_t reg, const Analysis::Loop& loop,
-        const std::unordered_map<size_t, size_t>& regDefBlock, const std::set<size_t>& invariantRegs) const
+    bool LICMPass::isLoopInvariantOperand(size_t reg, const Analysis::Loop& loop, const Analysis::DefUse& defUse,
+        const DenseSet& invariantRegs) const
     {
-        if (invariantRegs.find(reg) != invariantRegs.end()) return true;
+        if (invariantRegs.count(reg)) return true;
 
-        auto defIt = regDefBlock.find(reg);
-        if (defIt == regDefBlock.end()) return true;
-        return !loop.contains(defIt->second);
+        // 函数参数等没有定义指令的寄存器视为不变量
+        Block* defBlock = defUse.getDefBlock(reg);
+        if (!defBlock) return true;
+        return !loop.contains(defBlock->blockId);
     }
 
     //判定变量是否在循环外被使用
-    bool LICMPass::areUsesInsideLoop(size_t defReg, const Analysis::Loop& loop,
-        const std::map<size_t, std::vector<Instruction*>>& userMap,
-        const std::unordered_map<Instruction*, size_t>&    instBlock) const
+    bool LICMPass::areUsesInsideLoop(size_t defReg, const Analysis::Loop& loop, const Analysis::DefUse& defUse) const
     {
-        auto it = userMap.find(defReg);
-        if (it == userMap.end()) return true;
-
-        for (auto* userInst : it->second)
+        for (auto& use : defUse.getUses(defReg))
         {
-            auto blockIt = instBlock.find(userInst);
-            if (blockIt == instBlock.end()) continue;
+            if (!defUse.getBlock(use.user)) continue;
             // 使用出现在循环外也是允许的，预头块定义能支配后续出口
         }
         return true;
@@ -575,18 +446,14 @@ namespace ME
     // 参数：
     //   - inst: 要检查的指令
     //   - loop: 循环信息
-    //   - regDefBlock: 寄存器定义所在基本块的映射
+    //   - defUse: def-use 链（寄存器定义所在块、使用点、指令所在块）
     //   - invariantRegs: 已判定的循环不变量寄存器集合
-    //   - userMap: 寄存器使用映射
-    //   - instBlock: 指令所在基本块的映射
     //   - imm_dom: 直接支配者数组
     //   - loopStoreGlobals: 循环内被写入的全局变量集合
     //   - loopHasCall: 循环内是否存在函数调用
     // 返回：如果指令是循环不变量，返回 true；否则返回 false
-    bool LICMPass::isInvariantInst(Instruction* inst, const Analysis::Loop& loop,
-        const std::unordered_map<size_t, size_t>& regDefBlock, const std::set<size_t>& invariantRegs,
-        const std::map<size_t, std::vector<Instruction*>>& userMap,
-        const std::unordered_map<Instruction*, size_t>& instBlock, const std::vector<int>& imm_dom,
+    bool LICMPass::isInvariantInst(Instruction* inst, const Analysis::Loop& loop, const Analysis::DefUse& defUse,
+        const DenseSet& invariantRegs, const std::vector<int>& imm_dom,
         const std::set<Operand*>& loopStoreGlobals, bool loopHasCall) const
     {
         if (!inst) return false;
@@ -600,7 +467,7 @@ namespace ME
             if (globalOp->getType() == OperandType::GLOBAL)
             {
                 const auto* g   = static_cast<const GlobalOperand*>(globalOp);
-                allowAcrossCall = immutableGlobals.find(g->name) != immutableGlobals.end();
+                allowAcrossCall = modRef && modRef->isImmutable(g->name);
             }
             if (!loopHasCall || allowAcrossCall) isInvariantLoad = true;
         }
@@ -613,11 +480,11 @@ namespace ME
         apply(defCollector, *inst);
         size_t defReg = defCollector.getResult();
         if (defReg == 0) return false;
-        if (!areUsesInsideLoop(defReg, loop, userMap, instBlock)) { return false; }
+        if (!areUsesInsideLoop(defReg, loop, defUse)) { return false; }
 
-        auto blockIt = instBlock.find(inst);
-        if (blockIt == instBlock.end()) return false;
-        if (!dominatesAllLatches(blockIt->second, loop, imm_dom))
+        Block* block = defUse.getBlock(inst);
+        if (!block) return false;
+        if (!dominatesAllLatches(block->blockId, loop, imm_dom))
         {
             // 条件块中的指令仅在可安全提前执行时才允许外提
             LICMSafeSpecVisitor safeVisitor;
@@ -638,7 +505,7 @@ namespace ME
 
         for (auto& [reg, count] : uses)
         {
-            if (!isLoopInvariantOperand(reg, loop, regDefBlock, invariantRegs)) return false;
+            if (!isLoopInvariantOperand(reg, loop, defUse, invariantRegs)) return false;
         }
         return true;
     }
@@ -677,12 +544,10 @@ namespace ME
 
     // 收集当前循环中的所有可外提（循环不变量）指令
     // 采用迭代的方式持续检查，直到本轮没有新发现的不变量为止（fix-point迭代）
-    void LICMPass::collectInvariantInsts(Function& function, const Analysis::Loop& loop,
-        const std::unordered_map<size_t, size_t>&          regDefBlock,
-        const std::map<size_t, std::vector<Instruction*>>& userMap,
-        const std::unordered_map<Instruction*, size_t>& instBlock, const std::vector<int>& imm_dom, bool restrictHeader,
+    void LICMPass::collectInvariantInsts(Function& function, const Analysis::Loop& loop, const Analysis::DefUse& defUse,
+        const std::vector<int>& imm_dom, bool restrictHeader,
         const std::set<Operand*>& loopStoreGlobals, bool loopHasCall, std::set<Instruction*>& invariantInsts,
-        std::set<size_t>& invariantRegs)
+        DenseSet& invariantRegs)
     {
         bool changed = true;
 
@@ -713,10 +578,8 @@ namespace ME
                     // 条件包括：所有用到的寄存器来自循环外或者自身已经被判定为不变量，且副作用安全
                     if (!isInvariantInst(inst,
                             loop,
-                            regDefBlock,
+                            defUse,
                             invariantRegs,
-                            userMap,
-                            instBlock,
                             imm_dom,
                             loopStoreGlobals,
                             loopHasCall))
@@ -769,7 +632,7 @@ namespace ME
             }
         }
 
-        std::unordered_map<size_t, Instruction*> regToInst;
+        IndexedMap<Instruction*> regToInst(function.getMaxReg());
         for (auto* inst : invariantInsts)
         {
             DefCollector defCollector;
@@ -790,9 +653,9 @@ namespace ME
 
             for (auto& [reg, count] : uses)
             {
-                auto defIt = regToInst.find(reg);
-                if (defIt == regToInst.end()) continue;
-                Instruction* dep = defIt->second;
+                auto* defIt = regToInst.lookup(reg);
+                if (!defIt) continue;
+                Instruction* dep = *defIt;
                 edges[dep].push_back(inst);
                 indegree[inst] += 1;
             }
@@ -826,23 +689,15 @@ namespace ME
     }
 
     // 从基本块中移除指令
-    // 功能：从指定基本块的指令列表中删除给定的指令
-    // 实现思路：
-    // 1. 检查基本块和指令指针是否有效
-    // 2. 遍历基本块的指令列表，找到目标指令
-    // 3. 从列表中删除该指令（只删除第一次出现的）
+    // 功能：从指定基本块的指令列表中摘除给定的指令（不释放）
+    // 实现思路：指令链表是侵入式的，直接按指令解除链接，O(1)
     // 参数：
     //   - block: 基本块指针
     //   - inst: 要删除的指令指针
     void LICMPass::removeInstFromBlock(Block* block, Instruction* inst)
     {
         if (!block || !inst) return;
-        for (auto it = block->insts.begin(); it != block->insts.end(); ++it)
-        {
-            if (*it != inst) continue;
-            block->insts.erase(it);
-            return;
-        }
+        block->insts.remove(inst);
     }
 
     // 执行循环不变量指令的外提操作
@@ -858,20 +713,18 @@ namespace ME
     // 参数：
     //   - preheader: preheader 基本块指针
     //   - hoistOrder: 按依赖关系排序的外提指令列表
-    //   - instBlock: 指令所在基本块的映射（会被更新）
-    //   - regDefBlock: 寄存器定义所在基本块的映射（会被更新）
+    //   - defUse: def-use 链（指令移动、新建指令与寄存器替换都会同步到链上）
     //   - function: 当前函数
     //   - loop: 循环信息
     //   - imm_dom: 直接支配者数组
     void LICMPass::hoistInstructions(Block* preheader, const std::vector<Instruction*>& hoistOrder,
-        std::unordered_map<Instruction*, size_t>& instBlock, std::unordered_map<size_t, size_t>& regDefBlock,
-        Function& function, const Analysis::Loop& loop, const std::vector<int>& imm_dom)
+        Analysis::DefUse& defUse, Function& function, const Analysis::Loop& loop, const std::vector<int>& imm_dom)
     {
         if (!preheader) return;
 
         std::vector<Instruction*>                unsafeInsts;
         std::unordered_set<Instruction*>         unsafeSet;
-        std::set<size_t>                         unsafeRegs;
+        DenseSet                                 unsafeRegs(function.getMaxReg());
         std::unordered_map<Instruction*, size_t> defRegs;
         for (auto* inst : hoistOrder)
         {
@@ -885,8 +738,8 @@ namespace ME
             if (arith &&
                 (arith->opcode == Operator::DIV || arith->opcode == Operator::MOD || arith->opcode == Operator::FDIV))
             {
-                auto blockIt = instBlock.find(inst);
-                if (blockIt != instBlock.end() && !dominatesAllLatches(blockIt->second, loop, imm_dom))
+                Block* block = defUse.getBlock(inst);
+                if (block && !dominatesAllLatches(block->blockId, loop, imm_dom))
                 {
                     LICMSafeSpecVisitor safeVisitor;
                     if (!apply(safeVisitor, *inst)) needsGuard = true;
@@ -903,7 +756,7 @@ namespace ME
 
         std::vector<Instruction*> preGuardInsts;
         std::vector<Instruction*> postGuardInsts;
-        std::set<size_t>          guardedRegs = unsafeRegs;
+        DenseSet                  guardedRegs = unsafeRegs;
         for (auto* inst : hoistOrder)
         {
             if (unsafeSet.find(inst) != unsafeSet.end()) continue;
@@ -915,7 +768,7 @@ namespace ME
             bool dependsOnGuard = false;
             for (auto& [reg, count] : uses)
             {
-                if (guardedRegs.find(reg) != guardedRegs.end())
+                if (guardedRegs.count(reg))
                 {
                     dependsOnGuard = true;
                     break;
@@ -934,13 +787,10 @@ namespace ME
         // 先从原块中移除，避免重复引用
         for (auto* inst : hoistOrder)
         {
-            auto it = instBlock.find(inst);
-            if (it == instBlock.end()) continue;
-            Block* fromBlock = function.getBlock(it->second);
+            Block* fromBlock = defUse.getBlock(inst);
+            if (!fromBlock) continue;
             removeInstFromBlock(fromBlock, inst);
-            instBlock[inst] = preheader->blockId;
-            size_t defReg   = defRegs[inst];
-            if (defReg != 0) regDefBlock[defReg] = preheader->blockId;
+            defUse.moveInst(inst, preheader);
         }
 
         // 将指令插入到 preheader 的终结指令之前
@@ -962,19 +812,22 @@ namespace ME
             if (terminator) preheader->insts.push_back(terminator);
             return;
         }
-        if (terminator) delete terminator;
+        if (terminator)
+        {
+            defUse.removeInst(terminator);
+            delete terminator;
+        }
 
         // 带条件守卫的外提：遇到可能除零的运算时，在 preheader 后插入分支保护
-        Block*                                   current = preheader;
-        std::unordered_map<size_t, Operand*>     replaceRegs;
-        std::unordered_map<Instruction*, size_t> finalBlock;
-        for (auto* inst : preGuardInsts) finalBlock[inst] = preheader->blockId;
+        Block* current = preheader;
 
         for (auto* inst : unsafeInsts)
         {
             auto* arith = dynamic_cast<ArithmeticInst*>(inst);
             if (!arith) continue;
 
+            // 结果寄存器改名，先注销，放入 then 块后重新登记
+            defUse.removeInst(arith);
             Operand* oldRes = arith->res;
             Operand* divRes = getRegOperand(function.getNewRegId());
             arith->res      = divRes;
@@ -997,45 +850,40 @@ namespace ME
             Block* elseBlock  = function.createBlock();
             Block* mergeBlock = function.createBlock();
 
-            current->insts.push_back(cmpInst);
-            current->insts.push_back(
+            // 新建指令依次放入所在块并登记到 def-use 链
+            auto append = [&defUse](Block* block, Instruction* newInst) {
+                block->insts.push_back(newInst);
+                defUse.addInst(newInst, block);
+            };
+
+            append(current, cmpInst);
+            append(current,
                 new BrCondInst(cmpRes, getLabelOperand(thenBlock->blockId), getLabelOperand(elseBlock->blockId)));
 
-            thenBlock->insts.push_back(inst);
-            thenBlock->insts.push_back(new BrUncondInst(getLabelOperand(mergeBlock->blockId)));
+            append(thenBlock, inst);
+            append(thenBlock, new BrUncondInst(getLabelOperand(mergeBlock->blockId)));
 
-            elseBlock->insts.push_back(new BrUncondInst(getLabelOperand(mergeBlock->blockId)));
+            append(elseBlock, new BrUncondInst(getLabelOperand(mergeBlock->blockId)));
 
             Operand* phiRes = getRegOperand(function.getNewRegId());
             auto*    phi    = new PhiInst(arith->dt, phiRes);
             phi->addIncoming(divRes, getLabelOperand(thenBlock->blockId));
             phi->addIncoming(zero, getLabelOperand(elseBlock->blockId));
-            mergeBlock->insts.push_back(phi);
+            append(mergeBlock, phi);
 
-            if (oldRes && oldRes->getType() == OperandType::REG) { replaceRegs[oldRes->getRegNum()] = phiRes; }
+            // 原结果的使用全部改为读合并后的 Phi
+            if (oldRes && oldRes->getType() == OperandType::REG) defUse.replaceAllUsesWith(oldRes->getRegNum(), phiRes);
 
-            finalBlock[inst] = thenBlock->blockId;
-            current          = mergeBlock;
+            current = mergeBlock;
         }
 
         for (auto* inst : postGuardInsts)
         {
             current->insts.push_back(inst);
-            finalBlock[inst] = current->blockId;
+            defUse.moveInst(inst, current);
         }
         current->insts.push_back(new BrUncondInst(headerLabel));
-
-        if (!replaceRegs.empty())
-        {
-            OperandReplaceVisitor replaceVisitor(replaceRegs);
-            for (size_t blockId : loop.blocks)
-            {
-                Block* block = function.getBlock(blockId);
-                if (!block) continue;
-                for (auto* inst : block->insts) { apply(replaceVisitor, *inst); }
-            }
-            for (auto* inst : postGuardInsts) { apply(replaceVisitor, *inst); }
-        }
+        defUse.addInst(current->insts.back(), current);
 
         Operand*              oldLabel = getLabelOperand(preheader->blockId);
         Operand*              newLabel = getLabelOperand(current->blockId);
@@ -1043,14 +891,14 @@ namespace ME
         Block*                header = function.getBlock(loop.header);
         if (header && newLabel != oldLabel)
         {
-            for (auto* inst : header->insts) { apply(phiReplace, *inst, oldLabel, newLabel); }
-        }
-
-        for (auto& [inst, blockId] : finalBlock)
-        {
-            instBlock[inst] = blockId;
-            size_t defReg   = defRegs[inst];
-            if (defReg != 0) regDefBlock[defReg] = blockId;
+            for (auto* inst : header->insts)
+            {
+                if (inst->opcode != Operator::PHI) continue;
+                // 改写 incoming 的标签会重建映射项，先注销再重新登记
+                defUse.removeInst(inst);
+                apply(phiReplace, *inst, oldLabel, newLabel);
+                defUse.addInst(inst, header);
+            }
         }
     }
 
@@ -4,9 +4,10 @@
 #include <middleend/module/ir_instruction.h>
 #include <middleend/module/ir_operand.h>
 #include <middleend/visitor/utils/rename_visitor.h>
-#include <middleend/visitor/utils/use_def_visitor.h>
 #include <middleend/pass/analysis/analysis_manager.h>
 #include <middleend/pass/analysis/dominfo.h>
+#include <middleend/pass/analysis/def_use.h>
+#include <utils/indexed_map.h>
 #include <algorithm>
 #include <vector>
 #include <stack>
@@ -17,7 +18,12 @@
 
 namespace ME
 {
-    void Mem2RegPass::runOnFunction(Function& function) { promoteMemoryToRegister(function); }
+    Analysis::PreservedAnalyses Mem2RegPass::runOnFunction(Function& function)
+    {
+        if (!promoteMemoryToRegister(function)) return Analysis::PreservedAnalyses::all();
+        // 重命名直接改写了操作数，CFG 不变，只丢弃 def-use 链；只涉及局部变量，模块级分析仍然有效
+        return Analysis::PreservedAnalyses::none().preserveCFGAnalyses().preserveModuleAnalyses();
+    }
 
     bool Mem2RegPass::promoteMemoryToRegister(Function& function)
     {
@@ -30,20 +36,17 @@ namespace ME
         auto* domInfo = Analysis::AM.get<Analysis::DomInfo>(function);
         if (!domInfo) return false;
 
-        // 1) 扫描全函数，建立 def-use（用于判断 alloca 是否只被 load/store 使用）
-        UserCollector collector;
-        for (auto& [id, block] : function.blocks)
-        {
-            for (auto inst : block->insts) { apply(collector, *inst); }
-        }
+        // 1) 获取 def-use 链（用于判断 alloca 是否只被 load/store 使用）
+        auto* defUse = Analysis::AM.get<Analysis::DefUse>(function);
 
         // 2) 识别可提升的 Alloca：
         //    - alloca 的结果寄存器，只能作为 load/store 的 ptr 操作数
         //    - 且 store 必须把它作为“地址”，不能把它当成“值”参与运算
         std::vector<AllocaInst*>                             allocas;         // 可提升的 Alloca 列表
-        std::map<size_t, int>                                regToAllocaIdx;  // Alloca 寄存器编号 -> 上面数组的索引
+        IndexedMap<int>                                      regToAllocaIdx;  // Alloca 寄存器编号 -> 上面数组的索引
         std::unordered_set<Instruction*>                     toRemove;        // 待删除的指令集合
         std::vector<std::vector<std::pair<int, StoreInst*>>> storeInfo;  // allocaIdx -> (定义块ID, StoreInst) 列表
+        regToAllocaIdx.reset(function.getMaxReg());
 
         for (auto& [blockId, block] : function.blocks)
         {
@@ -55,8 +58,7 @@ namespace ME
                     AllocaInst* alloca = static_cast<AllocaInst*>(inst);
                     size_t      regNum = alloca->res->getRegNum();
 
-                    auto it = collector.userMap.find(regNum);
-                    if (it == collector.userMap.end())
+                    if (!defUse->hasUses(regNum))
                     {
                         // 无使用的 Alloca，标记删除
                         toRemove.insert(alloca);
@@ -65,10 +67,10 @@ namespace ME
 
                     // 检查是否可提升：只被 Load/Store 使用，且 Store 将其作为 ptr
                     // 如果 store 将 alloca 作为值使用，可能会导致间接内存访问，无法提升
-                    bool  promotable = true;
-                    auto& users      = it->second;
-                    for (auto* user : users)
+                    bool promotable = true;
+                    for (auto& use : defUse->getUses(regNum))
                     {
+                        Instruction* user = use.user;
                         // 遍历所有使用该 Alloca 的指令
                         if (user->opcode == Operator::LOAD)
                         {
@@ -108,11 +110,10 @@ namespace ME
                     if (store->ptr->getType() == OperandType::REG)
                     {
                         size_t reg = store->ptr->getRegNum();
-                        auto   it  = regToAllocaIdx.find(reg);
-                        if (it != regToAllocaIdx.end())
+                        if (auto* it = regToAllocaIdx.lookup(reg))
                         {
                             // 如果是存储到可提升的Alloca，记录 块ID和Store指令
-                            int idx = it->second;
+                            int idx = *it;
                             storeInfo[idx].emplace_back((int)blockId, store);
                         }
                     }
@@ -152,8 +153,8 @@ namespace ME
         // 4) Phi 插入（基于支配边界 DF 的经典工作队列算法）：
         //    对每个 alloca(i)，从所有定义块 defBlocks 出发，在 DF 上扩散插入 Phi，
         //    直到收敛（插入 Phi 的块也会成为新的“定义块”继续扩散）。
-        const auto&                                                DF = domInfo->getDomFrontier();  // 支配边界
-        std::unordered_map<int, std::unordered_map<int, PhiInst*>> blockPhis;  // 块ID -> (allocaIdx -> PhiInst)
+        const auto&                                   DF = domInfo->getDomFrontier();  // 支配边界
+        IndexedMap<std::unordered_map<int, PhiInst*>> blockPhis(function.getMaxLabel());  // 块ID -> (allocaIdx -> PhiInst)
 
         for (size_t i = 0; i < allocas.size(); ++i)
         {
@@ -165,7 +166,7 @@ namespace ME
             std::unordered_set<int> defBlocks;
             for (auto& [blkId, _] : storeInfo[i]) { defBlocks.insert(blkId); }
 
-            std::unordered_set<int> F;  // 已经给该 alloca(i) 插入了 Phi 节点的块id
+            DenseSet                F(function.getMaxLabel());  // 已经给该 alloca(i) 插入了 Phi 节点的块id
             std::queue<int>         W;  // 工作队列，存储当前已知有定义的块id
             for (int blk : defBlocks) { W.push(blk); }
 
@@ -177,13 +178,13 @@ namespace ME
                 for (int Y : DF[X])
                 {
                     // 遍历支配边界中的每个块Y
-                    if (F.find(Y) == F.end())
+                    if (!F.count(Y))
                     {
                         // 如果还没有为Y插入phi节点
-                        Block*      blkY = function.blocks[Y];  // 获取块Y
+                        Block*      blkY = function.getBlock(Y);  // 获取块Y
                         DataType    dt   = allocas[i]->dt;      // Alloca的数据类型
                         RegOperand* res =
-                            OperandFactory::getInstance().getRegOperand(function.getNewRegId());  // 新寄存器
+                            getRegOperand(function.getNewRegId());  // 新寄存器
                         PhiInst* phi = new PhiInst(dt, res);                                      // 创建Phi节点
 
                         blkY->insts.push_front(phi);  // 将Phi节点插入块Y的指令列表前端
@@ -213,34 +214,6 @@ namespace ME
         OperandRename                     renamer;    // 用于重命名寄存器的工具，根据 renameMap 替换指令中的寄存器操作数
         OperandMap                        renameMap;  // 记录重命名映射关系
 
-        // 处理快速路径的 Alloca
-        for (size_t i = 0; i < allocas.size(); ++i)
-        {
-            if (usesFastPath[i] && singleDefValue[i])
-            {
-                // 如果使用了快速路径，直接将 alloca(i) 替换为单定义值
-
-                size_t allocaReg = allocas[i]->res->getRegNum();       // 获取alloca(i)的寄存器编号
-                auto   it        = collector.userMap.find(allocaReg);  // 查找alloca(i)的所有用户
-                if (it != collector.userMap.end())
-                {
-                    for (auto* user : it->second)
-                    {
-                        // 遍历 alloca(i) 的所有用户
-                        if (user->opcode == Operator::LOAD)
-                        {
-                            // 如果是 Load 指令，将其结果重命名为单定义值
-                            LoadInst* load = static_cast<LoadInst*>(user);
-
-                            // 将 load 的结果重命名操作数
-                            renameMap[load->res->getRegNum()] = singleDefValue[i];
-                            toRemove.insert(load);  // 标记删除该 Load 指令
-                        }
-                    }
-                }
-            }
-        }
-
         // 迭代式重命名
         const auto& domTree = domInfo->getDomTree();  // 获取支配树
 
@@ -269,13 +242,12 @@ namespace ME
             }
 
             // 获取当前块
-            Block* blk = function.blocks[u];
+            Block* blk = function.getBlock(u);
 
             // 处理当前块的 Phi 定义
-            auto phiIt = blockPhis.find(u);
-            if (phiIt != blockPhis.end())
+            if (auto* phis = blockPhis.lookup(u))
             {
-                for (auto& [idx, phi] : phiIt->second)
+                for (auto& [idx, phi] : *phis)
                 {
                     // 获取Phi指令的结果，将其压入对应栈
                     stacks[idx].push(phi->res);
@@ -295,11 +267,20 @@ namespace ME
                     {
                         // 如果是从寄存器加载数据
                         size_t reg = load->ptr->getRegNum();
-                        auto   it  = regToAllocaIdx.find(reg);
-                        if (it != regToAllocaIdx.end() && !usesFastPath[it->second])
+                        auto*  it  = regToAllocaIdx.lookup(reg);
+                        if (it && usesFastPath[*it])
+                        {
+                            // 快速路径：直接用唯一定义值替换。该值本身可能是已被重命名的 load 结果
+                            // （如 int b = a; 中的 a），沿支配树访问到这里时其重命名已记录，先解析再记录
+                            Operand* val = singleDefValue[*it];
+                            renameOperand(val, renameMap);
+                            renameMap[load->res->getRegNum()] = val;
+                            toRemove.insert(load);
+                        }
+                        else if (it)
                         {
                             // 如果要存储的寄存器是alloca(i)的结果，并且没有使用快速路径
-                            int idx = it->second;
+                            int idx = *it;
                             if (!stacks[idx].empty())
                             {
                                 // 对应栈不为空，使用栈顶值重命名结果
@@ -311,12 +292,12 @@ namespace ME
                                 if (load->dt == DataType::F32)
                                 {
                                     renameMap[load->res->getRegNum()] =
-                                        OperandFactory::getInstance().getImmeF32Operand(0.0f);
+                                        getImmeF32Operand(0.0f);
                                 }
                                 else
                                 {
                                     renameMap[load->res->getRegNum()] =
-                                        OperandFactory::getInstance().getImmeI32Operand(0);
+                                        getImmeI32Operand(0);
                                 }
                             }
                             toRemove.insert(load);  // 标记删除该 Load 指令
@@ -332,12 +313,12 @@ namespace ME
                     {
                         // 如果是存储到寄存器
                         size_t reg = store->ptr->getRegNum();
-                        auto   it  = regToAllocaIdx.find(reg);
-                        if (it != regToAllocaIdx.end() && !usesFastPath[it->second])
+                        auto*  it  = regToAllocaIdx.lookup(reg);
+                        if (it && !usesFastPath[*it])
                         {
                             // Store：如果写入可提升 alloca，则把“写入的值”压栈，作为后续 load 的当前版本
                             isPromotable = true;  // 说明该 Store 可提升
-                            int      idx = it->second;
+                            int      idx = *it;
                             Operand* val = store->val;
                             renameOperand(val, renameMap);  // 将要存的值进行重命名
 
@@ -385,12 +366,12 @@ namespace ME
             for (Block* succ : succs)
             {
                 // 遍历每个后继块
-                int  v      = (int)succ->blockId;  // 后继块ID
-                auto phiIt2 = blockPhis.find(v);   // 查找后继块的Phi节点
-                if (phiIt2 != blockPhis.end())
+                int   v    = (int)succ->blockId;   // 后继块ID
+                auto* phis = blockPhis.lookup(v);  // 查找后继块的Phi节点
+                if (phis)
                 {
                     // 在后继块找到了Phi节点
-                    for (auto& [idx, phi] : phiIt2->second)
+                    for (auto& [idx, phi] : *phis)
                     {
                         // 对于每个Phi节点，添加来自当前块的参数
                         Operand* val = nullptr;
@@ -400,11 +381,11 @@ namespace ME
                             // 栈空意味着：该变量在到达此处前未定义，按语言语义使用默认零值
                             if (allocas[idx]->dt == DataType::F32)
                             {
-                                val = OperandFactory::getInstance().getImmeF32Operand(0.0f);
+                                val = getImmeF32Operand(0.0f);
                             }
-                            else { val = OperandFactory::getInstance().getImmeI32Operand(0); }
+                            else { val = getImmeI32Operand(0); }
                         }
-                        phi->addIncoming(val, OperandFactory::getInstance().getLabelOperand(u));
+                        phi->addIncoming(val, getLabelOperand(u));
                     }
                 }
             }
@@ -426,17 +407,17 @@ namespace ME
         // 6) 统一删除：将可提升相关的 alloca/load/store 移除（包括 fast path）
         for (auto& [id, block] : function.blocks)
         {
-            std::deque<Instruction*> newInsts;
-            for (auto inst : block->insts)
+            for (auto it = block->insts.begin(); it != block->insts.end();)
             {
-                if (toRemove.find(inst) == toRemove.end()) { newInsts.push_back(inst); }
+                Instruction* inst = *it;
+                if (toRemove.find(inst) == toRemove.end()) { ++it; }
                 else
                 {
                     // 删除可提升的 Alloca 指令
+                    it = block->insts.erase(it);
                     delete inst;
                 }
             }
-            block->insts = newInsts;
         }
 
         return true;
@@ -15,7 +15,7 @@ namespace ME
         Mem2RegPass()  = default;
         ~Mem2RegPass() = default;
 
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
         // 将内存中的变量提升为寄存器变量
@@ -0,0 +1,348 @@
+#include <middleend/pass/pass_manager.h>
+#include <middleend/module/ir_module.h>
+#include <middleend/module/ir_function.h>
+#include <middleend/pass/unify_return.h>
+#include <middleend/pass/dce.h>
+#include <middleend/pass/adce.h>
+#include <middleend/pass/mem2reg.h>
+#include <middleend/pass/inline.h>
+#include <middleend/pass/sccp.h>
+#include <middleend/pass/tco.h>
+#include <middleend/pass/licm.h>
+#include <middleend/pass/cse.h>
+#include <middleend/pass/simplify_cfg.h>
+#include <cctype>
+
+namespace ME
+{
+    namespace
+    {
+        struct PassEntry
+        {
+            const char* name;
+            std::unique_ptr<Pass> (*create)();
+        };
+
+        template <typename P>
+        std::unique_ptr<Pass> createPass()
+        {
+            return std::make_unique<P>();
+        }
+
+        const PassEntry passRegistry[] = {
+            {"tco", createPass<TCOPass>},
+            {"unify-return", createPass<UnifyReturnPass>},
+            {"mem2reg", createPass<Mem2RegPass>},
+            {"inline", createPass<InlinePass>},
+            {"sccp", createPass<SCCPPass>},
+            {"dce", createPass<DCEPass>},
+            {"licm", createPass<LICMPass>},
+            {"adce", createPass<ADCEPass>},
+            {"cse", createPass<CSEPass>},
+            {"simplifycfg", createPass<SimplifyCFGPass>},
+        };
+
+        const PassEntry* findPass(const std::string& name)
+        {
+            for (auto& entry : passRegistry)
+            {
+                if (name == entry.name) return &entry;
+            }
+            return nullptr;
+        }
+    }  // namespace
+
+    const char* PassManager::getPreset(int optimizeLevel)
+    {
+        switch (optimizeLevel)
+        {
+            case 0: return "";
+            case 1: return "tco,unify-return,mem2reg,inline,sccp,dce,licm,adce,cse,simplifycfg";
+            // -O2 起：内联后把常量传播与死代码消除迭代到不动点，LICM 外提后再做一轮清理
+            default:
+                return "tco,unify-return,mem2reg,inline,fixpoint(sccp,dce),licm,fixpoint(adce,cse,sccp,dce),"
+                       "simplifycfg";
+        }
+    }
+
+    std::vector<std::string> PassManager::passNames()
+    {
+        std::vector<std::string> names;
+        for (auto& entry : passRegistry) names.push_back(entry.name);
+        return names;
+    }
+
+    bool PassManager::parse(const std::string& text, std::string& err)
+    {
+        size_t            pos = 0;
+        std::vector<Node> nodes;
+        if (!parseList(text, pos, nodes, err, 0)) return false;
+        if (pos != text.size())
+        {
+            err = "unexpected '" + std::string(1, text[pos]) + "' at position " + std::to_string(pos);
+            return false;
+        }
+        for (auto& node : nodes) pipeline.push_back(std::move(node));
+        return true;
+    }
+
+    bool PassManager::parseList(const std::string& text, size_t& pos, std::vector<Node>& out, std::string& err, int depth)
+    {
+        if (pos == text.size() || text[pos] == ')') return true;  // 空列表
+
+        while (true)
+        {
+            size_t start = pos;
+            while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) || text[pos] == '-'))
+                ++pos;
+            std::string name = text.substr(start, pos - start);
+            if (name.empty())
+            {
+                err = "expected pass name at position " + std::to_string(start);
+                return false;
+            }
+
+            Node node;
+            node.name = name;
+            if (name == "fixpoint")
+            {
+                if (pos == text.size() || text[pos] != '(')
+                {
+                    err = "expected '(' after fixpoint";
+                    return false;
+                }
+                ++pos;
+                if (!parseList(text, pos, node.group, err, depth + 1)) return false;
+                if (pos == text.size() || text[pos] != ')')
+                {
+                    err = "missing ')' for fixpoint";
+                    return false;
+                }
+                ++pos;
+            }
+            else
+            {
+                const PassEntry* entry = findPass(name);
+                if (!entry)
+                {
+                    err = "unknown pass '" + name + "'";
+                    return false;
+                }
+                node.create = entry->create;
+                node.instances.push_back(entry->create());
+                node.isFunctionPass = dynamic_cast<FunctionPass*>(node.instances[0].get()) != nullptr;
+            }
+            out.push_back(std::move(node));
+
+            if (pos == text.size()) break;
+            if (text[pos] == ')')
+            {
+                if (depth == 0)
+                {
+                    err = "unmatched ')' at position " + std::to_string(pos);
+                    return false;
+                }
+                break;
+            }
+            if (text[pos] != ',')
+            {
+                err = "unexpected '" + std::string(1, text[pos]) + "' at position " + std::to_string(pos);
+                return false;
+            }
+            ++pos;
+        }
+        return true;
+    }
+
+    void PassManager::setThreads(size_t threads)
+    {
+        threads = ThreadPool::resolveThreads(threads);
+        pool    = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+    }
+
+    bool PassManager::run(Module& module) { return runList(pipeline, module); }
+
+    bool PassManager::runList(std::vector<Node>& nodes, Module& module)
+    {
+        bool changed = false;
+        for (auto& node : nodes) changed |= runNode(node, module);
+        return changed;
+    }
+
+    bool PassManager::runNode(Node& node, Module& module)
+    {
+        if (node.create) return node.isFunctionPass ? runFunctionPass(node, module) : runModulePass(node, module);
+
+        // fixpoint 组：整组都不再修改 IR 时停止
+        bool changed = false;
+        for (int iter = 0; iter < maxFixpointIters; ++iter)
+        {
+            if (!runList(node.group, module)) break;
+            changed = true;
+        }
+        return changed;
+    }
+
+    bool PassManager::runFunctionPass(Node& node, Module& module)
+    {
+        // 与 FunctionPass::runOnModule 相同的逐函数流程，额外跳过上次无修改且此后未被改动的函数
+        std::vector<Function*> work;
+        std::vector<size_t>    versions;
+        for (auto* function : module.functions)
+        {
+            size_t version = funcVersion[function];
+            auto   it      = node.cleanAt.find(function);
+            if (it != node.cleanAt.end() && it->second == version) continue;
+            work.push_back(function);
+            versions.push_back(version);
+        }
+        if (work.empty()) return false;
+
+        // 每个工作线程一个独立的 pass 实例，模块级准备在进入并行区前完成
+        bool   parallel = pool && work.size() > 1;
+        size_t workers  = parallel ? pool->size() : 1;
+        while (node.instances.size() < workers) node.instances.push_back(node.create());
+        for (size_t w = 0; w < workers; ++w) static_cast<FunctionPass*>(node.instances[w].get())->doInitialization(module);
+
+        std::vector<Analysis::PreservedAnalyses> results(work.size());
+        auto runOne = [&](size_t worker, size_t index) {
+            Function*    function = work[index];
+            OperandScope scope(module.constants, function);
+            results[index] = static_cast<FunctionPass*>(node.instances[worker].get())->runOnFunction(*function);
+            Analysis::AM.invalidate(*function, results[index]);
+        };
+        if (parallel)
+            pool->parallelFor(work.size(), runOne);
+        else
+            for (size_t i = 0; i < work.size(); ++i) runOne(0, i);
+
+        for (size_t w = 0; w < workers; ++w) static_cast<FunctionPass*>(node.instances[w].get())->doFinalization(module);
+
+        // 按函数顺序汇总结果，与单线程运行时一致
+        auto preserved = Analysis::PreservedAnalyses::all();
+        for (size_t i = 0; i < work.size(); ++i)
+        {
+            if (results[i].areAllPreserved())
+            {
+                node.cleanAt[work[i]] = versions[i];
+                continue;
+            }
+            preserved.intersect(results[i]);
+            markChanged(work[i]);
+        }
+        Analysis::AM.invalidate(module, preserved);
+        return !preserved.areAllPreserved();
+    }
+
+    bool PassManager::runModulePass(Node& node, Module& module)
+    {
+        if (node.moduleClean && node.moduleCleanAt == moduleVersion) return false;
+
+        auto pa = node.instances[0]->runOnModule(module);
+        if (pa.areAllPreserved())
+        {
+            node.moduleClean   = true;
+            node.moduleCleanAt = moduleVersion;
+            return false;
+        }
+        Analysis::AM.invalidate(module, pa);
+        for (auto* function : module.functions) markChanged(function);
+        return true;
+    }
+
+    void PassManager::markChanged(Function* function)
+    {
+        ++funcVersion[function];
+        ++moduleVersion;
+    }
+
+    bool PassManager::isLateNode(const Node& node)
+    {
+        if (node.create) return node.isFunctionPass;
+        for (auto& child : node.group)
+        {
+            if (!isLateNode(child)) return false;
+        }
+        return true;
+    }
+
+    template <typename Fn>
+    void PassManager::forEachPassNode(std::vector<Node>& nodes, Fn&& fn)
+    {
+        for (auto& node : nodes)
+        {
+            if (node.create)
+                fn(node);
+            else
+                forEachPassNode(node.group, fn);
+        }
+    }
+
+    bool PassManager::splitLatePasses()
+    {
+        size_t split = pipeline.size();
+        while (split > 0 && isLateNode(pipeline[split - 1])) --split;
+        for (size_t i = split; i < pipeline.size(); ++i) latePipeline.push_back(std::move(pipeline[i]));
+        pipeline.resize(split);
+        return !latePipeline.empty();
+    }
+
+    void PassManager::beginLate(Module& module, size_t workers)
+    {
+        // 模块级分析在此时（模块仍完整）由各 pass 的 doInitialization 取得
+        forEachPassNode(latePipeline, [&](Node& node) {
+            while (node.instances.size() < workers) node.instances.push_back(node.create());
+            for (size_t w = 0; w < workers; ++w)
+                static_cast<FunctionPass*>(node.instances[w].get())->doInitialization(module);
+        });
+    }
+
+    void PassManager::endLate(Module& module)
+    {
+        forEachPassNode(latePipeline, [&](Node& node) {
+            for (auto& instance : node.instances) static_cast<FunctionPass*>(instance.get())->doFinalization(module);
+        });
+    }
+
+    void PassManager::runLate(Module& module, Function& function, size_t worker)
+    {
+        OperandScope scope(module.constants, &function);
+        LateState    state;
+        runLateList(latePipeline, function, worker, state);
+    }
+
+    bool PassManager::runLateList(std::vector<Node>& nodes, Function& function, size_t worker, LateState& state)
+    {
+        bool changed = false;
+        for (auto& node : nodes) changed |= runLateNode(node, function, worker, state);
+        return changed;
+    }
+
+    bool PassManager::runLateNode(Node& node, Function& function, size_t worker, LateState& state)
+    {
+        if (!node.create)
+        {
+            bool changed = false;
+            for (int iter = 0; iter < maxFixpointIters; ++iter)
+            {
+                if (!runLateList(node.group, function, worker, state)) break;
+                changed = true;
+            }
+            return changed;
+        }
+
+        auto it = state.cleanAt.find(&node);
+        if (it != state.cleanAt.end() && it->second == state.version) return false;
+
+        // 只失效该函数上的分析，模块级分析保持不变（见文件头注释）
+        auto pa = static_cast<FunctionPass*>(node.instances[worker].get())->runOnFunction(function);
+        if (pa.areAllPreserved())
+        {
+            state.cleanAt[&node] = state.version;
+            return false;
+        }
+        Analysis::AM.invalidate(function, pa);
+        ++state.version;
+        return true;
+    }
+}  // namespace ME
@@ -0,0 +1,119 @@
+#ifndef __MIDDLEEND_PASS_PASS_MANAGER_H__
+#define __MIDDLEEND_PASS_PASS_MANAGER_H__
+
+#include <interfaces/middleend/pass.h>
+#include <utils/thread_pool.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Pass 管理器
+ *
+ * 管线描述 (-passes=)：
+ * - 以逗号分隔的 pass 名，按顺序运行，如 "mem2reg,sccp,dce"；
+ * - fixpoint(...) 表示一组 pass 反复运行，直到整组都不再修改 IR（至多 maxFixpointIters 轮），
+ *   可以嵌套，如 "mem2reg,fixpoint(sccp,dce,cse),simplifycfg"；
+ * - 可用的 pass 名见 passNames()，各优化等级的默认管线见 getPreset()。
+ *
+ * 跳过未改动的函数：
+ * - 每个函数有一个版本号，任何 pass 修改该函数（返回值不是 PreservedAnalyses::all()）后版本号加一；
+ * - 函数级 pass 在某函数上运行且未作修改时，记下当时的版本号；
+ *   之后再次轮到该 pass 时，若函数版本号未变，则结果必然仍是“无修改”，直接跳过；
+ * - 模块级 pass 无法给出逐函数的修改情况，有修改时视为所有函数都被修改。
+ *
+ * 函数级并行 (setThreads)：
+ * - 函数级 pass 在线程池上同时处理多个函数，每个线程使用该 pass 的独立实例；
+ * - 模块级 pass（tco、unify-return、inline）在调用线程上单独运行，相当于并行区之间的屏障；
+ * - 各函数的结果按 module.functions 的顺序汇总，输出与单线程完全一致。
+ *
+ * 后期管线 (splitLatePasses，用于流式编译)：
+ * - 管线末尾只由函数级 pass 及只含函数级 pass 的 fixpoint 组组成的部分可以拆出，run() 只运行其余部分；
+ * - 拆出的部分在 beginLate/endLate 之间由 runLate 逐函数运行，一个函数跑完即可交给后端并释放，
+ *   fixpoint 组在该函数不再被修改时停止，与整模块运行时逐函数的结果一致；
+ * - 模块级分析（如 LICM 使用的 GlobalModRef）沿用 beginLate 时按完整模块构建的结果，此后不再失效：
+ *   函数级 pass 只会删除 store/call，沿用的结果是保守的。
+ */
+
+namespace ME
+{
+    class PassManager
+    {
+      public:
+        static constexpr int maxFixpointIters = 8;
+
+        PassManager()  = default;
+        ~PassManager() = default;
+
+        // 解析管线描述并追加到当前管线，失败时返回 false，err 中给出原因
+        bool parse(const std::string& pipeline, std::string& err);
+        bool empty() const { return pipeline.empty(); }
+
+        // 函数级 pass 使用的线程数，1 为单线程，0 为硬件线程数
+        void setThreads(size_t threads);
+
+        // 在模块上运行整条管线，返回是否修改了 IR
+        bool run(Module& module);
+
+        // 把管线末尾的函数级部分拆为后期管线，返回拆出的部分是否非空
+        bool splitLatePasses();
+        // 后期管线的模块级准备与收尾，workers 为之后调用 runLate 的线程数
+        void beginLate(Module& module, size_t workers);
+        void endLate(Module& module);
+        // 在单个函数上运行后期管线，worker 为调用线程的编号 [0, workers)；不同线程可同时处理不同函数
+        void runLate(Module& module, Function& function, size_t worker);
+
+        // 各优化等级对应的默认管线，-O0 为空
+        static const char* getPreset(int optimizeLevel);
+        // 所有可在管线中使用的 pass 名
+        static std::vector<std::string> passNames();
+
+      private:
+        struct Node
+        {
+            std::string name;
+            std::unique_ptr<Pass> (*create)() = nullptr;  // 为空时表示 fixpoint 组
+            std::vector<std::unique_ptr<Pass>> instances;  // 每个工作线程一个实例，0 号由调用线程使用
+            bool                               isFunctionPass = false;
+            std::vector<Node>                  group;
+
+            // 函数 -> 该 pass 上次在其上无修改地运行时的函数版本号
+            std::unordered_map<Function*, size_t> cleanAt;
+            // 模块级 pass 上次无修改运行时的模块版本号
+            bool   moduleClean   = false;
+            size_t moduleCleanAt = 0;
+        };
+
+        std::vector<Node>           pipeline;
+        std::vector<Node>           latePipeline;
+        std::unique_ptr<ThreadPool> pool;
+
+        std::unordered_map<Function*, size_t> funcVersion;
+        size_t                                moduleVersion = 0;
+
+        bool parseList(const std::string& text, size_t& pos, std::vector<Node>& out, std::string& err, int depth);
+
+        bool runList(std::vector<Node>& nodes, Module& module);
+        bool runNode(Node& node, Module& module);
+        bool runFunctionPass(Node& node, Module& module);
+        bool runModulePass(Node& node, Module& module);
+
+        void markChanged(Function* function);
+
+        // 后期管线中单个函数的版本号与各 pass 上次无修改时的版本号，由调用线程独占
+        struct LateState
+        {
+            size_t                                  version = 0;
+            std::unordered_map<const Node*, size_t> cleanAt;
+        };
+        bool runLateList(std::vector<Node>& nodes, Function& function, size_t worker, LateState& state);
+        bool runLateNode(Node& node, Function& function, size_t worker, LateState& state);
+
+        static bool isLateNode(const Node& node);
+        template <typename Fn>
+        static void forEachPassNode(std::vector<Node>& nodes, Fn&& fn);
+    };
+}  // namespace ME
+
+#endif  // __MIDDLEEND_PASS_PASS_MANAGER_H__
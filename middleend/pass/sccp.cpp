@@ -4,7 +4,6 @@
 #include <middleend/module/ir_instruction.h>
 #include <middleend/module/ir_operand.h>
 #include <middleend/visitor/utils/sccp_visitor.h>
-#include <middleend/visitor/utils/use_def_visitor.h>
 #include <middleend/pass/analysis/analysis_manager.h>
 #include <cmath>
 #include <algorithm>
@@ -12,7 +11,7 @@
 
 namespace ME
 {
-    void SCCPPass::runOnFunction(Function& function)
+    Analysis::PreservedAnalyses SCCPPass::runOnFunction(Function& function)
     {
         // SCCP（Sparse Conditional Constant Propagation）：
         // 目标：在不遍历全 CFG 全状态的前提下，同时完成
@@ -27,11 +26,11 @@ namespace ME
 
         // 初始化分析状态
         initialize(function);
-        if (function.blocks.empty()) return;
+        if (function.blocks.empty()) return Analysis::PreservedAnalyses::all();
         Block* entry = function.blocks.begin()->second;
 
         // 从入口块开始，标记其为可达块
-        if (reachableBlocks.insert(entry->blockId).second)
+        if (reachableBlocks.insert(entry->blockId))
         {
             // 将入口id插入可达块集合成功，说明是新可达块
             blockWorklist.push_back(entry);
@@ -60,19 +59,27 @@ namespace ME
                 instWorklist.pop_front();
 
                 // 获取指令所在的基本块
-                Block* block = instBlockMap[inst];
+                Block* block = defUse->getBlock(inst);
                 if (!block || reachableBlocks.count(block->blockId) == 0) continue;
                 // 仅对“可达块内”指令进行增量重算，避免把不可达路径的值错误传播出来
                 apply(evaluator, *inst, *this, block);
             }
         }
 
-        SCCPReplaceVisitor replacer;
-        for (auto& [id, block] : function.blocks)
+        // instChanged: 改写了指令但未改变块间跳转；cfgChanged: 折叠了分支或删除了块
+        bool instChanged = false;
+        bool cfgChanged  = false;
+
+        // 常量替换：沿 def-use 链只改写常量寄存器的使用点。
+        // 不可达块中的使用也会被改写，但这些块随后整体删除，不影响结果
+        for (auto [reg, val] : valueMap)
         {
-            // 仅对可达块做常量替换
-            if (reachableBlocks.count(id) == 0) continue;
-            for (auto* inst : block->insts) { apply(replacer, *inst, *this); }
+            // 已无使用点的常量寄存器（如上一轮已替换过）不算改动，保证重复运行时能收敛
+            if (val.kind != LatticeKind::CONST || !defUse->hasUses(reg)) continue;
+            instChanged = true;
+            Operand* imm = val.type == DataType::F32 ? static_cast<Operand*>(getImmeF32Operand(val.f32))
+                                                     : static_cast<Operand*>(getImmeI32Operand(val.i32));
+            defUse->replaceAllUsesWith(reg, imm);
         }
 
         // 结果落地：
@@ -84,28 +91,26 @@ namespace ME
             if (reachableBlocks.count(id) == 0) continue;
 
             // 1. Phi 消除：如果 Phi 结果是常量，删除该 Phi 指令
-            std::deque<Instruction*> newInsts;
-            for (auto* inst : block->insts)
+            for (auto instIt = block->insts.begin(); instIt != block->insts.end();)
             {
+                Instruction* inst = *instIt++;
                 if (inst->opcode == Operator::PHI)
                 {
                     auto* phi = static_cast<PhiInst*>(inst);
                     if (phi->res && phi->res->getType() == OperandType::REG)
                     {
                         size_t reg = phi->res->getRegNum();
-                        auto   it  = valueMap.find(reg);
-                        if (it != valueMap.end() && it->second.kind == LatticeKind::CONST)
+                        auto*  val = valueMap.lookup(reg);
+                        if (val && val->kind == LatticeKind::CONST)
                         {
                             // Phi 结果是常量，可以删除，此时使用点已被替换为常量
+                            block->insts.remove(inst);
                             delete inst;
-                            continue;
+                            instChanged = true;
                         }
                     }
                 }
-                newInsts.push_back(inst);
             }
-            // 更新指令列表
-            block->insts = newInsts;
 
             // 2. 条件分支折叠
             if (block->insts.empty()) continue;
@@ -129,9 +134,10 @@ namespace ME
                 }
 
                 // 用无条件分支替换原条件分支
-                auto* newBr         = new BrUncondInst(target);
-                block->insts.back() = newBr;
+                auto* newBr = new BrUncondInst(target);
+                block->insts.replace(br, newBr);
                 delete br;
+                cfgChanged = true;
             }
         }
 
@@ -179,36 +185,30 @@ namespace ME
 
             // 真正删除块本体
             delete block;
-            it = function.blocks.erase(it);
+            it         = function.blocks.erase(it);
+            cfgChanged = true;
         }
-        Analysis::AM.invalidate(function);
+
+        // 删除 Phi 时未同步 def-use 链，指令有改动时 DefUse 一律作废
+        if (cfgChanged) return Analysis::PreservedAnalyses::none();
+        if (instChanged) return Analysis::PreservedAnalyses::none().preserveCFGAnalyses().preserveModuleAnalyses();
+        return Analysis::PreservedAnalyses::all();
     }
 
     void SCCPPass::initialize(Function& function)
     {
         // 重置分析状态
         currFunc = &function;
-        valueMap.clear();
-        userMap.clear();
-        instBlockMap.clear();
-        reachableBlocks.clear();
-        reachableEdges.clear();
+        valueMap.reset(function.getMaxReg());
+        reachableBlocks.reset(function.getMaxLabel());
+        reachableEdges.reset(function.getMaxLabel());
         blockWorklist.clear();
         instWorklist.clear();
 
-        // 收集寄存器 use 关系，并建立 inst -> block 映射：
-        // - userMap 用于“某寄存器格值变化后，快速把其所有使用点入队(instWorklist)”
-        // - instBlockMap 用于从指令反查其所在块，从而判断其是否可达并参与求值
-        UserCollector collector;
-        for (auto& [id, block] : function.blocks)
-        {
-            for (auto* inst : block->insts)
-            {
-                apply(collector, *inst);
-                instBlockMap[inst] = block;
-            }
-        }
-        userMap = std::move(collector.userMap);  // 寄存器编号 -> 使用该寄存器的指令列表
+        // def-use 链提供两类查询：
+        // - getUses(reg)：某寄存器格值变化后，快速把其所有使用点入队(instWorklist)
+        // - getBlock(inst)：从指令反查其所在块，从而判断其是否可达并参与求值
+        defUse = Analysis::AM.get<Analysis::DefUse>(function);
 
         // 参数寄存器视为不确定值，避免错误传播
         if (function.funcDef)
@@ -245,14 +245,14 @@ namespace ME
 /*
 SCCP 流程总结（对应本文件实现）：
 1) 初始化：
-   - 构建 userMap(reg -> users) 与 instBlockMap(inst -> block)；
+   - 获取 def-use 链（reg -> uses，inst -> block）；
    - 初始化格值表 valueMap（参数寄存器直接置为 OVERDEFINED）；
    - 从入口块开始，将其加入 reachableBlocks 与 blockWorklist。
 2) 求不动点（两类工作队列）：
    - 处理 blockWorklist：对新可达块遍历所有指令，计算/合并格值，并根据分支结果标记可达边与新可达块；
    - 处理 instWorklist：当寄存器格值变化时，仅重算受影响指令，做增量更新。
 3) 落地到 IR：
-   - 对可达块做常量替换（ReplaceVisitor）；
+   - 沿 def-use 链把常量寄存器的使用点替换为立即数；
    - 删除“结果已为常量”的 Phi；
    - 若条件分支条件变为立即数常量，则折叠为无条件分支，并移除被丢弃边对目标块 Phi 的 incoming。
 4) 删除不可达块，并先从其后继块 Phi 中移除 incoming，最后使分析缓存失效。
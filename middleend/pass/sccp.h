@@ -3,17 +3,15 @@
 
 #include <interfaces/middleend/pass.h>
 #include <middleend/module/ir_function.h>
+#include <middleend/pass/analysis/def_use.h>
+#include <utils/indexed_map.h>
 #include <deque>
-#include <map>
-#include <set>
 #include <vector>
 #include <utility>
 
 namespace ME
 {
     class SCCPEvalVisitor;
-    class SCCPReplaceVisitor;
-    class SCCPBranchSimplifyVisitor;
 
     // 稀疏条件常量传播（SCCP），用可达性与格值信息做常量传播与分支折叠
     class SCCPPass : public FunctionPass
@@ -22,7 +20,7 @@ namespace ME
         SCCPPass()  = default;
         ~SCCPPass() = default;
 
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
         // 格值三态：未知、常量、过定义
@@ -43,18 +41,17 @@ namespace ME
         };
 
         friend class SCCPEvalVisitor;
-        friend class SCCPReplaceVisitor;
 
       private:
-        Function* currFunc = nullptr;  // 当前函数上下文
+        Function*         currFunc = nullptr;  // 当前函数上下文
+        Analysis::DefUse* defUse   = nullptr;  // 当前函数的 def-use 链（使用者与指令所在块）
 
-        std::map<size_t, LatticeVal>                valueMap;         // 寄存器 -> 格值
-        std::map<size_t, std::vector<Instruction*>> userMap;          // 寄存器 -> 使用者指令
-        std::map<Instruction*, Block*>              instBlockMap;     // 指令 -> 基本块
-        std::set<size_t>                            reachableBlocks;  // 可达基本块集合
-        std::set<std::pair<size_t, size_t>>         reachableEdges;   // 可达边集合
-        std::deque<Block*>                          blockWorklist;    // 基本块工作队列
-        std::deque<Instruction*>                    instWorklist;     // 指令工作队列
+        // 格值表与可达性均以寄存器号/label 为下标，按函数的编号上界定容
+        IndexedMap<LatticeVal>   valueMap;         // 寄存器 -> 格值
+        DenseSet                 reachableBlocks;  // 可达基本块集合
+        IndexedMap<DenseSet>     reachableEdges;   // 可达边集合：目标块 -> 可达前驱
+        std::deque<Block*>       blockWorklist;    // 基本块工作队列
+        std::deque<Instruction*> instWorklist;     // 指令工作队列
 
       private:
         // 初始化 SCCP 分析状态
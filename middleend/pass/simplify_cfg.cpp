@@ -7,9 +7,10 @@
 
 namespace ME
 {
-    void SimplifyCFGPass::runOnFunction(Function& function)
+    Analysis::PreservedAnalyses SimplifyCFGPass::runOnFunction(Function& function)
     {
-        bool changed = true;
+        bool simplified = false;
+        bool changed    = true;
         while (changed)
         {
             changed = false;
@@ -82,10 +83,12 @@ namespace ME
             {
                 delete it->second;
                 function.blocks.erase(it);
-                changed = true;
+                changed = simplified = true;
             }
         }
 
-        Analysis::AM.invalidate(function);
+        // 只删除了仅含跳转的空块，指令与调用关系不变
+        if (!simplified) return Analysis::PreservedAnalyses::all();
+        return Analysis::PreservedAnalyses::none().preserveModuleAnalyses();
     }
 }  // namespace ME
@@ -13,7 +13,7 @@ namespace ME
         SimplifyCFGPass()  = default;
         ~SimplifyCFGPass() = default;
 
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
     };
 }  // namespace ME
 
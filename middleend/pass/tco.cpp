@@ -8,14 +8,27 @@
 
 namespace ME
 {
-    void TCOPass::runOnModule(Module& module)
+    Analysis::PreservedAnalyses TCOPass::runOnModule(Module& module)
     {
         // TCO（Tail Call Optimization）：
         // 该实现专门做“尾递归消除”：把对自身函数的尾调用改写为循环。
-        for (auto* function : module.functions) eliminateTailRecursion(*function);
+        // 改写会删除自递归调用并新增循环头，被改写函数的分析与调用图都不再有效
+        auto preserved = Analysis::PreservedAnalyses::all();
+        for (auto* function : module.functions)
+        {
+            OperandScope scope(module.constants, function);
+            auto         pa = runOnFunction(*function);
+            Analysis::AM.invalidate(*function, pa);
+            preserved.intersect(pa);
+        }
+        return preserved;
     }
 
-    void TCOPass::runOnFunction(Function& function) { eliminateTailRecursion(function); }
+    Analysis::PreservedAnalyses TCOPass::runOnFunction(Function& function)
+    {
+        if (!eliminateTailRecursion(function)) return Analysis::PreservedAnalyses::all();
+        return Analysis::PreservedAnalyses::none();
+    }
 
     // void 型返回值的分支链判断
     bool TCOPass::isVoidReturnChain(Function& function, Block* start) const
@@ -58,7 +71,7 @@ namespace ME
     }
 
     // 尾递归消除实现
-    void TCOPass::eliminateTailRecursion(Function& function)
+    bool TCOPass::eliminateTailRecursion(Function& function)
     {
         // 核心改写思路：
         // 1) 在函数内找“尾递归调用点”：call self 紧跟 ret（或 void 情况下 call->br->ret void 链）。
@@ -66,8 +79,8 @@ namespace ME
         // 3) 将入口块拆分出 loopHeader，在 loopHeader 开头 load 参数 slot 到新寄存器，并替换后续对形参寄存器的使用。
         // 4) 将尾递归点的“call+ret”替换为“参数写回 + br loopHeader”，形成显式循环。
         // 5) 必要时更新 Phi incoming，保持 CFG 语义正确。
-        if (!function.funcDef) return;
-        if (function.blocks.empty()) return;
+        if (!function.funcDef) return false;
+        if (function.blocks.empty()) return false;
 
         const std::string& funcName = function.funcDef->funcName;
 
@@ -99,7 +112,7 @@ namespace ME
         {
             // 遍历参数列表，记录寄存器号
             Operand* argOp = function.funcDef->argRegs[i].second;
-            if (!argOp || argOp->getType() != OperandType::REG) return;
+            if (!argOp || argOp->getType() != OperandType::REG) return false;
             // 记录对应的寄存器编号
             size_t regNum      = argOp->getRegNum();
             regToIndex[regNum] = i;
@@ -198,7 +211,7 @@ namespace ME
             }
         }
 
-        if (tailCallSites.empty()) return;
+        if (tailCallSites.empty()) return false;
 
         // 为需要的参数创建栈槽
         std::vector<StoreInst*> newParamStores;
@@ -225,7 +238,8 @@ namespace ME
             {
                 if (pos > maxStorePos) maxStorePos = pos;
             }
-            entry->insts.insert(entry->insts.begin() + maxStorePos + 1, newParamStores.begin(), newParamStores.end());
+            entry->insts.insert(
+                std::next(entry->insts.begin(), maxStorePos + 1), newParamStores.begin(), newParamStores.end());
         }
 
         // 计算最后一个参数初始化 store 的位置
@@ -259,11 +273,10 @@ namespace ME
             newHeader->setComment(funcName + ".tco loop.header");
 
             // 分割点：最后一个参数 store 之后
-            auto splitIt = entry->insts.begin() + lastParamStoreIdx + 1;
+            auto splitIt = std::next(entry->insts.begin(), lastParamStoreIdx + 1);
 
-            // 构造新列表并替换
-            newHeader->insts = std::deque<Instruction*>(splitIt, entry->insts.end());
-            entry->insts     = std::deque<Instruction*>(entry->insts.begin(), splitIt);
+            // 分割点之后的指令整段移入新循环头
+            newHeader->insts.splice(newHeader->insts.end(), entry->insts, splitIt, entry->insts.end());
 
             // 在入口块末尾添加跳转到新循环头的无条件分支
             entry->insts.push_back(new BrUncondInst(getLabelOperand(newHeader->blockId)));
@@ -327,7 +340,7 @@ namespace ME
         for (auto& [block, retBlock] : tailCallSites)
         {
             Instruction* termInst = block->insts.back();
-            auto*        call     = static_cast<CallInst*>(*(block->insts.rbegin() + 1));
+            auto*        call     = static_cast<CallInst*>(*std::next(block->insts.rbegin(), 1));
             auto         callArgs = call->args;
 
             // 将 call 和 term 指令移除
@@ -362,7 +375,7 @@ namespace ME
             }
         }
 
-        Analysis::AM.invalidate(function);
+        return true;
     }
 }  // namespace ME
 
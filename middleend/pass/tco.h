@@ -17,11 +17,11 @@ namespace ME
         TCOPass()  = default;
         ~TCOPass() = default;
 
-        void runOnModule(Module& module) override;
-        void runOnFunction(Function& function) override;
+        Analysis::PreservedAnalyses runOnModule(Module& module) override;
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;
 
       private:
-        void eliminateTailRecursion(Function& function);
+        bool eliminateTailRecursion(Function& function);  // 返回是否改写了函数
         bool isVoidReturnChain(Function& function, Block* start) const;
         bool isSameParamArg(const Function& function, size_t idx, Operand* arg) const;
     };
@@ -7,22 +7,35 @@
 
 namespace ME
 {
-    void UnifyReturnPass::runOnModule(Module& module)
+    Analysis::PreservedAnalyses UnifyReturnPass::runOnModule(Module& module)
     {
         // 对模块中的每个函数运行统一返回值传递的处理
-        for (auto* function : module.functions) unifyFunctionReturns(*function);
+        auto preserved = Analysis::PreservedAnalyses::all();
+        for (auto* function : module.functions)
+        {
+            OperandScope scope(module.constants, function);
+            auto         pa = runOnFunction(*function);
+            Analysis::AM.invalidate(*function, pa);
+            preserved.intersect(pa);
+        }
+        return preserved;
     }
 
-    void UnifyReturnPass::runOnFunction(Function& function) { unifyFunctionReturns(function); }
+    Analysis::PreservedAnalyses UnifyReturnPass::runOnFunction(Function& function)
+    {
+        if (!unifyFunctionReturns(function)) return Analysis::PreservedAnalyses::all();
+        // 新增了退出块并改写了跳转关系，但没有增删 call/store，模块级分析仍然有效
+        return Analysis::PreservedAnalyses::none().preserveModuleAnalyses();
+    }
 
-    void UnifyReturnPass::unifyFunctionReturns(Function& function)
+    bool UnifyReturnPass::unifyFunctionReturns(Function& function)
     {
         // 获取函数的控制流图 (CFG)
         auto* cfg = Analysis::AM.get<Analysis::CFG>(function);
 
         auto retInstructions = findReturnInstructions(cfg);
 
-        if (retInstructions.size() <= 1) return;  // 如果函数只有一个或没有返回指令，则无需处理
+        if (retInstructions.size() <= 1) return false;  // 如果函数只有一个或没有返回指令，则无需处理
 
         // 创建一个新的退出基本块
         Block* exitBlock = function.createBlock();
@@ -47,14 +60,10 @@ namespace ME
                 returnValues.push_back({nullptr, labelOp});
 
             // 用无条件跳转指令替换原有的返回指令
-            auto it = std::find(containingBlock->insts.begin(), containingBlock->insts.end(), retInst);
-            if (it != containingBlock->insts.end())
-            {
-                Operand* exitLabel  = getLabelOperand(exitBlock->blockId);  // 获取退出块的标签操作数
-                auto*    branchInst = new BrUncondInst(exitLabel);          // 创建无条件跳转指令
-                *it                 = branchInst;                           // 替换原有的返回指令
-                delete retInst;                                             // 删除原有的返回指令
-            }
+            Operand* exitLabel  = getLabelOperand(exitBlock->blockId);  // 获取退出块的标签操作数
+            auto*    branchInst = new BrUncondInst(exitLabel);          // 创建无条件跳转指令
+            containingBlock->insts.replace(retInst, branchInst);        // 替换原有的返回指令
+            delete retInst;                                             // 删除原有的返回指令
         }
 
         // 在退出基本块中创建一个 Phi 指令来选择正确的返回值
@@ -91,10 +100,10 @@ namespace ME
             exitBlock->insertBack(finalRet);
         }
 
-        // 由于在 `if (retInstructions.size() <= 1) return;` 处没有退出
+        // 由于在 `if (retInstructions.size() <= 1) return false;` 处没有退出
         // 我们可以确定该 pass 的执行一定向当前函数插入了新的基本块并修改了跳转关系
-        // 因此需要 invalidate 当前函数的 CFG 缓存
-        Analysis::AM.invalidate(function);
+        // 因此返回 true，由 runOnFunction 报告 CFG 相关分析失效
+        return true;
     }
 
     std::vector<RetInst*> UnifyReturnPass::findReturnInstructions(Analysis::CFG* cfg)
@@ -18,11 +18,11 @@ namespace ME
         UnifyReturnPass()  = default;
         ~UnifyReturnPass() = default;
 
-        void runOnModule(Module& module) override;        // 运行在模块级别
-        void runOnFunction(Function& function) override;  // 运行在函数级别
+        Analysis::PreservedAnalyses runOnModule(Module& module) override;        // 运行在模块级别
+        Analysis::PreservedAnalyses runOnFunction(Function& function) override;  // 运行在函数级别
 
       private:
-        void unifyFunctionReturns(Function& function);  // 统一函数的返回指令
+        bool unifyFunctionReturns(Function& function);  // 统一函数的返回指令，返回是否修改了函数
 
         std::vector<RetInst*> findReturnInstructions(Analysis::CFG* cfg);  // 查找函数中的所有返回指令
         Block* getBlockContaining(Function& function, Instruction* inst);  // 获取函数中包含指定指令的基本块
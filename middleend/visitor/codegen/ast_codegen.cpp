@@ -252,6 +252,9 @@ namespace ME
     // visit(Root): 模块级代码生成入口
     void ASTCodeGen::visit(FE::AST::Root& node, Module* m)
     {
+        // 全局变量初始值等模块级操作数放入模块常量表
+        OperandScope scope(m->constants);
+
         // 示例：注册库函数
         libFuncRegister(m);
 
@@ -15,6 +15,7 @@ namespace ME
         FuncDefInst* funcDef = new FuncDefInst(convert(node.retType), node.entry->getName());  // 创建函数定义指令
         Function*    func    = new Function(funcDef);                                          // 创建函数对象
         m->functions.emplace_back(func);  // 将函数添加到模块中
+        OperandScope funcScope(m->constants, func);  // 函数体内的操作数与指令归属该函数
 
         enterFunc(func);        // 进入函数
         name2reg.enterScope();  // 进入新作用域
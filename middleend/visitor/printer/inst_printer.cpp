@@ -1,95 +1,273 @@
 #include <middleend/visitor/printer/module_printer.h>
+#include <functional>
+#include <numeric>
 
 namespace ME
 {
-    void IRPrinter::visit(LoadInst& inst, std::ostream& os)
+    void IRPrinter::printOperand(const Operand* op, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        switch (op->getType())
+        {
+            case OperandType::REG: os << "%reg_" << static_cast<const RegOperand*>(op)->regNum; break;
+            case OperandType::IMMEI32: os << static_cast<const ImmeI32Operand*>(op)->value; break;
+            case OperandType::IMMEF32:
+                os << "0x";
+                os.hex(static_cast<uint64_t>(FLOAT_TO_DOUBLE_BITS(static_cast<const ImmeF32Operand*>(op)->value)));
+                break;
+            case OperandType::GLOBAL: os << '@' << static_cast<const GlobalOperand*>(op)->name; break;
+            case OperandType::LABEL: os << "%Block" << static_cast<const LabelOperand*>(op)->lnum; break;
+            default: os << op->toString(); break;
+        }
     }
-    void IRPrinter::visit(StoreInst& inst, std::ostream& os)
+
+    // 输出 [d_from x [d_from+1 x ... dt]...]
+    void IRPrinter::printArrayType(const std::vector<int>& dims, size_t from, DataType dt, OutBuffer& os)
+    {
+        for (size_t i = from; i < dims.size(); ++i) os << '[' << dims[i] << " x ";
+        os << getDataTypeName(dt);
+        for (size_t i = from; i < dims.size(); ++i) os << ']';
+    }
+
+    // 与 ir_instruction.cpp 中 initArrayGlb 的输出一致
+    void IRPrinter::printGlobalArrayInit(
+        DataType type, const FE::AST::VarAttr& v, size_t dimDph, size_t beginPos, size_t endPos, OutBuffer& os)
+    {
+        if (dimDph == 0)
+        {
+            bool allZero = true;
+            for (auto& initVal : v.initList)
+            {
+                if (initVal.type == FE::AST::boolType || initVal.type == FE::AST::intType ||
+                    initVal.type == FE::AST::llType)
+                {
+                    if (initVal.getInt() != 0) allZero = false;
+                }
+                if (initVal.type == FE::AST::floatType)
+                {
+                    if (initVal.getFloat() != 0.0f) allZero = false;
+                }
+                if (!allZero) break;
+            }
+
+            if (allZero)
+            {
+                printArrayType(v.arrayDims, 0, type, os);
+                os << " zeroinitializer";
+                return;
+            }
+        }
+
+        if (beginPos == endPos)
+        {
+            switch (type)
+            {
+                case DataType::I1:
+                case DataType::I32:
+                case DataType::I64: os << getDataTypeName(type) << ' ' << v.initList[beginPos].getInt(); break;
+                case DataType::F32:
+                    os << getDataTypeName(type) << " 0x";
+                    os.hex(static_cast<uint64_t>(FLOAT_TO_DOUBLE_BITS(v.initList[beginPos].getFloat())));
+                    break;
+                default: ERROR("Unsupported data type in global array init");
+            }
+            return;
+        }
+
+        printArrayType(v.arrayDims, dimDph, type, os);
+        os << " [";
+
+        int step = std::accumulate(v.arrayDims.begin() + dimDph + 1, v.arrayDims.end(), 1, std::multiplies<int>());
+        for (int i = 0; i < v.arrayDims[dimDph]; ++i)
+        {
+            if (i != 0) os << ',';
+            printGlobalArrayInit(type, v, dimDph + 1, beginPos + i * step, beginPos + (i + 1) * step - 1, os);
+        }
+
+        os << ']';
+    }
+
+    void IRPrinter::visit(LoadInst& inst, OutBuffer& os)
+    {
+        printOperand(inst.res, os);
+        os << " = load " << getDataTypeName(inst.dt) << ", ptr ";
+        printOperand(inst.ptr, os);
+        os << inst.getComment();
+    }
+    void IRPrinter::visit(StoreInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << "store " << getDataTypeName(inst.dt) << ' ';
+        printOperand(inst.val, os);
+        os << ", ptr ";
+        printOperand(inst.ptr, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(ArithmeticInst& inst, std::ostream& os)
+    void IRPrinter::visit(ArithmeticInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.res, os);
+        os << " = " << getOperatorName(inst.opcode) << ' ' << getDataTypeName(inst.dt) << ' ';
+        printOperand(inst.lhs, os);
+        os << ", ";
+        printOperand(inst.rhs, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(IcmpInst& inst, std::ostream& os)
+    void IRPrinter::visit(IcmpInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.res, os);
+        os << " = icmp " << getICmpName(inst.cond) << ' ' << getDataTypeName(inst.dt) << ' ';
+        printOperand(inst.lhs, os);
+        os << ", ";
+        printOperand(inst.rhs, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(FcmpInst& inst, std::ostream& os)
+    void IRPrinter::visit(FcmpInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.res, os);
+        os << " = fcmp " << getFCmpName(inst.cond) << ' ' << getDataTypeName(inst.dt) << ' ';
+        printOperand(inst.lhs, os);
+        os << ", ";
+        printOperand(inst.rhs, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(AllocaInst& inst, std::ostream& os)
+    void IRPrinter::visit(AllocaInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.res, os);
+        os << " = alloca ";
+        printArrayType(inst.dims, 0, inst.dt, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(BrCondInst& inst, std::ostream& os)
+    void IRPrinter::visit(BrCondInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << "br i1 ";
+        printOperand(inst.cond, os);
+        os << ", label ";
+        printOperand(inst.trueTar, os);
+        os << ", label ";
+        printOperand(inst.falseTar, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(BrUncondInst& inst, std::ostream& os)
+    void IRPrinter::visit(BrUncondInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << "br label ";
+        printOperand(inst.target, os);
+        os << inst.getComment();
     }
-    void IRPrinter::visit(GlbVarDeclInst& inst, std::ostream& os)
+    void IRPrinter::visit(GlbVarDeclInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << '@' << inst.name << " = global ";
+        if (inst.initList.arrayDims.empty())
+        {
+            os << getDataTypeName(inst.dt) << ' ';
+            if (inst.init)
+                printOperand(inst.init, os);
+            else
+                os << "zeroinitializer";
+        }
+        else
+        {
+            size_t step = 1;
+            for (int dim : inst.initList.arrayDims) step *= dim;
+            printGlobalArrayInit(inst.dt, inst.initList, 0, 0, step - 1, os);
+        }
+        os << inst.getComment();
     }
-    void IRPrinter::visit(CallInst& inst, std::ostream& os)
+    void IRPrinter::visit(CallInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        if (inst.retType != DataType::VOID)
+        {
+            printOperand(inst.res, os);
+            os << " = ";
+        }
+        os << "call " << getDataTypeName(inst.retType) << " @" << inst.funcName << '(';
+        for (size_t i = 0; i < inst.args.size(); ++i)
+        {
+            if (i) os << ", ";
+            os << getDataTypeName(inst.args[i].first) << ' ';
+            printOperand(inst.args[i].second, os);
+        }
+        os << ')' << inst.getComment();
     }
-    void IRPrinter::visit(FuncDeclInst& inst, std::ostream& os)
+    void IRPrinter::visit(FuncDeclInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << "declare " << getDataTypeName(inst.retType) << " @" << inst.funcName << '(';
+        for (size_t i = 0; i < inst.argTypes.size(); ++i)
+        {
+            if (i) os << ", ";
+            os << getDataTypeName(inst.argTypes[i]);
+        }
+        if (inst.isVarArg) os << ", ...";
+        os << ')' << inst.getComment();
     }
-    void IRPrinter::visit(FuncDefInst& inst, std::ostream& os)
+    void IRPrinter::visit(FuncDefInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << "define " << getDataTypeName(inst.retType) << " @" << inst.funcName << '(';
+        for (size_t i = 0; i < inst.argRegs.size(); ++i)
+        {
+            if (i) os << ", ";
+            os << getDataTypeName(inst.argRegs[i].first) << ' ';
+            printOperand(inst.argRegs[i].second, os);
+        }
+        os << ')' << inst.getComment();
     }
-    void IRPrinter::visit(RetInst& inst, std::ostream& os)
+    void IRPrinter::visit(RetInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        os << "ret " << getDataTypeName(inst.rt);
+        if (inst.res)
+        {
+            os << ' ';
+            printOperand(inst.res, os);
+        }
+        os << inst.getComment();
     }
-    void IRPrinter::visit(GEPInst& inst, std::ostream& os)
+    void IRPrinter::visit(GEPInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.res, os);
+        os << " = getelementptr ";
+        printArrayType(inst.dims, 0, inst.dt, os);
+        os << ", ptr ";
+        printOperand(inst.basePtr, os);
+        for (auto* idx : inst.idxs)
+        {
+            os << ", " << getDataTypeName(inst.idxType) << ' ';
+            printOperand(idx, os);
+        }
+        os << inst.getComment();
     }
-    void IRPrinter::visit(FP2SIInst& inst, std::ostream& os)
+    void IRPrinter::visit(FP2SIInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.dest, os);
+        os << " = fptosi float ";
+        printOperand(inst.src, os);
+        os << " to i32" << inst.getComment();
     }
-    void IRPrinter::visit(SI2FPInst& inst, std::ostream& os)
+    void IRPrinter::visit(SI2FPInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.dest, os);
+        os << " = sitofp i32 ";
+        printOperand(inst.src, os);
+        os << " to float" << inst.getComment();
     }
-    void IRPrinter::visit(ZextInst& inst, std::ostream& os)
+    void IRPrinter::visit(ZextInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.dest, os);
+        os << " = zext " << getDataTypeName(inst.from) << ' ';
+        printOperand(inst.src, os);
+        os << " to " << getDataTypeName(inst.to) << inst.getComment();
     }
-    void IRPrinter::visit(PhiInst& inst, std::ostream& os)
+    void IRPrinter::visit(PhiInst& inst, OutBuffer& os)
     {
-        (void)inst;
-        os << inst.toString();
+        printOperand(inst.res, os);
+        os << " = phi " << getDataTypeName(inst.dt) << ' ';
+        bool first = true;
+        for (auto& [label, val] : inst.incomingVals)
+        {
+            if (!first) os << ", ";
+            first = false;
+            os << "[ ";
+            printOperand(val, os);
+            os << ", ";
+            printOperand(label, os);
+            os << " ]";
+        }
+        os << inst.getComment();
     }
 }  // namespace ME
@@ -2,13 +2,13 @@
 
 namespace ME
 {
-    void IRPrinter::visit(Module& module, std::ostream& os)
+    void IRPrinter::visit(Module& module, OutBuffer& os)
     {
         os << "; Function Declarations\n";
         for (auto& fdecl : module.funcDecls)
         {
             apply(*this, *fdecl, os);
-            if (&fdecl != &module.funcDecls.back()) os << "\n";
+            if (&fdecl != &module.funcDecls.back()) os << '\n';
         }
         os << "\n\n";
 
@@ -16,7 +16,7 @@ namespace ME
         for (auto& gdef : module.globalVars)
         {
             apply(*this, *gdef, os);
-            if (&gdef != &module.globalVars.back()) os << "\n";
+            if (&gdef != &module.globalVars.back()) os << '\n';
         }
         os << "\n\n";
 
@@ -24,24 +24,24 @@ namespace ME
         for (auto& func : module.functions)
         {
             apply(*this, *func, os);
-            if (&func != &module.functions.back()) os << "\n";
+            if (&func != &module.functions.back()) os << '\n';
         }
     }
-    void IRPrinter::visit(Function& func, std::ostream& os)
+    void IRPrinter::visit(Function& func, OutBuffer& os)
     {
         apply(*this, *func.funcDef, os);
         os << "\n{\n";
         for (auto& [id, block] : func.blocks) apply(*this, *block, os);
         os << "}\n";
     }
-    void IRPrinter::visit(Block& block, std::ostream& os)
+    void IRPrinter::visit(Block& block, OutBuffer& os)
     {
         os << "Block" << block.blockId << ":" << block.getComment() << "\n";
-        for (auto& inst : block.insts)
+        for (auto* inst : block.insts)
         {
-            os << "\t";
+            os << '\t';
             apply(*this, *inst, os);
-            os << "\n";
+            os << '\n';
         }
     }
 }  // namespace ME
@@ -3,36 +3,49 @@
 
 #include <middleend/ir_visitor.h>
 #include <middleend/module/ir_module.h>
+#include <out_buffer.h>
 
 namespace ME
 {
-    using Printer_t = Visitor_t<void, std::ostream&>;
+    /*
+     * LLVM IR 文本输出
+     *
+     * 直接把各指令写入 OutBuffer，不经过 Instruction::toString() 的 stringstream 拼接；
+     * Instruction::toString() 保留用于调试时打印单条指令，两者输出格式保持一致。
+     */
+    using Printer_t = Visitor_t<void, OutBuffer&>;
 
     class IRPrinter : public Printer_t
     {
       public:
-        void visit(Module& module, std::ostream& os) override;
-        void visit(Function& func, std::ostream& os) override;
-        void visit(Block& block, std::ostream& os) override;
+        void visit(Module& module, OutBuffer& os) override;
+        void visit(Function& func, OutBuffer& os) override;
+        void visit(Block& block, OutBuffer& os) override;
 
-        void visit(LoadInst& inst, std::ostream& os) override;
-        void visit(StoreInst& inst, std::ostream& os) override;
-        void visit(ArithmeticInst& inst, std::ostream& os) override;
-        void visit(IcmpInst& inst, std::ostream& os) override;
-        void visit(FcmpInst& inst, std::ostream& os) override;
-        void visit(AllocaInst& inst, std::ostream& os) override;
-        void visit(BrCondInst& inst, std::ostream& os) override;
-        void visit(BrUncondInst& inst, std::ostream& os) override;
-        void visit(GlbVarDeclInst& inst, std::ostream& os) override;
-        void visit(CallInst& inst, std::ostream& os) override;
-        void visit(FuncDeclInst& inst, std::ostream& os) override;
-        void visit(FuncDefInst& inst, std::ostream& os) override;
-        void visit(RetInst& inst, std::ostream& os) override;
-        void visit(GEPInst& inst, std::ostream& os) override;
-        void visit(FP2SIInst& inst, std::ostream& os) override;
-        void visit(SI2FPInst& inst, std::ostream& os) override;
-        void visit(ZextInst& inst, std::ostream& os) override;
-        void visit(PhiInst& inst, std::ostream& os) override;
+        void visit(LoadInst& inst, OutBuffer& os) override;
+        void visit(StoreInst& inst, OutBuffer& os) override;
+        void visit(ArithmeticInst& inst, OutBuffer& os) override;
+        void visit(IcmpInst& inst, OutBuffer& os) override;
+        void visit(FcmpInst& inst, OutBuffer& os) override;
+        void visit(AllocaInst& inst, OutBuffer& os) override;
+        void visit(BrCondInst& inst, OutBuffer& os) override;
+        void visit(BrUncondInst& inst, OutBuffer& os) override;
+        void visit(GlbVarDeclInst& inst, OutBuffer& os) override;
+        void visit(CallInst& inst, OutBuffer& os) override;
+        void visit(FuncDeclInst& inst, OutBuffer& os) override;
+        void visit(FuncDefInst& inst, OutBuffer& os) override;
+        void visit(RetInst& inst, OutBuffer& os) override;
+        void visit(GEPInst& inst, OutBuffer& os) override;
+        void visit(FP2SIInst& inst, OutBuffer& os) override;
+        void visit(SI2FPInst& inst, OutBuffer& os) override;
+        void visit(ZextInst& inst, OutBuffer& os) override;
+        void visit(PhiInst& inst, OutBuffer& os) override;
+
+      private:
+        void printOperand(const Operand* op, OutBuffer& os);
+        void printArrayType(const std::vector<int>& dims, size_t from, DataType dt, OutBuffer& os);
+        void printGlobalArrayInit(DataType type, const FE::AST::VarAttr& v, size_t dimDph, size_t beginPos,
+            size_t endPos, OutBuffer& os);
     };
 }  // namespace ME
 
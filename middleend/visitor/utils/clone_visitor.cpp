@@ -2,13 +2,13 @@
 
 namespace ME
 {
-    Instruction* InstCloner::visit(LoadInst& inst) { return new LoadInst(inst.dt, inst.ptr, inst.res, inst.comment); }
+    Instruction* InstCloner::visit(LoadInst& inst) { return new LoadInst(inst.dt, inst.ptr, inst.res, inst.getCommentText()); }
 
-    Instruction* InstCloner::visit(StoreInst& inst) { return new StoreInst(inst.dt, inst.val, inst.ptr, inst.comment); }
+    Instruction* InstCloner::visit(StoreInst& inst) { return new StoreInst(inst.dt, inst.val, inst.ptr, inst.getCommentText()); }
 
     Instruction* InstCloner::visit(ArithmeticInst& inst)
     {
-        return new ArithmeticInst(inst.opcode, inst.dt, inst.lhs, inst.rhs, inst.res, inst.comment);
+        return new ArithmeticInst(inst.opcode, inst.dt, inst.lhs, inst.rhs, inst.res, inst.getCommentText());
     }
 
     Instruction* InstCloner::visit(IcmpInst& inst)
@@ -23,15 +23,15 @@ namespace ME
 
     Instruction* InstCloner::visit(AllocaInst& inst)
     {
-        return new AllocaInst(inst.dt, inst.res, inst.dims, inst.comment);
+        return new AllocaInst(inst.dt, inst.res, inst.dims, inst.getCommentText());
     }
 
     Instruction* InstCloner::visit(BrCondInst& inst)
     {
-        return new BrCondInst(inst.cond, inst.trueTar, inst.falseTar, inst.comment);
+        return new BrCondInst(inst.cond, inst.trueTar, inst.falseTar, inst.getCommentText());
     }
 
-    Instruction* InstCloner::visit(BrUncondInst& inst) { return new BrUncondInst(inst.target, inst.comment); }
+    Instruction* InstCloner::visit(BrUncondInst& inst) { return new BrUncondInst(inst.target, inst.getCommentText()); }
 
     Instruction* InstCloner::visit(GlbVarDeclInst& inst)
     {
@@ -41,20 +41,20 @@ namespace ME
 
     Instruction* InstCloner::visit(CallInst& inst)
     {
-        return new CallInst(inst.retType, inst.funcName, inst.args, inst.res, inst.comment);
+        return new CallInst(inst.retType, inst.funcName, inst.args, inst.res, inst.getCommentText());
     }
 
     Instruction* InstCloner::visit(FuncDeclInst& inst)
     {
-        return new FuncDeclInst(inst.retType, inst.funcName, inst.argTypes, inst.isVarArg, inst.comment);
+        return new FuncDeclInst(inst.retType, inst.funcName, inst.argTypes, inst.isVarArg, inst.getCommentText());
     }
 
     Instruction* InstCloner::visit(FuncDefInst& inst)
     {
-        return new FuncDefInst(inst.retType, inst.funcName, inst.argRegs, inst.comment);
+        return new FuncDefInst(inst.retType, inst.funcName, inst.argRegs, inst.getCommentText());
     }
 
-    Instruction* InstCloner::visit(RetInst& inst) { return new RetInst(inst.rt, inst.res, inst.comment); }
+    Instruction* InstCloner::visit(RetInst& inst) { return new RetInst(inst.rt, inst.res, inst.getCommentText()); }
 
     Instruction* InstCloner::visit(GEPInst& inst)
     {
@@ -69,7 +69,7 @@ namespace ME
 
     Instruction* InstCloner::visit(PhiInst& inst)
     {
-        auto* phi         = new PhiInst(inst.dt, inst.res, inst.comment);
+        auto* phi         = new PhiInst(inst.dt, inst.res, inst.getCommentText());
         phi->incomingVals = inst.incomingVals;
         return phi;
     }
@@ -7,9 +7,9 @@ namespace ME
     {
         if (!operand || operand->getType() != OperandType::REG) return;
 
-        auto it = renameMap.find(operand->getRegNum());
-        if (it == renameMap.end()) return;
-        operand = getRegOperand(it->second);
+        const size_t* renamed = renameMap.lookup(operand->getRegNum());
+        if (!renamed) return;
+        operand = getRegOperand(*renamed);
     }
 
     void RegRename::visit(LoadInst& inst, RegMap& rm)
@@ -104,7 +104,7 @@ namespace ME
     void RegRename::visit(PhiInst& inst, RegMap& rm)
     {
         renameReg(inst.res, rm);
-        std::map<Operand*, Operand*> newIncomingVals;
+        PhiInst::IncomingMap newIncomingVals;
         for (auto& [label, val] : inst.incomingVals)
         {
             Operand* newVal = val;
@@ -217,7 +217,7 @@ namespace ME
     void OperandRename::visit(PhiInst& inst, OperandMap& rm)
     {
         renameOperand(inst.res, rm);
-        std::map<Operand*, Operand*> newIncomingVals;
+        PhiInst::IncomingMap newIncomingVals;
         for (auto& [label, val] : inst.incomingVals)
         {
             Operand* newVal = val;
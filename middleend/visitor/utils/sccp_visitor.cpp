@@ -34,12 +34,8 @@ namespace ME
             // 只有值变更才通知使用者，减少无效迭代
             pass.valueMap[reg] = merged;
 
-            auto it = pass.userMap.find(reg);
-            if (it != pass.userMap.end())
-            {
-                // 使用点入队：reg 的格值变化，只可能影响“使用 reg 的指令”的求值结果
-                for (auto* user : it->second) { pass.instWorklist.push_back(user); }
-            }
+            // 使用点入队：reg 的格值变化，只可能影响“使用 reg 的指令”的求值结果
+            for (auto& use : pass.defUse->getUses(reg)) { pass.instWorklist.push_back(use.user); }
         }
     }
 
@@ -50,7 +46,7 @@ namespace ME
     {
         if (!pass.currFunc) return;
         // 插入可达边集合，若已存在则不处理
-        if (!pass.reachableEdges.insert({from, to}).second) return;
+        if (!pass.reachableEdges[to].insert(from)) return;
 
         // 获得后继基本块指针
         Block* succ = pass.currFunc->getBlock(to);
@@ -59,7 +55,7 @@ namespace ME
         // 可达性传播的入队策略：
         // - 后继块第一次变可达：整块入队（需要扫描所有指令以初始化/传播格值）
         // - 后继块已可达但新增一条可达入边：只把 Phi 入队（只有 Phi 依赖前驱边集合）
-        if (pass.reachableBlocks.insert(to).second) { pass.blockWorklist.push_back(succ); }
+        if (pass.reachableBlocks.insert(to)) { pass.blockWorklist.push_back(succ); }
         else
         {
             // 如果后继块已在可达集合中，
@@ -128,8 +124,7 @@ namespace ME
         {
             // 寄存器从 lattice 表中读取，不存在则视为 UNDEF
             size_t reg = op->getRegNum();
-            auto   it  = pass.valueMap.find(reg);
-            if (it != pass.valueMap.end()) return it->second;
+            if (auto* val = pass.valueMap.lookup(reg)) return *val;
             return makeUndef();
         }
         // 其他操作数类型视为 OVERDEFINED
@@ -537,7 +532,8 @@ namespace ME
             if (!labelOp || labelOp->getType() != OperandType::LABEL) continue;
             size_t predId = labelOp->getLabelNum();
             // 如果前驱块不可达则跳过
-            if (pass.reachableEdges.count({predId, block->blockId}) == 0) continue;
+            auto* preds = pass.reachableEdges.lookup(block->blockId);
+            if (!preds || !preds->count(predId)) continue;
 
             // 可达前驱：合并该 incoming 的格值
             hasIncoming = true;
@@ -555,80 +551,13 @@ namespace ME
         // 更新 Phi 结果格值
         updateValue(pass, inst.res, result);
     }
-
-    // 把已知 寄存器操作数替换为对应常量
-    void SCCPReplaceVisitor::replaceOperandIfConst(SCCPPass& pass, Operand*& op)
-    {
-        // 仅做“寄存器 -> 立即数常量”替换：
-        // - 只在 valueMap 中标记为 CONST 的寄存器才替换
-        // - OVERDEFINED/UNDEF 不做替换，保证语义保守
-        if (!op || op->getType() != OperandType::REG) return;
-
-        // 获取对应格值
-        auto it = pass.valueMap.find(op->getRegNum());
-        if (it == pass.valueMap.end()) return;
-        const auto& val = it->second;
-
-        // 只有常量格值才替换
-        if (val.kind != SCCPPass::LatticeKind::CONST) return;
-
-        // 直接替换为对应的立即数操作数
-        if (val.type == DataType::F32) { op = getImmeF32Operand(val.f32); }
-        else { op = getImmeI32Operand(val.i32); }
-    }
-
-    void SCCPReplaceVisitor::visit(LoadInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.ptr); }
-    void SCCPReplaceVisitor::visit(StoreInst& inst, SCCPPass& pass)
-    {
-        replaceOperandIfConst(pass, inst.ptr);
-        replaceOperandIfConst(pass, inst.val);
-    }
-    void SCCPReplaceVisitor::visit(ArithmeticInst& inst, SCCPPass& pass)
-    {
-        replaceOperandIfConst(pass, inst.lhs);
-        replaceOperandIfConst(pass, inst.rhs);
-    }
-    void SCCPReplaceVisitor::visit(IcmpInst& inst, SCCPPass& pass)
-    {
-        replaceOperandIfConst(pass, inst.lhs);
-        replaceOperandIfConst(pass, inst.rhs);
-    }
-    void SCCPReplaceVisitor::visit(FcmpInst& inst, SCCPPass& pass)
-    {
-        replaceOperandIfConst(pass, inst.lhs);
-        replaceOperandIfConst(pass, inst.rhs);
-    }
-    void SCCPReplaceVisitor::visit(AllocaInst& inst, SCCPPass& pass) { (void)inst; }
-    void SCCPReplaceVisitor::visit(BrCondInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.cond); }
-    void SCCPReplaceVisitor::visit(BrUncondInst& inst, SCCPPass& pass) { (void)inst; }
-    void SCCPReplaceVisitor::visit(GlbVarDeclInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.init); }
-    void SCCPReplaceVisitor::visit(CallInst& inst, SCCPPass& pass)
-    {
-        for (auto& arg : inst.args) { replaceOperandIfConst(pass, arg.second); }
-    }
-    void SCCPReplaceVisitor::visit(FuncDeclInst& inst, SCCPPass& pass) { (void)inst; }
-    void SCCPReplaceVisitor::visit(FuncDefInst& inst, SCCPPass& pass) { (void)inst; }
-    void SCCPReplaceVisitor::visit(RetInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.res); }
-    void SCCPReplaceVisitor::visit(GEPInst& inst, SCCPPass& pass)
-    {
-        replaceOperandIfConst(pass, inst.basePtr);
-        for (auto& idx : inst.idxs) replaceOperandIfConst(pass, idx);
-    }
-    void SCCPReplaceVisitor::visit(FP2SIInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.src); }
-    void SCCPReplaceVisitor::visit(SI2FPInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.src); }
-    void SCCPReplaceVisitor::visit(ZextInst& inst, SCCPPass& pass) { replaceOperandIfConst(pass, inst.src); }
-    void SCCPReplaceVisitor::visit(PhiInst& inst, SCCPPass& pass)
-    {
-        for (auto& [label, val] : inst.incomingVals) { replaceOperandIfConst(pass, val); }
-    }
-
 }  // namespace ME
 
 /*
 SCCP 格值更新策略总结（本文件实现）：
 1) 格定义：UNDEF < CONST < OVERDEFINED，mergeValue 保证格值单调上升并最终收敛。
 2) updateValue：先 merge(curr, new)，只有格值真正变化（kind 变化或 CONST 值变化）才写回 valueMap，
-   并将该寄存器的所有使用点（userMap[reg]）入 instWorklist 做增量重算。
+   并将该寄存器的所有使用点（defUse->getUses(reg)）入 instWorklist 做增量重算。
 3) 可达性传播：markEdgeReachable 首次发现可达边(from,to)才处理；若 to 块首次变可达则整块入 blockWorklist，
    否则仅把 to 块开头的 Phi 入 instWorklist（因为新增可达入边只会影响 Phi 合并）。
 4) Phi 求值：仅合并 reachableEdges 中存在的 incoming（可达前驱），避免不可达路径污染格值。
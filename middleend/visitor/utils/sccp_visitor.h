@@ -40,33 +40,6 @@ namespace ME
         SCCPPass::LatticeVal mergeValue(const SCCPPass::LatticeVal& lhs, const SCCPPass::LatticeVal& rhs) const;
     };
 
-    // SCCP 常量替换：将可确定寄存器替换为立即数
-    class SCCPReplaceVisitor : public InsVisitor_t<void, SCCPPass&>
-    {
-      public:
-        void visit(LoadInst& inst, SCCPPass& pass) override;
-        void visit(StoreInst& inst, SCCPPass& pass) override;
-        void visit(ArithmeticInst& inst, SCCPPass& pass) override;
-        void visit(IcmpInst& inst, SCCPPass& pass) override;
-        void visit(FcmpInst& inst, SCCPPass& pass) override;
-        void visit(AllocaInst& inst, SCCPPass& pass) override;
-        void visit(BrCondInst& inst, SCCPPass& pass) override;
-        void visit(BrUncondInst& inst, SCCPPass& pass) override;
-        void visit(GlbVarDeclInst& inst, SCCPPass& pass) override;
-        void visit(CallInst& inst, SCCPPass& pass) override;
-        void visit(FuncDeclInst& inst, SCCPPass& pass) override;
-        void visit(FuncDefInst& inst, SCCPPass& pass) override;
-        void visit(RetInst& inst, SCCPPass& pass) override;
-        void visit(GEPInst& inst, SCCPPass& pass) override;
-        void visit(FP2SIInst& inst, SCCPPass& pass) override;
-        void visit(SI2FPInst& inst, SCCPPass& pass) override;
-        void visit(ZextInst& inst, SCCPPass& pass) override;
-        void visit(PhiInst& inst, SCCPPass& pass) override;
-
-      private:
-        void replaceOperandIfConst(SCCPPass& pass, Operand*& op);
-    };
-
 }  // namespace ME
 
 #endif  // __MIDDLEEND_VISITOR_UTILS_SCCP_VISITOR_H__
@@ -103,92 +103,4 @@ namespace ME
     void DefCollector::visit(SI2FPInst& inst) { defReg = getReg(inst.dest); }
     void DefCollector::visit(ZextInst& inst) { defReg = getReg(inst.dest); }
     void DefCollector::visit(PhiInst& inst) { defReg = getReg(inst.res); }
-
-    // 收集使用指定寄存器的指令列表
-    void UserCollector::addUse(Operand* op)
-    {
-        if (op && op->getType() == OperandType::REG) { userMap[op->getRegNum()].push_back(currentInst); }
-    }
-
-    void UserCollector::visit(LoadInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.ptr);
-    }
-    void UserCollector::visit(StoreInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.ptr);
-        addUse(inst.val);
-    }
-    void UserCollector::visit(ArithmeticInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.lhs);
-        addUse(inst.rhs);
-    }
-    void UserCollector::visit(IcmpInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.lhs);
-        addUse(inst.rhs);
-    }
-    void UserCollector::visit(FcmpInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.lhs);
-        addUse(inst.rhs);
-    }
-    void UserCollector::visit(AllocaInst& inst)
-    { /* no uses */
-    }
-    void UserCollector::visit(BrCondInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.cond);
-    }
-    void UserCollector::visit(BrUncondInst& inst)
-    { /* no uses */
-    }
-    void UserCollector::visit(GlbVarDeclInst& inst)
-    { /* no uses */
-    }
-    void UserCollector::visit(CallInst& inst)
-    {
-        currentInst = &inst;
-        for (auto& arg : inst.args) addUse(arg.second);
-    }
-    void UserCollector::visit(FuncDeclInst& inst) {}
-    void UserCollector::visit(FuncDefInst& inst) {}
-    void UserCollector::visit(RetInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.res);
-    }
-    void UserCollector::visit(GEPInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.basePtr);
-        for (auto* idx : inst.idxs) addUse(idx);
-    }
-    void UserCollector::visit(FP2SIInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.src);
-    }
-    void UserCollector::visit(SI2FPInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.src);
-    }
-    void UserCollector::visit(ZextInst& inst)
-    {
-        currentInst = &inst;
-        addUse(inst.src);
-    }
-    void UserCollector::visit(PhiInst& inst)
-    {
-        currentInst = &inst;
-        for (auto& [label, val] : inst.incomingVals) addUse(val);
-    }
 }  // namespace ME
@@ -71,38 +71,6 @@ namespace ME
       private:
         size_t getReg(Operand* op);
     };
-
-    // 收集使用某寄存器的所有指令
-    class UserCollector : public InsVisitor_t<void>
-    {
-      public:
-        std::map<size_t, std::vector<Instruction*>> userMap;  // 寄存器编号 -> 使用该寄存器的指令列表
-        Instruction*                                currentInst = nullptr;
-
-        UserCollector() = default;
-
-        void visit(LoadInst& inst) override;
-        void visit(StoreInst& inst) override;
-        void visit(ArithmeticInst& inst) override;
-        void visit(IcmpInst& inst) override;
-        void visit(FcmpInst& inst) override;
-        void visit(AllocaInst& inst) override;
-        void visit(BrCondInst& inst) override;
-        void visit(BrUncondInst& inst) override;
-        void visit(GlbVarDeclInst& inst) override;
-        void visit(CallInst& inst) override;
-        void visit(FuncDeclInst& inst) override;
-        void visit(FuncDefInst& inst) override;
-        void visit(RetInst& inst) override;
-        void visit(GEPInst& inst) override;
-        void visit(FP2SIInst& inst) override;
-        void visit(SI2FPInst& inst) override;
-        void visit(ZextInst& inst) override;
-        void visit(PhiInst& inst) override;
-
-      private:
-        void addUse(Operand* op);
-    };
 }  // namespace ME
 
 #endif
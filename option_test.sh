@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# 在不应改变结果的编译选项下运行 RISC-V 功能测试：
+# 程序须运行正确，且输出与对照选项下的输出逐字节一致
+# 用法: ./option_test.sh [Basic|Advanced] [0|1|2]
+
+GROUP="${1:-Advanced}"
+OPT="${2:-2}"
+
+# 并行编译与单线程编译的输出一致
+python3 test.py --group "$GROUP" --stage riscv --opt "$OPT" --flags=-j4 --compare-flags=-j1
+# 流式逐函数编译与整模块编译的输出一致
+python3 test.py --group "$GROUP" --stage riscv --opt "$OPT" --flags=-fstreaming --compare-flags=
+# 直接输出的目标文件可以链接运行
+python3 test.py --group "$GROUP" --stage riscv-obj --opt "$OPT"
@@ -0,0 +1,107 @@
+"""
+This script tests the -passes= pipeline parser of the SysY compiler.
+Each case in testcase/passes/pipelines.txt is either a valid pipeline, which
+must compile pipeline.sy to LLVM IR that runs with the expected output, or a
+malformed one, which must be rejected with the given error message.
+"""
+import subprocess
+import os
+import sys
+
+SYSY = "bin/compiler"
+CASES_DIR = "testcase/passes"
+CASES_FILE = os.path.join(CASES_DIR, "pipelines.txt")
+SOURCE = os.path.join(CASES_DIR, "pipeline.sy")
+STD_OUTPUT = os.path.join(CASES_DIR, "pipeline.out")
+TEST_OUTPUT_DIR = "test_output"
+
+IR_TIMEOUT = "30"
+EXEC_TIMEOUT = "10"
+ERROR_PREFIX = "Error: invalid -passes pipeline: "
+
+
+def load_cases():
+    """Reads (expected, pipeline) pairs, skipping blank lines and comments."""
+    cases = []
+    with open(CASES_FILE, "r", encoding="utf-8") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not line.strip() or line.startswith("#"):
+                continue
+            expected, pipeline = line.split("|", 1)
+            cases.append((expected.strip(), pipeline.strip()))
+    return cases
+
+
+def run_valid(pipeline: str, index: int):
+    """Compiles SOURCE with the pipeline, runs it and compares the output."""
+    ir_file = os.path.join(TEST_OUTPUT_DIR, f"pipeline{index}.ll")
+    act_file = os.path.join(TEST_OUTPUT_DIR, f"pipeline{index}.act")
+    res = subprocess.run(
+        ["timeout", IR_TIMEOUT, SYSY, SOURCE, "-llvm", "-o", ir_file, f"-passes={pipeline}"],
+        capture_output=True, text=True, check=False)
+    if res.returncode != 0:
+        return f"rejected: {res.stderr.strip().splitlines()[0] if res.stderr.strip() else res.returncode}"
+
+    res = subprocess.run(
+        ["clang", ir_file, "-o", "tmp.bin", "-static", "-L./lib", "-lsysy_x86", "-w"],
+        stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
+    if res.returncode != 0:
+        return "link error"
+
+    with open(act_file, "w", encoding="utf-8") as out:
+        res = subprocess.run(["timeout", EXEC_TIMEOUT, "./tmp.bin"],
+                             stdout=out, stderr=subprocess.DEVNULL, check=False)
+    subprocess.run(["rm", "-f", "tmp.bin"], check=False)
+    with open(act_file, "r", encoding="utf-8") as f:
+        content = f.read()
+    if content and not content.endswith("\n"):
+        content += "\n"
+    content += f"{res.returncode}\n"
+    with open(STD_OUTPUT, "r", encoding="utf-8") as f:
+        expected = f.read()
+    if content.split() != expected.split():
+        return "wrong answer"
+    return None
+
+
+def run_invalid(pipeline: str, message: str):
+    """Checks that the compiler rejects the pipeline with the expected message."""
+    res = subprocess.run(
+        ["timeout", IR_TIMEOUT, SYSY, SOURCE, "-llvm", "-o", "/dev/null", f"-passes={pipeline}"],
+        capture_output=True, text=True, check=False)
+    if res.returncode == 0:
+        return "accepted"
+    if ERROR_PREFIX + message not in res.stderr.splitlines():
+        first = res.stderr.strip().splitlines()[0] if res.stderr.strip() else ""
+        return f"unexpected message: {first}"
+    return None
+
+
+def main():
+    """Runs every pipeline case and reports the pass count."""
+    if not os.path.exists(TEST_OUTPUT_DIR):
+        os.makedirs(TEST_OUTPUT_DIR)
+
+    cases = load_cases()
+    passed = 0
+    for index, (expected, pipeline) in enumerate(cases):
+        if expected == "ok":
+            failure = run_valid(pipeline, index)
+        else:
+            failure = run_invalid(pipeline, expected)
+        shown = f"-passes={pipeline}"
+        if failure is None:
+            passed += 1
+            print(f"\033[92mAccepted\033[0m      {shown}")
+        else:
+            print(f"\033[91mFailed\033[0m        {shown}  ({failure})")
+
+    print("\n" + "=" * 30)
+    print(f"\tPipelines Passed: {passed} / {len(cases)}")
+    print("=" * 30)
+    sys.exit(0 if passed == len(cases) else 1)
+
+
+if __name__ == "__main__":
+    main()
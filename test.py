@@ -7,8 +7,9 @@ import subprocess
 import os
 import sys
 import argparse
-from typing import Optional
-from dataclasses import dataclass
+import shlex
+from typing import List, Optional
+from dataclasses import dataclass, field
 from contextlib import ExitStack
 
 
@@ -21,6 +22,8 @@ class TestConfig:
     std_input: Optional[str]
     std_output: str
     act_output: str
+    flags: List[str] = field(default_factory=list)
+    compare_flags: Optional[List[str]] = None
 
 
 SYSY = "bin/compiler"
@@ -122,12 +125,12 @@ def add_returncode(file, ret):
     return False
 
 
-def _compile_to_ir(src_file: str, target_file: str, opt_level: int, test_name: str):
+def _compile_to_ir(src_file: str, target_file: str, opt_level: int, test_name: str, flags: List[str]):
     """Compiles the input SysY file to LLVM IR."""
     print_test_status(test_name, "Compiling sy to ir")
     res = subprocess.run([
         "timeout", IR_TIMEOUT,
-        SYSY, src_file, "-llvm", "-o", target_file, f"-O{opt_level}"
+        SYSY, src_file, "-llvm", "-o", target_file, f"-O{opt_level}", *flags
     ], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
     if res.returncode == 124:
         print_test_status(test_name, "\033[93mCompile Time Limit Exceed\033[0m", final=True)
@@ -218,12 +221,12 @@ def _run_ir_and_check(test_cfg: TestConfig, test_name: str):
     return True
 
 
-def _compile_to_asm(src_file: str, target_file: str, opt_level: int, test_name: str):
+def _compile_to_asm(src_file: str, target_file: str, opt_level: int, test_name: str, flags: List[str]):
     """Compiles the input SysY file to RISC-V assembly."""
     print_test_status(test_name, "Compiling sy to asm")
     res = subprocess.run([
         "timeout", ASM_TIMEOUT,
-        SYSY, src_file, "-S", "-o", target_file, f"-O{opt_level}"
+        SYSY, src_file, "-S", "-o", target_file, f"-O{opt_level}", *flags
     ], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
     if res.returncode == 124:
         print_test_status(test_name, "\033[93mCompile Time Limit Exceed\033[0m", final=True)
@@ -234,6 +237,55 @@ def _compile_to_asm(src_file: str, target_file: str, opt_level: int, test_name:
     return True
 
 
+def _compile_to_obj(src_file: str, target_file: str, opt_level: int, test_name: str, flags: List[str]):
+    """Compiles the input SysY file directly to a RISC-V object file (-c)."""
+    print_test_status(test_name, "Compiling sy to object")
+    res = subprocess.run([
+        "timeout", ASM_TIMEOUT,
+        SYSY, src_file, "-c", "-o", target_file, f"-O{opt_level}", *flags
+    ], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
+    if res.returncode == 124:
+        print_test_status(test_name, "\033[93mCompile Time Limit Exceed\033[0m", final=True)
+        return False
+    if res.returncode != 0:
+        print_test_status(test_name, "\033[93mCompiler Error\033[0m", final=True)
+        return False
+    return True
+
+
+def _link_obj_riscv(target_file: str, src_file: str, test_name: str):
+    """Links a RISC-V object file emitted by the compiler into an executable."""
+    global RISCV_GCC, TEXT_ADDR
+
+    print_test_status(test_name, "Linking object to exec")
+    res = subprocess.run([
+        RISCV_GCC, target_file, "-o", "tmp.bin",
+        "-L./lib", "-lsysy_riscv",
+        "-static", "-mcmodel=medany",
+        f"-Wl,--no-relax,-Ttext={TEXT_ADDR}"
+    ], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
+    if res.returncode != 0:
+        print_test_status(test_name, "\033[93mLink Error\033[0m", final=True)
+        return False
+    return True
+
+
+def _compare_output(compile_func, test_cfg: TestConfig, test_name: str):
+    """Recompiles with compare_flags and checks the output is byte-identical to the one under test."""
+    if test_cfg.compare_flags is None:
+        return True
+    ref_file = test_cfg.output_file + ".ref"
+    if not compile_func(test_cfg.input_file, ref_file, test_cfg.opt_level, test_name, test_cfg.compare_flags):
+        return False
+    print_test_status(test_name, "Comparing output")
+    res = subprocess.run(["cmp", "-s", test_cfg.output_file, ref_file], check=False)
+    subprocess.run(["rm", "-f", ref_file], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
+    if res.returncode != 0:
+        print_test_status(test_name, "\033[91mOutput Mismatch\033[0m", final=True)
+        return False
+    return True
+
+
 def _compile_asm_and_link_riscv(target_file: str, src_file: str, test_name: str):
     """Compiles RISC-V assembly to object file and links it into an executable."""
     global RISCV_GCC, TEXT_ADDR
@@ -309,13 +361,13 @@ def _run_riscv_and_check(test_cfg: TestConfig, test_name: str):
     return True
 
 
-def _compile_to_asm_arm(src_file: str, target_file: str, opt_level: int, test_name: str):
+def _compile_to_asm_arm(src_file: str, target_file: str, opt_level: int, test_name: str, flags: List[str]):
     """Compiles the input SysY file to AArch64 assembly."""
     print_test_status(test_name, "Compiling sy to asm")
     res = subprocess.run([
         "timeout", ASM_TIMEOUT,
         SYSY, src_file, "-S", "-o", target_file, f"-O{opt_level}",
-        "-march", "aarch64"
+        "-march", "aarch64", *flags
     ], stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, check=False)
     if res.returncode == 124:
         print_test_status(test_name, "\033[93mCompile Time Limit Exceed\033[0m", final=True)
@@ -402,7 +454,10 @@ def _execute_ir(test_cfg: TestConfig):
     # Print test case name at the beginning
     test_name = os.path.basename(test_cfg.input_file)
     
-    if not _compile_to_ir(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name):
+    if not _compile_to_ir(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name, test_cfg.flags):
+        return False
+
+    if not _compare_output(_compile_to_ir, test_cfg, test_name):
         return False
 
     if not _check_ir_syntax(test_cfg.output_file, test_cfg.input_file, test_name):
@@ -422,7 +477,10 @@ def _execute_riscv(test_cfg: TestConfig):
     """Full pipeline to compile, run, and check a SysY file via RISC-V assembly."""
     test_name = os.path.basename(test_cfg.input_file)
     
-    if not _compile_to_asm(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name):
+    if not _compile_to_asm(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name, test_cfg.flags):
+        return False
+
+    if not _compare_output(_compile_to_asm, test_cfg, test_name):
         return False
 
     if not _compile_asm_and_link_riscv(test_cfg.output_file, test_cfg.input_file, test_name):
@@ -435,11 +493,34 @@ def _execute_riscv(test_cfg: TestConfig):
     return True
 
 
+def _execute_riscv_obj(test_cfg: TestConfig):
+    """Full pipeline to compile, run, and check a SysY file via a RISC-V object file emitted with -c."""
+    test_name = os.path.basename(test_cfg.input_file)
+
+    if not _compile_to_obj(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name, test_cfg.flags):
+        return False
+
+    if not _compare_output(_compile_to_obj, test_cfg, test_name):
+        return False
+
+    if not _link_obj_riscv(test_cfg.output_file, test_cfg.input_file, test_name):
+        return False
+
+    if not _run_riscv_and_check(test_cfg, test_name):
+        return False
+
+    print_test_status(test_name, "\033[92mAccepted\033[0m", final=True)
+    return True
+
+
 def _execute_arm(test_cfg: TestConfig):
     """Full pipeline to compile, run, and check a SysY file via AArch64 assembly."""
     test_name = os.path.basename(test_cfg.input_file)
     
-    if not _compile_to_asm_arm(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name):
+    if not _compile_to_asm_arm(test_cfg.input_file, test_cfg.output_file, test_cfg.opt_level, test_name, test_cfg.flags):
+        return False
+
+    if not _compare_output(_compile_to_asm_arm, test_cfg, test_name):
         return False
 
     if not _compile_asm_and_link_arm(test_cfg.output_file, test_cfg.input_file, test_name):
@@ -460,10 +541,14 @@ def main():
         description="SysY Compiler Testing Script")
     parser.add_argument("--group", default="Advanced", choices=["Basic", "Advanced"],
                         help="Test case group to run.")
-    parser.add_argument("--stage", default="llvm", choices=["llvm", "riscv", "arm"],
+    parser.add_argument("--stage", default="llvm", choices=["llvm", "riscv", "riscv-obj", "arm"],
                         help="Testing stage.")
     parser.add_argument("--opt", default=1, type=int, choices=[0, 1, 2],
                         help="Optimization level.")
+    parser.add_argument("--flags", default="",
+                        help="Extra compiler options, e.g. \"-j4\" or \"-fstreaming\".")
+    parser.add_argument("--compare-flags", default=None,
+                        help="Also compile with these options instead of --flags and require identical output.")
     args = parser.parse_args()
 
     test_dir = os.path.join(TESTCASES_DIR, args.group)
@@ -483,12 +568,16 @@ def main():
     exec_funcs = {
         "llvm": _execute_ir,
         "riscv": _execute_riscv,
+        "riscv-obj": _execute_riscv_obj,
         "arm": _execute_arm,
     }
 
     exec_func = exec_funcs[args.stage]
 
-    output_ext = ".ll" if args.stage == "llvm" else ".s"
+    output_exts = {"llvm": ".ll", "riscv-obj": ".o"}
+    output_ext = output_exts.get(args.stage, ".s")
+    flags = shlex.split(args.flags)
+    compare_flags = shlex.split(args.compare_flags) if args.compare_flags is not None else None
 
     for sy_file in sorted(sy_files, key=lambda x: int(x.split('_')[0])):
         base_name = os.path.splitext(sy_file)[0]
@@ -503,7 +592,9 @@ def main():
             opt_level=args.opt,
             std_input=input_path if os.path.exists(input_path) else None,
             std_output=std_output_file,
-            act_output=os.path.join(TEST_OUTPUT_DIR, base_name + ".act")
+            act_output=os.path.join(TEST_OUTPUT_DIR, base_name + ".act"),
+            flags=flags,
+            compare_flags=compare_flags
         )
 
         if exec_func(test_cfg):
@@ -511,6 +602,8 @@ def main():
 
     print("\n" + "="*30)
     print(f"\tGroup: {args.group}, Stage: {args.stage}, Opt Level: {args.opt}")
+    if args.flags or compare_flags is not None:
+        print(f"\tFlags: {args.flags or '-'}, Compared With: {args.compare_flags if compare_flags is not None else '-'}")
     print(f"\tPassed: {passes_tests} / {len(sy_files)}")
     if len(sy_files) > 0:
         pass_rate = (passes_tests / len(sy_files)) * 100
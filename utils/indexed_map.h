@@ -0,0 +1,182 @@
+#ifndef __UTILS_INDEXED_MAP_H__
+#define __UTILS_INDEXED_MAP_H__
+
+#include <utils/dynamic_bitset.h>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * 以稠密编号为键的表与集合
+ *
+ * 中端的寄存器号、基本块 label 都是从 0 开始连续分配的（上界为 Function::getMaxReg()/getMaxLabel()），
+ * 以它们为键时直接用向量下标定位即可，查找/插入/删除均为 O(1)，不必走 std::map 的树结构。
+ * - IndexedMap<T>：值向量 + 存在位图，operator[] 在键越界时自动扩容；
+ * - DenseSet：位图集合。
+ * 构造或 reset 时传入编号上界可一次性定容，避免逐步扩容。
+ * 遍历按键升序进行，与原先 std::map/std::set 的遍历顺序一致；遍历开销与编号上界成正比。
+ */
+
+template <typename T>
+class IndexedMap
+{
+    // std::vector<bool> 无法返回元素引用，布尔值请用 char 存放
+    static_assert(!std::is_same<T, bool>::value, "use IndexedMap<char> instead of IndexedMap<bool>");
+
+    std::vector<T> vals_;
+    dynamic_bitset has_;
+    size_t         count_ = 0;
+
+  public:
+    class iterator
+    {
+        IndexedMap* map_;
+        size_t      idx_;
+
+        void skip()
+        {
+            while (idx_ < map_->has_.size() && !map_->has_.test(idx_)) ++idx_;
+        }
+
+      public:
+        iterator(IndexedMap* m, size_t i) : map_(m), idx_(i) { skip(); }
+
+        std::pair<size_t, T&> operator*() const { return {idx_, map_->vals_[idx_]}; }
+        iterator&             operator++()
+        {
+            ++idx_;
+            skip();
+            return *this;
+        }
+        bool operator==(const iterator& o) const { return idx_ == o.idx_; }
+        bool operator!=(const iterator& o) const { return idx_ != o.idx_; }
+    };
+
+    IndexedMap() = default;
+    explicit IndexedMap(size_t bound) { reset(bound); }
+
+    /// 清空并按编号上界 [0, bound] 重新定容
+    void reset(size_t bound)
+    {
+        vals_.assign(bound + 1, T());
+        has_.resize(bound + 1);
+        has_.reset();
+        count_ = 0;
+    }
+    void clear() { reset(vals_.empty() ? 0 : vals_.size() - 1); }
+
+    size_t size() const { return count_; }
+    bool   empty() const { return count_ == 0; }
+
+    T& operator[](size_t key)
+    {
+        if (key >= vals_.size())
+        {
+            // 按倍数扩容，逐个递增的键也只触发对数次重新分配
+            size_t n = std::max(key + 1, vals_.size() * 2);
+            vals_.resize(n);
+            has_.resize(n);
+        }
+        if (!has_.test(key))
+        {
+            has_.set(key);
+            ++count_;
+        }
+        return vals_[key];
+    }
+
+    /// 已记录时返回值的指针，否则返回 nullptr
+    T* lookup(size_t key) { return count(key) ? &vals_[key] : nullptr; }
+    const T* lookup(size_t key) const { return count(key) ? &vals_[key] : nullptr; }
+
+    bool count(size_t key) const { return key < has_.size() && has_.test(key); }
+
+    bool erase(size_t key)
+    {
+        if (!count(key)) return false;
+        has_.reset(key);
+        vals_[key] = T();
+        --count_;
+        return true;
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, has_.size()); }
+};
+
+class DenseSet
+{
+    dynamic_bitset bits_;
+    size_t         count_ = 0;
+
+  public:
+    class iterator
+    {
+        const dynamic_bitset* bits_;
+        size_t                idx_;
+
+        void skip()
+        {
+            while (idx_ < bits_->size() && !bits_->test(idx_)) ++idx_;
+        }
+
+      public:
+        iterator(const dynamic_bitset* b, size_t i) : bits_(b), idx_(i) { skip(); }
+
+        size_t    operator*() const { return idx_; }
+        iterator& operator++()
+        {
+            ++idx_;
+            skip();
+            return *this;
+        }
+        bool operator==(const iterator& o) const { return idx_ == o.idx_; }
+        bool operator!=(const iterator& o) const { return idx_ != o.idx_; }
+    };
+
+    DenseSet() = default;
+    explicit DenseSet(size_t bound) { reset(bound); }
+
+    /// 清空并按编号上界 [0, bound] 重新定容
+    void reset(size_t bound)
+    {
+        bits_.resize(bound + 1);
+        bits_.reset();
+        count_ = 0;
+    }
+    void clear()
+    {
+        bits_.reset();
+        count_ = 0;
+    }
+
+    size_t size() const { return count_; }
+    bool   empty() const { return count_ == 0; }
+
+    /// 插入编号，返回是否为新插入
+    bool insert(size_t key)
+    {
+        if (key >= bits_.size()) bits_.resize(std::max(key + 1, bits_.size() * 2));
+        if (bits_.test(key)) return false;
+        bits_.set(key);
+        ++count_;
+        return true;
+    }
+
+    bool count(size_t key) const { return key < bits_.size() && bits_.test(key); }
+
+    bool erase(size_t key)
+    {
+        if (!count(key)) return false;
+        bits_.reset(key);
+        --count_;
+        return true;
+    }
+
+    iterator begin() const { return iterator(&bits_, 0); }
+    iterator end() const { return iterator(&bits_, bits_.size()); }
+};
+
+#endif  // __UTILS_INDEXED_MAP_H__
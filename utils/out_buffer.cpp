@@ -0,0 +1,16 @@
+#include <out_buffer.h>
+#include <cstdio>
+
+void OutBuffer::flush()
+{
+    if (len_ == 0) return;
+    os_.rdbuf()->sputn(buf_.get(), static_cast<std::streamsize>(len_));
+    len_ = 0;
+}
+
+OutBuffer& OutBuffer::operator<<(double v)
+{
+    reserve(32);
+    len_ += std::snprintf(buf_.get() + len_, 32, "%g", v);
+    return *this;
+}
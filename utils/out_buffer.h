@@ -0,0 +1,102 @@
+#ifndef __UTILS_OUT_BUFFER_H__
+#define __UTILS_OUT_BUFFER_H__
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * 面向大批量文本输出的缓冲写出器（IR 打印与汇编输出使用）
+ *
+ * 所有写入先拷贝进一块 1MiB 的连续缓冲区，整数经 std::to_chars 直接转写到缓冲区中，
+ * 不经过 std::ostream 的逐次格式化与 locale 处理，也不产生临时 std::string。
+ * 缓冲区写满或显式 flush 时整块交给底层流的 streambuf，析构时自动 flush。
+ */
+class OutBuffer
+{
+  public:
+    static constexpr size_t kCapacity = 1 << 20;
+
+  private:
+    std::ostream&           os_;
+    std::unique_ptr<char[]> buf_;
+    size_t                  len_ = 0;
+
+    template <typename T>
+    static constexpr bool is_number_v =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+        !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>;
+
+    // 保证缓冲区剩余至少 n 字节
+    void reserve(size_t n)
+    {
+        if (kCapacity - len_ < n) flush();
+    }
+
+  public:
+    explicit OutBuffer(std::ostream& os) : os_(os), buf_(new char[kCapacity]) {}
+    OutBuffer(const OutBuffer&)            = delete;
+    OutBuffer& operator=(const OutBuffer&) = delete;
+    ~OutBuffer() { flush(); }
+
+    /// 将缓冲区内容整块写入底层流
+    void flush();
+
+    OutBuffer& write(const char* s, size_t n)
+    {
+        if (kCapacity - len_ < n)
+        {
+            flush();
+            // 超过整个缓冲区的大块直接交给底层流
+            if (n >= kCapacity)
+            {
+                os_.rdbuf()->sputn(s, static_cast<std::streamsize>(n));
+                return *this;
+            }
+        }
+        std::memcpy(buf_.get() + len_, s, n);
+        len_ += n;
+        return *this;
+    }
+
+    OutBuffer& put(char c)
+    {
+        reserve(1);
+        buf_[len_++] = c;
+        return *this;
+    }
+
+    /// 以小写十六进制写出无符号整数（不带 0x 前缀）
+    OutBuffer& hex(uint64_t v)
+    {
+        reserve(16);
+        char* p = buf_.get() + len_;
+        len_ += std::to_chars(p, p + 16, v, 16).ptr - p;
+        return *this;
+    }
+
+    OutBuffer& operator<<(char c) { return put(c); }
+    OutBuffer& operator<<(const char* s) { return write(s, std::strlen(s)); }
+    OutBuffer& operator<<(std::string_view s) { return write(s.data(), s.size()); }
+    OutBuffer& operator<<(const std::string& s) { return write(s.data(), s.size()); }
+
+    template <typename T, std::enable_if_t<is_number_v<T>, int> = 0>
+    OutBuffer& operator<<(T v)
+    {
+        reserve(24);
+        char* p = buf_.get() + len_;
+        len_ += std::to_chars(p, p + 24, v).ptr - p;
+        return *this;
+    }
+
+    /// 与 std::ostream 默认格式（%g，6 位有效数字）一致
+    OutBuffer& operator<<(double v);
+};
+
+#endif  // __UTILS_OUT_BUFFER_H__
@@ -0,0 +1,168 @@
+#include <utils/thread_pool.h>
+#include <utils/debug.h>
+#include <algorithm>
+#include <sys/resource.h>
+#include <thread>
+
+namespace
+{
+    struct ThreadStart
+    {
+        ThreadPool* pool;
+        size_t      worker;
+    };
+
+    // 与主线程一致的栈大小：栈上限为 unlimited 时取 1GB（只占虚拟地址空间，按需分配物理页）
+    size_t workerStackSize()
+    {
+        constexpr size_t defaultSize = 8ull << 20;
+        constexpr size_t maxSize     = 1ull << 30;
+        rlimit           limit;
+        if (getrlimit(RLIMIT_STACK, &limit) != 0) return defaultSize;
+        if (limit.rlim_cur == RLIM_INFINITY) return maxSize;
+        return std::clamp<size_t>(limit.rlim_cur, defaultSize, maxSize);
+    }
+}  // namespace
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    threadCount = std::max<size_t>(threadCount, 1);
+    for (size_t i = 0; i < threadCount; ++i) queues.push_back(std::make_unique<WorkQueue>());
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, workerStackSize());
+    // 0 号工作线程是调用 parallelFor 的线程本身
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        pthread_t tid;
+        int       rc = pthread_create(&tid, &attr, &ThreadPool::threadEntry, new ThreadStart{this, i});
+        if (rc != 0) ERROR("Failed to create worker thread %zu", i);
+        threads.push_back(tid);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+void* ThreadPool::threadEntry(void* arg)
+{
+    auto* start = static_cast<ThreadStart*>(arg);
+    start->pool->workerLoop(start->worker);
+    delete start;
+    return nullptr;
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto t : threads) pthread_join(t, nullptr);
+}
+
+size_t ThreadPool::resolveThreads(size_t requested)
+{
+    if (requested != 0) return requested;
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void ThreadPool::parallelFor(size_t n, const Task& fn)
+{
+    if (n == 0) return;
+    if (threads.empty() || n == 1)
+    {
+        for (size_t i = 0; i < n; ++i) fn(0, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (size_t i = 0; i < n; ++i)
+        {
+            auto& queue = *queues[i % queues.size()];
+            // 此时没有工作线程在运行，不需要队列锁；这里加锁只为与窃取的内存可见性保持一致
+            std::lock_guard<std::mutex> qlock(queue.mtx);
+            queue.tasks.push_back(i);
+        }
+        remaining = n;
+        job       = &fn;
+        ++generation;
+    }
+    wakeCv.notify_all();
+
+    runTasks(0, fn);
+
+    std::unique_lock<std::mutex> lock(mtx);
+    doneCv.wait(lock, [this] { return remaining == 0 && active == 0; });
+    // 在同一临界区内撤下本轮任务，迟到的工作线程看到的是 nullptr，不会再访问 fn
+    job = nullptr;
+}
+
+void ThreadPool::workerLoop(size_t worker)
+{
+    size_t seen = 0;
+    while (true)
+    {
+        const Task* fn = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (!job) continue;
+            fn = job;
+            ++active;
+        }
+
+        runTasks(worker, *fn);
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            --active;
+        }
+        doneCv.notify_all();
+    }
+}
+
+void ThreadPool::runTasks(size_t worker, const Task& fn)
+{
+    size_t index = 0;
+    while (popTask(worker, index))
+    {
+        fn(worker, index);
+        if (--remaining == 0)
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            doneCv.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popTask(size_t worker, size_t& index)
+{
+    // 先取自己队列的头部
+    {
+        auto&                       own = *queues[worker];
+        std::lock_guard<std::mutex> lock(own.mtx);
+        if (!own.tasks.empty())
+        {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // 再从其他线程队列的尾部窃取
+    for (size_t k = 1; k < queues.size(); ++k)
+    {
+        auto&                       victim = *queues[(worker + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (!victim.tasks.empty())
+        {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#ifndef __UTILS_THREAD_POOL_H__
+#define __UTILS_THREAD_POOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+/*
+ * 工作窃取线程池
+ *
+ * parallelFor(n, fn) 把下标 [0, n) 轮流分到各工作线程的任务队列中，调用线程作为 0 号工作线程一同执行。
+ * 每个线程先从自己队列的头部取任务，取空后从其他线程队列的尾部窃取，
+ * 大小悬殊的任务（如大小不一的函数）也能较均匀地分摊到各线程。
+ * fn(worker, index) 中的 worker 为执行该任务的线程编号 [0, size())，可用于索引每线程独立的状态。
+ * parallelFor 返回时所有任务均已完成，且没有工作线程仍在访问本轮的 fn。
+ * 中端/后端有不少递归遍历（支配树 DFS 等），工作线程的栈大小与主线程的栈上限（ulimit -s）一致，
+ * 而 std::thread 无法指定栈大小（栈上限为 unlimited 时 glibc 默认只给 2MB），因此用 pthread 创建线程。
+ */
+
+class ThreadPool
+{
+  public:
+    using Task = std::function<void(size_t worker, size_t index)>;
+
+    // threads 为包括调用线程在内的线程数，至少为 1；为 1 时 parallelFor 直接在调用线程上顺序执行
+    explicit ThreadPool(size_t threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&)            = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return queues.size(); }
+
+    void parallelFor(size_t n, const Task& fn);
+
+    // 0 表示使用硬件线程数
+    static size_t resolveThreads(size_t requested);
+
+    // 可请求的最大线程数，命令行 -j 超出时报错
+    static constexpr size_t kMaxThreads = 256;
+
+  private:
+    struct WorkQueue
+    {
+        std::mutex         mtx;
+        std::deque<size_t> tasks;
+    };
+
+    std::vector<pthread_t>                  threads;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+
+    std::mutex              mtx;
+    std::condition_variable wakeCv;  // 有新一轮任务或需要退出
+    std::condition_variable doneCv;  // 任务全部完成且工作线程全部空闲
+    const Task*             job        = nullptr;
+    size_t                  generation = 0;
+    size_t                  active     = 0;  // 正在执行本轮任务的工作线程数（不含调用线程）
+    bool                    stopping   = false;
+    std::atomic<size_t>     remaining{0};
+
+    static void* threadEntry(void* arg);
+    void         workerLoop(size_t worker);
+    void runTasks(size_t worker, const Task& fn);
+    bool popTask(size_t worker, size_t& index);
+};
+
+#endif  // __UTILS_THREAD_POOL_H__